@@ -0,0 +1,535 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-19
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// Real time benchmark for a full console configuration, without Qt.
+// The console should use "simulation": "DYNAMIC" for all arms so
+// PID and IO are provided by the stand-in (see
+// share/console/console-MTMR-PSM1_DYN_SIMULATED-Teleop.json).  Once
+// all arms are homed, a scripted workload is applied:
+//   - move_jp sweeps on all arms
+//   - tele-operation enabled with the operator present
+//   - external read load on all arms during both phases, similar to
+//     the ROS bridges
+// Period and execution time distributions are collected every cycle
+// for all the arms, tele-operation, stand-in and IO components (see
+// mtsIntuitiveResearchKitTimingProbe) and checked against budgets.
+// Returns 0 if all budgets are met, 1 otherwise.
+
+// system
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <string>
+
+// cisst/saw
+#include <cisstCommon/cmnPath.h>
+#include <cisstCommon/cmnCommandLineOptions.h>
+#include <cisstCommon/cmnTypeTraits.h>
+#include <cisstOSAbstraction/osaGetTime.h>
+#include <cisstOSAbstraction/osaSleep.h>
+#include <cisstMultiTask/mtsInterfaceRequired.h>
+#include <cisstMultiTask/mtsIntervalStatistics.h>
+#include <cisstMultiTask/mtsManagerLocal.h>
+#include <cisstMultiTask/mtsTaskPeriodic.h>
+#include <cisstParameterTypes/prmConfigurationJoint.h>
+#include <cisstParameterTypes/prmEventButton.h>
+#include <cisstParameterTypes/prmOperatingState.h>
+#include <cisstParameterTypes/prmPositionCartesianGet.h>
+#include <cisstParameterTypes/prmPositionJointSet.h>
+#include <cisstParameterTypes/prmStateJoint.h>
+#include <cisstParameterTypes/prmVelocityCartesianGet.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitConsole.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLog.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArm.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitStandIn.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitTimingProbe.h>
+
+// reads the arms' state periodically, like the ROS bridges
+class ReadLoad: public mtsTaskPeriodic
+{
+    CMN_DECLARE_SERVICES(CMN_NO_DYNAMIC_CREATION, CMN_LOG_ALLOW_DEFAULT);
+
+protected:
+    struct ArmType {
+        mtsFunctionRead measured_js;
+        mtsFunctionRead setpoint_js;
+        mtsFunctionRead measured_cp;
+        mtsFunctionRead setpoint_cp;
+        mtsFunctionRead measured_cv;
+        mtsFunctionRead operating_state;
+        mtsFunctionRead period_statistics;
+        prmStateJoint m_measured_js;
+        prmStateJoint m_setpoint_js;
+        prmPositionCartesianGet m_measured_cp;
+        prmPositionCartesianGet m_setpoint_cp;
+        prmVelocityCartesianGet m_measured_cv;
+        prmOperatingState m_operating_state;
+        mtsIntervalStatistics m_period_statistics;
+    };
+    std::list<ArmType *> mArms;
+
+public:
+    ReadLoad(const std::string & name, const double period):
+        mtsTaskPeriodic(name, period)
+    {}
+
+    ~ReadLoad() {
+        for (auto arm : mArms) {
+            delete arm;
+        }
+    }
+
+    void AddArm(const std::string & name) {
+        mtsInterfaceRequired * required = AddInterfaceRequired(name);
+        if (required) {
+            ArmType * arm = new ArmType;
+            required->AddFunction("measured_js", arm->measured_js);
+            required->AddFunction("setpoint_js", arm->setpoint_js);
+            required->AddFunction("measured_cp", arm->measured_cp);
+            required->AddFunction("setpoint_cp", arm->setpoint_cp);
+            required->AddFunction("measured_cv", arm->measured_cv);
+            required->AddFunction("operating_state", arm->operating_state);
+            required->AddFunction("period_statistics", arm->period_statistics);
+            mArms.push_back(arm);
+        }
+    }
+
+    void Startup(void) {}
+
+    void Run(void) {
+        ProcessQueuedCommands();
+        for (auto arm : mArms) {
+            arm->measured_js(arm->m_measured_js);
+            arm->setpoint_js(arm->m_setpoint_js);
+            arm->measured_cp(arm->m_measured_cp);
+            arm->setpoint_cp(arm->m_setpoint_cp);
+            arm->measured_cv(arm->m_measured_cv);
+            arm->operating_state(arm->m_operating_state);
+            arm->period_statistics(arm->m_period_statistics);
+        }
+    }
+
+    void Cleanup(void) {}
+};
+
+CMN_DECLARE_SERVICES_INSTANTIATION(ReadLoad)
+CMN_IMPLEMENT_SERVICES_DERIVED(ReadLoad, mtsTaskPeriodic)
+
+// commands sent by the scripted workload
+struct WorkloadArm {
+    std::string Name;
+    mtsFunctionRead measured_js;
+    mtsFunctionRead configuration_js;
+    mtsFunctionRead operating_state;
+    mtsFunctionWrite move_jp;
+    vctDoubleVec Home;
+    vctDoubleVec Amplitude;
+    vctDoubleVec Lower;
+    vctDoubleVec Upper;
+};
+
+struct WorkloadConsole {
+    mtsFunctionVoid home;
+    mtsFunctionVoid power_off;
+    mtsFunctionWrite teleop_enable;
+    mtsFunctionWrite emulate_operator_present;
+};
+
+bool WaitForArms(std::list<WorkloadArm *> & arms, const double timeout, const bool homed)
+{
+    const double start = osaGetTime();
+    prmOperatingState state;
+    while (osaGetTime() - start < timeout) {
+        bool done = true;
+        for (auto arm : arms) {
+            arm->operating_state(state);
+            if (homed) {
+                done &= (state.State() == prmOperatingState::ENABLED) && state.IsHomed();
+            } else {
+                done &= !state.IsBusy();
+            }
+        }
+        if (done) {
+            return true;
+        }
+        osaSleep(10.0 * cmn_ms);
+    }
+    return false;
+}
+
+// budgets for a component, "*" for defaults.  Sections "period" and
+// "execution" are in seconds, sections "period-ratio" and
+// "execution-ratio" are relative to the nominal period.
+bool CheckBudgets(const Json::Value & jsonBudgets,
+                  const std::string & componentName,
+                  const mtsIntuitiveResearchKitTimingProbe & probe,
+                  std::ostream & failures)
+{
+    const double nominal = probe.Source()->GetPeriodicity(true);
+    bool pass = true;
+    const char * sections[] = {"period", "execution", "period-ratio", "execution-ratio"};
+    for (auto section : sections) {
+        Json::Value jsonSection = jsonBudgets[componentName][section];
+        if (jsonSection.empty()) {
+            jsonSection = jsonBudgets["*"][section];
+        }
+        const std::string sectionName = section;
+        const bool isPeriod = (sectionName.find("period") == 0);
+        const bool isRatio = (sectionName.find("-ratio") != std::string::npos);
+        const mtsIntuitiveResearchKitTimingHistogram & histogram =
+            isPeriod ? probe.Periods() : probe.ExecutionTimes();
+        const Json::Value::Members statistics = jsonSection.getMemberNames();
+        for (const auto & statistic : statistics) {
+            double value;
+            if (!histogram.Statistic(statistic, value)) {
+                failures << componentName << ": invalid statistic \"" << statistic
+                         << "\" in \"" << section << "\"" << std::endl;
+                pass = false;
+                continue;
+            }
+            double budget = jsonSection[statistic].asDouble();
+            if (isRatio) {
+                budget *= nominal;
+            }
+            if (value > budget) {
+                failures << componentName << ": " << section << " " << statistic
+                         << " is " << value * 1.0e6 << " us, budget is "
+                         << budget * 1.0e6 << " us" << std::endl;
+                pass = false;
+            }
+        }
+    }
+    return pass;
+}
+
+void PrintDistribution(std::ostream & output,
+                       const mtsIntuitiveResearchKitTimingHistogram & histogram)
+{
+    output << std::setw(9) << histogram.Percentile(50.0) * 1.0e6
+           << std::setw(9) << histogram.Percentile(99.0) * 1.0e6
+           << std::setw(9) << histogram.Percentile(99.9) * 1.0e6
+           << std::setw(9) << histogram.Maximum() * 1.0e6;
+}
+
+Json::Value DistributionToJSON(const mtsIntuitiveResearchKitTimingHistogram & histogram)
+{
+    Json::Value jsonValue;
+    jsonValue["count"] = static_cast<Json::UInt64>(histogram.Count());
+    jsonValue["overflows"] = static_cast<Json::UInt64>(histogram.Overflows());
+    jsonValue["min"] = histogram.Minimum();
+    jsonValue["mean"] = histogram.Mean();
+    jsonValue["p50"] = histogram.Percentile(50.0);
+    jsonValue["p99"] = histogram.Percentile(99.0);
+    jsonValue["p99.9"] = histogram.Percentile(99.9);
+    jsonValue["max"] = histogram.Maximum();
+    return jsonValue;
+}
+
+int main(int argc, char ** argv)
+{
+    // log configuration
+    cmnLogger::SetMask(CMN_LOG_ALLOW_ALL);
+    cmnLogger::SetMaskDefaultLog(CMN_LOG_ALLOW_ALL);
+    cmnLogger::SetMaskFunction(CMN_LOG_ALLOW_ALL);
+    cmnLogger::SetMaskClassMatching("mtsIntuitiveResearchKit", CMN_LOG_ALLOW_ALL);
+    cmnLogger::AddChannel(std::cerr, CMN_LOG_ALLOW_ERRORS_AND_WARNINGS);
+
+    // parse options
+    cmnCommandLineOptions options;
+    std::string jsonMainConfigFile;
+    std::string jsonBudgetsFile;
+    std::string jsonResultsFile;
+    double sweepDuration = 20.0;
+    double teleopDuration = 20.0;
+    double homingTimeout = 60.0;
+    double readPeriod = mtsIntuitiveResearchKit::Benchmark::ReadPeriod;
+    int numberOfReaders = 1;
+
+    options.AddOptionOneValue("j", "json-config",
+                              "json configuration file for the console, arms should use simulation DYNAMIC",
+                              cmnCommandLineOptions::REQUIRED_OPTION, &jsonMainConfigFile);
+
+    options.AddOptionOneValue("b", "budgets",
+                              "json file with timing budgets per component, \"*\" for defaults",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &jsonBudgetsFile);
+
+    options.AddOptionOneValue("o", "output",
+                              "json file to save all distributions, e.g. to compare runs",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &jsonResultsFile);
+
+    options.AddOptionOneValue("s", "sweep-duration",
+                              "duration of move_jp sweeps in seconds, default is 20",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &sweepDuration);
+
+    options.AddOptionOneValue("t", "teleop-duration",
+                              "duration of tele-operation in seconds, default is 20",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &teleopDuration);
+
+    options.AddOptionOneValue("r", "read-period",
+                              "period of the external read load in seconds, default is 0.01",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &readPeriod);
+
+    options.AddOptionOneValue("l", "readers",
+                              "number of external read load threads, default is 1, 0 to disable",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &numberOfReaders);
+
+    options.AddOptionOneValue("T", "homing-timeout",
+                              "maximum time for all arms to be powered and homed in seconds, default is 60",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &homingTimeout);
+
+    options.AddOptionNoValue("H", "allow-hardware",
+                             "allow configurations without stand-in, i.e. using real hardware");
+
+    // check that all required options have been provided
+    std::string errorMessage;
+    if (!options.Parse(argc, argv, errorMessage)) {
+        std::cerr << "Error: " << errorMessage << std::endl;
+        options.PrintUsage(std::cerr);
+        return -1;
+    }
+    std::string arguments;
+    options.PrintParsedArguments(arguments);
+    std::cout << "Options provided:" << std::endl << arguments << std::endl;
+
+    if (!cmnPath::Exists(jsonMainConfigFile)) {
+        std::cerr << "File not found: JSON configuration; " << jsonMainConfigFile << std::endl;
+        return -1;
+    }
+
+    Json::Value jsonBudgets;
+    if (options.IsSet("budgets")) {
+        std::ifstream jsonStream(jsonBudgetsFile.c_str());
+        Json::Reader jsonReader;
+        if (!jsonReader.parse(jsonStream, jsonBudgets)) {
+            std::cerr << "Failed to parse budgets file " << jsonBudgetsFile << std::endl
+                      << jsonReader.getFormattedErrorMessages();
+            return -1;
+        }
+    }
+
+    mtsManagerLocal * componentManager = mtsManagerLocal::GetInstance();
+
+    // console
+    mtsIntuitiveResearchKitConsole * console = new mtsIntuitiveResearchKitConsole("console");
+    console->Configure(jsonMainConfigFile);
+    componentManager->AddComponent(console);
+    console->Connect();
+
+    // find arms to move and components to measure
+    std::list<WorkloadArm *> arms;
+    bool hasStandIn = false;
+    const std::vector<std::string> componentNames = componentManager->GetNamesOfComponents();
+    for (const auto & componentName : componentNames) {
+        mtsComponent * component = componentManager->GetComponent(componentName);
+        if (dynamic_cast<mtsIntuitiveResearchKitStandIn *>(component)) {
+            hasStandIn = true;
+        }
+        if (dynamic_cast<mtsIntuitiveResearchKitArm *>(component)) {
+            WorkloadArm * arm = new WorkloadArm;
+            arm->Name = componentName;
+            arms.push_back(arm);
+        }
+    }
+    std::list<mtsIntuitiveResearchKitTimingProbe *> probes =
+        mtsIntuitiveResearchKitTimingProbe::AddProbes(mtsIntuitiveResearchKit::Benchmark::Resolution,
+                                                      mtsIntuitiveResearchKit::Benchmark::Range);
+    if (!hasStandIn && !options.IsSet("allow-hardware")) {
+        std::cerr << "No stand-in found, arms should use \"simulation\": \"DYNAMIC\" (or use --allow-hardware)" << std::endl;
+        return -1;
+    }
+    if (arms.empty()) {
+        std::cerr << "No arm found in " << jsonMainConfigFile << std::endl;
+        return -1;
+    }
+
+    // scripted workload
+    mtsComponent * workload = new mtsComponent("benchmark");
+    WorkloadConsole consoleCommands;
+    mtsInterfaceRequired * required = workload->AddInterfaceRequired("Console");
+    required->AddFunction("home", consoleCommands.home);
+    required->AddFunction("power_off", consoleCommands.power_off);
+    required->AddFunction("teleop_enable", consoleCommands.teleop_enable);
+    required->AddFunction("emulate_operator_present", consoleCommands.emulate_operator_present);
+    for (auto arm : arms) {
+        required = workload->AddInterfaceRequired(arm->Name);
+        required->AddFunction("measured_js", arm->measured_js);
+        required->AddFunction("configuration_js", arm->configuration_js);
+        required->AddFunction("operating_state", arm->operating_state);
+        required->AddFunction("move_jp", arm->move_jp);
+    }
+    componentManager->AddComponent(workload);
+    componentManager->Connect(workload->GetName(), "Console", console->GetName(), "Main");
+    for (auto arm : arms) {
+        componentManager->Connect(workload->GetName(), arm->Name, arm->Name, "Arm");
+    }
+
+    // external read load
+    for (int index = 0; index < numberOfReaders; ++index) {
+        ReadLoad * reader = new ReadLoad("benchmark-reader-" + std::to_string(index), readPeriod);
+        for (auto arm : arms) {
+            reader->AddArm(arm->Name);
+        }
+        componentManager->AddComponent(reader);
+        for (auto arm : arms) {
+            componentManager->Connect(reader->GetName(), arm->Name, arm->Name, "Arm");
+        }
+    }
+
+    // run time errors from real time threads are written in background
+    mtsIntuitiveResearchKitLog::Start();
+
+    //-------------- create the components ------------------
+    componentManager->CreateAllAndWait(2.0 * cmn_s);
+    componentManager->StartAllAndWait(2.0 * cmn_s);
+
+    // power and home all arms
+    std::cout << "Homing arms..." << std::endl;
+    consoleCommands.home();
+    if (!WaitForArms(arms, homingTimeout, true)) {
+        std::cerr << "Arms not homed after " << homingTimeout << " seconds" << std::endl;
+        componentManager->KillAllAndWait(2.0 * cmn_s);
+        componentManager->Cleanup();
+        mtsIntuitiveResearchKitLog::Stop();
+        return -1;
+    }
+
+    // sweep around the homed position, 10% of the joint range each way
+    for (auto arm : arms) {
+        prmStateJoint measured_js;
+        prmConfigurationJoint configuration_js;
+        arm->measured_js(measured_js);
+        arm->configuration_js(configuration_js);
+        arm->Home.ForceAssign(measured_js.Position());
+        arm->Amplitude.SetSize(arm->Home.size());
+        arm->Amplitude.SetAll(0.1);
+        arm->Lower.SetSize(arm->Home.size());
+        arm->Lower.SetAll(-cmnTypeTraits<double>::MaxPositiveValue());
+        arm->Upper.SetSize(arm->Home.size());
+        arm->Upper.SetAll(cmnTypeTraits<double>::MaxPositiveValue());
+        if ((configuration_js.PositionMin().size() == arm->Home.size())
+            && (configuration_js.PositionMax().size() == arm->Home.size())) {
+            arm->Lower.Assign(configuration_js.PositionMin());
+            arm->Upper.Assign(configuration_js.PositionMax());
+            arm->Amplitude.DifferenceOf(arm->Upper, arm->Lower);
+            arm->Amplitude.Multiply(0.1);
+        }
+    }
+
+    for (auto probe : probes) {
+        probe->SetRecording(true);
+    }
+
+    std::cout << "Sweeping arms for " << sweepDuration << " seconds..." << std::endl;
+    const double sweepStart = osaGetTime();
+    double direction = 1.0;
+    size_t numberOfSweeps = 0;
+    while (osaGetTime() - sweepStart < sweepDuration) {
+        for (auto arm : arms) {
+            prmPositionJointSet move_jp;
+            move_jp.Goal().SetSize(arm->Home.size());
+            for (size_t index = 0; index < arm->Home.size(); ++index) {
+                move_jp.Goal().at(index) =
+                    std::max(arm->Lower.at(index),
+                             std::min(arm->Home.at(index) + direction * arm->Amplitude.at(index),
+                                      arm->Upper.at(index)));
+            }
+            arm->move_jp(move_jp);
+        }
+        // let arms report busy before waiting for goals
+        osaSleep(50.0 * cmn_ms);
+        WaitForArms(arms, 10.0 * cmn_s, false);
+        direction = -direction;
+        ++numberOfSweeps;
+    }
+
+    std::cout << "Tele-operation for " << teleopDuration << " seconds..." << std::endl;
+    prmEventButton operatorPresent;
+    operatorPresent.SetType(prmEventButton::PRESSED);
+    consoleCommands.emulate_operator_present(operatorPresent);
+    consoleCommands.teleop_enable(true);
+    osaSleep(teleopDuration);
+    consoleCommands.teleop_enable(false);
+    operatorPresent.SetType(prmEventButton::RELEASED);
+    consoleCommands.emulate_operator_present(operatorPresent);
+
+    for (auto probe : probes) {
+        probe->SetRecording(false);
+    }
+
+    consoleCommands.power_off();
+    componentManager->KillAllAndWait(2.0 * cmn_s);
+    componentManager->Cleanup();
+
+    // report, times in micro seconds
+    std::cout << std::endl << numberOfSweeps << " sweeps, "
+              << numberOfReaders << " reader(s) at " << readPeriod * 1.0e3 << " ms" << std::endl
+              << std::left << std::setw(24) << "component" << std::right
+              << std::setw(9) << "nominal" << std::setw(10) << "samples"
+              << std::setw(9) << "T p50" << std::setw(9) << "T p99"
+              << std::setw(9) << "T p99.9" << std::setw(9) << "T max"
+              << std::setw(9) << "E p50" << std::setw(9) << "E p99"
+              << std::setw(9) << "E p99.9" << std::setw(9) << "E max"
+              << "  budget" << std::endl
+              << std::fixed << std::setprecision(0);
+    bool pass = true;
+    std::stringstream failures;
+    Json::Value jsonResults;
+    for (auto probe : probes) {
+        const std::string name = probe->Source()->GetName();
+        const bool probePass = CheckBudgets(jsonBudgets, name, *probe, failures);
+        pass &= probePass;
+        std::cout << std::left << std::setw(24) << name << std::right
+                  << std::setw(9) << probe->Source()->GetPeriodicity(true) * 1.0e6
+                  << std::setw(10) << probe->ExecutionTimes().Count();
+        PrintDistribution(std::cout, probe->Periods());
+        PrintDistribution(std::cout, probe->ExecutionTimes());
+        std::cout << (probePass ? "  pass" : "  FAIL") << std::endl;
+        Json::Value & jsonComponent = jsonResults["components"][name];
+        jsonComponent["nominal"] = probe->Source()->GetPeriodicity(true);
+        jsonComponent["period"] = DistributionToJSON(probe->Periods());
+        jsonComponent["execution"] = DistributionToJSON(probe->ExecutionTimes());
+        jsonComponent["pass"] = probePass;
+    }
+    std::cout << failures.str()
+              << std::endl << (pass ? "PASS" : "FAIL") << std::endl;
+
+    if (options.IsSet("output")) {
+        jsonResults["configuration"] = jsonMainConfigFile;
+        jsonResults["sweeps"] = static_cast<Json::UInt64>(numberOfSweeps);
+        jsonResults["readers"] = numberOfReaders;
+        jsonResults["read-period"] = readPeriod;
+        jsonResults["pass"] = pass;
+        std::ofstream jsonStream(jsonResultsFile.c_str());
+        Json::StyledStreamWriter writer;
+        writer.write(jsonStream, jsonResults);
+    }
+
+    for (auto arm : arms) {
+        delete arm;
+    }
+
+    // stop all logs
+    mtsIntuitiveResearchKitLog::Stop();
+    cmnLogger::Kill();
+
+    return pass ? 0 : 1;
+}
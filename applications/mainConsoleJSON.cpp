@@ -0,0 +1,216 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// Same console as sawIntuitiveResearchKitQtConsoleJSON without Qt,
+// so no GUI thread competes with the real time threads.  Use
+// --remote-telemetry and sawIntuitiveResearchKitQtRemote to display
+// the arms from a separate process.  Use --timing to compare the
+// period and execution time distributions with and without GUI (the
+// Qt console accepts the same option).  Runs until SIGINT/SIGTERM or
+// for --duration seconds.
+
+// system
+#include <atomic>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <list>
+
+// cisst/saw
+#include <cisstCommon/cmnPath.h>
+#include <cisstCommon/cmnCommandLineOptions.h>
+#include <cisstOSAbstraction/osaGetTime.h>
+#include <cisstOSAbstraction/osaSleep.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitConsole.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLog.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecorder.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitTimingProbe.h>
+
+#include <cisstMultiTask/mtsCollectorFactory.h>
+#include <cisstMultiTask/mtsManagerLocal.h>
+
+namespace {
+    std::atomic<bool> stopRequested(false);
+
+    void SignalHandler(int)
+    {
+        stopRequested = true;
+    }
+}
+
+void fileExists(const std::string & description, const std::string & filename)
+{
+    if (!cmnPath::Exists(filename)) {
+        std::cerr << "File not found: " << description
+                  << "; " << filename << std::endl;
+        exit(-1);
+    } else {
+        std::cout << "File found: " << description
+                  << "; " << filename << std::endl;
+    }
+}
+
+
+int main(int argc, char ** argv)
+{
+    // log configuration
+    cmnLogger::SetMask(CMN_LOG_ALLOW_ALL);
+    cmnLogger::SetMaskDefaultLog(CMN_LOG_ALLOW_ALL);
+    cmnLogger::SetMaskFunction(CMN_LOG_ALLOW_ALL);
+    cmnLogger::SetMaskClassMatching("mtsIntuitiveResearchKit", CMN_LOG_ALLOW_ALL);
+    cmnLogger::AddChannel(std::cerr, CMN_LOG_ALLOW_ERRORS_AND_WARNINGS);
+
+    // parse options
+    cmnCommandLineOptions options;
+    std::string jsonMainConfigFile;
+    std::string jsonCollectionConfigFile;
+    std::list<std::string> managerConfig;
+    double duration = 0.0;
+
+    options.AddOptionOneValue("j", "json-config",
+                              "json configuration file",
+                              cmnCommandLineOptions::REQUIRED_OPTION, &jsonMainConfigFile);
+
+    options.AddOptionOneValue("c", "collection-config",
+                              "json configuration file for data collection using cisstMultiTask state table collector or binary recorder",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &jsonCollectionConfigFile);
+
+    options.AddOptionNoValue("C", "calibration-mode",
+                             "run in calibration mode, doesn't use potentiometers to monitor encoder values and always force re-homing.  This mode should only be used when calibrating your potentiometers.");
+
+    options.AddOptionMultipleValues("m", "component-manager",
+                                    "JSON files to configure component manager",
+                                    cmnCommandLineOptions::OPTIONAL_OPTION, &managerConfig);
+
+    options.AddOptionNoValue("r", "remote-telemetry",
+                             "publish all arms and teleops in shared memory for sawIntuitiveResearchKitQtRemote");
+
+    options.AddOptionNoValue("t", "timing",
+                             "collect period and execution time distributions for all real time components, report printed on exit");
+
+    options.AddOptionOneValue("d", "duration",
+                              "stop after duration in seconds, default is to run until SIGINT/SIGTERM",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &duration);
+
+    // check that all required options have been provided
+    std::string errorMessage;
+    if (!options.Parse(argc, argv, errorMessage)) {
+        std::cerr << "Error: " << errorMessage << std::endl;
+        options.PrintUsage(std::cerr);
+        return -1;
+    }
+    std::string arguments;
+    options.PrintParsedArguments(arguments);
+    std::cout << "Options provided:" << std::endl << arguments << std::endl;
+
+    // make sure the json config file exists and can be parsed
+    fileExists("JSON configuration", jsonMainConfigFile);
+
+    mtsManagerLocal * componentManager = mtsManagerLocal::GetInstance();
+
+    // console
+    mtsIntuitiveResearchKitConsole * console = new mtsIntuitiveResearchKitConsole("console");
+    console->set_calibration_mode(options.IsSet("calibration-mode"));
+    console->set_remote_telemetry(options.IsSet("remote-telemetry"));
+    console->Configure(jsonMainConfigFile);
+    componentManager->AddComponent(console);
+    console->Connect();
+
+    // configure data collection if needed
+    if (options.IsSet("collection-config")) {
+        // make sure the json config file exists
+        fileExists("JSON data collection configuration", jsonCollectionConfigFile);
+
+        std::ifstream jsonStream(jsonCollectionConfigFile.c_str());
+        Json::Value jsonCollection;
+        Json::Reader jsonReader;
+        if (!jsonReader.parse(jsonStream, jsonCollection)) {
+            std::cerr << "Failed to parse data collection configuration file "
+                      << jsonCollectionConfigFile << std::endl
+                      << jsonReader.getFormattedErrorMessages();
+            return -1;
+        }
+
+        if (!jsonCollection["recorder"].empty()) {
+            // binary recorder, runs in the arms' threads and records every sample
+            if (!mtsIntuitiveResearchKitRecorder::AddRecorders(jsonCollection["recorder"])) {
+                std::cerr << "Failed to configure recorder, check cisstLog for error messages" << std::endl;
+                return -1;
+            }
+        } else {
+            // without GUI, collection has to be started using the collector's interfaces
+            mtsCollectorFactory * collectorFactory = new mtsCollectorFactory("collectors");
+            collectorFactory->Configure(jsonCollectionConfigFile);
+            componentManager->AddComponent(collectorFactory);
+            collectorFactory->Connect();
+        }
+    }
+
+    // custom user component
+    if (!componentManager->ConfigureJSON(managerConfig)) {
+        CMN_LOG_INIT_ERROR << "Configure: failed to configure component-manager, check cisstLog for error messages" << std::endl;
+        return -1;
+    }
+
+    // timing probes, added last so all components are known
+    std::list<mtsIntuitiveResearchKitTimingProbe *> probes;
+    if (options.IsSet("timing")) {
+        probes = mtsIntuitiveResearchKitTimingProbe::AddProbes(mtsIntuitiveResearchKit::Benchmark::Resolution,
+                                                               mtsIntuitiveResearchKit::Benchmark::Range);
+    }
+
+    // run time errors from real time threads are written in background
+    mtsIntuitiveResearchKitLog::Start();
+
+    //-------------- create the components ------------------
+    componentManager->CreateAllAndWait(2.0 * cmn_s);
+    componentManager->StartAllAndWait(2.0 * cmn_s);
+
+    for (auto probe : probes) {
+        probe->SetRecording(true);
+    }
+
+    std::signal(SIGINT, SignalHandler);
+    std::signal(SIGTERM, SignalHandler);
+    std::cout << "Console running, press Ctrl-C to quit" << std::endl;
+    const double startTime = osaGetTime();
+    while (!stopRequested
+           && ((duration <= 0.0) || (osaGetTime() - startTime < duration))) {
+        osaSleep(100.0 * cmn_ms);
+    }
+
+    for (auto probe : probes) {
+        probe->SetRecording(false);
+    }
+
+    componentManager->KillAllAndWait(2.0 * cmn_s);
+    componentManager->Cleanup();
+
+    // times in micro seconds
+    if (!probes.empty()) {
+        std::cout << std::endl;
+        mtsIntuitiveResearchKitTimingProbe::PrintReport(std::cout, probes);
+    }
+
+    // stop all logs
+    mtsIntuitiveResearchKitLog::Stop();
+    cmnLogger::Kill();
+
+    return 0;
+}
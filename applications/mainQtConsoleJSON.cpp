@@ -18,15 +18,21 @@ http://www.cisst.org/cisst/license.txt.
 */
 
 // system
+#include <fstream>
 #include <iostream>
+#include <list>
 #include <map>
 
 // cisst/saw
 #include <cisstCommon/cmnPath.h>
 #include <cisstCommon/cmnCommandLineOptions.h>
 #include <cisstCommon/cmnQt.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitConsole.h>
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitConsoleQt.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLog.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecorder.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitTimingProbe.h>
 
 #include <cisstMultiTask/mtsCollectorFactory.h>
 #include <cisstMultiTask/mtsCollectorQtFactory.h>
@@ -70,7 +76,7 @@ int main(int argc, char ** argv)
                               cmnCommandLineOptions::REQUIRED_OPTION, &jsonMainConfigFile);
 
     options.AddOptionOneValue("c", "collection-config",
-                              "json configuration file for data collection using cisstMultiTask state table collector",
+                              "json configuration file for data collection using cisstMultiTask state table collector or binary recorder",
                               cmnCommandLineOptions::OPTIONAL_OPTION, &jsonCollectionConfigFile);
 
     options.AddOptionNoValue("C", "calibration-mode",
@@ -87,6 +93,9 @@ int main(int argc, char ** argv)
     options.AddOptionNoValue("D", "dark-mode",
                              "replaces the default Qt palette with darker colors");
 
+    options.AddOptionNoValue("t", "timing",
+                             "collect period and execution time distributions for all real time components, report printed on exit");
+
     // check that all required options have been provided
     std::string errorMessage;
     if (!options.Parse(argc, argv, errorMessage)) {
@@ -134,19 +143,37 @@ int main(int argc, char ** argv)
         // make sure the json config file exists
         fileExists("JSON data collection configuration", jsonCollectionConfigFile);
 
-        mtsCollectorFactory * collectorFactory = new mtsCollectorFactory("collectors");
-        collectorFactory->Configure(jsonCollectionConfigFile);
-        componentManager->AddComponent(collectorFactory);
-        collectorFactory->Connect();
-
-        mtsCollectorQtWidget * collectorQtWidget = new mtsCollectorQtWidget();
-        consoleQt->addTab(collectorQtWidget, "Collection");
+        std::ifstream jsonStream(jsonCollectionConfigFile.c_str());
+        Json::Value jsonCollection;
+        Json::Reader jsonReader;
+        if (!jsonReader.parse(jsonStream, jsonCollection)) {
+            std::cerr << "Failed to parse data collection configuration file "
+                      << jsonCollectionConfigFile << std::endl
+                      << jsonReader.getFormattedErrorMessages();
+            return -1;
+        }
 
-        mtsCollectorQtFactory * collectorQtFactory = new mtsCollectorQtFactory("collectorsQt");
-        collectorQtFactory->SetFactory("collectors");
-        componentManager->AddComponent(collectorQtFactory);
-        collectorQtFactory->Connect();
-        collectorQtFactory->ConnectToWidget(collectorQtWidget);
+        if (!jsonCollection["recorder"].empty()) {
+            // binary recorder, runs in the arms' threads and records every sample
+            if (!mtsIntuitiveResearchKitRecorder::AddRecorders(jsonCollection["recorder"])) {
+                std::cerr << "Failed to configure recorder, check cisstLog for error messages" << std::endl;
+                return -1;
+            }
+        } else {
+            mtsCollectorFactory * collectorFactory = new mtsCollectorFactory("collectors");
+            collectorFactory->Configure(jsonCollectionConfigFile);
+            componentManager->AddComponent(collectorFactory);
+            collectorFactory->Connect();
+
+            mtsCollectorQtWidget * collectorQtWidget = new mtsCollectorQtWidget();
+            consoleQt->addTab(collectorQtWidget, "Collection");
+
+            mtsCollectorQtFactory * collectorQtFactory = new mtsCollectorQtFactory("collectorsQt");
+            collectorQtFactory->SetFactory("collectors");
+            componentManager->AddComponent(collectorQtFactory);
+            collectorQtFactory->Connect();
+            collectorQtFactory->ConnectToWidget(collectorQtWidget);
+        }
     }
 
     // custom user component
@@ -155,16 +182,41 @@ int main(int argc, char ** argv)
         return -1;
     }
 
+    // timing probes, to compare with sawIntuitiveResearchKitConsoleJSON
+    std::list<mtsIntuitiveResearchKitTimingProbe *> probes;
+    if (options.IsSet("timing")) {
+        probes = mtsIntuitiveResearchKitTimingProbe::AddProbes(mtsIntuitiveResearchKit::Benchmark::Resolution,
+                                                               mtsIntuitiveResearchKit::Benchmark::Range);
+    }
+
+    // run time errors from real time threads are written in background
+    mtsIntuitiveResearchKitLog::Start();
+
     //-------------- create the components ------------------
     componentManager->CreateAllAndWait(2.0 * cmn_s);
     componentManager->StartAllAndWait(2.0 * cmn_s);
 
+    for (auto probe : probes) {
+        probe->SetRecording(true);
+    }
+
     application.exec();
 
+    for (auto probe : probes) {
+        probe->SetRecording(false);
+    }
+
     componentManager->KillAllAndWait(2.0 * cmn_s);
     componentManager->Cleanup();
 
+    // times in micro seconds
+    if (!probes.empty()) {
+        std::cout << std::endl;
+        mtsIntuitiveResearchKitTimingProbe::PrintReport(std::cout, probes);
+    }
+
     // stop all logs
+    mtsIntuitiveResearchKitLog::Stop();
     cmnLogger::Kill();
 
     delete consoleQt;
@@ -0,0 +1,127 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// Read-only GUI for a console running in another process, e.g.
+// sawIntuitiveResearchKitConsoleJSON --remote-telemetry.  Arms and
+// teleops are displayed using the shared memory rings published by the
+// console so the GUI never calls any command on the real time
+// components.  If no arm is specified, all rings found in /dev/shm are
+// displayed.
+
+// system
+#include <dirent.h>
+#include <iostream>
+#include <list>
+#include <string>
+
+// cisst/saw
+#include <cisstCommon/cmnCommandLineOptions.h>
+#include <cisstCommon/cmnQt.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRemoteQtWidget.h>
+
+#include <QApplication>
+#include <QIcon>
+#include <QTabWidget>
+
+// arm and teleop names from rings in /dev/shm, Linux only
+std::list<std::string> FindArms(void)
+{
+    std::list<std::string> arms;
+    // shared memory names start with "/" but files in /dev/shm don't
+    const std::string prefix = mtsIntuitiveResearchKit::Remote::Prefix.substr(1);
+    DIR * directory = opendir("/dev/shm");
+    if (!directory) {
+        return arms;
+    }
+    struct dirent * entry;
+    while ((entry = readdir(directory)) != nullptr) {
+        const std::string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) == 0) {
+            arms.push_back(name.substr(prefix.size()));
+        }
+    }
+    closedir(directory);
+    arms.sort();
+    return arms;
+}
+
+int main(int argc, char ** argv)
+{
+    // log configuration
+    cmnLogger::SetMask(CMN_LOG_ALLOW_ALL);
+    cmnLogger::SetMaskDefaultLog(CMN_LOG_ALLOW_ALL);
+    cmnLogger::AddChannel(std::cerr, CMN_LOG_ALLOW_ERRORS_AND_WARNINGS);
+
+    // parse options
+    cmnCommandLineOptions options;
+    std::list<std::string> arms;
+    double period = 50.0 * cmn_ms;
+
+    options.AddOptionMultipleValues("a", "arm",
+                                    "arm(s) or teleop(s) to display, default is all published",
+                                    cmnCommandLineOptions::OPTIONAL_OPTION, &arms);
+
+    options.AddOptionOneValue("p", "period",
+                              "refresh period in seconds, default is 0.05",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &period);
+
+    options.AddOptionNoValue("D", "dark-mode",
+                             "replaces the default Qt palette with darker colors");
+
+    // check that all required options have been provided
+    std::string errorMessage;
+    if (!options.Parse(argc, argv, errorMessage)) {
+        std::cerr << "Error: " << errorMessage << std::endl;
+        options.PrintUsage(std::cerr);
+        return -1;
+    }
+
+    if (arms.empty()) {
+        arms = FindArms();
+        if (arms.empty()) {
+            std::cerr << "No arm published in shared memory, make sure the console runs with --remote-telemetry or use --arm" << std::endl;
+            return -1;
+        }
+    }
+
+    QApplication application(argc, argv);
+    application.setWindowIcon(QIcon(":/dVRK.png"));
+    cmnQt::QApplicationExitsOnCtrlC();
+    if (options.IsSet("dark-mode")) {
+        cmnQt::SetDarkMode();
+    }
+
+    QTabWidget * tabs = new QTabWidget();
+    tabs->setWindowTitle("dVRK remote");
+    for (const auto & arm : arms) {
+        mtsIntuitiveResearchKitRemoteQtWidget * widget =
+            new mtsIntuitiveResearchKitRemoteQtWidget(mtsIntuitiveResearchKit::Remote::Prefix + arm,
+                                                      period);
+        tabs->addTab(widget, arm.c_str());
+        widget->Startup();
+    }
+    tabs->show();
+
+    application.exec();
+
+    delete tabs;
+    cmnLogger::Kill();
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-06
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// Reference client for the shared memory command mailbox.  Reads the
+// arm joint positions from a streamer shared memory ring, then sends
+// servo_jp commands with a sine wave on the last joint.  The arm must
+// have "shared-memory-command" in its configuration file and the
+// console a streamer for the arm with "measured_js" and a
+// "shared-memory" destination.  Once the client is running, call the
+// arm command "use_shared_memory_command" (e.g. using ROS).
+
+// system
+#include <cmath>
+#include <iostream>
+#include <vector>
+// cisst/saw
+#include <cisstCommon/cmnCommandLineOptions.h>
+#include <cisstCommon/cmnConstants.h>
+#include <cisstOSAbstraction/osaSleep.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitStreamFormat.h>
+#include <sawIntuitiveResearchKit/mtsSharedMemoryRing.h>
+#include <sawIntuitiveResearchKit/mtsSharedMemoryCommand.h>
+
+int main(int argc, char ** argv)
+{
+    typedef mtsIntuitiveResearchKitStreamFormat StreamFormat;
+
+    // parse options
+    cmnCommandLineOptions options;
+    std::string armName, stateRingName;
+    double duration = 10.0;
+    double amplitude = 5.0 * cmnPI_180;
+    double frequency = 0.5;
+    double period = 1.0 * cmn_ms;
+
+    options.AddOptionOneValue("a", "arm",
+                              "arm name, as defined in the console configuration file",
+                              cmnCommandLineOptions::REQUIRED_OPTION, &armName);
+    options.AddOptionOneValue("s", "state",
+                              "name of the shared memory ring with the arm state, default is /dvrk-<arm>",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &stateRingName);
+    options.AddOptionOneValue("d", "duration",
+                              "duration in seconds, default is 10",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &duration);
+    options.AddOptionOneValue("m", "amplitude",
+                              "amplitude of the sine wave on the last joint in radians or meters",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &amplitude);
+    options.AddOptionOneValue("f", "frequency",
+                              "frequency of the sine wave in Hz, default is 0.5",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &frequency);
+    options.AddOptionOneValue("p", "period",
+                              "period between commands in seconds, default is 0.001",
+                              cmnCommandLineOptions::OPTIONAL_OPTION, &period);
+
+    if (!options.Parse(argc, argv, std::cerr)) {
+        return -1;
+    }
+    if (stateRingName.empty()) {
+        stateRingName = "/dvrk-" + armName;
+    }
+
+    // arm state
+    mtsSharedMemoryRing stateRing;
+    if (!stateRing.Open(stateRingName)) {
+        std::cerr << "Failed to open arm state: " << stateRing.LastError() << std::endl;
+        return -1;
+    }
+    std::vector<char> buffer(stateRing.MaximumDataSize());
+    uint64_t index;
+    const int size = stateRing.ReadLatest(index, buffer.data(), buffer.size());
+    StreamFormat::Header header;
+    StreamFormat::Sample sample;
+    if ((size <= 0)
+        || !StreamFormat::DecodeHeader(buffer.data(), size, header)
+        || !(header.FieldMask & (1 << StreamFormat::MEASURED_JS))
+        || (StreamFormat::DecodeSample(buffer.data() + StreamFormat::HeaderSize,
+                                       size - StreamFormat::HeaderSize,
+                                       header.FieldMask, sample) == 0)) {
+        std::cerr << "Failed to read measured_js from " << stateRingName
+                  << ", make sure the streamer is running and sends measured_js" << std::endl;
+        return -1;
+    }
+    const vctDoubleVec start(sample.measured_js.Position());
+    std::cout << "Start position: " << start << std::endl;
+
+    // commands
+    mtsSharedMemoryCommand mailbox;
+    if (!mailbox.Open(armName)) {
+        std::cerr << "Failed to open command mailbox for " << armName << ": "
+                  << mailbox.Ring().LastError() << std::endl;
+        return -1;
+    }
+    std::cout << "Sending commands to " << mtsSharedMemoryCommand::RingName(armName)
+              << ", call use_shared_memory_command on the arm to start" << std::endl;
+
+    vctDoubleVec goal(start);
+    const size_t lastJoint = goal.size() - 1;
+    const double startTime = mtsSharedMemoryCommand::Now();
+    size_t numberOfCommands = 0;
+    double now = startTime;
+    while ((now - startTime) < duration) {
+        goal.Element(lastJoint) = start.Element(lastJoint)
+            + amplitude * std::sin(2.0 * cmnPI * frequency * (now - startTime));
+        if (!mailbox.servo_jp(goal.Pointer(), goal.size())) {
+            std::cerr << "Failed to send command" << std::endl;
+            return -1;
+        }
+        numberOfCommands++;
+        osaSleep(period);
+        now = mtsSharedMemoryCommand::Now();
+    }
+
+    std::cout << "Sent " << numberOfCommands << " commands, arm will freeze now" << std::endl;
+    return 0;
+}
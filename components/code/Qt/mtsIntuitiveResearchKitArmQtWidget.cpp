@@ -31,10 +31,12 @@ http://www.cisst.org/cisst/license.txt.
 #include <QCoreApplication>
 
 // cisst
+#include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstMultiTask/mtsInterfaceRequired.h>
 #include <cisstParameterTypes/prmPositionJointGet.h>
 
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArm.h>
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArmQtWidget.h>
 
 
@@ -42,7 +44,9 @@ CMN_IMPLEMENT_SERVICES_DERIVED_ONEARG(mtsIntuitiveResearchKitArmQtWidget, mtsCom
 
 mtsIntuitiveResearchKitArmQtWidget::mtsIntuitiveResearchKitArmQtWidget(const std::string & componentName, double periodInSeconds):
     mtsComponent(componentName),
-    TimerPeriodInMilliseconds(periodInSeconds * 1000),
+    Refresh(periodInSeconds),
+    mDisplaySnapshot(nullptr),
+    mDisplaySequence(0),
     DirectControl(false),
     LogEnabled(false)
 {
@@ -78,7 +82,8 @@ void mtsIntuitiveResearchKitArmQtWidget::Configure(const std::string &filename)
 void mtsIntuitiveResearchKitArmQtWidget::Startup(void)
 {
     setupUi();
-    startTimer(TimerPeriodInMilliseconds); // ms
+    FindDisplaySnapshot();
+    Refresh.Start(this);
     if (!LogEnabled) {
         QMMessage->hide();
     }
@@ -105,39 +110,107 @@ void mtsIntuitiveResearchKitArmQtWidget::closeEvent(QCloseEvent * event)
     }
 }
 
+void mtsIntuitiveResearchKitArmQtWidget::FindDisplaySnapshot(void)
+{
+    mDisplaySnapshot = nullptr;
+    const mtsInterfaceProvided * interfaceProvided = InterfaceRequired->GetConnectedInterface();
+    if (!interfaceProvided) {
+        return;
+    }
+    // will fail for proxies and non dVRK arms, e.g. SUJ
+    const mtsIntuitiveResearchKitArm * arm =
+        dynamic_cast<const mtsIntuitiveResearchKitArm *>(interfaceProvided->GetComponent());
+    if (!arm) {
+        return;
+    }
+    mDisplaySnapshot = &(arm->display_snapshot());
+    mDisplaySequence = mDisplaySnapshot->Sequence();
+    // frame names are not part of the snapshot
+    Arm.measured_cp(Position);
+    Refresh.AddReads();
+}
+
+bool mtsIntuitiveResearchKitArmQtWidget::ReadArm(void)
+{
+    if (!mDisplaySnapshot) {
+        Arm.measured_js(StateJoint);
+        Arm.measured_cp(Position);
+        Refresh.AddReads(2);
+        if (Arm.measured_cf_body.IsValid()) {
+            Arm.measured_cf_body(Wrench);
+            Refresh.AddReads();
+        }
+        return true;
+    }
+
+    // single snapshot written by the arm's thread
+    if (!Refresh.ReadSnapshot(*mDisplaySnapshot, mDisplaySequence, mDisplayData)) {
+        return false;
+    }
+    const size_t nbJoints = mDisplayData.number_of_joints;
+    StateJoint.Position().SetSize(nbJoints);
+    StateJoint.Velocity().SetSize(nbJoints);
+    StateJoint.Effort().SetSize(nbJoints);
+    for (size_t index = 0; index < nbJoints; ++index) {
+        StateJoint.Position().Element(index) = mDisplayData.measured_jp.Element(index);
+        StateJoint.Velocity().Element(index) = mDisplayData.measured_jv.Element(index);
+        StateJoint.Effort().Element(index) = mDisplayData.measured_jf.Element(index);
+    }
+    StateJoint.Valid() = mDisplayData.measured_js_valid;
+    StateJoint.Timestamp() = mDisplayData.measured_js_timestamp;
+    Position.Position().From(mDisplayData.measured_cp);
+    Position.Valid() = mDisplayData.measured_cp_valid;
+    Position.Timestamp() = mDisplayData.measured_cp_timestamp;
+    Wrench.Force().Assign(mDisplayData.body_measured_cf);
+    Wrench.Valid() = mDisplayData.body_measured_cf_valid;
+    Wrench.Timestamp() = mDisplayData.body_measured_cf_timestamp;
+    return true;
+}
+
 void mtsIntuitiveResearchKitArmQtWidget::timerEvent(QTimerEvent * CMN_UNUSED(event))
 {
-    // make sure we should update the display
-    if (this->isHidden()) {
+    // make sure we should update the display, also adjusts timer period
+    if (!Refresh.Tick()) {
         return;
     }
 
-    mtsExecutionResult executionResult;
+    typedef mtsIntuitiveResearchKitRefreshRate RefreshRate;
+    const double positionPrecision = mtsIntuitiveResearchKit::Display::PositionPrecision;
+    const double effortPrecision = mtsIntuitiveResearchKit::Display::EffortPrecision;
 
-    executionResult = Arm.measured_js(StateJoint);
-    if (executionResult) {
-        if ((ConfigurationJoint.Name().size() != StateJoint.Name().size())
+    if (ReadArm()) {
+        // joint names are not in the display snapshot, use configuration
+        if ((ConfigurationJoint.Name().size() != StateJoint.Position().size())
             && (Arm.configuration_js.IsValid())) {
             Arm.configuration_js(ConfigurationJoint);
+            Refresh.AddReads();
             QSJWidget->SetConfiguration(ConfigurationJoint);
         }
-        QSJWidget->SetValue(StateJoint);
-    }
-
-    executionResult = Arm.measured_cp(Position);
-    if (executionResult) {
-        QCPGWidget->SetValue(Position);
-    }
-
-    executionResult = Arm.measured_cf_body(Wrench);
-    if (executionResult) {
+        // only redraw if values changed beyond display precision
+        if ((StateJoint.Valid() != StateJointDisplayed.Valid())
+            || RefreshRate::Changed(StateJointDisplayed.Position(), StateJoint.Position(), positionPrecision)
+            || RefreshRate::Changed(StateJointDisplayed.Velocity(), StateJoint.Velocity(), positionPrecision)
+            || RefreshRate::Changed(StateJointDisplayed.Effort(), StateJoint.Effort(), effortPrecision)) {
+            QSJWidget->SetValue(StateJoint);
+            StateJointDisplayed = StateJoint;
+        }
+        if ((Position.Valid() != PositionDisplayed.Valid())
+            || RefreshRate::ChangedFrame(PositionDisplayed.Position(), Position.Position(), positionPrecision)) {
+            QCPGWidget->SetValue(Position);
+            PositionDisplayed = Position;
+        }
+        // wrench plot is time based, always updated
         if (Wrench.Valid()) {
             QFTWidget->SetValue(Wrench.F(), Wrench.T(), Wrench.Timestamp());
         }
     }
 
-    Arm.period_statistics(IntervalStatistics);
-    QMIntervalStatistics->SetValue(IntervalStatistics);
+    // statistics are only computed once per second by the arm
+    if (Refresh.StatisticsDue()) {
+        Arm.period_statistics(IntervalStatistics);
+        Refresh.AddReads();
+        QMIntervalStatistics->SetValue(IntervalStatistics);
+    }
 
     // for derived classes
     this->timerEventDerived();
@@ -216,9 +289,13 @@ void mtsIntuitiveResearchKitArmQtWidget::setupUi(void)
 
     MainLayout->addLayout(topLayout);
 
-    // timing
+    // timing and load put on the arm by this widget
+    QVBoxLayout * timingLayout = new QVBoxLayout;
+    timingLayout->setContentsMargins(0, 0, 0, 0);
     QMIntervalStatistics = new mtsQtWidgetIntervalStatistics();
-    topLayout->addWidget(QMIntervalStatistics, 0, 0);
+    timingLayout->addWidget(QMIntervalStatistics);
+    timingLayout->addWidget(Refresh.QLLoad);
+    topLayout->addLayout(timingLayout, 0, 0);
 
     // joint state
     QSJWidget = new prmStateJointQtWidget();
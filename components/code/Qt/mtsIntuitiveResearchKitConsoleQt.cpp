@@ -206,8 +206,16 @@ void mtsIntuitiveResearchKitConsoleQt::Configure(mtsIntuitiveResearchKitConsole
 
             break;
 
-        case mtsIntuitiveResearchKitConsole::Arm::ARM_PSM_SOCKET:
+        case mtsIntuitiveResearchKitConsole::Arm::ARM_MTM_SOCKET:
+        case mtsIntuitiveResearchKitConsole::Arm::ARM_ECM_SOCKET:
+            // always bridged
+            break;
 
+        case mtsIntuitiveResearchKitConsole::Arm::ARM_PSM_SOCKET:
+            // bridged arms share a single widget, see below
+            if (armIter->second->m_socket_bridged) {
+                break;
+            }
             socketGUI = new mtsSocketBaseQtWidget(name + "-GUI");
             socketGUI->setObjectName(name.c_str());
             socketGUI->Configure();
@@ -251,6 +259,17 @@ void mtsIntuitiveResearchKitConsoleQt::Configure(mtsIntuitiveResearchKitConsole
         }
     }
 
+    // socket bridge, single widget for all arms
+    if (console->mSocketBridge.Configured) {
+        const std::string name = console->mSocketBridge.ComponentName;
+        mtsSocketBaseQtWidget * socketGUI = new mtsSocketBaseQtWidget(name + "-GUI");
+        socketGUI->setObjectName(name.c_str());
+        socketGUI->Configure();
+        componentManager->AddComponent(socketGUI);
+        Connections.Add(socketGUI->GetName(), "SocketBase", name, "System");
+        armTabWidget->addTab(socketGUI, name.c_str());
+    }
+
     // add teleop PSM widgets
     bool hasTeleOp = false;
 
@@ -144,6 +144,7 @@ void mtsIntuitiveResearchKitPSMQtWidget::timerEventDerived(void)
     if ((QCBToolOptions->count() == 1) && tool_list_size.IsValid()) {
         size_t nb_tools;
         tool_list_size(nb_tools);
+        Refresh.AddReads(nb_tools + 1);
         for (size_t index = 0;
              index < nb_tools;
              ++index) {
@@ -155,6 +156,7 @@ void mtsIntuitiveResearchKitPSMQtWidget::timerEventDerived(void)
 
     // get jaw data
     Jaw.measured_js(m_jaw_measured_js);
+    Refresh.AddReads();
 
     QString text;
     if (m_jaw_measured_js.Position().size() > 0) {
@@ -0,0 +1,78 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// Qt include
+#include <QLabel>
+#include <QWidget>
+
+// cisst
+#include <cisstOSAbstraction/osaGetTime.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitQtRefresh.h>
+
+mtsIntuitiveResearchKitQtRefresh::mtsIntuitiveResearchKitQtRefresh(const double periodInSeconds):
+    mtsIntuitiveResearchKitRefreshRate(periodInSeconds,
+                                       mtsIntuitiveResearchKit::Display::UnfocusedFactor,
+                                       mtsIntuitiveResearchKit::Display::MinimizedPeriod,
+                                       mtsIntuitiveResearchKit::Display::LoadInterval),
+    mWidget(nullptr),
+    mTimerId(0),
+    mTime(0.0),
+    mLastStatistics(-mtsIntuitiveResearchKit::Display::StatisticsPeriod)
+{
+    QLLoad = new QLabel("GUI load: -");
+    QLLoad->setToolTip("Read commands and snapshots requested per second by this widget");
+}
+
+void mtsIntuitiveResearchKitQtRefresh::Start(QWidget * widget)
+{
+    mWidget = widget;
+    mTimerId = mWidget->startTimer(CurrentPeriod() * 1000.0); // ms
+}
+
+bool mtsIntuitiveResearchKitQtRefresh::Tick(void)
+{
+    VisibilityType visibility = REFRESH_FOCUSED;
+    if (mWidget->isHidden() || mWidget->window()->isMinimized()) {
+        visibility = REFRESH_MINIMIZED;
+    } else if (!mWidget->isActiveWindow()) {
+        visibility = REFRESH_UNFOCUSED;
+    }
+    if (SetVisibility(visibility)) {
+        mWidget->killTimer(mTimerId);
+        mTimerId = mWidget->startTimer(CurrentPeriod() * 1000.0); // ms
+    }
+
+    mTime = osaGetTime();
+    if (UpdateLoad(mTime)) {
+        QLLoad->setText(QString("GUI load: %1 reads/s, %2 snapshots/s")
+                        .arg(ReadsPerSecond(), 0, 'f', 1)
+                        .arg(SnapshotsPerSecond(), 0, 'f', 1));
+    }
+    return (visibility != REFRESH_MINIMIZED);
+}
+
+bool mtsIntuitiveResearchKitQtRefresh::StatisticsDue(void)
+{
+    if ((mTime - mLastStatistics) < mtsIntuitiveResearchKit::Display::StatisticsPeriod) {
+        return false;
+    }
+    mLastStatistics = mTime;
+    return true;
+}
@@ -0,0 +1,230 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+// Qt include
+#include <QString>
+#include <QLabel>
+#include <QGridLayout>
+#include <QVBoxLayout>
+
+// cisst
+#include <cisstOSAbstraction/osaGetTime.h>
+#include <cisstVector/vctAxisAngleRotation3.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRemoteQtWidget.h>
+
+mtsIntuitiveResearchKitRemoteQtWidget::mtsIntuitiveResearchKitRemoteQtWidget(const std::string & ringName,
+                                                                             double periodInSeconds):
+    TimerPeriodInMilliseconds(periodInSeconds * 1000),
+    mRingName(ringName),
+    mLastWriteCount(0),
+    mLastWriteTime(0.0),
+    mLastIndex(0),
+    mLastTimestamp(0.0)
+{
+}
+
+void mtsIntuitiveResearchKitRemoteQtWidget::Startup(void)
+{
+    setupUi();
+    startTimer(TimerPeriodInMilliseconds); // ms
+    if (!parent()) {
+        show();
+    }
+}
+
+void mtsIntuitiveResearchKitRemoteQtWidget::SetStatus(const QString & status)
+{
+    QLStatus->setText(status);
+}
+
+bool mtsIntuitiveResearchKitRemoteQtWidget::Read(void)
+{
+    const double now = osaGetTime();
+
+    // console not started yet or restarted
+    if (!mRing.IsOpen()) {
+        if (!mRing.Open(mRingName)) {
+            SetStatus(QString("waiting for %1").arg(mRingName.c_str()));
+            return false;
+        }
+        mBuffer.resize(mRing.MaximumDataSize());
+        mLastWriteCount = mRing.WriteCount();
+        mLastWriteTime = now;
+        mLastTimestamp = 0.0;
+        SetStatus(QString("%1 (%2)").arg(mRingName.c_str()).arg(mRing.Source().c_str()));
+    }
+
+    // a ring removed by the writer stays mapped, close it so it can be re-opened
+    const uint64_t writeCount = mRing.WriteCount();
+    if (writeCount == mLastWriteCount) {
+        if ((now - mLastWriteTime) > mtsIntuitiveResearchKit::Remote::Timeout) {
+            mRing.Close();
+            SetStatus(QString("no data from %1").arg(mRingName.c_str()));
+        }
+        return false;
+    }
+    mLastWriteCount = writeCount;
+    mLastWriteTime = now;
+
+    uint64_t index;
+    const int size = mRing.ReadLatest(index, mBuffer.data(), mBuffer.size());
+    if (size <= 0) {
+        return false;
+    }
+    const size_t dataSize = static_cast<size_t>(size);
+    if (!StreamFormat::DecodeHeader(mBuffer.data(), dataSize, mHeader)) {
+        return false;
+    }
+    // only the last sample of the datagram is displayed
+    size_t offset = StreamFormat::HeaderSize;
+    for (uint16_t sample = 0; sample < mHeader.NumberOfSamples; ++sample) {
+        const size_t used = StreamFormat::DecodeSample(mBuffer.data() + offset, dataSize - offset,
+                                                       mHeader.FieldMask, mSample);
+        if (used == 0) {
+            return false;
+        }
+        offset += used;
+    }
+    return (mHeader.NumberOfSamples > 0);
+}
+
+void mtsIntuitiveResearchKitRemoteQtWidget::timerEvent(QTimerEvent * CMN_UNUSED(event))
+{
+    // make sure we should update the display
+    if (this->isHidden()) {
+        return;
+    }
+
+    if (!Read()) {
+        if (mRing.IsOpen()) {
+            QLAge->setText(QString::number((osaGetTime() - mLastWriteTime) * 1000.0, 'f', 0));
+        }
+        return;
+    }
+    QLAge->setText("0");
+
+    // arm cycles per second, based on the arm's clock
+    if ((mLastTimestamp != 0.0) && (mSample.Timestamp > mLastTimestamp)) {
+        const double rate = (mSample.Index - mLastIndex) / (mSample.Timestamp - mLastTimestamp);
+        QLRate->setText(QString::number(rate, 'f', 0));
+    }
+    mLastIndex = mSample.Index;
+    mLastTimestamp = mSample.Timestamp;
+
+    if (mHeader.FieldMask & (1 << StreamFormat::OPERATING_STATE)) {
+        const prmOperatingState & state = mSample.operating_state;
+        QString text = prmOperatingState::StateTypeToString(state.State()).c_str();
+        text.append(state.IsHomed() ? ", homed" : ", not homed");
+        if (state.IsBusy()) {
+            text.append(", busy");
+        }
+        QLState->setText(text);
+    }
+    if (mHeader.FieldMask & (1 << StreamFormat::TELEOP_STATE)) {
+        const StreamFormat::TeleopState & teleop = mSample.teleop_state;
+        QString text = teleop.following ? "following" : "not following";
+        if (teleop.clutched) {
+            text.append(", clutched");
+        }
+        if (teleop.operator_present) {
+            text.append(", operator present");
+        }
+        text.append(QString(", scale %1").arg(teleop.scale, 0, 'f', 2));
+        const vctAxAnRot3 offset(teleop.alignment_offset, VCT_NORMALIZE);
+        text.append(QString(", offset %1 deg").arg(offset.Angle() * cmn180_PI, 0, 'f', 1));
+        QLTeleop->setText(text);
+        QLTeleop->setVisible(teleop.Valid);
+        QLTeleopLabel->setVisible(teleop.Valid);
+    }
+    if (mHeader.FieldMask & (1 << StreamFormat::MEASURED_JS)) {
+        QSJWidget->SetValue(mSample.measured_js);
+    }
+    if (mHeader.FieldMask & (1 << StreamFormat::MEASURED_CP)) {
+        QCPGWidget->SetValue(mSample.measured_cp);
+    }
+    if ((mHeader.FieldMask & (1 << StreamFormat::BODY_MEASURED_CF))
+        && mSample.body_measured_cf.Valid()) {
+        QFTWidget->SetValue(mSample.body_measured_cf.F(),
+                            mSample.body_measured_cf.T(),
+                            mSample.body_measured_cf.Timestamp());
+    }
+}
+
+void mtsIntuitiveResearchKitRemoteQtWidget::setupUi(void)
+{
+    QVBoxLayout * mainLayout = new QVBoxLayout;
+    mainLayout->setContentsMargins(1, 1, 1, 1);
+    setLayout(mainLayout);
+    setWindowTitle(mRingName.c_str());
+
+    // status
+    QGridLayout * statusLayout = new QGridLayout;
+    mainLayout->addLayout(statusLayout);
+    int row = 0;
+    QLStatus = new QLabel();
+    statusLayout->addWidget(QLStatus, row, 0, 1, 2);
+    row++;
+
+    statusLayout->addWidget(new QLabel("State"), row, 0);
+    QLState = new QLabel();
+    statusLayout->addWidget(QLState, row, 1);
+    row++;
+
+    // only for teleop rings
+    QLTeleopLabel = new QLabel("Teleop");
+    statusLayout->addWidget(QLTeleopLabel, row, 0);
+    QLTeleop = new QLabel();
+    statusLayout->addWidget(QLTeleop, row, 1);
+    QLTeleopLabel->hide();
+    QLTeleop->hide();
+    row++;
+
+    statusLayout->addWidget(new QLabel("Arm rate (Hz)"), row, 0);
+    QLRate = new QLabel();
+    statusLayout->addWidget(QLRate, row, 1);
+    row++;
+
+    statusLayout->addWidget(new QLabel("Last update (ms)"), row, 0);
+    QLAge = new QLabel();
+    statusLayout->addWidget(QLAge, row, 1);
+    row++;
+
+    QGridLayout * dataLayout = new QGridLayout;
+    dataLayout->setContentsMargins(1, 1, 1, 1);
+    dataLayout->setColumnStretch(1, 1);
+    mainLayout->addLayout(dataLayout);
+
+    // joint state
+    QSJWidget = new prmStateJointQtWidget();
+    QSJWidget->setupUi();
+    QSJWidget->SetPrismaticRevoluteFactors(1.0 / cmn_mm, cmn180_PI);
+    dataLayout->addWidget(QSJWidget, 0, 0, 1, 2);
+
+    // 3D position
+    QCPGWidget = new prmPositionCartesianGetQtWidget();
+    QCPGWidget->SetPrismaticRevoluteFactors(1.0 / cmn_mm, cmn180_PI);
+    dataLayout->addWidget(QCPGWidget, 1, 0);
+
+    // wrench
+    QFTWidget = new vctForceTorqueQtWidget();
+    dataLayout->addWidget(QFTWidget, 1, 1);
+
+    mainLayout->addStretch();
+}
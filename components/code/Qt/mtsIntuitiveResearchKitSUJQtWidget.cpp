@@ -195,6 +195,7 @@ void mtsIntuitiveResearchKitSUJQtWidget::timerEventDerived(void)
         QVPrimaryVoltagesWidget->SetValue(mVoltages[0]);
         GetSecondaryVoltages(mVoltages[1]);
         QVSecondaryVoltagesWidget->SetValue(mVoltages[1]);
+        Refresh.AddReads(4);
         // calibration data
         QVPotentiometerRecalibrationStartWidget->SetValue(JointPositionStart);
         QVPotentiometerRecalibrationFinishWidget->SetValue(JointPositionFinish);
@@ -25,6 +25,8 @@ http://www.cisst.org/cisst/license.txt.
 #include <QtGui>
 #include <QMessageBox>
 // cisst
+#include <cisstVector/vctFixedSizeVectorTypes.h>
+#include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstMultiTask/mtsInterfaceRequired.h>
 #include <sawIntuitiveResearchKit/mtsSocketBaseQtWidget.h>
 
@@ -33,7 +35,9 @@ CMN_IMPLEMENT_SERVICES_DERIVED_ONEARG(mtsSocketBaseQtWidget, mtsComponent, std::
 
 mtsSocketBaseQtWidget::mtsSocketBaseQtWidget(const std::string & componentName, double periodInSeconds):
     mtsComponent(componentName),
-    TimerPeriodInMilliseconds(periodInSeconds * 1000)
+    Refresh(periodInSeconds),
+    mDisplaySnapshot(nullptr),
+    mDisplaySequence(0)
 {
 
     // Setup CISST Interface
@@ -45,6 +49,18 @@ mtsSocketBaseQtWidget::mtsSocketBaseQtWidget(const std::string & componentName,
         interfaceRequired->AddFunction("GetLastReceivedPacketId", SocketBase.GetLastReceivedPacketId);
         interfaceRequired->AddFunction("GetLastSentPacketId", SocketBase.GetLastSentPacketId);
         interfaceRequired->AddFunction("period_statistics", SocketBase.period_statistics);
+        interfaceRequired->AddFunction("GetClockOffset", SocketBase.GetClockOffset);
+        interfaceRequired->AddFunction("GetClockDrift", SocketBase.GetClockDrift);
+        interfaceRequired->AddFunction("GetRoundTripTime", SocketBase.GetRoundTripTime);
+        interfaceRequired->AddFunction("GetLatencyIn", SocketBase.GetLatencyIn);
+        interfaceRequired->AddFunction("GetLatencyOut", SocketBase.GetLatencyOut);
+        interfaceRequired->AddFunction("GetPacketsStale", SocketBase.GetPacketsStale);
+        interfaceRequired->AddFunction("GetPlayoutDelay", SocketBase.GetPlayoutDelay, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("GetJitter", SocketBase.GetJitter, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("GetPacketsReordered", SocketBase.GetPacketsReordered, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("GetPacketsLate", SocketBase.GetPacketsLate, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("GetPlayoutExtrapolated", SocketBase.GetPlayoutExtrapolated, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("GetPlayoutHolds", SocketBase.GetPlayoutHolds, MTS_OPTIONAL);
     }
 }
 
@@ -56,7 +72,8 @@ void mtsSocketBaseQtWidget::Configure(const std::string &filename)
 void mtsSocketBaseQtWidget::Startup(void)
 {
     setupUi();
-    startTimer(TimerPeriodInMilliseconds); // ms    
+    FindDisplaySnapshot();
+    Refresh.Start(this);
     if (!parent()) {
         show();
     }
@@ -80,32 +97,110 @@ void mtsSocketBaseQtWidget::closeEvent(QCloseEvent * event)
     }
 }
 
-void mtsSocketBaseQtWidget::timerEvent(QTimerEvent * CMN_UNUSED(event))
+void mtsSocketBaseQtWidget::FindDisplaySnapshot(void)
 {
-    // make sure we should update the display
-    if (this->isHidden()) {
+    mDisplaySnapshot = nullptr;
+    const mtsInterfaceRequired * interfaceRequired = GetInterfaceRequired("SocketBase");
+    if (!interfaceRequired) {
+        return;
+    }
+    const mtsInterfaceProvided * interfaceProvided = interfaceRequired->GetConnectedInterface();
+    if (!interfaceProvided) {
         return;
     }
+    // will fail for proxies
+    const mtsSocketBasePSM * socket =
+        dynamic_cast<const mtsSocketBasePSM *>(interfaceProvided->GetComponent());
+    if (!socket) {
+        return;
+    }
+    mDisplaySnapshot = &(socket->DisplaySnapshot());
+    mDisplaySequence = mDisplaySnapshot->Sequence();
+}
 
-    unsigned int packet;
-    SocketBase.GetLastSentPacketId(packet);
-    SocketBase.QLLastSentPacketId->setText(QString::number(packet));
+bool mtsSocketBaseQtWidget::ReadSocket(void)
+{
+    // single snapshot written by the socket's thread
+    if (mDisplaySnapshot) {
+        return Refresh.ReadSnapshot(*mDisplaySnapshot, mDisplaySequence, mDisplayData);
+    }
 
-    SocketBase.GetLastReceivedPacketId(packet);
-    SocketBase.QLLastReceivedPacketId->setText(QString::number(packet));
+    SocketBase.GetLastSentPacketId(mDisplayData.LastSentPacketId);
+    SocketBase.GetLastReceivedPacketId(mDisplayData.LastReceivedPacketId);
+    SocketBase.GetPacketsLost(mDisplayData.PacketsLost);
+    SocketBase.GetPacketsDelayed(mDisplayData.PacketsDelayed);
+    SocketBase.GetPacketsStale(mDisplayData.PacketsStale);
+    SocketBase.GetLoopTime(mDisplayData.LoopTime);
+    SocketBase.GetClockOffset(mDisplayData.ClockOffset);
+    SocketBase.GetClockDrift(mDisplayData.ClockDrift);
+    SocketBase.GetRoundTripTime(mDisplayData.RoundTripTime);
+    SocketBase.GetLatencyIn(mDisplayData.LatencyIn);
+    SocketBase.GetLatencyOut(mDisplayData.LatencyOut);
+    Refresh.AddReads(11);
 
-    SocketBase.GetPacketsLost(packet);
-    SocketBase.QLPacketsLost->setText(QString::number(packet));
+    // jitter buffer statistics are only provided by socket servers
+    mDisplayData.HasJitterBuffer = SocketBase.GetPlayoutDelay.IsValid();
+    if (mDisplayData.HasJitterBuffer) {
+        SocketBase.GetPlayoutDelay(mDisplayData.PlayoutDelay);
+        SocketBase.GetJitter(mDisplayData.Jitter);
+        SocketBase.GetPacketsReordered(mDisplayData.PacketsReordered);
+        SocketBase.GetPacketsLate(mDisplayData.PacketsLate);
+        SocketBase.GetPlayoutExtrapolated(mDisplayData.PlayoutExtrapolated);
+        SocketBase.GetPlayoutHolds(mDisplayData.PlayoutHolds);
+        Refresh.AddReads(6);
+    }
+    return true;
+}
 
-    SocketBase.GetPacketsDelayed(packet);
-    SocketBase.QLPacketsDelayed->setText(QString::number(packet));
+void mtsSocketBaseQtWidget::timerEvent(QTimerEvent * CMN_UNUSED(event))
+{
+    // make sure we should update the display, also adjusts timer period
+    if (!Refresh.Tick()) {
+        return;
+    }
 
-    double loopTime;
-    SocketBase.GetLoopTime(loopTime);
-    SocketBase.QLLoopTime->setText(QString::number(loopTime * 1000.0, 'g', 3));
+    // QLabel::setText doesn't redraw if the text, i.e. value at
+    // display precision, didn't change
+    if (ReadSocket()) {
+        const mtsSocketBasePSMDisplayData & data = mDisplayData;
+        SocketBase.QLLastSentPacketId->setText(QString::number(data.LastSentPacketId));
+        SocketBase.QLLastReceivedPacketId->setText(QString::number(data.LastReceivedPacketId));
+        SocketBase.QLPacketsLost->setText(QString::number(data.PacketsLost));
+        SocketBase.QLPacketsDelayed->setText(QString::number(data.PacketsDelayed));
+        SocketBase.QLLoopTime->setText(QString::number(data.LoopTime * 1000.0, 'g', 3));
+        SocketBase.QLClockOffset->setText(QString::number(data.ClockOffset, 'f', 6));
+        SocketBase.QLClockDrift->setText(QString::number(data.ClockDrift * 1.0e6, 'f', 1));
+        SocketBase.QLRoundTripTime->setText(QString::number(data.RoundTripTime * 1000.0, 'g', 3));
+        // distributions are min, mean, std, 99th percentile, max
+        SocketBase.QLLatencyIn->setText(QString("%1 / %2 / %3")
+                                        .arg(data.LatencyIn[1] * 1000.0, 0, 'g', 3)
+                                        .arg(data.LatencyIn[3] * 1000.0, 0, 'g', 3)
+                                        .arg(data.LatencyIn[4] * 1000.0, 0, 'g', 3));
+        SocketBase.QLLatencyOut->setText(QString("%1 / %2 / %3")
+                                         .arg(data.LatencyOut[1] * 1000.0, 0, 'g', 3)
+                                         .arg(data.LatencyOut[3] * 1000.0, 0, 'g', 3)
+                                         .arg(data.LatencyOut[4] * 1000.0, 0, 'g', 3));
+        SocketBase.QLPacketsStale->setText(QString::number(data.PacketsStale));
+
+        if (data.HasJitterBuffer) {
+            SocketBase.QWJitterBuffer->show();
+            SocketBase.QLPlayoutDelay->setText(QString::number(data.PlayoutDelay * 1000.0, 'g', 3));
+            SocketBase.QLJitter->setText(QString::number(data.Jitter * 1000.0, 'g', 3));
+            SocketBase.QLPacketsReordered->setText(QString::number(data.PacketsReordered));
+            SocketBase.QLPacketsLate->setText(QString::number(data.PacketsLate));
+            SocketBase.QLPlayoutExtrapolated->setText(QString::number(data.PlayoutExtrapolated));
+            SocketBase.QLPlayoutHolds->setText(QString::number(data.PlayoutHolds));
+        } else {
+            SocketBase.QWJitterBuffer->hide();
+        }
+    }
 
-    SocketBase.period_statistics(IntervalStatistics);
-    QMIntervalStatistics->SetValue(IntervalStatistics);
+    // statistics are only computed once per second by the component
+    if (Refresh.StatisticsDue()) {
+        SocketBase.period_statistics(IntervalStatistics);
+        Refresh.AddReads();
+        QMIntervalStatistics->SetValue(IntervalStatistics);
+    }
 }
 
 void mtsSocketBaseQtWidget::setupUi(void)
@@ -146,10 +241,79 @@ void mtsSocketBaseQtWidget::setupUi(void)
     SocketBase.QLLoopTime = new QLabel();
     grid->addWidget(SocketBase.QLLoopTime, row, 1);
     row++;
+
+    grid->addWidget(new QLabel("Clock offset (s)"), row, 0);
+    SocketBase.QLClockOffset = new QLabel();
+    grid->addWidget(SocketBase.QLClockOffset, row, 1);
+    row++;
+
+    grid->addWidget(new QLabel("Clock drift (ppm)"), row, 0);
+    SocketBase.QLClockDrift = new QLabel();
+    grid->addWidget(SocketBase.QLClockDrift, row, 1);
+    row++;
+
+    grid->addWidget(new QLabel("Round trip (ms)"), row, 0);
+    SocketBase.QLRoundTripTime = new QLabel();
+    grid->addWidget(SocketBase.QLRoundTripTime, row, 1);
+    row++;
+
+    grid->addWidget(new QLabel("Latency in, mean/99%/max (ms)"), row, 0);
+    SocketBase.QLLatencyIn = new QLabel();
+    grid->addWidget(SocketBase.QLLatencyIn, row, 1);
+    row++;
+
+    grid->addWidget(new QLabel("Latency out, mean/99%/max (ms)"), row, 0);
+    SocketBase.QLLatencyOut = new QLabel();
+    grid->addWidget(SocketBase.QLLatencyOut, row, 1);
+    row++;
+
+    grid->addWidget(new QLabel("Packets stale"), row, 0);
+    SocketBase.QLPacketsStale = new QLabel();
+    grid->addWidget(SocketBase.QLPacketsStale, row, 1);
+    row++;
+
+    // jitter buffer
+    SocketBase.QWJitterBuffer = new QWidget();
+    QGridLayout * jitterGrid = new QGridLayout();
+    jitterGrid->setContentsMargins(0, 0, 0, 0);
+    SocketBase.QWJitterBuffer->setLayout(jitterGrid);
+    socketlayout->addWidget(SocketBase.QWJitterBuffer);
+    row = 0;
+
+    jitterGrid->addWidget(new QLabel("Playout delay (ms)"), row, 0);
+    SocketBase.QLPlayoutDelay = new QLabel();
+    jitterGrid->addWidget(SocketBase.QLPlayoutDelay, row, 1);
+    row++;
+
+    jitterGrid->addWidget(new QLabel("Jitter (ms)"), row, 0);
+    SocketBase.QLJitter = new QLabel();
+    jitterGrid->addWidget(SocketBase.QLJitter, row, 1);
+    row++;
+
+    jitterGrid->addWidget(new QLabel("Packets reordered"), row, 0);
+    SocketBase.QLPacketsReordered = new QLabel();
+    jitterGrid->addWidget(SocketBase.QLPacketsReordered, row, 1);
+    row++;
+
+    jitterGrid->addWidget(new QLabel("Packets late"), row, 0);
+    SocketBase.QLPacketsLate = new QLabel();
+    jitterGrid->addWidget(SocketBase.QLPacketsLate, row, 1);
+    row++;
+
+    jitterGrid->addWidget(new QLabel("Extrapolated"), row, 0);
+    SocketBase.QLPlayoutExtrapolated = new QLabel();
+    jitterGrid->addWidget(SocketBase.QLPlayoutExtrapolated, row, 1);
+    row++;
+
+    jitterGrid->addWidget(new QLabel("Holds"), row, 0);
+    SocketBase.QLPlayoutHolds = new QLabel();
+    jitterGrid->addWidget(SocketBase.QLPlayoutHolds, row, 1);
+    row++;
     socketlayout->addStretch();
 
     // timing
     QMIntervalStatistics = new mtsQtWidgetIntervalStatistics();
     mainLayout->addWidget(QMIntervalStatistics);
+    mainLayout->addWidget(Refresh.QLLoad);
     mainLayout->addStretch();
 }
@@ -35,6 +35,7 @@ http://www.cisst.org/cisst/license.txt.
 #include <QHBoxLayout>
 
 // cisst
+#include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstMultiTask/mtsInterfaceRequired.h>
 #include <cisstParameterTypes/prmPositionJointGet.h>
 #include <cisstParameterTypes/prmPositionJointSet.h>
@@ -46,7 +47,9 @@ CMN_IMPLEMENT_SERVICES_DERIVED_ONEARG(mtsTeleOperationPSMQtWidget, mtsComponent,
 
 mtsTeleOperationPSMQtWidget::mtsTeleOperationPSMQtWidget(const std::string & componentName, double periodInSeconds):
     mtsComponent(componentName),
-    TimerPeriodInMilliseconds(periodInSeconds * 1000), // Qt timers are in milliseconds
+    Refresh(periodInSeconds),
+    mDisplaySnapshot(nullptr),
+    mDisplaySequence(0),
     LogEnabled(false)
 {
     QMMessage = new mtsMessageQtWidget();
@@ -91,7 +94,8 @@ void mtsTeleOperationPSMQtWidget::Configure(const std::string &filename)
 void mtsTeleOperationPSMQtWidget::Startup(void)
 {
     setupUi();
-    startTimer(TimerPeriodInMilliseconds);
+    FindDisplaySnapshot();
+    Refresh.Start(this);
     if (!LogEnabled) {
         QMMessage->hide();
     }
@@ -124,41 +128,113 @@ void mtsTeleOperationPSMQtWidget::closeEvent(QCloseEvent * event)
     }
 }
 
-void mtsTeleOperationPSMQtWidget::timerEvent(QTimerEvent * CMN_UNUSED(event))
+void mtsTeleOperationPSMQtWidget::FindDisplaySnapshot(void)
 {
-    // make sure we should update the display
-    if (this->isHidden()) {
+    mDisplaySnapshot = nullptr;
+    const mtsInterfaceRequired * interfaceRequired = GetInterfaceRequired("TeleOperation");
+    if (!interfaceRequired) {
         return;
     }
-
-    // retrieve transformations
+    const mtsInterfaceProvided * interfaceProvided = interfaceRequired->GetConnectedInterface();
+    if (!interfaceProvided) {
+        return;
+    }
+    // will fail for proxies
+    const mtsTeleOperationPSM * teleop =
+        dynamic_cast<const mtsTeleOperationPSM *>(interfaceProvided->GetComponent());
+    if (!teleop) {
+        return;
+    }
+    mDisplaySnapshot = &(teleop->display_snapshot());
+    mDisplaySequence = mDisplaySnapshot->Sequence();
+    // frame names are not part of the snapshot
     TeleOperation.MTM_measured_cp(m_MTM_measured_cp);
-    QCPGMTMWidget->SetValue(m_MTM_measured_cp);
-
-    // for PSM, check if the registration rotation is needed
     TeleOperation.PSM_setpoint_cp(m_PSM_setpoint_cp);
-    TeleOperation.registration_rotation(m_registration_rotation);
-    if (m_registration_rotation.Equal(vctMatRot3::Identity())) {
-        QCPGPSMWidget->SetValue(m_PSM_setpoint_cp);
-    } else {
-        prmPositionCartesianGet registeredPSM;
-        registeredPSM.Valid() = m_PSM_setpoint_cp.Valid();
-        registeredPSM.Timestamp() = m_PSM_setpoint_cp.Timestamp();
-        registeredPSM.MovingFrame() = m_PSM_setpoint_cp.MovingFrame();
-        registeredPSM.ReferenceFrame() = "rot * " + m_PSM_setpoint_cp.ReferenceFrame();
-        m_registration_rotation.ApplyInverseTo(m_PSM_setpoint_cp.Position().Rotation(),
-                                               registeredPSM.Position().Rotation());
-        m_registration_rotation.ApplyInverseTo(m_PSM_setpoint_cp.Position().Translation(),
-                                               registeredPSM.Position().Translation());
-        QCPGPSMWidget->SetValue(registeredPSM);
+    Refresh.AddReads(2);
+}
+
+bool mtsTeleOperationPSMQtWidget::ReadTeleOperation(void)
+{
+    if (!mDisplaySnapshot) {
+        TeleOperation.MTM_measured_cp(m_MTM_measured_cp);
+        TeleOperation.PSM_setpoint_cp(m_PSM_setpoint_cp);
+        TeleOperation.registration_rotation(m_registration_rotation);
+        TeleOperation.alignment_offset(m_alignment_offset);
+        Refresh.AddReads(4);
+        return true;
     }
 
-    // alignment offset
-    TeleOperation.alignment_offset(m_alignment_offset);
-    QVRAlignOffset->SetValue(m_alignment_offset);
+    // single snapshot written by the teleoperation's thread
+    if (!Refresh.ReadSnapshot(*mDisplaySnapshot, mDisplaySequence, mDisplayData)) {
+        return false;
+    }
+    m_MTM_measured_cp.Position().Assign(mDisplayData.MTM_measured_cp);
+    m_MTM_measured_cp.Valid() = mDisplayData.MTM_measured_cp_valid;
+    m_MTM_measured_cp.Timestamp() = mDisplayData.MTM_measured_cp_timestamp;
+    m_PSM_setpoint_cp.Position().Assign(mDisplayData.PSM_setpoint_cp);
+    m_PSM_setpoint_cp.Valid() = mDisplayData.PSM_setpoint_cp_valid;
+    m_PSM_setpoint_cp.Timestamp() = mDisplayData.PSM_setpoint_cp_timestamp;
+    m_registration_rotation.Assign(mDisplayData.registration_rotation);
+    m_alignment_offset.Assign(mDisplayData.alignment_offset);
+    return true;
+}
+
+void mtsTeleOperationPSMQtWidget::timerEvent(QTimerEvent * CMN_UNUSED(event))
+{
+    // make sure we should update the display, also adjusts timer period
+    if (!Refresh.Tick()) {
+        return;
+    }
 
-    TeleOperation.period_statistics(m_interval_statistics);
-    QMIntervalStatistics->SetValue(m_interval_statistics);
+    typedef mtsIntuitiveResearchKitRefreshRate RefreshRate;
+    const double precision = mtsIntuitiveResearchKit::Display::PositionPrecision;
+
+    if (ReadTeleOperation()) {
+        // only redraw if values changed beyond display precision
+        if ((m_MTM_measured_cp.Valid() != m_MTM_measured_cp_displayed.Valid())
+            || RefreshRate::ChangedFrame(m_MTM_measured_cp_displayed.Position(),
+                                         m_MTM_measured_cp.Position(), precision)) {
+            QCPGMTMWidget->SetValue(m_MTM_measured_cp);
+            m_MTM_measured_cp_displayed = m_MTM_measured_cp;
+        }
+
+        // for PSM, check if the registration rotation is needed
+        if ((m_PSM_setpoint_cp.Valid() != m_PSM_setpoint_cp_displayed.Valid())
+            || RefreshRate::ChangedFrame(m_PSM_setpoint_cp_displayed.Position(),
+                                         m_PSM_setpoint_cp.Position(), precision)
+            || RefreshRate::Changed(m_registration_rotation_displayed,
+                                    m_registration_rotation, precision)) {
+            if (m_registration_rotation.Equal(vctMatRot3::Identity())) {
+                QCPGPSMWidget->SetValue(m_PSM_setpoint_cp);
+            } else {
+                prmPositionCartesianGet registeredPSM;
+                registeredPSM.Valid() = m_PSM_setpoint_cp.Valid();
+                registeredPSM.Timestamp() = m_PSM_setpoint_cp.Timestamp();
+                registeredPSM.MovingFrame() = m_PSM_setpoint_cp.MovingFrame();
+                registeredPSM.ReferenceFrame() = "rot * " + m_PSM_setpoint_cp.ReferenceFrame();
+                m_registration_rotation.ApplyInverseTo(m_PSM_setpoint_cp.Position().Rotation(),
+                                                       registeredPSM.Position().Rotation());
+                m_registration_rotation.ApplyInverseTo(m_PSM_setpoint_cp.Position().Translation(),
+                                                       registeredPSM.Position().Translation());
+                QCPGPSMWidget->SetValue(registeredPSM);
+            }
+            m_PSM_setpoint_cp_displayed = m_PSM_setpoint_cp;
+            m_registration_rotation_displayed.Assign(m_registration_rotation);
+        }
+
+        // alignment offset
+        if (RefreshRate::Changed(m_alignment_offset_displayed, m_alignment_offset, precision)) {
+            QVRAlignOffset->SetValue(m_alignment_offset);
+            m_alignment_offset_displayed.Assign(m_alignment_offset);
+        }
+    }
+
+    // statistics are only computed once per second by the component
+    if (Refresh.StatisticsDue()) {
+        TeleOperation.period_statistics(m_interval_statistics);
+        Refresh.AddReads();
+        QMIntervalStatistics->SetValue(m_interval_statistics);
+    }
 }
 
 void mtsTeleOperationPSMQtWidget::SlotSetScale(double scale)
@@ -320,6 +396,7 @@ void mtsTeleOperationPSMQtWidget::setupUi(void)
     // Timing
     QMIntervalStatistics = new mtsQtWidgetIntervalStatistics();
     stateAndTimingLayout->addWidget(QMIntervalStatistics);
+    stateAndTimingLayout->addWidget(Refresh.QLLoad);
 
     // messages
     QMMessage->setupUi();
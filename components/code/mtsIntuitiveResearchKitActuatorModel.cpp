@@ -0,0 +1,101 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-18
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitActuatorModel.h>
+
+mtsIntuitiveResearchKitActuatorModel::mtsIntuitiveResearchKitActuatorModel(void):
+    mLatency(0.0),
+    mDelaySteps(0),
+    mDelayIndex(0)
+{
+}
+
+void mtsIntuitiveResearchKitActuatorModel::SetSize(const size_t size)
+{
+    mTimeConstants.assign(size, 0.0);
+    mEffortMaximums.assign(size, std::numeric_limits<double>::max());
+    mEfforts.assign(size, 0.0);
+    mDelayed.assign(size, 0.0);
+    mDelaySteps = 0;
+    mDelayLine.clear();
+    mDelayIndex = 0;
+}
+
+void mtsIntuitiveResearchKitActuatorModel::SetTimeConstant(const size_t index, const double timeConstant)
+{
+    mTimeConstants.at(index) = std::max(timeConstant, 0.0);
+}
+
+void mtsIntuitiveResearchKitActuatorModel::SetEffortMaximum(const size_t index, const double effortMaximum)
+{
+    mEffortMaximums.at(index) = std::abs(effortMaximum);
+}
+
+void mtsIntuitiveResearchKitActuatorModel::SetLatency(const double latency)
+{
+    mLatency = std::max(latency, 0.0);
+}
+
+void mtsIntuitiveResearchKitActuatorModel::Reset(void)
+{
+    std::fill(mEfforts.begin(), mEfforts.end(), 0.0);
+    std::fill(mDelayLine.begin(), mDelayLine.end(), 0.0);
+}
+
+const std::vector<double> & mtsIntuitiveResearchKitActuatorModel::Update(const double * requests,
+                                                                         const double dt)
+{
+    const size_t n = mEfforts.size();
+
+    // delay line is only resized when the step size changes
+    const size_t steps = ((mLatency > 0.0) && (dt > 0.0)) ?
+        static_cast<size_t>(std::floor(mLatency / dt + 0.5)) : 0;
+    if (steps != mDelaySteps) {
+        mDelaySteps = steps;
+        mDelayLine.assign(steps * n, 0.0);
+        mDelayIndex = 0;
+    }
+
+    // oldest request out, latest in
+    const double * delayed = requests;
+    if (mDelaySteps > 0) {
+        double * slot = &(mDelayLine[mDelayIndex * n]);
+        std::copy(slot, slot + n, mDelayed.begin());
+        std::copy(requests, requests + n, slot);
+        mDelayIndex = (mDelayIndex + 1) % mDelaySteps;
+        delayed = mDelayed.data();
+    }
+
+    // first order response, exact for constant request over the step
+    for (size_t index = 0; index < n; ++index) {
+        double & effort = mEfforts[index];
+        const double timeConstant = mTimeConstants[index];
+        if ((timeConstant > 0.0) && (dt > 0.0)) {
+            effort += (delayed[index] - effort) * (1.0 - std::exp(-dt / timeConstant));
+        } else {
+            effort = delayed[index];
+        }
+        const double maximum = mEffortMaximums[index];
+        effort = std::max(-maximum, std::min(effort, maximum));
+    }
+    return mEfforts;
+}
@@ -17,6 +17,8 @@ http://www.cisst.org/cisst/license.txt.
 */
 
 // system include
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <time.h>
 
@@ -31,6 +33,7 @@ http://www.cisst.org/cisst/license.txt.
 #include <sawIntuitiveResearchKit/sawIntuitiveResearchKitRevision.h>
 #include <sawIntuitiveResearchKit/sawIntuitiveResearchKitConfig.h>
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArm.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLog.h>
 
 CMN_IMPLEMENT_SERVICES_DERIVED_ONEARG(mtsIntuitiveResearchKitArm, mtsTaskPeriodic, mtsTaskPeriodicConstructorArg);
 
@@ -39,7 +42,8 @@ mtsIntuitiveResearchKitArm::mtsIntuitiveResearchKitArm(const std::string & compo
     mArmState(componentName, "DISABLED"),
     mStateTableState(100, "State"),
     mStateTableConfiguration(100, "Configuration"),
-    mControlCallback(0)
+    mControlCallback(0),
+    m_messages(mtsIntuitiveResearchKit::Messages::Interval)
 {
     mCartesianImpedanceController = new osaCartesianImpedanceController();
 }
@@ -49,7 +53,8 @@ mtsIntuitiveResearchKitArm::mtsIntuitiveResearchKitArm(const mtsTaskPeriodicCons
     mArmState(arg.Name, "DISABLED"),
     mStateTableState(100, "State"),
     mStateTableConfiguration(100, "Configuration"),
-    mControlCallback(0)
+    mControlCallback(0),
+    m_messages(mtsIntuitiveResearchKit::Messages::Interval)
 {
     mCartesianImpedanceController = new osaCartesianImpedanceController();
 }
@@ -207,8 +212,6 @@ void mtsIntuitiveResearchKitArm::Init(void)
     m_effort_orientation_locked = false;
 
     mSafeForCartesianControlCounter = 0;
-    mArmNotReadyCounter = 0;
-    mArmNotReadyTimeLastMessage = 0.0;
 
     // initialize trajectory data
     m_servo_jp.SetSize(NumberOfJoints());
@@ -353,6 +356,8 @@ void mtsIntuitiveResearchKitArm::Init(void)
                                          this, "set_base_frame");
         m_arm_interface->AddCommandVoid(&mtsIntuitiveResearchKitArm::Freeze,
                                         this, "Freeze");
+        m_arm_interface->AddCommandVoid(&mtsIntuitiveResearchKitArm::use_shared_memory_command,
+                                        this, "use_shared_memory_command");
         m_arm_interface->AddCommandWrite(&mtsIntuitiveResearchKitArm::servo_jp,
                                          this, "servo_jp");
         m_arm_interface->AddCommandWrite(&mtsIntuitiveResearchKitArm::servo_jr,
@@ -615,6 +620,22 @@ void mtsIntuitiveResearchKitArm::Configure(const std::string & filename)
             m_re_home = jsonAlwaysHome.asBool();
         }
 
+        // mailbox for servo commands from external processes
+        const Json::Value jsonSharedMemoryCommand = jsonConfig["shared-memory-command"];
+        if (!jsonSharedMemoryCommand.isNull()) {
+            const Json::Value jsonTimeout = jsonSharedMemoryCommand["timeout"];
+            if (!jsonTimeout.isNull()) {
+                m_shared_memory_command.timeout = jsonTimeout.asDouble();
+            }
+            if (!m_shared_memory_command.mailbox.Create(this->GetName(),
+                                                        mtsIntuitiveResearchKit::SharedMemoryCommand::NumberOfSlots)) {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName()
+                                         << ": failed to create shared memory for commands, "
+                                         << m_shared_memory_command.mailbox.Ring().LastError() << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+
     } catch (std::exception & e) {
         CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName() << ": parsing file \""
                                  << filename << "\", got error: " << e.what() << std::endl;
@@ -717,6 +738,8 @@ void mtsIntuitiveResearchKitArm::ConfigureDH(const std::string & filename)
 
 void mtsIntuitiveResearchKitArm::Startup(void)
 {
+    // allocate log queue now, not in first error
+    mtsIntuitiveResearchKitLog::RegisterThread();
     SetDesiredState("DISABLED");
     trajectory_j_set_ratio(mtsIntuitiveResearchKit::JointTrajectory::ratio);
 }
@@ -732,11 +755,58 @@ void mtsIntuitiveResearchKitArm::Run(void)
                                    + ", caught exception \"" + e.what() + "\"");
         SetDesiredState("DISABLED");
     }
+    // publish snapshot for co-located components
+    UpdateSnapshot(m_snapshot_data);
+    m_snapshot.Write(m_snapshot_data);
+    if (m_display_snapshot.Requested()) {
+        UpdateDisplaySnapshot(m_display_snapshot_data);
+        m_display_snapshot.Write(m_display_snapshot_data);
+    }
+    // send aggregated errors and warnings
+    m_messages.Process(Now(),
+                       [this](const mtsIntuitiveResearchKitMessageAggregator::LevelType level,
+                              const std::string & text) {
+                           SendArmMessage(level, text);
+                       });
     // trigger ExecOut event
     RunEvent();
     ProcessQueuedCommands();
 }
 
+void mtsIntuitiveResearchKitArm::UpdateSnapshot(mtsIntuitiveResearchKitArmSnapshotData & data)
+{
+    data.timestamp = m_measured_cp.Timestamp();
+    data.measured_cp_valid = m_measured_cp.Valid();
+    data.measured_cp.Assign(m_measured_cp_frame);
+    data.setpoint_cp_valid = m_setpoint_cp.Valid();
+    data.setpoint_cp.Assign(m_setpoint_cp_frame);
+    data.operating_state = m_operating_state.State();
+    data.is_homed = m_operating_state.IsHomed();
+    data.is_busy = m_operating_state.IsBusy();
+}
+
+void mtsIntuitiveResearchKitArm::UpdateDisplaySnapshot(mtsIntuitiveResearchKitArmDisplayData & data)
+{
+    // arms with more joints than the display data can hold only display the first ones
+    data.number_of_joints = std::min(m_kin_measured_js.Position().size(),
+                                     static_cast<size_t>(mtsIntuitiveResearchKitArmDisplayData::MAXIMUM_NUMBER_OF_JOINTS));
+    data.measured_js_valid = m_kin_measured_js.Valid();
+    data.measured_js_timestamp = m_kin_measured_js.Timestamp();
+    for (size_t index = 0; index < data.number_of_joints; ++index) {
+        data.measured_jp.Element(index) = m_kin_measured_js.Position().Element(index);
+        data.measured_jv.Element(index) =
+            (index < m_kin_measured_js.Velocity().size()) ? m_kin_measured_js.Velocity().Element(index) : 0.0;
+        data.measured_jf.Element(index) =
+            (index < m_kin_measured_js.Effort().size()) ? m_kin_measured_js.Effort().Element(index) : 0.0;
+    }
+    data.measured_cp_valid = m_measured_cp.Valid();
+    data.measured_cp_timestamp = m_measured_cp.Timestamp();
+    data.measured_cp.Assign(m_measured_cp_frame);
+    data.body_measured_cf_valid = m_body_measured_cf.Valid();
+    data.body_measured_cf_timestamp = m_body_measured_cf.Timestamp();
+    data.body_measured_cf.Assign(m_body_measured_cf.Force());
+}
+
 void mtsIntuitiveResearchKitArm::Cleanup(void)
 {
     // engage brakes
@@ -797,8 +867,8 @@ void mtsIntuitiveResearchKitArm::GetRobotData(void)
         if (executionResult.IsOK()) {
             m_pid_measured_js.SetValid(true);
         } else {
-            CMN_LOG_CLASS_RUN_ERROR << GetName() << ": GetRobotData: call to PID.measured_js failed \""
-                                    << executionResult << "\"" << std::endl;
+            mtsIntuitiveResearchKitLog::Error(GetName(), "GetRobotData: call to PID.measured_js failed",
+                                              executionResult);
             m_pid_measured_js.SetValid(false);
         }
 
@@ -807,8 +877,8 @@ void mtsIntuitiveResearchKitArm::GetRobotData(void)
         if (executionResult.IsOK()) {
             m_pid_setpoint_js.SetValid(true);
         } else {
-            CMN_LOG_CLASS_RUN_ERROR << GetName() << ": GetRobotData: call to PID.setpoint_js failed \""
-                                    << executionResult << "\"" << std::endl;
+            mtsIntuitiveResearchKitLog::Error(GetName(), "GetRobotData: call to PID.setpoint_js failed",
+                                              executionResult);
             m_pid_setpoint_js.SetValid(false);
         }
 
@@ -1037,7 +1107,7 @@ void mtsIntuitiveResearchKitArm::EnterPowering(void)
         return;
     }
 
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     // in case we still have power but brakes are not engaged
     if (HasBrakes()) {
@@ -1061,7 +1131,7 @@ void mtsIntuitiveResearchKitArm::TransitionPowering(void)
         return;
     }
 
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     // check power status
     vctBoolVec actuatorAmplifiersStatus(NumberOfJoints());
@@ -1128,7 +1198,7 @@ void mtsIntuitiveResearchKitArm::EnterCalibratingEncodersFromPots(void)
     }
 
     // request bias encoder
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
     const int nb_samples = 1970; // birth year, state table contains 1999 elements so anything under that would work
     if (m_re_home || m_calibration_mode) {
         // positive number to ignore encoder preloads
@@ -1149,7 +1219,7 @@ void mtsIntuitiveResearchKitArm::TransitionCalibratingEncodersFromPots(void)
         return;
     }
 
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
     const double timeToBias = 30.0 * cmn_s; // large timeout
     if ((currentTime - mHomingTimer) > timeToBias) {
         mHomingBiasEncoderRequested = false;
@@ -1238,7 +1308,7 @@ void mtsIntuitiveResearchKitArm::EnterHoming(void)
 void mtsIntuitiveResearchKitArm::RunHoming(void)
 {
     static const double extraTime = 2.0 * cmn_s;
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     m_trajectory_j.Reflexxes.Evaluate(m_servo_jp,
                                       m_servo_jv,
@@ -1319,6 +1389,13 @@ void mtsIntuitiveResearchKitArm::RunHomed(void)
     if (mControlCallback) {
         mControlCallback->Execute();
     }
+    // freeze outside the callback since changing mode deletes the callback
+    if (m_shared_memory_command.freeze_reason) {
+        const std::string reason = m_shared_memory_command.freeze_reason;
+        m_shared_memory_command.freeze_reason = nullptr;
+        m_arm_interface->SendError(this->GetName() + ": " + reason + ", arm frozen");
+        Freeze();
+    }
 }
 
 void mtsIntuitiveResearchKitArm::EnterPaused(void)
@@ -1357,7 +1434,7 @@ void mtsIntuitiveResearchKitArm::control_move_jp(void)
     mtsIntuitiveResearchKitArm::servo_jp_internal(m_servo_jp);
 
     const robReflexxes::ResultType trajectoryResult = m_trajectory_j.Reflexxes.ResultValue();
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     switch (trajectoryResult) {
     case robReflexxes::Reflexxes_WORKING:
@@ -1388,14 +1465,7 @@ void mtsIntuitiveResearchKitArm::control_servo_cp(void)
             // finally send new joint values
             servo_jp_internal(jointSet);
         } else {
-            // shows robManipulator error if used
-            if (this->Manipulator) {
-                m_arm_interface->SendError(this->GetName()
-                                           + ": unable to solve inverse kinematics ("
-                                           + this->Manipulator->LastError() + ")");
-            } else {
-                m_arm_interface->SendError(this->GetName() + ": unable to solve inverse kinematics");
-            }
+            SendInverseKinematicsError();
         }
         // reset flag
         m_new_pid_goal = false;
@@ -1408,6 +1478,10 @@ void mtsIntuitiveResearchKitArm::control_move_cp(void)
     control_move_jp();
 }
 
+// same literal for Add and Reset, the aggregator only compares addresses
+static const char * const ArmNotReadyMessage = "arm not ready";
+static const char * const InverseKinematicsMessage = "unable to solve inverse kinematics";
+
 bool mtsIntuitiveResearchKitArm::ArmIsReady(const std::string & methodName,
                                             const mtsIntuitiveResearchKitArmTypes::ControlSpace space)
 {
@@ -1417,23 +1491,66 @@ bool mtsIntuitiveResearchKitArm::ArmIsReady(const std::string & methodName,
              && IsJointReady())
             || ((space == mtsIntuitiveResearchKitArmTypes::CARTESIAN_SPACE)
                 && IsCartesianReady())) {
-            mArmNotReadyCounter = 0;
-            mArmNotReadyTimeLastMessage = 0.0;
+            m_messages.Reset(ArmNotReadyMessage);
             return true;
         }
     }
-    // throttle messages in time
-    if ((StateTable.GetTic() - mArmNotReadyTimeLastMessage) > 2.0 * cmn_s) {
-        std::stringstream message;
-        message << this->GetName() << ": " << methodName << ", arm not ready";
-        if (mArmNotReadyCounter > 1) {
-            message << " (" << mArmNotReadyCounter << " errors)";
+    SendAggregated(mtsIntuitiveResearchKitMessageAggregator::MESSAGE_WARNING,
+                   ArmNotReadyMessage, methodName);
+    return false;
+}
+
+void mtsIntuitiveResearchKitArm::SendAggregated(const mtsIntuitiveResearchKitMessageAggregator::LevelType level,
+                                                const char * message)
+{
+    if (!m_messages.Add(level, message)) {
+        SendArmMessage(level, message);
+    }
+}
+
+void mtsIntuitiveResearchKitArm::SendAggregated(const mtsIntuitiveResearchKitMessageAggregator::LevelType level,
+                                                const char * message, const std::string & detail)
+{
+    if (!m_messages.Add(level, message, detail)) {
+        SendArmMessage(level, std::string(message) + " (" + detail + ")");
+    }
+}
+
+void mtsIntuitiveResearchKitArm::SendInverseKinematicsError(void)
+{
+    // shows robManipulator error if used
+    const std::string detail = this->Manipulator ? this->Manipulator->LastError() : std::string();
+    // first failure sent right away, clients rely on it
+    auto sender = [this](const mtsIntuitiveResearchKitMessageAggregator::LevelType level,
+                         const std::string & text) {
+        SendArmMessage(level, text);
+    };
+    if (!m_messages.AddOrSend(Now(), mtsIntuitiveResearchKitMessageAggregator::MESSAGE_ERROR,
+                              InverseKinematicsMessage, detail, sender)) {
+        if (detail.empty()) {
+            SendArmMessage(mtsIntuitiveResearchKitMessageAggregator::MESSAGE_ERROR,
+                           InverseKinematicsMessage);
+        } else {
+            SendArmMessage(mtsIntuitiveResearchKitMessageAggregator::MESSAGE_ERROR,
+                           std::string(InverseKinematicsMessage) + " (" + detail + ")");
         }
-        m_arm_interface->SendWarning(message.str());
-        mArmNotReadyTimeLastMessage = StateTable.GetTic();
     }
-    mArmNotReadyCounter++;
-    return false;
+}
+
+void mtsIntuitiveResearchKitArm::SendArmMessage(const mtsIntuitiveResearchKitMessageAggregator::LevelType level,
+                                                const std::string & text)
+{
+    switch (level) {
+    case mtsIntuitiveResearchKitMessageAggregator::MESSAGE_ERROR:
+        m_arm_interface->SendError(this->GetName() + ": " + text);
+        break;
+    case mtsIntuitiveResearchKitMessageAggregator::MESSAGE_WARNING:
+        m_arm_interface->SendWarning(this->GetName() + ": " + text);
+        break;
+    default:
+        m_arm_interface->SendStatus(this->GetName() + ": " + text);
+        break;
+    }
 }
 
 void mtsIntuitiveResearchKitArm::trajectory_j_set_ratio_v(const double & ratio)
@@ -1500,7 +1617,7 @@ void mtsIntuitiveResearchKitArm::trajectory_j_update_reflexxes(void)
                                m_trajectory_j.a_max);
     m_trajectory_j.Reflexxes.Set(m_trajectory_j.v,
                                  m_trajectory_j.a,
-                                 StateTable.PeriodStats.PeriodAvg(),
+                                 ControlPeriod(),
                                  robReflexxes::Reflexxes_TIME);
 }
 
@@ -1572,7 +1689,7 @@ void mtsIntuitiveResearchKitArm::SetControlSpaceAndMode(const mtsIntuitiveResear
             }
             m_trajectory_j.Reflexxes.Set(m_trajectory_j.v,
                                          m_trajectory_j.a,
-                                         StateTable.PeriodStats.PeriodAvg(),
+                                         ControlPeriod(),
                                          robReflexxes::Reflexxes_TIME);
             break;
         case mtsIntuitiveResearchKitArmTypes::EFFORT_MODE:
@@ -1763,7 +1880,7 @@ void mtsIntuitiveResearchKitArm::servo_jf_internal(const vctDoubleVec & newEffor
 {
     // convert to cisstParameterTypes
     mTorqueSetParam.SetForceTorque(newEffort);
-    mTorqueSetParam.SetTimestamp(StateTable.GetTic());
+    mTorqueSetParam.SetTimestamp(Now());
     PID.servo_jf(mTorqueSetParam);
 }
 
@@ -1777,7 +1894,7 @@ void mtsIntuitiveResearchKitArm::servo_jp_internal(const vctDoubleVec & newPosit
     // position
     m_servo_jp_param.Goal().Zeros();
     m_servo_jp_param.Goal().Assign(newPosition, NumberOfJoints());
-    m_servo_jp_param.SetTimestamp(StateTable.GetTic());
+    m_servo_jp_param.SetTimestamp(Now());
     PID.servo_jp(m_servo_jp_param);
 }
 
@@ -1795,6 +1912,117 @@ void mtsIntuitiveResearchKitArm::Freeze(void)
     m_new_pid_goal = true;
 }
 
+void mtsIntuitiveResearchKitArm::use_shared_memory_command(void)
+{
+    if (!m_shared_memory_command.mailbox.Ring().IsOpen()) {
+        m_arm_interface->SendWarning(this->GetName() + ": use_shared_memory_command, \"shared-memory-command\" is not set in arm configuration file");
+        return;
+    }
+    if (!ArmIsReady("use_shared_memory_command", mtsIntuitiveResearchKitArmTypes::JOINT_SPACE)) {
+        return;
+    }
+    // ignore commands sent before
+    m_shared_memory_command.next_index = m_shared_memory_command.mailbox.Ring().WriteCount();
+    m_shared_memory_command.last_time = Now();
+    m_shared_memory_command.type = 0;
+    m_shared_memory_command.freeze_reason = nullptr;
+    SetControlSpaceAndMode(mtsIntuitiveResearchKitArmTypes::USER_SPACE,
+                           mtsIntuitiveResearchKitArmTypes::USER_MODE,
+                           &mtsIntuitiveResearchKitArm::control_shared_memory_command, this);
+}
+
+void mtsIntuitiveResearchKitArm::control_shared_memory_command(void)
+{
+    mtsSharedMemoryCommand::Data & data = m_shared_memory_command.data;
+    uint64_t index;
+    const double now = Now();
+    if ((m_shared_memory_command.mailbox.Poll(index, data) <= 0)
+        || (index < m_shared_memory_command.next_index)) {
+        // watchdog, RunHomed will freeze the arm
+        if ((now - m_shared_memory_command.last_time) > m_shared_memory_command.timeout) {
+            m_shared_memory_command.freeze_reason = "no new shared memory command received";
+        }
+        return;
+    }
+    m_shared_memory_command.next_index = index + 1;
+    m_shared_memory_command.last_time = now;
+
+    const size_t numberOfJoints = NumberOfJointsKinematics();
+    const bool effort = (data.Type == mtsSharedMemoryCommand::SERVO_JF);
+    const bool isJoint = (data.Type == mtsSharedMemoryCommand::SERVO_JP) || effort;
+    if ((isJoint && (data.NumberOfValues != numberOfJoints))
+        || ((data.Type == mtsSharedMemoryCommand::SERVO_CP) && (data.NumberOfValues != 7))
+        || (!isJoint && (data.Type != mtsSharedMemoryCommand::SERVO_CP))) {
+        m_shared_memory_command.freeze_reason = "invalid shared memory command";
+        return;
+    }
+    // values come from another process, don't trust them
+    for (size_t value = 0; value < data.NumberOfValues; ++value) {
+        if (!std::isfinite(data.Values[value])) {
+            m_shared_memory_command.freeze_reason = "invalid shared memory command";
+            return;
+        }
+    }
+    if (data.Type == mtsSharedMemoryCommand::SERVO_CP) {
+        const double quaternionNorm = std::sqrt(data.Values[3] * data.Values[3]
+                                                + data.Values[4] * data.Values[4]
+                                                + data.Values[5] * data.Values[5]
+                                                + data.Values[6] * data.Values[6]);
+        if (quaternionNorm < 1.0e-6) {
+            m_shared_memory_command.freeze_reason = "invalid shared memory command";
+            return;
+        }
+    }
+
+    // configure PID when switching between position and effort
+    if (data.Type != m_shared_memory_command.type) {
+        if (effort) {
+            PID.EnableTrackingError(false);
+            mEffortJointSet.ForceTorque().SetAll(0.0);
+            SetControlEffortActiveJoints();
+        } else {
+            PID.EnableTrackingError(UsePIDTrackingError());
+            PID.EnableTorqueMode(vctBoolVec(NumberOfJoints(), false));
+        }
+        m_shared_memory_command.type = data.Type;
+    }
+
+    switch (data.Type) {
+    case mtsSharedMemoryCommand::SERVO_JP:
+        for (size_t joint = 0; joint < numberOfJoints; ++joint) {
+            m_servo_jp.Element(joint) = data.Values[joint];
+        }
+        servo_jp_internal(m_servo_jp);
+        break;
+    case mtsSharedMemoryCommand::SERVO_JF:
+        for (size_t joint = 0; joint < numberOfJoints; ++joint) {
+            mEffortJointSet.ForceTorque().Element(joint) = data.Values[joint];
+        }
+        control_servo_jf();
+        break;
+    case mtsSharedMemoryCommand::SERVO_CP:
+        {
+            if (!IsCartesianReady() || !IsSafeForCartesianControl()) {
+                m_shared_memory_command.freeze_reason = "shared memory servo_cp, arm not ready for cartesian control";
+                break;
+            }
+            vctQuatRot3 quaternion;
+            quaternion.W() = data.Values[3];
+            quaternion.X() = data.Values[4];
+            quaternion.Y() = data.Values[5];
+            quaternion.Z() = data.Values[6];
+            quaternion.NormalizedSelf();
+            CartesianSetParam.Goal().Translation().Assign(data.Values[0], data.Values[1], data.Values[2]);
+            CartesianSetParam.Goal().Rotation().FromNormalized(quaternion);
+            m_new_pid_goal = true;
+            control_servo_cp();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
 void mtsIntuitiveResearchKitArm::servo_jp(const prmPositionJointSet & newPosition)
 {
     if (!ArmIsReady("servo_jp", mtsIntuitiveResearchKitArmTypes::JOINT_SPACE)) {
@@ -1919,14 +2147,7 @@ void mtsIntuitiveResearchKitArm::move_cp(const prmPositionCartesianSet & newPosi
         ToJointsPID(jointSet, m_trajectory_j.goal);
         m_trajectory_j.goal_v.SetAll(0.0);
     } else {
-        // shows robManipulator error if used
-        if (this->Manipulator) {
-            m_arm_interface->SendError(this->GetName()
-                                       + ": unable to solve inverse kinematics ("
-                                       + this->Manipulator->LastError() + ")");
-        } else {
-            m_arm_interface->SendError(this->GetName() + ": unable to solve inverse kinematics");
-        }
+        SendInverseKinematicsError();
         m_trajectory_j.goal_reached_event(false);
         UpdateIsBusy(false);
     }
@@ -1952,7 +2173,8 @@ void mtsIntuitiveResearchKitArm::ErrorEventHandler(const mtsMessage & message)
 
 void mtsIntuitiveResearchKitArm::PositionLimitEventHandler(const vctBoolVec & CMN_UNUSED(flags))
 {
-    m_arm_interface->SendWarning(this->GetName() + ": PID position limit");
+    SendAggregated(mtsIntuitiveResearchKitMessageAggregator::MESSAGE_WARNING,
+                   "PID position limit");
 }
 
 void mtsIntuitiveResearchKitArm::BiasEncoderEventHandler(const int & nbSamples)
@@ -17,6 +17,7 @@ http://www.cisst.org/cisst/license.txt.
 */
 
 // system include
+#include <algorithm>
 #include <iostream>
 
 // cisst
@@ -42,6 +43,11 @@ http://www.cisst.org/cisst/license.txt.
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitSUJ.h>
 #include <sawIntuitiveResearchKit/mtsSocketClientPSM.h>
 #include <sawIntuitiveResearchKit/mtsSocketServerPSM.h>
+#include <sawIntuitiveResearchKit/mtsSocketBridge.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitUDPStreamer.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitReplay.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitScheduler.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitStandIn.h>
 #include <sawIntuitiveResearchKit/mtsDaVinciHeadSensor.h>
 #include <sawIntuitiveResearchKit/mtsDaVinciEndoscopeFocus.h>
 #include <sawIntuitiveResearchKit/mtsTeleOperationPSM.h>
@@ -59,7 +65,9 @@ mtsIntuitiveResearchKitConsole::Arm::Arm(mtsIntuitiveResearchKitConsole * consol
     m_console(console),
     m_name(name),
     m_IO_component_name(ioComponentName),
+    m_PID_interface_name("Controller"),
     m_arm_period(mtsIntuitiveResearchKit::ArmPeriod),
+    m_socket_format(mtsSocketWireFormat::PACKED),
     IOInterfaceRequired(0),
     PIDInterfaceRequired(0),
     ArmInterfaceRequired(0),
@@ -132,6 +140,9 @@ void mtsIntuitiveResearchKitConsole::Arm::ConfigureArm(const ArmType armType,
 
             if (m_socket_server) {
                 mtsSocketServerPSM *serverPSM = new mtsSocketServerPSM(SocketComponentName(), periodInSeconds, m_IP, m_port);
+                serverPSM->SetWireFormat(m_socket_format);
+                serverPSM->ConfigureJitterBuffer(m_socket_jitter_buffer);
+                serverPSM->ConfigureTransport(m_socket_transport);
                 serverPSM->Configure();
                 componentManager->AddComponent(serverPSM);
                 m_console->mConnections.Add(SocketComponentName(), "PSM",
@@ -140,12 +151,19 @@ void mtsIntuitiveResearchKitConsole::Arm::ConfigureArm(const ArmType armType,
         }
         break;
     case ARM_PSM_SOCKET:
-        {
+        // bridged arms are created by the console along with the bridge
+        if (!m_socket_bridged) {
             mtsSocketClientPSM * clientPSM = new mtsSocketClientPSM(Name(), periodInSeconds, m_IP, m_port);
+            clientPSM->SetWireFormat(m_socket_format);
+            clientPSM->ConfigureTransport(m_socket_transport);
             clientPSM->Configure();
             componentManager->AddComponent(clientPSM);
         }
         break;
+    case ARM_MTM_SOCKET:
+    case ARM_ECM_SOCKET:
+        // only available through the socket bridge
+        break;
     case ARM_ECM:
         armECMOrDerived = true;
         {
@@ -274,7 +292,7 @@ void mtsIntuitiveResearchKitConsole::Arm::ConfigureArm(const ArmType armType,
         break;
     }
 
-    if (armPSMOrDerived && (m_simulation == SIMULATION_NONE)) {
+    if (armPSMOrDerived && HasIOInterfaces()) {
         m_console->mConnections.Add(Name(), "Adapter",
                                     IOComponentName(), Name() + "-Adapter");
         m_console->mConnections.Add(Name(), "Tool",
@@ -285,7 +303,7 @@ void mtsIntuitiveResearchKitConsole::Arm::ConfigureArm(const ArmType armType,
                                     IOComponentName(), Name() + "-Dallas");
     }
 
-    if (armECMOrDerived && (m_simulation == SIMULATION_NONE)) {
+    if (armECMOrDerived && HasIOInterfaces()) {
         m_console->mConnections.Add(Name(), "ManipClutch",
                                     IOComponentName(), Name() + "-ManipClutch");
     }
@@ -304,20 +322,20 @@ bool mtsIntuitiveResearchKitConsole::Arm::Connect(void)
     // if the arm is a research kit arm
     if (m_native_or_derived) {
         // Connect arm to IO if not simulated
-        if (m_simulation == SIMULATION_NONE) {
+        if (HasIOInterfaces()) {
             componentManager->Connect(Name(), "RobotIO",
                                       IOComponentName(), Name());
         }
         // connect MTM gripper to IO
         if (((m_type == ARM_MTM)
              || (m_type == ARM_MTM_DERIVED))
-            && (m_simulation == SIMULATION_NONE)) {
+            && HasIOInterfaces()) {
             componentManager->Connect(Name(), "GripperIO",
                                       IOComponentName(), Name() + "-Gripper");
         }
         // connect PID
         componentManager->Connect(Name(), "PID",
-                                  PIDComponentName(), "Controller");
+                                  PIDComponentName(), m_PID_interface_name);
         // connect m_base_frame if needed
         if ((m_base_frame_component_name != "") && (m_base_frame_interface_name != "")) {
             componentManager->Connect(m_base_frame_component_name, m_base_frame_interface_name,
@@ -339,6 +357,18 @@ const std::string & mtsIntuitiveResearchKitConsole::Arm::InterfaceName(void) con
     return m_arm_interface_name;
 }
 
+bool mtsIntuitiveResearchKitConsole::Arm::HasIOInterfaces(void) const {
+    return ((m_simulation == SIMULATION_NONE)
+            || (m_simulation == SIMULATION_DYNAMIC)
+            || (m_simulation == SIMULATION_REPLAY));
+}
+
+bool mtsIntuitiveResearchKitConsole::Arm::IsSocketClient(void) const {
+    return ((m_type == ARM_PSM_SOCKET)
+            || (m_type == ARM_MTM_SOCKET)
+            || (m_type == ARM_ECM_SOCKET));
+}
+
 const std::string & mtsIntuitiveResearchKitConsole::Arm::SocketComponentName(void) const {
     return m_socket_component_name;
 }
@@ -514,7 +544,7 @@ mtsIntuitiveResearchKitConsole::mtsIntuitiveResearchKitConsole(const std::string
         // emulate foot pedal events
         mInterface->AddCommandWrite(&mtsIntuitiveResearchKitConsole::OperatorPresentEventHandler, this,
                                     "emulate_operator_present", prmEventButton());
-        mInterface->AddCommandWrite(&mtsIntuitiveResearchKitConsole::ClutchEventHandler, this,
+        mInterface->AddCommandWrite(&mtsIntuitiveResearchKitConsole::emulate_clutch, this,
                                     "emulate_clutch", prmEventButton());
         mInterface->AddCommandWrite(&mtsIntuitiveResearchKitConsole::CameraEventHandler, this,
                                     "emulate_camera", prmEventButton());
@@ -551,6 +581,11 @@ void mtsIntuitiveResearchKitConsole::calibration_mode(bool & result) const
     result = m_calibration_mode;
 }
 
+void mtsIntuitiveResearchKitConsole::set_remote_telemetry(const bool remote)
+{
+    m_remote_telemetry = remote;
+}
+
 void mtsIntuitiveResearchKitConsole::Configure(const std::string & filename)
 {
     mConfigured = false;
@@ -620,6 +655,11 @@ void mtsIntuitiveResearchKitConsole::Configure(const std::string & filename)
         mChatty = false;
     }
 
+    jsonValue = jsonConfig["direct-footpedals"];
+    if (!jsonValue.empty()) {
+        m_direct_footpedals = jsonValue.asBool();
+    }
+
     // get user preferences
     jsonValue = jsonConfig["io"];
     if (!jsonValue.empty()) {
@@ -679,6 +719,33 @@ void mtsIntuitiveResearchKitConsole::Configure(const std::string & filename)
                                << "     - Protocol is " << protocol << std::endl
                                << "     - Watchdog timeout is " << watchdogTimeout << std::endl;
 
+    // socket bridge, arms are needed to configure the bridge
+    jsonValue = jsonConfig["socket-bridge"];
+    if (!jsonValue.empty()) {
+        if (!ConfigureSocketBridgeJSON(jsonValue)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to configure socket-bridge" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // replay, must be configured before the arms
+    jsonValue = jsonConfig["replay"];
+    if (!jsonValue.empty()) {
+        if (!ConfigureReplayJSON(jsonValue, configPath)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to configure replay" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // virtual clock for stepped simulation
+    jsonValue = jsonConfig["virtual-clock"];
+    if (!jsonValue.empty()) {
+        if (!ConfigureVirtualClockJSON(jsonValue)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to configure virtual-clock" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
     const Json::Value arms = jsonConfig["arms"];
     for (unsigned int index = 0; index < arms.size(); ++index) {
         if (!ConfigureArmJSON(arms[index], m_IO_component_name, configPath)) {
@@ -818,10 +885,63 @@ void mtsIntuitiveResearchKitConsole::Configure(const std::string & filename)
         mtsComponentManager::GetInstance()->AddComponent(io);
     }
 
+    // replay replaces IO and PID components for arms with simulation "REPLAY"
+    const mtsIntuitiveResearchKitVirtualClock * virtualClock = nullptr;
+    std::string virtualClockComponentName;
+    if (mReplay.Configured) {
+        mtsIntuitiveResearchKitReplay * replay = new mtsIntuitiveResearchKitReplay(mReplay.ComponentName);
+        if (!replay->Load(mReplay.FileName, mReplay.IOComponentName)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to load replay file \""
+                                     << mReplay.FileName << "\"" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        replay->SetStep(mReplay.Step);
+        replay->SetRate(mReplay.Rate);
+        replay->SetTolerance(mReplay.Tolerance);
+        for (auto iter = mArms.begin(); iter != end; ++iter) {
+            Arm * arm = iter->second;
+            if (arm->m_simulation == Arm::SIMULATION_REPLAY) {
+                if (!replay->AddArm(arm->Name(), mReplay.Tools[arm->Name()].asString())) {
+                    CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to replay arm \""
+                                             << arm->Name() << "\"" << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                // arm runs in replay thread, once per replay step
+                mConnections.Add(arm->Name(), "ExecIn",
+                                 mReplay.ComponentName, "ExecOut");
+            }
+        }
+        mtsComponentManager::GetInstance()->AddComponent(replay);
+        virtualClock = &(replay->VirtualClock());
+        virtualClockComponentName = mReplay.ComponentName;
+    }
+
+    // stand-in replaces IO and PID components for arms with simulation "DYNAMIC"
+    mtsIntuitiveResearchKitStandIn * standIn = nullptr;
+    if (mStandIn.Configured) {
+        standIn = new mtsIntuitiveResearchKitStandIn(mStandIn.ComponentName,
+                                                     mtsIntuitiveResearchKit::IOPeriod);
+        for (auto iter = mArms.begin(); iter != end; ++iter) {
+            Arm * arm = iter->second;
+            if (arm->m_simulation == Arm::SIMULATION_DYNAMIC) {
+                if (!standIn->AddArm(arm->Name(),
+                                     arm->m_arm_configuration_file,
+                                     arm->m_PID_configuration_file,
+                                     arm->m_dynamics)) {
+                    CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to simulate arm \""
+                                             << arm->Name() << "\"" << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+        }
+        mtsComponentManager::GetInstance()->AddComponent(standIn);
+    }
+
     // now can configure PID and Arms
     for (auto iter = mArms.begin(); iter != end; ++iter) {
         const std::string pidConfig = iter->second->m_PID_configuration_file;
-        if (!pidConfig.empty()) {
+        if (!pidConfig.empty()
+            && (iter->second->m_simulation != Arm::SIMULATION_DYNAMIC)) {
             iter->second->ConfigurePID(pidConfig);
         }
         // for generic arms, nothing to do
@@ -832,6 +952,61 @@ void mtsIntuitiveResearchKitConsole::Configure(const std::string & filename)
         }
     }
 
+    // single bridge for all arms sharing a socket
+    if (mSocketBridge.Configured) {
+        mtsSocketBridge * bridge = new mtsSocketBridge(mSocketBridge.ComponentName,
+                                                       mtsIntuitiveResearchKit::ArmPeriod,
+                                                       mSocketBridge.IP,
+                                                       mSocketBridge.Port,
+                                                       mSocketBridge.Server);
+        for (const auto & armName : mSocketBridge.Arms) {
+            const auto armIterator = mArms.find(armName);
+            if (armIterator == mArms.end()) {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure: arm \"" << armName
+                                         << "\" used in socket-bridge is not defined in \"arms\"" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            mtsSocketWireFormat::ChannelType channelType;
+            switch (armIterator->second->m_type) {
+            case Arm::ARM_MTM:
+            case Arm::ARM_MTM_DERIVED:
+            case Arm::ARM_MTM_GENERIC:
+            case Arm::ARM_MTM_SOCKET:
+                channelType = mtsSocketWireFormat::CHANNEL_MTM;
+                break;
+            case Arm::ARM_ECM:
+            case Arm::ARM_ECM_DERIVED:
+            case Arm::ARM_ECM_GENERIC:
+            case Arm::ARM_ECM_SOCKET:
+                channelType = mtsSocketWireFormat::CHANNEL_ECM;
+                break;
+            case Arm::ARM_PSM:
+            case Arm::ARM_PSM_DERIVED:
+            case Arm::ARM_PSM_GENERIC:
+            case Arm::ARM_PSM_SOCKET:
+                channelType = mtsSocketWireFormat::CHANNEL_PSM;
+                break;
+            default:
+                CMN_LOG_CLASS_INIT_ERROR << "Configure: arm \"" << armName
+                                         << "\" can't be used in socket-bridge, only MTMs, PSMs and ECMs are supported" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            if (!bridge->AddArm(armName, channelType)) {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to add arm \"" << armName
+                                         << "\" to socket-bridge" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            if (mSocketBridge.Server) {
+                mConnections.Add(bridge->GetName(), armName,
+                                 armIterator->second->ComponentName(),
+                                 armIterator->second->InterfaceName());
+            }
+        }
+        bridge->ConfigureTransport(mSocketBridge.Transport);
+        bridge->Configure();
+        mtsComponentManager::GetInstance()->AddComponent(bridge);
+    }
+
     // look for ECM teleop
     const Json::Value ecmTeleop = jsonConfig["ecm-teleop"];
     if (!ecmTeleop.isNull()) {
@@ -850,6 +1025,108 @@ void mtsIntuitiveResearchKitConsole::Configure(const std::string & filename)
         }
     }
 
+    // binary streamers, arms and teleops need to be created first
+    const Json::Value streamers = jsonConfig["streamers"];
+    for (unsigned int index = 0; index < streamers.size(); ++index) {
+        if (!ConfigureStreamerJSON(streamers[index])) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to configure streamers[" << index << "]" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // shared memory telemetry for GUIs running in a separate process
+    if (m_remote_telemetry) {
+        if (!ConfigureRemoteTelemetry()) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure: failed to configure remote telemetry" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // scheduler steps all simulated PIDs and arms, in this order
+    if (mVirtualClock.Configured) {
+        mtsIntuitiveResearchKitScheduler * scheduler =
+            new mtsIntuitiveResearchKitScheduler(mVirtualClock.ComponentName, mVirtualClock.Step);
+        scheduler->SetRate(mVirtualClock.Rate);
+        scheduler->SetPaused(mVirtualClock.Paused);
+        mtsComponentManager::GetInstance()->AddComponent(scheduler);
+        virtualClock = &(scheduler->VirtualClock());
+        virtualClockComponentName = mVirtualClock.ComponentName;
+        // stand-in first so arms read the state of the current step
+        if (standIn) {
+            standIn->set_virtual_clock(virtualClock);
+            mConnections.Add(mStandIn.ComponentName, "ExecIn",
+                             mVirtualClock.ComponentName, "ExecOut");
+        }
+        for (auto iter = mArms.begin(); iter != end; ++iter) {
+            Arm * arm = iter->second;
+            if (arm->m_generic) {
+                CMN_LOG_CLASS_INIT_WARNING << "Configure: generic arm \"" << arm->Name()
+                                           << "\" is not stepped by the virtual clock" << std::endl;
+                continue;
+            }
+            if ((arm->m_simulation != Arm::SIMULATION_KINEMATIC)
+                && (arm->m_simulation != Arm::SIMULATION_DYNAMIC)) {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure: arm \"" << arm->Name()
+                                         << "\" must use the \"KINEMATIC\" or \"DYNAMIC\" simulation with \"virtual-clock\"" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            if (!arm->m_PID_configuration_file.empty()
+                && (arm->m_simulation == Arm::SIMULATION_KINEMATIC)) {
+                mConnections.Add(arm->PIDComponentName(), "ExecIn",
+                                 mVirtualClock.ComponentName, "ExecOut");
+            }
+        }
+        for (auto iter = mArms.begin(); iter != end; ++iter) {
+            Arm * arm = iter->second;
+            if (!arm->m_generic) {
+                mConnections.Add(arm->Name(), "ExecIn",
+                                 mVirtualClock.ComponentName, "ExecOut");
+            }
+        }
+    }
+
+    // stepped arms and tele-operation components use the virtual clock
+    if (virtualClock) {
+        mtsManagerLocal * componentManager = mtsManagerLocal::GetInstance();
+        for (auto iter = mArms.begin(); iter != end; ++iter) {
+            Arm * arm = iter->second;
+            if (arm->m_generic
+                || (mReplay.Configured && (arm->m_simulation != Arm::SIMULATION_REPLAY))) {
+                continue;
+            }
+            mtsComponent * component = componentManager->GetComponent(arm->Name());
+            mtsIntuitiveResearchKitArm * armPointer = dynamic_cast<mtsIntuitiveResearchKitArm *>(component);
+            if (armPointer) {
+                armPointer->set_virtual_clock(virtualClock);
+            }
+            mtsIntuitiveResearchKitSUJ * sujPointer = dynamic_cast<mtsIntuitiveResearchKitSUJ *>(component);
+            if (sujPointer) {
+                sujPointer->set_virtual_clock(virtualClock);
+            }
+        }
+        // tele-operation components run after the arms
+        for (const auto & teleop : mTeleopsPSM) {
+            if (teleop.second->m_type != TeleopPSM::TELEOP_PSM_GENERIC) {
+                mtsTeleOperationPSM * teleopPointer =
+                    dynamic_cast<mtsTeleOperationPSM *>(componentManager->GetComponent(teleop.second->Name()));
+                if (teleopPointer) {
+                    teleopPointer->set_virtual_clock(virtualClock);
+                }
+                mConnections.Add(teleop.second->Name(), "ExecIn",
+                                 virtualClockComponentName, "ExecOut");
+            }
+        }
+        if (mTeleopECM && (mTeleopECM->m_type != TeleopECM::TELEOP_ECM_GENERIC)) {
+            mtsTeleOperationECM * teleopPointer =
+                dynamic_cast<mtsTeleOperationECM *>(componentManager->GetComponent(mTeleopECM->Name()));
+            if (teleopPointer) {
+                teleopPointer->set_virtual_clock(virtualClock);
+            }
+            mConnections.Add(mTeleopECM->Name(), "ExecIn",
+                             virtualClockComponentName, "ExecOut");
+        }
+    }
+
     // see which event is used for operator present
     // find name of button event used to detect if operator is present
 
@@ -977,7 +1254,7 @@ void mtsIntuitiveResearchKitConsole::Configure(const std::string & filename)
                  || (arm->m_type == Arm::ARM_PSM)
                  || (arm->m_type == Arm::ARM_PSM_DERIVED)
                  )
-                && (arm->m_simulation == Arm::SIMULATION_NONE)) {
+                && arm->HasIOInterfaces()) {
                 arm->SUJInterfaceRequiredFromIO = this->AddInterfaceRequired("SUJ-" + arm->Name() + "-IO");
                 arm->SUJInterfaceRequiredFromIO->AddEventHandlerWrite(&Arm::SUJClutchEventHandlerFromIO, arm, "Button");
                 arm->SUJInterfaceRequiredToSUJ = this->AddInterfaceRequired("SUJ-" + arm->Name());
@@ -1066,7 +1343,7 @@ void mtsIntuitiveResearchKitConsole::Cleanup(void)
 
 bool mtsIntuitiveResearchKitConsole::AddArm(Arm * newArm)
 {
-    if ((newArm->m_type != Arm::ARM_PSM_SOCKET)
+    if (!newArm->IsSocketClient()
         && (!newArm->m_generic)) {
         if (newArm->m_type != Arm::ARM_SUJ) {
             if (newArm->m_PID_configuration_file.empty()) {
@@ -1127,6 +1404,7 @@ bool mtsIntuitiveResearchKitConsole::AddTeleopECMInterfaces(TeleopECM * teleop)
     teleop->InterfaceRequired = this->AddInterfaceRequired(teleop->Name());
     if (teleop->InterfaceRequired) {
         teleop->InterfaceRequired->AddFunction("state_command", teleop->state_command);
+        teleop->InterfaceRequired->AddFunction("emulate_clutch", teleop->emulate_clutch, MTS_OPTIONAL);
         teleop->InterfaceRequired->AddEventHandlerWrite(&mtsIntuitiveResearchKitConsole::ErrorEventHandler, this, "error");
         teleop->InterfaceRequired->AddEventHandlerWrite(&mtsIntuitiveResearchKitConsole::WarningEventHandler, this, "warning");
         teleop->InterfaceRequired->AddEventHandlerWrite(&mtsIntuitiveResearchKitConsole::StatusEventHandler, this, "status");
@@ -1144,6 +1422,7 @@ bool mtsIntuitiveResearchKitConsole::AddTeleopPSMInterfaces(TeleopPSM * teleop)
     if (teleop->InterfaceRequired) {
         teleop->InterfaceRequired->AddFunction("state_command", teleop->state_command);
         teleop->InterfaceRequired->AddFunction("set_scale", teleop->set_scale);
+        teleop->InterfaceRequired->AddFunction("emulate_clutch", teleop->emulate_clutch, MTS_OPTIONAL);
         teleop->InterfaceRequired->AddEventHandlerWrite(&mtsIntuitiveResearchKitConsole::ErrorEventHandler, this, "error");
         teleop->InterfaceRequired->AddEventHandlerWrite(&mtsIntuitiveResearchKitConsole::WarningEventHandler, this, "warning");
         teleop->InterfaceRequired->AddEventHandlerWrite(&mtsIntuitiveResearchKitConsole::StatusEventHandler, this, "status");
@@ -1173,6 +1452,23 @@ void mtsIntuitiveResearchKitConsole::AddFootpedalInterfaces(void)
         clutchProvided->AddEventWrite(console_events.clutch, "Button", prmEventButton());
     }
 
+    // teleop components get clutch events from the console or
+    // directly from the source to avoid the extra hop through the
+    // console thread.  Camera and operator present are always handled
+    // by the console since it selects which teleops are enabled
+    InterfaceComponentType clutchSource(this->GetName(), "Clutch");
+    if (m_direct_footpedals && (iter != endDInputs)) {
+        clutchSource = iter->second;
+    }
+    for (auto & teleop : mTeleopsPSM) {
+        mConnections.Add(teleop.second->Name(), "Clutch",
+                         clutchSource.first, clutchSource.second);
+    }
+    if (mTeleopECM) {
+        mConnections.Add(mTeleopECM->Name(), "Clutch",
+                         clutchSource.first, clutchSource.second);
+    }
+
     iter = mDInputSources.find("Camera");
     if (iter != endDInputs) {
         mtsInterfaceRequired * cameraRequired = AddInterfaceRequired("Camera");
@@ -1263,6 +1559,10 @@ bool mtsIntuitiveResearchKitConsole::ConfigureArmJSON(const Json::Value & jsonAr
             armPointer->m_generic = true;
         } else if (typeString == "PSM_SOCKET") {
             armPointer->m_type = Arm::ARM_PSM_SOCKET;
+        } else if (typeString == "MTM_SOCKET") {
+            armPointer->m_type = Arm::ARM_MTM_SOCKET;
+        } else if (typeString == "ECM_SOCKET") {
+            armPointer->m_type = Arm::ARM_ECM_SOCKET;
         } else if (typeString == "FOCUS_CONTROLLER") {
             armPointer->m_type = Arm::FOCUS_CONTROLLER;
             armPointer->m_native_or_derived = true;
@@ -1270,7 +1570,7 @@ bool mtsIntuitiveResearchKitConsole::ConfigureArmJSON(const Json::Value & jsonAr
             armPointer->m_type = Arm::ARM_SUJ;
         } else {
             CMN_LOG_CLASS_INIT_ERROR << "ConfigureArmJSON: arm " << armName << ": invalid type \""
-                                     << typeString << "\", needs to be one of {MTM,PSM,ECM}{,_DERIVED,_GENERIC}" << std::endl;
+                                     << typeString << "\", needs to be one of {MTM,PSM,ECM}{,_DERIVED,_GENERIC,_SOCKET}" << std::endl;
             return false;
         }
     } else {
@@ -1294,15 +1594,44 @@ bool mtsIntuitiveResearchKitConsole::ConfigureArmJSON(const Json::Value & jsonAr
             armPointer->m_simulation = Arm::SIMULATION_DYNAMIC;
         } else if (typeString == "NONE") {
             armPointer->m_simulation = Arm::SIMULATION_NONE;
+        } else if (typeString == "REPLAY") {
+            armPointer->m_simulation = Arm::SIMULATION_REPLAY;
         } else {
             CMN_LOG_CLASS_INIT_ERROR << "ConfigureArmJSON: arm " << armName << ": invalid simulation \""
-                                     << typeString << "\", needs to be NONE, KINEMATIC or DYNAMIC" << std::endl;
+                                     << typeString << "\", needs to be NONE, KINEMATIC, DYNAMIC or REPLAY" << std::endl;
             return false;
         }
     } else {
         armPointer->m_simulation = Arm::SIMULATION_NONE;
     }
 
+    // replay component provides both IO and PID interfaces
+    if (armPointer->m_simulation == Arm::SIMULATION_REPLAY) {
+        if (!mReplay.Configured) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureArmJSON: arm " << armName
+                                     << ": simulation \"REPLAY\" requires \"replay\" to be configured" << std::endl;
+            return false;
+        }
+        armPointer->m_IO_component_name = mReplay.ComponentName;
+        armPointer->m_PID_component_name = mReplay.ComponentName;
+        armPointer->m_PID_interface_name = armName + "-Controller";
+    }
+
+    // stand-in component provides both IO and PID interfaces
+    if (armPointer->m_simulation == Arm::SIMULATION_DYNAMIC) {
+        if (!armPointer->m_native_or_derived
+            || (armPointer->m_type == Arm::FOCUS_CONTROLLER)) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureArmJSON: arm " << armName
+                                     << ": simulation \"DYNAMIC\" is only supported for MTM, PSM and ECM (and derived)" << std::endl;
+            return false;
+        }
+        mStandIn.Configured = true;
+        armPointer->m_IO_component_name = mStandIn.ComponentName;
+        armPointer->m_PID_component_name = mStandIn.ComponentName;
+        armPointer->m_PID_interface_name = armName + "-Controller";
+        armPointer->m_dynamics = jsonArm["dynamics"];
+    }
+
     // set arm calibration mode based on console calibration mode
     armPointer->m_calibration_mode = m_calibration_mode;
 
@@ -1332,8 +1661,45 @@ bool mtsIntuitiveResearchKitConsole::ConfigureArmJSON(const Json::Value & jsonAr
         armPointer->m_socket_server = jsonValue.asBool();
     }
 
+    // arms sharing the socket bridge, IP and port are defined in "socket-bridge"
+    armPointer->m_socket_bridged = (std::find(mSocketBridge.Arms.begin(),
+                                              mSocketBridge.Arms.end(),
+                                              armName) != mSocketBridge.Arms.end());
+    if (armPointer->m_socket_bridged) {
+        if (armPointer->m_socket_server) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureArmJSON: arm \"" << armName
+                                     << "\" can't use both \"socket-server\" and \"socket-bridge\"" << std::endl;
+            return false;
+        }
+        if (mSocketBridge.Server) {
+            if (armPointer->IsSocketClient()) {
+                CMN_LOG_CLASS_INIT_ERROR << "ConfigureArmJSON: arm \"" << armName
+                                         << "\" is a socket client, it can't be bridged by a server" << std::endl;
+                return false;
+            }
+        } else {
+            if (!armPointer->IsSocketClient()) {
+                CMN_LOG_CLASS_INIT_ERROR << "ConfigureArmJSON: arm \"" << armName
+                                         << "\" must be of type \"PSM_SOCKET\", \"MTM_SOCKET\" or \"ECM_SOCKET\" to use a socket-bridge client" << std::endl;
+                return false;
+            }
+            armPointer->m_arm_component_name = mSocketBridge.ComponentName;
+            armPointer->m_arm_interface_name = armName;
+        }
+    }
+
+    // MTM and ECM socket clients only exist with the bridge
+    if (((armPointer->m_type == Arm::ARM_MTM_SOCKET)
+         || (armPointer->m_type == Arm::ARM_ECM_SOCKET))
+        && !armPointer->m_socket_bridged) {
+        CMN_LOG_CLASS_INIT_ERROR << "ConfigureArmJSON: arm \"" << armName
+                                 << "\" must be listed in \"socket-bridge\" \"arms\"" << std::endl;
+        return false;
+    }
+
     // for socket client or server, look for remote IP / port
-    if (armPointer->m_type == Arm::ARM_PSM_SOCKET || armPointer->m_socket_server) {
+    if ((armPointer->m_type == Arm::ARM_PSM_SOCKET && !armPointer->m_socket_bridged)
+        || armPointer->m_socket_server) {
         armPointer->m_socket_component_name = armPointer->m_name + "-SocketServer";
         jsonValue = jsonArm["remote-ip"];
         if(!jsonValue.empty()){
@@ -1351,10 +1717,23 @@ bool mtsIntuitiveResearchKitConsole::ConfigureArmJSON(const Json::Value & jsonAr
                                      << armName << "\"" << std::endl;
             return false;
         }
+        jsonValue = jsonArm["socket-format"];
+        if (!jsonValue.empty()) {
+            if (!mtsSocketWireFormat::FormatFromString(jsonValue.asString(),
+                                                       armPointer->m_socket_format)) {
+                CMN_LOG_CLASS_INIT_ERROR << "ConfigureArmJSON: invalid \"socket-format\" for arm \""
+                                         << armName << "\", must be \"packed\" or \"cdg\"" << std::endl;
+                return false;
+            }
+        }
+        // jitter buffer, only used by socket server
+        armPointer->m_socket_jitter_buffer = jsonArm["socket-jitter-buffer"];
+        // transport, UDP by default
+        armPointer->m_socket_transport = jsonArm["socket-transport"];
     }
 
     // IO for anything not simulated or socket client
-    if ((armPointer->m_type != Arm::ARM_PSM_SOCKET)
+    if (!armPointer->IsSocketClient()
         && (!armPointer->m_generic)) {
         if (armPointer->m_simulation == Arm::SIMULATION_NONE) {
             jsonValue = jsonArm["io"];
@@ -1411,8 +1790,9 @@ bool mtsIntuitiveResearchKitConsole::ConfigureArmJSON(const Json::Value & jsonAr
         }
     }
 
-    // PID only required for MTM, PSM and ECM (and derived)
-    if (armPointer->m_native_or_derived) {
+    // PID only required for MTM, PSM and ECM (and derived), replaced when replaying
+    if (armPointer->m_native_or_derived
+        && (armPointer->m_simulation != Arm::SIMULATION_REPLAY)) {
         jsonValue = jsonArm["pid"];
         if (!jsonValue.empty()) {
             armPointer->m_PID_configuration_file = armConfigPath.Find(jsonValue.asString());
@@ -1442,7 +1822,7 @@ bool mtsIntuitiveResearchKitConsole::ConfigureArmJSON(const Json::Value & jsonAr
     }
 
     // only configure kinematics if not arm socket client
-    if ((armPointer->m_type != Arm::ARM_PSM_SOCKET)
+    if (!armPointer->IsSocketClient()
         && (!armPointer->m_generic)) {
         // renamed "kinematic" to "arm" so we can have a more complex configuration file for the arm class
         if (armPointer->m_native_or_derived) {
@@ -1576,9 +1956,10 @@ bool mtsIntuitiveResearchKitConsole::ConfigureECMTeleopJSON(const Json::Value &
         armPointer = armIterator->second;
         if (!((armPointer->m_type == Arm::ARM_MTM_GENERIC) ||
               (armPointer->m_type == Arm::ARM_MTM_DERIVED) ||
+              (armPointer->m_type == Arm::ARM_MTM_SOCKET)  ||
               (armPointer->m_type == Arm::ARM_MTM))) {
             CMN_LOG_CLASS_INIT_ERROR << "ConfigureECMTeleopJSON: mtm left\""
-                                     << mtmLeftName << "\" type must be \"MTM\", \"MTM_DERIVED\" or \"MTM_GENERIC\"" << std::endl;
+                                     << mtmLeftName << "\" type must be \"MTM\", \"MTM_DERIVED\", \"MTM_GENERIC\" or \"MTM_SOCKET\"" << std::endl;
             return false;
         }
         mtmLeftComponent = armPointer->ComponentName();
@@ -1593,9 +1974,10 @@ bool mtsIntuitiveResearchKitConsole::ConfigureECMTeleopJSON(const Json::Value &
         armPointer = armIterator->second;
         if (!((armPointer->m_type == Arm::ARM_MTM_GENERIC) ||
               (armPointer->m_type == Arm::ARM_MTM_DERIVED) ||
+              (armPointer->m_type == Arm::ARM_MTM_SOCKET)  ||
               (armPointer->m_type == Arm::ARM_MTM))) {
             CMN_LOG_CLASS_INIT_ERROR << "ConfigureECMTeleopJSON: mtm right\""
-                                     << mtmRightName << "\" type must be \"MTM\", \"MTM_DERIVED\" or \"MTM_GENERIC\"" << std::endl;
+                                     << mtmRightName << "\" type must be \"MTM\", \"MTM_DERIVED\", \"MTM_GENERIC\" or \"MTM_SOCKET\"" << std::endl;
             return false;
         }
         mtmRightComponent = armPointer->ComponentName();
@@ -1610,9 +1992,10 @@ bool mtsIntuitiveResearchKitConsole::ConfigureECMTeleopJSON(const Json::Value &
         armPointer = armIterator->second;
         if (!((armPointer->m_type == Arm::ARM_ECM_GENERIC) ||
               (armPointer->m_type == Arm::ARM_ECM_DERIVED) ||
+              (armPointer->m_type == Arm::ARM_ECM_SOCKET)  ||
               (armPointer->m_type == Arm::ARM_ECM))) {
             CMN_LOG_CLASS_INIT_ERROR << "ConfigureECMTeleopJSON: ecm \""
-                                     << ecmName << "\" type must be \"ECM\" or \"GENERIC_ECM\"" << std::endl;
+                                     << ecmName << "\" type must be \"ECM\", \"ECM_DERIVED\", \"ECM_GENERIC\" or \"ECM_SOCKET\"" << std::endl;
             return false;
         }
         ecmComponent = armPointer->ComponentName();
@@ -1628,7 +2011,6 @@ bool mtsIntuitiveResearchKitConsole::ConfigureECMTeleopJSON(const Json::Value &
         mConnections.Add(name, "MTML", mtmLeftComponent, mtmLeftInterface);
         mConnections.Add(name, "MTMR", mtmRightComponent, mtmRightInterface);
         mConnections.Add(name, "ECM", ecmComponent, ecmInterface);
-        mConnections.Add(name, "Clutch", this->GetName(), "Clutch"); // console clutch
         mConnections.Add(this->GetName(), name, name, "Setting");
     } else {
         CMN_LOG_CLASS_INIT_ERROR << "ConfigureECMTeleopJSON: there is already an ECM teleop" << std::endl;
@@ -1705,9 +2087,10 @@ bool mtsIntuitiveResearchKitConsole::ConfigurePSMTeleopJSON(const Json::Value &
         armPointer = armIterator->second;
         if (!((armPointer->m_type == Arm::ARM_MTM_GENERIC) ||
               (armPointer->m_type == Arm::ARM_MTM_DERIVED) ||
+              (armPointer->m_type == Arm::ARM_MTM_SOCKET)  ||
               (armPointer->m_type == Arm::ARM_MTM))) {
             CMN_LOG_CLASS_INIT_ERROR << "ConfigurePSMTeleopJSON: mtm \""
-                                     << mtmName << "\" type must be \"MTM\", \"MTM_DERIVED\" or \"MTM_GENERIC\"" << std::endl;
+                                     << mtmName << "\" type must be \"MTM\", \"MTM_DERIVED\", \"MTM_GENERIC\" or \"MTM_SOCKET\"" << std::endl;
             return false;
         }
         mtmComponent = armPointer->ComponentName();
@@ -1725,7 +2108,7 @@ bool mtsIntuitiveResearchKitConsole::ConfigurePSMTeleopJSON(const Json::Value &
               (armPointer->m_type == Arm::ARM_PSM_SOCKET)  ||
               (armPointer->m_type == Arm::ARM_PSM))) {
             CMN_LOG_CLASS_INIT_ERROR << "ConfigurePSMTeleopJSON: psm \""
-                                     << psmName << "\" type must be \"PSM\", \"PSM_DERIVED\" or \"PSM_GENERIC\"" << std::endl;
+                                     << psmName << "\" type must be \"PSM\", \"PSM_DERIVED\", \"PSM_GENERIC\" or \"PSM_SOCKET\"" << std::endl;
             return false;
         }
         psmComponent = armPointer->ComponentName();
@@ -1755,7 +2138,6 @@ bool mtsIntuitiveResearchKitConsole::ConfigurePSMTeleopJSON(const Json::Value &
         // schedule connections
         mConnections.Add(name, "MTM", mtmComponent, mtmInterface);
         mConnections.Add(name, "PSM", psmComponent, psmInterface);
-        mConnections.Add(name, "Clutch", this->GetName(), "Clutch"); // clutch from console
         mConnections.Add(this->GetName(), name, name, "Setting");
         if ((baseFrameComponent != "")
             && (baseFrameInterface != "")) {
@@ -1843,6 +2225,258 @@ bool mtsIntuitiveResearchKitConsole::ConfigurePSMTeleopJSON(const Json::Value &
     return true;
 }
 
+bool mtsIntuitiveResearchKitConsole::ConfigureSocketBridgeJSON(const Json::Value & jsonBridge)
+{
+    Json::Value jsonValue;
+
+    jsonValue = jsonBridge["server"];
+    if (!jsonValue.empty()) {
+        mSocketBridge.Server = jsonValue.asBool();
+    }
+    jsonValue = jsonBridge["component"];
+    if (!jsonValue.empty()) {
+        mSocketBridge.ComponentName = jsonValue.asString();
+    }
+    jsonValue = jsonBridge["remote-ip"];
+    if (!jsonValue.empty()) {
+        mSocketBridge.IP = jsonValue.asString();
+    } else {
+        CMN_LOG_CLASS_INIT_ERROR << "ConfigureSocketBridgeJSON: can't find \"remote-ip\"" << std::endl;
+        return false;
+    }
+    jsonValue = jsonBridge["port"];
+    if (!jsonValue.empty()) {
+        mSocketBridge.Port = jsonValue.asInt();
+    } else {
+        CMN_LOG_CLASS_INIT_ERROR << "ConfigureSocketBridgeJSON: can't find \"port\"" << std::endl;
+        return false;
+    }
+    mSocketBridge.Transport = jsonBridge["transport"];
+
+    // order matters, it defines the channel id for each arm
+    const Json::Value jsonArms = jsonBridge["arms"];
+    if (jsonArms.empty()) {
+        CMN_LOG_CLASS_INIT_ERROR << "ConfigureSocketBridgeJSON: \"arms\" must contain at least one arm name" << std::endl;
+        return false;
+    }
+    for (unsigned int index = 0; index < jsonArms.size(); ++index) {
+        mSocketBridge.Arms.push_back(jsonArms[index].asString());
+    }
+    mSocketBridge.Configured = true;
+    return true;
+}
+
+bool mtsIntuitiveResearchKitConsole::ConfigureReplayJSON(const Json::Value & jsonReplay,
+                                                         const cmnPath & configPath)
+{
+    Json::Value jsonValue;
+
+    jsonValue = jsonReplay["file"];
+    if (jsonValue.empty()) {
+        CMN_LOG_CLASS_INIT_ERROR << "ConfigureReplayJSON: can't find \"file\"" << std::endl;
+        return false;
+    }
+    mReplay.FileName = configPath.Find(jsonValue.asString());
+    if (mReplay.FileName == "") {
+        CMN_LOG_CLASS_INIT_ERROR << "ConfigureReplayJSON: can't find file " << jsonValue.asString() << std::endl;
+        return false;
+    }
+    jsonValue = jsonReplay["component"];
+    if (!jsonValue.empty()) {
+        mReplay.ComponentName = jsonValue.asString();
+    }
+    jsonValue = jsonReplay["io-component"];
+    if (!jsonValue.empty()) {
+        mReplay.IOComponentName = jsonValue.asString();
+    }
+    jsonValue = jsonReplay["step"];
+    if (!jsonValue.empty()) {
+        mReplay.Step = jsonValue.asDouble();
+        if (mReplay.Step <= 0.0) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureReplayJSON: \"step\" must be strictly positive" << std::endl;
+            return false;
+        }
+    }
+    jsonValue = jsonReplay["rate"];
+    if (!jsonValue.empty()) {
+        mReplay.Rate = jsonValue.asDouble();
+    }
+    jsonValue = jsonReplay["tolerance"];
+    if (!jsonValue.empty()) {
+        mReplay.Tolerance = jsonValue.asDouble();
+    }
+    // tool type for PSMs using Dallas chip detection, e.g. {"PSM1": "LARGE_NEEDLE_DRIVER:400006"}
+    mReplay.Tools = jsonReplay["tools"];
+    mReplay.Configured = true;
+    return true;
+}
+
+bool mtsIntuitiveResearchKitConsole::ConfigureVirtualClockJSON(const Json::Value & jsonClock)
+{
+    Json::Value jsonValue;
+
+    // replay already steps its arms on the recorded time
+    if (mReplay.Configured) {
+        CMN_LOG_CLASS_INIT_ERROR << "ConfigureVirtualClockJSON: \"virtual-clock\" can't be used with \"replay\"" << std::endl;
+        return false;
+    }
+    jsonValue = jsonClock["component"];
+    if (!jsonValue.empty()) {
+        mVirtualClock.ComponentName = jsonValue.asString();
+    }
+    jsonValue = jsonClock["step"];
+    if (!jsonValue.empty()) {
+        mVirtualClock.Step = jsonValue.asDouble();
+        if (mVirtualClock.Step <= 0.0) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureVirtualClockJSON: \"step\" must be strictly positive" << std::endl;
+            return false;
+        }
+    }
+    jsonValue = jsonClock["rate"];
+    if (!jsonValue.empty()) {
+        mVirtualClock.Rate = jsonValue.asDouble();
+    }
+    jsonValue = jsonClock["paused"];
+    if (!jsonValue.empty()) {
+        mVirtualClock.Paused = jsonValue.asBool();
+    }
+    mVirtualClock.Configured = true;
+    return true;
+}
+
+bool mtsIntuitiveResearchKitConsole::ConfigureStreamerJSON(const Json::Value & jsonStreamer)
+{
+    Json::Value jsonValue;
+
+    // source is either an arm or a teleop
+    std::string sourceName, sourceComponentName, sourceInterfaceName;
+    double period = mtsIntuitiveResearchKit::TeleopPeriod;
+    bool sourceExecOut = false;
+    jsonValue = jsonStreamer["arm"];
+    if (!jsonValue.empty()) {
+        sourceName = jsonValue.asString();
+        const auto armIterator = mArms.find(sourceName);
+        if (armIterator == mArms.end()) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureStreamerJSON: arm \"" << sourceName
+                                     << "\" is not defined in \"arms\"" << std::endl;
+            return false;
+        }
+        const Arm * arm = armIterator->second;
+        sourceComponentName = arm->ComponentName();
+        sourceInterfaceName = arm->InterfaceName();
+        period = arm->m_arm_period;
+        // dVRK arms trigger ExecOut at the end of each cycle
+        sourceExecOut = arm->m_native_or_derived && (arm->m_type != Arm::FOCUS_CONTROLLER);
+    } else {
+        jsonValue = jsonStreamer["teleop"];
+        if (jsonValue.empty()) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureStreamerJSON: can't find \"arm\" nor \"teleop\"" << std::endl;
+            return false;
+        }
+        sourceName = jsonValue.asString();
+        const auto teleopIterator = mTeleopsPSM.find(sourceName);
+        if (teleopIterator != mTeleopsPSM.end()) {
+            sourceExecOut = (teleopIterator->second->m_type != TeleopPSM::TELEOP_PSM_GENERIC);
+        } else if (mTeleopECM && (mTeleopECM->Name() == sourceName)) {
+            sourceExecOut = (mTeleopECM->m_type != TeleopECM::TELEOP_ECM_GENERIC);
+        } else {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureStreamerJSON: teleop \"" << sourceName
+                                     << "\" is not defined in \"psm-teleops\" nor \"ecm-teleop\"" << std::endl;
+            return false;
+        }
+        sourceComponentName = sourceName;
+        sourceInterfaceName = "Setting";
+        const mtsTaskPeriodic * task =
+            dynamic_cast<mtsTaskPeriodic *>(mtsComponentManager::GetInstance()->GetComponent(sourceName));
+        if (task) {
+            period = task->GetPeriodicity();
+        }
+    }
+
+    std::string componentName = sourceName + "-Streamer";
+    jsonValue = jsonStreamer["component"];
+    if (!jsonValue.empty()) {
+        componentName = jsonValue.asString();
+    }
+
+    // SUJ arms are provided by the SUJ component
+    jsonValue = jsonStreamer["interface"];
+    if (!jsonValue.empty()) {
+        sourceInterfaceName = jsonValue.asString();
+    }
+
+    mtsIntuitiveResearchKitUDPStreamer * streamer =
+        new mtsIntuitiveResearchKitUDPStreamer(componentName, period);
+    streamer->Configure(jsonStreamer);
+    mtsComponentManager::GetInstance()->AddComponent(streamer);
+    mConnections.Add(componentName, "Arm",
+                     sourceComponentName, sourceInterfaceName);
+    // streamer runs in the source's thread
+    if (sourceExecOut) {
+        mConnections.Add(componentName, "ExecIn",
+                         sourceComponentName, "ExecOut");
+    } else {
+        CMN_LOG_CLASS_INIT_WARNING << "ConfigureStreamerJSON: \"" << sourceName
+                                   << "\" is not a dVRK arm nor teleop, streamer \"" << componentName
+                                   << "\" will run at its own rate" << std::endl;
+    }
+    return true;
+}
+
+bool mtsIntuitiveResearchKitConsole::ConfigureRemoteTelemetry(void)
+{
+    for (const auto & armIterator : mArms) {
+        const Arm * arm = armIterator.second;
+        // only dVRK arms trigger ExecOut, SUJ arms are provided by the SUJ component
+        if (!arm->m_native_or_derived
+            || (arm->m_type == Arm::ARM_SUJ)
+            || (arm->m_type == Arm::FOCUS_CONTROLLER)) {
+            continue;
+        }
+        Json::Value jsonStreamer;
+        jsonStreamer["arm"] = arm->Name();
+        jsonStreamer["component"] = arm->Name() + "-Remote";
+        jsonStreamer["fields"].append("measured_js");
+        jsonStreamer["fields"].append("setpoint_js");
+        jsonStreamer["fields"].append("measured_cp");
+        jsonStreamer["fields"].append("setpoint_cp");
+        jsonStreamer["fields"].append("body/measured_cf");
+        jsonStreamer["fields"].append("operating_state");
+        Json::Value jsonDestination;
+        jsonDestination["shared-memory"] = mtsIntuitiveResearchKit::Remote::Prefix + arm->Name();
+        jsonDestination["slots"] = static_cast<Json::UInt>(mtsIntuitiveResearchKit::Remote::NumberOfSlots);
+        jsonDestination["decimation"] = mtsIntuitiveResearchKit::Remote::Decimation;
+        jsonStreamer["destinations"].append(jsonDestination);
+        if (!ConfigureStreamerJSON(jsonStreamer)) {
+            return false;
+        }
+    }
+
+    // tele-operation state, same prefix so the GUI finds all rings
+    std::vector<std::string> teleops;
+    for (const auto & teleopIterator : mTeleopsPSM) {
+        teleops.push_back(teleopIterator.first);
+    }
+    if (mTeleopECM) {
+        teleops.push_back(mTeleopECM->Name());
+    }
+    for (const auto & teleop : teleops) {
+        Json::Value jsonStreamer;
+        jsonStreamer["teleop"] = teleop;
+        jsonStreamer["component"] = teleop + "-Remote";
+        jsonStreamer["fields"].append("teleop_state");
+        Json::Value jsonDestination;
+        jsonDestination["shared-memory"] = mtsIntuitiveResearchKit::Remote::Prefix + teleop;
+        jsonDestination["slots"] = static_cast<Json::UInt>(mtsIntuitiveResearchKit::Remote::NumberOfSlots);
+        jsonDestination["decimation"] = mtsIntuitiveResearchKit::Remote::Decimation;
+        jsonStreamer["destinations"].append(jsonDestination);
+        if (!ConfigureStreamerJSON(jsonStreamer)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool mtsIntuitiveResearchKitConsole::AddArmInterfaces(Arm * arm)
 {
     // IO
@@ -2230,7 +2864,8 @@ void mtsIntuitiveResearchKitConsole::UpdateTeleopState(void)
             for (auto & iterArms : mArms) {
                 if ((iterArms.second->m_type == Arm::ARM_MTM) ||
                     (iterArms.second->m_type == Arm::ARM_MTM_DERIVED) ||
-                    (iterArms.second->m_type == Arm::ARM_MTM_GENERIC)) {
+                    (iterArms.second->m_type == Arm::ARM_MTM_GENERIC) ||
+                    (iterArms.second->m_type == Arm::ARM_MTM_SOCKET)) {
                     iterArms.second->Freeze();
                 }
             }
@@ -2243,7 +2878,8 @@ void mtsIntuitiveResearchKitConsole::UpdateTeleopState(void)
         for (auto & iterArms : mArms) {
             if ((iterArms.second->m_type == Arm::ARM_MTM) ||
                 (iterArms.second->m_type == Arm::ARM_MTM_DERIVED) ||
-                (iterArms.second->m_type == Arm::ARM_MTM_GENERIC)) {
+                (iterArms.second->m_type == Arm::ARM_MTM_GENERIC) ||
+                (iterArms.second->m_type == Arm::ARM_MTM_SOCKET)) {
                 iterArms.second->Freeze();
             }
         }
@@ -2406,6 +3042,30 @@ void mtsIntuitiveResearchKitConsole::ClutchEventHandler(const prmEventButton & b
     console_events.clutch(button);
 }
 
+void mtsIntuitiveResearchKitConsole::emulate_clutch(const prmEventButton & button)
+{
+    // when teleops are connected directly to the footpedal source,
+    // they don't receive the console's clutch events
+    if (m_direct_footpedals
+        && (mDInputSources.find("Clutch") != mDInputSources.end())) {
+        for (auto & teleop : mTeleopsPSM) {
+            if (teleop.second->emulate_clutch.IsValid()) {
+                teleop.second->emulate_clutch(button);
+            } else {
+                mInterface->SendWarning(this->GetName() + ": emulated clutch can't be sent to " + teleop.second->Name());
+            }
+        }
+        if (mTeleopECM) {
+            if (mTeleopECM->emulate_clutch.IsValid()) {
+                mTeleopECM->emulate_clutch(button);
+            } else {
+                mInterface->SendWarning(this->GetName() + ": emulated clutch can't be sent to " + mTeleopECM->Name());
+            }
+        }
+    }
+    ClutchEventHandler(button);
+}
+
 void mtsIntuitiveResearchKitConsole::CameraEventHandler(const prmEventButton & button)
 {
     switch (button.Type()) {
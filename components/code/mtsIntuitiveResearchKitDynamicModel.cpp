@@ -0,0 +1,463 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-15
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitDynamicModel.h>
+
+const double mtsIntuitiveResearchKitDynamicModel::VelocityThreshold = 1.0e-4;
+
+namespace {
+    // smallest pivot used for joints without mass nor armature
+    const double MinimumPivot = 1.0e-9;
+
+    inline void Cross(const double * a, const double * b, double * result) {
+        const double x = a[1] * b[2] - a[2] * b[1];
+        const double y = a[2] * b[0] - a[0] * b[2];
+        const double z = a[0] * b[1] - a[1] * b[0];
+        result[0] = x; result[1] = y; result[2] = z;
+    }
+
+    inline double Dot(const double * a, const double * b) {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // result += scale * a
+    inline void AddScaled(double * result, const double scale, const double * a) {
+        result[0] += scale * a[0]; result[1] += scale * a[1]; result[2] += scale * a[2];
+    }
+
+    inline void MatrixVector(const double * m, const double * v, double * result) {
+        const double x = m[0] * v[0] + m[1] * v[1] + m[2] * v[2];
+        const double y = m[3] * v[0] + m[4] * v[1] + m[5] * v[2];
+        const double z = m[6] * v[0] + m[7] * v[1] + m[8] * v[2];
+        result[0] = x; result[1] = y; result[2] = z;
+    }
+
+    // a x (b x c), used for centripetal accelerations
+    inline void CrossCross(const double * a, const double * b, double * result) {
+        double temp[3];
+        Cross(a, b, temp);
+        Cross(a, temp, result);
+    }
+}
+
+mtsIntuitiveResearchKitDynamicModel::mtsIntuitiveResearchKitDynamicModel(void):
+    mBrakes(false)
+{
+    SetGravity(0.0, 0.0, -9.81);
+}
+
+void mtsIntuitiveResearchKitDynamicModel::AddLink(const Link & link, const Joint & joint)
+{
+    mLinks.push_back(link);
+    mJoints.push_back(joint);
+    const size_t n = mLinks.size();
+    mDrivePositions.assign(n, 0.0);
+    mLinkPositions.assign(n, 0.0);
+    mDriveVelocities.assign(n, 0.0);
+    mLinkVelocities.assign(n, 0.0);
+    mAxes.resize(3 * n);
+    mJointPoints.resize(3 * n);
+    mCenters.resize(3 * n);
+    mInertias.resize(9 * n);
+    mOmega.resize(3 * n);
+    mAlpha.resize(3 * n);
+    mAccelerationCenter.resize(3 * n);
+    mForces.resize(3 * n);
+    mMoments.resize(3 * n);
+    mBias.resize(n);
+    mInertia.resize(n * n);
+    mRightHandSide.resize(n);
+    mZeros.assign(n, 0.0);
+    mUnit.assign(n, 0.0);
+    mStuck.assign(n, false);
+}
+
+void mtsIntuitiveResearchKitDynamicModel::SetGravity(const double x, const double y, const double z)
+{
+    mGravity[0] = x;
+    mGravity[1] = y;
+    mGravity[2] = z;
+}
+
+void mtsIntuitiveResearchKitDynamicModel::Reset(const double * positions)
+{
+    for (size_t index = 0; index < mLinks.size(); ++index) {
+        mDrivePositions[index] = positions[index];
+        mLinkPositions[index] = positions[index];
+        mDriveVelocities[index] = 0.0;
+        mLinkVelocities[index] = 0.0;
+        mStuck[index] = false;
+    }
+}
+
+void mtsIntuitiveResearchKitDynamicModel::SetBrakes(const bool engaged)
+{
+    mBrakes = engaged;
+    if (mBrakes) {
+        mDriveVelocities.assign(mDriveVelocities.size(), 0.0);
+        mLinkVelocities.assign(mLinkVelocities.size(), 0.0);
+    }
+}
+
+void mtsIntuitiveResearchKitDynamicModel::UpdateGeometry(const double * positions)
+{
+    // base frame
+    double R[9] = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+    double p[3] = {0.0, 0.0, 0.0};
+
+    for (size_t i = 0; i < mLinks.size(); ++i) {
+        const Link & link = mLinks[i];
+        const double theta = link.Theta + (link.Prismatic ? 0.0 : link.Offset + positions[i]);
+        const double d = link.D + (link.Prismatic ? link.Offset + positions[i] : 0.0);
+        const double ct = std::cos(theta), st = std::sin(theta);
+        const double ca = std::cos(link.Alpha), sa = std::sin(link.Alpha);
+
+        // standard convention, joint axis is z of previous frame
+        if (!link.Modified) {
+            mAxes[3 * i] = R[2]; mAxes[3 * i + 1] = R[5]; mAxes[3 * i + 2] = R[8];
+            mJointPoints[3 * i] = p[0]; mJointPoints[3 * i + 1] = p[1]; mJointPoints[3 * i + 2] = p[2];
+        }
+
+        // local transformation
+        double Rl[9], pl[3];
+        if (link.Modified) {
+            // Rx(alpha) Tx(a) Rz(theta) Tz(d)
+            Rl[0] = ct;      Rl[1] = -st;     Rl[2] = 0.0;
+            Rl[3] = st * ca; Rl[4] = ct * ca; Rl[5] = -sa;
+            Rl[6] = st * sa; Rl[7] = ct * sa; Rl[8] = ca;
+            pl[0] = link.A; pl[1] = -sa * d; pl[2] = ca * d;
+        } else {
+            // Rz(theta) Tz(d) Tx(a) Rx(alpha)
+            Rl[0] = ct; Rl[1] = -st * ca; Rl[2] = st * sa;
+            Rl[3] = st; Rl[4] = ct * ca;  Rl[5] = -ct * sa;
+            Rl[6] = 0.0; Rl[7] = sa;      Rl[8] = ca;
+            pl[0] = link.A * ct; pl[1] = link.A * st; pl[2] = d;
+        }
+
+        // compose with previous frame
+        double offset[3];
+        MatrixVector(R, pl, offset);
+        p[0] += offset[0]; p[1] += offset[1]; p[2] += offset[2];
+        double Rn[9];
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t column = 0; column < 3; ++column) {
+                Rn[3 * row + column] =
+                    R[3 * row] * Rl[column]
+                    + R[3 * row + 1] * Rl[3 + column]
+                    + R[3 * row + 2] * Rl[6 + column];
+            }
+        }
+        std::copy(Rn, Rn + 9, R);
+
+        // modified convention, joint axis is z of this frame
+        if (link.Modified) {
+            mAxes[3 * i] = R[2]; mAxes[3 * i + 1] = R[5]; mAxes[3 * i + 2] = R[8];
+            mJointPoints[3 * i] = p[0]; mJointPoints[3 * i + 1] = p[1]; mJointPoints[3 * i + 2] = p[2];
+        }
+
+        // center of mass and inertia in base coordinates, R I R^t
+        MatrixVector(R, link.CenterOfMass, mCenters.data() + 3 * i);
+        AddScaled(mCenters.data() + 3 * i, 1.0, p);
+        double RI[9];
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t column = 0; column < 3; ++column) {
+                RI[3 * row + column] =
+                    R[3 * row] * link.Inertia[column]
+                    + R[3 * row + 1] * link.Inertia[3 + column]
+                    + R[3 * row + 2] * link.Inertia[6 + column];
+            }
+        }
+        double * inertia = mInertias.data() + 9 * i;
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t column = 0; column < 3; ++column) {
+                inertia[3 * row + column] =
+                    RI[3 * row] * R[3 * column]
+                    + RI[3 * row + 1] * R[3 * column + 1]
+                    + RI[3 * row + 2] * R[3 * column + 2];
+            }
+        }
+    }
+}
+
+void mtsIntuitiveResearchKitDynamicModel::NewtonEuler(const double * velocities,
+                                                      const double * accelerations,
+                                                      const bool useGravity,
+                                                      double * efforts)
+{
+    const size_t n = mLinks.size();
+    if (!velocities) {
+        velocities = mZeros.data();
+    }
+    if (!accelerations) {
+        accelerations = mZeros.data();
+    }
+
+    // forward recursion, base doesn't move but accelerates up to
+    // account for gravity
+    double omega[3] = {0.0, 0.0, 0.0};
+    double alpha[3] = {0.0, 0.0, 0.0};
+    double acceleration[3] = {0.0, 0.0, 0.0};
+    if (useGravity) {
+        acceleration[0] = -mGravity[0];
+        acceleration[1] = -mGravity[1];
+        acceleration[2] = -mGravity[2];
+    }
+    double previousPoint[3] = {0.0, 0.0, 0.0};
+    double temp[3];
+
+    for (size_t i = 0; i < n; ++i) {
+        const double * z = mAxes.data() + 3 * i;
+        const double * point = mJointPoints.data() + 3 * i;
+        const double qd = velocities[i];
+        const double qdd = accelerations[i];
+
+        // acceleration of joint point, attached to previous link
+        const double r[3] = {point[0] - previousPoint[0],
+                             point[1] - previousPoint[1],
+                             point[2] - previousPoint[2]};
+        Cross(alpha, r, temp);
+        AddScaled(acceleration, 1.0, temp);
+        CrossCross(omega, r, temp);
+        AddScaled(acceleration, 1.0, temp);
+
+        const double zqd[3] = {z[0] * qd, z[1] * qd, z[2] * qd};
+        Cross(omega, zqd, temp);
+        if (mLinks[i].Prismatic) {
+            AddScaled(acceleration, qdd, z);
+            AddScaled(acceleration, 2.0, temp);
+        } else {
+            AddScaled(alpha, qdd, z);
+            AddScaled(alpha, 1.0, temp);
+            AddScaled(omega, 1.0, zqd);
+        }
+
+        // acceleration of center of mass
+        const double * center = mCenters.data() + 3 * i;
+        const double rc[3] = {center[0] - point[0],
+                              center[1] - point[1],
+                              center[2] - point[2]};
+        double * accelerationCenter = mAccelerationCenter.data() + 3 * i;
+        std::copy(acceleration, acceleration + 3, accelerationCenter);
+        Cross(alpha, rc, temp);
+        AddScaled(accelerationCenter, 1.0, temp);
+        CrossCross(omega, rc, temp);
+        AddScaled(accelerationCenter, 1.0, temp);
+
+        std::copy(omega, omega + 3, mOmega.data() + 3 * i);
+        std::copy(alpha, alpha + 3, mAlpha.data() + 3 * i);
+        std::copy(point, point + 3, previousPoint);
+    }
+
+    // backward recursion, forces and moments (at joint point) applied
+    // by previous link
+    double nextForce[3] = {0.0, 0.0, 0.0};
+    double nextMoment[3] = {0.0, 0.0, 0.0};
+    double nextPoint[3] = {0.0, 0.0, 0.0};
+    for (size_t i = n; i-- > 0; ) {
+        const double mass = mLinks[i].Mass;
+        const double * inertia = mInertias.data() + 9 * i;
+        const double * w = mOmega.data() + 3 * i;
+        const double * point = mJointPoints.data() + 3 * i;
+        const double * center = mCenters.data() + 3 * i;
+        const double * accelerationCenter = mAccelerationCenter.data() + 3 * i;
+
+        // F = m a, N = I alpha + w x I w
+        const double F[3] = {mass * accelerationCenter[0],
+                             mass * accelerationCenter[1],
+                             mass * accelerationCenter[2]};
+        double N[3], Iw[3];
+        MatrixVector(inertia, mAlpha.data() + 3 * i, N);
+        MatrixVector(inertia, w, Iw);
+        Cross(w, Iw, temp);
+        AddScaled(N, 1.0, temp);
+
+        double * force = mForces.data() + 3 * i;
+        double * moment = mMoments.data() + 3 * i;
+        force[0] = F[0] + nextForce[0];
+        force[1] = F[1] + nextForce[1];
+        force[2] = F[2] + nextForce[2];
+
+        const double rc[3] = {center[0] - point[0],
+                              center[1] - point[1],
+                              center[2] - point[2]};
+        std::copy(N, N + 3, moment);
+        Cross(rc, F, temp);
+        AddScaled(moment, 1.0, temp);
+        AddScaled(moment, 1.0, nextMoment);
+        if (i + 1 < n) {
+            const double rn[3] = {nextPoint[0] - point[0],
+                                  nextPoint[1] - point[1],
+                                  nextPoint[2] - point[2]};
+            Cross(rn, nextForce, temp);
+            AddScaled(moment, 1.0, temp);
+        }
+
+        const double * z = mAxes.data() + 3 * i;
+        efforts[i] = mLinks[i].Prismatic ? Dot(z, force) : Dot(z, moment);
+
+        std::copy(force, force + 3, nextForce);
+        std::copy(moment, moment + 3, nextMoment);
+        std::copy(point, point + 3, nextPoint);
+    }
+}
+
+void mtsIntuitiveResearchKitDynamicModel::InertiaMatrixFromGeometry(double * inertia)
+{
+    // one column per unit acceleration, without gravity nor velocities
+    const size_t n = mLinks.size();
+    for (size_t column = 0; column < n; ++column) {
+        mUnit[column] = 1.0;
+        NewtonEuler(nullptr, mUnit.data(), false, mRightHandSide.data());
+        mUnit[column] = 0.0;
+        for (size_t row = 0; row < n; ++row) {
+            inertia[row * n + column] = mRightHandSide[row];
+        }
+        inertia[column * n + column] += mJoints[column].Armature;
+    }
+}
+
+void mtsIntuitiveResearchKitDynamicModel::InverseDynamics(const double * positions,
+                                                          const double * velocities,
+                                                          const double * accelerations,
+                                                          double * efforts)
+{
+    UpdateGeometry(positions);
+    NewtonEuler(velocities, accelerations, true, efforts);
+}
+
+void mtsIntuitiveResearchKitDynamicModel::InertiaMatrix(const double * positions,
+                                                        double * inertia)
+{
+    UpdateGeometry(positions);
+    InertiaMatrixFromGeometry(inertia);
+}
+
+void mtsIntuitiveResearchKitDynamicModel::Step(const double * efforts, const double dt)
+{
+    const size_t n = mLinks.size();
+    if (mBrakes || (n == 0)) {
+        return;
+    }
+
+    // gravity, coriolis and centrifugal efforts
+    UpdateGeometry(mLinkPositions.data());
+    NewtonEuler(mDriveVelocities.data(), nullptr, true, mBias.data());
+    InertiaMatrixFromGeometry(mInertia.data());
+
+    // (M + dt B) qdd = effort - bias - B qd - coulomb, B viscous
+    // friction, implicit so high values don't make the model unstable
+    for (size_t i = 0; i < n; ++i) {
+        const Joint & joint = mJoints[i];
+        const double velocity = mDriveVelocities[i];
+        mInertia[i * n + i] += dt * joint.Viscous;
+        double rhs = efforts[i] - mBias[i] - joint.Viscous * velocity;
+        mStuck[i] = false;
+        if (joint.Coulomb > 0.0) {
+            if (std::fabs(velocity) > VelocityThreshold) {
+                rhs -= std::copysign(joint.Coulomb, velocity);
+            } else if (std::fabs(rhs) <= joint.Coulomb) {
+                mStuck[i] = true;
+            } else {
+                rhs -= std::copysign(joint.Coulomb, rhs);
+            }
+        }
+        mRightHandSide[i] = rhs;
+    }
+
+    // stuck joints don't accelerate, remove them from the system
+    for (size_t i = 0; i < n; ++i) {
+        if (mStuck[i]) {
+            for (size_t j = 0; j < n; ++j) {
+                mInertia[i * n + j] = 0.0;
+                mInertia[j * n + i] = 0.0;
+            }
+            mInertia[i * n + i] = 1.0;
+            mRightHandSide[i] = 0.0;
+        }
+    }
+
+    // Cholesky decomposition, lower part, then solve in place
+    double * L = mInertia.data();
+    for (size_t j = 0; j < n; ++j) {
+        double pivot = L[j * n + j];
+        for (size_t k = 0; k < j; ++k) {
+            pivot -= L[j * n + k] * L[j * n + k];
+        }
+        pivot = std::sqrt(std::max(pivot, MinimumPivot));
+        L[j * n + j] = pivot;
+        for (size_t i = j + 1; i < n; ++i) {
+            double value = L[i * n + j];
+            for (size_t k = 0; k < j; ++k) {
+                value -= L[i * n + k] * L[j * n + k];
+            }
+            L[i * n + j] = value / pivot;
+        }
+    }
+    double * x = mRightHandSide.data();
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k < i; ++k) {
+            x[i] -= L[i * n + k] * x[k];
+        }
+        x[i] /= L[i * n + i];
+    }
+    for (size_t i = n; i-- > 0; ) {
+        for (size_t k = i + 1; k < n; ++k) {
+            x[i] -= L[k * n + i] * x[k];
+        }
+        x[i] /= L[i * n + i];
+    }
+
+    // semi-implicit Euler on drive side, then backlash
+    for (size_t i = 0; i < n; ++i) {
+        double velocity = mStuck[i] ? 0.0 : mDriveVelocities[i] + dt * x[i];
+        // Coulomb friction can stop a joint but not reverse it, stick
+        // or slip is decided at next step
+        if ((mJoints[i].Coulomb > 0.0) && (velocity * mDriveVelocities[i] < 0.0)) {
+            velocity = 0.0;
+        }
+        mDriveVelocities[i] = velocity;
+        mDrivePositions[i] += dt * velocity;
+        double linkVelocity = velocity;
+        const double halfPlay = 0.5 * mJoints[i].Backlash;
+        if (halfPlay > 0.0) {
+            const double gap = mDrivePositions[i] - mLinkPositions[i];
+            if (gap > halfPlay) {
+                mLinkPositions[i] = mDrivePositions[i] - halfPlay;
+            } else if (gap < -halfPlay) {
+                mLinkPositions[i] = mDrivePositions[i] + halfPlay;
+            } else {
+                // drive moves within the play, link doesn't
+                linkVelocity = 0.0;
+            }
+        } else {
+            mLinkPositions[i] = mDrivePositions[i];
+        }
+        // stops, drive and link are pressed against each other
+        const Joint & joint = mJoints[i];
+        if ((mLinkPositions[i] < joint.PositionMin) || (mLinkPositions[i] > joint.PositionMax)) {
+            mLinkPositions[i] = std::min(std::max(mLinkPositions[i], joint.PositionMin), joint.PositionMax);
+            mDrivePositions[i] = mLinkPositions[i] + ((mDrivePositions[i] > mLinkPositions[i]) ? halfPlay : -halfPlay);
+            mDriveVelocities[i] = 0.0;
+            linkVelocity = 0.0;
+        }
+        mLinkVelocities[i] = linkVelocity;
+    }
+}
@@ -0,0 +1,186 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <cisstCommon/cmnLogger.h>
+#include <cisstOSAbstraction/osaGetTime.h>
+#include <cisstOSAbstraction/osaSleep.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLog.h>
+
+namespace {
+
+    typedef mtsIntuitiveResearchKitLogQueue Queue;
+
+    struct Registered {
+        std::shared_ptr<Queue> queue;
+        size_t dropped; // last reported
+    };
+
+    // queues are kept until the process ends, even if their thread stopped
+    std::mutex registryMutex;
+    std::vector<Registered> registry;
+    std::atomic<bool> running(false);
+    std::thread backgroundThread;
+
+    thread_local std::shared_ptr<Queue> threadQueue;
+
+    Queue & ThreadQueue(void)
+    {
+        if (!threadQueue) {
+            threadQueue = std::make_shared<Queue>(mtsIntuitiveResearchKit::Log::QueueSize,
+                                                  mtsIntuitiveResearchKit::Log::MinimumInterval);
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(Registered{threadQueue, 0});
+        }
+        return *threadQueue;
+    }
+
+    void Write(const Queue::Record & record)
+    {
+        std::stringstream text;
+        text << Queue::Format(record);
+        if (record.Code >= 0) {
+            text << " \"" << mtsExecutionResult(static_cast<mtsExecutionResult::Enum>(record.Code)) << "\"";
+        }
+        if (record.Level == Queue::LOG_ERROR) {
+            CMN_LOG_RUN_ERROR << text.str() << std::endl;
+        } else {
+            CMN_LOG_RUN_WARNING << text.str() << std::endl;
+        }
+    }
+
+    void Drain(Queue & queue)
+    {
+        Queue::Record record;
+        while (queue.Pop(record)) {
+            Write(record);
+        }
+    }
+
+    // called by the background thread or after it stopped
+    void DrainAll(void)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto & registered : registry) {
+            Drain(*(registered.queue));
+            const size_t dropped = registered.queue->Dropped();
+            if (dropped != registered.dropped) {
+                CMN_LOG_RUN_WARNING << "mtsIntuitiveResearchKitLog: " << (dropped - registered.dropped)
+                                    << " message(s) dropped, queue full" << std::endl;
+                registered.dropped = dropped;
+            }
+        }
+    }
+
+    void Background(void)
+    {
+        while (running) {
+            DrainAll();
+            osaSleep(mtsIntuitiveResearchKit::Log::Period);
+        }
+    }
+}
+
+void mtsIntuitiveResearchKitLog::Start(void)
+{
+    if (running) {
+        return;
+    }
+    running = true;
+    backgroundThread = std::thread(Background);
+}
+
+void mtsIntuitiveResearchKitLog::Stop(void)
+{
+    if (!running) {
+        return;
+    }
+    running = false;
+    backgroundThread.join();
+    DrainAll();
+}
+
+void mtsIntuitiveResearchKitLog::RegisterThread(void)
+{
+    ThreadQueue();
+}
+
+void mtsIntuitiveResearchKitLog::Error(const std::string & name, const char * message,
+                                       std::initializer_list<double> values)
+{
+    Push(Queue::LOG_ERROR, name, message, values, -1);
+}
+
+void mtsIntuitiveResearchKitLog::Error(const std::string & name, const char * message,
+                                       const mtsExecutionResult & result)
+{
+    Push(Queue::LOG_ERROR, name, message, {}, static_cast<int>(result.GetResult()));
+}
+
+void mtsIntuitiveResearchKitLog::Warning(const std::string & name, const char * message,
+                                         std::initializer_list<double> values)
+{
+    Push(Queue::LOG_WARNING, name, message, values, -1);
+}
+
+void mtsIntuitiveResearchKitLog::Warning(const std::string & name, const char * message,
+                                         const mtsExecutionResult & result)
+{
+    Push(Queue::LOG_WARNING, name, message, {}, static_cast<int>(result.GetResult()));
+}
+
+size_t mtsIntuitiveResearchKitLog::Dropped(void)
+{
+    size_t total = 0;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto & registered : registry) {
+        total += registered.queue->Dropped();
+    }
+    return total;
+}
+
+size_t mtsIntuitiveResearchKitLog::Suppressed(void)
+{
+    size_t total = 0;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto & registered : registry) {
+        total += registered.queue->Suppressed();
+    }
+    return total;
+}
+
+void mtsIntuitiveResearchKitLog::Push(const mtsIntuitiveResearchKitLogQueue::LevelType level,
+                                      const std::string & name, const char * message,
+                                      std::initializer_list<double> values, const int code)
+{
+    Queue & queue = ThreadQueue();
+    queue.Push(level, osaGetTime(), name, message, values, code);
+    // no background thread, write now
+    if (!running) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        Drain(queue);
+    }
+}
@@ -0,0 +1,141 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <sstream>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLogQueue.h>
+
+mtsIntuitiveResearchKitLogQueue::mtsIntuitiveResearchKitLogQueue(const size_t capacity,
+                                                                 const double minimumInterval):
+    mHead(0),
+    mTail(0),
+    mDropped(0),
+    mSuppressed(0),
+    mMinimumInterval(minimumInterval),
+    mNumberOfSites(0)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    mRecords.resize(size);
+    mMask = size - 1;
+}
+
+bool mtsIntuitiveResearchKitLogQueue::Push(const LevelType level, const double time,
+                                           const std::string & name, const char * message,
+                                           std::initializer_list<double> values,
+                                           const int code)
+{
+    // rate limiting per call site and component, sites are only
+    // known by this thread
+    const size_t nameHash = std::hash<std::string>()(name);
+    Site * site = nullptr;
+    for (size_t index = 0; index < mNumberOfSites; ++index) {
+        if ((mSites[index].Message == message)
+            && (mSites[index].NameHash == nameHash)) {
+            site = &(mSites[index]);
+            break;
+        }
+    }
+    if (!site && (mNumberOfSites < NUMBER_OF_SITES)) {
+        site = &(mSites[mNumberOfSites]);
+        ++mNumberOfSites;
+        site->Message = message;
+        site->NameHash = nameHash;
+        site->LastTime = -std::numeric_limits<double>::max();
+        site->Suppressed = 0;
+    } else if (site) {
+        if (time - site->LastTime < mMinimumInterval) {
+            ++(site->Suppressed);
+            ++mSuppressed;
+            return false;
+        }
+    }
+
+    const size_t head = mHead.load(std::memory_order_relaxed);
+    if (head - mTail.load(std::memory_order_acquire) >= mRecords.size()) {
+        ++mDropped;
+        return false;
+    }
+
+    Record & record = mRecords[head & mMask];
+    record.Level = level;
+    record.Time = time;
+    record.Message = message;
+    const size_t nameSize = std::min(name.size(), static_cast<size_t>(NAME_SIZE - 1));
+    std::memcpy(record.Name, name.data(), nameSize);
+    record.Name[nameSize] = '\0';
+    record.NumberOfValues = 0;
+    for (auto value : values) {
+        if (record.NumberOfValues == MAXIMUM_NUMBER_OF_VALUES) {
+            break;
+        }
+        record.Values[record.NumberOfValues] = value;
+        ++record.NumberOfValues;
+    }
+    record.Code = code;
+    record.Suppressed = 0;
+    // untracked sites (table full) are never rate limited
+    if (site) {
+        record.Suppressed = site->Suppressed;
+        site->Suppressed = 0;
+        site->LastTime = time;
+    }
+    mHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool mtsIntuitiveResearchKitLogQueue::Pop(Record & record)
+{
+    const size_t tail = mTail.load(std::memory_order_relaxed);
+    if (tail == mHead.load(std::memory_order_acquire)) {
+        return false;
+    }
+    record = mRecords[tail & mMask];
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+std::string mtsIntuitiveResearchKitLogQueue::Format(const Record & record)
+{
+    std::stringstream result;
+    if (record.Name[0] != '\0') {
+        result << record.Name << ": ";
+    }
+    result << record.Message;
+    if (record.NumberOfValues > 0) {
+        result << " [";
+        for (size_t index = 0; index < record.NumberOfValues; ++index) {
+            if (index != 0) {
+                result << ", ";
+            }
+            result << record.Values[index];
+        }
+        result << "]";
+    }
+    if (record.Suppressed > 0) {
+        result << " (" << record.Suppressed << " similar message"
+               << ((record.Suppressed > 1) ? "s" : "") << " suppressed)";
+    }
+    return result.str();
+}
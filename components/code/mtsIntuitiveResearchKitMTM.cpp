@@ -31,6 +31,7 @@ http://www.cisst.org/cisst/license.txt.
 
 #include <sawIntuitiveResearchKit/robManipulatorMTM.h>
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitMTM.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLog.h>
 #include "robGravityCompensationMTM.h"
 
 CMN_IMPLEMENT_SERVICES_DERIVED_ONEARG(mtsIntuitiveResearchKitMTM, mtsTaskPeriodic, mtsTaskPeriodicConstructorArg);
@@ -386,7 +387,7 @@ void mtsIntuitiveResearchKitMTM::RunCalibratingRoll(void)
     static const double maxTrackingError = 1.0 * cmnPI; // 1/2 turn
     double trackingError;
     static const double extraTime = 2.0 * cmn_s;
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     m_trajectory_j.Reflexxes.Evaluate(m_servo_jp,
                                       m_servo_jv,
@@ -461,7 +462,7 @@ void mtsIntuitiveResearchKitMTM::EnterResettingRollEncoder(void)
     IO.SetSomeEncoderPosition(values);
 
     // start timer
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
     mHomingTimer = currentTime;
 }
 
@@ -469,7 +470,7 @@ void mtsIntuitiveResearchKitMTM::RunResettingRollEncoder(void)
 {
     // wait for some time, no easy way to check if encoder has been reset
     const double timeToWait = 10.0 * cmn_ms;
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
     if ((currentTime - mHomingTimer) < timeToWait) {
         return;
     }
@@ -506,8 +507,8 @@ void mtsIntuitiveResearchKitMTM::GetRobotData(void)
     // get gripper based on analog inputs
     mtsExecutionResult executionResult = GripperIO.GetAnalogInputPosSI(m_gripper_measured_js);
     if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << GetName() << ": GetRobotData: call to GetAnalogInputPosSI failed \""
-                                << executionResult << "\"" << std::endl;
+        mtsIntuitiveResearchKitLog::Error(GetName(), "GetRobotData: call to GetAnalogInputPosSI failed",
+                                          executionResult);
         return;
     }
     // for timestamp, we assume the value ws collected at the same time as other joints
@@ -529,6 +530,13 @@ void mtsIntuitiveResearchKitMTM::GetRobotData(void)
     }
 }
 
+void mtsIntuitiveResearchKitMTM::UpdateSnapshot(mtsIntuitiveResearchKitArmSnapshotData & data)
+{
+    mtsIntuitiveResearchKitArm::UpdateSnapshot(data);
+    data.gripper_valid = m_gripper_measured_js.Valid();
+    data.gripper = m_gripper_measured_js.Position().at(0);
+}
+
 void mtsIntuitiveResearchKitMTM::control_servo_cf_orientation_locked(void)
 {
     // don't get current joint values!
@@ -551,7 +559,8 @@ void mtsIntuitiveResearchKitMTM::control_servo_cf_orientation_locked(void)
                                           m_trajectory_j.goal_v);
         servo_jp_internal(m_servo_jp);
     } else {
-        m_arm_interface->SendWarning(this->GetName() + ": unable to solve inverse kinematics in control_servo_cf_orientation_locked");
+        SendAggregated(mtsIntuitiveResearchKitMessageAggregator::MESSAGE_WARNING,
+                       "unable to solve inverse kinematics in control_servo_cf_orientation_locked");
     }
 }
 
@@ -639,7 +648,7 @@ void mtsIntuitiveResearchKitMTM::lock_orientation(const vctMatRot3 & orientation
         m_servo_jv.Assign(m_pid_measured_js.Velocity(), NumberOfJoints());
         m_trajectory_j.Reflexxes.Set(m_trajectory_j.v,
                                      m_trajectory_j.a,
-                                     StateTable.PeriodStats.PeriodAvg(),
+                                     ControlPeriod(),
                                      robReflexxes::Reflexxes_TIME);
     }
     // in any case, update desired orientation in local coordinate system
@@ -0,0 +1,114 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitMessageAggregator.h>
+
+mtsIntuitiveResearchKitMessageAggregator::mtsIntuitiveResearchKitMessageAggregator(const double interval,
+                                                                                   const size_t maximumNumberOfMessages):
+    mInterval(interval),
+    mMaximumNumberOfMessages(maximumNumberOfMessages)
+{
+    // entries are never removed, Add doesn't allocate once all messages are known
+    mEntries.reserve(maximumNumberOfMessages);
+}
+
+mtsIntuitiveResearchKitMessageAggregator::Entry *
+mtsIntuitiveResearchKitMessageAggregator::Find(const char * message)
+{
+    for (auto & entry : mEntries) {
+        if (entry.Message == message) {
+            return &entry;
+        }
+    }
+    if (mEntries.size() == mMaximumNumberOfMessages) {
+        return nullptr;
+    }
+    Entry entry;
+    entry.Level = MESSAGE_STATUS;
+    entry.Message = message;
+    entry.Count = 0;
+    entry.LastSent = -std::numeric_limits<double>::max();
+    mEntries.push_back(entry);
+    return &(mEntries.back());
+}
+
+bool mtsIntuitiveResearchKitMessageAggregator::Add(const LevelType level, const char * message)
+{
+    Entry * entry = Find(message);
+    if (!entry) {
+        return false;
+    }
+    entry->Level = level;
+    entry->Detail.clear();
+    ++(entry->Count);
+    return true;
+}
+
+bool mtsIntuitiveResearchKitMessageAggregator::Add(const LevelType level, const char * message,
+                                                   const std::string & detail)
+{
+    Entry * entry = Find(message);
+    if (!entry) {
+        return false;
+    }
+    entry->Level = level;
+    // assign reuses the capacity, no allocation for details of similar length
+    entry->Detail.assign(detail);
+    ++(entry->Count);
+    return true;
+}
+
+size_t mtsIntuitiveResearchKitMessageAggregator::Pending(const char * message) const
+{
+    for (const auto & entry : mEntries) {
+        if (entry.Message == message) {
+            return entry.Count;
+        }
+    }
+    return 0;
+}
+
+void mtsIntuitiveResearchKitMessageAggregator::Reset(const char * message)
+{
+    for (auto & entry : mEntries) {
+        if (entry.Message == message) {
+            entry.Count = 0;
+            entry.LastSent = -std::numeric_limits<double>::max();
+            return;
+        }
+    }
+}
+
+std::string mtsIntuitiveResearchKitMessageAggregator::Text(const Entry & entry,
+                                                           const double time) const
+{
+    std::stringstream text;
+    text << entry.Message;
+    if (!entry.Detail.empty()) {
+        text << " (" << entry.Detail << ")";
+    }
+    if (entry.Count > 1) {
+        text << " [" << entry.Count << " times";
+        // first occurrence of a message doesn't have a meaningful interval
+        if (entry.LastSent != -std::numeric_limits<double>::max()) {
+            text << " in " << (time - entry.LastSent) << "s";
+        }
+        text << "]";
+    }
+    return text.str();
+}
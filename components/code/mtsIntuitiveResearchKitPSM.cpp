@@ -475,7 +475,8 @@ robManipulator::Errno mtsIntuitiveResearchKitPSM::InverseKinematics(vctDoubleVec
 
     // if too close to zero we're going to run into issue in any case
     if (distanceToRCM < 1.0 * cmn_mm) {
-        m_arm_interface->SendWarning(GetName() + ": InverseKinematics, can't solve IK too close to RCM");
+        SendAggregated(mtsIntuitiveResearchKitMessageAggregator::MESSAGE_WARNING,
+                       "InverseKinematics, can't solve IK too close to RCM");
         return robManipulator::EFAILURE;
     }
 
@@ -487,7 +488,8 @@ robManipulator::Errno mtsIntuitiveResearchKitPSM::InverseKinematics(vctDoubleVec
         // Check for equality Snake joints (4,7) and (5,6)
         if (fabs(jointSet.at(4) - jointSet.at(7)) > 0.00001 ||
             fabs(jointSet.at(5) - jointSet.at(6)) > 0.00001) {
-            m_arm_interface->SendWarning(GetName() + ": InverseKinematics, equality constraint violated");
+            SendAggregated(mtsIntuitiveResearchKitMessageAggregator::MESSAGE_WARNING,
+                           "InverseKinematics, equality constraint violated");
         }
     }
 
@@ -828,7 +830,7 @@ void mtsIntuitiveResearchKitPSM::RunChangingCoupling(void)
         return;
     }
 
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     // first phase, disable last 4 joints and wait
     if (!CouplingChange.Started) {
@@ -1035,7 +1037,7 @@ void mtsIntuitiveResearchKitPSM::RunEngagingAdapter(void)
         return;
     }
 
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     if (EngagingStage == 1) {
         // configure PID to fail in case of tracking error
@@ -1156,7 +1158,7 @@ void mtsIntuitiveResearchKitPSM::RunEngagingTool(void)
         return;
     }
 
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     if (EngagingStage == 1) {
         // configure PID to fail in case of tracking error
@@ -1360,7 +1362,7 @@ void mtsIntuitiveResearchKitPSM::servo_jp_internal(const vctDoubleVec & newPosit
     m_servo_jp_param.Goal().Zeros();
     ToJointsPID(newPosition, m_servo_jp_param.Goal());
     m_servo_jp_param.Goal().at(6) = m_jaw_servo_jp;
-    m_servo_jp_param.SetTimestamp(StateTable.GetTic());
+    m_servo_jp_param.SetTimestamp(Now());
     PID.servo_jp(m_servo_jp_param);
 }
 
@@ -1412,7 +1414,7 @@ void mtsIntuitiveResearchKitPSM::servo_jf_internal(const vctDoubleVec & newEffor
 
     // convert to cisstParameterTypes
     mTorqueSetParam.SetForceTorque(torqueDesired);
-    mTorqueSetParam.SetTimestamp(StateTable.GetTic());
+    mTorqueSetParam.SetTimestamp(Now());
     PID.servo_jf(mTorqueSetParam);
 }
 
@@ -0,0 +1,361 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordFormat.h>
+
+const uint32_t mtsIntuitiveResearchKitRecordFormat::Magic;
+const uint16_t mtsIntuitiveResearchKitRecordFormat::Version;
+const size_t mtsIntuitiveResearchKitRecordFormat::HeaderSize;
+const size_t mtsIntuitiveResearchKitRecordFormat::RecordHeaderSize;
+const size_t mtsIntuitiveResearchKitRecordFormat::IndexEntrySize;
+
+namespace {
+
+    inline bool HostIsLittleEndian(void) {
+        const uint16_t one = 1;
+        return (*reinterpret_cast<const unsigned char *>(&one) == 1);
+    }
+
+    template <typename _type>
+    inline void WriteLE(char * & pointer, const _type value) {
+        memcpy(pointer, &value, sizeof(_type));
+        if (!HostIsLittleEndian()) {
+            std::reverse(pointer, pointer + sizeof(_type));
+        }
+        pointer += sizeof(_type);
+    }
+
+    template <typename _type>
+    inline _type ReadLE(const char * & pointer) {
+        char bytes[sizeof(_type)];
+        memcpy(bytes, pointer, sizeof(_type));
+        if (!HostIsLittleEndian()) {
+            std::reverse(bytes, bytes + sizeof(_type));
+        }
+        _type value;
+        memcpy(&value, bytes, sizeof(_type));
+        pointer += sizeof(_type);
+        return value;
+    }
+
+    // a 64 bits varint uses at most 10 bytes
+    const size_t MaximumVarintSize = 10;
+
+    inline void WriteVarint(char * & pointer, uint64_t value) {
+        while (value >= 0x80) {
+            *pointer = static_cast<char>((value & 0x7F) | 0x80);
+            ++pointer;
+            value >>= 7;
+        }
+        *pointer = static_cast<char>(value);
+        ++pointer;
+    }
+
+    inline bool ReadVarint(const char * & pointer, const char * end, uint64_t & value) {
+        value = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            if (pointer >= end) {
+                return false;
+            }
+            const uint8_t byte = static_cast<uint8_t>(*pointer);
+            ++pointer;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // small negative and positive values both use few bytes
+    inline uint64_t ZigZag(const int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t UnZigZag(const uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    inline uint64_t DoubleBits(const double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline double BitsDouble(const uint64_t bits) {
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    inline int64_t Nanoseconds(const double time) {
+        return static_cast<int64_t>(std::llround(time * 1.0e9));
+    }
+
+    inline double Seconds(const int64_t time) {
+        return static_cast<double>(time) * 1.0e-9;
+    }
+
+    inline void WriteString(char * & pointer, const std::string & value) {
+        WriteLE<uint16_t>(pointer, static_cast<uint16_t>(value.size()));
+        memcpy(pointer, value.data(), value.size());
+        pointer += value.size();
+    }
+
+    inline bool ReadString(const char * & pointer, const char * end, std::string & value) {
+        if (end - pointer < 2) {
+            return false;
+        }
+        const uint16_t size = ReadLE<uint16_t>(pointer);
+        if (end - pointer < size) {
+            return false;
+        }
+        value.assign(pointer, size);
+        pointer += size;
+        return true;
+    }
+}
+
+mtsIntuitiveResearchKitRecordFormat::Header::Header(void):
+    IndexOffset(0),
+    NumberOfIndexEntries(0),
+    NumberOfSignals(0),
+    DataEnd(HeaderSize)
+{
+}
+
+mtsIntuitiveResearchKitRecordFormat::RecordHeader::RecordHeader(void):
+    Type(0),
+    Signal(0),
+    NumberOfSamples(0),
+    PayloadSize(0),
+    StartTime(0.0),
+    EndTime(0.0)
+{
+}
+
+void mtsIntuitiveResearchKitRecordFormat::EncodeHeader(const Header & header, char * buffer)
+{
+    memset(buffer, 0, HeaderSize);
+    char * pointer = buffer;
+    WriteLE<uint32_t>(pointer, Magic);
+    WriteLE<uint16_t>(pointer, Version);
+    WriteLE<uint16_t>(pointer, static_cast<uint16_t>(HeaderSize));
+    WriteLE<uint64_t>(pointer, header.IndexOffset);
+    WriteLE<uint32_t>(pointer, header.NumberOfIndexEntries);
+    WriteLE<uint32_t>(pointer, header.NumberOfSignals);
+    WriteLE<uint64_t>(pointer, header.DataEnd);
+}
+
+bool mtsIntuitiveResearchKitRecordFormat::DecodeHeader(const char * buffer, const size_t size,
+                                                       Header & header)
+{
+    if (size < HeaderSize) {
+        return false;
+    }
+    const char * pointer = buffer;
+    if ((ReadLE<uint32_t>(pointer) != Magic)
+        || (ReadLE<uint16_t>(pointer) != Version)
+        || (ReadLE<uint16_t>(pointer) != HeaderSize)) {
+        return false;
+    }
+    header.IndexOffset = ReadLE<uint64_t>(pointer);
+    header.NumberOfIndexEntries = ReadLE<uint32_t>(pointer);
+    header.NumberOfSignals = ReadLE<uint32_t>(pointer);
+    header.DataEnd = ReadLE<uint64_t>(pointer);
+    return true;
+}
+
+void mtsIntuitiveResearchKitRecordFormat::EncodeRecordHeader(const RecordHeader & header, char * buffer)
+{
+    char * pointer = buffer;
+    WriteLE<uint32_t>(pointer, header.Type);
+    WriteLE<uint32_t>(pointer, header.Signal);
+    WriteLE<uint32_t>(pointer, header.NumberOfSamples);
+    WriteLE<uint32_t>(pointer, header.PayloadSize);
+    WriteLE<double>(pointer, header.StartTime);
+    WriteLE<double>(pointer, header.EndTime);
+}
+
+void mtsIntuitiveResearchKitRecordFormat::DecodeRecordHeader(const char * buffer, RecordHeader & header)
+{
+    const char * pointer = buffer;
+    header.Type = ReadLE<uint32_t>(pointer);
+    header.Signal = ReadLE<uint32_t>(pointer);
+    header.NumberOfSamples = ReadLE<uint32_t>(pointer);
+    header.PayloadSize = ReadLE<uint32_t>(pointer);
+    header.StartTime = ReadLE<double>(pointer);
+    header.EndTime = ReadLE<double>(pointer);
+}
+
+void mtsIntuitiveResearchKitRecordFormat::EncodeIndexEntry(const IndexEntry & entry, char * buffer)
+{
+    char * pointer = buffer;
+    WriteLE<uint32_t>(pointer, entry.Type);
+    WriteLE<uint32_t>(pointer, entry.Signal);
+    WriteLE<uint64_t>(pointer, entry.Offset);
+    WriteLE<double>(pointer, entry.StartTime);
+    WriteLE<double>(pointer, entry.EndTime);
+}
+
+void mtsIntuitiveResearchKitRecordFormat::DecodeIndexEntry(const char * buffer, IndexEntry & entry)
+{
+    const char * pointer = buffer;
+    entry.Type = ReadLE<uint32_t>(pointer);
+    entry.Signal = ReadLE<uint32_t>(pointer);
+    entry.Offset = ReadLE<uint64_t>(pointer);
+    entry.StartTime = ReadLE<double>(pointer);
+    entry.EndTime = ReadLE<double>(pointer);
+}
+
+size_t mtsIntuitiveResearchKitRecordFormat::SignalSize(const Signal & signal)
+{
+    size_t size = 2 + signal.Name.size() + 4;
+    for (const auto & name : signal.ScalarNames) {
+        size += 2 + name.size();
+    }
+    return size;
+}
+
+size_t mtsIntuitiveResearchKitRecordFormat::EncodeSignal(const Signal & signal, char * buffer,
+                                                         const size_t bufferSize)
+{
+    const size_t size = SignalSize(signal);
+    if (size > bufferSize) {
+        return 0;
+    }
+    char * pointer = buffer;
+    WriteString(pointer, signal.Name);
+    WriteLE<uint32_t>(pointer, static_cast<uint32_t>(signal.ScalarNames.size()));
+    for (const auto & name : signal.ScalarNames) {
+        WriteString(pointer, name);
+    }
+    return size;
+}
+
+bool mtsIntuitiveResearchKitRecordFormat::DecodeSignal(const char * buffer, const size_t size,
+                                                       Signal & signal)
+{
+    const char * pointer = buffer;
+    const char * end = buffer + size;
+    if (!ReadString(pointer, end, signal.Name)
+        || (end - pointer < 4)) {
+        return false;
+    }
+    const uint32_t numberOfScalars = ReadLE<uint32_t>(pointer);
+    // each name uses at least 2 bytes, avoids huge allocations for corrupted files
+    if (numberOfScalars > static_cast<size_t>(end - pointer) / 2) {
+        return false;
+    }
+    signal.ScalarNames.resize(numberOfScalars);
+    for (auto & name : signal.ScalarNames) {
+        if (!ReadString(pointer, end, name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double mtsIntuitiveResearchKitRecordFormat::StoredTime(const double time)
+{
+    return Seconds(Nanoseconds(time));
+}
+
+size_t mtsIntuitiveResearchKitRecordFormat::MaximumChunkSize(const size_t numberOfSamples,
+                                                             const size_t numberOfScalars)
+{
+    return numberOfSamples * (numberOfScalars + 1) * MaximumVarintSize;
+}
+
+size_t mtsIntuitiveResearchKitRecordFormat::EncodeChunk(const double * times, const double * values,
+                                                        const size_t numberOfSamples, const size_t numberOfScalars,
+                                                        const size_t stride,
+                                                        char * buffer, const size_t bufferSize)
+{
+    if (bufferSize < MaximumChunkSize(numberOfSamples, numberOfScalars)) {
+        return 0;
+    }
+    char * pointer = buffer;
+
+    // times, delta of delta is 0 for periodic samples
+    int64_t previousTime = 0;
+    int64_t previousDelta = 0;
+    for (size_t sample = 0; sample < numberOfSamples; ++sample) {
+        const int64_t time = Nanoseconds(times[sample]);
+        if (sample == 0) {
+            WriteVarint(pointer, ZigZag(time));
+        } else {
+            const int64_t delta = time - previousTime;
+            WriteVarint(pointer, ZigZag(delta - previousDelta));
+            previousDelta = delta;
+        }
+        previousTime = time;
+    }
+
+    // values, XOR with previous is 0 for constant values
+    for (size_t scalar = 0; scalar < numberOfScalars; ++scalar) {
+        const double * column = values + scalar * stride;
+        uint64_t previous = 0;
+        for (size_t sample = 0; sample < numberOfSamples; ++sample) {
+            const uint64_t bits = DoubleBits(column[sample]);
+            WriteVarint(pointer, bits ^ previous);
+            previous = bits;
+        }
+    }
+    return pointer - buffer;
+}
+
+bool mtsIntuitiveResearchKitRecordFormat::DecodeChunk(const char * buffer, const size_t size,
+                                                      const size_t numberOfSamples, const size_t numberOfScalars,
+                                                      double * times, double * values)
+{
+    const char * pointer = buffer;
+    const char * end = buffer + size;
+    uint64_t encoded;
+
+    int64_t time = 0;
+    int64_t delta = 0;
+    for (size_t sample = 0; sample < numberOfSamples; ++sample) {
+        if (!ReadVarint(pointer, end, encoded)) {
+            return false;
+        }
+        if (sample == 0) {
+            time = UnZigZag(encoded);
+        } else {
+            delta += UnZigZag(encoded);
+            time += delta;
+        }
+        times[sample] = Seconds(time);
+    }
+
+    for (size_t scalar = 0; scalar < numberOfScalars; ++scalar) {
+        uint64_t bits = 0;
+        for (size_t sample = 0; sample < numberOfSamples; ++sample) {
+            if (!ReadVarint(pointer, end, encoded)) {
+                return false;
+            }
+            bits ^= encoded;
+            values[sample * numberOfScalars + scalar] = BitsDouble(bits);
+        }
+    }
+    return (pointer == end);
+}
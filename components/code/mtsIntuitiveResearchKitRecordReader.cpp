@@ -0,0 +1,248 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordReader.h>
+
+mtsIntuitiveResearchKitRecordReader::mtsIntuitiveResearchKitRecordReader(void):
+    mMemory(nullptr),
+    mMemorySize(0),
+    mIndexed(false)
+{
+}
+
+mtsIntuitiveResearchKitRecordReader::~mtsIntuitiveResearchKitRecordReader()
+{
+    Close();
+}
+
+bool mtsIntuitiveResearchKitRecordReader::Open(const std::string & fileName)
+{
+    Close();
+#ifndef _WIN32
+    const int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        mLastError = "open \"" + fileName + "\": " + strerror(errno);
+        return false;
+    }
+    struct stat status;
+    if ((fstat(fileDescriptor, &status) != 0)
+        || (static_cast<size_t>(status.st_size) < Format::HeaderSize)) {
+        close(fileDescriptor);
+        mLastError = "file \"" + fileName + "\" is too small";
+        return false;
+    }
+    void * memory = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+    if (memory == MAP_FAILED) {
+        mLastError = "mmap \"" + fileName + "\": " + strerror(errno);
+        return false;
+    }
+    mMemory = static_cast<const char *>(memory);
+    mMemorySize = status.st_size;
+
+    Format::Header header;
+    if (!Format::DecodeHeader(mMemory, mMemorySize, header)) {
+        Close();
+        mLastError = "file \"" + fileName + "\" is not a recording or has an incompatible version";
+        return false;
+    }
+    mIndexed = LoadIndex(header);
+    if (!mIndexed) {
+        // file not closed properly, use all complete records
+        mSignals.clear();
+        mChunks.clear();
+        Scan();
+    }
+    return true;
+#else
+    mLastError = "memory mapped files are not supported on this platform";
+    return false;
+#endif
+}
+
+void mtsIntuitiveResearchKitRecordReader::Close(void)
+{
+#ifndef _WIN32
+    if (mMemory) {
+        munmap(const_cast<char *>(mMemory), mMemorySize);
+    }
+#endif
+    mMemory = nullptr;
+    mMemorySize = 0;
+    mIndexed = false;
+    mSignals.clear();
+    mChunks.clear();
+}
+
+bool mtsIntuitiveResearchKitRecordReader::AddRecord(const uint64_t offset)
+{
+    if ((offset < Format::HeaderSize)
+        || (offset + Format::RecordHeaderSize > mMemorySize)) {
+        return false;
+    }
+    Format::RecordHeader header;
+    Format::DecodeRecordHeader(mMemory + offset, header);
+    const uint64_t payloadOffset = offset + Format::RecordHeaderSize;
+    if (payloadOffset + header.PayloadSize > mMemorySize) {
+        return false;
+    }
+    switch (header.Type) {
+    case Format::SIGNAL_RECORD:
+        {
+            // signals are always written in order
+            if (header.Signal != mSignals.size()) {
+                return false;
+            }
+            Format::Signal signal;
+            if (!Format::DecodeSignal(mMemory + payloadOffset, header.PayloadSize, signal)) {
+                return false;
+            }
+            mSignals.push_back(signal);
+            mChunks.resize(mSignals.size());
+        }
+        return true;
+    case Format::CHUNK_RECORD:
+        {
+            // each time and value uses at least one byte
+            if ((header.Signal >= mSignals.size())
+                || (header.NumberOfSamples == 0)
+                || (header.PayloadSize < static_cast<uint64_t>(header.NumberOfSamples)
+                    * (mSignals[header.Signal].ScalarNames.size() + 1))) {
+                return false;
+            }
+            Chunk chunk;
+            chunk.Offset = offset;
+            chunk.NumberOfSamples = header.NumberOfSamples;
+            chunk.StartTime = header.StartTime;
+            chunk.EndTime = header.EndTime;
+            mChunks[header.Signal].push_back(chunk);
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool mtsIntuitiveResearchKitRecordReader::LoadIndex(const Format::Header & header)
+{
+    if ((header.IndexOffset == 0)
+        || (header.IndexOffset + static_cast<uint64_t>(header.NumberOfIndexEntries) * Format::IndexEntrySize
+            > mMemorySize)) {
+        return false;
+    }
+    Format::IndexEntry entry;
+    const char * pointer = mMemory + header.IndexOffset;
+    for (uint32_t index = 0; index < header.NumberOfIndexEntries; ++index) {
+        Format::DecodeIndexEntry(pointer, entry);
+        pointer += Format::IndexEntrySize;
+        if (!AddRecord(entry.Offset)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void mtsIntuitiveResearchKitRecordReader::Scan(void)
+{
+    // the header is written after the payload so all records with a
+    // valid header are complete, space reserved but not used is 0
+    uint64_t offset = Format::HeaderSize;
+    while (AddRecord(offset)) {
+        Format::RecordHeader header;
+        Format::DecodeRecordHeader(mMemory + offset, header);
+        offset += Format::RecordHeaderSize + header.PayloadSize;
+    }
+}
+
+int mtsIntuitiveResearchKitRecordReader::FindSignal(const std::string & name) const
+{
+    for (size_t signal = 0; signal < mSignals.size(); ++signal) {
+        if (mSignals[signal].Name == name) {
+            return static_cast<int>(signal);
+        }
+    }
+    return -1;
+}
+
+size_t mtsIntuitiveResearchKitRecordReader::NumberOfSamples(const size_t signal) const
+{
+    size_t result = 0;
+    for (const auto & chunk : mChunks.at(signal)) {
+        result += chunk.NumberOfSamples;
+    }
+    return result;
+}
+
+bool mtsIntuitiveResearchKitRecordReader::TimeRange(const size_t signal, double & startTime, double & endTime) const
+{
+    const std::vector<Chunk> & chunks = mChunks.at(signal);
+    if (chunks.empty()) {
+        return false;
+    }
+    startTime = chunks.front().StartTime;
+    endTime = chunks.back().EndTime;
+    return true;
+}
+
+int mtsIntuitiveResearchKitRecordReader::Read(const size_t signal, const double startTime, const double endTime,
+                                              std::vector<double> & times, std::vector<double> & values) const
+{
+    times.clear();
+    values.clear();
+    const std::vector<Chunk> & chunks = mChunks.at(signal);
+    const size_t numberOfScalars = mSignals.at(signal).ScalarNames.size();
+
+    // chunks are sorted by time, first chunk ending after start time
+    auto chunk = std::lower_bound(chunks.begin(), chunks.end(), startTime,
+                                  [](const Chunk & c, const double time) {
+                                      return c.EndTime < time;
+                                  });
+    std::vector<double> chunkTimes, chunkValues;
+    for (; (chunk != chunks.end()) && (chunk->StartTime <= endTime); ++chunk) {
+        Format::RecordHeader header;
+        Format::DecodeRecordHeader(mMemory + chunk->Offset, header);
+        chunkTimes.resize(chunk->NumberOfSamples);
+        chunkValues.resize(chunk->NumberOfSamples * numberOfScalars);
+        if (!Format::DecodeChunk(mMemory + chunk->Offset + Format::RecordHeaderSize, header.PayloadSize,
+                                 chunk->NumberOfSamples, numberOfScalars,
+                                 chunkTimes.data(), chunkValues.data())) {
+            mLastError = "corrupted chunk for signal \"" + mSignals[signal].Name + "\"";
+            return -1;
+        }
+        for (size_t sample = 0; sample < chunk->NumberOfSamples; ++sample) {
+            if ((chunkTimes[sample] >= startTime) && (chunkTimes[sample] <= endTime)) {
+                times.push_back(chunkTimes[sample]);
+                values.insert(values.end(),
+                              chunkValues.begin() + sample * numberOfScalars,
+                              chunkValues.begin() + (sample + 1) * numberOfScalars);
+            }
+        }
+    }
+    return static_cast<int>(times.size());
+}
@@ -0,0 +1,446 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordWriter.h>
+
+const size_t mtsIntuitiveResearchKitRecordWriter::MaximumNumberOfSignals;
+
+namespace {
+    // file grows by at least this size to limit the number of remaps
+    const size_t FileIncrement = 4 * 1024 * 1024;
+
+    // background thread wakes up at this period to check for full buffers
+    const std::chrono::milliseconds FlushPeriod(10);
+}
+
+struct mtsIntuitiveResearchKitRecordWriter::SignalBuffers {
+    SignalBuffers(const std::string & name, const std::vector<std::string> & scalarNames,
+                  const size_t chunkSize, const size_t numberOfBuffers):
+        NumberOfScalars(scalarNames.size()),
+        Times(chunkSize * numberOfBuffers, 0.0),
+        Values(chunkSize * numberOfBuffers * scalarNames.size(), 0.0),
+        States(numberOfBuffers),
+        Counts(numberOfBuffers),
+        Current(0),
+        Next(0),
+        Written(false)
+    {
+        Description.Name = name;
+        Description.ScalarNames = scalarNames;
+        for (size_t buffer = 0; buffer < numberOfBuffers; ++buffer) {
+            States[buffer].store(BUFFER_FREE, std::memory_order_relaxed);
+            Counts[buffer].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    Format::Signal Description;
+    size_t NumberOfScalars;
+    // buffer b uses Times[b * chunkSize] and, stored by column,
+    // Values[b * chunkSize * NumberOfScalars]
+    std::vector<double> Times;
+    std::vector<double> Values;
+    std::vector<std::atomic<uint32_t> > States;
+    std::vector<std::atomic<uint32_t> > Counts;
+    size_t Current; // only used by the thread appending
+    size_t Next;    // only used by the background thread
+    bool Written;   // only used by the background thread
+};
+
+mtsIntuitiveResearchKitRecordWriter::mtsIntuitiveResearchKitRecordWriter(void):
+    mChunkSize(0),
+    mNumberOfBuffers(0),
+    mNumberOfSignals(0),
+    mOpen(false),
+    mStop(false),
+    mFileDescriptor(-1),
+    mMemory(nullptr),
+    mMemorySize(0),
+    mOffset(0),
+    mNumberOfSignalRecords(0),
+    mFailed(false),
+    mNumberOfSamples(0),
+    mNumberOfDroppedSamples(0),
+    mNumberOfChunks(0),
+    mNumberOfBytes(0)
+{
+}
+
+mtsIntuitiveResearchKitRecordWriter::~mtsIntuitiveResearchKitRecordWriter()
+{
+    Close();
+}
+
+bool mtsIntuitiveResearchKitRecordWriter::Fail(const std::string & what)
+{
+    std::lock_guard<std::mutex> lock(mErrorMutex);
+    mLastError = what + " \"" + mFileName + "\": " + strerror(errno);
+    mFailed = true;
+    return false;
+}
+
+std::string mtsIntuitiveResearchKitRecordWriter::LastError(void) const
+{
+    std::lock_guard<std::mutex> lock(mErrorMutex);
+    return mLastError;
+}
+
+bool mtsIntuitiveResearchKitRecordWriter::Open(const std::string & fileName,
+                                               const size_t chunkSize,
+                                               const size_t numberOfBuffers)
+{
+    if (IsOpen()) {
+        std::lock_guard<std::mutex> lock(mErrorMutex);
+        mLastError = "file \"" + mFileName + "\" is already open";
+        return false;
+    }
+    mFileName = fileName;
+    if ((chunkSize == 0) || (numberOfBuffers < 2)) {
+        std::lock_guard<std::mutex> lock(mErrorMutex);
+        mLastError = "chunk size must be strictly positive and there must be at least 2 buffers";
+        return false;
+    }
+    mChunkSize = chunkSize;
+    mNumberOfBuffers = numberOfBuffers;
+    mFailed = false;
+    mIndex.clear();
+    mNumberOfSignalRecords = 0;
+    mNumberOfSamples = 0;
+    mNumberOfDroppedSamples = 0;
+    mNumberOfChunks = 0;
+#ifndef _WIN32
+    mFileDescriptor = open(fileName.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (mFileDescriptor < 0) {
+        return Fail("open");
+    }
+    mOffset = Format::HeaderSize;
+    if (!Reserve(0)) {
+        close(mFileDescriptor);
+        mFileDescriptor = -1;
+        return false;
+    }
+    UpdateHeader(0);
+    mStop = false;
+    mOpen = true;
+    mThread = std::thread(&mtsIntuitiveResearchKitRecordWriter::Run, this);
+    return true;
+#else
+    std::lock_guard<std::mutex> lock(mErrorMutex);
+    mLastError = "memory mapped files are not supported on this platform";
+    return false;
+#endif
+}
+
+bool mtsIntuitiveResearchKitRecordWriter::Close(void)
+{
+    if (!IsOpen()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mThreadMutex);
+        mStop = true;
+    }
+    mCondition.notify_one();
+    mThread.join();
+
+    bool result = !mFailed;
+#ifndef _WIN32
+    if (!mFailed) {
+        // index at the end, then header to mark the file as closed
+        const size_t indexOffset = mOffset;
+        if (Reserve(mIndex.size() * Format::IndexEntrySize)) {
+            for (const auto & entry : mIndex) {
+                Format::EncodeIndexEntry(entry, mMemory + mOffset);
+                mOffset += Format::IndexEntrySize;
+            }
+            UpdateHeader(indexOffset);
+            if (msync(mMemory, mOffset, MS_SYNC) != 0) {
+                result = Fail("msync");
+            }
+        } else {
+            result = false;
+        }
+    }
+    if (mMemory) {
+        munmap(mMemory, mMemorySize);
+    }
+    // remove unused space reserved at the end
+    if ((ftruncate(mFileDescriptor, mOffset) != 0) && result) {
+        result = Fail("ftruncate");
+    }
+    close(mFileDescriptor);
+#endif
+    mFileDescriptor = -1;
+    mMemory = nullptr;
+    mMemorySize = 0;
+    mNumberOfBytes = mOffset;
+
+    std::lock_guard<std::mutex> lock(mSignalsMutex);
+    const size_t numberOfSignals = mNumberOfSignals;
+    for (size_t signal = 0; signal < numberOfSignals; ++signal) {
+        mSignals[signal].reset();
+    }
+    mNumberOfSignals = 0;
+    mOpen = false;
+    return result;
+}
+
+int mtsIntuitiveResearchKitRecordWriter::AddSignal(const std::string & name,
+                                                   const std::vector<std::string> & scalarNames)
+{
+    std::lock_guard<std::mutex> lock(mSignalsMutex);
+    std::lock_guard<std::mutex> errorLock(mErrorMutex);
+    if (!IsOpen()) {
+        mLastError = "can't add signal \"" + name + "\", file is not open";
+        return -1;
+    }
+    const size_t id = mNumberOfSignals.load(std::memory_order_relaxed);
+    if (id >= MaximumNumberOfSignals) {
+        mLastError = "can't add signal \"" + name + "\", too many signals";
+        return -1;
+    }
+    mSignals[id].reset(new SignalBuffers(name, scalarNames, mChunkSize, mNumberOfBuffers));
+    // publish after the buffers have been allocated
+    mNumberOfSignals.store(id + 1, std::memory_order_release);
+    return static_cast<int>(id);
+}
+
+bool mtsIntuitiveResearchKitRecordWriter::Append(const int signal, const double time, const double * values)
+{
+    if ((signal < 0)
+        || (static_cast<size_t>(signal) >= mNumberOfSignals.load(std::memory_order_acquire))) {
+        return false;
+    }
+    SignalBuffers & buffers = *(mSignals[signal]);
+    const size_t buffer = buffers.Current;
+    const uint32_t state = buffers.States[buffer].load(std::memory_order_acquire);
+    if (state == BUFFER_FULL) {
+        // background thread didn't keep up
+        mNumberOfDroppedSamples.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    uint32_t count = 0;
+    if (state == BUFFER_FREE) {
+        buffers.States[buffer].store(BUFFER_FILLING, std::memory_order_relaxed);
+    } else {
+        count = buffers.Counts[buffer].load(std::memory_order_relaxed);
+    }
+
+    const size_t first = buffer * mChunkSize;
+    buffers.Times[first + count] = time;
+    double * column = buffers.Values.data() + first * buffers.NumberOfScalars + count;
+    for (size_t scalar = 0; scalar < buffers.NumberOfScalars; ++scalar) {
+        *column = values[scalar];
+        column += mChunkSize;
+    }
+    ++count;
+    buffers.Counts[buffer].store(count, std::memory_order_relaxed);
+
+    if (count == mChunkSize) {
+        buffers.States[buffer].store(BUFFER_FULL, std::memory_order_release);
+        buffers.Current = (buffer + 1) % mNumberOfBuffers;
+    }
+    mNumberOfSamples.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+mtsIntuitiveResearchKitRecordWriter::Statistics mtsIntuitiveResearchKitRecordWriter::GetStatistics(void) const
+{
+    Statistics statistics;
+    statistics.NumberOfSamples = mNumberOfSamples;
+    statistics.NumberOfDroppedSamples = mNumberOfDroppedSamples;
+    statistics.NumberOfChunks = mNumberOfChunks;
+    statistics.NumberOfBytes = mNumberOfBytes;
+    return statistics;
+}
+
+void mtsIntuitiveResearchKitRecordWriter::Run(void)
+{
+    std::unique_lock<std::mutex> lock(mThreadMutex);
+    while (!mStop) {
+        lock.unlock();
+        Flush(false);
+        lock.lock();
+        mCondition.wait_for(lock, FlushPeriod, [this] { return mStop; });
+    }
+    lock.unlock();
+    // producers have stopped, also write partial buffers
+    Flush(true);
+}
+
+void mtsIntuitiveResearchKitRecordWriter::Flush(const bool final)
+{
+    if (mFailed) {
+        return;
+    }
+    const size_t numberOfSignals = mNumberOfSignals.load(std::memory_order_acquire);
+    const size_t offset = mOffset;
+
+    // signal descriptions first so readers know them before any chunk
+    for (size_t id = 0; id < numberOfSignals; ++id) {
+        SignalBuffers & signal = *(mSignals[id]);
+        if (!signal.Written && !WriteSignal(id, signal)) {
+            return;
+        }
+    }
+
+    // full buffers in the order they have been filled
+    for (size_t id = 0; id < numberOfSignals; ++id) {
+        SignalBuffers & signal = *(mSignals[id]);
+        while (signal.States[signal.Next].load(std::memory_order_acquire) == BUFFER_FULL) {
+            if (!WriteChunk(id, signal, signal.Next)) {
+                return;
+            }
+            signal.States[signal.Next].store(BUFFER_FREE, std::memory_order_release);
+            signal.Next = (signal.Next + 1) % mNumberOfBuffers;
+        }
+        if (final
+            && (signal.States[signal.Next].load(std::memory_order_acquire) == BUFFER_FILLING)) {
+            if (!WriteChunk(id, signal, signal.Next)) {
+                return;
+            }
+            signal.States[signal.Next].store(BUFFER_FREE, std::memory_order_release);
+        }
+    }
+
+    if (mOffset != offset) {
+        UpdateHeader(0);
+#ifndef _WIN32
+        // let the kernel start writing, don't wait
+        msync(mMemory, mOffset, MS_ASYNC);
+#endif
+    }
+}
+
+bool mtsIntuitiveResearchKitRecordWriter::WriteSignal(const size_t id, SignalBuffers & signal)
+{
+    const size_t size = Format::SignalSize(signal.Description);
+    if (!Reserve(Format::RecordHeaderSize + size)) {
+        return false;
+    }
+    Format::EncodeSignal(signal.Description, mMemory + mOffset + Format::RecordHeaderSize, size);
+    Format::RecordHeader header;
+    header.Type = Format::SIGNAL_RECORD;
+    header.Signal = static_cast<uint32_t>(id);
+    header.PayloadSize = static_cast<uint32_t>(size);
+    // header after payload, a record with a header is complete
+    Format::EncodeRecordHeader(header, mMemory + mOffset);
+
+    Format::IndexEntry entry;
+    entry.Type = header.Type;
+    entry.Signal = header.Signal;
+    entry.Offset = mOffset;
+    entry.StartTime = 0.0;
+    entry.EndTime = 0.0;
+    mIndex.push_back(entry);
+
+    mOffset += Format::RecordHeaderSize + size;
+    mNumberOfBytes = mOffset;
+    mNumberOfSignalRecords++;
+    signal.Written = true;
+    return true;
+}
+
+bool mtsIntuitiveResearchKitRecordWriter::WriteChunk(const size_t id, SignalBuffers & signal, const size_t buffer)
+{
+    const size_t count = signal.Counts[buffer].load(std::memory_order_relaxed);
+    if (count == 0) {
+        return true;
+    }
+    const size_t maximumSize = Format::MaximumChunkSize(count, signal.NumberOfScalars);
+    if (!Reserve(Format::RecordHeaderSize + maximumSize)) {
+        return false;
+    }
+    const size_t first = buffer * mChunkSize;
+    const size_t size =
+        Format::EncodeChunk(signal.Times.data() + first,
+                            signal.Values.data() + first * signal.NumberOfScalars,
+                            count, signal.NumberOfScalars, mChunkSize,
+                            mMemory + mOffset + Format::RecordHeaderSize, maximumSize);
+    Format::RecordHeader header;
+    header.Type = Format::CHUNK_RECORD;
+    header.Signal = static_cast<uint32_t>(id);
+    header.NumberOfSamples = static_cast<uint32_t>(count);
+    header.PayloadSize = static_cast<uint32_t>(size);
+    // same times as decoded samples so time range queries are consistent
+    header.StartTime = Format::StoredTime(signal.Times[first]);
+    header.EndTime = Format::StoredTime(signal.Times[first + count - 1]);
+    Format::EncodeRecordHeader(header, mMemory + mOffset);
+
+    Format::IndexEntry entry;
+    entry.Type = header.Type;
+    entry.Signal = header.Signal;
+    entry.Offset = mOffset;
+    entry.StartTime = header.StartTime;
+    entry.EndTime = header.EndTime;
+    mIndex.push_back(entry);
+
+    mOffset += Format::RecordHeaderSize + size;
+    mNumberOfBytes = mOffset;
+    mNumberOfChunks++;
+    return true;
+}
+
+bool mtsIntuitiveResearchKitRecordWriter::Reserve(const size_t size)
+{
+    const size_t required = mOffset + size;
+    if (required <= mMemorySize) {
+        return true;
+    }
+#ifndef _WIN32
+    size_t newSize = std::max(2 * mMemorySize, required);
+    newSize = ((newSize + FileIncrement - 1) / FileIncrement) * FileIncrement;
+    if (mMemory) {
+        munmap(mMemory, mMemorySize);
+        mMemory = nullptr;
+        mMemorySize = 0;
+    }
+    if (ftruncate(mFileDescriptor, newSize) != 0) {
+        return Fail("ftruncate");
+    }
+    void * memory = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFileDescriptor, 0);
+    if (memory == MAP_FAILED) {
+        return Fail("mmap");
+    }
+    mMemory = static_cast<char *>(memory);
+    mMemorySize = newSize;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void mtsIntuitiveResearchKitRecordWriter::UpdateHeader(const uint64_t indexOffset)
+{
+    Format::Header header;
+    header.IndexOffset = indexOffset;
+    header.NumberOfIndexEntries = (indexOffset == 0) ? 0 : static_cast<uint32_t>(mIndex.size());
+    header.NumberOfSignals = static_cast<uint32_t>(mNumberOfSignalRecords);
+    header.DataEnd = (indexOffset == 0) ? mOffset : indexOffset;
+    Format::EncodeHeader(header, mMemory);
+}
@@ -0,0 +1,276 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecorder.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArm.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitSUJ.h>
+#include <cisstMultiTask/mtsInterfaceProvided.h>
+#include <cisstMultiTask/mtsInterfaceRequired.h>
+#include <cisstMultiTask/mtsManagerLocal.h>
+
+CMN_IMPLEMENT_SERVICES_DERIVED(mtsIntuitiveResearchKitRecorder, mtsTaskPeriodic)
+
+mtsIntuitiveResearchKitRecorder::mtsIntuitiveResearchKitRecorder(const std::string & name, const double period,
+                                                                 std::shared_ptr<mtsIntuitiveResearchKitRecordWriter> writer,
+                                                                 const std::string & prefix):
+    mtsTaskPeriodic(name, period),
+    mPrefix(prefix),
+    mWriter(writer),
+    mNumberOfSamples(0),
+    mNumberOfDuplicates(0),
+    mNumberOfDroppedSamples(0)
+{
+    StateTable.AddData(mNumberOfSamples, "NumberOfSamples");
+    StateTable.AddData(mNumberOfDuplicates, "NumberOfDuplicates");
+    StateTable.AddData(mNumberOfDroppedSamples, "NumberOfDroppedSamples");
+
+    mtsInterfaceProvided * provided = AddInterfaceProvided("Recorder");
+    if (provided) {
+        provided->AddCommandReadState(StateTable, StateTable.PeriodStats, "period_statistics");
+        provided->AddCommandReadState(StateTable, mNumberOfSamples, "GetNumberOfSamples");
+        provided->AddCommandReadState(StateTable, mNumberOfDuplicates, "GetNumberOfDuplicates");
+        provided->AddCommandReadState(StateTable, mNumberOfDroppedSamples, "GetNumberOfDroppedSamples");
+    }
+    AddInterfaceRequired("Source");
+}
+
+mtsIntuitiveResearchKitRecorder::~mtsIntuitiveResearchKitRecorder()
+{
+    for (auto signal : mSignals) {
+        delete signal;
+    }
+}
+
+void mtsIntuitiveResearchKitRecorder::Configure(const std::vector<std::string> & signals)
+{
+    mtsInterfaceRequired * required = GetInterfaceRequired("Source");
+    for (const auto & name : signals) {
+        Signal * signal = new Signal;
+        signal->Name = name;
+        // signals not provided are reported in Startup
+        required->AddFunction(name, signal->Function, MTS_OPTIONAL);
+        mSignals.push_back(signal);
+    }
+}
+
+void mtsIntuitiveResearchKitRecorder::Startup(void)
+{
+    // allocate data using the command prototypes
+    for (auto signal : mSignals) {
+        if (!signal->Function.IsValid()) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup " << this->GetName()
+                                       << ": signal \"" << signal->Name
+                                       << "\" is not provided, it will not be recorded" << std::endl;
+            continue;
+        }
+        const mtsGenericObject * prototype = signal->Function.GetArgumentPrototype();
+        if (prototype) {
+            signal->Data = dynamic_cast<mtsGenericObject *>(prototype->Services()->Create(*prototype));
+        }
+        if (!signal->Data) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup " << this->GetName()
+                                       << ": can't create data for signal \"" << signal->Name
+                                       << "\", it will not be recorded" << std::endl;
+        }
+    }
+}
+
+void mtsIntuitiveResearchKitRecorder::RecordedScalars(const mtsGenericObject & data,
+                                                      std::vector<size_t> & indices,
+                                                      std::vector<std::string> & names)
+{
+    // timestamps are recorded as sample times
+    indices.clear();
+    names.clear();
+    const size_t numberOfScalars = data.ScalarNumber();
+    for (size_t index = 0; index < numberOfScalars; ++index) {
+        const std::string name = data.ScalarDescription(index, "");
+        if ((name != "Timestamp") && (name != "AutomaticTimestamp")) {
+            indices.push_back(index);
+            names.push_back(name);
+        }
+    }
+}
+
+bool mtsIntuitiveResearchKitRecorder::AddSignal(Signal & signal)
+{
+    // scalars are known once data has been read since vector sizes
+    // can be set at runtime
+    std::vector<std::string> names;
+    RecordedScalars(*(signal.Data), signal.Scalars, names);
+    signal.Values.resize(signal.Scalars.size());
+    signal.Id = mWriter->AddSignal(mPrefix + signal.Name, names);
+    if (signal.Id < 0) {
+        CMN_LOG_CLASS_RUN_ERROR << "AddSignal " << this->GetName()
+                                << ": failed to add signal \"" << signal.Name
+                                << "\", " << mWriter->LastError() << std::endl;
+        // don't try again
+        delete signal.Data;
+        signal.Data = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void mtsIntuitiveResearchKitRecorder::Run(void)
+{
+    ProcessQueuedCommands();
+
+    if (!mWriter) {
+        return;
+    }
+
+    for (auto signal : mSignals) {
+        if (!signal->Data) {
+            continue;
+        }
+        const mtsExecutionResult result = signal->Function(*(signal->Data));
+        if (!result.IsOK()) {
+            continue;
+        }
+        double time = signal->Data->Timestamp();
+        if (time == 0.0) {
+            time = mtsComponentManager::GetInstance()->GetTimeServer().GetRelativeTime();
+        } else if (time == signal->LastTimestamp) {
+            // source didn't run since last sample
+            mNumberOfDuplicates++;
+            continue;
+        }
+        signal->LastTimestamp = time;
+        if ((signal->Id < 0) && !AddSignal(*signal)) {
+            continue;
+        }
+        // size changed since first sample
+        if (!signal->Scalars.empty()
+            && (signal->Scalars.back() >= signal->Data->ScalarNumber())) {
+            mNumberOfDroppedSamples++;
+            continue;
+        }
+        for (size_t index = 0; index < signal->Scalars.size(); ++index) {
+            signal->Values[index] = signal->Data->Scalar(signal->Scalars[index]);
+        }
+        if (mWriter->Append(signal->Id, time, signal->Values.data())) {
+            mNumberOfSamples++;
+        } else {
+            mNumberOfDroppedSamples++;
+        }
+    }
+}
+
+void mtsIntuitiveResearchKitRecorder::Cleanup(void)
+{
+    // last recorder using the writer closes the file
+    mWriter.reset();
+}
+
+bool mtsIntuitiveResearchKitRecorder::AddRecorders(const Json::Value & jsonConfig)
+{
+    Json::Value jsonValue;
+
+    jsonValue = jsonConfig["file"];
+    if (jsonValue.empty()) {
+        CMN_LOG_INIT_ERROR << "mtsIntuitiveResearchKitRecorder::AddRecorders: can't find \"file\"" << std::endl;
+        return false;
+    }
+    const std::string fileName = jsonValue.asString();
+    size_t chunkSize = mtsIntuitiveResearchKit::Recorder::ChunkSize;
+    jsonValue = jsonConfig["chunk-size"];
+    if (!jsonValue.empty()) {
+        chunkSize = jsonValue.asUInt();
+    }
+    size_t numberOfBuffers = mtsIntuitiveResearchKit::Recorder::NumberOfBuffers;
+    jsonValue = jsonConfig["buffers"];
+    if (!jsonValue.empty()) {
+        numberOfBuffers = jsonValue.asUInt();
+    }
+
+    const Json::Value jsonSources = jsonConfig["sources"];
+    if (jsonSources.empty()) {
+        CMN_LOG_INIT_ERROR << "mtsIntuitiveResearchKitRecorder::AddRecorders: can't find \"sources\"" << std::endl;
+        return false;
+    }
+
+    auto writer = std::make_shared<mtsIntuitiveResearchKitRecordWriter>();
+    if (!writer->Open(fileName, chunkSize, numberOfBuffers)) {
+        CMN_LOG_INIT_ERROR << "mtsIntuitiveResearchKitRecorder::AddRecorders: failed to open file, "
+                           << writer->LastError() << std::endl;
+        return false;
+    }
+
+    mtsManagerLocal * componentManager = mtsManagerLocal::GetInstance();
+    for (unsigned int index = 0; index < jsonSources.size(); ++index) {
+        const Json::Value jsonSource = jsonSources[index];
+        jsonValue = jsonSource["component"];
+        if (jsonValue.empty()) {
+            CMN_LOG_INIT_ERROR << "mtsIntuitiveResearchKitRecorder::AddRecorders: sources["
+                               << index << "] can't find \"component\"" << std::endl;
+            return false;
+        }
+        const std::string componentName = jsonValue.asString();
+        mtsComponent * component = componentManager->GetComponent(componentName);
+        if (!component) {
+            CMN_LOG_INIT_ERROR << "mtsIntuitiveResearchKitRecorder::AddRecorders: sources["
+                               << index << "] component \"" << componentName << "\" doesn't exist" << std::endl;
+            return false;
+        }
+        std::string interfaceName = "Arm";
+        jsonValue = jsonSource["interface"];
+        if (!jsonValue.empty()) {
+            interfaceName = jsonValue.asString();
+        }
+        double period = mtsIntuitiveResearchKit::Recorder::Period;
+        jsonValue = jsonSource["period"];
+        if (!jsonValue.empty()) {
+            period = jsonValue.asDouble();
+        }
+        std::vector<std::string> signals;
+        const Json::Value jsonSignals = jsonSource["signals"];
+        for (unsigned int signal = 0; signal < jsonSignals.size(); ++signal) {
+            signals.push_back(jsonSignals[signal].asString());
+        }
+        if (signals.empty()) {
+            CMN_LOG_INIT_ERROR << "mtsIntuitiveResearchKitRecorder::AddRecorders: sources["
+                               << index << "] can't find \"signals\"" << std::endl;
+            return false;
+        }
+
+        const std::string recorderName = componentName + "-" + interfaceName + "-Recorder";
+        mtsIntuitiveResearchKitRecorder * recorder =
+            new mtsIntuitiveResearchKitRecorder(recorderName, period, writer,
+                                                componentName + "/" + interfaceName + "/");
+        recorder->Configure(signals);
+        componentManager->AddComponent(recorder);
+        if (!componentManager->Connect(recorderName, "Source", componentName, interfaceName)) {
+            CMN_LOG_INIT_ERROR << "mtsIntuitiveResearchKitRecorder::AddRecorders: sources["
+                               << index << "] failed to connect to \"" << componentName
+                               << "\" interface \"" << interfaceName << "\"" << std::endl;
+            return false;
+        }
+        // dVRK arms trigger ExecOut at the end of each cycle, recorder runs in arm thread
+        if (dynamic_cast<mtsIntuitiveResearchKitArm *>(component)
+            || dynamic_cast<mtsIntuitiveResearchKitSUJ *>(component)) {
+            componentManager->Connect(recorderName, "ExecIn", componentName, "ExecOut");
+        } else {
+            CMN_LOG_INIT_WARNING << "mtsIntuitiveResearchKitRecorder::AddRecorders: component \""
+                                 << componentName << "\" doesn't trigger ExecOut, recorder \""
+                                 << recorderName << "\" will run at its own rate" << std::endl;
+        }
+    }
+    return true;
+}
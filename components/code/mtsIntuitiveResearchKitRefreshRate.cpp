@@ -0,0 +1,78 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRefreshRate.h>
+
+mtsIntuitiveResearchKitRefreshRate::mtsIntuitiveResearchKitRefreshRate(const double period,
+                                                                       const double unfocusedFactor,
+                                                                       const double minimizedPeriod,
+                                                                       const double loadInterval):
+    mPeriod(period),
+    mUnfocusedFactor(std::max(unfocusedFactor, 1.0)),
+    mMinimizedPeriod(minimizedPeriod),
+    mVisibility(REFRESH_FOCUSED),
+    mLoadInterval(loadInterval),
+    mLoadStart(-1.0),
+    mReads(0),
+    mSnapshots(0),
+    mReadsPerSecond(0.0),
+    mSnapshotsPerSecond(0.0)
+{
+}
+
+double mtsIntuitiveResearchKitRefreshRate::Period(const VisibilityType visibility) const
+{
+    switch (visibility) {
+    case REFRESH_UNFOCUSED:
+        return mPeriod * mUnfocusedFactor;
+    case REFRESH_MINIMIZED:
+        return std::max(mPeriod, mMinimizedPeriod);
+    default:
+        return mPeriod;
+    }
+}
+
+bool mtsIntuitiveResearchKitRefreshRate::SetVisibility(const VisibilityType visibility)
+{
+    const double previous = CurrentPeriod();
+    mVisibility = visibility;
+    return (CurrentPeriod() != previous);
+}
+
+bool mtsIntuitiveResearchKitRefreshRate::UpdateLoad(const double time)
+{
+    // first call only starts the interval
+    if (mLoadStart < 0.0) {
+        mLoadStart = time;
+        mReads = 0;
+        mSnapshots = 0;
+        return false;
+    }
+    const double elapsed = time - mLoadStart;
+    if (elapsed < mLoadInterval) {
+        return false;
+    }
+    mReadsPerSecond = mReads / elapsed;
+    mSnapshotsPerSecond = mSnapshots / elapsed;
+    mLoadStart = time;
+    mReads = 0;
+    mSnapshots = 0;
+    return true;
+}
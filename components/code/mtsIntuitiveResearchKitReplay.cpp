@@ -0,0 +1,609 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-12
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+#include <cisstOSAbstraction/osaGetTime.h>
+#include <cisstOSAbstraction/osaSleep.h>
+#include <cisstMultiTask/mtsInterfaceProvided.h>
+#include <cisstMultiTask/mtsVector.h>
+#include <cisstParameterTypes/prmForceTorqueJointSet.h>
+#include <cisstParameterTypes/prmMaskedVector.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecorder.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitReplay.h>
+
+CMN_IMPLEMENT_SERVICES_DERIVED(mtsIntuitiveResearchKitReplay, mtsTaskContinuous)
+
+namespace {
+    // number of scalars recorded before the vector elements
+    size_t RecordedOffset(const mtsGenericObject & data) {
+        std::vector<size_t> indices;
+        std::vector<std::string> names;
+        mtsIntuitiveResearchKitRecorder::RecordedScalars(data, indices, names);
+        return indices.size();
+    }
+
+    // last elements of a recorded vector of booleans
+    void FillBoolVec(const double * values, const size_t numberOfScalars, vctBoolVec & result) {
+        const size_t offset = std::min(RecordedOffset(mtsBoolVec()), numberOfScalars);
+        result.SetSize(numberOfScalars - offset);
+        for (size_t index = 0; index < result.size(); ++index) {
+            result.at(index) = (values[offset + index] != 0.0);
+        }
+    }
+}
+
+bool mtsIntuitiveResearchKitReplay::StateJointLayout::Configure(const size_t numberOfScalars)
+{
+    prmStateJoint probe;
+    std::vector<size_t> indices;
+    std::vector<std::string> names;
+
+    // number of scalars without and per joint
+    const size_t offset = RecordedOffset(probe);
+    probe.Position().SetSize(1);
+    probe.Velocity().SetSize(1);
+    probe.Effort().SetSize(1);
+    const size_t perJoint = RecordedOffset(probe) - offset;
+    if ((perJoint == 0)
+        || (numberOfScalars < offset)
+        || ((numberOfScalars - offset) % perJoint != 0)) {
+        return false;
+    }
+    mNumberOfJoints = (numberOfScalars - offset) / perJoint;
+
+    // unique value for each element so we can find where each scalar goes
+    const size_t n = mNumberOfJoints;
+    probe.Position().SetSize(n);
+    probe.Velocity().SetSize(n);
+    probe.Effort().SetSize(n);
+    for (size_t index = 0; index < n; ++index) {
+        probe.Position().at(index) = static_cast<double>(1 + index);
+        probe.Velocity().at(index) = static_cast<double>(1 + n + index);
+        probe.Effort().at(index) = static_cast<double>(1 + 2 * n + index);
+    }
+    probe.SetValid(false);
+    mtsIntuitiveResearchKitRecorder::RecordedScalars(probe, indices, names);
+    if (indices.size() != numberOfScalars) {
+        return false;
+    }
+    mTargets.assign(numberOfScalars, -1);
+    for (size_t scalar = 0; scalar < numberOfScalars; ++scalar) {
+        const double value = probe.Scalar(indices[scalar]);
+        if ((value >= 1.0) && (value <= static_cast<double>(3 * n))) {
+            mTargets[scalar] = static_cast<int>(value) - 1;
+        }
+    }
+    return true;
+}
+
+void mtsIntuitiveResearchKitReplay::StateJointLayout::Fill(const double * values, prmStateJoint & state) const
+{
+    const size_t n = mNumberOfJoints;
+    state.Position().SetSize(n);
+    state.Velocity().SetSize(n);
+    state.Effort().SetSize(n);
+    for (size_t scalar = 0; scalar < mTargets.size(); ++scalar) {
+        const int target = mTargets[scalar];
+        if (target < 0) {
+            continue;
+        }
+        const size_t index = target % n;
+        switch (target / n) {
+        case 0:
+            state.Position().at(index) = values[scalar];
+            break;
+        case 1:
+            state.Velocity().at(index) = values[scalar];
+            break;
+        default:
+            state.Effort().at(index) = values[scalar];
+            break;
+        }
+    }
+    state.SetValid(true);
+}
+
+void mtsIntuitiveResearchKitReplay::Button::AddInterface(mtsIntuitiveResearchKitReplay * replay,
+                                                         const std::string & name)
+{
+    mName = name;
+    mtsInterfaceProvided * interfaceProvided = replay->AddInterfaceProvided(name);
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandRead(&Button::GetButton, this, "GetButton");
+        interfaceProvided->AddEventWrite(mEvent, "Button", prmEventButton());
+    }
+}
+
+void mtsIntuitiveResearchKitReplay::Button::Update(const double time)
+{
+    const double * values = mTrack.Seek(time);
+    if (!values || (mTrack.NumberOfScalars() == 0)) {
+        return;
+    }
+    const bool pressed = (values[mTrack.NumberOfScalars() - 1] != 0.0);
+    if (pressed != mPressed) {
+        mPressed = pressed;
+        prmEventButton event;
+        event.SetType(pressed ? prmEventButton::PRESSED : prmEventButton::RELEASED);
+        event.SetTimestamp(mTrack.Time());
+        mEvent(event);
+    }
+}
+
+void mtsIntuitiveResearchKitReplay::Button::GetButton(bool & pressed) const
+{
+    pressed = mPressed;
+}
+
+mtsIntuitiveResearchKitReplay::Arm::Arm(mtsIntuitiveResearchKitReplay * replay, const std::string & name):
+    mReplay(replay),
+    mName(name),
+    m_comparison(4, 0.0)
+{
+}
+
+bool mtsIntuitiveResearchKitReplay::Arm::Open(const mtsIntuitiveResearchKitRecordReader & reader,
+                                              const std::string & ioPrefix)
+{
+    const double window = mtsIntuitiveResearchKit::Replay::Window;
+    const std::string pidPrefix = mName + "-PID/Controller/";
+    if (!mMeasured.Open(reader, pidPrefix + "measured_js", window)) {
+        CMN_LOG_INIT_ERROR << "mtsIntuitiveResearchKitReplay::Arm::Open: " << mName
+                           << ", " << mMeasured.LastError() << std::endl;
+        return false;
+    }
+    if (!mMeasuredLayout.Configure(mMeasured.NumberOfScalars())) {
+        CMN_LOG_INIT_ERROR << "mtsIntuitiveResearchKitReplay::Arm::Open: " << mName
+                           << ", recorded measured_js doesn't match prmStateJoint" << std::endl;
+        return false;
+    }
+    const size_t numberOfJoints = mMeasuredLayout.NumberOfJoints();
+    m_measured_js.Position().SetSize(numberOfJoints);
+    m_measured_js.Position().SetAll(0.0);
+    m_measured_js.Velocity().SetSize(numberOfJoints);
+    m_measured_js.Velocity().SetAll(0.0);
+    m_measured_js.Effort().SetSize(numberOfJoints);
+    m_measured_js.Effort().SetAll(0.0);
+    m_setpoint_js = m_measured_js;
+
+    // setpoints are optional but needed for comparison
+    if (!mSetpoint.Open(reader, pidPrefix + "setpoint_js", window)
+        || !mSetpointLayout.Configure(mSetpoint.NumberOfScalars())) {
+        CMN_LOG_INIT_WARNING << "mtsIntuitiveResearchKitReplay::Arm::Open: " << mName
+                             << ", can't use recorded setpoint_js, setpoints will not be compared" << std::endl;
+        mSetpoint = mtsIntuitiveResearchKitReplayTrack();
+    }
+
+    // all powered unless recorded
+    m_actuator_amp_status.SetSize(numberOfJoints);
+    m_actuator_amp_status.SetAll(true);
+    m_brake_amp_status.SetSize(numberOfJoints);
+    m_brake_amp_status.SetAll(true);
+    mActuatorAmpStatus.Open(reader, ioPrefix + mName + "/GetActuatorAmpStatus", window);
+    mBrakeAmpStatus.Open(reader, ioPrefix + mName + "/GetBrakeAmpStatus", window);
+
+    // MTM gripper
+    m_gripper_measured_js.Position().SetSize(1);
+    m_gripper_measured_js.Position().SetAll(0.0);
+    if (mGripper.Open(reader, ioPrefix + mName + "-Gripper/GetAnalogInputPosSI", window)
+        && !mGripperLayout.Configure(mGripper.NumberOfScalars())) {
+        mGripper = mtsIntuitiveResearchKitReplayTrack();
+    }
+
+    // no limits, recorded positions were already checked by the PID
+    m_configuration_js.Name().SetSize(numberOfJoints);
+    m_configuration_js.PositionMin().SetSize(numberOfJoints);
+    m_configuration_js.PositionMin().SetAll(std::numeric_limits<double>::lowest());
+    m_configuration_js.PositionMax().SetSize(numberOfJoints);
+    m_configuration_js.PositionMax().SetAll(std::numeric_limits<double>::max());
+    return true;
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::AddInterfaces(void)
+{
+    // same interfaces as sawControllersPID
+    mtsInterfaceProvided * interfaceProvided = mReplay->AddInterfaceProvided(mName + "-Controller");
+    if (interfaceProvided) {
+        interfaceProvided->AddMessageEvents();
+        interfaceProvided->AddCommandRead(&Arm::measured_js, this, "measured_js", m_measured_js);
+        interfaceProvided->AddCommandRead(&Arm::setpoint_js, this, "setpoint_js", m_setpoint_js);
+        interfaceProvided->AddCommandRead(&Arm::configuration_js, this, "configuration_js", m_configuration_js);
+        interfaceProvided->AddCommandWrite(&Arm::configure_js, this, "configure_js", m_configuration_js);
+        interfaceProvided->AddCommandRead(&Arm::Enabled, this, "Enabled");
+        interfaceProvided->AddCommandWrite(&Arm::Enable, this, "Enable");
+        interfaceProvided->AddCommandWrite(&Arm::EnableJoints, this, "EnableJoints");
+        interfaceProvided->AddCommandWrite(&Arm::SetCoupling, this, "SetCoupling");
+        interfaceProvided->AddCommandWrite(&Arm::servo_jp, this, "servo_jp");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<prmForceTorqueJointSet>, this, "feed_forward_jf");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<prmForceTorqueJointSet>, this, "servo_jf");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<bool>, this, "SetCheckPositionLimit");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<vctBoolVec>, this, "EnableTorqueMode");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<bool>, this, "EnableTrackingError");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<vctDoubleVec>, this, "SetTrackingErrorTolerances");
+        interfaceProvided->AddEventWrite(mCouplingEvent, "Coupling", prmActuatorJointCoupling());
+        interfaceProvided->AddEventWrite(mEnabledJointsEvent, "EnabledJoints", vctBoolVec());
+        interfaceProvided->AddEventWrite(mPositionLimitEvent, "PositionLimit", vctBoolVec());
+    }
+
+    // same interfaces as sawRobotIO1394
+    interfaceProvided = mReplay->AddInterfaceProvided(mName);
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandRead(&Arm::GetSerialNumber, this, "GetSerialNumber");
+        interfaceProvided->AddCommandRead(&Arm::GetActuatorAmpStatus, this, "GetActuatorAmpStatus",
+                                          m_actuator_amp_status);
+        interfaceProvided->AddCommandRead(&Arm::GetBrakeAmpStatus, this, "GetBrakeAmpStatus",
+                                          m_brake_amp_status);
+        interfaceProvided->AddCommandWrite(&Arm::BiasEncoder, this, "BiasEncoder");
+        interfaceProvided->AddCommandVoid(&Arm::IgnoreVoid, this, "PowerOnSequence");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<bool>, this, "PowerOffSequence");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<vctDoubleVec>, this, "SetEncoderPosition");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<prmMaskedDoubleVec>, this, "SetSomeEncoderPosition");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<vctDoubleVec>, this, "SetActuatorCurrent");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<bool>, this, "UsePotsForSafetyCheck");
+        interfaceProvided->AddCommandVoid(&Arm::IgnoreVoid, this, "BrakeRelease");
+        interfaceProvided->AddCommandVoid(&Arm::IgnoreVoid, this, "BrakeEngage");
+        interfaceProvided->AddEventWrite(mBiasEncoderEvent, "BiasEncoder", 0);
+    }
+    interfaceProvided = mReplay->AddInterfaceProvided(mName + "-Gripper");
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandRead(&Arm::GetAnalogInputPosSI, this, "GetAnalogInputPosSI",
+                                          m_gripper_measured_js);
+    }
+    interfaceProvided = mReplay->AddInterfaceProvided(mName + "-Dallas");
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandVoid(&Arm::TriggerRead, this, "TriggerRead");
+        interfaceProvided->AddEventWrite(mToolTypeEvent, "ToolType", std::string());
+    }
+    mReplay->AddButton(mName + "-Adapter");
+    mReplay->AddButton(mName + "-Tool");
+    mReplay->AddButton(mName + "-ManipClutch");
+    mReplay->AddButton(mName + "-SUJClutch");
+
+    // comparison statistics
+    mReplay->StateTable.AddData(m_comparison, mName + "/comparison");
+    mReplay->mInterface->AddCommandReadState(mReplay->StateTable, m_comparison, mName + "/GetComparison");
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::Update(const double time)
+{
+    const double * values = mMeasured.Seek(time);
+    if (values) {
+        mMeasuredLayout.Fill(values, m_measured_js);
+        m_measured_js.SetTimestamp(mMeasured.Time());
+    }
+    values = mSetpoint.Seek(time);
+    if (values) {
+        mSetpointLayout.Fill(values, m_setpoint_js);
+        m_setpoint_js.SetTimestamp(mSetpoint.Time());
+    }
+    values = mActuatorAmpStatus.Seek(time);
+    if (values) {
+        FillBoolVec(values, mActuatorAmpStatus.NumberOfScalars(), m_actuator_amp_status);
+    }
+    values = mBrakeAmpStatus.Seek(time);
+    if (values) {
+        FillBoolVec(values, mBrakeAmpStatus.NumberOfScalars(), m_brake_amp_status);
+    }
+    values = mGripper.Seek(time);
+    if (values) {
+        mGripperLayout.Fill(values, m_gripper_measured_js);
+        m_gripper_measured_js.SetTimestamp(mGripper.Time());
+    }
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::Compare(void)
+{
+    if (!mServoNew || !mSetpoint.IsOpen()) {
+        return;
+    }
+    mServoNew = false;
+    const size_t size = std::min(m_servo_jp.Goal().size(), m_setpoint_js.Position().size());
+    if (!mComparison.Add(m_setpoint_js.Position().Pointer(), m_servo_jp.Goal().Pointer(), size)
+        && (mComparison.NumberOfMismatches() == 1)) {
+        // only log first mismatch, see statistics for all
+        CMN_LOG_RUN_WARNING << "mtsIntuitiveResearchKitReplay::Arm::Compare: " << mName
+                            << ", first setpoint mismatch at " << m_setpoint_js.Timestamp()
+                            << "\n - recorded: " << m_setpoint_js.Position()
+                            << "\n - replayed: " << m_servo_jp.Goal() << std::endl;
+    }
+    m_comparison.at(0) = static_cast<double>(mComparison.NumberOfSamples());
+    m_comparison.at(1) = static_cast<double>(mComparison.NumberOfMismatches());
+    m_comparison.at(2) = mComparison.MaximumError();
+    m_comparison.at(3) = mComparison.RMSError();
+}
+
+std::string mtsIntuitiveResearchKitReplay::Arm::Summary(void) const
+{
+    std::stringstream summary;
+    summary << mName << ": " << mComparison.NumberOfSamples() << " setpoints compared, "
+            << mComparison.NumberOfMismatches() << " mismatches, maximum error "
+            << mComparison.MaximumError() << ", RMS error " << mComparison.RMSError();
+    return summary.str();
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::measured_js(prmStateJoint & state) const
+{
+    state = m_measured_js;
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::setpoint_js(prmStateJoint & state) const
+{
+    state = m_setpoint_js;
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::configuration_js(prmConfigurationJoint & configuration) const
+{
+    configuration = m_configuration_js;
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::configure_js(const prmConfigurationJoint & configuration)
+{
+    m_configuration_js = configuration;
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::Enabled(bool & enabled) const
+{
+    enabled = mEnabled;
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::Enable(const bool & enable)
+{
+    mEnabled = enable;
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::EnableJoints(const vctBoolVec & enable)
+{
+    mEnabledJointsEvent(enable);
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::SetCoupling(const prmActuatorJointCoupling & coupling)
+{
+    // recorded joint values already use the coupling, only acknowledge
+    mCouplingEvent(coupling);
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::servo_jp(const prmPositionJointSet & position)
+{
+    m_servo_jp = position;
+    mServoNew = true;
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::GetSerialNumber(std::string & serial) const
+{
+    serial = mReplay->GetName();
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::GetActuatorAmpStatus(vctBoolVec & status) const
+{
+    status.ForceAssign(m_actuator_amp_status);
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::GetBrakeAmpStatus(vctBoolVec & status) const
+{
+    status.ForceAssign(m_brake_amp_status);
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::BiasEncoder(const int & CMN_UNUSED(nbSamples))
+{
+    // recorded positions are already biased, same as encoders preloaded
+    mBiasEncoderEvent(-1);
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::GetAnalogInputPosSI(prmStateJoint & state) const
+{
+    state = m_gripper_measured_js;
+}
+
+void mtsIntuitiveResearchKitReplay::Arm::TriggerRead(void)
+{
+    if (!mToolType.empty()) {
+        mToolTypeEvent(mToolType);
+    }
+}
+
+mtsIntuitiveResearchKitReplay::mtsIntuitiveResearchKitReplay(const std::string & componentName):
+    mtsTaskContinuous(componentName),
+    mStep(mtsIntuitiveResearchKit::IOPeriod),
+    mRate(mtsIntuitiveResearchKit::Replay::Rate),
+    mTolerance(mtsIntuitiveResearchKit::Replay::Tolerance),
+    mStartTime(std::numeric_limits<double>::max()),
+    mEndTime(std::numeric_limits<double>::lowest()),
+    mWallStartTime(0.0),
+    m_time(0.0),
+    mNumberOfSteps(0),
+    mFinished(false)
+{
+    StateTable.AddData(m_time, "time");
+    StateTable.AddData(mNumberOfSteps, "NumberOfSteps");
+    StateTable.AddData(mFinished, "Finished");
+
+    mInterface = AddInterfaceProvided("Replay");
+    if (mInterface) {
+        mInterface->AddMessageEvents();
+        mInterface->AddCommandReadState(StateTable, StateTable.PeriodStats, "period_statistics");
+        mInterface->AddCommandReadState(StateTable, m_time, "GetTime");
+        mInterface->AddCommandReadState(StateTable, mNumberOfSteps, "GetNumberOfSteps");
+        mInterface->AddCommandReadState(StateTable, mFinished, "GetFinished");
+    }
+}
+
+mtsIntuitiveResearchKitReplay::~mtsIntuitiveResearchKitReplay()
+{
+    for (auto & arm : mArms) {
+        delete arm.second;
+    }
+    for (auto & button : mButtons) {
+        delete button.second;
+    }
+}
+
+bool mtsIntuitiveResearchKitReplay::Load(const std::string & fileName,
+                                         const std::string & ioComponentName)
+{
+    if (!mReader.Open(fileName)) {
+        CMN_LOG_CLASS_INIT_ERROR << "Load " << this->GetName() << ": " << mReader.LastError() << std::endl;
+        return false;
+    }
+    if (!mReader.IsIndexed()) {
+        CMN_LOG_CLASS_INIT_WARNING << "Load " << this->GetName() << ": \"" << fileName
+                                   << "\" was not closed properly, using all complete records" << std::endl;
+    }
+    mIOComponentName = ioComponentName;
+
+    // all recorded buttons, e.g. foot pedals
+    const std::string prefix = mIOComponentName + "/";
+    const std::string suffix = "/GetButton";
+    for (size_t signal = 0; signal < mReader.NumberOfSignals(); ++signal) {
+        const std::string & name = mReader.Signal(signal).Name;
+        if ((name.size() > prefix.size() + suffix.size())
+            && (name.compare(0, prefix.size(), prefix) == 0)
+            && (name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)) {
+            AddButton(name.substr(prefix.size(), name.size() - prefix.size() - suffix.size()));
+        }
+    }
+    return true;
+}
+
+mtsIntuitiveResearchKitReplay::Button * mtsIntuitiveResearchKitReplay::AddButton(const std::string & name)
+{
+    auto iter = mButtons.find(name);
+    if (iter != mButtons.end()) {
+        return iter->second;
+    }
+    Button * button = new Button;
+    button->AddInterface(this, name);
+    // not all buttons are recorded, these are never pressed
+    button->mTrack.Open(mReader, mIOComponentName + "/" + name + "/GetButton",
+                        mtsIntuitiveResearchKit::Replay::Window);
+    mButtons[name] = button;
+    return button;
+}
+
+bool mtsIntuitiveResearchKitReplay::AddArm(const std::string & name, const std::string & toolType)
+{
+    if (mArms.find(name) != mArms.end()) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddArm " << this->GetName() << ": arm \"" << name
+                                 << "\" already exists" << std::endl;
+        return false;
+    }
+    Arm * arm = new Arm(this, name);
+    arm->mToolType = toolType;
+    if (!arm->Open(mReader, mIOComponentName + "/")) {
+        delete arm;
+        return false;
+    }
+    arm->mComparison.Reset(mTolerance);
+    arm->AddInterfaces();
+    mArms[name] = arm;
+    mStartTime = std::min(mStartTime, arm->mMeasured.StartTime());
+    mEndTime = std::max(mEndTime, arm->mMeasured.EndTime());
+    // components using the clock might read it before the first step
+    mClock.Reset(mStep, mStartTime - mStep);
+    return true;
+}
+
+void mtsIntuitiveResearchKitReplay::SetStep(const double step)
+{
+    if (step > 0.0) {
+        mStep = step;
+    }
+}
+
+void mtsIntuitiveResearchKitReplay::SetRate(const double rate)
+{
+    mRate = std::max(rate, 0.0);
+}
+
+void mtsIntuitiveResearchKitReplay::SetTolerance(const double tolerance)
+{
+    mTolerance = tolerance;
+    for (auto & arm : mArms) {
+        arm.second->mComparison.Reset(mTolerance);
+    }
+}
+
+void mtsIntuitiveResearchKitReplay::Startup(void)
+{
+    if (mArms.empty()) {
+        CMN_LOG_CLASS_INIT_WARNING << "Startup " << this->GetName() << ": no arm to replay" << std::endl;
+        mFinished = true;
+        return;
+    }
+    CMN_LOG_CLASS_INIT_VERBOSE << "Startup " << this->GetName() << ": replaying from "
+                               << mStartTime << " to " << mEndTime << ", "
+                               << (mEndTime - mStartTime) / mStep << " steps" << std::endl;
+    // first step is at start time
+    mClock.Reset(mStep, mStartTime - mStep);
+    m_time = mClock.Time();
+    mWallStartTime = osaGetTime();
+}
+
+void mtsIntuitiveResearchKitReplay::Run(void)
+{
+    // commands sent by the arms during the previous step
+    ProcessQueuedCommands();
+
+    if (!mFinished) {
+        mClock.Advance();
+        m_time = mClock.Time();
+        for (auto & arm : mArms) {
+            arm.second->Update(m_time);
+        }
+        for (auto & button : mButtons) {
+            button.second->Update(m_time);
+        }
+        for (auto & arm : mArms) {
+            arm.second->Compare();
+        }
+        mNumberOfSteps++;
+        if (m_time >= mEndTime) {
+            mFinished = true;
+            std::stringstream message;
+            message << this->GetName() << ": replay finished after " << mNumberOfSteps << " steps";
+            mInterface->SendStatus(message.str());
+            for (const auto & arm : mArms) {
+                mInterface->SendStatus(this->GetName() + ": " + arm.second->Summary());
+            }
+        }
+    }
+
+    // arms and tele-operation components run now
+    RunEvent();
+
+    if (mFinished) {
+        // keep components running with last samples
+        osaSleep(mStep);
+    } else if (mRate > 0.0) {
+        const double ahead = mWallStartTime + (m_time - mStartTime) / mRate - osaGetTime();
+        if (ahead > 0.0) {
+            osaSleep(ahead);
+        }
+    }
+}
+
+void mtsIntuitiveResearchKitReplay::Cleanup(void)
+{
+    for (const auto & arm : mArms) {
+        CMN_LOG_CLASS_INIT_VERBOSE << "Cleanup " << this->GetName() << ": " << arm.second->Summary() << std::endl;
+    }
+}
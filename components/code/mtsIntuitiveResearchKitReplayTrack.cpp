@@ -0,0 +1,157 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-12
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitReplayTrack.h>
+
+mtsIntuitiveResearchKitReplayTrack::mtsIntuitiveResearchKitReplayTrack(void):
+    mReader(nullptr),
+    mSignal(0),
+    mWindow(1.0),
+    mStartTime(0.0),
+    mEndTime(0.0),
+    mLoadedUntil(0.0),
+    mLoaded(false),
+    mNext(0),
+    mCurrentTime(0.0),
+    mValid(false)
+{
+}
+
+bool mtsIntuitiveResearchKitReplayTrack::Open(const mtsIntuitiveResearchKitRecordReader & reader,
+                                              const std::string & name,
+                                              const double window)
+{
+    mReader = nullptr;
+    const int signal = reader.FindSignal(name);
+    if (signal < 0) {
+        mLastError = "signal \"" + name + "\" not found";
+        return false;
+    }
+    if (!reader.TimeRange(signal, mStartTime, mEndTime)) {
+        mLastError = "signal \"" + name + "\" has no sample";
+        return false;
+    }
+    mReader = &reader;
+    mSignal = signal;
+    mWindow = (window > 0.0) ? window : 1.0;
+    mLoaded = false;
+    mTimes.clear();
+    mValues.clear();
+    mNext = 0;
+    mCurrent.assign(reader.Signal(signal).ScalarNames.size(), 0.0);
+    mCurrentTime = 0.0;
+    mValid = false;
+    return true;
+}
+
+bool mtsIntuitiveResearchKitReplayTrack::Load(const double time)
+{
+    // window starts where the previous one ended, that sample has
+    // already been read so it is removed
+    const double start = mLoaded ? mLoadedUntil : mStartTime;
+    const double end = std::max(start, time) + mWindow;
+    if (mReader->Read(mSignal, start, end, mTimes, mValues) < 0) {
+        mLastError = mReader->LastError();
+        return false;
+    }
+    mNext = 0;
+    if (mLoaded) {
+        while ((mNext < mTimes.size()) && (mTimes[mNext] <= mLoadedUntil)) {
+            ++mNext;
+        }
+    }
+    mLoaded = true;
+    mLoadedUntil = end;
+    return true;
+}
+
+const double * mtsIntuitiveResearchKitReplayTrack::Seek(const double time)
+{
+    if (!mReader) {
+        return nullptr;
+    }
+    const size_t numberOfScalars = mCurrent.size();
+    while (true) {
+        // consume all samples in window up to time
+        while ((mNext < mTimes.size()) && (mTimes[mNext] <= time)) {
+            mCurrentTime = mTimes[mNext];
+            std::copy(mValues.begin() + mNext * numberOfScalars,
+                      mValues.begin() + (mNext + 1) * numberOfScalars,
+                      mCurrent.begin());
+            mValid = true;
+            ++mNext;
+        }
+        // next sample is after time or there's nothing left to load
+        if ((mNext < mTimes.size())
+            || (mLoaded && (mLoadedUntil >= mEndTime))
+            || (mLoaded && (mLoadedUntil > time))) {
+            break;
+        }
+        if (!Load(time)) {
+            mValid = false;
+            mReader = nullptr;
+            return nullptr;
+        }
+    }
+    return mValid ? mCurrent.data() : nullptr;
+}
+
+mtsIntuitiveResearchKitReplayComparison::mtsIntuitiveResearchKitReplayComparison(void)
+{
+    Reset(0.0);
+}
+
+void mtsIntuitiveResearchKitReplayComparison::Reset(const double tolerance)
+{
+    mTolerance = tolerance;
+    mNumberOfSamples = 0;
+    mNumberOfMismatches = 0;
+    mNumberOfValues = 0;
+    mMaximumError = 0.0;
+    mSumSquares = 0.0;
+}
+
+bool mtsIntuitiveResearchKitReplayComparison::Add(const double * expected, const double * produced,
+                                                  const size_t size)
+{
+    double sampleError = 0.0;
+    for (size_t index = 0; index < size; ++index) {
+        const double error = std::fabs(produced[index] - expected[index]);
+        sampleError = std::max(sampleError, error);
+        mSumSquares += error * error;
+    }
+    mNumberOfValues += size;
+    mNumberOfSamples++;
+    mMaximumError = std::max(mMaximumError, sampleError);
+    if (sampleError > mTolerance) {
+        mNumberOfMismatches++;
+        return false;
+    }
+    return true;
+}
+
+double mtsIntuitiveResearchKitReplayComparison::RMSError(void) const
+{
+    if (mNumberOfValues == 0) {
+        return 0.0;
+    }
+    return std::sqrt(mSumSquares / static_cast<double>(mNumberOfValues));
+}
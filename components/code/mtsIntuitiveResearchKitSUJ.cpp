@@ -23,6 +23,7 @@ http://www.cisst.org/cisst/license.txt.
 // cisst
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitSUJ.h>
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLog.h>
 #include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstMultiTask/mtsInterfaceRequired.h>
 #include <cisstParameterTypes/prmStateJoint.h>
@@ -728,7 +729,7 @@ void mtsIntuitiveResearchKitSUJ::RunAllStates(void)
 
 void mtsIntuitiveResearchKitSUJ::ResetMux(void)
 {
-    mMuxTimer = this->StateTable.GetTic();
+    mMuxTimer = Now();
     MuxIncrement.SetValue(false);
     NoMuxReset.SetValue(false);
     Sleep(30.0 * cmn_ms);
@@ -771,7 +772,7 @@ void mtsIntuitiveResearchKitSUJ::EnterPowering(void)
         return;
     }
 
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
     mHomingTimer = currentTime;
     // pre-load the boards with zero current
     RobotIO.SetActuatorCurrent(vctDoubleVec(4, 0.0));
@@ -788,7 +789,7 @@ void mtsIntuitiveResearchKitSUJ::TransitionPowering(void)
         return;
     }
 
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     // check status
     if ((currentTime - mHomingTimer) > mtsIntuitiveResearchKit::TimeToPower) {
@@ -849,6 +850,8 @@ void mtsIntuitiveResearchKitSUJ::TransitionEnabled(void)
 
 void mtsIntuitiveResearchKitSUJ::Startup(void)
 {
+    // allocate log queue now, not in first error
+    mtsIntuitiveResearchKitLog::RegisterThread();
     SetDesiredState("DISABLED");
 }
 
@@ -969,7 +972,7 @@ void mtsIntuitiveResearchKitSUJ::GetRobotData(void)
     const double muxCycle = 30.0 * cmn_ms;
 
     // we can start reporting some joint values after the robot is powered
-    const double currentTime = this->StateTable.GetTic();
+    const double currentTime = Now();
 
     // we assume the analog in is now stable
     if (currentTime > mMuxTimer) {
@@ -1003,7 +1006,8 @@ void mtsIntuitiveResearchKitSUJ::GetAndConvertPotentiometerValues(void)
     mMuxIndex = (mMuxState[0]?1:0) + (mMuxState[1]?2:0) + (mMuxState[2]?4:0) + (mMuxState[3]?8:0);
     if (mMuxIndex != mMuxIndexExpected) {
         DispatchWarning(this->GetName() + ": unexpected multiplexer value.");
-        CMN_LOG_CLASS_RUN_ERROR << "GetAndConvertPotentiometerValues: mux from IO board, actual: " << mMuxIndex << ", expected: " << mMuxIndexExpected << std::endl;
+        mtsIntuitiveResearchKitLog::Error(GetName(), "GetAndConvertPotentiometerValues: mux from IO board, actual and expected",
+                                          {static_cast<double>(mMuxIndex), static_cast<double>(mMuxIndexExpected)});
         ResetMux();
         SetHomed(false);
         return;
@@ -1213,7 +1217,7 @@ void mtsIntuitiveResearchKitSUJ::state_command(const std::string & command)
 void mtsIntuitiveResearchKitSUJ::RunEnabled(void)
 {
     if (m_simulated) {
-        const double currentTime = this->StateTable.GetTic();
+        const double currentTime = Now();
         if (currentTime - mSimulatedTimer > 1.0 * cmn_s) {
             mSimulatedTimer = currentTime;
             for (size_t armIndex = 0; armIndex < 4; ++armIndex) {
@@ -1246,7 +1250,7 @@ void mtsIntuitiveResearchKitSUJ::RunEnabled(void)
         return;
     }
 
-    double currentTic = this->StateTable.GetTic();
+    double currentTic = Now();
     const double timeDelta = currentTic - mPreviousTic;
 
     const double brakeCurrentRate = 8.0; // rate = 8 A/s, about 1/4 second to get up/down
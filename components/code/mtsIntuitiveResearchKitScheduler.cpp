@@ -0,0 +1,152 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-14
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <sstream>
+
+#include <cisstOSAbstraction/osaGetTime.h>
+#include <cisstOSAbstraction/osaSleep.h>
+#include <cisstMultiTask/mtsInterfaceProvided.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitScheduler.h>
+
+CMN_IMPLEMENT_SERVICES_DERIVED(mtsIntuitiveResearchKitScheduler, mtsTaskContinuous)
+
+mtsIntuitiveResearchKitScheduler::mtsIntuitiveResearchKitScheduler(const std::string & componentName,
+                                                                   const double step):
+    mtsTaskContinuous(componentName),
+    mRate(mtsIntuitiveResearchKit::Scheduler::Rate),
+    mPaused(false),
+    mStepsRemaining(0),
+    mWallReference(0.0),
+    mTimeReference(0.0),
+    m_time(0.0)
+{
+    mClock.Reset((step > 0.0) ? step : mtsIntuitiveResearchKit::Scheduler::Step);
+
+    StateTable.AddData(m_time, "time");
+    StateTable.AddData(mPaused, "Paused");
+
+    mInterface = AddInterfaceProvided("Scheduler");
+    if (mInterface) {
+        mInterface->AddMessageEvents();
+        mInterface->AddCommandReadState(StateTable, StateTable.PeriodStats, "period_statistics");
+        mInterface->AddCommandReadState(StateTable, m_time, "GetTime");
+        mInterface->AddCommandReadState(StateTable, mPaused, "GetPaused");
+        mInterface->AddCommandVoid(&mtsIntuitiveResearchKitScheduler::Pause, this, "Pause");
+        mInterface->AddCommandVoid(&mtsIntuitiveResearchKitScheduler::Resume, this, "Resume");
+        mInterface->AddCommandWrite(&mtsIntuitiveResearchKitScheduler::RunFor, this, "RunFor");
+        mInterface->AddCommandWrite(&mtsIntuitiveResearchKitScheduler::SetRate, this, "SetRate");
+        mInterface->AddEventWrite(mPausedEvent, "Paused", false);
+    }
+}
+
+void mtsIntuitiveResearchKitScheduler::SetRate(const double & rate)
+{
+    mRate = std::max(rate, 0.0);
+    ResetRateReference();
+}
+
+void mtsIntuitiveResearchKitScheduler::SetPaused(const bool paused)
+{
+    mPaused = paused;
+}
+
+void mtsIntuitiveResearchKitScheduler::ResetRateReference(void)
+{
+    mWallReference = osaGetTime();
+    mTimeReference = mClock.Time();
+}
+
+void mtsIntuitiveResearchKitScheduler::Pause(void)
+{
+    mStepsRemaining = 0;
+    if (!mPaused) {
+        mPaused = true;
+        std::stringstream message;
+        message << this->GetName() << ": paused at " << mClock.Time() << "s";
+        mInterface->SendStatus(message.str());
+        mPausedEvent(true);
+    }
+}
+
+void mtsIntuitiveResearchKitScheduler::Resume(void)
+{
+    mStepsRemaining = 0;
+    if (mPaused) {
+        mPaused = false;
+        ResetRateReference();
+        mPausedEvent(false);
+    }
+}
+
+void mtsIntuitiveResearchKitScheduler::RunFor(const double & duration)
+{
+    const size_t steps = mClock.StepsFor(duration);
+    if (steps == 0) {
+        mInterface->SendWarning(this->GetName() + ": RunFor duration must be strictly positive");
+        return;
+    }
+    Resume();
+    mStepsRemaining = steps;
+}
+
+void mtsIntuitiveResearchKitScheduler::Startup(void)
+{
+    CMN_LOG_CLASS_INIT_VERBOSE << "Startup " << this->GetName() << ": step is "
+                               << mClock.Step() << "s, rate is " << mRate
+                               << (mPaused ? ", paused" : "") << std::endl;
+    ResetRateReference();
+}
+
+void mtsIntuitiveResearchKitScheduler::Run(void)
+{
+    // commands sent to pause or run for a given duration
+    ProcessQueuedCommands();
+
+    if (mPaused) {
+        osaSleep(mtsIntuitiveResearchKit::Scheduler::PausedSleep);
+        return;
+    }
+
+    mClock.Advance();
+    m_time = mClock.Time();
+
+    // all stepped components run now
+    RunEvent();
+
+    if ((mStepsRemaining > 0) && (--mStepsRemaining == 0)) {
+        Pause();
+        return;
+    }
+
+    if (mRate > 0.0) {
+        const double ahead = mWallReference + (mClock.Time() - mTimeReference) / mRate - osaGetTime();
+        if (ahead > 0.0) {
+            osaSleep(ahead);
+        }
+    }
+}
+
+void mtsIntuitiveResearchKitScheduler::Cleanup(void)
+{
+    CMN_LOG_CLASS_INIT_VERBOSE << "Cleanup " << this->GetName() << ": stopped at "
+                               << mClock.Time() << "s after "
+                               << mClock.NumberOfSteps() << " steps" << std::endl;
+}
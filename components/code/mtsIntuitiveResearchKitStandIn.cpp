@@ -0,0 +1,808 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-15
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include <cisstCommon/cmnPath.h>
+#include <cisstCommon/cmnXMLPath.h>
+#include <cisstMultiTask/mtsInterfaceProvided.h>
+#include <cisstNumerical/nmrPInverse.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitStandIn.h>
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitConfig.h>
+
+CMN_IMPLEMENT_SERVICES_DERIVED(mtsIntuitiveResearchKitStandIn, mtsTaskPeriodic)
+
+namespace {
+    // single value for all joints or array with one value per joint
+    bool JointValues(const Json::Value & jsonValue, vctDoubleVec & values) {
+        if (jsonValue.isNull()) {
+            return true;
+        }
+        if (jsonValue.isNumeric()) {
+            values.SetAll(jsonValue.asDouble());
+            return true;
+        }
+        if (jsonValue.isArray() && (jsonValue.size() == values.size())) {
+            for (unsigned int index = 0; index < jsonValue.size(); ++index) {
+                values.at(index) = jsonValue[index].asDouble();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // units used in sawControllersPID configuration files
+    double UnitScale(const std::string & units) {
+        if (units == "deg") {
+            return cmnPI_180;
+        }
+        if (units == "mm") {
+            return cmn_mm;
+        }
+        return 1.0;
+    }
+}
+
+void mtsIntuitiveResearchKitStandIn::Button::AddInterface(mtsIntuitiveResearchKitStandIn * standIn,
+                                                          const std::string & name,
+                                                          const bool pressed)
+{
+    mPressed = pressed;
+    mtsInterfaceProvided * interfaceProvided = standIn->AddInterfaceProvided(name);
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandRead(&Button::GetButton, this, "GetButton");
+        interfaceProvided->AddEventWrite(mEvent, "Button", prmEventButton());
+    }
+}
+
+void mtsIntuitiveResearchKitStandIn::Button::GetButton(bool & pressed) const
+{
+    pressed = mPressed;
+}
+
+mtsIntuitiveResearchKitStandIn::Arm::Arm(mtsIntuitiveResearchKitStandIn * standIn, const std::string & name):
+    mStandIn(standIn),
+    mName(name)
+{
+}
+
+bool mtsIntuitiveResearchKitStandIn::Arm::ConfigureModel(const std::string & armConfigurationFile)
+{
+    std::ifstream jsonStream;
+    Json::Value jsonConfig;
+    Json::Reader jsonReader;
+
+    // kinematic file name from arm configuration file
+    jsonStream.open(armConfigurationFile.c_str());
+    if (!jsonReader.parse(jsonStream, jsonConfig)) {
+        CMN_LOG_INIT_ERROR << "ConfigureModel " << mName
+                           << ": failed to parse arm configuration file \""
+                           << armConfigurationFile << "\"\n"
+                           << jsonReader.getFormattedErrorMessages();
+        return false;
+    }
+    const Json::Value jsonKinematic = jsonConfig["kinematic"];
+    if (jsonKinematic.isNull()) {
+        CMN_LOG_INIT_ERROR << "ConfigureModel " << mName
+                           << ": can't find \"kinematic\" in \""
+                           << armConfigurationFile << "\"" << std::endl;
+        return false;
+    }
+
+    // same search path as mtsIntuitiveResearchKitArm::Configure
+    cmnPath configPath(cmnPath::GetWorkingDirectory());
+    const std::string fullname = configPath.Find(armConfigurationFile);
+    configPath.Add(fullname.substr(0, fullname.find_last_of('/')), cmnPath::TAIL);
+    configPath.Add(std::string(sawIntuitiveResearchKit_SOURCE_DIR) + "/../share", cmnPath::TAIL);
+    const std::string kinematicFile = configPath.Find(jsonKinematic.asString());
+    if (kinematicFile == "") {
+        CMN_LOG_INIT_ERROR << "ConfigureModel " << mName
+                           << ": can't find kinematic file \""
+                           << jsonKinematic.asString() << "\"" << std::endl;
+        return false;
+    }
+
+    jsonStream.close();
+    jsonStream.clear();
+    jsonConfig.clear();
+    jsonStream.open(kinematicFile.c_str());
+    if (!jsonReader.parse(jsonStream, jsonConfig)) {
+        CMN_LOG_INIT_ERROR << "ConfigureModel " << mName
+                           << ": failed to parse kinematic file \""
+                           << kinematicFile << "\"\n"
+                           << jsonReader.getFormattedErrorMessages();
+        return false;
+    }
+    const Json::Value jsonDH = jsonConfig["DH"];
+    Json::Value jsonLinks = jsonDH["links"];
+    if (jsonLinks.isNull()) {
+        jsonLinks = jsonDH["joints"];
+    }
+    if (!jsonLinks.isArray()) {
+        CMN_LOG_INIT_ERROR << "ConfigureModel " << mName
+                           << ": can't find \"DH\" links in \""
+                           << kinematicFile << "\"" << std::endl;
+        return false;
+    }
+    const bool modified = (jsonDH.get("convention", "standard").asString() == "modified");
+
+    mLinks.clear();
+    for (unsigned int index = 0; index < jsonLinks.size(); ++index) {
+        const Json::Value jsonLink = jsonLinks[index];
+        mtsIntuitiveResearchKitDynamicModel::Link link;
+        link.Modified = modified;
+        link.Prismatic = (jsonLink["type"].asString() == "prismatic");
+        link.Alpha = jsonLink["alpha"].asDouble();
+        link.A = jsonLink["A"].asDouble();
+        link.Theta = jsonLink["theta"].asDouble();
+        link.D = jsonLink["D"].asDouble();
+        link.Offset = jsonLink["offset"].asDouble();
+        link.Mass = jsonLink["mass"].asDouble();
+        link.CenterOfMass[0] = jsonLink["cx"].asDouble();
+        link.CenterOfMass[1] = jsonLink["cy"].asDouble();
+        link.CenterOfMass[2] = jsonLink["cz"].asDouble();
+        // principal moments and axes, I = V diag(Ixx, Iyy, Izz) V^T
+        const double moments[3] = {jsonLink["Ixx"].asDouble(),
+                                   jsonLink["Iyy"].asDouble(),
+                                   jsonLink["Izz"].asDouble()};
+        const double axes[3][3] = {{jsonLink.get("x1", 1.0).asDouble(),
+                                    jsonLink.get("x2", 0.0).asDouble(),
+                                    jsonLink.get("x3", 0.0).asDouble()},
+                                   {jsonLink.get("y1", 0.0).asDouble(),
+                                    jsonLink.get("y2", 1.0).asDouble(),
+                                    jsonLink.get("y3", 0.0).asDouble()},
+                                   {jsonLink.get("z1", 0.0).asDouble(),
+                                    jsonLink.get("z2", 0.0).asDouble(),
+                                    jsonLink.get("z3", 1.0).asDouble()}};
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t col = 0; col < 3; ++col) {
+                double sum = 0.0;
+                for (size_t axis = 0; axis < 3; ++axis) {
+                    sum += axes[axis][row] * moments[axis] * axes[axis][col];
+                }
+                link.Inertia[3 * row + col] = sum;
+            }
+        }
+        mLinks.push_back(link);
+    }
+    return true;
+}
+
+bool mtsIntuitiveResearchKitStandIn::Arm::ConfigurePID(const std::string & pidConfigurationFile)
+{
+    cmnXMLPath xmlConfig;
+    xmlConfig.SetInputSource(pidConfigurationFile);
+
+    int numberOfJoints = 0;
+    if (!xmlConfig.GetXMLValue("/controller", "@numofjoints", numberOfJoints)
+        || (numberOfJoints <= 0)) {
+        CMN_LOG_INIT_ERROR << "ConfigurePID " << mName
+                           << ": can't find number of joints in \""
+                           << pidConfigurationFile << "\"" << std::endl;
+        return false;
+    }
+    const size_t n = static_cast<size_t>(numberOfJoints);
+    if (n < mLinks.size()) {
+        CMN_LOG_INIT_ERROR << "ConfigurePID " << mName
+                           << ": kinematic file has more joints (" << mLinks.size()
+                           << ") than PID configuration file (" << n << ")" << std::endl;
+        return false;
+    }
+    mNumberOfJoints = n;
+
+    mPGain.SetSize(n);
+    mDGain.SetSize(n);
+    mIGain.SetSize(n);
+    mOffset.SetSize(n);
+    mForget.SetSize(n);
+    mMinIError.SetSize(n);
+    mMaxIError.SetSize(n);
+    mTrackingErrorTolerances.SetSize(n);
+    mPrismatic.assign(n, false);
+    m_configuration_js.Name().SetSize(n);
+    m_configuration_js.Type().SetSize(n);
+    m_configuration_js.PositionMin().SetSize(n);
+    m_configuration_js.PositionMax().SetSize(n);
+
+    for (size_t index = 0; index < n; ++index) {
+        std::stringstream context;
+        context << "/controller/joints/joint[" << index + 1 << "]";
+        std::string name, type, units;
+        double lower = 0.0, upper = 0.0;
+        bool ok = true;
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "@name", name);
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "@type", type);
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "pid/@PGain", mPGain.at(index));
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "pid/@DGain", mDGain.at(index));
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "pid/@IGain", mIGain.at(index));
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "pid/@OffsetTorque", mOffset.at(index));
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "pid/@Forget", mForget.at(index));
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "limit/@MinILimit", mMinIError.at(index));
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "limit/@MaxILimit", mMaxIError.at(index));
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "limit/@ErrorLimit", mTrackingErrorTolerances.at(index));
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "pos/@LowerLimit", lower);
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "pos/@UpperLimit", upper);
+        ok &= xmlConfig.GetXMLValue(context.str().c_str(), "pos/@Units", units);
+        if (!ok) {
+            CMN_LOG_INIT_ERROR << "ConfigurePID " << mName
+                               << ": missing parameter for joint " << index << " in \""
+                               << pidConfigurationFile << "\"" << std::endl;
+            return false;
+        }
+        mPrismatic.at(index) = (type == "Prismatic");
+        if ((index < mLinks.size()) && (mPrismatic.at(index) != mLinks.at(index).Prismatic)) {
+            CMN_LOG_INIT_ERROR << "ConfigurePID " << mName
+                               << ": joint type for \"" << name
+                               << "\" doesn't match kinematic file" << std::endl;
+            return false;
+        }
+        m_configuration_js.Name().at(index) = name;
+        m_configuration_js.Type().at(index) = mPrismatic.at(index) ? PRM_JOINT_PRISMATIC : PRM_JOINT_REVOLUTE;
+        m_configuration_js.PositionMin().at(index) = lower * UnitScale(units);
+        m_configuration_js.PositionMax().at(index) = upper * UnitScale(units);
+    }
+
+    // PID state
+    mIError.SetSize(n);
+    mIError.SetAll(0.0);
+    mGoal.SetSize(n);
+    mGoal.SetAll(0.0);
+    mServoEffort.SetSize(n);
+    mServoEffort.SetAll(0.0);
+    mFeedForward.SetSize(n);
+    mFeedForward.SetAll(0.0);
+    mEffort.SetSize(n);
+    mEffort.SetAll(0.0);
+    mEnabledJoints.SetSize(n);
+    mEnabledJoints.SetAll(true);
+    mTorqueMode.SetSize(n);
+    mTorqueMode.SetAll(false);
+    mPositionLimitFlags.SetSize(n);
+    mPositionLimitFlags.SetAll(false);
+
+    // measured and setpoint
+    m_measured_js.Name().ForceAssign(m_configuration_js.Name());
+    m_measured_js.Position().SetSize(n);
+    m_measured_js.Velocity().SetSize(n);
+    m_measured_js.Effort().SetSize(n);
+    m_measured_js.Position().SetAll(0.0);
+    m_measured_js.Velocity().SetAll(0.0);
+    m_measured_js.Effort().SetAll(0.0);
+    m_setpoint_js = m_measured_js;
+
+    // IO, powered off
+    m_actuator_amp_status.SetSize(n);
+    m_actuator_amp_status.SetAll(false);
+    m_brake_amp_status.SetSize(n);
+    m_brake_amp_status.SetAll(false);
+    m_gripper_measured_js.Position().SetSize(1);
+    m_gripper_measured_js.Position().SetAll(0.0);
+
+    // identity coupling until the arm sets one
+    mActuatorToJointPosition.ForceAssign(vctDoubleMat::Eye(n));
+    mJointToActuatorEffort.ForceAssign(vctDoubleMat::Eye(n));
+    mActuatorToJointEffort.ForceAssign(vctDoubleMat::Eye(n));
+    mEncoderOffsets.SetSize(n);
+    mEncoderOffsets.SetAll(0.0);
+    mActuatorPosition.SetSize(n);
+    mActuatorVelocity.SetSize(n);
+    mActuatorRequest.SetSize(n);
+    mActuatorEffort.SetSize(n);
+    mActuatorEffort.SetAll(0.0);
+    mJointPosition.SetSize(n);
+    mJointVelocity.SetSize(n);
+    mActuators.SetSize(n);
+    return true;
+}
+
+bool mtsIntuitiveResearchKitStandIn::Arm::ConfigureDynamics(const Json::Value & jsonDynamics)
+{
+    const size_t n = mNumberOfJoints;
+
+    // armature critically damping the PID position loop by default
+    vctDoubleVec armature(n), viscous(n, 0.0), coulomb(n, 0.0), backlash(n, 0.0), position(n, 0.0),
+        timeConstant(n, 0.0), effortMax(n, std::numeric_limits<double>::max());
+    for (size_t index = 0; index < n; ++index) {
+        const double p = mPGain.at(index);
+        const double d = mDGain.at(index);
+        armature.at(index) = ((p > 0.0) && (d > 0.0)) ?
+            (d * d) / (4.0 * p) : mtsIntuitiveResearchKit::StandIn::Armature;
+    }
+
+    const char * names[] = {"armature", "viscous", "coulomb", "backlash", "position",
+                            "time-constant", "effort-max"};
+    vctDoubleVec * values[] = {&armature, &viscous, &coulomb, &backlash, &position,
+                               &timeConstant, &effortMax};
+    for (size_t index = 0; index < 7; ++index) {
+        if (!JointValues(jsonDynamics[names[index]], *(values[index]))) {
+            CMN_LOG_INIT_ERROR << "ConfigureDynamics " << mName
+                               << ": \"" << names[index] << "\" must be a number or an array of "
+                               << n << " numbers" << std::endl;
+            return false;
+        }
+    }
+
+    // massless links for joints not in kinematic file
+    mModel = mtsIntuitiveResearchKitDynamicModel();
+    for (size_t index = 0; index < n; ++index) {
+        mtsIntuitiveResearchKitDynamicModel::Link link;
+        if (index < mLinks.size()) {
+            link = mLinks.at(index);
+        } else {
+            link.Prismatic = mPrismatic.at(index);
+        }
+        mtsIntuitiveResearchKitDynamicModel::Joint joint;
+        joint.Armature = armature.at(index);
+        joint.Viscous = viscous.at(index);
+        joint.Coulomb = coulomb.at(index);
+        joint.Backlash = backlash.at(index);
+        joint.PositionMin = m_configuration_js.PositionMin().at(index);
+        joint.PositionMax = m_configuration_js.PositionMax().at(index);
+        if (joint.Armature <= 0.0) {
+            CMN_LOG_INIT_ERROR << "ConfigureDynamics " << mName
+                               << ": \"armature\" must be strictly positive" << std::endl;
+            return false;
+        }
+        mModel.AddLink(link, joint);
+        if (effortMax.at(index) <= 0.0) {
+            CMN_LOG_INIT_ERROR << "ConfigureDynamics " << mName
+                               << ": \"effort-max\" must be strictly positive" << std::endl;
+            return false;
+        }
+        mActuators.SetTimeConstant(index, timeConstant.at(index));
+        mActuators.SetEffortMaximum(index, effortMax.at(index));
+    }
+
+    const double latency = jsonDynamics.get("latency", 0.0).asDouble();
+    mTimeToPower = jsonDynamics.get("time-to-power",
+                                    mtsIntuitiveResearchKit::StandIn::TimeToPower).asDouble();
+    if ((latency < 0.0) || (mTimeToPower < 0.0)) {
+        CMN_LOG_INIT_ERROR << "ConfigureDynamics " << mName
+                           << ": \"latency\" and \"time-to-power\" can't be negative" << std::endl;
+        return false;
+    }
+    mActuators.SetLatency(latency);
+
+    const Json::Value jsonGravity = jsonDynamics["gravity"];
+    if (!jsonGravity.isNull()) {
+        if (!jsonGravity.isArray() || (jsonGravity.size() != 3)) {
+            CMN_LOG_INIT_ERROR << "ConfigureDynamics " << mName
+                               << ": \"gravity\" must be an array of 3 numbers" << std::endl;
+            return false;
+        }
+        mModel.SetGravity(jsonGravity[0].asDouble(),
+                          jsonGravity[1].asDouble(),
+                          jsonGravity[2].asDouble());
+    }
+
+    // initial position within stops
+    for (size_t index = 0; index < n; ++index) {
+        position.at(index) = std::max(m_configuration_js.PositionMin().at(index),
+                                      std::min(position.at(index),
+                                               m_configuration_js.PositionMax().at(index)));
+    }
+    mModel.Reset(position.Pointer());
+
+    // encoders read 0 at power up unless preloaded
+    mEncodersPreloaded = jsonDynamics.get("encoders-preloaded", false).asBool();
+    mEncodersBiased = mEncodersPreloaded;
+    if (!mEncodersPreloaded) {
+        mEncoderOffsets.Assign(position);
+        mEncoderOffsets.Multiply(-1.0);
+    }
+    mGoal.SumOf(position, mEncoderOffsets);
+    m_measured_js.Position().Assign(mGoal);
+    m_setpoint_js.Position().Assign(mGoal);
+
+    mToolType = jsonDynamics.get("tool", "").asString();
+    return true;
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::AddInterfaces(void)
+{
+    mtsStateTable & stateTable = mStandIn->StateTable;
+    stateTable.AddData(m_measured_js, mName + "-measured_js");
+    stateTable.AddData(m_setpoint_js, mName + "-setpoint_js");
+    stateTable.AddData(m_configuration_js, mName + "-configuration_js");
+    stateTable.AddData(mEnabled, mName + "-Enabled");
+    stateTable.AddData(m_actuator_amp_status, mName + "-ActuatorAmpStatus");
+    stateTable.AddData(m_brake_amp_status, mName + "-BrakeAmpStatus");
+    stateTable.AddData(m_gripper_measured_js, mName + "-Gripper");
+
+    // same interfaces as sawControllersPID
+    mPIDInterface = mStandIn->AddInterfaceProvided(mName + "-Controller");
+    if (mPIDInterface) {
+        mPIDInterface->AddMessageEvents();
+        mPIDInterface->AddCommandReadState(stateTable, m_measured_js, "measured_js");
+        mPIDInterface->AddCommandReadState(stateTable, m_setpoint_js, "setpoint_js");
+        mPIDInterface->AddCommandReadState(stateTable, m_configuration_js, "configuration_js");
+        mPIDInterface->AddCommandWrite(&Arm::configure_js, this, "configure_js", m_configuration_js);
+        mPIDInterface->AddCommandReadState(stateTable, mEnabled, "Enabled");
+        mPIDInterface->AddCommandWrite(&Arm::Enable, this, "Enable");
+        mPIDInterface->AddCommandWrite(&Arm::EnableJoints, this, "EnableJoints");
+        mPIDInterface->AddCommandWrite(&Arm::SetCoupling, this, "SetCoupling");
+        mPIDInterface->AddCommandWrite(&Arm::servo_jp, this, "servo_jp");
+        mPIDInterface->AddCommandWrite(&Arm::feed_forward_jf, this, "feed_forward_jf");
+        mPIDInterface->AddCommandWrite(&Arm::servo_jf, this, "servo_jf");
+        mPIDInterface->AddCommandWrite(&Arm::SetCheckPositionLimit, this, "SetCheckPositionLimit");
+        mPIDInterface->AddCommandWrite(&Arm::EnableTorqueMode, this, "EnableTorqueMode");
+        mPIDInterface->AddCommandWrite(&Arm::EnableTrackingError, this, "EnableTrackingError");
+        mPIDInterface->AddCommandWrite(&Arm::SetTrackingErrorTolerances, this, "SetTrackingErrorTolerances");
+        mPIDInterface->AddEventWrite(mCouplingEvent, "Coupling", prmActuatorJointCoupling());
+        mPIDInterface->AddEventWrite(mEnabledJointsEvent, "EnabledJoints", vctBoolVec());
+        mPIDInterface->AddEventWrite(mPositionLimitEvent, "PositionLimit", vctBoolVec());
+    }
+
+    // same interfaces as sawRobotIO1394
+    mtsInterfaceProvided * interfaceProvided = mStandIn->AddInterfaceProvided(mName);
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandRead(&Arm::GetSerialNumber, this, "GetSerialNumber");
+        interfaceProvided->AddCommandReadState(stateTable, m_actuator_amp_status, "GetActuatorAmpStatus");
+        interfaceProvided->AddCommandReadState(stateTable, m_brake_amp_status, "GetBrakeAmpStatus");
+        interfaceProvided->AddCommandWrite(&Arm::BiasEncoder, this, "BiasEncoder");
+        interfaceProvided->AddCommandVoid(&Arm::PowerOnSequence, this, "PowerOnSequence");
+        interfaceProvided->AddCommandWrite(&Arm::PowerOffSequence, this, "PowerOffSequence");
+        interfaceProvided->AddCommandWrite(&Arm::SetEncoderPosition, this, "SetEncoderPosition");
+        interfaceProvided->AddCommandWrite(&Arm::SetSomeEncoderPosition, this, "SetSomeEncoderPosition");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<vctDoubleVec>, this, "SetActuatorCurrent");
+        interfaceProvided->AddCommandWrite(&Arm::Ignore<bool>, this, "UsePotsForSafetyCheck");
+        interfaceProvided->AddCommandVoid(&Arm::BrakeRelease, this, "BrakeRelease");
+        interfaceProvided->AddCommandVoid(&Arm::BrakeEngage, this, "BrakeEngage");
+        interfaceProvided->AddEventWrite(mBiasEncoderEvent, "BiasEncoder", 0);
+    }
+    interfaceProvided = mStandIn->AddInterfaceProvided(mName + "-Gripper");
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandReadState(stateTable, m_gripper_measured_js, "GetAnalogInputPosSI");
+    }
+    interfaceProvided = mStandIn->AddInterfaceProvided(mName + "-Dallas");
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandVoid(&Arm::TriggerRead, this, "TriggerRead");
+        interfaceProvided->AddEventWrite(mToolTypeEvent, "ToolType", std::string());
+    }
+    mAdapter.AddInterface(mStandIn, mName + "-Adapter", true);
+    mTool.AddInterface(mStandIn, mName + "-Tool", true);
+    mManipClutch.AddInterface(mStandIn, mName + "-ManipClutch", false);
+    mSUJClutch.AddInterface(mStandIn, mName + "-SUJClutch", false);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::Run(const double time, const double dt)
+{
+    if (mPowering && (time >= mPowerTime)) {
+        mPowering = false;
+        m_actuator_amp_status.SetAll(true);
+        m_brake_amp_status.SetAll(true);
+    }
+    const bool powered = m_actuator_amp_status.All();
+
+    // encoders and coupling, same as the real IO
+    const std::vector<double> & position = mModel.Positions();
+    const std::vector<double> & velocity = mModel.Velocities();
+    for (size_t index = 0; index < mNumberOfJoints; ++index) {
+        mActuatorPosition.at(index) = position[index] + mEncoderOffsets.at(index);
+        mActuatorVelocity.at(index) = velocity[index];
+    }
+    mJointPosition.ProductOf(mActuatorToJointPosition, mActuatorPosition);
+    mJointVelocity.ProductOf(mActuatorToJointPosition, mActuatorVelocity);
+
+    // PID law, same as sawControllersPID without non linear gain nor dead band
+    bool trackingError = false;
+    for (size_t index = 0; index < mNumberOfJoints; ++index) {
+        double effort = 0.0;
+        if (powered && mEnabled && mEnabledJoints.at(index)) {
+            if (mTorqueMode.at(index)) {
+                effort = mServoEffort.at(index);
+            } else {
+                const double error = mGoal.at(index) - mJointPosition.at(index);
+                if (mTrackingErrorEnabled
+                    && (std::abs(error) > mTrackingErrorTolerances.at(index))) {
+                    trackingError = true;
+                }
+                double & iError = mIError.at(index);
+                iError = std::max(mMinIError.at(index),
+                                  std::min(mForget.at(index) * iError + error * dt,
+                                           mMaxIError.at(index)));
+                effort = mPGain.at(index) * error
+                    - mDGain.at(index) * mJointVelocity.at(index)
+                    + mIGain.at(index) * iError
+                    + mOffset.at(index);
+            }
+            effort += mFeedForward.at(index);
+        }
+        mEffort.at(index) = effort;
+    }
+
+    if (trackingError) {
+        mEnabled = false;
+        mEffort.SetAll(0.0);
+        mPIDInterface->SendError(mName + ": PID tracking error, PID disabled");
+    }
+
+    // actuators, amplifiers off apply no effort
+    if (powered) {
+        mActuatorRequest.ProductOf(mJointToActuatorEffort, mEffort);
+        const std::vector<double> & applied = mActuators.Update(mActuatorRequest.Pointer(), dt);
+        std::copy(applied.begin(), applied.end(), mActuatorEffort.begin());
+    }
+    mModel.Step(mActuatorEffort.Pointer(), dt);
+
+    // report what the PID used
+    m_measured_js.Position().Assign(mJointPosition);
+    m_measured_js.Velocity().Assign(mJointVelocity);
+    m_measured_js.Effort().ProductOf(mActuatorToJointEffort, mActuatorEffort);
+    m_measured_js.SetTimestamp(time);
+    m_measured_js.SetValid(true);
+    m_setpoint_js.Position().Assign(mGoal);
+    m_setpoint_js.Effort().Assign(mEffort);
+    m_setpoint_js.SetTimestamp(time);
+    m_setpoint_js.SetValid(true);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::configure_js(const prmConfigurationJoint & configuration)
+{
+    m_configuration_js = configuration;
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::Enable(const bool & enable)
+{
+    mEnabled = enable;
+    mIError.SetAll(0.0);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::EnableJoints(const vctBoolVec & enable)
+{
+    if (enable.size() != mNumberOfJoints) {
+        mPIDInterface->SendError(mName + ": EnableJoints, incorrect size");
+        return;
+    }
+    mEnabledJoints.Assign(enable);
+    mEnabledJointsEvent(mEnabledJoints);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::SetCoupling(const prmActuatorJointCoupling & coupling)
+{
+    const vctDoubleMat & positionCoupling = coupling.ActuatorToJointPosition();
+    if ((positionCoupling.rows() != mNumberOfJoints)
+        || (positionCoupling.cols() != mNumberOfJoints)) {
+        mPIDInterface->SendError(mName + ": SetCoupling, incorrect size");
+        return;
+    }
+    // efforts are mapped using the position coupling, as the IO does
+    // when only the position coupling is provided
+    mActuatorToJointPosition.Assign(positionCoupling);
+    mJointToActuatorEffort.Assign(positionCoupling.Transpose());
+    vctDoubleMat transpose(mJointToActuatorEffort);
+    nmrPInverseDynamicData pInverseData;
+    pInverseData.Allocate(transpose);
+    nmrPInverse(transpose, pInverseData);
+    mActuatorToJointEffort.Assign(pInverseData.PInverse());
+    mCouplingEvent(coupling);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::servo_jp(const prmPositionJointSet & position)
+{
+    if (position.Goal().size() != mNumberOfJoints) {
+        mPIDInterface->SendError(mName + ": servo_jp, incorrect size");
+        return;
+    }
+    mGoal.Assign(position.Goal());
+    if (!mCheckPositionLimit) {
+        return;
+    }
+    bool changed = false;
+    for (size_t index = 0; index < mNumberOfJoints; ++index) {
+        const double min = m_configuration_js.PositionMin().at(index);
+        const double max = m_configuration_js.PositionMax().at(index);
+        double & goal = mGoal.at(index);
+        const bool limited = (goal < min) || (goal > max);
+        goal = std::max(min, std::min(goal, max));
+        if (limited != mPositionLimitFlags.at(index)) {
+            mPositionLimitFlags.at(index) = limited;
+            changed = true;
+        }
+    }
+    if (changed) {
+        mPositionLimitEvent(mPositionLimitFlags);
+    }
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::servo_jf(const prmForceTorqueJointSet & effort)
+{
+    if (effort.ForceTorque().size() != mNumberOfJoints) {
+        mPIDInterface->SendError(mName + ": servo_jf, incorrect size");
+        return;
+    }
+    mServoEffort.Assign(effort.ForceTorque());
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::feed_forward_jf(const prmForceTorqueJointSet & effort)
+{
+    if (effort.ForceTorque().size() != mNumberOfJoints) {
+        mPIDInterface->SendError(mName + ": feed_forward_jf, incorrect size");
+        return;
+    }
+    mFeedForward.Assign(effort.ForceTorque());
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::SetCheckPositionLimit(const bool & check)
+{
+    mCheckPositionLimit = check;
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::EnableTorqueMode(const vctBoolVec & torqueMode)
+{
+    if (torqueMode.size() != mNumberOfJoints) {
+        mPIDInterface->SendError(mName + ": EnableTorqueMode, incorrect size");
+        return;
+    }
+    mTorqueMode.Assign(torqueMode);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::EnableTrackingError(const bool & enable)
+{
+    mTrackingErrorEnabled = enable;
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::SetTrackingErrorTolerances(const vctDoubleVec & tolerances)
+{
+    if (tolerances.size() != mNumberOfJoints) {
+        mPIDInterface->SendError(mName + ": SetTrackingErrorTolerances, incorrect size");
+        return;
+    }
+    mTrackingErrorTolerances.Assign(tolerances);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::GetSerialNumber(std::string & serial) const
+{
+    serial = mName;
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::PowerOnSequence(void)
+{
+    // amplifiers report power after the delay, see Run
+    if (!m_actuator_amp_status.All()) {
+        mPowering = true;
+        mPowerTime = mStandIn->Now() + mTimeToPower;
+    }
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::PowerOffSequence(const bool & CMN_UNUSED(openSafetyRelays))
+{
+    mPowering = false;
+    m_actuator_amp_status.SetAll(false);
+    m_brake_amp_status.SetAll(false);
+    mEnabled = false;
+    mActuators.Reset();
+    mActuatorEffort.SetAll(0.0);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::BiasEncoder(const int & nbSamples)
+{
+    // negative number of samples, only bias if needed
+    if ((nbSamples < 0) && mEncodersBiased) {
+        mBiasEncoderEvent(-1);
+        return;
+    }
+    // potentiometers read the actual actuator positions
+    mEncoderOffsets.SetAll(0.0);
+    mEncodersBiased = true;
+    mBiasEncoderEvent(std::abs(nbSamples));
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::SetEncoderPosition(const vctDoubleVec & positions)
+{
+    if (positions.size() != mNumberOfJoints) {
+        mPIDInterface->SendError(mName + ": SetEncoderPosition, incorrect size");
+        return;
+    }
+    for (size_t index = 0; index < mNumberOfJoints; ++index) {
+        mEncoderOffsets.at(index) = positions.at(index) - mModel.Positions()[index];
+    }
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::SetSomeEncoderPosition(const prmMaskedDoubleVec & positions)
+{
+    if ((positions.Data().size() != mNumberOfJoints)
+        || (positions.Mask().size() != mNumberOfJoints)) {
+        mPIDInterface->SendError(mName + ": SetSomeEncoderPosition, incorrect size");
+        return;
+    }
+    for (size_t index = 0; index < mNumberOfJoints; ++index) {
+        if (positions.Mask().at(index)) {
+            mEncoderOffsets.at(index) = positions.Data().at(index) - mModel.Positions()[index];
+        }
+    }
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::BrakeRelease(void)
+{
+    mModel.SetBrakes(false);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::BrakeEngage(void)
+{
+    mModel.SetBrakes(true);
+}
+
+void mtsIntuitiveResearchKitStandIn::Arm::TriggerRead(void)
+{
+    if (!mToolType.empty()) {
+        mToolTypeEvent(mToolType);
+    }
+}
+
+mtsIntuitiveResearchKitStandIn::mtsIntuitiveResearchKitStandIn(const std::string & componentName,
+                                                               const double periodInSeconds):
+    mtsTaskPeriodic(componentName, periodInSeconds)
+{
+}
+
+mtsIntuitiveResearchKitStandIn::~mtsIntuitiveResearchKitStandIn()
+{
+    for (auto & arm : mArms) {
+        delete arm.second;
+    }
+}
+
+bool mtsIntuitiveResearchKitStandIn::AddArm(const std::string & name,
+                                            const std::string & armConfigurationFile,
+                                            const std::string & pidConfigurationFile,
+                                            const Json::Value & jsonDynamics)
+{
+    if (mArms.find(name) != mArms.end()) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddArm: arm \"" << name << "\" already added" << std::endl;
+        return false;
+    }
+    Arm * arm = new Arm(this, name);
+    if (!arm->ConfigureModel(armConfigurationFile)
+        || !arm->ConfigurePID(pidConfigurationFile)
+        || !arm->ConfigureDynamics(jsonDynamics)) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddArm: failed to configure arm \"" << name << "\"" << std::endl;
+        delete arm;
+        return false;
+    }
+    arm->AddInterfaces();
+    mArms[name] = arm;
+    return true;
+}
+
+void mtsIntuitiveResearchKitStandIn::Startup(void)
+{
+}
+
+void mtsIntuitiveResearchKitStandIn::Run(void)
+{
+    ProcessQueuedCommands();
+    const double dt = m_virtual_clock ? m_virtual_clock->Step() : GetPeriodicity();
+    const double time = Now();
+    for (auto & arm : mArms) {
+        arm.second->Run(time, dt);
+    }
+
+    // trigger ExecOut event
+    RunEvent();
+}
+
+void mtsIntuitiveResearchKitStandIn::Cleanup(void)
+{
+}
@@ -0,0 +1,476 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-01
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include <cisstVector/vctQuaternionRotation3.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitStreamFormat.h>
+
+const uint32_t mtsIntuitiveResearchKitStreamFormat::Magic;
+const uint16_t mtsIntuitiveResearchKitStreamFormat::Version;
+const size_t mtsIntuitiveResearchKitStreamFormat::HeaderSize;
+const size_t mtsIntuitiveResearchKitStreamFormat::SampleHeaderSize;
+const uint32_t mtsIntuitiveResearchKitStreamFormat::ButtonClutch;
+const uint32_t mtsIntuitiveResearchKitStreamFormat::ButtonCoag;
+const uint32_t mtsIntuitiveResearchKitStreamFormat::TeleopFollowing;
+const uint32_t mtsIntuitiveResearchKitStreamFormat::TeleopClutched;
+const uint32_t mtsIntuitiveResearchKitStreamFormat::TeleopOperatorPresent;
+
+namespace {
+
+    inline bool HostIsLittleEndian(void) {
+        const uint16_t one = 1;
+        return (*reinterpret_cast<const unsigned char *>(&one) == 1);
+    }
+
+    template <typename _type>
+    inline void WriteLE(char * & pointer, const _type value) {
+        memcpy(pointer, &value, sizeof(_type));
+        if (!HostIsLittleEndian()) {
+            std::reverse(pointer, pointer + sizeof(_type));
+        }
+        pointer += sizeof(_type);
+    }
+
+    template <typename _type>
+    inline _type ReadLE(const char * & pointer) {
+        char bytes[sizeof(_type)];
+        memcpy(bytes, pointer, sizeof(_type));
+        if (!HostIsLittleEndian()) {
+            std::reverse(bytes, bytes + sizeof(_type));
+        }
+        _type value;
+        memcpy(&value, bytes, sizeof(_type));
+        pointer += sizeof(_type);
+        return value;
+    }
+
+    typedef mtsIntuitiveResearchKitStreamFormat Format;
+
+    const char * FieldNames[Format::NUMBER_OF_FIELDS] = {
+        "measured_js",
+        "setpoint_js",
+        "measured_cp",
+        "setpoint_cp",
+        "measured_cv",
+        "body/measured_cf",
+        "spatial/measured_cf",
+        "gripper/measured_js",
+        "operating_state",
+        "buttons",
+        "teleop_state"
+    };
+
+    inline bool HasField(const uint32_t fieldMask, const Format::FieldType field) {
+        return (fieldMask & (1 << field));
+    }
+
+    bool IsJointState(const Format::FieldType field) {
+        return ((field == Format::MEASURED_JS)
+                || (field == Format::SETPOINT_JS)
+                || (field == Format::GRIPPER_MEASURED_JS));
+    }
+
+    // size excluding joint state vectors
+    size_t FieldSize(const Format::FieldType field) {
+        switch (field) {
+        case Format::MEASURED_JS:
+        case Format::SETPOINT_JS:
+        case Format::GRIPPER_MEASURED_JS:
+            return 4 * sizeof(uint16_t);
+        case Format::MEASURED_CP:
+        case Format::SETPOINT_CP:
+            return 7 * sizeof(double);
+        case Format::MEASURED_CV:
+        case Format::BODY_MEASURED_CF:
+        case Format::SPATIAL_MEASURED_CF:
+            return 6 * sizeof(double);
+        case Format::OPERATING_STATE:
+            return 2 * sizeof(uint32_t);
+        case Format::BUTTONS:
+            return sizeof(uint32_t);
+        case Format::TELEOP_STATE:
+            return 2 * sizeof(uint32_t) + 5 * sizeof(double);
+        default:
+            break;
+        }
+        return 0;
+    }
+
+    const prmStateJoint & JointState(const Format::Sample & sample, const Format::FieldType field) {
+        switch (field) {
+        case Format::SETPOINT_JS:
+            return sample.setpoint_js;
+        case Format::GRIPPER_MEASURED_JS:
+            return sample.gripper_measured_js;
+        default:
+            break;
+        }
+        return sample.measured_js;
+    }
+
+    prmStateJoint & JointState(Format::Sample & sample, const Format::FieldType field) {
+        return const_cast<prmStateJoint &>(JointState(const_cast<const Format::Sample &>(sample), field));
+    }
+
+    bool FieldValid(const Format::Sample & sample, const Format::FieldType field) {
+        switch (field) {
+        case Format::MEASURED_JS:
+        case Format::SETPOINT_JS:
+        case Format::GRIPPER_MEASURED_JS:
+            return JointState(sample, field).Valid();
+        case Format::MEASURED_CP:
+            return sample.measured_cp.Valid();
+        case Format::SETPOINT_CP:
+            return sample.setpoint_cp.Valid();
+        case Format::MEASURED_CV:
+            return sample.measured_cv.Valid();
+        case Format::BODY_MEASURED_CF:
+            return sample.body_measured_cf.Valid();
+        case Format::SPATIAL_MEASURED_CF:
+            return sample.spatial_measured_cf.Valid();
+        case Format::OPERATING_STATE:
+            return sample.operating_state.Valid();
+        case Format::TELEOP_STATE:
+            return sample.teleop_state.Valid;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    void WriteRotation(char * & pointer, const vctMatRot3 & rotation) {
+        const vctQuatRot3 quaternion(rotation, VCT_NORMALIZE);
+        WriteLE<double>(pointer, quaternion.W());
+        WriteLE<double>(pointer, quaternion.X());
+        WriteLE<double>(pointer, quaternion.Y());
+        WriteLE<double>(pointer, quaternion.Z());
+    }
+
+    void ReadRotation(const char * & pointer, vctMatRot3 & rotation) {
+        vctQuatRot3 quaternion;
+        quaternion.W() = ReadLE<double>(pointer);
+        quaternion.X() = ReadLE<double>(pointer);
+        quaternion.Y() = ReadLE<double>(pointer);
+        quaternion.Z() = ReadLE<double>(pointer);
+        rotation.FromRaw(quaternion);
+    }
+
+    void WriteFrame(char * & pointer, const vctFrm3 & frame) {
+        for (size_t index = 0; index < 3; ++index) {
+            WriteLE<double>(pointer, frame.Translation().Element(index));
+        }
+        WriteRotation(pointer, frame.Rotation());
+    }
+
+    void ReadFrame(const char * & pointer, vctFrm3 & frame) {
+        for (size_t index = 0; index < 3; ++index) {
+            frame.Translation().Element(index) = ReadLE<double>(pointer);
+        }
+        ReadRotation(pointer, frame.Rotation());
+    }
+
+    template <class _vectorType>
+    void WriteVector(char * & pointer, const _vectorType & vector) {
+        const size_t size = vector.size();
+        for (size_t index = 0; index < size; ++index) {
+            WriteLE<double>(pointer, vector.Element(index));
+        }
+    }
+
+    template <class _vectorType>
+    void ReadVector(const char * & pointer, _vectorType & vector) {
+        const size_t size = vector.size();
+        for (size_t index = 0; index < size; ++index) {
+            vector.Element(index) = ReadLE<double>(pointer);
+        }
+    }
+}
+
+std::string mtsIntuitiveResearchKitStreamFormat::FieldToString(const FieldType field)
+{
+    if (field < NUMBER_OF_FIELDS) {
+        return FieldNames[field];
+    }
+    return "unknown";
+}
+
+bool mtsIntuitiveResearchKitStreamFormat::FieldFromString(const std::string & name, FieldType & field)
+{
+    for (int index = 0; index < NUMBER_OF_FIELDS; ++index) {
+        if (name == FieldNames[index]) {
+            field = static_cast<FieldType>(index);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t mtsIntuitiveResearchKitStreamFormat::MaximumSampleSize(const uint32_t fieldMask,
+                                                              const size_t numberOfJoints)
+{
+    size_t size = SampleHeaderSize;
+    for (int index = 0; index < NUMBER_OF_FIELDS; ++index) {
+        const FieldType field = static_cast<FieldType>(index);
+        if (HasField(fieldMask, field)) {
+            size += FieldSize(field);
+            if (IsJointState(field)) {
+                size += 3 * numberOfJoints * sizeof(double);
+            }
+        }
+    }
+    return size;
+}
+
+size_t mtsIntuitiveResearchKitStreamFormat::EncodeHeader(const Header & header,
+                                                         char * buffer, const size_t bufferSize)
+{
+    if (bufferSize < HeaderSize) {
+        return 0;
+    }
+    char * pointer = buffer;
+    WriteLE<uint32_t>(pointer, Magic);
+    WriteLE<uint16_t>(pointer, Version);
+    WriteLE<uint16_t>(pointer, header.NumberOfSamples);
+    WriteLE<uint32_t>(pointer, header.Sequence);
+    WriteLE<uint32_t>(pointer, header.FieldMask);
+    WriteLE<double>(pointer, header.Timestamp);
+    WriteLE<uint32_t>(pointer, header.Decimation);
+    WriteLE<uint32_t>(pointer, 0);
+    return HeaderSize;
+}
+
+bool mtsIntuitiveResearchKitStreamFormat::DecodeHeader(const char * buffer, const size_t size,
+                                                       Header & header)
+{
+    if (size < HeaderSize) {
+        return false;
+    }
+    const char * pointer = buffer;
+    if (ReadLE<uint32_t>(pointer) != Magic) {
+        return false;
+    }
+    // version 2 only added fields
+    const uint16_t version = ReadLE<uint16_t>(pointer);
+    if ((version < 1) || (version > Version)) {
+        return false;
+    }
+    header.NumberOfSamples = ReadLE<uint16_t>(pointer);
+    header.Sequence = ReadLE<uint32_t>(pointer);
+    header.FieldMask = ReadLE<uint32_t>(pointer);
+    header.Timestamp = ReadLE<double>(pointer);
+    header.Decimation = ReadLE<uint32_t>(pointer);
+    return true;
+}
+
+size_t mtsIntuitiveResearchKitStreamFormat::EncodeSample(const Sample & sample, const uint32_t fieldMask,
+                                                         char * buffer, const size_t bufferSize)
+{
+    // check size first
+    size_t size = SampleHeaderSize;
+    for (int index = 0; index < NUMBER_OF_FIELDS; ++index) {
+        const FieldType field = static_cast<FieldType>(index);
+        if (HasField(fieldMask, field)) {
+            size += FieldSize(field);
+            if (IsJointState(field)) {
+                const prmStateJoint & state = JointState(sample, field);
+                size += (state.Position().size() + state.Velocity().size() + state.Effort().size())
+                    * sizeof(double);
+            }
+        }
+    }
+    if ((bufferSize < size) || (size > UINT16_MAX)) {
+        return 0;
+    }
+
+    char * pointer = buffer + SampleHeaderSize;
+    uint16_t valid = 0;
+    for (int index = 0; index < NUMBER_OF_FIELDS; ++index) {
+        const FieldType field = static_cast<FieldType>(index);
+        if (!HasField(fieldMask, field)) {
+            continue;
+        }
+        if (FieldValid(sample, field)) {
+            valid |= (1 << field);
+        }
+        switch (field) {
+        case MEASURED_JS:
+        case SETPOINT_JS:
+        case GRIPPER_MEASURED_JS:
+            {
+                const prmStateJoint & state = JointState(sample, field);
+                WriteLE<uint16_t>(pointer, static_cast<uint16_t>(state.Position().size()));
+                WriteLE<uint16_t>(pointer, static_cast<uint16_t>(state.Velocity().size()));
+                WriteLE<uint16_t>(pointer, static_cast<uint16_t>(state.Effort().size()));
+                WriteLE<uint16_t>(pointer, 0);
+                WriteVector(pointer, state.Position());
+                WriteVector(pointer, state.Velocity());
+                WriteVector(pointer, state.Effort());
+            }
+            break;
+        case MEASURED_CP:
+            WriteFrame(pointer, sample.measured_cp.Position());
+            break;
+        case SETPOINT_CP:
+            WriteFrame(pointer, sample.setpoint_cp.Position());
+            break;
+        case MEASURED_CV:
+            WriteVector(pointer, sample.measured_cv.VelocityLinear());
+            WriteVector(pointer, sample.measured_cv.VelocityAngular());
+            break;
+        case BODY_MEASURED_CF:
+            WriteVector(pointer, sample.body_measured_cf.Force());
+            break;
+        case SPATIAL_MEASURED_CF:
+            WriteVector(pointer, sample.spatial_measured_cf.Force());
+            break;
+        case OPERATING_STATE:
+            WriteLE<uint32_t>(pointer, static_cast<uint32_t>(sample.operating_state.State()));
+            WriteLE<uint32_t>(pointer, (sample.operating_state.IsHomed() ? 0x1 : 0x0)
+                              | (sample.operating_state.IsBusy() ? 0x2 : 0x0));
+            break;
+        case BUTTONS:
+            WriteLE<uint32_t>(pointer, sample.buttons);
+            break;
+        case TELEOP_STATE:
+            {
+                const TeleopState & state = sample.teleop_state;
+                WriteLE<uint32_t>(pointer, (state.following ? TeleopFollowing : 0x0)
+                                  | (state.clutched ? TeleopClutched : 0x0)
+                                  | (state.operator_present ? TeleopOperatorPresent : 0x0));
+                WriteLE<uint32_t>(pointer, 0);
+                WriteLE<double>(pointer, state.scale);
+                WriteRotation(pointer, state.alignment_offset);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // sample header, valid flags are now known
+    pointer = buffer;
+    WriteLE<uint16_t>(pointer, static_cast<uint16_t>(size));
+    WriteLE<uint16_t>(pointer, valid);
+    WriteLE<uint32_t>(pointer, sample.Index);
+    WriteLE<double>(pointer, sample.Timestamp);
+    return size;
+}
+
+size_t mtsIntuitiveResearchKitStreamFormat::DecodeSample(const char * buffer, const size_t size,
+                                                         const uint32_t fieldMask, Sample & sample)
+{
+    if (size < SampleHeaderSize) {
+        return 0;
+    }
+    const char * pointer = buffer;
+    const size_t sampleSize = ReadLE<uint16_t>(pointer);
+    if ((sampleSize > size) || (sampleSize < SampleHeaderSize)) {
+        return 0;
+    }
+    const uint16_t valid = ReadLE<uint16_t>(pointer);
+    sample.Index = ReadLE<uint32_t>(pointer);
+    sample.Timestamp = ReadLE<double>(pointer);
+
+    const char * end = buffer + sampleSize;
+    for (int index = 0; index < NUMBER_OF_FIELDS; ++index) {
+        const FieldType field = static_cast<FieldType>(index);
+        if (!HasField(fieldMask, field)) {
+            continue;
+        }
+        if (pointer + FieldSize(field) > end) {
+            return 0;
+        }
+        const bool fieldValid = (valid & (1 << field));
+        switch (field) {
+        case MEASURED_JS:
+        case SETPOINT_JS:
+        case GRIPPER_MEASURED_JS:
+            {
+                prmStateJoint & state = JointState(sample, field);
+                const size_t positions = ReadLE<uint16_t>(pointer);
+                const size_t velocities = ReadLE<uint16_t>(pointer);
+                const size_t efforts = ReadLE<uint16_t>(pointer);
+                ReadLE<uint16_t>(pointer);
+                if (pointer + (positions + velocities + efforts) * sizeof(double) > end) {
+                    return 0;
+                }
+                state.Position().SetSize(positions);
+                state.Velocity().SetSize(velocities);
+                state.Effort().SetSize(efforts);
+                ReadVector(pointer, state.Position());
+                ReadVector(pointer, state.Velocity());
+                ReadVector(pointer, state.Effort());
+                state.SetValid(fieldValid);
+                state.SetTimestamp(sample.Timestamp);
+            }
+            break;
+        case MEASURED_CP:
+            ReadFrame(pointer, sample.measured_cp.Position());
+            sample.measured_cp.SetValid(fieldValid);
+            break;
+        case SETPOINT_CP:
+            ReadFrame(pointer, sample.setpoint_cp.Position());
+            sample.setpoint_cp.SetValid(fieldValid);
+            break;
+        case MEASURED_CV:
+            ReadVector(pointer, sample.measured_cv.VelocityLinear());
+            ReadVector(pointer, sample.measured_cv.VelocityAngular());
+            sample.measured_cv.SetValid(fieldValid);
+            break;
+        case BODY_MEASURED_CF:
+            ReadVector(pointer, sample.body_measured_cf.Force());
+            sample.body_measured_cf.SetValid(fieldValid);
+            break;
+        case SPATIAL_MEASURED_CF:
+            ReadVector(pointer, sample.spatial_measured_cf.Force());
+            sample.spatial_measured_cf.SetValid(fieldValid);
+            break;
+        case OPERATING_STATE:
+            {
+                sample.operating_state.State() =
+                    static_cast<prmOperatingState::StateType>(ReadLE<uint32_t>(pointer));
+                const uint32_t flags = ReadLE<uint32_t>(pointer);
+                sample.operating_state.IsHomed() = (flags & 0x1);
+                sample.operating_state.IsBusy() = (flags & 0x2);
+                sample.operating_state.SetValid(fieldValid);
+            }
+            break;
+        case BUTTONS:
+            sample.buttons = ReadLE<uint32_t>(pointer);
+            break;
+        case TELEOP_STATE:
+            {
+                TeleopState & state = sample.teleop_state;
+                const uint32_t flags = ReadLE<uint32_t>(pointer);
+                ReadLE<uint32_t>(pointer);
+                state.following = (flags & TeleopFollowing);
+                state.clutched = (flags & TeleopClutched);
+                state.operator_present = (flags & TeleopOperatorPresent);
+                state.scale = ReadLE<double>(pointer);
+                ReadRotation(pointer, state.alignment_offset);
+                state.Valid = fieldValid;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return sampleSize;
+}
@@ -0,0 +1,142 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-19
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitTimingHistogram.h>
+
+mtsIntuitiveResearchKitTimingHistogram::mtsIntuitiveResearchKitTimingHistogram(void):
+    mResolution(1.0e-6)
+{
+    Configure(1.0e-6, 0.01);
+}
+
+void mtsIntuitiveResearchKitTimingHistogram::Configure(const double resolution, const double range)
+{
+    mResolution = (resolution > 0.0) ? resolution : 1.0e-6;
+    const size_t size = std::max(static_cast<size_t>(std::ceil(range / mResolution)),
+                                 static_cast<size_t>(1));
+    mBins.assign(size, 0);
+    Reset();
+}
+
+void mtsIntuitiveResearchKitTimingHistogram::Reset(void)
+{
+    std::fill(mBins.begin(), mBins.end(), 0);
+    mCount = 0;
+    mOverflows = 0;
+    mMinimum = 0.0;
+    mMaximum = 0.0;
+    mSum = 0.0;
+}
+
+void mtsIntuitiveResearchKitTimingHistogram::Add(const double value)
+{
+    if (mCount == 0) {
+        mMinimum = value;
+        mMaximum = value;
+    } else {
+        mMinimum = std::min(mMinimum, value);
+        mMaximum = std::max(mMaximum, value);
+    }
+    ++mCount;
+    mSum += value;
+    if (value <= 0.0) {
+        ++mBins[0];
+        return;
+    }
+    // bin i holds values in (i * resolution, (i + 1) * resolution],
+    // small tolerance so exact multiples don't end in the next bin
+    const double position = std::ceil(value / mResolution - 1.0e-9) - 1.0;
+    if (position >= static_cast<double>(mBins.size())) {
+        ++mOverflows;
+        return;
+    }
+    ++mBins[static_cast<size_t>(std::max(position, 0.0))];
+}
+
+double mtsIntuitiveResearchKitTimingHistogram::Minimum(void) const
+{
+    return mMinimum;
+}
+
+double mtsIntuitiveResearchKitTimingHistogram::Maximum(void) const
+{
+    return mMaximum;
+}
+
+double mtsIntuitiveResearchKitTimingHistogram::Mean(void) const
+{
+    if (mCount == 0) {
+        return 0.0;
+    }
+    return mSum / static_cast<double>(mCount);
+}
+
+double mtsIntuitiveResearchKitTimingHistogram::Percentile(const double percent) const
+{
+    if (mCount == 0) {
+        return 0.0;
+    }
+    // smallest rank with at least percent of the samples at or below
+    const double ratio = std::max(0.0, std::min(percent, 100.0)) / 100.0;
+    size_t rank = static_cast<size_t>(std::ceil(ratio * static_cast<double>(mCount) - 1.0e-9));
+    rank = std::max(rank, static_cast<size_t>(1));
+    if (rank >= mCount) {
+        return mMaximum;
+    }
+    size_t cumulated = 0;
+    for (size_t index = 0; index < mBins.size(); ++index) {
+        cumulated += mBins[index];
+        if (cumulated >= rank) {
+            const double edge = static_cast<double>(index + 1) * mResolution;
+            return std::max(mMinimum, std::min(edge, mMaximum));
+        }
+    }
+    // in overflows
+    return mMaximum;
+}
+
+bool mtsIntuitiveResearchKitTimingHistogram::Statistic(const std::string & name, double & value) const
+{
+    if (name == "min") {
+        value = Minimum();
+        return true;
+    }
+    if (name == "mean") {
+        value = Mean();
+        return true;
+    }
+    if (name == "max") {
+        value = Maximum();
+        return true;
+    }
+    if ((name.size() < 2) || (name[0] != 'p')) {
+        return false;
+    }
+    const char * start = name.c_str() + 1;
+    char * end = nullptr;
+    const double percent = std::strtod(start, &end);
+    if ((end == start) || (*end != '\0') || (percent < 0.0) || (percent > 100.0)) {
+        return false;
+    }
+    value = Percentile(percent);
+    return true;
+}
@@ -0,0 +1,136 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-19
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <iomanip>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitTimingProbe.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArm.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitSUJ.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitStandIn.h>
+#include <sawIntuitiveResearchKit/mtsTeleOperationPSM.h>
+#include <sawIntuitiveResearchKit/mtsTeleOperationECM.h>
+#include <sawRobotIO1394/mtsRobotIO1394.h>
+#include <cisstMultiTask/mtsManagerLocal.h>
+#include <cisstMultiTask/mtsStateTable.h>
+
+CMN_IMPLEMENT_SERVICES_DERIVED(mtsIntuitiveResearchKitTimingProbe, mtsTaskPeriodic)
+
+mtsIntuitiveResearchKitTimingProbe::mtsIntuitiveResearchKitTimingProbe(const std::string & name,
+                                                                       mtsTask * source,
+                                                                       const double resolution,
+                                                                       const double range):
+    // period is not used, probe runs in source thread
+    mtsTaskPeriodic(name, mtsIntuitiveResearchKit::Benchmark::ProbePeriod),
+    mSource(source),
+    mRecording(false),
+    mLastTic(0.0)
+{
+    mPeriods.Configure(resolution, range);
+    mExecutionTimes.Configure(resolution, range);
+}
+
+void mtsIntuitiveResearchKitTimingProbe::Startup(void)
+{
+}
+
+void mtsIntuitiveResearchKitTimingProbe::Run(void)
+{
+    if (!mRecording) {
+        return;
+    }
+    const double tic = mSource->GetDefaultStateTable()->GetTic();
+    const double now = mtsManagerLocal::GetInstance()->GetTimeServer().GetRelativeTime();
+    mExecutionTimes.Add(now - tic);
+    // first cycle after start only provides a reference
+    if ((mLastTic != 0.0) && (tic != mLastTic)) {
+        mPeriods.Add(tic - mLastTic);
+    }
+    mLastTic = tic;
+}
+
+void mtsIntuitiveResearchKitTimingProbe::Cleanup(void)
+{
+}
+
+void mtsIntuitiveResearchKitTimingProbe::SetRecording(const bool recording)
+{
+    if (recording && !mRecording) {
+        mPeriods.Reset();
+        mExecutionTimes.Reset();
+        mLastTic = 0.0;
+    }
+    mRecording = recording;
+}
+
+std::list<mtsIntuitiveResearchKitTimingProbe *>
+mtsIntuitiveResearchKitTimingProbe::AddProbes(const double resolution, const double range)
+{
+    std::list<mtsIntuitiveResearchKitTimingProbe *> probes;
+    mtsManagerLocal * componentManager = mtsManagerLocal::GetInstance();
+    const std::vector<std::string> componentNames = componentManager->GetNamesOfComponents();
+    for (const auto & componentName : componentNames) {
+        mtsTask * task = dynamic_cast<mtsTask *>(componentManager->GetComponent(componentName));
+        // all these tasks trigger ExecOut at the end of Run
+        if (dynamic_cast<mtsIntuitiveResearchKitArm *>(task)
+            || dynamic_cast<mtsIntuitiveResearchKitSUJ *>(task)
+            || dynamic_cast<mtsTeleOperationPSM *>(task)
+            || dynamic_cast<mtsTeleOperationECM *>(task)
+            || dynamic_cast<mtsIntuitiveResearchKitStandIn *>(task)
+            || dynamic_cast<mtsRobotIO1394 *>(task)) {
+            mtsIntuitiveResearchKitTimingProbe * probe =
+                new mtsIntuitiveResearchKitTimingProbe(componentName + "-Probe", task,
+                                                       resolution, range);
+            componentManager->AddComponent(probe);
+            componentManager->Connect(probe->GetName(), "ExecIn", componentName, "ExecOut");
+            probes.push_back(probe);
+        }
+    }
+    return probes;
+}
+
+void mtsIntuitiveResearchKitTimingProbe::PrintReport(std::ostream & output,
+                                                     const std::list<mtsIntuitiveResearchKitTimingProbe *> & probes)
+{
+    output << std::left << std::setw(24) << "component" << std::right
+           << std::setw(9) << "nominal" << std::setw(10) << "samples"
+           << std::setw(9) << "T p50" << std::setw(9) << "T p99"
+           << std::setw(9) << "T p99.9" << std::setw(9) << "T max"
+           << std::setw(9) << "E p50" << std::setw(9) << "E p99"
+           << std::setw(9) << "E p99.9" << std::setw(9) << "E max"
+           << std::endl;
+    const std::ios::fmtflags flags = output.flags();
+    const std::streamsize precision = output.precision();
+    output << std::fixed << std::setprecision(0);
+    for (const auto probe : probes) {
+        output << std::left << std::setw(24) << probe->Source()->GetName() << std::right
+               << std::setw(9) << probe->Source()->GetPeriodicity(true) * 1.0e6
+               << std::setw(10) << probe->ExecutionTimes().Count();
+        const mtsIntuitiveResearchKitTimingHistogram * histograms[2] = {&(probe->Periods()),
+                                                                          &(probe->ExecutionTimes())};
+        for (auto histogram : histograms) {
+            output << std::setw(9) << histogram->Percentile(50.0) * 1.0e6
+                   << std::setw(9) << histogram->Percentile(99.0) * 1.0e6
+                   << std::setw(9) << histogram->Percentile(99.9) * 1.0e6
+                   << std::setw(9) << histogram->Maximum() * 1.0e6;
+        }
+        output << std::endl;
+    }
+    output.flags(flags);
+    output.precision(precision);
+}
@@ -3,10 +3,10 @@
 
 /*
 
-  Author(s):  Peter Kazanzides
+  Author(s):  Peter Kazanzides, Anton Deguet
   Created on: 2013-12-02
 
-  (C) Copyright 2013-2014 Johns Hopkins University (JHU), All Rights Reserved.
+  (C) Copyright 2013-2021 Johns Hopkins University (JHU), All Rights Reserved.
 
 --- begin cisst license - do not edit ---
 
@@ -17,10 +17,14 @@ http://www.cisst.org/cisst/license.txt.
 --- end cisst license ---
 */
 
+#include <cstring>
+#include <fstream>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitUDPStreamer.h>
 #include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstMultiTask/mtsInterfaceRequired.h>
-#include <cisstParameterTypes/prmPositionCartesianGet.h>
+#include <cisstMultiTask/mtsManagerLocal.h>
 #include <cisstParameterTypes/prmEventButton.h>
 
 CMN_IMPLEMENT_SERVICES_DERIVED(mtsIntuitiveResearchKitUDPStreamer, mtsTaskPeriodic)
@@ -28,45 +32,250 @@ CMN_IMPLEMENT_SERVICES_DERIVED(mtsIntuitiveResearchKitUDPStreamer, mtsTaskPeriod
 mtsIntuitiveResearchKitUDPStreamer::mtsIntuitiveResearchKitUDPStreamer(const std::string & name,
                                                                        double period, const std::string & ip, unsigned short port) :
     mtsTaskPeriodic(name, period),
-    Socket(osaSocket::UDP),
-    SocketConfigured(false),
-    Clutch(false),
-    Coag(false)
+    mLastTimestamp(0.0),
+    mNumberOfSamples(0),
+    mNumberOfDatagrams(0),
+    mNumberOfDuplicates(0)
 {
+    // default fields, same data as original 9 doubles packet
+    mFieldMask = (1 << StreamFormat::BUTTONS)
+        | (1 << StreamFormat::GRIPPER_MEASURED_JS)
+        | (1 << StreamFormat::MEASURED_CP);
+
+    StateTable.AddData(mNumberOfSamples, "NumberOfSamples");
+    StateTable.AddData(mNumberOfDatagrams, "NumberOfDatagrams");
+    StateTable.AddData(mNumberOfDuplicates, "NumberOfDuplicates");
+
     mtsInterfaceProvided * provided = AddInterfaceProvided("Configuration");
     if (provided) {
         provided->AddCommandWrite(&mtsIntuitiveResearchKitUDPStreamer::SetDestination, this, "SetDestination");
+        provided->AddCommandReadState(StateTable, StateTable.PeriodStats, "period_statistics");
+        provided->AddCommandReadState(StateTable, mNumberOfSamples, "GetNumberOfSamples");
+        provided->AddCommandReadState(StateTable, mNumberOfDatagrams, "GetNumberOfDatagrams");
+        provided->AddCommandReadState(StateTable, mNumberOfDuplicates, "GetNumberOfDuplicates");
     }
+    // all fields are optional, only fields configured and provided by the arm are sent
     mtsInterfaceRequired * required = AddInterfaceRequired("Arm");
     if (required) {
-        required->AddFunction("measured_cp", measured_cp);
-        required->AddFunction("GetGripperPosition", GetGripperPosition);
+        for (int index = 0; index < StreamFormat::NUMBER_OF_FIELDS; ++index) {
+            const StreamFormat::FieldType field = static_cast<StreamFormat::FieldType>(index);
+            if ((field != StreamFormat::BUTTONS)
+                && (field != StreamFormat::TELEOP_STATE)) {
+                required->AddFunction(StreamFormat::FieldToString(field), mReadFunctions[index], MTS_OPTIONAL);
+            }
+        }
+        // tele-operation components
+        required->AddFunction("following", mTeleop.following, MTS_OPTIONAL);
+        required->AddFunction("clutched", mTeleop.clutched, MTS_OPTIONAL);
+        required->AddFunction("operator_present", mTeleop.operator_present, MTS_OPTIONAL);
+        required->AddFunction("scale", mTeleop.scale, MTS_OPTIONAL);
+        required->AddFunction("alignment_offset", mTeleop.alignment_offset, MTS_OPTIONAL);
     }
-    required = AddInterfaceRequired("Clutch");
+    required = AddInterfaceRequired("Clutch", MTS_OPTIONAL);
     if (required) {
         required->AddEventHandlerWrite(&mtsIntuitiveResearchKitUDPStreamer::EventHandlerManipClutch, this, "Button");
     }
-    required = AddInterfaceRequired("Coag");
+    required = AddInterfaceRequired("Coag", MTS_OPTIONAL);
     if (required) {
         required->AddEventHandlerWrite(&mtsIntuitiveResearchKitUDPStreamer::EventHandlerCoag, this, "Button");
     }
+
+    const size_t sampleSize = StreamFormat::MaximumSampleSize((1 << StreamFormat::NUMBER_OF_FIELDS) - 1,
+                                                              mtsIntuitiveResearchKit::Streamer::MaximumNumberOfJoints);
+    mSampleBuffer.resize(sampleSize);
+
     if (!ip.empty()) {
-        Socket.SetDestination(ip, port);
-        SocketConfigured = true;
+        AddDestination(ip, port, 1, 1);
     }
 }
 
 mtsIntuitiveResearchKitUDPStreamer::~mtsIntuitiveResearchKitUDPStreamer()
 {
+    for (auto destination : mDestinations) {
+        delete destination;
+    }
+}
+
+void mtsIntuitiveResearchKitUDPStreamer::Configure(const std::string & filename)
+{
+    std::ifstream jsonStream;
+    Json::Value jsonConfig;
+    Json::Reader jsonReader;
+
+    if (filename == "") {
+        return;
+    }
+
+    jsonStream.open(filename.c_str());
+    if (!jsonReader.parse(jsonStream, jsonConfig)) {
+        CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName()
+                                 << ": failed to parse configuration file \""
+                                 << filename << "\"\n"
+                                 << jsonReader.getFormattedErrorMessages();
+        exit(EXIT_FAILURE);
+    }
+
+    CMN_LOG_CLASS_INIT_VERBOSE << "Configure: " << this->GetName()
+                               << " using file \"" << filename << "\"" << std::endl
+                               << "----> content of configuration file: " << std::endl
+                               << jsonConfig << std::endl
+                               << "<----" << std::endl;
+
+    Configure(jsonConfig);
+}
+
+void mtsIntuitiveResearchKitUDPStreamer::Configure(const Json::Value & jsonConfig)
+{
+    // fields, order doesn't matter
+    const Json::Value jsonFields = jsonConfig["fields"];
+    if (!jsonFields.empty()) {
+        mFieldMask = 0;
+        for (unsigned int index = 0; index < jsonFields.size(); ++index) {
+            StreamFormat::FieldType field;
+            const std::string name = jsonFields[index].asString();
+            if (!StreamFormat::FieldFromString(name, field)) {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName()
+                                         << ": unknown field \"" << name << "\"" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            mFieldMask |= (1 << field);
+        }
+    }
+
+    const Json::Value jsonDestinations = jsonConfig["destinations"];
+    for (unsigned int index = 0; index < jsonDestinations.size(); ++index) {
+        const Json::Value jsonDestination = jsonDestinations[index];
+        Json::Value jsonValue;
+        std::string ip, sharedMemory;
+        unsigned short port = 0;
+        unsigned int slots = mtsIntuitiveResearchKit::Streamer::NumberOfSlots;
+        unsigned int decimation = 1;
+        unsigned int batch = 1;
+        jsonValue = jsonDestination["ip"];
+        if (!jsonValue.empty()) {
+            ip = jsonValue.asString();
+        }
+        jsonValue = jsonDestination["port"];
+        if (!jsonValue.empty()) {
+            port = static_cast<unsigned short>(jsonValue.asUInt());
+        }
+        jsonValue = jsonDestination["shared-memory"];
+        if (!jsonValue.empty()) {
+            sharedMemory = jsonValue.asString();
+        }
+        jsonValue = jsonDestination["slots"];
+        if (!jsonValue.empty()) {
+            slots = jsonValue.asUInt();
+        }
+        jsonValue = jsonDestination["decimation"];
+        if (!jsonValue.empty()) {
+            decimation = jsonValue.asUInt();
+        }
+        jsonValue = jsonDestination["batch"];
+        if (!jsonValue.empty()) {
+            batch = jsonValue.asUInt();
+        }
+        if (!sharedMemory.empty()) {
+            if (!ip.empty()) {
+                CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName()
+                                         << ": destinations[" << index << "] can't use both \"ip\" and \"shared-memory\"" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            if (!AddSharedMemory(sharedMemory, slots, decimation, batch)) {
+                exit(EXIT_FAILURE);
+            }
+            continue;
+        }
+        if (ip.empty() || (port == 0)) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName()
+                                     << ": destinations[" << index << "] requires \"ip\" and \"port\" or \"shared-memory\"" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (!AddDestination(ip, port, decimation, batch)) {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+mtsIntuitiveResearchKitUDPStreamer::Destination *
+mtsIntuitiveResearchKitUDPStreamer::NewDestination(const unsigned int decimation, const unsigned int batch)
+{
+    if ((decimation == 0) || (batch == 0)) {
+        CMN_LOG_CLASS_INIT_ERROR << "NewDestination " << this->GetName()
+                                 << ": decimation and batch must be strictly positive" << std::endl;
+        return nullptr;
+    }
+    Destination * destination = new Destination;
+    destination->Decimation = decimation;
+    destination->Batch = batch;
+    destination->Cycles = 0;
+    destination->Header.Decimation = decimation;
+    destination->Header.FieldMask = mFieldMask;
+    // size with all possible fields so fields can be changed later
+    destination->Buffer.resize(StreamFormat::HeaderSize + batch * mSampleBuffer.size());
+    destination->Size = StreamFormat::HeaderSize;
+    return destination;
+}
+
+bool mtsIntuitiveResearchKitUDPStreamer::AddDestination(const std::string & ip, const unsigned short port,
+                                                        const unsigned int decimation, const unsigned int batch)
+{
+    Destination * destination = NewDestination(decimation, batch);
+    if (!destination) {
+        return false;
+    }
+    if (destination->Buffer.size() > mtsIntuitiveResearchKit::Streamer::MaximumDatagramSize) {
+        const size_t maximumBatch = (mtsIntuitiveResearchKit::Streamer::MaximumDatagramSize - StreamFormat::HeaderSize)
+            / mSampleBuffer.size();
+        CMN_LOG_CLASS_INIT_WARNING << "AddDestination " << this->GetName()
+                                   << ": datagrams might not fit in a single ethernet frame with batch of "
+                                   << batch << ", recommended batch for all fields is " << maximumBatch << std::endl;
+    }
+    destination->Address = ip + ":" + std::to_string(port);
+    destination->Socket.SetDestination(ip, port);
+    mDestinations.push_back(destination);
+    return true;
 }
 
-void mtsIntuitiveResearchKitUDPStreamer::Configure(const std::string &ipPort)
+bool mtsIntuitiveResearchKitUDPStreamer::AddSharedMemory(const std::string & name, const unsigned int numberOfSlots,
+                                                         const unsigned int decimation, const unsigned int batch)
 {
-    SetDestination(ipPort);
+    Destination * destination = NewDestination(decimation, batch);
+    if (!destination) {
+        return false;
+    }
+    destination->Address = name;
+    destination->Ring = new mtsSharedMemoryRing;
+    if (!destination->Ring->Create(name, numberOfSlots, destination->Buffer.size(), this->GetName())) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddSharedMemory " << this->GetName()
+                                 << ": failed to create shared memory ring, "
+                                 << destination->Ring->LastError() << std::endl;
+        delete destination;
+        return false;
+    }
+    mDestinations.push_back(destination);
+    return true;
 }
 
 void mtsIntuitiveResearchKitUDPStreamer::Startup(void)
 {
+    // remove fields not provided by the arm
+    for (int index = 0; index < StreamFormat::NUMBER_OF_FIELDS; ++index) {
+        const StreamFormat::FieldType field = static_cast<StreamFormat::FieldType>(index);
+        const bool provided = (field == StreamFormat::TELEOP_STATE) ?
+            mTeleop.following.IsValid() : mReadFunctions[index].IsValid();
+        if ((field != StreamFormat::BUTTONS)
+            && (mFieldMask & (1 << field))
+            && !provided) {
+            CMN_LOG_CLASS_INIT_WARNING << "Startup " << this->GetName()
+                                       << ": field \"" << StreamFormat::FieldToString(field)
+                                       << "\" is not provided by the arm, it will not be streamed" << std::endl;
+            mFieldMask &= ~(1 << field);
+        }
+    }
+    for (auto destination : mDestinations) {
+        destination->Header.FieldMask = mFieldMask;
+    }
 }
 
 void mtsIntuitiveResearchKitUDPStreamer::Run(void)
@@ -74,39 +283,150 @@ void mtsIntuitiveResearchKitUDPStreamer::Run(void)
     ProcessQueuedCommands();
     ProcessQueuedEvents();
 
-    if (SocketConfigured) {
-        // Packet format (9 doubles): buttons (clutch, coag), gripper, x, y, z, q0, qx, qy, qz
-        // For the buttons: 0=None, 1=Clutch, 2=Coag, 3=Both
-        double packet[9];
-        if (Clutch) {
-            packet[0] = 1.0;
-        } else {
-            packet[0] = 0.0;
-        }
-        if (Coag)
-            packet[0] += 2.0;
-        GetGripperPosition(packet[1]);
-        prmPositionCartesianGet posCart;
-        measured_cp(posCart);
-        vct3 pos = posCart.Position().Translation();
-        packet[2] = pos.X();
-        packet[3] = pos.Y();
-        packet[4] = pos.Z();
-        vctQuatRot3 qrot(posCart.Position().Rotation());
-        packet[5] = qrot.W();
-        packet[6] = qrot.X();
-        packet[7] = qrot.Y();
-        packet[8] = qrot.Z();
-        Socket.Send((char *)packet, sizeof(packet));
+    if (mDestinations.empty()) {
+        return;
+    }
+
+    // read all fields, timestamp from first field with data timestamp
+    bool timestampFound = false;
+    for (int index = 0; index < StreamFormat::NUMBER_OF_FIELDS; ++index) {
+        const StreamFormat::FieldType field = static_cast<StreamFormat::FieldType>(index);
+        if (!(mFieldMask & (1 << field))) {
+            continue;
+        }
+        mtsGenericObject * data = nullptr;
+        switch (field) {
+        case StreamFormat::MEASURED_JS:
+            data = &(mSample.measured_js);
+            break;
+        case StreamFormat::SETPOINT_JS:
+            data = &(mSample.setpoint_js);
+            break;
+        case StreamFormat::MEASURED_CP:
+            data = &(mSample.measured_cp);
+            break;
+        case StreamFormat::SETPOINT_CP:
+            data = &(mSample.setpoint_cp);
+            break;
+        case StreamFormat::MEASURED_CV:
+            data = &(mSample.measured_cv);
+            break;
+        case StreamFormat::BODY_MEASURED_CF:
+            data = &(mSample.body_measured_cf);
+            break;
+        case StreamFormat::SPATIAL_MEASURED_CF:
+            data = &(mSample.spatial_measured_cf);
+            break;
+        case StreamFormat::GRIPPER_MEASURED_JS:
+            data = &(mSample.gripper_measured_js);
+            break;
+        case StreamFormat::OPERATING_STATE:
+            // only timestamped when state changes
+            mReadFunctions[index](mSample.operating_state);
+            break;
+        case StreamFormat::TELEOP_STATE:
+            ReadTeleopState(mSample.teleop_state);
+            break;
+        default:
+            break;
+        }
+        if (data) {
+            mReadFunctions[index](*data);
+            if (!timestampFound) {
+                mSample.Timestamp = data->Timestamp();
+                timestampFound = true;
+            }
+        }
+    }
+    if (!timestampFound) {
+        mSample.Timestamp = mtsComponentManager::GetInstance()->GetTimeServer().GetRelativeTime();
+    } else if (mSample.Timestamp == mLastTimestamp) {
+        // arm didn't run since last sample
+        mNumberOfDuplicates++;
+        return;
+    }
+    mLastTimestamp = mSample.Timestamp;
+    mSample.Index = mNumberOfSamples;
+    mNumberOfSamples++;
+
+    // encode once for all destinations
+    const size_t sampleSize = StreamFormat::EncodeSample(mSample, mFieldMask,
+                                                         mSampleBuffer.data(), mSampleBuffer.size());
+    if (sampleSize == 0) {
+        CMN_LOG_CLASS_RUN_ERROR << "Run " << this->GetName()
+                                << ": failed to encode sample, too many joints?" << std::endl;
+        return;
+    }
+
+    for (auto destination : mDestinations) {
+        const bool sendSample = ((destination->Cycles % destination->Decimation) == 0);
+        destination->Cycles++;
+        if (!sendSample) {
+            continue;
+        }
+        memcpy(destination->Buffer.data() + destination->Size, mSampleBuffer.data(), sampleSize);
+        destination->Size += sampleSize;
+        destination->Header.NumberOfSamples++;
+        if (destination->Header.NumberOfSamples == destination->Batch) {
+            Send(*destination);
+        }
+    }
+}
+
+void mtsIntuitiveResearchKitUDPStreamer::ReadTeleopState(StreamFormat::TeleopState & state)
+{
+    state.Valid = mTeleop.following(state.following).IsOK();
+    // ECM teleop has no operator presence nor alignment offset
+    if (mTeleop.clutched.IsValid()) {
+        mTeleop.clutched(state.clutched);
+    }
+    if (mTeleop.operator_present.IsValid()) {
+        mTeleop.operator_present(state.operator_present);
+    }
+    if (mTeleop.scale.IsValid()) {
+        mTeleop.scale(state.scale);
+    }
+    if (mTeleop.alignment_offset.IsValid()) {
+        mTeleop.alignment_offset(state.alignment_offset);
+    }
+}
+
+void mtsIntuitiveResearchKitUDPStreamer::Send(Destination & destination)
+{
+    destination.Header.Sequence++;
+    destination.Header.Timestamp = mtsComponentManager::GetInstance()->GetTimeServer().GetRelativeTime();
+    StreamFormat::EncodeHeader(destination.Header, destination.Buffer.data(), destination.Buffer.size());
+    if (destination.Ring) {
+        destination.Ring->Write(destination.Buffer.data(), destination.Size);
+    } else {
+        destination.Socket.Send(destination.Buffer.data(), destination.Size);
+    }
+    mNumberOfDatagrams++;
+    destination.Header.NumberOfSamples = 0;
+    destination.Size = StreamFormat::HeaderSize;
+}
+
+void mtsIntuitiveResearchKitUDPStreamer::Flush(Destination & destination)
+{
+    if (destination.Header.NumberOfSamples > 0) {
+        Send(destination);
     }
 }
 
 void mtsIntuitiveResearchKitUDPStreamer::Cleanup(void)
 {
-    Socket.Close();
+    for (auto destination : mDestinations) {
+        // send partial batches so the last samples are not lost
+        Flush(*destination);
+        if (destination->Ring) {
+            destination->Ring->Close();
+        } else {
+            destination->Socket.Close();
+        }
+    }
 }
 
-void mtsIntuitiveResearchKitUDPStreamer::SetDestination(const std::string &ipPort)
+void mtsIntuitiveResearchKitUDPStreamer::SetDestination(const std::string & ipPort)
 {
     size_t colon = ipPort.find(':');
     if (colon == std::string::npos) {
@@ -115,20 +435,35 @@ void mtsIntuitiveResearchKitUDPStreamer::SetDestination(const std::string &ipPor
         unsigned short port;
         if ((sscanf(ipPort.c_str() + colon + 1, "%hu", &port) != 1)) {
             CMN_LOG_CLASS_RUN_ERROR << "SetDestination: invalid port " << ipPort << std::endl;
-        
         } else {
-            Socket.SetDestination(ipPort.substr(0, colon), port);
-            SocketConfigured = true;
+            // configured destinations are kept, only add a new one
+            // if nothing is streamed to this address yet
+            const std::string address = ipPort.substr(0, colon) + ":" + std::to_string(port);
+            for (auto destination : mDestinations) {
+                if (!destination->Ring && (destination->Address == address)) {
+                    CMN_LOG_CLASS_RUN_VERBOSE << "SetDestination: already streaming to " << address << std::endl;
+                    return;
+                }
+            }
+            AddDestination(ipPort.substr(0, colon), port, 1, 1);
         }
     }
 }
 
-void mtsIntuitiveResearchKitUDPStreamer::EventHandlerManipClutch(const prmEventButton &button)
+void mtsIntuitiveResearchKitUDPStreamer::EventHandlerManipClutch(const prmEventButton & button)
 {
-    Clutch = (button.Type() == prmEventButton::PRESSED);
+    if (button.Type() == prmEventButton::PRESSED) {
+        mSample.buttons |= StreamFormat::ButtonClutch;
+    } else {
+        mSample.buttons &= ~StreamFormat::ButtonClutch;
+    }
 }
 
-void mtsIntuitiveResearchKitUDPStreamer::EventHandlerCoag(const prmEventButton &button)
+void mtsIntuitiveResearchKitUDPStreamer::EventHandlerCoag(const prmEventButton & button)
 {
-    Coag = (button.Type() == prmEventButton::PRESSED);
+    if (button.Type() == prmEventButton::PRESSED) {
+        mSample.buttons |= StreamFormat::ButtonCoag;
+    } else {
+        mSample.buttons &= ~StreamFormat::ButtonCoag;
+    }
 }
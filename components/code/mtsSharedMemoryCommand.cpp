@@ -0,0 +1,99 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-06
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+
+#include <sawIntuitiveResearchKit/mtsSharedMemoryCommand.h>
+
+const size_t mtsSharedMemoryCommand::MaximumNumberOfValues;
+
+std::string mtsSharedMemoryCommand::RingName(const std::string & armName)
+{
+    return "/dvrk-" + armName + "-command";
+}
+
+double mtsSharedMemoryCommand::Now(void)
+{
+    // steady clock is CLOCK_MONOTONIC on Linux, same for all processes
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool mtsSharedMemoryCommand::Create(const std::string & armName, const size_t numberOfSlots)
+{
+    return mRing.Create(RingName(armName), numberOfSlots, sizeof(Data), armName);
+}
+
+int mtsSharedMemoryCommand::Poll(uint64_t & index, Data & data) const
+{
+    const int result = mRing.ReadLatest(index, &data, sizeof(Data));
+    if (result <= 0) {
+        return result;
+    }
+    // make sure all values have been sent
+    if ((data.NumberOfValues > MaximumNumberOfValues)
+        || (static_cast<size_t>(result) < offsetof(Data, Values) + data.NumberOfValues * sizeof(double))) {
+        return mtsSharedMemoryRing::BUFFER_TOO_SMALL;
+    }
+    return result;
+}
+
+bool mtsSharedMemoryCommand::Open(const std::string & armName)
+{
+    if (!mRing.Open(RingName(armName), true)) {
+        return false;
+    }
+    if (mRing.MaximumDataSize() < sizeof(Data)) {
+        mRing.Close();
+        return false;
+    }
+    return true;
+}
+
+bool mtsSharedMemoryCommand::Send(const CommandType type, const double * values, const size_t numberOfValues)
+{
+    if (numberOfValues > MaximumNumberOfValues) {
+        return false;
+    }
+    Data data;
+    data.Type = type;
+    data.NumberOfValues = static_cast<uint32_t>(numberOfValues);
+    data.Time = Now();
+    memcpy(data.Values, values, numberOfValues * sizeof(double));
+    // only send values used
+    return mRing.Write(&data, sizeof(Data) - (MaximumNumberOfValues - numberOfValues) * sizeof(double));
+}
+
+bool mtsSharedMemoryCommand::servo_jp(const double * positions, const size_t numberOfJoints)
+{
+    return Send(SERVO_JP, positions, numberOfJoints);
+}
+
+bool mtsSharedMemoryCommand::servo_jf(const double * efforts, const size_t numberOfJoints)
+{
+    return Send(SERVO_JF, efforts, numberOfJoints);
+}
+
+bool mtsSharedMemoryCommand::servo_cp(const double translation[3], const double quaternion[4])
+{
+    double values[7];
+    memcpy(values, translation, 3 * sizeof(double));
+    memcpy(values + 3, quaternion, 4 * sizeof(double));
+    return Send(SERVO_CP, values, 7);
+}
@@ -0,0 +1,365 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-04
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <sawIntuitiveResearchKit/mtsSharedMemoryRing.h>
+
+const uint32_t mtsSharedMemoryRing::Magic;
+const uint16_t mtsSharedMemoryRing::Version;
+const size_t mtsSharedMemoryRing::HeaderSize;
+const size_t mtsSharedMemoryRing::ControlSize;
+const size_t mtsSharedMemoryRing::SlotHeaderSize;
+const size_t mtsSharedMemoryRing::SourceSize;
+
+struct mtsSharedMemoryRing::Header {
+    uint32_t Magic;
+    uint16_t Version;
+    uint16_t HeaderSize;
+    uint32_t NumberOfSlots;
+    uint32_t SlotSize;
+    char Source[SourceSize];
+    uint64_t Reserved;
+};
+
+struct mtsSharedMemoryRing::Control {
+    std::atomic<uint64_t> WriteCount;
+    char Padding[56];
+};
+
+struct mtsSharedMemoryRing::Slot {
+    std::atomic<uint32_t> Sequence;
+    uint32_t Size;
+    uint64_t Index;
+};
+
+namespace {
+    // slots start on a cache line so the writer doesn't invalidate
+    // the line readers are using for the previous slot
+    const size_t CacheLineSize = 64;
+
+    inline char * SlotData(void * slot) {
+        return static_cast<char *>(slot) + mtsSharedMemoryRing::SlotHeaderSize;
+    }
+}
+
+mtsSharedMemoryRing::mtsSharedMemoryRing(void):
+    mOwner(false),
+    mWritable(false),
+    mMemory(nullptr),
+    mMemorySize(0),
+    mHeader(nullptr),
+    mControl(nullptr),
+    mNumberOfSlots(0),
+    mSlotSize(0)
+{
+    static_assert(sizeof(Header) <= HeaderSize, "mtsSharedMemoryRing header layout");
+    static_assert(sizeof(Control) == ControlSize, "mtsSharedMemoryRing control layout");
+    static_assert(sizeof(Slot) == SlotHeaderSize, "mtsSharedMemoryRing slot layout");
+}
+
+mtsSharedMemoryRing::~mtsSharedMemoryRing()
+{
+    Close();
+}
+
+bool mtsSharedMemoryRing::Fail(const std::string & what)
+{
+    mLastError = what + " \"" + mName + "\": " + strerror(errno);
+    return false;
+}
+
+bool mtsSharedMemoryRing::Map(const int fileDescriptor, const size_t size)
+{
+#ifndef _WIN32
+    const int protection = mWritable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void * memory = mmap(nullptr, size, protection, MAP_SHARED, fileDescriptor, 0);
+    if (memory == MAP_FAILED) {
+        return Fail("mmap");
+    }
+    mMemory = static_cast<char *>(memory);
+    mMemorySize = size;
+    mHeader = reinterpret_cast<Header *>(mMemory);
+    mControl = reinterpret_cast<Control *>(mMemory + HeaderSize);
+    // other writers can't modify the header, only possible if
+    // the header is a multiple of the page size
+    if (mWritable && !mOwner && (size >= HeaderSize + ControlSize)) {
+        const long pageSize = sysconf(_SC_PAGESIZE);
+        if ((pageSize > 0) && ((HeaderSize % pageSize) == 0)) {
+            mprotect(mMemory, HeaderSize, PROT_READ);
+        }
+    }
+    return true;
+#else
+    (void)fileDescriptor;
+    (void)size;
+    return false;
+#endif
+}
+
+bool mtsSharedMemoryRing::Create(const std::string & name, const size_t numberOfSlots,
+                                 const size_t maximumDataSize, const std::string & source)
+{
+    Close();
+    mName = name;
+    mOwner = true;
+    mWritable = true;
+#ifndef _WIN32
+    if (numberOfSlots == 0) {
+        mLastError = "number of slots must be strictly positive";
+        return false;
+    }
+    const size_t slotSize = ((SlotHeaderSize + maximumDataSize + CacheLineSize - 1) / CacheLineSize) * CacheLineSize;
+    const size_t size = HeaderSize + ControlSize + numberOfSlots * slotSize;
+
+    // readers still mapping a previous ring keep the old memory
+    shm_unlink(name.c_str());
+    const int fileDescriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fileDescriptor < 0) {
+        return Fail("shm_open");
+    }
+    if (ftruncate(fileDescriptor, size) != 0) {
+        Fail("ftruncate");
+        close(fileDescriptor);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    const bool mapped = Map(fileDescriptor, size);
+    close(fileDescriptor);
+    if (!mapped) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // touch all pages now, locking might fail without privileges
+    memset(mMemory, 0, size);
+    mlock(mMemory, size);
+
+    mHeader->Version = Version;
+    mHeader->HeaderSize = HeaderSize;
+    mHeader->NumberOfSlots = static_cast<uint32_t>(numberOfSlots);
+    mHeader->SlotSize = static_cast<uint32_t>(slotSize);
+    strncpy(mHeader->Source, source.c_str(), SourceSize - 1);
+    mControl->WriteCount.store(0, std::memory_order_relaxed);
+    mNumberOfSlots = numberOfSlots;
+    mSlotSize = slotSize;
+    // magic number last, readers check it first
+    std::atomic_thread_fence(std::memory_order_release);
+    mHeader->Magic = Magic;
+    return true;
+#else
+    (void)numberOfSlots;
+    (void)maximumDataSize;
+    (void)source;
+    mLastError = "shared memory is not supported on this platform";
+    return false;
+#endif
+}
+
+bool mtsSharedMemoryRing::Open(const std::string & name, const bool writable)
+{
+    Close();
+    mName = name;
+    mOwner = false;
+    mWritable = writable;
+#ifndef _WIN32
+    const int fileDescriptor = shm_open(name.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+    if (fileDescriptor < 0) {
+        return Fail("shm_open");
+    }
+    struct stat status;
+    if ((fstat(fileDescriptor, &status) != 0)
+        || (static_cast<size_t>(status.st_size) < HeaderSize + ControlSize)) {
+        close(fileDescriptor);
+        mLastError = "ring \"" + name + "\" is not initialized";
+        return false;
+    }
+    const bool mapped = Map(fileDescriptor, status.st_size);
+    close(fileDescriptor);
+    if (!mapped) {
+        return false;
+    }
+    // geometry is read once, the header might be modified later by
+    // another process mapping the ring writable
+    const uint32_t magic = mHeader->Magic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const size_t numberOfSlots = mHeader->NumberOfSlots;
+    const size_t slotSize = mHeader->SlotSize;
+    if ((magic != Magic)
+        || (mHeader->Version != Version)
+        || (mHeader->HeaderSize != HeaderSize)
+        || (numberOfSlots == 0)
+        || (slotSize < SlotHeaderSize)
+        || (HeaderSize + ControlSize + numberOfSlots * slotSize > mMemorySize)) {
+        Close();
+        mName = name;
+        mLastError = "ring \"" + name + "\" has an incompatible layout";
+        return false;
+    }
+    mNumberOfSlots = numberOfSlots;
+    mSlotSize = slotSize;
+    return true;
+#else
+    (void)writable;
+    mLastError = "shared memory is not supported on this platform";
+    return false;
+#endif
+}
+
+void mtsSharedMemoryRing::Close(void)
+{
+#ifndef _WIN32
+    if (mMemory) {
+        munmap(mMemory, mMemorySize);
+        if (mOwner) {
+            shm_unlink(mName.c_str());
+        }
+    }
+#endif
+    mMemory = nullptr;
+    mMemorySize = 0;
+    mHeader = nullptr;
+    mControl = nullptr;
+    mNumberOfSlots = 0;
+    mSlotSize = 0;
+}
+
+mtsSharedMemoryRing::Slot * mtsSharedMemoryRing::GetSlot(const uint64_t index) const
+{
+    const size_t slot = index % mNumberOfSlots;
+    return reinterpret_cast<Slot *>(mMemory + HeaderSize + ControlSize + slot * mSlotSize);
+}
+
+bool mtsSharedMemoryRing::Write(const void * data, const size_t size)
+{
+    if (!mWritable || !mHeader || (size > MaximumDataSize())) {
+        return false;
+    }
+    const uint64_t index = mControl->WriteCount.load(std::memory_order_relaxed);
+    Slot * slot = GetSlot(index);
+    const uint32_t sequence = slot->Sequence.load(std::memory_order_relaxed);
+    // odd sequence means write in progress
+    slot->Sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->Size = static_cast<uint32_t>(size);
+    slot->Index = index;
+    memcpy(SlotData(slot), data, size);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->Sequence.store(sequence + 2, std::memory_order_release);
+    mControl->WriteCount.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+uint64_t mtsSharedMemoryRing::WriteCount(void) const
+{
+    if (!mHeader) {
+        return 0;
+    }
+    return mControl->WriteCount.load(std::memory_order_acquire);
+}
+
+size_t mtsSharedMemoryRing::NumberOfSlots(void) const
+{
+    return mNumberOfSlots;
+}
+
+size_t mtsSharedMemoryRing::MaximumDataSize(void) const
+{
+    if (!mHeader) {
+        return 0;
+    }
+    return mSlotSize - SlotHeaderSize;
+}
+
+std::string mtsSharedMemoryRing::Source(void) const
+{
+    if (!mHeader) {
+        return "";
+    }
+    return std::string(mHeader->Source, strnlen(mHeader->Source, SourceSize));
+}
+
+int mtsSharedMemoryRing::Read(const uint64_t index, void * buffer, const size_t bufferSize,
+                              const size_t maxAttempts) const
+{
+    if (!mHeader) {
+        return NO_DATA;
+    }
+    const uint64_t count = mControl->WriteCount.load(std::memory_order_acquire);
+    if (index >= count) {
+        return NO_DATA;
+    }
+    if (count - index > mNumberOfSlots) {
+        return OVERRUN;
+    }
+    Slot * slot = GetSlot(index);
+    const size_t maximumDataSize = MaximumDataSize();
+    for (size_t attempt = 0; attempt < maxAttempts; ++attempt) {
+        const uint32_t before = slot->Sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        const uint64_t slotIndex = slot->Index;
+        const size_t size = std::min(static_cast<size_t>(slot->Size), maximumDataSize);
+        if (size <= bufferSize) {
+            memcpy(buffer, SlotData(slot), size);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint32_t after = slot->Sequence.load(std::memory_order_relaxed);
+        if (before != after) {
+            continue;
+        }
+        // writer has already wrapped around
+        if (slotIndex != index) {
+            return OVERRUN;
+        }
+        if (size > bufferSize) {
+            return BUFFER_TOO_SMALL;
+        }
+        return static_cast<int>(size);
+    }
+    return BUSY;
+}
+
+int mtsSharedMemoryRing::ReadLatest(uint64_t & index, void * buffer, const size_t bufferSize,
+                                    const size_t maxAttempts) const
+{
+    int result = NO_DATA;
+    for (size_t attempt = 0; attempt < maxAttempts; ++attempt) {
+        const uint64_t count = WriteCount();
+        if (count == 0) {
+            return NO_DATA;
+        }
+        index = count - 1;
+        result = Read(index, buffer, bufferSize, maxAttempts);
+        // latest slot can only be overrun if the writer wrapped around while reading
+        if (result != OVERRUN) {
+            return result;
+        }
+    }
+    return result;
+}
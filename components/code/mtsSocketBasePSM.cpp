@@ -16,6 +16,8 @@ http://www.cisst.org/cisst/license.txt.
 --- end cisst license ---
 */
 
+#include <cstring>
+
 #include <sawIntuitiveResearchKit/mtsSocketBasePSM.h>
 #include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstMultiTask/mtsManagerLocal.h>
@@ -25,12 +27,19 @@ mtsSocketBasePSM::mtsSocketBasePSM(const std::string & componentName, const doub
     mtsTaskPeriodic(componentName, periodInSeconds),
     mIsServer(isServer),
     mTimeServer(mtsComponentManager::GetInstance()->GetTimeServer()),
+    mWireFormat(mtsSocketWireFormat::PACKED),
     mPacketsLost(0),
-    mPacketsDelayed(0)
+    mPacketsDelayed(0),
+    mLastReceivedId(0),
+    mMaximumLatency(mtsIntuitiveResearchKit::SocketClockSync::MaximumLatency),
+    mClockOffset(0.0),
+    mClockDrift(0.0),
+    mRoundTripTime(0.0),
+    mPacketsStale(0)
 {
-    Command.Socket = new osaSocket(osaSocket::UDP);
+    Command.Socket = new mtsSocketTransportUDP;
     Command.IpPort = port;
-    State.Socket = new osaSocket(osaSocket::UDP);
+    State.Socket = new mtsSocketTransportUDP;
     State.IpPort = port + 1;
     IpAddress = ip;
 
@@ -39,7 +48,14 @@ mtsSocketBasePSM::mtsSocketBasePSM(const std::string & componentName, const doub
     this->StateTable.AddData(mLoopTime, "LoopTime");
     this->StateTable.AddData(Command.Data.Header.Id, "CommandId");
     this->StateTable.AddData(State.Data.Header.Id, "StateId");
-
+    mLatencyIn.SetAll(0.0);
+    mLatencyOut.SetAll(0.0);
+    this->StateTable.AddData(mClockOffset, "ClockOffset");
+    this->StateTable.AddData(mClockDrift, "ClockDrift");
+    this->StateTable.AddData(mRoundTripTime, "RoundTripTime");
+    this->StateTable.AddData(mLatencyIn, "LatencyIn");
+    this->StateTable.AddData(mLatencyOut, "LatencyOut");
+    this->StateTable.AddData(mPacketsStale, "PacketsStale");
 
     mtsInterfaceProvided * interfaceProvided = AddInterfaceProvided("System");
     if (interfaceProvided) {
@@ -47,6 +63,12 @@ mtsSocketBasePSM::mtsSocketBasePSM(const std::string & componentName, const doub
         interfaceProvided->AddCommandReadState(this->StateTable, mPacketsLost, "GetPacketsLost");
         interfaceProvided->AddCommandReadState(this->StateTable, mPacketsDelayed, "GetPacketsDelayed");
         interfaceProvided->AddCommandReadState(this->StateTable, mLoopTime, "GetLoopTime");
+        interfaceProvided->AddCommandReadState(this->StateTable, mClockOffset, "GetClockOffset");
+        interfaceProvided->AddCommandReadState(this->StateTable, mClockDrift, "GetClockDrift");
+        interfaceProvided->AddCommandReadState(this->StateTable, mRoundTripTime, "GetRoundTripTime");
+        interfaceProvided->AddCommandReadState(this->StateTable, mLatencyIn, "GetLatencyIn");
+        interfaceProvided->AddCommandReadState(this->StateTable, mLatencyOut, "GetLatencyOut");
+        interfaceProvided->AddCommandReadState(this->StateTable, mPacketsStale, "GetPacketsStale");
         if (mIsServer) {
             interfaceProvided->AddCommandReadState(this->StateTable, Command.Data.Header.Id, "GetLastReceivedPacketId");
             interfaceProvided->AddCommandReadState(this->StateTable, State.Data.Header.Id, "GetLastSentPacketId");
@@ -57,12 +79,133 @@ mtsSocketBasePSM::mtsSocketBasePSM(const std::string & componentName, const doub
     }
 }
 
+mtsSocketBasePSM::~mtsSocketBasePSM()
+{
+    delete Command.Socket;
+    delete State.Socket;
+}
+
 void mtsSocketBasePSM::Cleanup(void)
 {
     Command.Socket->Close();
     State.Socket->Close();
 }
 
+void mtsSocketBasePSM::SetWireFormat(const mtsSocketWireFormat::FormatType format)
+{
+    mWireFormat = format;
+}
+
+void mtsSocketBasePSM::SetMaximumLatency(const double latency)
+{
+    mMaximumLatency = latency;
+}
+
+void mtsSocketBasePSM::ConfigureTransport(const Json::Value & jsonConfig)
+{
+    Json::Value jsonValue;
+    mtsSocketTransport::TransportType type = mtsSocketTransport::UDP;
+    jsonValue = jsonConfig["type"];
+    if (!jsonValue.empty()) {
+        if (!mtsSocketTransport::TypeFromString(jsonValue.asString(), type)) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureTransport: " << this->GetName()
+                                     << ", invalid type \"" << jsonValue.asString()
+                                     << "\", must be \"udp\" or \"loopback\"" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    mtsSocketImpairment::Profile profile;
+    jsonValue = jsonConfig["impairment"];
+    if (!jsonValue.empty()) {
+        if (type != mtsSocketTransport::LOOPBACK) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureTransport: " << this->GetName()
+                                     << ", \"impairment\" can only be used with \"loopback\" transport" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (!mtsSocketImpairment::ProfileFromJSON(jsonValue, profile)) {
+            CMN_LOG_CLASS_INIT_ERROR << "ConfigureTransport: " << this->GetName()
+                                     << ", invalid impairment, times, bandwidth and queue-size must be positive"
+                                     << " and probabilities between 0 and 1" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (type == mtsSocketTransport::LOOPBACK) {
+        CMN_LOG_CLASS_INIT_WARNING << "ConfigureTransport: " << this->GetName()
+                                   << " is using the in process loopback transport" << std::endl;
+        delete Command.Socket;
+        delete State.Socket;
+        Command.Socket = new mtsSocketTransportLoopback(profile);
+        State.Socket = new mtsSocketTransportLoopback(profile);
+    }
+}
+
+bool mtsSocketBasePSM::IsStale(const socketHeader & header)
+{
+    if (!mClockSync.Valid()) {
+        return false;
+    }
+    if (mClockSync.Latency(header.Timestamp, mTimeServer.GetRelativeTime()) > mMaximumLatency) {
+        mPacketsStale++;
+        return true;
+    }
+    return false;
+}
+
+int mtsSocketBasePSM::ReceiveLatest(mtsSocketTransport * socket, char * buffer)
+{
+    int bytesRead = socket->Receive(buffer, BUFFER_SIZE, TIMEOUT);
+    if (bytesRead <= 0) {
+        return bytesRead;
+    }
+
+    // dequeue all the datagrams and only use the latest one
+    int readCounter = 0;
+    int dataLeft = socket->Receive(mReceiveBuffer, BUFFER_SIZE, 0);
+    while (dataLeft > 0) {
+        memcpy(buffer, mReceiveBuffer, dataLeft);
+        bytesRead = dataLeft;
+        readCounter++;
+        dataLeft = socket->Receive(mReceiveBuffer, BUFFER_SIZE, 0);
+    }
+
+    if (readCounter > 0) {
+        CMN_LOG_CLASS_RUN_DEBUG << "ReceiveLatest: catching up, skipped "
+                                << readCounter << " datagram(s)" << std::endl;
+    }
+    return bytesRead;
+}
+
+void mtsSocketBasePSM::PublishDisplaySnapshot(void)
+{
+    if (mDisplaySnapshot.Requested()) {
+        UpdateDisplaySnapshot(mDisplayData);
+        mDisplaySnapshot.Write(mDisplayData);
+    }
+}
+
+void mtsSocketBasePSM::UpdateDisplaySnapshot(mtsSocketBasePSMDisplayData & data)
+{
+    // same as read commands GetLastSentPacketId and GetLastReceivedPacketId
+    if (mIsServer) {
+        data.LastSentPacketId = State.Data.Header.Id;
+        data.LastReceivedPacketId = Command.Data.Header.Id;
+    } else {
+        data.LastSentPacketId = Command.Data.Header.Id;
+        data.LastReceivedPacketId = State.Data.Header.Id;
+    }
+    data.PacketsLost = mPacketsLost;
+    data.PacketsDelayed = mPacketsDelayed;
+    data.PacketsStale = mPacketsStale;
+    data.LoopTime = mLoopTime;
+    data.ClockOffset = mClockOffset;
+    data.ClockDrift = mClockDrift;
+    data.RoundTripTime = mRoundTripTime;
+    data.LatencyIn.Assign(mLatencyIn);
+    data.LatencyOut.Assign(mLatencyOut);
+}
+
 void mtsSocketBasePSM::UpdateStatistics(void)
 {
     int deltaPacket = 1;
@@ -95,4 +238,28 @@ void mtsSocketBasePSM::UpdateStatistics(void)
     } else if (deltaPacket > 1) {
         mPacketsLost += (deltaPacket - 1);
     }
+
+    // clock offset, one sample per new message received
+    const socketHeader & received = mIsServer ? Command.Data.Header : State.Data.Header;
+    if (received.Id == mLastReceivedId) {
+        return;
+    }
+    if (received.Id == 1) {
+        // peer restarted
+        mClockSync.Reset();
+        mPacketsStale = 0;
+    }
+    mLastReceivedId = received.Id;
+    if (mClockSync.AddSample(received.LastTimestamp, received.Timestamp,
+                             mTimeServer.GetRelativeTime())) {
+        mClockOffset = mClockSync.Offset(mTimeServer.GetRelativeTime());
+        mClockDrift = mClockSync.Drift();
+        mRoundTripTime = mClockSync.RoundTripTime();
+        // distributions don't need to be updated every cycle
+        if ((mClockSync.NumberOfSamples() % mtsIntuitiveResearchKit::SocketClockSync::LatencyUpdate) == 0) {
+            mClockSync.ComputeDistributions();
+            mLatencyIn.Assign(mClockSync.LatencyIn());
+            mLatencyOut.Assign(mClockSync.LatencyOut());
+        }
+    }
 }
@@ -0,0 +1,852 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-24
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#include <algorithm>
+
+#include <sawIntuitiveResearchKit/mtsSocketBridge.h>
+#include <cisstMultiTask/mtsInterfaceProvided.h>
+#include <cisstMultiTask/mtsInterfaceRequired.h>
+
+CMN_IMPLEMENT_SERVICES_DERIVED(mtsSocketBridge, mtsTaskPeriodic);
+
+mtsSocketBridge::Channel::Channel(mtsSocketBridge * bridge, const std::string & name,
+                                  const mtsSocketWireFormat::ChannelType type):
+    mBridge(bridge),
+    mName(name),
+    mType(type),
+    mCurrentState(socketMessages::SCK_UNINITIALIZED),
+    mDesiredState(socketMessages::SCK_UNINITIALIZED),
+    mPreviousState(socketMessages::SCK_UNINITIALIZED),
+    mGoalReached(false),
+    mGoalActive(false),
+    mGoalId(0)
+{
+}
+
+void mtsSocketBridge::Channel::AddFunctions(mtsInterfaceRequired * interfaceRequired)
+{
+    interfaceRequired->AddFunction("operating_state", operating_state_function);
+    interfaceRequired->AddFunction("state_command", state_command_function);
+    interfaceRequired->AddFunction("Freeze", freeze_function, MTS_OPTIONAL);
+}
+
+void mtsSocketBridge::Channel::GoalReachedEventHandler(const bool & reached)
+{
+    mGoalReached = reached;
+}
+
+void mtsSocketBridge::Channel::AddCommands(mtsInterfaceProvided * interfaceProvided, mtsStateTable & stateTable)
+{
+    stateTable.AddData(m_operating_state, mName + "/operating_state");
+    interfaceProvided->AddMessageEvents();
+    interfaceProvided->AddCommandReadState(stateTable, m_operating_state, "operating_state");
+    interfaceProvided->AddCommandVoid(&Channel::Freeze, this, "Freeze");
+    interfaceProvided->AddCommandWrite(&Channel::state_command, this, "state_command");
+    interfaceProvided->AddEventWrite(operating_state_event, "operating_state", m_operating_state);
+    interfaceProvided->AddEventWrite(goal_reached_event, "goal_reached", bool());
+}
+
+void mtsSocketBridge::Channel::state_command(const std::string & state)
+{
+    if (state == "disable") {
+        mDesiredState = socketMessages::SCK_UNINITIALIZED;
+    } else if ((state == "enable") || (state == "home")) {
+        mDesiredState = socketMessages::SCK_HOMED;
+    } else {
+        CMN_LOG_RUN_WARNING << "mtsSocketBridge: " << mName << ", state command \""
+                            << state << "\" not supported" << std::endl;
+    }
+}
+
+void mtsSocketBridge::Channel::Freeze(void)
+{
+    // server freezes arm when leaving a mode
+    if (mDesiredState > socketMessages::SCK_HOMED) {
+        mDesiredState = socketMessages::SCK_HOMED;
+    }
+}
+
+void mtsSocketBridge::Channel::UpdateCurrentState(void)
+{
+    operating_state_function(m_operating_state);
+    if (m_operating_state.State() != prmOperatingState::ENABLED) {
+        mCurrentState = socketMessages::SCK_UNINITIALIZED;
+    } else if (m_operating_state.IsHomed()) {
+        if (mCurrentState < socketMessages::SCK_HOMED) {
+            mCurrentState = socketMessages::SCK_HOMED;
+        }
+    } else {
+        mCurrentState = socketMessages::SCK_HOMING;
+    }
+}
+
+void mtsSocketBridge::Channel::ExecuteStateCommand(const socketMessages::StateType desired)
+{
+    if (mDesiredState != desired) {
+        mDesiredState = desired;
+        switch (mDesiredState) {
+        case socketMessages::SCK_UNINITIALIZED:
+            state_command_function(std::string("disable"));
+            break;
+        case socketMessages::SCK_HOMING:
+            CMN_LOG_RUN_WARNING << "mtsSocketBridge: " << mName << ", state "
+                                << mDesiredState << " not supported" << std::endl;
+            break;
+        default:
+            if ((mDesiredState != socketMessages::SCK_HOMED)
+                && !IsModeSupported(mDesiredState)) {
+                CMN_LOG_RUN_WARNING << "mtsSocketBridge: " << mName << ", state "
+                                    << mDesiredState << " not supported" << std::endl;
+                break;
+            }
+            if (mCurrentState == socketMessages::SCK_UNINITIALIZED) {
+                state_command_function(std::string("enable"));
+                state_command_function(std::string("home"));
+            }
+            // leaving a mode
+            if ((mDesiredState == socketMessages::SCK_HOMED)
+                && (mCurrentState > socketMessages::SCK_HOMED)) {
+                if (freeze_function.IsValid()) {
+                    freeze_function();
+                }
+                mCurrentState = socketMessages::SCK_HOMED;
+            }
+            break;
+        }
+    }
+
+    // enter or switch mode once the arm is homed
+    if ((mCurrentState >= socketMessages::SCK_HOMED)
+        && (mDesiredState > socketMessages::SCK_HOMED)
+        && (mCurrentState != mDesiredState)
+        && IsModeSupported(mDesiredState)) {
+        mCurrentState = mDesiredState;
+        mGoalReached = false;
+    }
+}
+
+void mtsSocketBridge::Channel::UpdateOperatingState(const socketMessages::StateType state)
+{
+    mPreviousState = mCurrentState;
+    mCurrentState = state;
+    if (mCurrentState == mPreviousState) {
+        return;
+    }
+    switch (mCurrentState) {
+    case socketMessages::SCK_UNINITIALIZED:
+        m_operating_state.State() = prmOperatingState::DISABLED;
+        m_operating_state.IsHomed() = false;
+        break;
+    case socketMessages::SCK_HOMING:
+        m_operating_state.State() = prmOperatingState::ENABLED;
+        m_operating_state.IsHomed() = false;
+        break;
+    default:
+        // homed or any mode
+        m_operating_state.State() = prmOperatingState::ENABLED;
+        m_operating_state.IsHomed() = true;
+        break;
+    }
+    operating_state_event(m_operating_state);
+}
+
+void mtsSocketBridge::Channel::NewGoal(void)
+{
+    mGoalActive = true;
+    mGoalId = 0;
+}
+
+void mtsSocketBridge::Channel::SetGoalId(const socketHeader & header)
+{
+    // first command sent with the new goal
+    if (mGoalActive && (mGoalId == 0)) {
+        mGoalId = header.Id;
+    }
+}
+
+void mtsSocketBridge::Channel::CheckGoalReached(const socketHeader & header, const bool reached)
+{
+    if (mGoalActive
+        && (mGoalId != 0)
+        && (header.LastId >= mGoalId)
+        && reached) {
+        mGoalActive = false;
+        goal_reached_event(true);
+    }
+}
+
+// PSM, cartesian position mode only
+mtsSocketBridge::ChannelPSM::ChannelPSM(mtsSocketBridge * bridge, const std::string & name):
+    Channel(bridge, name, mtsSocketWireFormat::CHANNEL_PSM)
+{
+    m_jaw_measured_js.Position().SetSize(1);
+    m_jaw_measured_js.Position().SetAll(0.0);
+    m_jaw_servo_jp.Goal().SetSize(1);
+}
+
+bool mtsSocketBridge::ChannelPSM::IsModeSupported(const socketMessages::StateType state) const
+{
+    return (state == socketMessages::SCK_CART_POS);
+}
+
+void mtsSocketBridge::ChannelPSM::AddFunctions(mtsInterfaceRequired * interfaceRequired)
+{
+    Channel::AddFunctions(interfaceRequired);
+    interfaceRequired->AddFunction("measured_cp", measured_cp);
+    interfaceRequired->AddFunction("servo_cp", servo_cp_function);
+    interfaceRequired->AddFunction("jaw/servo_jp", jaw_servo_jp_function, MTS_OPTIONAL);
+}
+
+size_t mtsSocketBridge::ChannelPSM::EncodeState(const socketHeader & header, char * buffer, const size_t bufferSize)
+{
+    measured_cp(m_measured_cp);
+    mState.CurrentPose.Assign(m_measured_cp.Position());
+    UpdateCurrentState();
+    mState.RobotControlState = mCurrentState;
+    mState.Header = header;
+    return mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, mState, buffer, bufferSize);
+}
+
+bool mtsSocketBridge::ChannelPSM::DecodeCommand(const char * buffer, const size_t size)
+{
+    if (!mtsSocketWireFormat::Decode(buffer, size, mCommand)) {
+        return false;
+    }
+    mCommand.GoalPose.NormalizedSelf();
+    return true;
+}
+
+void mtsSocketBridge::ChannelPSM::ExecuteCommands(const bool stale)
+{
+    ExecuteStateCommand(mCommand.RobotControlState);
+
+    // only send when in cartesian mode and command is recent enough
+    if ((mCurrentState == socketMessages::SCK_CART_POS) && !stale) {
+        m_servo_cp.Goal().From(mCommand.GoalPose);
+        servo_cp_function(m_servo_cp);
+        if (jaw_servo_jp_function.IsValid()) {
+            m_jaw_servo_jp.Goal().Element(0) = mCommand.GoalJaw;
+            jaw_servo_jp_function(m_jaw_servo_jp);
+        }
+    }
+}
+
+void mtsSocketBridge::ChannelPSM::AddCommands(mtsInterfaceProvided * interfaceProvided, mtsStateTable & stateTable)
+{
+    stateTable.AddData(m_measured_cp, mName + "/measured_cp");
+    stateTable.AddData(m_jaw_measured_js, mName + "/jaw/measured_js");
+    Channel::AddCommands(interfaceProvided, stateTable);
+    interfaceProvided->AddCommandReadState(stateTable, m_measured_cp, "measured_cp");
+    interfaceProvided->AddCommandReadState(stateTable, m_jaw_measured_js, "jaw/measured_js");
+    interfaceProvided->AddCommandWrite(&ChannelPSM::servo_cp, this, "servo_cp");
+    interfaceProvided->AddCommandWrite(&ChannelPSM::jaw_servo_jp, this, "jaw/servo_jp");
+}
+
+size_t mtsSocketBridge::ChannelPSM::EncodeCommand(const socketHeader & header, char * buffer, const size_t bufferSize)
+{
+    mCommand.Header = header;
+    mCommand.RobotControlState = mDesiredState;
+    return mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, mCommand, buffer, bufferSize);
+}
+
+bool mtsSocketBridge::ChannelPSM::DecodeState(const char * buffer, const size_t size)
+{
+    if (!mtsSocketWireFormat::Decode(buffer, size, mState)) {
+        return false;
+    }
+    mState.CurrentPose.NormalizedSelf();
+    return true;
+}
+
+void mtsSocketBridge::ChannelPSM::UpdateApplication(void)
+{
+    UpdateOperatingState(mState.RobotControlState);
+    m_measured_cp.Valid() = (mCurrentState >= socketMessages::SCK_HOMED);
+    m_measured_cp.Position().FromNormalized(mState.CurrentPose);
+    m_jaw_measured_js.Position().at(0) = mState.CurrentJaw;
+}
+
+void mtsSocketBridge::ChannelPSM::state_command(const std::string & state)
+{
+    Channel::state_command(state);
+    mCommand.GoalPose.From(mState.CurrentPose);
+    mCommand.GoalJaw = mState.CurrentJaw;
+}
+
+void mtsSocketBridge::ChannelPSM::Freeze(void)
+{
+    mDesiredState = socketMessages::SCK_CART_POS;
+    mCommand.GoalPose.From(mState.CurrentPose);
+    mCommand.GoalJaw = mState.CurrentJaw;
+}
+
+void mtsSocketBridge::ChannelPSM::servo_cp(const prmPositionCartesianSet & position)
+{
+    mDesiredState = socketMessages::SCK_CART_POS;
+    mCommand.GoalPose.From(position.Goal());
+}
+
+void mtsSocketBridge::ChannelPSM::jaw_servo_jp(const prmPositionJointSet & position)
+{
+    mDesiredState = socketMessages::SCK_CART_POS;
+    mCommand.GoalJaw = position.Goal().at(0);
+}
+
+// MTM, trajectory and effort modes used by tele-operation
+mtsSocketBridge::ChannelMTM::ChannelMTM(mtsSocketBridge * bridge, const std::string & name):
+    Channel(bridge, name, mtsSocketWireFormat::CHANNEL_MTM),
+    mLockOrientation(false),
+    mGravityCompensation(false),
+    mWrenchOrientationAbsolute(false)
+{
+    m_gripper_measured_js.Position().SetSize(1);
+    m_gripper_measured_js.Position().SetAll(0.0);
+    m_measured_cv.SetVelocityLinear(vct3(0.0));
+    m_measured_cv.SetVelocityAngular(vct3(0.0));
+}
+
+bool mtsSocketBridge::ChannelMTM::IsModeSupported(const socketMessages::StateType state) const
+{
+    return ((state == socketMessages::SCK_CART_TRAJ)
+            || (state == socketMessages::SCK_CART_EFFORT));
+}
+
+void mtsSocketBridge::ChannelMTM::AddFunctions(mtsInterfaceRequired * interfaceRequired)
+{
+    Channel::AddFunctions(interfaceRequired);
+    interfaceRequired->AddFunction("measured_cp", mArm.measured_cp);
+    interfaceRequired->AddFunction("setpoint_cp", mArm.setpoint_cp);
+    interfaceRequired->AddFunction("measured_cv", mArm.measured_cv);
+    interfaceRequired->AddFunction("gripper/measured_js", mArm.gripper_measured_js, MTS_OPTIONAL);
+    interfaceRequired->AddFunction("move_cp", mArm.move_cp);
+    interfaceRequired->AddFunction("body/servo_cf", mArm.body_servo_cf);
+    interfaceRequired->AddFunction("lock_orientation", mArm.lock_orientation, MTS_OPTIONAL);
+    interfaceRequired->AddFunction("unlock_orientation", mArm.unlock_orientation, MTS_OPTIONAL);
+    interfaceRequired->AddFunction("use_gravity_compensation", mArm.use_gravity_compensation);
+    interfaceRequired->AddFunction("body/set_cf_orientation_absolute", mArm.body_set_cf_orientation_absolute, MTS_OPTIONAL);
+    interfaceRequired->AddEventHandlerWrite(&Channel::GoalReachedEventHandler,
+                                            static_cast<Channel *>(this), "goal_reached");
+}
+
+size_t mtsSocketBridge::ChannelMTM::EncodeState(const socketHeader & header, char * buffer, const size_t bufferSize)
+{
+    mArm.measured_cp(m_measured_cp);
+    mArm.setpoint_cp(m_setpoint_cp);
+    mArm.measured_cv(m_measured_cv);
+    mState.MeasuredPose.Assign(m_measured_cp.Position());
+    mState.SetpointPose.Assign(m_setpoint_cp.Position());
+    mState.MeasuredTwist.Ref<3>(0).Assign(m_measured_cv.VelocityLinear());
+    mState.MeasuredTwist.Ref<3>(3).Assign(m_measured_cv.VelocityAngular());
+    if (mArm.gripper_measured_js.IsValid()) {
+        mArm.gripper_measured_js(m_gripper_measured_js);
+        if (m_gripper_measured_js.Position().size() > 0) {
+            mState.Gripper = m_gripper_measured_js.Position().at(0);
+        }
+    }
+    UpdateCurrentState();
+    mState.RobotControlState = mCurrentState;
+    mState.GoalReached = mGoalReached;
+    mState.Header = header;
+    return mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, mState, buffer, bufferSize);
+}
+
+bool mtsSocketBridge::ChannelMTM::DecodeCommand(const char * buffer, const size_t size)
+{
+    if (!mtsSocketWireFormat::Decode(buffer, size, mCommand)) {
+        return false;
+    }
+    mCommand.GoalPose.NormalizedSelf();
+    mCommand.Orientation.NormalizedSelf();
+    return true;
+}
+
+void mtsSocketBridge::ChannelMTM::ExecuteCommands(const bool stale)
+{
+    ExecuteStateCommand(mCommand.RobotControlState);
+    const bool newMode = (mCurrentState != mPreviousState);
+    mPreviousState = mCurrentState;
+    if (stale || (mCurrentState < socketMessages::SCK_HOMED)) {
+        return;
+    }
+
+    // settings are only sent when they change
+    if (mCommand.GravityCompensation != mGravityCompensation) {
+        mGravityCompensation = mCommand.GravityCompensation;
+        mArm.use_gravity_compensation(mGravityCompensation);
+    }
+    if ((mCommand.WrenchOrientationAbsolute != mWrenchOrientationAbsolute)
+        && mArm.body_set_cf_orientation_absolute.IsValid()) {
+        mWrenchOrientationAbsolute = mCommand.WrenchOrientationAbsolute;
+        mArm.body_set_cf_orientation_absolute(mWrenchOrientationAbsolute);
+    }
+    if (mArm.lock_orientation.IsValid() && mArm.unlock_orientation.IsValid()) {
+        if (mCommand.LockOrientation) {
+            if (!mLockOrientation || !mOrientation.Equal(mCommand.Orientation)) {
+                mLockOrientation = true;
+                mOrientation.Assign(mCommand.Orientation);
+                mArm.lock_orientation(mOrientation);
+            }
+        } else if (mLockOrientation) {
+            mLockOrientation = false;
+            mArm.unlock_orientation();
+        }
+    }
+
+    switch (mCurrentState) {
+    case socketMessages::SCK_CART_TRAJ:
+        // client keeps sending the same goal, only start a new
+        // trajectory when the goal changes
+        if (newMode || !mGoalPose.Equal(mCommand.GoalPose)) {
+            mGoalPose.Assign(mCommand.GoalPose);
+            mGoalReached = false;
+            m_move_cp.Goal().From(mGoalPose);
+            mArm.move_cp(m_move_cp);
+        }
+        break;
+    case socketMessages::SCK_CART_EFFORT:
+        m_body_servo_cf.Force().Assign(mCommand.Wrench);
+        mArm.body_servo_cf(m_body_servo_cf);
+        break;
+    default:
+        break;
+    }
+}
+
+void mtsSocketBridge::ChannelMTM::AddCommands(mtsInterfaceProvided * interfaceProvided, mtsStateTable & stateTable)
+{
+    stateTable.AddData(m_measured_cp, mName + "/measured_cp");
+    stateTable.AddData(m_setpoint_cp, mName + "/setpoint_cp");
+    stateTable.AddData(m_measured_cv, mName + "/measured_cv");
+    stateTable.AddData(m_gripper_measured_js, mName + "/gripper/measured_js");
+    Channel::AddCommands(interfaceProvided, stateTable);
+    interfaceProvided->AddCommandReadState(stateTable, m_measured_cp, "measured_cp");
+    interfaceProvided->AddCommandReadState(stateTable, m_setpoint_cp, "setpoint_cp");
+    interfaceProvided->AddCommandReadState(stateTable, m_measured_cv, "measured_cv");
+    interfaceProvided->AddCommandReadState(stateTable, m_gripper_measured_js, "gripper/measured_js");
+    interfaceProvided->AddCommandWrite(&ChannelMTM::move_cp, this, "move_cp");
+    interfaceProvided->AddCommandWrite(&ChannelMTM::body_servo_cf, this, "body/servo_cf");
+    interfaceProvided->AddCommandWrite(&ChannelMTM::lock_orientation, this, "lock_orientation");
+    interfaceProvided->AddCommandVoid(&ChannelMTM::unlock_orientation, this, "unlock_orientation");
+    interfaceProvided->AddCommandWrite(&ChannelMTM::use_gravity_compensation, this, "use_gravity_compensation");
+    interfaceProvided->AddCommandWrite(&ChannelMTM::body_set_cf_orientation_absolute, this,
+                                       "body/set_cf_orientation_absolute");
+}
+
+size_t mtsSocketBridge::ChannelMTM::EncodeCommand(const socketHeader & header, char * buffer, const size_t bufferSize)
+{
+    SetGoalId(header);
+    mCommand.Header = header;
+    mCommand.RobotControlState = mDesiredState;
+    return mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, mCommand, buffer, bufferSize);
+}
+
+bool mtsSocketBridge::ChannelMTM::DecodeState(const char * buffer, const size_t size)
+{
+    if (!mtsSocketWireFormat::Decode(buffer, size, mState)) {
+        return false;
+    }
+    mState.MeasuredPose.NormalizedSelf();
+    mState.SetpointPose.NormalizedSelf();
+    return true;
+}
+
+void mtsSocketBridge::ChannelMTM::UpdateApplication(void)
+{
+    UpdateOperatingState(mState.RobotControlState);
+    const bool valid = (mCurrentState >= socketMessages::SCK_HOMED);
+    m_measured_cp.Valid() = valid;
+    m_measured_cp.Position().FromNormalized(mState.MeasuredPose);
+    m_setpoint_cp.Valid() = valid;
+    m_setpoint_cp.Position().FromNormalized(mState.SetpointPose);
+    m_measured_cv.VelocityLinear().Assign(mState.MeasuredTwist.Ref<3>(0));
+    m_measured_cv.VelocityAngular().Assign(mState.MeasuredTwist.Ref<3>(3));
+    m_measured_cv.SetValid(valid);
+    m_gripper_measured_js.Position().at(0) = mState.Gripper;
+    CheckGoalReached(mState.Header, mState.GoalReached);
+}
+
+void mtsSocketBridge::ChannelMTM::move_cp(const prmPositionCartesianSet & position)
+{
+    mDesiredState = socketMessages::SCK_CART_TRAJ;
+    mCommand.GoalPose.From(position.Goal());
+    NewGoal();
+}
+
+void mtsSocketBridge::ChannelMTM::body_servo_cf(const prmForceCartesianSet & wrench)
+{
+    mDesiredState = socketMessages::SCK_CART_EFFORT;
+    mCommand.Wrench.Assign(wrench.Force());
+}
+
+void mtsSocketBridge::ChannelMTM::lock_orientation(const vctMatRot3 & orientation)
+{
+    mCommand.LockOrientation = true;
+    mCommand.Orientation.Assign(orientation);
+}
+
+void mtsSocketBridge::ChannelMTM::unlock_orientation(void)
+{
+    mCommand.LockOrientation = false;
+}
+
+void mtsSocketBridge::ChannelMTM::use_gravity_compensation(const bool & gravity)
+{
+    mCommand.GravityCompensation = gravity;
+}
+
+void mtsSocketBridge::ChannelMTM::body_set_cf_orientation_absolute(const bool & absolute)
+{
+    mCommand.WrenchOrientationAbsolute = absolute;
+}
+
+// ECM, joint modes used by tele-operation
+mtsSocketBridge::ChannelECM::ChannelECM(mtsSocketBridge * bridge, const std::string & name):
+    Channel(bridge, name, mtsSocketWireFormat::CHANNEL_ECM),
+    mGoalJoints(0.0)
+{
+    m_measured_js.Position().SetSize(4);
+    m_measured_js.Position().SetAll(0.0);
+    m_setpoint_js.Position().SetSize(4);
+    m_setpoint_js.Position().SetAll(0.0);
+    m_setpoint_jp.Goal().SetSize(4);
+}
+
+bool mtsSocketBridge::ChannelECM::IsModeSupported(const socketMessages::StateType state) const
+{
+    return ((state == socketMessages::SCK_JNT_POS)
+            || (state == socketMessages::SCK_JNT_TRAJ));
+}
+
+void mtsSocketBridge::ChannelECM::AddFunctions(mtsInterfaceRequired * interfaceRequired)
+{
+    Channel::AddFunctions(interfaceRequired);
+    interfaceRequired->AddFunction("measured_cp", mArm.measured_cp);
+    interfaceRequired->AddFunction("setpoint_cp", mArm.setpoint_cp);
+    interfaceRequired->AddFunction("measured_js", mArm.measured_js);
+    interfaceRequired->AddFunction("setpoint_js", mArm.setpoint_js);
+    interfaceRequired->AddFunction("servo_jp", mArm.servo_jp);
+    interfaceRequired->AddFunction("move_jp", mArm.move_jp);
+    interfaceRequired->AddEventHandlerWrite(&Channel::GoalReachedEventHandler,
+                                            static_cast<Channel *>(this), "goal_reached");
+}
+
+size_t mtsSocketBridge::ChannelECM::EncodeState(const socketHeader & header, char * buffer, const size_t bufferSize)
+{
+    mArm.measured_cp(m_measured_cp);
+    mArm.setpoint_cp(m_setpoint_cp);
+    mArm.measured_js(m_measured_js);
+    mArm.setpoint_js(m_setpoint_js);
+    mState.MeasuredPose.Assign(m_measured_cp.Position());
+    mState.SetpointPose.Assign(m_setpoint_cp.Position());
+    // ECM has 4 joints, extra joints are not sent
+    const size_t measured = std::min(m_measured_js.Position().size(), mState.MeasuredJoints.size());
+    for (size_t index = 0; index < measured; ++index) {
+        mState.MeasuredJoints.Element(index) = m_measured_js.Position().Element(index);
+    }
+    const size_t setpoint = std::min(m_setpoint_js.Position().size(), mState.SetpointJoints.size());
+    for (size_t index = 0; index < setpoint; ++index) {
+        mState.SetpointJoints.Element(index) = m_setpoint_js.Position().Element(index);
+    }
+    UpdateCurrentState();
+    mState.RobotControlState = mCurrentState;
+    mState.GoalReached = mGoalReached;
+    mState.Header = header;
+    return mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, mState, buffer, bufferSize);
+}
+
+bool mtsSocketBridge::ChannelECM::DecodeCommand(const char * buffer, const size_t size)
+{
+    return mtsSocketWireFormat::Decode(buffer, size, mCommand);
+}
+
+void mtsSocketBridge::ChannelECM::ExecuteCommands(const bool stale)
+{
+    ExecuteStateCommand(mCommand.RobotControlState);
+    const bool newMode = (mCurrentState != mPreviousState);
+    mPreviousState = mCurrentState;
+    if (stale) {
+        return;
+    }
+
+    switch (mCurrentState) {
+    case socketMessages::SCK_JNT_POS:
+        m_setpoint_jp.Goal().Assign(mCommand.GoalJoints);
+        mArm.servo_jp(m_setpoint_jp);
+        break;
+    case socketMessages::SCK_JNT_TRAJ:
+        if (newMode || !mGoalJoints.Equal(mCommand.GoalJoints)) {
+            mGoalJoints.Assign(mCommand.GoalJoints);
+            mGoalReached = false;
+            m_setpoint_jp.Goal().Assign(mGoalJoints);
+            mArm.move_jp(m_setpoint_jp);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void mtsSocketBridge::ChannelECM::AddCommands(mtsInterfaceProvided * interfaceProvided, mtsStateTable & stateTable)
+{
+    stateTable.AddData(m_measured_cp, mName + "/measured_cp");
+    stateTable.AddData(m_setpoint_cp, mName + "/setpoint_cp");
+    stateTable.AddData(m_measured_js, mName + "/measured_js");
+    stateTable.AddData(m_setpoint_js, mName + "/setpoint_js");
+    Channel::AddCommands(interfaceProvided, stateTable);
+    interfaceProvided->AddCommandReadState(stateTable, m_measured_cp, "measured_cp");
+    interfaceProvided->AddCommandReadState(stateTable, m_setpoint_cp, "setpoint_cp");
+    interfaceProvided->AddCommandReadState(stateTable, m_measured_js, "measured_js");
+    interfaceProvided->AddCommandReadState(stateTable, m_setpoint_js, "setpoint_js");
+    interfaceProvided->AddCommandWrite(&ChannelECM::servo_jp, this, "servo_jp");
+    interfaceProvided->AddCommandWrite(&ChannelECM::move_jp, this, "move_jp");
+}
+
+size_t mtsSocketBridge::ChannelECM::EncodeCommand(const socketHeader & header, char * buffer, const size_t bufferSize)
+{
+    SetGoalId(header);
+    mCommand.Header = header;
+    mCommand.RobotControlState = mDesiredState;
+    return mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, mCommand, buffer, bufferSize);
+}
+
+bool mtsSocketBridge::ChannelECM::DecodeState(const char * buffer, const size_t size)
+{
+    if (!mtsSocketWireFormat::Decode(buffer, size, mState)) {
+        return false;
+    }
+    mState.MeasuredPose.NormalizedSelf();
+    mState.SetpointPose.NormalizedSelf();
+    return true;
+}
+
+void mtsSocketBridge::ChannelECM::UpdateApplication(void)
+{
+    UpdateOperatingState(mState.RobotControlState);
+    const bool valid = (mCurrentState >= socketMessages::SCK_HOMED);
+    m_measured_cp.Valid() = valid;
+    m_measured_cp.Position().FromNormalized(mState.MeasuredPose);
+    m_setpoint_cp.Valid() = valid;
+    m_setpoint_cp.Position().FromNormalized(mState.SetpointPose);
+    m_measured_js.Position().Assign(mState.MeasuredJoints);
+    m_setpoint_js.Position().Assign(mState.SetpointJoints);
+    CheckGoalReached(mState.Header, mState.GoalReached);
+}
+
+bool mtsSocketBridge::ChannelECM::SetGoalJoints(const prmPositionJointSet & position)
+{
+    if (position.Goal().size() != mCommand.GoalJoints.size()) {
+        CMN_LOG_RUN_ERROR << "mtsSocketBridge: " << mName << ", expected "
+                          << mCommand.GoalJoints.size() << " joints, got "
+                          << position.Goal().size() << std::endl;
+        return false;
+    }
+    mCommand.GoalJoints.Assign(position.Goal());
+    return true;
+}
+
+void mtsSocketBridge::ChannelECM::servo_jp(const prmPositionJointSet & position)
+{
+    if (SetGoalJoints(position)) {
+        mDesiredState = socketMessages::SCK_JNT_POS;
+    }
+}
+
+void mtsSocketBridge::ChannelECM::move_jp(const prmPositionJointSet & position)
+{
+    if (SetGoalJoints(position)) {
+        mDesiredState = socketMessages::SCK_JNT_TRAJ;
+        NewGoal();
+    }
+}
+
+mtsSocketBridge::mtsSocketBridge(const std::string & componentName, const double periodInSeconds,
+                                 const std::string & ip, const unsigned int port,
+                                 const bool isServer):
+    mtsSocketBasePSM(componentName, periodInSeconds, ip, port, isServer),
+    mStateSize(mtsSocketWireFormat::BridgeHeaderSize),
+    mCommandSize(mtsSocketWireFormat::BridgeHeaderSize)
+{
+    // bridge only uses packed format
+    mWireFormat = mtsSocketWireFormat::PACKED;
+}
+
+mtsSocketBridge::~mtsSocketBridge()
+{
+    for (auto channel : mChannels) {
+        delete channel;
+    }
+}
+
+bool mtsSocketBridge::AddArm(const std::string & name,
+                             const mtsSocketWireFormat::ChannelType type)
+{
+    for (auto channel : mChannels) {
+        if (channel->mName == name) {
+            CMN_LOG_CLASS_INIT_ERROR << "AddArm: " << this->GetName()
+                                     << ", arm \"" << name << "\" already added" << std::endl;
+            return false;
+        }
+    }
+    const size_t stateSize = mStateSize + mtsSocketWireFormat::BridgeChannelStateSize(type);
+    const size_t commandSize = mCommandSize + mtsSocketWireFormat::BridgeChannelCommandSize(type);
+    if ((stateSize > BUFFER_SIZE) || (commandSize > BUFFER_SIZE)) {
+        CMN_LOG_CLASS_INIT_ERROR << "AddArm: " << this->GetName()
+                                 << ", can't add \"" << name << "\", datagrams would exceed "
+                                 << BUFFER_SIZE << " bytes" << std::endl;
+        return false;
+    }
+
+    Channel * channel;
+    switch (type) {
+    case mtsSocketWireFormat::CHANNEL_MTM:
+        channel = new ChannelMTM(this, name);
+        break;
+    case mtsSocketWireFormat::CHANNEL_ECM:
+        channel = new ChannelECM(this, name);
+        break;
+    default:
+        channel = new ChannelPSM(this, name);
+        break;
+    }
+    if (mIsServer) {
+        mtsInterfaceRequired * interfaceRequired = AddInterfaceRequired(name);
+        if (!interfaceRequired) {
+            delete channel;
+            return false;
+        }
+        channel->AddFunctions(interfaceRequired);
+    } else {
+        mtsInterfaceProvided * interfaceProvided = AddInterfaceProvided(name);
+        if (!interfaceProvided) {
+            delete channel;
+            return false;
+        }
+        channel->AddCommands(interfaceProvided, this->StateTable);
+    }
+    mChannels.push_back(channel);
+    mStateSize = stateSize;
+    mCommandSize = commandSize;
+    return true;
+}
+
+void mtsSocketBridge::Configure(const std::string & CMN_UNUSED(fileName))
+{
+    if (mIsServer) {
+        State.Socket->SetDestination(IpAddress, State.IpPort);
+        Command.Socket->AssignPort(Command.IpPort);
+    } else {
+        Command.Socket->SetDestination(IpAddress, Command.IpPort);
+        State.Socket->AssignPort(State.IpPort);
+    }
+}
+
+void mtsSocketBridge::Run(void)
+{
+    ProcessQueuedEvents();
+    ProcessQueuedCommands();
+
+    ReceiveData();
+    UpdateStatistics();
+    PublishDisplaySnapshot();
+    SendData();
+}
+
+void mtsSocketBridge::ReceiveData(void)
+{
+    // server receives commands, client receives states
+    mtsSocketTransport * socket = mIsServer ? Command.Socket : State.Socket;
+    char * buffer = mIsServer ? Command.Buffer : State.Buffer;
+    socketHeader & header = mIsServer ? Command.Data.Header : State.Data.Header;
+
+    // all arms are in each datagram so we only need the latest
+    const int bytesRead = ReceiveLatest(socket, buffer);
+    if (bytesRead <= 0) {
+        CMN_LOG_CLASS_RUN_DEBUG << "ReceiveData: UDP receive failed" << std::endl;
+        return;
+    }
+
+    size_t numberOfChannels;
+    if (!mtsSocketWireFormat::DecodeBridgeHeader(buffer, bytesRead, header, numberOfChannels)) {
+        CMN_LOG_CLASS_RUN_ERROR << "ReceiveData: failed to decode "
+                                << bytesRead << " bytes" << std::endl;
+        return;
+    }
+
+    // all channels were sent at the same time
+    const bool stale = mIsServer && IsStale(header);
+    const char * pointer = buffer + mtsSocketWireFormat::BridgeHeaderSize;
+    for (size_t index = 0; index < numberOfChannels; ++index) {
+        const unsigned int channelId = mtsSocketWireFormat::DecodeChannelId(pointer);
+        const unsigned int channelType = mtsSocketWireFormat::DecodeChannelType(pointer);
+        const size_t channelSize = mtsSocketWireFormat::DecodeChannelSize(pointer);
+        const char * message = pointer + mtsSocketWireFormat::ChannelHeaderSize;
+        const size_t messageSize = channelSize - mtsSocketWireFormat::ChannelHeaderSize;
+        pointer += channelSize;
+        if (channelId >= mChannels.size()) {
+            CMN_LOG_CLASS_RUN_WARNING << "ReceiveData: unknown channel " << channelId << std::endl;
+            continue;
+        }
+        Channel * channel = mChannels[channelId];
+        if (channelType != static_cast<unsigned int>(channel->mType)) {
+            CMN_LOG_CLASS_RUN_WARNING << "ReceiveData: channel " << channelId << " (" << channel->mName
+                                      << ") has a different arm type on the other side" << std::endl;
+            continue;
+        }
+        if (mIsServer) {
+            if (channel->DecodeCommand(message, messageSize)) {
+                channel->ExecuteCommands(stale);
+            }
+        } else {
+            if (channel->DecodeState(message, messageSize)) {
+                channel->UpdateApplication();
+            }
+        }
+    }
+}
+
+void mtsSocketBridge::SendData(void)
+{
+    // server sends states, client sends commands
+    mtsSocketTransport * socket = mIsServer ? State.Socket : Command.Socket;
+    char * buffer = mIsServer ? State.Buffer : Command.Buffer;
+    socketHeader & header = mIsServer ? State.Data.Header : Command.Data.Header;
+    const socketHeader & received = mIsServer ? Command.Data.Header : State.Data.Header;
+
+    header.Id++;
+    header.Timestamp = mTimeServer.GetRelativeTime();
+    header.LastId = received.Id;
+    header.LastTimestamp = received.Timestamp;
+
+    // sizes are checked when arms are added
+    size_t size = mtsSocketWireFormat::EncodeBridgeHeader(header, mChannels.size(),
+                                                          buffer, BUFFER_SIZE);
+    const size_t numberOfChannels = mChannels.size();
+    for (size_t index = 0; index < numberOfChannels; ++index) {
+        Channel * channel = mChannels[index];
+        char * pointer = buffer + size;
+        mtsSocketWireFormat::EncodeChannelId(index, pointer, channel->mType);
+        pointer += mtsSocketWireFormat::ChannelHeaderSize;
+        const size_t available = BUFFER_SIZE - size - mtsSocketWireFormat::ChannelHeaderSize;
+        const size_t messageSize = mIsServer
+            ? channel->EncodeState(header, pointer, available)
+            : channel->EncodeCommand(header, pointer, available);
+        size += mtsSocketWireFormat::ChannelHeaderSize + messageSize;
+    }
+    socket->Send(buffer, size);
+}
@@ -26,13 +26,18 @@ mtsSocketClientPSM::mtsSocketClientPSM(const std::string & componentName, const
     mtsSocketBasePSM(componentName, periodInSeconds, ip, port, false)
 {
     this->StateTable.AddData(m_measured_cp, "m_measured_cp");
+    m_measured_js.Position().SetSize(6);
+    m_measured_js.Position().SetAll(0.0);
+    this->StateTable.AddData(m_measured_js, "m_measured_js");
     m_jaw_measured_js.Position().resize(1);
     this->StateTable.AddData(m_jaw_measured_js, "m_jaw_measured_js");
     this->StateTable.AddData(m_operating_state, "m_operating_state");
-    mtsInterfaceProvided * interfaceProvided = AddInterfaceProvided("Arm");
+    mInterface = AddInterfaceProvided("Arm");
+    mtsInterfaceProvided * interfaceProvided = mInterface;
     if (interfaceProvided) {
         interfaceProvided->AddMessageEvents();
         interfaceProvided->AddCommandReadState(this->StateTable, m_measured_cp, "measured_cp");
+        interfaceProvided->AddCommandReadState(this->StateTable, m_measured_js, "measured_js");
         interfaceProvided->AddCommandReadState(this->StateTable, m_jaw_measured_js, "jaw/measured_js");
         interfaceProvided->AddCommandReadState(this->StateTable, m_operating_state, "operating_state");
         interfaceProvided->AddCommandVoid(&mtsSocketClientPSM::Freeze,
@@ -41,11 +46,25 @@ mtsSocketClientPSM::mtsSocketClientPSM(const std::string & componentName, const
                                            this , "servo_cp");
         interfaceProvided->AddCommandWrite(&mtsSocketClientPSM::jaw_servo_jp,
                                            this , "jaw/servo_jp");
+        interfaceProvided->AddCommandWrite(&mtsSocketClientPSM::servo_jp,
+                                           this , "servo_jp");
+        interfaceProvided->AddCommandWrite(&mtsSocketClientPSM::move_cp,
+                                           this , "move_cp");
+        interfaceProvided->AddCommandWrite(&mtsSocketClientPSM::move_jp,
+                                           this , "move_jp");
+        interfaceProvided->AddCommandWrite(&mtsSocketClientPSM::jaw_move_jp,
+                                           this , "jaw/move_jp");
         interfaceProvided->AddCommandWrite(&mtsSocketClientPSM::state_command,
                                            this , "state_command");
         interfaceProvided->AddEventWrite(operating_state_event, "operating_state",
                                          m_operating_state);
+        interfaceProvided->AddEventWrite(goal_reached_event, "goal_reached", bool());
     }
+
+    mTrajectoryGoalNew = false;
+    mTrajectoryGoalActive = false;
+    mTrajectoryGoalId = 0;
+    mCommandRejected = false;
 }
 
 void mtsSocketClientPSM::Configure(const std::string & CMN_UNUSED(fileName))
@@ -53,7 +72,6 @@ void mtsSocketClientPSM::Configure(const std::string & CMN_UNUSED(fileName))
     DesiredState = socketMessages::SCK_UNINITIALIZED;
     PreviousState = socketMessages::SCK_UNINITIALIZED;
     CurrentState = socketMessages::SCK_UNINITIALIZED;
-    Command.Data.Header.Size = CLIENT_MSG_SIZE;
     Command.Socket->SetDestination(IpAddress, Command.IpPort);
     State.Socket->AssignPort(State.IpPort);
 }
@@ -65,6 +83,7 @@ void mtsSocketClientPSM::Run(void)
 
     ReceivePSMStateData();
     UpdateStatistics();
+    PublishDisplaySnapshot();
     SendPSMCommandData();
 }
 
@@ -83,6 +102,9 @@ void mtsSocketClientPSM::UpdateApplication(void)
             break;
         case socketMessages::SCK_HOMED:
         case socketMessages::SCK_CART_POS:
+        case socketMessages::SCK_CART_TRAJ:
+        case socketMessages::SCK_JNT_POS:
+        case socketMessages::SCK_JNT_TRAJ:
             m_operating_state.State() = prmOperatingState::ENABLED;
             m_operating_state.IsHomed() = true;
             break;
@@ -92,10 +114,29 @@ void mtsSocketClientPSM::UpdateApplication(void)
         }
         operating_state_event(m_operating_state);
     }
-    m_measured_cp.Valid() = (CurrentState >= socketMessages::SCK_HOMED);
+    m_measured_cp.Valid() = (CurrentState >= socketMessages::SCK_HOMED)
+        && !IsStale(State.Data.Header);
     m_measured_cp.Position().FromNormalized(State.Data.CurrentPose);
+    m_measured_js.Position().Assign(State.Data.CurrentJoints);
     m_jaw_measured_js.Position().at(0) = State.Data.CurrentJaw;
-    
+
+    // server can't execute the last state requested
+    if (State.Data.CommandRejected && !mCommandRejected) {
+        mInterface->SendError(this->GetName() + ": command rejected by server");
+        if (mTrajectoryGoalActive) {
+            mTrajectoryGoalActive = false;
+            goal_reached_event(false);
+        }
+    }
+    mCommandRejected = State.Data.CommandRejected;
+
+    // only trust goal reached once the server received the goal
+    if (mTrajectoryGoalActive
+        && (State.Data.Header.LastId >= mTrajectoryGoalId)
+        && State.Data.GoalReached) {
+        mTrajectoryGoalActive = false;
+        goal_reached_event(true);
+    }
 }
 
 void mtsSocketClientPSM::Freeze(void)
@@ -103,6 +144,7 @@ void mtsSocketClientPSM::Freeze(void)
     DesiredState = socketMessages::SCK_CART_POS;
     Command.Data.GoalPose.From(State.Data.CurrentPose);
     Command.Data.GoalJaw = State.Data.CurrentJaw;
+    Command.Data.GoalJoints.Assign(State.Data.CurrentJoints);
 }
 
 void mtsSocketClientPSM::state_command(const std::string & state)
@@ -118,6 +160,7 @@ void mtsSocketClientPSM::state_command(const std::string & state)
     Command.Data.RobotControlState = DesiredState;
     Command.Data.GoalPose.From(State.Data.CurrentPose);
     Command.Data.GoalJaw = State.Data.CurrentJaw;
+    Command.Data.GoalJoints.Assign(State.Data.CurrentJoints);
 }
 
 void mtsSocketClientPSM::servo_cp(const prmPositionCartesianSet & position)
@@ -128,43 +171,83 @@ void mtsSocketClientPSM::servo_cp(const prmPositionCartesianSet & position)
 
 void mtsSocketClientPSM::jaw_servo_jp(const prmPositionJointSet & position)
 {
-    DesiredState = socketMessages::SCK_CART_POS;
+    if (DesiredState != socketMessages::SCK_JNT_POS) {
+        DesiredState = socketMessages::SCK_CART_POS;
+    }
     Command.Data.GoalJaw = position.Goal().at(0);
 }
 
-void mtsSocketClientPSM::ReceivePSMStateData(void)
+void mtsSocketClientPSM::servo_jp(const prmPositionJointSet & position)
 {
-    // Recv Scoket Data
-    size_t bytesRead = 0;
-    bytesRead = State.Socket->Receive(State.Buffer, BUFFER_SIZE, TIMEOUT);
-    if (bytesRead > 0) {
-        if (bytesRead != State.Data.Header.Size){
-            std::cerr << CMN_LOG_DETAILS << "Incorrect bytes read " << bytesRead << ". Looking for " << State.Data.Header.Size << " bytes." << std::endl;
-        }
-
-        std::stringstream ss;
-        cmnDataFormat local, remote;
-        ss.write(State.Buffer, bytesRead);
+    if (mWireFormat != mtsSocketWireFormat::PACKED) {
+        mInterface->SendError(this->GetName() + ": servo_jp requires the packed socket format");
+        return;
+    }
+    if (position.Goal().size() != Command.Data.GoalJoints.size()) {
+        CMN_LOG_CLASS_RUN_ERROR << "servo_jp: expected " << Command.Data.GoalJoints.size()
+                                << " joints, received " << position.Goal().size() << std::endl;
+        return;
+    }
+    DesiredState = socketMessages::SCK_JNT_POS;
+    Command.Data.GoalJoints.Assign(position.Goal());
+}
 
-        // Dequeue all the datagrams and only use the latest one.
-        int readCounter = 0;
-        int dataLeft = bytesRead;
-        while (dataLeft > 0) {
-            dataLeft = State.Socket->Receive(State.Buffer, BUFFER_SIZE, 0);
-            if (dataLeft != 0) {
-                bytesRead = dataLeft;
-            }
+void mtsSocketClientPSM::move_cp(const prmPositionCartesianSet & position)
+{
+    Command.Data.GoalPose.From(position.Goal());
+    NewTrajectoryGoal(socketMessages::SCK_CART_TRAJ);
+}
 
-            readCounter++;
-        }
+void mtsSocketClientPSM::move_jp(const prmPositionJointSet & position)
+{
+    if (mWireFormat != mtsSocketWireFormat::PACKED) {
+        mInterface->SendError(this->GetName() + ": move_jp requires the packed socket format");
+        return;
+    }
+    if (position.Goal().size() != Command.Data.GoalJoints.size()) {
+        CMN_LOG_CLASS_RUN_ERROR << "move_jp: expected " << Command.Data.GoalJoints.size()
+                                << " joints, received " << position.Goal().size() << std::endl;
+        return;
+    }
+    Command.Data.GoalJoints.Assign(position.Goal());
+    NewTrajectoryGoal(socketMessages::SCK_JNT_TRAJ);
+}
 
-        if (readCounter > 1) {
-            std::cerr << CMN_LOG_DETAILS << "Catching up : " << readCounter << std::endl;
+void mtsSocketClientPSM::jaw_move_jp(const prmPositionJointSet & position)
+{
+    Command.Data.GoalJaw = position.Goal().at(0);
+    // keep current trajectory mode, use cartesian by default
+    if (DesiredState == socketMessages::SCK_JNT_TRAJ) {
+        NewTrajectoryGoal(socketMessages::SCK_JNT_TRAJ);
+    } else {
+        if (DesiredState != socketMessages::SCK_CART_TRAJ) {
+            Command.Data.GoalPose.From(State.Data.CurrentPose);
         }
+        NewTrajectoryGoal(socketMessages::SCK_CART_TRAJ);
+    }
+}
 
-        ss.write(State.Buffer, bytesRead);
-        cmnData<socketStatePSM>::DeSerializeBinary(State.Data, ss, local, remote);
+void mtsSocketClientPSM::NewTrajectoryGoal(const socketMessages::StateType state)
+{
+    // previous trajectory is interrupted
+    if (mTrajectoryGoalActive) {
+        goal_reached_event(false);
+    }
+    DesiredState = state;
+    mTrajectoryGoalNew = true;
+    mTrajectoryGoalActive = true;
+}
 
+void mtsSocketClientPSM::ReceivePSMStateData(void)
+{
+    // Recv Socket Data, decoded in place
+    const int bytesRead = ReceiveLatest(State.Socket, State.Buffer);
+    if (bytesRead > 0) {
+        if (!mtsSocketWireFormat::Decode(State.Buffer, bytesRead, State.Data)) {
+            CMN_LOG_CLASS_RUN_ERROR << "ReceivePSMStateData: failed to decode "
+                                    << bytesRead << " bytes" << std::endl;
+            return;
+        }
         State.Data.CurrentPose.NormalizedSelf();
         UpdateApplication();
     } else {
@@ -180,11 +263,17 @@ void mtsSocketClientPSM::SendPSMCommandData(void)
     Command.Data.Header.LastId = State.Data.Header.Id;
     Command.Data.Header.LastTimestamp = State.Data.Header.Timestamp;
     Command.Data.RobotControlState = DesiredState;
+    if (mTrajectoryGoalNew) {
+        mTrajectoryGoalNew = false;
+        mTrajectoryGoalId = Command.Data.Header.Id;
+    }
 
-    // Send Socket Data
-    std::stringstream ss;
-    cmnData<socketCommandPSM>::SerializeBinary(Command.Data, ss);
-    memcpy(Command.Buffer, ss.str().c_str(), ss.str().length());
-
-    Command.Socket->Send(Command.Buffer, ss.str().size());
+    // Send Socket Data, encoded in place
+    const size_t size = mtsSocketWireFormat::Encode(mWireFormat, Command.Data,
+                                                    Command.Buffer, BUFFER_SIZE);
+    if (size == 0) {
+        CMN_LOG_CLASS_RUN_ERROR << "SendPSMCommandData: failed to encode command" << std::endl;
+        return;
+    }
+    Command.Socket->Send(Command.Buffer, size);
 }
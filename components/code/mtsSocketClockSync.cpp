@@ -0,0 +1,161 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-27
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <sawIntuitiveResearchKit/mtsSocketClockSync.h>
+
+mtsSocketClockSync::mtsSocketClockSync(void)
+{
+    Reset();
+}
+
+void mtsSocketClockSync::Reset(void)
+{
+    mFilterSize = 0;
+    mFilterIndex = 0;
+    mValid = false;
+    mOffset = 0.0;
+    mOffsetTime = 0.0;
+    mRoundTripTime = 0.0;
+    mDriftValid = false;
+    mDrift = 0.0;
+    mDriftReferenceTime = 0.0;
+    mDriftReferenceOffset = 0.0;
+    mWindowSize = 0;
+    mWindowIndex = 0;
+    mNumberOfSamples = 0;
+    mLatencyIn.SetAll(0.0);
+    mLatencyOut.SetAll(0.0);
+}
+
+bool mtsSocketClockSync::AddSample(const double localSendTime, const double remoteTime,
+                                   const double localReceiveTime)
+{
+    // peer didn't echo anything yet or timestamps from before a restart
+    if ((localSendTime <= 0.0) || (localReceiveTime < localSendTime)) {
+        return false;
+    }
+
+    // offset assuming symmetric delays
+    Sample & sample = mFilter[mFilterIndex];
+    sample.Time = localReceiveTime;
+    sample.Delay = localReceiveTime - localSendTime;
+    sample.Offset = remoteTime - 0.5 * (localSendTime + localReceiveTime);
+    mFilterIndex = (mFilterIndex + 1) % FILTER_SIZE;
+    if (mFilterSize < FILTER_SIZE) {
+        mFilterSize++;
+    }
+
+    // clock filter, smallest round trip, most recent if tie
+    const Sample * best = &(mFilter[0]);
+    for (size_t index = 1; index < mFilterSize; ++index) {
+        const Sample & candidate = mFilter[index];
+        if ((candidate.Delay < best->Delay)
+            || ((candidate.Delay == best->Delay) && (candidate.Time > best->Time))) {
+            best = &candidate;
+        }
+    }
+
+    // drift from offsets far enough apart
+    if (!mValid) {
+        mValid = true;
+        mDriftReferenceTime = best->Time;
+        mDriftReferenceOffset = best->Offset;
+    } else {
+        const double elapsed = best->Time - mDriftReferenceTime;
+        if (elapsed >= mtsIntuitiveResearchKit::SocketClockSync::DriftInterval) {
+            const double drift = (best->Offset - mDriftReferenceOffset) / elapsed;
+            if (mDriftValid) {
+                mDrift += mtsIntuitiveResearchKit::SocketClockSync::DriftGain * (drift - mDrift);
+            } else {
+                mDriftValid = true;
+                mDrift = drift;
+            }
+            mDriftReferenceTime = best->Time;
+            mDriftReferenceOffset = best->Offset;
+        }
+    }
+    mOffset = best->Offset;
+    mOffsetTime = best->Time;
+    mRoundTripTime = best->Delay;
+
+    // one way latencies using filtered offset
+    const double remoteSendTime = remoteTime - Offset(localReceiveTime);
+    mWindowIn[mWindowIndex] = localReceiveTime - remoteSendTime;
+    mWindowOut[mWindowIndex] = remoteSendTime - localSendTime;
+    mWindowIndex = (mWindowIndex + 1) % WINDOW_SIZE;
+    if (mWindowSize < WINDOW_SIZE) {
+        mWindowSize++;
+    }
+    mNumberOfSamples++;
+    return true;
+}
+
+double mtsSocketClockSync::Offset(const double localTime) const
+{
+    return mOffset + mDrift * (localTime - mOffsetTime);
+}
+
+double mtsSocketClockSync::Latency(const double remoteTime, const double localReceiveTime) const
+{
+    return localReceiveTime - (remoteTime - Offset(localReceiveTime));
+}
+
+void mtsSocketClockSync::ComputeDistributions(void)
+{
+    ComputeDistribution(mWindowIn, mLatencyIn);
+    ComputeDistribution(mWindowOut, mLatencyOut);
+}
+
+void mtsSocketClockSync::ComputeDistribution(const double * window, vct5 & distribution)
+{
+    if (mWindowSize == 0) {
+        distribution.SetAll(0.0);
+        return;
+    }
+    double minimum = window[0];
+    double maximum = window[0];
+    double sum = 0.0;
+    for (size_t index = 0; index < mWindowSize; ++index) {
+        const double value = window[index];
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+        sum += value;
+    }
+    const double mean = sum / mWindowSize;
+    double sumSquares = 0.0;
+    for (size_t index = 0; index < mWindowSize; ++index) {
+        const double difference = window[index] - mean;
+        sumSquares += difference * difference;
+    }
+
+    // 99th percentile, partial sort on a copy
+    memcpy(mScratch, window, mWindowSize * sizeof(double));
+    size_t rank = static_cast<size_t>(std::ceil(0.99 * mWindowSize));
+    rank = (rank == 0) ? 0 : rank - 1;
+    std::nth_element(mScratch, mScratch + rank, mScratch + mWindowSize);
+
+    distribution.Assign(minimum,
+                        mean,
+                        std::sqrt(sumSquares / mWindowSize),
+                        mScratch[rank],
+                        maximum);
+}
@@ -0,0 +1,201 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-29
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include <sawIntuitiveResearchKit/mtsSocketImpairment.h>
+
+mtsSocketImpairment::mtsSocketImpairment(void)
+{
+    Configure(Profile());
+}
+
+void mtsSocketImpairment::Configure(const Profile & profile)
+{
+    mProfile = profile;
+    mStatistics = Statistics();
+    // xorshift can't use 0 as state
+    mRandomState = (profile.Seed == 0) ? 1 : profile.Seed;
+    mSequence = 0;
+    mLastDeliveredSequence = 0;
+    mLinkFreeTime = 0.0;
+    mSize = 0;
+}
+
+bool mtsSocketImpairment::ProfileFromJSON(const Json::Value & jsonProfile, Profile & profile)
+{
+    Json::Value jsonValue;
+    jsonValue = jsonProfile["delay"];
+    if (!jsonValue.empty()) {
+        profile.Delay = jsonValue.asDouble();
+    }
+    jsonValue = jsonProfile["jitter"];
+    if (!jsonValue.empty()) {
+        profile.Jitter = jsonValue.asDouble();
+    }
+    jsonValue = jsonProfile["loss"];
+    if (!jsonValue.empty()) {
+        profile.Loss = jsonValue.asDouble();
+    }
+    jsonValue = jsonProfile["duplicate"];
+    if (!jsonValue.empty()) {
+        profile.Duplicate = jsonValue.asDouble();
+    }
+    jsonValue = jsonProfile["reorder"];
+    if (!jsonValue.empty()) {
+        profile.Reorder = jsonValue.asDouble();
+    }
+    jsonValue = jsonProfile["reorder-delay"];
+    if (!jsonValue.empty()) {
+        profile.ReorderDelay = jsonValue.asDouble();
+    }
+    jsonValue = jsonProfile["bandwidth"];
+    if (!jsonValue.empty()) {
+        profile.Bandwidth = jsonValue.asDouble();
+    }
+    jsonValue = jsonProfile["queue-size"];
+    if (!jsonValue.empty()) {
+        profile.QueueSize = jsonValue.asUInt();
+    }
+    jsonValue = jsonProfile["seed"];
+    if (!jsonValue.empty()) {
+        profile.Seed = jsonValue.asUInt();
+    }
+
+    if ((profile.Delay < 0.0) || (profile.Jitter < 0.0) || (profile.ReorderDelay < 0.0)
+        || (profile.Loss < 0.0) || (profile.Loss > 1.0)
+        || (profile.Duplicate < 0.0) || (profile.Duplicate > 1.0)
+        || (profile.Reorder < 0.0) || (profile.Reorder > 1.0)
+        || (profile.Bandwidth < 0.0) || (profile.QueueSize == 0)) {
+        return false;
+    }
+    return true;
+}
+
+double mtsSocketImpairment::Random(void)
+{
+    mRandomState ^= mRandomState << 13;
+    mRandomState ^= mRandomState >> 17;
+    mRandomState ^= mRandomState << 5;
+    return mRandomState / 4294967296.0;
+}
+
+bool mtsSocketImpairment::Queue(const char * data, const size_t size,
+                                const uint32_t sequence, const double deliveryTime)
+{
+    if (mSize == CAPACITY) {
+        return false;
+    }
+    Datagram & datagram = mDatagrams[mSize];
+    datagram.DeliveryTime = deliveryTime;
+    datagram.Sequence = sequence;
+    datagram.Size = size;
+    memcpy(datagram.Data, data, size);
+    mSize++;
+    return true;
+}
+
+bool mtsSocketImpairment::Send(const char * data, const size_t size, const double time)
+{
+    mStatistics.Sent++;
+    mSequence++;
+    if (size > MAXIMUM_DATAGRAM_SIZE) {
+        return false;
+    }
+    if (Random() < mProfile.Loss) {
+        mStatistics.Lost++;
+        return false;
+    }
+
+    // limited bandwidth, datagrams leave the link one after the other
+    double departureTime = time;
+    if (mProfile.Bandwidth > 0.0) {
+        const double startTime = std::max(time, mLinkFreeTime);
+        const double bytesQueued = (startTime - time) * mProfile.Bandwidth;
+        if (bytesQueued + size > mProfile.QueueSize) {
+            mStatistics.Overflows++;
+            return false;
+        }
+        mLinkFreeTime = startTime + size / mProfile.Bandwidth;
+        departureTime = mLinkFreeTime;
+    }
+
+    double deliveryTime = departureTime + mProfile.Delay + mProfile.Jitter * Random();
+    if (Random() < mProfile.Reorder) {
+        deliveryTime += mProfile.ReorderDelay;
+    }
+    if (!Queue(data, size, mSequence, deliveryTime)) {
+        mStatistics.Overflows++;
+        return false;
+    }
+
+    // duplicates have their own jitter
+    if (Random() < mProfile.Duplicate) {
+        const double duplicateTime = departureTime + mProfile.Delay + mProfile.Jitter * Random();
+        if (Queue(data, size, mSequence, duplicateTime)) {
+            mStatistics.Duplicated++;
+        }
+    }
+    return true;
+}
+
+int mtsSocketImpairment::Receive(char * buffer, const size_t bufferSize, const double time)
+{
+    // earliest delivery, send order if tie
+    size_t best = mSize;
+    for (size_t index = 0; index < mSize; ++index) {
+        const Datagram & candidate = mDatagrams[index];
+        if (candidate.DeliveryTime > time) {
+            continue;
+        }
+        if ((best == mSize)
+            || (candidate.DeliveryTime < mDatagrams[best].DeliveryTime)
+            || ((candidate.DeliveryTime == mDatagrams[best].DeliveryTime)
+                && (candidate.Sequence < mDatagrams[best].Sequence))) {
+            best = index;
+        }
+    }
+    if (best == mSize) {
+        return 0;
+    }
+
+    Datagram & datagram = mDatagrams[best];
+    int result = -1;
+    if (datagram.Size <= bufferSize) {
+        memcpy(buffer, datagram.Data, datagram.Size);
+        result = static_cast<int>(datagram.Size);
+        mStatistics.Delivered++;
+        if (datagram.Sequence < mLastDeliveredSequence) {
+            mStatistics.Reordered++;
+        } else {
+            mLastDeliveredSequence = datagram.Sequence;
+        }
+    }
+
+    // remove, order in array doesn't matter
+    mSize--;
+    if (best != mSize) {
+        const Datagram & last = mDatagrams[mSize];
+        datagram.DeliveryTime = last.DeliveryTime;
+        datagram.Sequence = last.Sequence;
+        datagram.Size = last.Size;
+        memcpy(datagram.Data, last.Data, last.Size);
+    }
+    return result;
+}
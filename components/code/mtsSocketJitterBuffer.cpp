@@ -0,0 +1,223 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-22
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cmath>
+#include <limits>
+
+#include <sawIntuitiveResearchKit/mtsSocketJitterBuffer.h>
+
+mtsSocketJitterBuffer::mtsSocketJitterBuffer(void):
+    mMinDelay(mtsIntuitiveResearchKit::SocketJitterBuffer::MinDelay),
+    mMaxDelay(mtsIntuitiveResearchKit::SocketJitterBuffer::MaxDelay),
+    mExtrapolation(mtsIntuitiveResearchKit::SocketJitterBuffer::Extrapolation),
+    mHoldTimeout(mtsIntuitiveResearchKit::SocketJitterBuffer::HoldTimeout),
+    mLastJaw(0.0)
+{
+    Reset();
+}
+
+void mtsSocketJitterBuffer::Configure(const double minDelay, const double maxDelay,
+                                      const double extrapolation, const double holdTimeout)
+{
+    mMinDelay = minDelay;
+    mMaxDelay = maxDelay;
+    mExtrapolation = extrapolation;
+    mHoldTimeout = holdTimeout;
+    mStatistics.PlayoutDelay = mMinDelay;
+}
+
+void mtsSocketJitterBuffer::Reset(void)
+{
+    mSize = 0;
+    mPreviousValid = false;
+    mOffsetValid = false;
+    mOffset = 0.0;
+    mLastTransit = 0.0;
+    mLastArrival = 0.0;
+    mNewestId = 0;
+    mLastPlayoutRemoteTime = -std::numeric_limits<double>::max();
+    mLastPlayout = EMPTY;
+    mStatistics.PlayoutDelay = mMinDelay;
+}
+
+void mtsSocketJitterBuffer::DropFront(const size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    // keep last dropped entry to estimate velocity when extrapolating
+    mPrevious = mEntries[count - 1];
+    mPreviousValid = true;
+    for (size_t index = count; index < mSize; ++index) {
+        mEntries[index - count] = mEntries[index];
+    }
+    mSize -= count;
+}
+
+bool mtsSocketJitterBuffer::Push(const unsigned int id, const double remoteTime, const double localTime,
+                                 const vctFrm3 & pose, const double jaw)
+{
+    // transit time and inter-arrival jitter, see RFC 3550
+    const double transit = localTime - remoteTime;
+    const bool first = !mOffsetValid;
+    if (first) {
+        mOffsetValid = true;
+        mOffset = transit;
+    } else {
+        mStatistics.Jitter += (std::fabs(transit - mLastTransit) - mStatistics.Jitter) / 16.0;
+        // offset follows the minimum transit, slowly increases to
+        // follow drift between both clocks
+        if (transit < mOffset) {
+            mOffset = transit;
+        } else {
+            mOffset += 0.001 * (transit - mOffset);
+        }
+    }
+    mLastTransit = transit;
+    mLastArrival = localTime;
+
+    // adapt playout delay to measured jitter
+    double delay = 4.0 * mStatistics.Jitter;
+    if (delay < mMinDelay) {
+        delay = mMinDelay;
+    } else if (delay > mMaxDelay) {
+        delay = mMaxDelay;
+    }
+    mStatistics.PlayoutDelay = delay;
+
+    // too late to be played
+    if (remoteTime <= mLastPlayoutRemoteTime) {
+        mStatistics.PacketsLate++;
+        return false;
+    }
+
+    // find where to insert, most of the time at the end
+    size_t position = mSize;
+    if (first || (id > mNewestId)) {
+        if (!first && (id > mNewestId + 1)) {
+            mStatistics.PacketsLost += (id - mNewestId - 1);
+        }
+        mNewestId = id;
+    } else {
+        while ((position > 0) && (mEntries[position - 1].Id > id)) {
+            --position;
+        }
+        if ((position > 0) && (mEntries[position - 1].Id == id)) {
+            // duplicate
+            return false;
+        }
+        mStatistics.PacketsReordered++;
+        if (mStatistics.PacketsLost > 0) {
+            mStatistics.PacketsLost--;
+        }
+    }
+
+    // make room if needed, oldest is dropped
+    if (mSize == CAPACITY) {
+        DropFront(1);
+        if (position == 0) {
+            return false;
+        }
+        --position;
+    }
+    for (size_t index = mSize; index > position; --index) {
+        mEntries[index] = mEntries[index - 1];
+    }
+    Entry & entry = mEntries[position];
+    entry.Id = id;
+    entry.RemoteTime = remoteTime;
+    entry.Pose.Assign(pose);
+    entry.Jaw = jaw;
+    ++mSize;
+    return true;
+}
+
+mtsSocketJitterBuffer::PlayoutType
+mtsSocketJitterBuffer::Playout(const double localTime, vctFrm3 & pose, double & jaw)
+{
+    PlayoutType result;
+
+    if (mSize == 0) {
+        result = EMPTY;
+    } else if ((localTime - mLastArrival) > mHoldTimeout) {
+        // nothing received for too long, keep last pose
+        if (mLastPlayout != HOLD) {
+            mStatistics.Holds++;
+        }
+        result = HOLD;
+    } else {
+        const double remoteTime = localTime - mOffset - mStatistics.PlayoutDelay;
+        if (remoteTime < mEntries[0].RemoteTime) {
+            // not enough data buffered yet
+            mLastPose.Assign(mEntries[0].Pose);
+            mLastJaw = mEntries[0].Jaw;
+            result = BUFFERING;
+        } else {
+            // drop all entries older than the one just before playout time
+            size_t index = 0;
+            while (((index + 1) < mSize)
+                   && (mEntries[index + 1].RemoteTime <= remoteTime)) {
+                ++index;
+            }
+            DropFront(index);
+            mLastPlayoutRemoteTime = remoteTime;
+
+            const Entry & start = mEntries[0];
+            if (mSize > 1) {
+                // interpolate between start and next
+                const Entry & end = mEntries[1];
+                const double ratio = (remoteTime - start.RemoteTime) / (end.RemoteTime - start.RemoteTime);
+                mLastPose.Translation().SumOf(start.Pose.Translation(),
+                                              ratio * (end.Pose.Translation() - start.Pose.Translation()));
+                vctMatRot3 delta, partial;
+                start.Pose.Rotation().ApplyInverseTo(end.Pose.Rotation(), delta);
+                vctAxAnRot3 axisAngle;
+                axisAngle.FromNormalized(delta);
+                axisAngle.Angle() *= ratio;
+                partial.FromNormalized(axisAngle);
+                mLastPose.Rotation().ProductOf(start.Pose.Rotation(), partial);
+                mLastJaw = start.Jaw + ratio * (end.Jaw - start.Jaw);
+                result = INTERPOLATING;
+            } else {
+                // nothing newer, extrapolate translation for a short time
+                double dt = remoteTime - start.RemoteTime;
+                if (dt > mExtrapolation) {
+                    dt = mExtrapolation;
+                }
+                mLastPose.Assign(start.Pose);
+                mLastJaw = start.Jaw;
+                if (mPreviousValid && (start.RemoteTime > mPrevious.RemoteTime)) {
+                    const double ratio = dt / (start.RemoteTime - mPrevious.RemoteTime);
+                    mLastPose.Translation().AddProductOf(ratio,
+                                                         start.Pose.Translation() - mPrevious.Pose.Translation());
+                }
+                if (mLastPlayout != EXTRAPOLATING) {
+                    mStatistics.Extrapolated++;
+                }
+                result = EXTRAPOLATING;
+            }
+        }
+    }
+
+    mLastPlayout = result;
+    if (result != EMPTY) {
+        pose.Assign(mLastPose);
+        jaw = mLastJaw;
+    }
+    return result;
+}
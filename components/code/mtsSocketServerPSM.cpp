@@ -16,8 +16,11 @@ http://www.cisst.org/cisst/license.txt.
 --- end cisst license ---
 */
 
+#include <algorithm>
+
 #include <sawIntuitiveResearchKit/mtsSocketServerPSM.h>
 #include <cisstMultiTask/mtsInterfaceRequired.h>
+#include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstParameterTypes/prmOperatingState.h>
 
 CMN_IMPLEMENT_SERVICES_DERIVED(mtsSocketServerPSM, mtsTaskPeriodic);
@@ -31,10 +34,51 @@ mtsSocketServerPSM::mtsSocketServerPSM(const std::string & componentName, const
         interfaceRequired->AddFunction("measured_cp", measured_cp);
         interfaceRequired->AddFunction("servo_cp", servo_cp);
         interfaceRequired->AddFunction("jaw/servo_jp", jaw_servo_jp);
+        // joint space and trajectory modes, not provided by all PSM like components
+        interfaceRequired->AddFunction("measured_js", measured_js, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("servo_jp", servo_jp, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("move_cp", move_cp, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("move_jp", move_jp, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("jaw/move_jp", jaw_move_jp, MTS_OPTIONAL);
         interfaceRequired->AddFunction("operating_state", operating_state);
         interfaceRequired->AddFunction("state_command", state_command);
         interfaceRequired->AddEventHandlerWrite(&mtsSocketServerPSM::ErrorEventHandler,
                                                 this, "error");
+        interfaceRequired->AddEventHandlerWrite(&mtsSocketServerPSM::GoalReachedEventHandler,
+                                                this, "goal_reached");
+    }
+
+    m_jaw_setpoint_jp.Goal().SetSize(1);
+    m_setpoint_jp.Goal().SetSize(6);
+    mTrajectoryGoalSent = false;
+    mTrajectoryGoalJaw = 0.0;
+    mCommandStale = false;
+    mCommandPacked = true;
+
+    // jitter buffer, disabled by default
+    mJitterBufferEnabled = false;
+    mPlayoutJaw = 0.0;
+    mJitterStatistics.PlayoutDelay = 0.0;
+    mJitterStatistics.Jitter = 0.0;
+    mJitterStatistics.PacketsReordered = 0;
+    mJitterStatistics.PacketsLate = 0;
+    mJitterStatistics.Extrapolated = 0;
+    mJitterStatistics.Holds = 0;
+    this->StateTable.AddData(mJitterStatistics.PlayoutDelay, "PlayoutDelay");
+    this->StateTable.AddData(mJitterStatistics.Jitter, "Jitter");
+    this->StateTable.AddData(mJitterStatistics.PacketsReordered, "PacketsReordered");
+    this->StateTable.AddData(mJitterStatistics.PacketsLate, "PacketsLate");
+    this->StateTable.AddData(mJitterStatistics.Extrapolated, "PlayoutExtrapolated");
+    this->StateTable.AddData(mJitterStatistics.Holds, "PlayoutHolds");
+
+    mtsInterfaceProvided * interfaceProvided = GetInterfaceProvided("System");
+    if (interfaceProvided) {
+        interfaceProvided->AddCommandReadState(this->StateTable, mJitterStatistics.PlayoutDelay, "GetPlayoutDelay");
+        interfaceProvided->AddCommandReadState(this->StateTable, mJitterStatistics.Jitter, "GetJitter");
+        interfaceProvided->AddCommandReadState(this->StateTable, mJitterStatistics.PacketsReordered, "GetPacketsReordered");
+        interfaceProvided->AddCommandReadState(this->StateTable, mJitterStatistics.PacketsLate, "GetPacketsLate");
+        interfaceProvided->AddCommandReadState(this->StateTable, mJitterStatistics.Extrapolated, "GetPlayoutExtrapolated");
+        interfaceProvided->AddCommandReadState(this->StateTable, mJitterStatistics.Holds, "GetPlayoutHolds");
     }
 }
 
@@ -42,24 +86,135 @@ void mtsSocketServerPSM::Configure(const std::string & CMN_UNUSED(fileName))
 {
     DesiredState = socketMessages::SCK_UNINITIALIZED;
     CurrentState = socketMessages::SCK_UNINITIALIZED;
-    State.Data.Header.Size = SERVER_MSG_SIZE;
     State.Socket->SetDestination(IpAddress, State.IpPort);
     Command.Socket->AssignPort(Command.IpPort);
 }
 
+void mtsSocketServerPSM::ConfigureJitterBuffer(const Json::Value & jsonConfig)
+{
+    Json::Value jsonValue;
+    double minDelay = mtsIntuitiveResearchKit::SocketJitterBuffer::MinDelay;
+    double maxDelay = mtsIntuitiveResearchKit::SocketJitterBuffer::MaxDelay;
+    double extrapolation = mtsIntuitiveResearchKit::SocketJitterBuffer::Extrapolation;
+    double holdTimeout = mtsIntuitiveResearchKit::SocketJitterBuffer::HoldTimeout;
+
+    jsonValue = jsonConfig["enabled"];
+    if (!jsonValue.empty()) {
+        mJitterBufferEnabled = jsonValue.asBool();
+    }
+    jsonValue = jsonConfig["min-delay"];
+    if (!jsonValue.empty()) {
+        minDelay = jsonValue.asDouble();
+    }
+    jsonValue = jsonConfig["max-delay"];
+    if (!jsonValue.empty()) {
+        maxDelay = jsonValue.asDouble();
+    }
+    jsonValue = jsonConfig["extrapolation"];
+    if (!jsonValue.empty()) {
+        extrapolation = jsonValue.asDouble();
+    }
+    jsonValue = jsonConfig["hold-timeout"];
+    if (!jsonValue.empty()) {
+        holdTimeout = jsonValue.asDouble();
+    }
+
+    if ((minDelay < 0.0) || (maxDelay < minDelay)
+        || (extrapolation < 0.0) || (holdTimeout <= 0.0)) {
+        CMN_LOG_CLASS_INIT_ERROR << "ConfigureJitterBuffer: " << this->GetName()
+                                 << ", invalid parameters, min-delay must be positive and lower than max-delay,"
+                                 << " extrapolation must be positive and hold-timeout strictly positive" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    mJitterBuffer.Configure(minDelay, maxDelay, extrapolation, holdTimeout);
+}
+
 void mtsSocketServerPSM::Run(void)
 {
     ProcessQueuedEvents();
     ProcessQueuedCommands();
 
-    ReceivePSMCommandData();
+    if (mJitterBufferEnabled) {
+        ReceivePSMCommandDataJitterBuffer();
+    } else {
+        ReceivePSMCommandData();
+    }
     UpdateStatistics();
+    PublishDisplaySnapshot();
     SendPSMStateData();
 }
 
+void mtsSocketServerPSM::UpdateDisplaySnapshot(mtsSocketBasePSMDisplayData & data)
+{
+    mtsSocketBasePSM::UpdateDisplaySnapshot(data);
+    data.HasJitterBuffer = true;
+    data.PlayoutDelay = mJitterStatistics.PlayoutDelay;
+    data.Jitter = mJitterStatistics.Jitter;
+    data.PacketsReordered = mJitterStatistics.PacketsReordered;
+    data.PacketsLate = mJitterStatistics.PacketsLate;
+    data.PlayoutExtrapolated = mJitterStatistics.Extrapolated;
+    data.PlayoutHolds = mJitterStatistics.Holds;
+}
+
+bool mtsSocketServerPSM::StateSupported(const socketMessages::StateType state,
+                                        std::string & reason)
+{
+    switch (state) {
+    case socketMessages::SCK_UNINITIALIZED:
+    case socketMessages::SCK_HOMED:
+    case socketMessages::SCK_CART_POS:
+        return true;
+    case socketMessages::SCK_CART_TRAJ:
+        if (!move_cp.IsValid() || !jaw_move_jp.IsValid()) {
+            reason = "cartesian trajectories require move_cp and jaw/move_jp";
+            return false;
+        }
+        return true;
+    case socketMessages::SCK_JNT_POS:
+    case socketMessages::SCK_JNT_TRAJ:
+        // joint goals are not part of the legacy format
+        if (!mCommandPacked) {
+            reason = "joint space commands require the packed format";
+            return false;
+        }
+        if (!measured_js.IsValid()
+            || ((state == socketMessages::SCK_JNT_POS) && !servo_jp.IsValid())
+            || ((state == socketMessages::SCK_JNT_TRAJ) && (!move_jp.IsValid() || !jaw_move_jp.IsValid()))) {
+            reason = "joint space commands are not provided by the arm";
+            return false;
+        }
+        // joint goals are sent as 6 values, jaw excluded
+        measured_js(m_measured_js);
+        if (m_measured_js.Position().size() != 6) {
+            reason = "joint space commands require an arm with 6 joints, not "
+                + std::to_string(m_measured_js.Position().size());
+            return false;
+        }
+        return true;
+    default:
+        reason = "state " + std::to_string(static_cast<int>(state)) + " not supported";
+        return false;
+    }
+}
+
 void mtsSocketServerPSM::ExecutePSMCommands(void)
 {
-    if (DesiredState != Command.Data.RobotControlState) {
+    bool rejected = false;
+    std::string reason;
+    if ((DesiredState != Command.Data.RobotControlState)
+        && !StateSupported(Command.Data.RobotControlState, reason)) {
+        // desired state is not changed so the client can request
+        // another state, rejection is reported in the state message
+        rejected = true;
+        if (!State.Data.CommandRejected) {
+            CMN_LOG_CLASS_RUN_ERROR << "ExecutePSMCommands: " << this->GetName()
+                                    << ", rejected command: " << reason << std::endl;
+        }
+    } else if (DesiredState != Command.Data.RobotControlState) {
+        // leaving cartesian mode, drop buffered commands
+        if (DesiredState == socketMessages::SCK_CART_POS) {
+            mJitterBuffer.Reset();
+        }
         DesiredState = Command.Data.RobotControlState;
         switch (DesiredState) {
         case socketMessages::SCK_UNINITIALIZED:
@@ -72,29 +227,89 @@ void mtsSocketServerPSM::ExecutePSMCommands(void)
             }
             break;
         case socketMessages::SCK_CART_POS:
+        case socketMessages::SCK_CART_TRAJ:
+        case socketMessages::SCK_JNT_POS:
+        case socketMessages::SCK_JNT_TRAJ:
             if (CurrentState != socketMessages::SCK_HOMING) {
                 state_command(std::string("enable"));
                 state_command(std::string("home"));
             }
-            CurrentState = socketMessages::SCK_CART_POS;
+            CurrentState = DesiredState;
+            // first trajectory goal in new mode must be sent
+            mTrajectoryGoalSent = false;
             break;
         default:
-            std::cerr << CMN_LOG_DETAILS << Command.Data.RobotControlState << " state not supported. " << std::endl;
             break;
         }
     }
+    State.Data.CommandRejected = rejected;
 
-    // Only send when in cartesian mode
+    // Only send when in a control mode
     switch (CurrentState) {
     case socketMessages::SCK_CART_POS:
-        // send cartesian goal
-        m_setpoint_cp.Goal().From(Command.Data.GoalPose);
+        if (mJitterBufferEnabled) {
+            // nothing to play or safe hold, don't send new goals
+            const mtsSocketJitterBuffer::PlayoutType playout
+                = mJitterBuffer.Playout(mTimeServer.GetRelativeTime(), mPlayoutPose, mPlayoutJaw);
+            if ((playout == mtsSocketJitterBuffer::EMPTY)
+                || (playout == mtsSocketJitterBuffer::HOLD)) {
+                break;
+            }
+            m_setpoint_cp.Goal().FromNormalized(mPlayoutPose);
+            m_jaw_setpoint_jp.Goal().Element(0) = mPlayoutJaw;
+        } else {
+            // too old, arm holds its last setpoint
+            if (mCommandStale) {
+                break;
+            }
+            m_setpoint_cp.Goal().From(Command.Data.GoalPose);
+            m_jaw_setpoint_jp.Goal().Element(0) = Command.Data.GoalJaw;
+        }
+        // send cartesian and jaw goals
         servo_cp(m_setpoint_cp);
-        // send jaw goal
-        m_jaw_setpoint_jp.Goal().SetSize(1);
+        jaw_servo_jp(m_jaw_setpoint_jp);
+        break;
+    case socketMessages::SCK_JNT_POS:
+        if (mCommandStale) {
+            break;
+        }
+        m_setpoint_jp.Goal().Assign(Command.Data.GoalJoints);
         m_jaw_setpoint_jp.Goal().Element(0) = Command.Data.GoalJaw;
+        servo_jp(m_setpoint_jp);
         jaw_servo_jp(m_jaw_setpoint_jp);
         break;
+    case socketMessages::SCK_CART_TRAJ:
+        // client keeps sending the same goal, only start a new
+        // trajectory when the goal changes
+        if (!mTrajectoryGoalSent
+            || !mTrajectoryGoalPose.Equal(Command.Data.GoalPose)
+            || (mTrajectoryGoalJaw != Command.Data.GoalJaw)) {
+            mTrajectoryGoalSent = true;
+            mTrajectoryGoalPose.Assign(Command.Data.GoalPose);
+            mTrajectoryGoalJaw = Command.Data.GoalJaw;
+            State.Data.GoalReached = false;
+            // jaw first, move_cp keeps the jaw goal
+            m_jaw_setpoint_jp.Goal().Element(0) = mTrajectoryGoalJaw;
+            jaw_move_jp(m_jaw_setpoint_jp);
+            m_setpoint_cp.Goal().From(mTrajectoryGoalPose);
+            move_cp(m_setpoint_cp);
+        }
+        break;
+    case socketMessages::SCK_JNT_TRAJ:
+        if (!mTrajectoryGoalSent
+            || !mTrajectoryGoalJoints.Equal(Command.Data.GoalJoints)
+            || (mTrajectoryGoalJaw != Command.Data.GoalJaw)) {
+            mTrajectoryGoalSent = true;
+            mTrajectoryGoalJoints.Assign(Command.Data.GoalJoints);
+            mTrajectoryGoalJaw = Command.Data.GoalJaw;
+            State.Data.GoalReached = false;
+            // jaw first, move_jp keeps the jaw goal
+            m_jaw_setpoint_jp.Goal().Element(0) = mTrajectoryGoalJaw;
+            jaw_move_jp(m_jaw_setpoint_jp);
+            m_setpoint_jp.Goal().Assign(mTrajectoryGoalJoints);
+            move_jp(m_setpoint_jp);
+        }
+        break;
     default:
         break;
     }
@@ -102,44 +317,70 @@ void mtsSocketServerPSM::ExecutePSMCommands(void)
 
 void mtsSocketServerPSM::ReceivePSMCommandData(void)
 {
-    // Recv Socket Data
-    int bytesRead = 0;
-    bytesRead = Command.Socket->Receive(Command.Buffer, BUFFER_SIZE, TIMEOUT);
+    // Recv Socket Data, decoded in place
+    const int bytesRead = ReceiveLatest(Command.Socket, Command.Buffer);
     if (bytesRead > 0) {
-        if (bytesRead != Command.Data.Header.Size) {
-            std::cerr << CMN_LOG_DETAILS << "Incorrect bytes read " << bytesRead << ". Looking for " << Command.Data.Header.Size << " bytes." << std::endl;
+        if (!mtsSocketWireFormat::Decode(Command.Buffer, bytesRead, Command.Data)) {
+            CMN_LOG_CLASS_RUN_ERROR << "ReceivePSMCommandData: failed to decode "
+                                    << bytesRead << " bytes" << std::endl;
+            return;
         }
-
-        std::stringstream ss;
-        cmnDataFormat local, remote;
-        ss.write(Command.Buffer, bytesRead);
-
-        // Dequeue all the datagrams and only use the latest one.
-        int readCounter = 0;
-        int dataLeft = bytesRead;
-        while (dataLeft > 0) {
-            dataLeft = Command.Socket->Receive(Command.Buffer, BUFFER_SIZE, 0);
-            if (dataLeft != 0) {
-                bytesRead = dataLeft;
-            }
-            readCounter++;
-        }
-
-        if (readCounter > 1) {
-            std::cerr << CMN_LOG_DETAILS << "Catching up : " << readCounter << std::endl;
-        }
-
-        ss.write(Command.Buffer, bytesRead);
-        cmnData<socketCommandPSM>::DeSerializeBinary(Command.Data, ss, local, remote);
-
+        mCommandPacked = mtsSocketWireFormat::IsPacked(Command.Buffer, bytesRead);
         Command.Data.GoalPose.NormalizedSelf();
+        mCommandStale = IsStale(Command.Data.Header);
         ExecutePSMCommands();
-
     } else {
         CMN_LOG_CLASS_RUN_DEBUG << "RecvPSMCommandData: UDP receive failed" << std::endl;
     }
 }
 
+void mtsSocketServerPSM::ReceivePSMCommandDataJitterBuffer(void)
+{
+    // dequeue all datagrams without waiting, all cartesian commands go
+    // in the jitter buffer, state changes use the most recent command
+    const double now = mTimeServer.GetRelativeTime();
+    int bytesRead = Command.Socket->Receive(Command.Buffer, BUFFER_SIZE, 0);
+    while (bytesRead > 0) {
+        if (mtsSocketWireFormat::Decode(Command.Buffer, bytesRead, mReceivedCommand)) {
+            mReceivedCommand.GoalPose.NormalizedSelf();
+            // client restarted
+            if (mReceivedCommand.Header.Id == 1) {
+                mJitterBuffer.Reset();
+            }
+            // stale commands are not buffered, the jitter buffer
+            // extrapolates or holds instead
+            if ((mReceivedCommand.RobotControlState == socketMessages::SCK_CART_POS)
+                && !IsStale(mReceivedCommand.Header)) {
+                mJitterBuffer.Push(mReceivedCommand.Header.Id,
+                                   mReceivedCommand.Header.Timestamp,
+                                   now,
+                                   mReceivedCommand.GoalPose,
+                                   mReceivedCommand.GoalJaw);
+            }
+            if ((mReceivedCommand.Header.Id > Command.Data.Header.Id)
+                || (mReceivedCommand.Header.Id == 1)) {
+                Command.Data = mReceivedCommand;
+                mCommandPacked = mtsSocketWireFormat::IsPacked(Command.Buffer, bytesRead);
+            }
+        } else {
+            CMN_LOG_CLASS_RUN_ERROR << "ReceivePSMCommandDataJitterBuffer: failed to decode "
+                                    << bytesRead << " bytes" << std::endl;
+        }
+        bytesRead = Command.Socket->Receive(Command.Buffer, BUFFER_SIZE, 0);
+    }
+
+    // play out at local rate, even if nothing new was received
+    ExecutePSMCommands();
+
+    const mtsSocketJitterBuffer::Statistics & statistics = mJitterBuffer.GetStatistics();
+    mJitterStatistics.PlayoutDelay = statistics.PlayoutDelay;
+    mJitterStatistics.Jitter = statistics.Jitter;
+    mJitterStatistics.PacketsReordered = statistics.PacketsReordered;
+    mJitterStatistics.PacketsLate = statistics.PacketsLate;
+    mJitterStatistics.Extrapolated = statistics.Extrapolated;
+    mJitterStatistics.Holds = statistics.Holds;
+}
+
 void mtsSocketServerPSM::UpdatePSMState(void)
 {
     // Update PSM State
@@ -149,6 +390,17 @@ void mtsSocketServerPSM::UpdatePSMState(void)
     executionResult = measured_cp(m_measured_cp);
     State.Data.CurrentPose.Assign(m_measured_cp.Position());
 
+    // Get joint positions, snake like tools have more than 6 joints
+    if (measured_js.IsValid()) {
+        measured_js(m_measured_js);
+    }
+    const size_t numberOfJoints = std::min(m_measured_js.Position().size(),
+                                           State.Data.CurrentJoints.size());
+    State.Data.CurrentJoints.SetAll(0.0);
+    for (size_t index = 0; index < numberOfJoints; ++index) {
+        State.Data.CurrentJoints.Element(index) = m_measured_js.Position().Element(index);
+    }
+
     // Get Arm State
     prmOperatingState psmState;
     operating_state(psmState);
@@ -157,8 +409,8 @@ void mtsSocketServerPSM::UpdatePSMState(void)
     if (psmState.State() != prmOperatingState::ENABLED) {
         CurrentState = socketMessages::SCK_UNINITIALIZED;
     } else if (psmState.IsHomed()) {
-        if ((CurrentState != socketMessages::SCK_HOMED)
-            && (CurrentState != socketMessages::SCK_CART_POS)) {
+        // keep control mode if any
+        if (CurrentState < socketMessages::SCK_HOMED) {
             CurrentState = socketMessages::SCK_HOMED;
         }
     } else {
@@ -177,12 +429,14 @@ void mtsSocketServerPSM::SendPSMStateData(void)
     State.Data.Header.LastTimestamp = Command.Data.Header.Timestamp;
     State.Data.RobotControlState = CurrentState;
 
-    // Send Socket Data
-    std::stringstream ss;
-    cmnData<socketStatePSM>::SerializeBinary(State.Data, ss);
-    memcpy(State.Buffer, ss.str().c_str(), ss.str().length());
-
-    State.Socket->Send(State.Buffer, ss.str().size());
+    // Send Socket Data, encoded in place
+    const size_t size = mtsSocketWireFormat::Encode(mWireFormat, State.Data,
+                                                    State.Buffer, BUFFER_SIZE);
+    if (size == 0) {
+        CMN_LOG_CLASS_RUN_ERROR << "SendPSMStateData: failed to encode state" << std::endl;
+        return;
+    }
+    State.Socket->Send(State.Buffer, size);
 }
 
 void mtsSocketServerPSM::ErrorEventHandler(const mtsMessage & CMN_UNUSED(message))
@@ -191,3 +445,8 @@ void mtsSocketServerPSM::ErrorEventHandler(const mtsMessage & CMN_UNUSED(message
     //State.Data.Error = message;
     State.Data.RobotControlState = socketMessages::SCK_UNINITIALIZED;
 }
+
+void mtsSocketServerPSM::GoalReachedEventHandler(const bool & reached)
+{
+    State.Data.GoalReached = reached;
+}
@@ -0,0 +1,191 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-29
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <map>
+
+#include <cisstOSAbstraction/osaGetTime.h>
+#include <cisstOSAbstraction/osaMutex.h>
+#include <cisstOSAbstraction/osaSleep.h>
+#include <sawIntuitiveResearchKit/mtsSocketTransport.h>
+
+std::string mtsSocketTransport::TypeToString(const TransportType type)
+{
+    switch (type) {
+    case UDP:
+        return "udp";
+    case LOOPBACK:
+        return "loopback";
+    }
+    return "unknown";
+}
+
+bool mtsSocketTransport::TypeFromString(const std::string & name, TransportType & type)
+{
+    if (name == "udp") {
+        type = UDP;
+        return true;
+    }
+    if (name == "loopback") {
+        type = LOOPBACK;
+        return true;
+    }
+    return false;
+}
+
+mtsSocketTransportUDP::mtsSocketTransportUDP(void):
+    mSocket(osaSocket::UDP)
+{
+}
+
+bool mtsSocketTransportUDP::SetDestination(const std::string & host, const unsigned short port)
+{
+    mSocket.SetDestination(host, port);
+    return true;
+}
+
+bool mtsSocketTransportUDP::AssignPort(const unsigned short port)
+{
+    return mSocket.AssignPort(port);
+}
+
+int mtsSocketTransportUDP::Send(const char * buffer, const unsigned int size)
+{
+    return mSocket.Send(buffer, size);
+}
+
+int mtsSocketTransportUDP::Receive(char * buffer, const unsigned int maxLength,
+                                   const double timeoutInSeconds)
+{
+    return mSocket.Receive(buffer, maxLength, timeoutInSeconds);
+}
+
+void mtsSocketTransportUDP::Close(void)
+{
+    mSocket.Close();
+}
+
+// emulated link shared by sender and receiver threads
+class mtsSocketTransportLoopback::Link
+{
+public:
+    osaMutex Mutex;
+    mtsSocketImpairment Impairment;
+};
+
+namespace {
+    // links are created on demand and never deleted so components can
+    // be stopped in any order
+    osaMutex & RegistryMutex(void) {
+        static osaMutex mutex;
+        return mutex;
+    }
+
+    std::map<unsigned short, mtsSocketTransportLoopback::Link *> & Registry(void) {
+        static std::map<unsigned short, mtsSocketTransportLoopback::Link *> links;
+        return links;
+    }
+
+    mtsSocketTransportLoopback::Link * GetLink(const unsigned short port, const bool create) {
+        RegistryMutex().Lock();
+        mtsSocketTransportLoopback::Link * link = nullptr;
+        auto found = Registry().find(port);
+        if (found != Registry().end()) {
+            link = found->second;
+        } else if (create) {
+            link = new mtsSocketTransportLoopback::Link;
+            Registry()[port] = link;
+        }
+        RegistryMutex().Unlock();
+        return link;
+    }
+}
+
+mtsSocketTransportLoopback::mtsSocketTransportLoopback(const mtsSocketImpairment::Profile & profile):
+    mProfile(profile),
+    mDestination(nullptr),
+    mSource(nullptr)
+{
+}
+
+bool mtsSocketTransportLoopback::SetDestination(const std::string & CMN_UNUSED(host),
+                                                const unsigned short port)
+{
+    mDestination = GetLink(port, true);
+    mDestination->Mutex.Lock();
+    mDestination->Impairment.Configure(mProfile);
+    mDestination->Mutex.Unlock();
+    return true;
+}
+
+bool mtsSocketTransportLoopback::AssignPort(const unsigned short port)
+{
+    mSource = GetLink(port, true);
+    return true;
+}
+
+int mtsSocketTransportLoopback::Send(const char * buffer, const unsigned int size)
+{
+    if (!mDestination) {
+        return -1;
+    }
+    mDestination->Mutex.Lock();
+    // datagrams lost on the link are not errors for the sender
+    mDestination->Impairment.Send(buffer, size, osaGetTime());
+    mDestination->Mutex.Unlock();
+    return size;
+}
+
+int mtsSocketTransportLoopback::Receive(char * buffer, const unsigned int maxLength,
+                                        const double timeoutInSeconds)
+{
+    if (!mSource) {
+        return -1;
+    }
+    const double pollPeriod = mtsIntuitiveResearchKit::SocketImpairment::PollPeriod;
+    const double deadline = osaGetTime() + timeoutInSeconds;
+    while (true) {
+        const double now = osaGetTime();
+        mSource->Mutex.Lock();
+        const int bytesRead = mSource->Impairment.Receive(buffer, maxLength, now);
+        mSource->Mutex.Unlock();
+        if ((bytesRead != 0) || (now >= deadline)) {
+            return bytesRead;
+        }
+        osaSleep(std::min(pollPeriod, deadline - now));
+    }
+}
+
+void mtsSocketTransportLoopback::Close(void)
+{
+    mDestination = nullptr;
+    mSource = nullptr;
+}
+
+bool mtsSocketTransportLoopback::GetStatistics(const unsigned short port,
+                                               mtsSocketImpairment::Statistics & statistics)
+{
+    Link * link = GetLink(port, false);
+    if (!link) {
+        return false;
+    }
+    link->Mutex.Lock();
+    statistics = link->Impairment.GetStatistics();
+    link->Mutex.Unlock();
+    return true;
+}
@@ -0,0 +1,643 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include <sawIntuitiveResearchKit/mtsSocketWireFormat.h>
+
+const uint32_t mtsSocketWireFormat::Magic;
+const uint16_t mtsSocketWireFormat::Version;
+const size_t mtsSocketWireFormat::HeaderSize;
+const size_t mtsSocketWireFormat::MessagePSMSize;
+const size_t mtsSocketWireFormat::MessageStateMTMSize;
+const size_t mtsSocketWireFormat::MessageCommandMTMSize;
+const size_t mtsSocketWireFormat::MessageStateECMSize;
+const size_t mtsSocketWireFormat::MessageCommandECMSize;
+const uint32_t mtsSocketWireFormat::FlagGoalReached;
+const uint32_t mtsSocketWireFormat::FlagLockOrientation;
+const uint32_t mtsSocketWireFormat::FlagGravityCompensation;
+const uint32_t mtsSocketWireFormat::FlagWrenchOrientationAbsolute;
+const uint32_t mtsSocketWireFormat::FlagCommandRejected;
+const uint32_t mtsSocketWireFormat::BridgeMagic;
+const size_t mtsSocketWireFormat::BridgeHeaderSize;
+const size_t mtsSocketWireFormat::ChannelHeaderSize;
+const size_t mtsSocketWireFormat::BridgeChannelSize;
+
+namespace {
+
+    inline bool HostIsLittleEndian(void) {
+        const uint16_t one = 1;
+        return (*reinterpret_cast<const unsigned char *>(&one) == 1);
+    }
+
+    template <typename _type>
+    inline void WriteLE(char * buffer, const _type value) {
+        memcpy(buffer, &value, sizeof(_type));
+        if (!HostIsLittleEndian()) {
+            std::reverse(buffer, buffer + sizeof(_type));
+        }
+    }
+
+    template <typename _type>
+    inline _type ReadLE(const char * buffer) {
+        char bytes[sizeof(_type)];
+        memcpy(bytes, buffer, sizeof(_type));
+        if (!HostIsLittleEndian()) {
+            std::reverse(bytes, bytes + sizeof(_type));
+        }
+        _type value;
+        memcpy(&value, bytes, sizeof(_type));
+        return value;
+    }
+
+    // offsets, see layout in header file
+    const size_t OffsetMagic = 0;
+    const size_t OffsetVersion = 4;
+    const size_t OffsetSize = 6; // number of channels for bridge header
+    const size_t OffsetId = 8;
+    const size_t OffsetLastId = 12;
+    const size_t OffsetTimestamp = 16;
+    const size_t OffsetLastTimestamp = 24;
+    const size_t OffsetState = 32;
+    const size_t OffsetFlags = 36;
+    const size_t OffsetTranslation = 40;
+    const size_t OffsetJaw = 136;
+    const size_t OffsetJoints = 144;
+    // MTM and ECM
+    const size_t OffsetSetpoint = 136;
+    const size_t OffsetMTMTwist = 232;
+    const size_t OffsetMTMGripper = 280;
+    const size_t OffsetMTMOrientation = 136;
+    const size_t OffsetMTMWrench = 208;
+    const size_t OffsetECMMeasuredJoints = 232;
+    const size_t OffsetECMSetpointJoints = 264;
+    const size_t OffsetECMGoalJoints = 40;
+
+    // common to all packed messages
+    void EncodePackedHeader(socketHeader & header, const size_t size,
+                            const socketMessages::StateType state,
+                            const uint32_t flags,
+                            char * buffer)
+    {
+        header.Size = static_cast<int>(size);
+        WriteLE<uint32_t>(buffer + OffsetMagic, mtsSocketWireFormat::Magic);
+        WriteLE<uint16_t>(buffer + OffsetVersion, mtsSocketWireFormat::Version);
+        WriteLE<uint16_t>(buffer + OffsetSize, static_cast<uint16_t>(size));
+        WriteLE<uint32_t>(buffer + OffsetId, header.Id);
+        WriteLE<uint32_t>(buffer + OffsetLastId, header.LastId);
+        WriteLE<double>(buffer + OffsetTimestamp, header.Timestamp);
+        WriteLE<double>(buffer + OffsetLastTimestamp, header.LastTimestamp);
+        WriteLE<uint32_t>(buffer + OffsetState, static_cast<uint32_t>(state));
+        WriteLE<uint32_t>(buffer + OffsetFlags, flags);
+    }
+
+    bool DecodePackedHeader(const char * buffer, const size_t size,
+                            const size_t expectedSize,
+                            socketHeader & header,
+                            socketMessages::StateType & state,
+                            uint32_t & flags)
+    {
+        if (size < expectedSize) {
+            return false;
+        }
+        const uint16_t version = ReadLE<uint16_t>(buffer + OffsetVersion);
+        if (version != mtsSocketWireFormat::Version) {
+            return false;
+        }
+        const uint16_t messageSize = ReadLE<uint16_t>(buffer + OffsetSize);
+        if ((messageSize < expectedSize)
+            || (messageSize > size)) {
+            return false;
+        }
+        const uint32_t stateValue = ReadLE<uint32_t>(buffer + OffsetState);
+        if (stateValue > static_cast<uint32_t>(socketMessages::SCK_CART_EFFORT)) {
+            return false;
+        }
+        header.Version = version;
+        header.Size = messageSize;
+        header.Id = ReadLE<uint32_t>(buffer + OffsetId);
+        header.LastId = ReadLE<uint32_t>(buffer + OffsetLastId);
+        header.Timestamp = ReadLE<double>(buffer + OffsetTimestamp);
+        header.LastTimestamp = ReadLE<double>(buffer + OffsetLastTimestamp);
+        state = static_cast<socketMessages::StateType>(stateValue);
+        flags = ReadLE<uint32_t>(buffer + OffsetFlags);
+        return true;
+    }
+
+    template <typename _vectorType>
+    char * WriteVector(char * buffer, const _vectorType & vector)
+    {
+        for (size_t index = 0; index < vector.size(); ++index) {
+            WriteLE<double>(buffer, vector.Element(index));
+            buffer += sizeof(double);
+        }
+        return buffer;
+    }
+
+    template <typename _vectorType>
+    const char * ReadVector(const char * buffer, _vectorType & vector)
+    {
+        for (size_t index = 0; index < vector.size(); ++index) {
+            vector.Element(index) = ReadLE<double>(buffer);
+            buffer += sizeof(double);
+        }
+        return buffer;
+    }
+
+    // row major
+    char * WriteRotation(char * buffer, const vctMatRot3 & rotation)
+    {
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t col = 0; col < 3; ++col) {
+                WriteLE<double>(buffer, rotation.Element(row, col));
+                buffer += sizeof(double);
+            }
+        }
+        return buffer;
+    }
+
+    const char * ReadRotation(const char * buffer, vctMatRot3 & rotation)
+    {
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t col = 0; col < 3; ++col) {
+                rotation.Element(row, col) = ReadLE<double>(buffer);
+                buffer += sizeof(double);
+            }
+        }
+        return buffer;
+    }
+
+    // translation then rotation
+    char * WriteFrame(char * buffer, const vctFrm3 & frame)
+    {
+        buffer = WriteVector(buffer, frame.Translation());
+        return WriteRotation(buffer, frame.Rotation());
+    }
+
+    const char * ReadFrame(const char * buffer, vctFrm3 & frame)
+    {
+        buffer = ReadVector(buffer, frame.Translation());
+        return ReadRotation(buffer, frame.Rotation());
+    }
+
+    // PSM state and command messages have the same layout
+    size_t EncodePacked(socketHeader & header,
+                        const socketMessages::StateType state,
+                        const uint32_t flags,
+                        const vctFrm3 & frame,
+                        const double jaw,
+                        const vct6 & joints,
+                        char * buffer, const size_t bufferSize)
+    {
+        const size_t size = mtsSocketWireFormat::MessagePSMSize;
+        if (bufferSize < size) {
+            return 0;
+        }
+        EncodePackedHeader(header, size, state, flags, buffer);
+        WriteFrame(buffer + OffsetTranslation, frame);
+        WriteLE<double>(buffer + OffsetJaw, jaw);
+        WriteVector(buffer + OffsetJoints, joints);
+        return size;
+    }
+
+    bool DecodePacked(const char * buffer, const size_t size,
+                      socketHeader & header,
+                      socketMessages::StateType & state,
+                      uint32_t & flags,
+                      vctFrm3 & frame,
+                      double & jaw,
+                      vct6 & joints)
+    {
+        if (!DecodePackedHeader(buffer, size, mtsSocketWireFormat::MessagePSMSize,
+                                header, state, flags)) {
+            return false;
+        }
+        ReadFrame(buffer + OffsetTranslation, frame);
+        jaw = ReadLE<double>(buffer + OffsetJaw);
+        ReadVector(buffer + OffsetJoints, joints);
+        return true;
+    }
+
+    // legacy format, cmnData binary serialization
+    template <typename _messageType>
+    size_t EncodeCDG(_messageType & data,
+                     char * buffer, const size_t bufferSize)
+    {
+        std::stringstream stream;
+        cmnData<_messageType>::SerializeBinary(data, stream);
+        std::string serialized = stream.str();
+        // all fields have a fixed size so this only happens once, on
+        // first message
+        if (data.Header.Size != static_cast<int>(serialized.size())) {
+            data.Header.Size = static_cast<int>(serialized.size());
+            stream.str("");
+            cmnData<_messageType>::SerializeBinary(data, stream);
+            serialized = stream.str();
+        }
+        if (bufferSize < serialized.size()) {
+            return 0;
+        }
+        memcpy(buffer, serialized.data(), serialized.size());
+        return serialized.size();
+    }
+
+    template <typename _messageType>
+    bool DecodeCDG(const char * buffer, const size_t size,
+                   _messageType & data)
+    {
+        std::stringstream stream;
+        cmnDataFormat local, remote;
+        stream.write(buffer, size);
+        try {
+            cmnData<_messageType>::DeSerializeBinary(data, stream, local, remote);
+        } catch (std::exception &) {
+            return false;
+        }
+        return true;
+    }
+}
+
+std::string mtsSocketWireFormat::FormatToString(const FormatType format)
+{
+    switch (format) {
+    case PACKED:
+        return "packed";
+    case CDG:
+        return "cdg";
+    }
+    return "unknown";
+}
+
+bool mtsSocketWireFormat::FormatFromString(const std::string & name, FormatType & format)
+{
+    if (name == "packed") {
+        format = PACKED;
+        return true;
+    }
+    if (name == "cdg") {
+        format = CDG;
+        return true;
+    }
+    return false;
+}
+
+bool mtsSocketWireFormat::IsPacked(const char * buffer, const size_t size)
+{
+    if (size < HeaderSize) {
+        return false;
+    }
+    return (ReadLE<uint32_t>(buffer + OffsetMagic) == Magic);
+}
+
+size_t mtsSocketWireFormat::Encode(const FormatType format, socketStatePSM & data,
+                                   char * buffer, const size_t bufferSize)
+{
+    if (format == CDG) {
+        // legacy layout, joints and goal reached are not sent
+        socketStatePSMv1 legacy;
+        legacy.Header = data.Header;
+        legacy.RobotControlState = data.RobotControlState;
+        legacy.CurrentPose = data.CurrentPose;
+        legacy.CurrentJaw = data.CurrentJaw;
+        const size_t size = EncodeCDG(legacy, buffer, bufferSize);
+        data.Header.Size = legacy.Header.Size;
+        return size;
+    }
+    return EncodePacked(data.Header, data.RobotControlState,
+                        (data.GoalReached ? FlagGoalReached : 0)
+                        | (data.CommandRejected ? FlagCommandRejected : 0),
+                        data.CurrentPose, data.CurrentJaw, data.CurrentJoints,
+                        buffer, bufferSize);
+}
+
+size_t mtsSocketWireFormat::Encode(const FormatType format, socketCommandPSM & data,
+                                   char * buffer, const size_t bufferSize)
+{
+    if (format == CDG) {
+        // legacy layout, joints are not sent
+        socketCommandPSMv1 legacy;
+        legacy.Header = data.Header;
+        legacy.RobotControlState = data.RobotControlState;
+        legacy.GoalPose = data.GoalPose;
+        legacy.GoalJaw = data.GoalJaw;
+        const size_t size = EncodeCDG(legacy, buffer, bufferSize);
+        data.Header.Size = legacy.Header.Size;
+        return size;
+    }
+    return EncodePacked(data.Header, data.RobotControlState, 0,
+                        data.GoalPose, data.GoalJaw, data.GoalJoints,
+                        buffer, bufferSize);
+}
+
+bool mtsSocketWireFormat::Decode(const char * buffer, const size_t size,
+                                 socketStatePSM & data)
+{
+    if (IsPacked(buffer, size)) {
+        uint32_t flags;
+        if (!DecodePacked(buffer, size, data.Header, data.RobotControlState, flags,
+                          data.CurrentPose, data.CurrentJaw, data.CurrentJoints)) {
+            return false;
+        }
+        data.GoalReached = ((flags & FlagGoalReached) != 0);
+        data.CommandRejected = ((flags & FlagCommandRejected) != 0);
+        return true;
+    }
+    socketStatePSMv1 legacy;
+    if (!DecodeCDG(buffer, size, legacy)) {
+        return false;
+    }
+    data.Header = legacy.Header;
+    data.RobotControlState = legacy.RobotControlState;
+    data.CurrentPose = legacy.CurrentPose;
+    data.CurrentJaw = legacy.CurrentJaw;
+    data.CurrentJoints.SetAll(0.0);
+    data.GoalReached = false;
+    data.CommandRejected = false;
+    return true;
+}
+
+bool mtsSocketWireFormat::Decode(const char * buffer, const size_t size,
+                                 socketCommandPSM & data)
+{
+    if (IsPacked(buffer, size)) {
+        uint32_t flags;
+        return DecodePacked(buffer, size, data.Header, data.RobotControlState, flags,
+                            data.GoalPose, data.GoalJaw, data.GoalJoints);
+    }
+    socketCommandPSMv1 legacy;
+    if (!DecodeCDG(buffer, size, legacy)) {
+        return false;
+    }
+    data.Header = legacy.Header;
+    data.RobotControlState = legacy.RobotControlState;
+    data.GoalPose = legacy.GoalPose;
+    data.GoalJaw = legacy.GoalJaw;
+    data.GoalJoints.SetAll(0.0);
+    return true;
+}
+
+size_t mtsSocketWireFormat::Encode(const FormatType format, socketStateMTM & data,
+                                   char * buffer, const size_t bufferSize)
+{
+    if (format == CDG) {
+        return EncodeCDG(data, buffer, bufferSize);
+    }
+    const size_t size = MessageStateMTMSize;
+    if (bufferSize < size) {
+        return 0;
+    }
+    EncodePackedHeader(data.Header, size, data.RobotControlState,
+                       data.GoalReached ? FlagGoalReached : 0, buffer);
+    WriteFrame(buffer + OffsetTranslation, data.MeasuredPose);
+    WriteFrame(buffer + OffsetSetpoint, data.SetpointPose);
+    WriteVector(buffer + OffsetMTMTwist, data.MeasuredTwist);
+    WriteLE<double>(buffer + OffsetMTMGripper, data.Gripper);
+    return size;
+}
+
+size_t mtsSocketWireFormat::Encode(const FormatType format, socketCommandMTM & data,
+                                   char * buffer, const size_t bufferSize)
+{
+    if (format == CDG) {
+        return EncodeCDG(data, buffer, bufferSize);
+    }
+    const size_t size = MessageCommandMTMSize;
+    if (bufferSize < size) {
+        return 0;
+    }
+    uint32_t flags = 0;
+    if (data.LockOrientation) {
+        flags |= FlagLockOrientation;
+    }
+    if (data.GravityCompensation) {
+        flags |= FlagGravityCompensation;
+    }
+    if (data.WrenchOrientationAbsolute) {
+        flags |= FlagWrenchOrientationAbsolute;
+    }
+    EncodePackedHeader(data.Header, size, data.RobotControlState, flags, buffer);
+    WriteFrame(buffer + OffsetTranslation, data.GoalPose);
+    WriteRotation(buffer + OffsetMTMOrientation, data.Orientation);
+    WriteVector(buffer + OffsetMTMWrench, data.Wrench);
+    return size;
+}
+
+size_t mtsSocketWireFormat::Encode(const FormatType format, socketStateECM & data,
+                                   char * buffer, const size_t bufferSize)
+{
+    if (format == CDG) {
+        return EncodeCDG(data, buffer, bufferSize);
+    }
+    const size_t size = MessageStateECMSize;
+    if (bufferSize < size) {
+        return 0;
+    }
+    EncodePackedHeader(data.Header, size, data.RobotControlState,
+                       data.GoalReached ? FlagGoalReached : 0, buffer);
+    WriteFrame(buffer + OffsetTranslation, data.MeasuredPose);
+    WriteFrame(buffer + OffsetSetpoint, data.SetpointPose);
+    WriteVector(buffer + OffsetECMMeasuredJoints, data.MeasuredJoints);
+    WriteVector(buffer + OffsetECMSetpointJoints, data.SetpointJoints);
+    return size;
+}
+
+size_t mtsSocketWireFormat::Encode(const FormatType format, socketCommandECM & data,
+                                   char * buffer, const size_t bufferSize)
+{
+    if (format == CDG) {
+        return EncodeCDG(data, buffer, bufferSize);
+    }
+    const size_t size = MessageCommandECMSize;
+    if (bufferSize < size) {
+        return 0;
+    }
+    EncodePackedHeader(data.Header, size, data.RobotControlState, 0, buffer);
+    WriteVector(buffer + OffsetECMGoalJoints, data.GoalJoints);
+    return size;
+}
+
+bool mtsSocketWireFormat::Decode(const char * buffer, const size_t size,
+                                 socketStateMTM & data)
+{
+    if (IsPacked(buffer, size)) {
+        uint32_t flags;
+        if (!DecodePackedHeader(buffer, size, MessageStateMTMSize,
+                                data.Header, data.RobotControlState, flags)) {
+            return false;
+        }
+        data.GoalReached = ((flags & FlagGoalReached) != 0);
+        ReadFrame(buffer + OffsetTranslation, data.MeasuredPose);
+        ReadFrame(buffer + OffsetSetpoint, data.SetpointPose);
+        ReadVector(buffer + OffsetMTMTwist, data.MeasuredTwist);
+        data.Gripper = ReadLE<double>(buffer + OffsetMTMGripper);
+        return true;
+    }
+    return DecodeCDG(buffer, size, data);
+}
+
+bool mtsSocketWireFormat::Decode(const char * buffer, const size_t size,
+                                 socketCommandMTM & data)
+{
+    if (IsPacked(buffer, size)) {
+        uint32_t flags;
+        if (!DecodePackedHeader(buffer, size, MessageCommandMTMSize,
+                                data.Header, data.RobotControlState, flags)) {
+            return false;
+        }
+        data.LockOrientation = ((flags & FlagLockOrientation) != 0);
+        data.GravityCompensation = ((flags & FlagGravityCompensation) != 0);
+        data.WrenchOrientationAbsolute = ((flags & FlagWrenchOrientationAbsolute) != 0);
+        ReadFrame(buffer + OffsetTranslation, data.GoalPose);
+        ReadRotation(buffer + OffsetMTMOrientation, data.Orientation);
+        ReadVector(buffer + OffsetMTMWrench, data.Wrench);
+        return true;
+    }
+    return DecodeCDG(buffer, size, data);
+}
+
+bool mtsSocketWireFormat::Decode(const char * buffer, const size_t size,
+                                 socketStateECM & data)
+{
+    if (IsPacked(buffer, size)) {
+        uint32_t flags;
+        if (!DecodePackedHeader(buffer, size, MessageStateECMSize,
+                                data.Header, data.RobotControlState, flags)) {
+            return false;
+        }
+        data.GoalReached = ((flags & FlagGoalReached) != 0);
+        ReadFrame(buffer + OffsetTranslation, data.MeasuredPose);
+        ReadFrame(buffer + OffsetSetpoint, data.SetpointPose);
+        ReadVector(buffer + OffsetECMMeasuredJoints, data.MeasuredJoints);
+        ReadVector(buffer + OffsetECMSetpointJoints, data.SetpointJoints);
+        return true;
+    }
+    return DecodeCDG(buffer, size, data);
+}
+
+bool mtsSocketWireFormat::Decode(const char * buffer, const size_t size,
+                                 socketCommandECM & data)
+{
+    if (IsPacked(buffer, size)) {
+        uint32_t flags;
+        if (!DecodePackedHeader(buffer, size, MessageCommandECMSize,
+                                data.Header, data.RobotControlState, flags)) {
+            return false;
+        }
+        ReadVector(buffer + OffsetECMGoalJoints, data.GoalJoints);
+        return true;
+    }
+    return DecodeCDG(buffer, size, data);
+}
+
+size_t mtsSocketWireFormat::BridgeChannelStateSize(const ChannelType type)
+{
+    switch (type) {
+    case CHANNEL_MTM:
+        return ChannelHeaderSize + MessageStateMTMSize;
+    case CHANNEL_ECM:
+        return ChannelHeaderSize + MessageStateECMSize;
+    default:
+        return ChannelHeaderSize + MessagePSMSize;
+    }
+}
+
+size_t mtsSocketWireFormat::BridgeChannelCommandSize(const ChannelType type)
+{
+    switch (type) {
+    case CHANNEL_MTM:
+        return ChannelHeaderSize + MessageCommandMTMSize;
+    case CHANNEL_ECM:
+        return ChannelHeaderSize + MessageCommandECMSize;
+    default:
+        return ChannelHeaderSize + MessagePSMSize;
+    }
+}
+
+size_t mtsSocketWireFormat::EncodeBridgeHeader(const socketHeader & header, const size_t numberOfChannels,
+                                               char * buffer, const size_t bufferSize)
+{
+    if (bufferSize < BridgeHeaderSize) {
+        return 0;
+    }
+    WriteLE<uint32_t>(buffer + OffsetMagic, BridgeMagic);
+    WriteLE<uint16_t>(buffer + OffsetVersion, Version);
+    WriteLE<uint16_t>(buffer + OffsetSize, static_cast<uint16_t>(numberOfChannels));
+    WriteLE<uint32_t>(buffer + OffsetId, header.Id);
+    WriteLE<uint32_t>(buffer + OffsetLastId, header.LastId);
+    WriteLE<double>(buffer + OffsetTimestamp, header.Timestamp);
+    WriteLE<double>(buffer + OffsetLastTimestamp, header.LastTimestamp);
+    return BridgeHeaderSize;
+}
+
+bool mtsSocketWireFormat::DecodeBridgeHeader(const char * buffer, const size_t size,
+                                             socketHeader & header, size_t & numberOfChannels)
+{
+    if (size < BridgeHeaderSize) {
+        return false;
+    }
+    if ((ReadLE<uint32_t>(buffer + OffsetMagic) != BridgeMagic)
+        || (ReadLE<uint16_t>(buffer + OffsetVersion) != Version)) {
+        return false;
+    }
+    numberOfChannels = ReadLE<uint16_t>(buffer + OffsetSize);
+    // channels have different sizes, check all fit in buffer
+    size_t offset = BridgeHeaderSize;
+    for (size_t index = 0; index < numberOfChannels; ++index) {
+        if (size < (offset + ChannelHeaderSize + HeaderSize)) {
+            return false;
+        }
+        const size_t channelSize = DecodeChannelSize(buffer + offset);
+        if ((channelSize < (ChannelHeaderSize + HeaderSize))
+            || (size < (offset + channelSize))) {
+            return false;
+        }
+        offset += channelSize;
+    }
+    header.Version = Version;
+    header.Size = static_cast<int>(offset);
+    header.Id = ReadLE<uint32_t>(buffer + OffsetId);
+    header.LastId = ReadLE<uint32_t>(buffer + OffsetLastId);
+    header.Timestamp = ReadLE<double>(buffer + OffsetTimestamp);
+    header.LastTimestamp = ReadLE<double>(buffer + OffsetLastTimestamp);
+    return true;
+}
+
+void mtsSocketWireFormat::EncodeChannelId(const unsigned int channel, char * buffer,
+                                          const ChannelType type)
+{
+    WriteLE<uint16_t>(buffer, static_cast<uint16_t>(channel));
+    WriteLE<uint16_t>(buffer + 2, static_cast<uint16_t>(type));
+}
+
+unsigned int mtsSocketWireFormat::DecodeChannelId(const char * buffer)
+{
+    return ReadLE<uint16_t>(buffer);
+}
+
+unsigned int mtsSocketWireFormat::DecodeChannelType(const char * buffer)
+{
+    return ReadLE<uint16_t>(buffer + 2);
+}
+
+size_t mtsSocketWireFormat::DecodeChannelSize(const char * buffer)
+{
+    // size of packed message after channel header
+    return ChannelHeaderSize + ReadLE<uint16_t>(buffer + ChannelHeaderSize + OffsetSize);
+}
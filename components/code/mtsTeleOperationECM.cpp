@@ -22,10 +22,13 @@ http://www.cisst.org/cisst/license.txt.
 
 // cisst
 #include <sawIntuitiveResearchKit/mtsTeleOperationECM.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLog.h>
 
 #include <cisstCommon/cmnUnits.h>
 #include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstMultiTask/mtsInterfaceRequired.h>
+#include <cisstMultiTask/mtsManagerLocal.h>
 #include <cisstParameterTypes/prmOperatingState.h>
 #include <cisstParameterTypes/prmForceCartesianSet.h>
 
@@ -33,14 +36,16 @@ CMN_IMPLEMENT_SERVICES_DERIVED_ONEARG(mtsTeleOperationECM, mtsTaskPeriodic, mtsT
 
 mtsTeleOperationECM::mtsTeleOperationECM(const std::string & componentName, const double periodInSeconds):
     mtsTaskPeriodic(componentName, periodInSeconds),
-    mTeleopState(componentName, "DISABLED")
+    mTeleopState(componentName, "DISABLED"),
+    mMessages(mtsIntuitiveResearchKit::Messages::Interval)
 {
     Init();
 }
 
 mtsTeleOperationECM::mtsTeleOperationECM(const mtsTaskPeriodicConstructorArg & arg):
     mtsTaskPeriodic(arg),
-    mTeleopState(arg.Name, "DISABLED")
+    mTeleopState(arg.Name, "DISABLED"),
+    mMessages(mtsIntuitiveResearchKit::Messages::Interval)
 {
     Init();
 }
@@ -90,10 +95,14 @@ void mtsTeleOperationECM::Init(void)
 
     m_scale = 0.2;
     m_clutched = false;
+    m_clutch_latency = 0.0;
 
     StateTable.AddData(mMTML.m_measured_cp, "MTML/measured_cp");
     StateTable.AddData(mMTMR.m_measured_cp, "MTMR/measured_cp");
     StateTable.AddData(mECM.m_measured_cp, "ECM/measured_cp");
+    StateTable.AddData(m_clutch_latency, "clutch_latency");
+    StateTable.AddData(m_following, "following");
+    StateTable.AddData(m_clutched, "clutched");
 
     mConfigurationStateTable = new mtsStateTable(100, "Configuration");
     mConfigurationStateTable->SetAutomaticAdvance(false);
@@ -190,6 +199,19 @@ void mtsTeleOperationECM::Init(void)
         mInterface->AddCommandReadState(StateTable,
                                         mECM.m_measured_cp,
                                         "ECM/measured_cp");
+        mInterface->AddCommandReadState(StateTable,
+                                        m_clutch_latency,
+                                        "clutch_latency");
+        mInterface->AddCommandReadState(StateTable,
+                                        m_following,
+                                        "following");
+        mInterface->AddCommandReadState(StateTable,
+                                        m_clutched,
+                                        "clutched");
+        // used by the console to forward emulated clutch events when
+        // the clutch is connected directly to the footpedal source
+        mInterface->AddCommandWrite(&mtsTeleOperationECM::ClutchEventHandler, this,
+                                    "emulate_clutch", prmEventButton());
         // events
         mInterface->AddEventWrite(MessageEvents.desired_state,
                                   "desired_state", std::string(""));
@@ -252,6 +274,8 @@ void mtsTeleOperationECM::Configure(const Json::Value & jsonConfig)
 void mtsTeleOperationECM::Startup(void)
 {
     CMN_LOG_CLASS_INIT_VERBOSE << "Startup" << std::endl;
+    // allocate log queue now, not in first error
+    mtsIntuitiveResearchKitLog::RegisterThread();
     set_scale(m_scale);
     set_following(false);
 }
@@ -263,6 +287,16 @@ void mtsTeleOperationECM::Run(void)
 
     // run based on state
     mTeleopState.Run();
+
+    // send aggregated errors
+    mMessages.Process(Now(),
+                      [this](const mtsIntuitiveResearchKitMessageAggregator::LevelType CMN_UNUSED(level),
+                             const std::string & text) {
+                          mInterface->SendError(this->GetName() + ": " + text);
+                      });
+
+    // trigger ExecOut event
+    RunEvent();
 }
 
 void mtsTeleOperationECM::Cleanup(void)
@@ -270,6 +304,13 @@ void mtsTeleOperationECM::Cleanup(void)
     CMN_LOG_CLASS_INIT_VERBOSE << "Cleanup" << std::endl;
 }
 
+void mtsTeleOperationECM::SendAggregatedError(const char * message)
+{
+    if (!mMessages.Add(mtsIntuitiveResearchKitMessageAggregator::MESSAGE_ERROR, message)) {
+        mInterface->SendError(this->GetName() + ": " + message);
+    }
+}
+
 void mtsTeleOperationECM::StateChanged(void)
 {
     const std::string newState = mTeleopState.CurrentState();
@@ -284,49 +325,43 @@ void mtsTeleOperationECM::RunAllStates(void)
     // get MTML Cartesian position/velocity
     executionResult = mMTML.measured_cp(mMTML.m_measured_cp);
     if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << "Run: call to MTML.measured_cp failed \""
-                                << executionResult << "\"" << std::endl;
-        mInterface->SendError(this->GetName() + ": unable to get cartesian position from MTML");
+        mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to MTML.measured_cp failed", executionResult);
+        SendAggregatedError("unable to get cartesian position from MTML");
         mTeleopState.SetDesiredState("DISABLED");
     }
     executionResult = mMTML.measured_cv(mMTML.m_measured_cv);
     if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << "Run: call to MTML.measured_cv failed \""
-                                << executionResult << "\"" << std::endl;
-        mInterface->SendError(this->GetName() + ": unable to get cartesian velocity from MTML");
+        mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to MTML.measured_cv failed", executionResult);
+        SendAggregatedError("unable to get cartesian velocity from MTML");
         mTeleopState.SetDesiredState("DISABLED");
     }
 
     // get MTMR Cartesian position
     executionResult = mMTMR.measured_cp(mMTMR.m_measured_cp);
     if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << "Run: call to MTMR.measured_cp failed \""
-                                << executionResult << "\"" << std::endl;
-        mInterface->SendError(this->GetName() + ": unable to get cartesian position from MTMR");
+        mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to MTMR.measured_cp failed", executionResult);
+        SendAggregatedError("unable to get cartesian position from MTMR");
         mTeleopState.SetDesiredState("DISABLED");
     }
     executionResult = mMTMR.measured_cv(mMTMR.m_measured_cv);
     if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << "Run: call to MTMR.measured_cv failed \""
-                                << executionResult << "\"" << std::endl;
-        mInterface->SendError(this->GetName() + ": unable to get cartesian velocity from MTMR");
+        mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to MTMR.measured_cv failed", executionResult);
+        SendAggregatedError("unable to get cartesian velocity from MTMR");
         mTeleopState.SetDesiredState("DISABLED");
     }
 
     // get ECM Cartesian position for GUI
     executionResult = mECM.measured_cp(mECM.m_measured_cp);
     if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << "Run: call to ECM.measured_cp failed \""
-                                << executionResult << "\"" << std::endl;
-        mInterface->SendError(this->GetName() + ": unable to get cartesian position from ECM");
+        mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to ECM.measured_cp failed", executionResult);
+        SendAggregatedError("unable to get cartesian position from ECM");
         mTeleopState.SetDesiredState("DISABLED");
     }
     // for motion computation
     executionResult = mECM.setpoint_js(mECM.m_setpoint_js);
     if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << "Run: call to ECM.setpoint_js failed \""
-                                << executionResult << "\"" << std::endl;
-        mInterface->SendError(this->GetName() + ": unable to get joint state from ECM");
+        mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to ECM.setpoint_js failed", executionResult);
+        SendAggregatedError("unable to get joint state from ECM");
         mTeleopState.SetDesiredState("DISABLED");
     }
 
@@ -373,7 +408,7 @@ void mtsTeleOperationECM::TransitionDisabled(void)
 void mtsTeleOperationECM::EnterSettingArmsState(void)
 {
     // reset timer
-    mInStateTimer = StateTable.GetTic();
+    mInStateTimer = Now();
 
     // request state if needed
     prmOperatingState state;
@@ -416,7 +451,7 @@ void mtsTeleOperationECM::TransitionSettingArmsState(void)
         return;
     }
     // check timer
-    if ((StateTable.GetTic() - mInStateTimer) > 60.0 * cmn_s) {
+    if ((Now() - mInStateTimer) > 60.0 * cmn_s) {
         mInterface->SendError(this->GetName() + ": timed out while setting up arms state");
         mTeleopState.SetDesiredState("DISABLED");
     }
@@ -424,6 +459,14 @@ void mtsTeleOperationECM::TransitionSettingArmsState(void)
 
 void mtsTeleOperationECM::EnterEnabled(void)
 {
+    // ECM joint goal is sized once, RunEnabled only assigns values
+    if (mECM.m_setpoint_js.Position().size() != 4) {
+        mInterface->SendError(this->GetName() + ": ECM setpoint_js must have 4 joints");
+        mTeleopState.SetDesiredState("DISABLED");
+        return;
+    }
+    mECM.m_servo_jp.Goal().SetSize(4);
+
     // set cartesian effort parameters
     mMTML.use_gravity_compensation(true);
     mMTML.body_set_cf_orientation_absolute(true);
@@ -432,54 +475,15 @@ void mtsTeleOperationECM::EnterEnabled(void)
     mMTMR.body_set_cf_orientation_absolute(true);
     mMTMR.lock_orientation(mMTMR.m_measured_cp.Position().Rotation());
 
-    // initial state for MTM force feedback
-    // -1- initial distance between MTMs
-    vct3 vectorLR;
-    vectorLR.DifferenceOf(mMTMR.m_measured_cp.Position().Translation(),
-                          mMTML.m_measured_cp.Position().Translation());
-    // -2- mid-point, aka center of image
-    mInitial.C.SumOf(mMTMR.m_measured_cp.Position().Translation(),
-                     mMTML.m_measured_cp.Position().Translation());
-    mInitial.C.Multiply(0.5);
-    // -3- image up vector
-    mInitial.Up.CrossProductOf(vectorLR, mInitial.C);
-    mInitial.Up.NormalizedSelf();
-    // -4- width of image, depth of arms wrt image plan
-    vct3 side;
-    side.CrossProductOf(mInitial.C, mInitial.Up);
-    side.NormalizedSelf();
-    mInitial.w = 0.5 * vctDotProduct(side, vectorLR);
-    mInitial.d = 0.5 * vctDotProduct(mInitial.C.Normalized(), vectorLR);
-
-    // projections
-    mInitial.Lr.Assign(mInitial.C[0], 0, mInitial.C[2]);
-    mInitial.Lr.NormalizedSelf();
-    mInitial.Ud.Assign(0, mInitial.C[1], mInitial.C[2]);
-    mInitial.Ud.NormalizedSelf();
-    mInitial.Cw.Assign(mInitial.Up[0], mInitial.Up[1], 0);
-    mInitial.Cw.NormalizedSelf();
-
-    mInitial.ECMPositionJoint = mECM.m_setpoint_js.Position();
-
-    // -5- store current rotation matrix for MTML, MTMR, and ECM
-    vctEulerZYXRotation3 eulerAngles;
-    eulerAngles.Assign(mInitial.ECMPositionJoint[3], mInitial.ECMPositionJoint[0], mInitial.ECMPositionJoint[1]);
-    vctEulerToMatrixRotation3(eulerAngles, mInitial.ECMRotEuler);
-
-    mInitial.MTMLRot = mMTML.m_measured_cp.Position().Rotation();
-    mInitial.MTMRRot = mMTMR.m_measured_cp.Position().Rotation();
-
-#if 0
-    std::cerr << CMN_LOG_DETAILS << std::endl
-              << "L: " << mMTML.m_measured_cp.Position().Translation() << std::endl
-              << "R: " << mMTMR.m_measured_cp.Position().Translation() << std::endl
-              << "C:  " << mInitial.C << std::endl
-              << "Up: " << mInitial.Up << std::endl
-              << "w:  " << mInitial.w << std::endl
-              << "d:  " << mInitial.d << std::endl
-              << "Si: " << side << std::endl;
-#endif
-    mInitial.ECMPositionJoint = mECM.m_setpoint_js.Position();
+    // initial state for MTM force feedback and ECM motion
+    vct4 ecmJoints;
+    ecmJoints.Assign(mECM.m_setpoint_js.Position());
+    mTeleop.Initialize(mMTML.m_measured_cp.Position().Translation(),
+                       mMTML.m_measured_cp.Position().Rotation(),
+                       mMTMR.m_measured_cp.Position().Translation(),
+                       mMTMR.m_measured_cp.Position().Rotation(),
+                       ecmJoints);
+
     // check if by any chance the clutch pedal is pressed
     if (m_clutched) {
         Clutch(true);
@@ -494,155 +498,53 @@ void mtsTeleOperationECM::RunEnabled(void)
         return;
     }
 
-    /* --- Forces on MTMs --- */
-    const vct3 frictionForceCoeff(-10.0, -10.0, -40.0);
-    const double distanceForceCoeff = 150.0;
-
-    //-1- vector between MTMs
-    vct3 vectorLR;
-    vectorLR.DifferenceOf(mMTMR.m_measured_cp.Position().Translation(),
-                          mMTML.m_measured_cp.Position().Translation());
-    // -2- mid-point, aka center of image
-    vct3 c;
-    c.SumOf(mMTMR.m_measured_cp.Position().Translation(),
-            mMTML.m_measured_cp.Position().Translation());
-    c.Multiply(0.5);
-    vct3 directionC = c.Normalized();
-    // -3- image up vector
-    vct3 up;
-    up.CrossProductOf(vectorLR, c);
-    up.NormalizedSelf();
-    // -4- Width of image
-    vct3 side;
-    side.CrossProductOf(c, up);
-    side.NormalizedSelf();
-    // -5- find desired position for L and R
-    vct3 goalL(c);
-    goalL.AddProductOf(-mInitial.w, side);
-    goalL.AddProductOf(-mInitial.d, directionC);
-    vct3 goalR(c);
-    goalR.AddProductOf(mInitial.w, side);
-    goalR.AddProductOf(mInitial.d, directionC);
+    // compute goals for MTMs and ECM, no memory allocation
+    mTeleop.Compute(mMTML.m_measured_cp.Position().Translation(),
+                    mMTMR.m_measured_cp.Position().Translation(),
+                    m_scale);
 
+    /* --- Forces on MTMs --- */
+    static const vct3 frictionForceCoeff(-10.0, -10.0, -40.0);
+    static const double distanceForceCoeff = 150.0;
 
     // compute forces on L and R based on error in position
     vct3 forceFriction;
     vct3 force;
-    prmForceCartesianSet wrenchR, wrenchL;
 
     // MTMR
     // apply force
-    force.DifferenceOf(goalR,
+    force.DifferenceOf(mTeleop.GoalR(),
                        mMTMR.m_measured_cp.Position().Translation());
     force.Multiply(distanceForceCoeff);
-    wrenchR.Force().Ref<3>(0).Assign(force);
+    mMTMR.m_body_servo_cf.Force().Ref<3>(0).Assign(force);
     // add friction force
     forceFriction.ElementwiseProductOf(frictionForceCoeff,
                                        mMTMR.m_measured_cv.VelocityLinear());
-    wrenchR.Force().Ref<3>(0).Add(forceFriction);
+    mMTMR.m_body_servo_cf.Force().Ref<3>(0).Add(forceFriction);
     // apply
-    mMTMR.body_servo_cf(wrenchR);
+    mMTMR.body_servo_cf(mMTMR.m_body_servo_cf);
 
     // MTML
     // apply force
-    force.DifferenceOf(goalL,
+    force.DifferenceOf(mTeleop.GoalL(),
                        mMTML.m_measured_cp.Position().Translation());
     force.Multiply(distanceForceCoeff);
-    wrenchL.Force().Ref<3>(0).Assign(force);
+    mMTML.m_body_servo_cf.Force().Ref<3>(0).Assign(force);
     // add friction force
     forceFriction.ElementwiseProductOf(frictionForceCoeff,
                                        mMTML.m_measured_cv.VelocityLinear());
-    wrenchL.Force().Ref<3>(0).Add(forceFriction);
+    mMTML.m_body_servo_cf.Force().Ref<3>(0).Add(forceFriction);
     // apply
-    mMTML.body_servo_cf(wrenchL);
+    mMTML.body_servo_cf(mMTML.m_body_servo_cf);
 
     /* --- Joint Control --- */
-    static const vct3 normXZ(0.0, 1.0, 0.0);
-    static const vct3 normYZ(1.0, 0.0, 0.0);
-    static const vct3 normXY(0.0, 0.0, 1.0);
-    // Initial ECM joints
-    vctVec goalJoints(mInitial.ECMPositionJoint);
-    // Change in directions and joints
-    vctVec changeJoints(4);
-    vctVec changeDir(4);
-    vct3 crossN;  // normal to direction of motion
-
-    // - Direction 0 - left/right, movement in the XZ plane
-    vct3  lr(c[0], 0.0, c[2]);
-    lr.NormalizedSelf();
-    if (mInitial.Lr.AlmostEqual(lr)) {
-        changeDir[0] = 0.0;
-    } else {
-        changeDir[0] = -acos(vctDotProduct(mInitial.Lr, lr));
-        crossN = vctCrossProduct(mInitial.Lr, lr);
-        if (vctDotProduct(normXZ, crossN) < 0.0) {
-            changeDir[0] = -changeDir[0];
-        }
-    }
-
-    // - Direction 1 - up/down, movement in the YZ plane
-    vct3  ud(0.0, c[1], c[2]);
-    ud.NormalizedSelf();
-    if (mInitial.Ud.AlmostEqual(ud)) {
-        changeDir[1] = 0.0;
-    } else {
-        changeDir[1] = acos(vctDotProduct(mInitial.Ud, ud));
-        crossN = vctCrossProduct(mInitial.Ud, ud);
-        if (vctDotProduct(normYZ, crossN) < 0.0) {
-            changeDir[1] = -changeDir[1];
-        }
-    }
-
-    // - Direction 2 - in/out
-    changeDir[2] = m_scale * (mInitial.C.Norm() - c.Norm());
-
-    // - Direction 3 - cc/ccw, movement in the XY plane
-    vct3 cw(up[0], up[1], 0);
-    cw.NormalizedSelf();
-    if (mInitial.Cw.AlmostEqual(cw)) {
-        changeDir[3] = 0.0;
-    } else {
-        changeDir[3] = -acos(vctDotProduct(mInitial.Cw, cw));
-        crossN = vctCrossProduct(mInitial.Cw, cw);
-        if (vctDotProduct(normXY, crossN) < 0) {
-            changeDir[3] = -changeDir[3];
-        }
-    }
-
-    // adjusting movement for camera orientation
-    double totalChangeJoint3 = changeDir[3] + mInitial.ECMPositionJoint[3];
-    changeJoints[0] = changeDir[0] * cos(totalChangeJoint3) - changeDir[1] * sin(totalChangeJoint3);
-    changeJoints[1] = changeDir[1] * cos(totalChangeJoint3) + changeDir[0] * sin(totalChangeJoint3);
-    changeJoints[2] = changeDir[2];
-    changeJoints[3] = changeDir[3];
-
-    goalJoints.Add(changeJoints);
-    mECM.m_servo_jp.Goal().ForceAssign(goalJoints);
+    mECM.m_servo_jp.Goal().Assign(mTeleop.GoalJoints());
     mECM.servo_jp(mECM.m_servo_jp);
 
     /* --- Lock Orientation --- */
-
-    //Calculate new rotations of MTMs
-    vctMatRot3 currMTMLRot;
-    vctMatRot3 currMTMRRot;
-    // Current ECM Rotation
-    vctEulerZYXRotation3 finalEulerAngles;
-    vctMatrixRotation3<double> currECMRot;
-    vctMatrixRotation3<double> finalECMRot;
-
-    finalEulerAngles.Assign(goalJoints[3], goalJoints[0], goalJoints[1]);
-    vctEulerToMatrixRotation3(finalEulerAngles, finalECMRot);
-    currECMRot = finalECMRot * mInitial.ECMRotEuler.Inverse();
-
-    // Set MTM Orientation
-    currMTMLRot = currECMRot.Inverse() * mInitial.MTMLRot;
-    currMTMRRot = currECMRot.Inverse() * mInitial.MTMRRot;
-
-    // set cartesian effort parameters
-    mMTML.body_set_cf_orientation_absolute(true);
-    mMTML.lock_orientation(currMTMLRot);
-    mMTMR.body_set_cf_orientation_absolute(true);
-    mMTMR.lock_orientation(currMTMRRot);
+    // body_set_cf_orientation_absolute is already set in EnterEnabled
+    mMTML.lock_orientation(mTeleop.MTMLRotation());
+    mMTMR.lock_orientation(mTeleop.MTMRRotation());
 }
 
 void mtsTeleOperationECM::TransitionEnabled(void)
@@ -679,6 +581,12 @@ void mtsTeleOperationECM::ECMErrorEventHandler(const mtsMessage & message)
 
 void mtsTeleOperationECM::ClutchEventHandler(const prmEventButton & button)
 {
+    // time since the event was generated, only if the source sets the timestamp
+    if (button.Timestamp() != 0.0) {
+        m_clutch_latency = mtsManagerLocal::GetInstance()->GetTimeServer().GetRelativeTime()
+            - button.Timestamp();
+    }
+
     switch (button.Type()) {
     case prmEventButton::PRESSED:
         m_clutched = true;
@@ -21,9 +21,13 @@
 
 // cisst
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLog.h>
 #include <sawIntuitiveResearchKit/mtsTeleOperationPSM.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArm.h>
 #include <cisstMultiTask/mtsInterfaceProvided.h>
 #include <cisstMultiTask/mtsInterfaceRequired.h>
+#include <cisstMultiTask/mtsManagerLocal.h>
+#include <cisstOSAbstraction/osaGetTime.h>
 #include <cisstParameterTypes/prmOperatingState.h>
 #include <cisstParameterTypes/prmForceCartesianSet.h>
 
@@ -31,14 +35,16 @@ CMN_IMPLEMENT_SERVICES_DERIVED_ONEARG(mtsTeleOperationPSM, mtsTaskPeriodic, mtsT
 
 mtsTeleOperationPSM::mtsTeleOperationPSM(const std::string & componentName, const double periodInSeconds):
     mtsTaskPeriodic(componentName, periodInSeconds),
-    mTeleopState(componentName, "DISABLED")
+    mTeleopState(componentName, "DISABLED"),
+    mMessages(mtsIntuitiveResearchKit::Messages::Interval)
 {
     Init();
 }
 
 mtsTeleOperationPSM::mtsTeleOperationPSM(const mtsTaskPeriodicConstructorArg & arg):
     mtsTaskPeriodic(arg),
-    mTeleopState(arg.Name, "DISABLED")
+    mTeleopState(arg.Name, "DISABLED"),
+    mMessages(mtsIntuitiveResearchKit::Messages::Interval)
 {
     Init();
 }
@@ -106,6 +112,18 @@ void mtsTeleOperationPSM::Init(void)
     this->StateTable.AddData(mMTM.m_setpoint_cp, "MTM/setpoint_cp");
     this->StateTable.AddData(mPSM.m_setpoint_cp, "PSM/setpoint_cp");
     this->StateTable.AddData(m_alignment_offset, "alignment_offset");
+    this->StateTable.AddData(m_time_to_follow.duration, "time_to_follow");
+    this->StateTable.AddData(m_arms_read_time, "arms_read_time");
+    this->StateTable.AddData(m_clutch_latency, "clutch_latency");
+    this->StateTable.AddData(m_following, "following");
+    this->StateTable.AddData(m_clutched, "clutched");
+    this->StateTable.AddData(m_operator.is_active, "operator_present");
+    m_force_feedback.m_servo_cf.Force().SetAll(0.0);
+    this->StateTable.AddData(m_force_feedback.m_servo_cf, "force_feedback/servo_cf");
+    this->StateTable.AddData(m_force_feedback.tank_level, "force_feedback/tank_level");
+    this->StateTable.AddData(m_force_feedback.latency, "force_feedback/latency");
+    this->StateTable.AddData(m_force_feedback.samples, "force_feedback/samples");
+    this->StateTable.AddData(m_force_feedback.saturated, "force_feedback/saturated");
 
     mConfigurationStateTable = new mtsStateTable(100, "Configuration");
     mConfigurationStateTable->SetAutomaticAdvance(false);
@@ -115,6 +133,7 @@ void mtsTeleOperationPSM::Init(void)
     mConfigurationStateTable->AddData(m_rotation_locked, "rotation_locked");
     mConfigurationStateTable->AddData(m_translation_locked, "translation_locked");
     mConfigurationStateTable->AddData(m_align_mtm, "align_mtm");
+    mConfigurationStateTable->AddData(m_force_feedback.enabled, "force_feedback");
 
     // setup cisst interfaces
     mtsInterfaceRequired * interfaceRequired = AddInterfaceRequired("MTM");
@@ -126,11 +145,15 @@ void mtsTeleOperationPSM::Init(void)
         interfaceRequired->AddFunction("lock_orientation", mMTM.lock_orientation, MTS_OPTIONAL);
         interfaceRequired->AddFunction("unlock_orientation", mMTM.unlock_orientation, MTS_OPTIONAL);
         interfaceRequired->AddFunction("body/servo_cf", mMTM.servo_cf_body);
+        interfaceRequired->AddFunction("body/set_cf_orientation_absolute",
+                                       mMTM.body_set_cf_orientation_absolute);
         interfaceRequired->AddFunction("use_gravity_compensation", mMTM.use_gravity_compensation);
         interfaceRequired->AddFunction("operating_state", mMTM.operating_state);
         interfaceRequired->AddFunction("state_command", mMTM.state_command);
         interfaceRequired->AddEventHandlerWrite(&mtsTeleOperationPSM::MTMErrorEventHandler,
                                                 this, "error");
+        interfaceRequired->AddEventHandlerWrite(&mtsTeleOperationPSM::MTMGoalReachedEventHandler,
+                                                this, "goal_reached");
     }
 
     interfaceRequired = AddInterfaceRequired("PSM");
@@ -141,6 +164,7 @@ void mtsTeleOperationPSM::Init(void)
         interfaceRequired->AddFunction("jaw/setpoint_js", mPSM.jaw_setpoint_js, MTS_OPTIONAL);
         interfaceRequired->AddFunction("jaw/configuration_js", mPSM.jaw_configuration_js, MTS_OPTIONAL);
         interfaceRequired->AddFunction("jaw/servo_jp", mPSM.jaw_servo_jp, MTS_OPTIONAL);
+        interfaceRequired->AddFunction("body/measured_cf", mPSM.body_measured_cf, MTS_OPTIONAL);
         interfaceRequired->AddFunction("operating_state", mPSM.operating_state);
         interfaceRequired->AddFunction("state_command", mPSM.state_command);
         interfaceRequired->AddEventHandlerWrite(&mtsTeleOperationPSM::PSMErrorEventHandler,
@@ -177,6 +201,8 @@ void mtsTeleOperationPSM::Init(void)
                                     "lock_translation", m_translation_locked);
         mInterface->AddCommandWrite(&mtsTeleOperationPSM::set_align_mtm, this,
                                     "set_align_mtm", m_align_mtm);
+        mInterface->AddCommandWrite(&mtsTeleOperationPSM::set_force_feedback, this,
+                                    "set_force_feedback", m_force_feedback.enabled);
         mInterface->AddCommandReadState(*(mConfigurationStateTable),
                                         m_scale,
                                         "scale");
@@ -189,6 +215,8 @@ void mtsTeleOperationPSM::Init(void)
                                         m_translation_locked, "translation_locked");
         mInterface->AddCommandReadState(*(mConfigurationStateTable),
                                         m_align_mtm, "align_mtm");
+        mInterface->AddCommandReadState(*(mConfigurationStateTable),
+                                        m_force_feedback.enabled, "force_feedback");
         mInterface->AddCommandReadState(this->StateTable,
                                         mMTM.m_measured_cp,
                                         "MTM/measured_cp");
@@ -198,6 +226,43 @@ void mtsTeleOperationPSM::Init(void)
         mInterface->AddCommandReadState(this->StateTable,
                                         m_alignment_offset,
                                         "alignment_offset");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_time_to_follow.duration,
+                                        "time_to_follow");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_arms_read_time,
+                                        "arms_read_time");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_clutch_latency,
+                                        "clutch_latency");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_following,
+                                        "following");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_clutched,
+                                        "clutched");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_operator.is_active,
+                                        "operator_present");
+        // used by the console to forward emulated clutch events when
+        // the clutch is connected directly to the footpedal source
+        mInterface->AddCommandWrite(&mtsTeleOperationPSM::ClutchEventHandler, this,
+                                    "emulate_clutch", prmEventButton());
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_force_feedback.m_servo_cf,
+                                        "force_feedback/servo_cf");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_force_feedback.tank_level,
+                                        "force_feedback/tank_level");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_force_feedback.latency,
+                                        "force_feedback/latency");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_force_feedback.samples,
+                                        "force_feedback/samples");
+        mInterface->AddCommandReadState(this->StateTable,
+                                        m_force_feedback.saturated,
+                                        "force_feedback/saturated");
         // events
         mInterface->AddEventWrite(MessageEvents.desired_state,
                                   "desired_state", std::string(""));
@@ -214,6 +279,8 @@ void mtsTeleOperationPSM::Init(void)
                                   "translation_locked", m_translation_locked);
         mInterface->AddEventWrite(ConfigurationEvents.align_mtm,
                                   "align_mtm", m_align_mtm);
+        mInterface->AddEventWrite(ConfigurationEvents.force_feedback,
+                                  "force_feedback", m_force_feedback.enabled);
     }
 
     // so sent commands can be used with ros-bridge
@@ -381,16 +448,86 @@ void mtsTeleOperationPSM::Configure(const Json::Value & jsonConfig)
     if (!jsonValue.empty()) {
         m_align_mtm = jsonValue.asBool();
     }
+
+    // use snapshots for arms in same process
+    jsonValue = jsonConfig["use-arm-snapshot"];
+    if (!jsonValue.empty()) {
+        m_use_arm_snapshot = jsonValue.asBool();
+    }
+
+    // force feedback from PSM to MTM
+    Json::Value jsonForceFeedback = jsonConfig["force-feedback"];
+    if (!jsonForceFeedback.empty()) {
+        jsonValue = jsonForceFeedback["enabled"];
+        if (!jsonValue.empty()) {
+            m_force_feedback.enabled = jsonValue.asBool();
+        }
+        jsonValue = jsonForceFeedback["scale"];
+        if (!jsonValue.empty()) {
+            m_force_feedback.scale = jsonValue.asDouble();
+        }
+        if (m_force_feedback.scale < 0.0) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName()
+                                     << ": \"force-feedback\": { \"scale\": } must be a positive number.  Found "
+                                     << m_force_feedback.scale << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        jsonValue = jsonForceFeedback["cutoff"];
+        if (!jsonValue.empty()) {
+            m_force_feedback.cutoff = jsonValue.asDouble();
+        }
+        if (m_force_feedback.cutoff <= 0.0) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName()
+                                     << ": \"force-feedback\": { \"cutoff\": } must be a positive number.  Found "
+                                     << m_force_feedback.cutoff << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        jsonValue = jsonForceFeedback["max-force"];
+        if (!jsonValue.empty()) {
+            m_force_feedback.max_force = jsonValue.asDouble();
+        }
+        if (m_force_feedback.max_force < 0.0) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName()
+                                     << ": \"force-feedback\": { \"max-force\": } must be a positive number.  Found "
+                                     << m_force_feedback.max_force << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        jsonValue = jsonForceFeedback["energy-tank"];
+        if (!jsonValue.empty()) {
+            m_force_feedback.tank_capacity = jsonValue.asDouble();
+        }
+        if (m_force_feedback.tank_capacity < 0.0) {
+            CMN_LOG_CLASS_INIT_ERROR << "Configure " << this->GetName()
+                                     << ": \"force-feedback\": { \"energy-tank\": } must be a positive number.  Found "
+                                     << m_force_feedback.tank_capacity << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
 }
 
 void mtsTeleOperationPSM::Startup(void)
 {
     CMN_LOG_CLASS_INIT_VERBOSE << "Startup" << std::endl;
+    // allocate log queue now, not in first error
+    mtsIntuitiveResearchKitLog::RegisterThread();
     set_scale(m_scale);
     set_following(false);
     lock_rotation(m_rotation_locked);
     lock_translation(m_translation_locked);
     set_align_mtm(m_align_mtm);
+    set_force_feedback(m_force_feedback.enabled);
+
+    // check if we can bypass read commands
+    if (m_use_arm_snapshot) {
+        mMTM.snapshot = FindArmSnapshot("MTM");
+        if (!mMTM.snapshot) {
+            mInterface->SendWarning(this->GetName() + ": \"use-arm-snapshot\" is set but MTM is not a dVRK arm in the same process, using read commands");
+        }
+        mPSM.snapshot = FindArmSnapshot("PSM");
+        if (!mPSM.snapshot) {
+            mInterface->SendWarning(this->GetName() + ": \"use-arm-snapshot\" is set but PSM is not a dVRK arm in the same process, using read commands");
+        }
+    }
 
     // check if functions for jaw are connected
     if (!m_jaw.ignore) {
@@ -409,6 +546,34 @@ void mtsTeleOperationPSM::Run(void)
 
     // run based on state
     mTeleopState.Run();
+
+    // data for widgets in the same process
+    if (m_display_snapshot.Requested()) {
+        UpdateDisplaySnapshot(m_display_snapshot_data);
+        m_display_snapshot.Write(m_display_snapshot_data);
+    }
+
+    // send aggregated errors
+    mMessages.Process(Now(),
+                      [this](const mtsIntuitiveResearchKitMessageAggregator::LevelType CMN_UNUSED(level),
+                             const std::string & text) {
+                          mInterface->SendError(this->GetName() + ": " + text);
+                      });
+
+    // trigger ExecOut event
+    RunEvent();
+}
+
+void mtsTeleOperationPSM::UpdateDisplaySnapshot(mtsTeleOperationPSMDisplayData & data)
+{
+    data.MTM_measured_cp_valid = mMTM.m_measured_cp.Valid();
+    data.MTM_measured_cp_timestamp = mMTM.m_measured_cp.Timestamp();
+    data.MTM_measured_cp.Assign(mMTM.m_measured_cp.Position());
+    data.PSM_setpoint_cp_valid = mPSM.m_setpoint_cp.Valid();
+    data.PSM_setpoint_cp_timestamp = mPSM.m_setpoint_cp.Timestamp();
+    data.PSM_setpoint_cp.Assign(mPSM.m_setpoint_cp.Position());
+    data.alignment_offset.Assign(m_alignment_offset);
+    data.registration_rotation.Assign(m_registration_rotation);
 }
 
 void mtsTeleOperationPSM::Cleanup(void)
@@ -416,12 +581,30 @@ void mtsTeleOperationPSM::Cleanup(void)
     CMN_LOG_CLASS_INIT_VERBOSE << "Cleanup" << std::endl;
 }
 
+void mtsTeleOperationPSM::SendAggregatedError(const char * message)
+{
+    if (!mMessages.Add(mtsIntuitiveResearchKitMessageAggregator::MESSAGE_ERROR, message)) {
+        mInterface->SendError(this->GetName() + ": " + message);
+    }
+}
+
 void mtsTeleOperationPSM::MTMErrorEventHandler(const mtsMessage & message)
 {
     mTeleopState.SetDesiredState("DISABLED");
     mInterface->SendError(this->GetName() + ": received from MTM [" + message.Message + "]");
 }
 
+void mtsTeleOperationPSM::MTMGoalReachedEventHandler(const bool & reached)
+{
+    // trajectory aborted (e.g. inverse kinematics error), the
+    // alignment goal will be sent again
+    if (reached) {
+        mMTMAlignGoalReached = true;
+    } else {
+        mMTMAlignGoalSent = false;
+    }
+}
+
 void mtsTeleOperationPSM::PSMErrorEventHandler(const mtsMessage & message)
 {
     mTeleopState.SetDesiredState("DISABLED");
@@ -430,6 +613,12 @@ void mtsTeleOperationPSM::PSMErrorEventHandler(const mtsMessage & message)
 
 void mtsTeleOperationPSM::ClutchEventHandler(const prmEventButton & button)
 {
+    // time since the event was generated, only if the source sets the timestamp
+    if (button.Timestamp() != 0.0) {
+        m_clutch_latency = mtsManagerLocal::GetInstance()->GetTimeServer().GetRelativeTime()
+            - button.Timestamp();
+    }
+
     switch (button.Type()) {
     case prmEventButton::PRESSED:
         m_clutched = true;
@@ -454,6 +643,7 @@ void mtsTeleOperationPSM::Clutch(const bool & clutch)
         // keep track of last follow mode
         m_operator.was_active_before_clutch = m_operator.is_active;
         set_following(false);
+        ResetForceFeedback();
         mMTM.m_move_cp.Goal().Rotation().FromNormalized(mPSM.m_setpoint_cp.Position().Rotation());
         mMTM.m_move_cp.Goal().Translation().Assign(mMTM.m_measured_cp.Position().Translation());
         mInterface->SendStatus(this->GetName() + ": console clutch pressed");
@@ -520,10 +710,46 @@ void mtsTeleOperationPSM::SetDesiredState(const std::string & state)
     }
     // force operator to indicate they are present
     m_operator.is_active = false;
+    // start timer to measure how long it takes to follow
+    if (state == "ENABLED") {
+        m_time_to_follow.start = Now();
+    } else {
+        m_time_to_follow.start = 0.0;
+    }
     MessageEvents.desired_state(state);
     mInterface->SendStatus(this->GetName() + ": set desired state to " + state);
 }
 
+const mtsIntuitiveResearchKitArmSnapshot * mtsTeleOperationPSM::FindArmSnapshot(const std::string & interfaceName)
+{
+    const mtsInterfaceRequired * interfaceRequired = GetInterfaceRequired(interfaceName);
+    if (!interfaceRequired) {
+        return 0;
+    }
+    const mtsInterfaceProvided * interfaceProvided = interfaceRequired->GetConnectedInterface();
+    if (!interfaceProvided) {
+        return 0;
+    }
+    // will fail for proxies and non dVRK arms
+    const mtsIntuitiveResearchKitArm * arm =
+        dynamic_cast<const mtsIntuitiveResearchKitArm *>(interfaceProvided->GetComponent());
+    if (!arm) {
+        return 0;
+    }
+    return &(arm->snapshot());
+}
+
+void mtsTeleOperationPSM::UpdateMTMGripper(void)
+{
+    if (mMTM.m_snapshot_valid && mMTM.m_snapshot.gripper_valid) {
+        mMTM.m_gripper_measured_js.Position().SetSize(1);
+        mMTM.m_gripper_measured_js.Position().at(0) = mMTM.m_snapshot.gripper;
+        mMTM.m_gripper_measured_js.Valid() = true;
+        return;
+    }
+    mMTM.gripper_measured_js(mMTM.m_gripper_measured_js);
+}
+
 vctMatRot3 mtsTeleOperationPSM::UpdateAlignOffset(void)
 {
     vctMatRot3 desiredOrientation;
@@ -539,6 +765,7 @@ void mtsTeleOperationPSM::UpdateInitialState(void)
     mPSM.CartesianInitial.From(mPSM.m_setpoint_cp.Position());
     UpdateAlignOffset();
     m_alignment_offset_initial = m_alignment_offset;
+    m_alignment_mtm_previous.Assign(mMTM.m_measured_cp.Position().Rotation());
     if (mBaseFrame.measured_cp.IsValid()) {
         mBaseFrame.CartesianInitial.From(mBaseFrame.m_measured_cp.Position());
     }
@@ -615,6 +842,29 @@ void mtsTeleOperationPSM::set_align_mtm(const bool & alignMTM)
     }
 }
 
+void mtsTeleOperationPSM::set_force_feedback(const bool & forceFeedback)
+{
+    mConfigurationStateTable->Start();
+    // make sure we have access to the PSM wrench
+    if (mPSM.body_measured_cf.IsValid()) {
+        m_force_feedback.enabled = forceFeedback;
+    } else {
+        if (forceFeedback) {
+            mInterface->SendWarning(this->GetName() + ": unable to enable force feedback, the PSM doesn't provide \"body/measured_cf\"");
+        }
+        m_force_feedback.enabled = false;
+    }
+    mConfigurationStateTable->Advance();
+    ConfigurationEvents.force_feedback(m_force_feedback.enabled);
+    // tank is only filled when force feedback is enabled
+    if (m_force_feedback.enabled) {
+        m_force_feedback.tank_level = m_force_feedback.tank_capacity;
+    } else {
+        // remove any force already applied on MTM
+        ResetForceFeedback();
+    }
+}
+
 void mtsTeleOperationPSM::StateChanged(void)
 {
     const std::string newState = mTeleopState.CurrentState();
@@ -625,37 +875,73 @@ void mtsTeleOperationPSM::StateChanged(void)
 void mtsTeleOperationPSM::RunAllStates(void)
 {
     mtsExecutionResult executionResult;
-
-    // get MTM Cartesian position
-    executionResult = mMTM.measured_cp(mMTM.m_measured_cp);
-    if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << "Run: call to MTM.measured_cp failed \""
-                                << executionResult << "\"" << std::endl;
-        mInterface->SendError(this->GetName() + ": unable to get cartesian position from MTM");
-        mTeleopState.SetDesiredState("DISABLED");
+    const double startTime = osaGetTime();
+
+    // get MTM Cartesian position.  Snapshot read can fail if the arm
+    // hasn't published yet or its thread was preempted while writing,
+    // keep the last good snapshot and use read commands for this cycle
+    mMTM.m_snapshot_valid = false;
+    if (mMTM.snapshot) {
+        mtsIntuitiveResearchKitArmSnapshotData snapshot;
+        if (mMTM.snapshot->Read(snapshot)) {
+            mMTM.m_snapshot = snapshot;
+            mMTM.m_snapshot_valid = true;
+            mMTM.m_measured_cp.Position().From(mMTM.m_snapshot.measured_cp);
+            mMTM.m_measured_cp.Valid() = mMTM.m_snapshot.measured_cp_valid;
+            mMTM.m_measured_cp.Timestamp() = mMTM.m_snapshot.timestamp;
+            mMTM.m_setpoint_cp.Position().From(mMTM.m_snapshot.setpoint_cp);
+            mMTM.m_setpoint_cp.Valid() = mMTM.m_snapshot.setpoint_cp_valid;
+            mMTM.m_setpoint_cp.Timestamp() = mMTM.m_snapshot.timestamp;
+        } else {
+            mMTM.m_snapshot_failures++;
+            mtsIntuitiveResearchKitLog::Warning(GetName(), "Run: unable to read MTM snapshot, using read commands",
+                                                {static_cast<double>(mMTM.m_snapshot_failures)});
+        }
     }
-    executionResult = mMTM.setpoint_cp(mMTM.m_setpoint_cp);
-    if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << "Run: call to MTM.setpoint_cp failed \""
-                                << executionResult << "\"" << std::endl;
+    if (!mMTM.m_snapshot_valid) {
+        executionResult = mMTM.measured_cp(mMTM.m_measured_cp);
+        if (!executionResult.IsOK()) {
+            mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to MTM.measured_cp failed", executionResult);
+            SendAggregatedError("unable to get cartesian position from MTM");
+            mTeleopState.SetDesiredState("DISABLED");
+        }
+        executionResult = mMTM.setpoint_cp(mMTM.m_setpoint_cp);
+        if (!executionResult.IsOK()) {
+            mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to MTM.setpoint_cp failed", executionResult);
+        }
     }
 
-    // get PSM Cartesian position
-    executionResult = mPSM.setpoint_cp(mPSM.m_setpoint_cp);
-    if (!executionResult.IsOK()) {
-        CMN_LOG_CLASS_RUN_ERROR << "Run: call to PSM.setpoint_cp failed \""
-                                << executionResult << "\"" << std::endl;
-        mInterface->SendError(this->GetName() + ": unable to get cartesian position from PSM");
-        mTeleopState.SetDesiredState("DISABLED");
+    // get PSM Cartesian position, same fallback as MTM
+    mPSM.m_snapshot_valid = false;
+    if (mPSM.snapshot) {
+        mtsIntuitiveResearchKitArmSnapshotData snapshot;
+        if (mPSM.snapshot->Read(snapshot)) {
+            mPSM.m_snapshot = snapshot;
+            mPSM.m_snapshot_valid = true;
+            mPSM.m_setpoint_cp.Position().From(mPSM.m_snapshot.setpoint_cp);
+            mPSM.m_setpoint_cp.Valid() = mPSM.m_snapshot.setpoint_cp_valid;
+            mPSM.m_setpoint_cp.Timestamp() = mPSM.m_snapshot.timestamp;
+        } else {
+            mPSM.m_snapshot_failures++;
+            mtsIntuitiveResearchKitLog::Warning(GetName(), "Run: unable to read PSM snapshot, using read commands",
+                                                {static_cast<double>(mPSM.m_snapshot_failures)});
+        }
+    }
+    if (!mPSM.m_snapshot_valid) {
+        executionResult = mPSM.setpoint_cp(mPSM.m_setpoint_cp);
+        if (!executionResult.IsOK()) {
+            mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to PSM.setpoint_cp failed", executionResult);
+            SendAggregatedError("unable to get cartesian position from PSM");
+            mTeleopState.SetDesiredState("DISABLED");
+        }
     }
 
     // get base-frame cartesian position if available
     if (mBaseFrame.measured_cp.IsValid()) {
         executionResult = mBaseFrame.measured_cp(mBaseFrame.m_measured_cp);
         if (!executionResult.IsOK()) {
-            CMN_LOG_CLASS_RUN_ERROR << "Run: call to m_base_frame.measured_cp failed \""
-                                    << executionResult << "\"" << std::endl;
-            mInterface->SendError(this->GetName() + ": unable to get cartesian position from base frame");
+            mtsIntuitiveResearchKitLog::Error(GetName(), "Run: call to m_base_frame.measured_cp failed", executionResult);
+            SendAggregatedError("unable to get cartesian position from base frame");
             mTeleopState.SetDesiredState("DISABLED");
         }
     }
@@ -664,6 +950,7 @@ void mtsTeleOperationPSM::RunAllStates(void)
     if ((mTeleopState.DesiredState() == "DISABLED")
         && (mTeleopState.CurrentState() != "DISABLED")) {
         set_following(false);
+        ResetForceFeedback();
         mTeleopState.SetCurrentState("DISABLED");
         return;
     }
@@ -672,19 +959,31 @@ void mtsTeleOperationPSM::RunAllStates(void)
     if ((mTeleopState.CurrentState() != "DISABLED")
         && (mTeleopState.CurrentState() != "SETTING_ARMS_STATE")) {
         prmOperatingState state;
-        mPSM.operating_state(state);
+        if (mPSM.m_snapshot_valid) {
+            state.State() = mPSM.m_snapshot.operating_state;
+            state.IsHomed() = mPSM.m_snapshot.is_homed;
+        } else {
+            mPSM.operating_state(state);
+        }
         if ((state.State() != prmOperatingState::ENABLED)
             || !state.IsHomed()) {
             mTeleopState.SetDesiredState("DISABLED");
             mInterface->SendError(this->GetName() + ": PSM is not in state \"ENABLED\" anymore");
         }
-        mMTM.operating_state(state);
+        if (mMTM.m_snapshot_valid) {
+            state.State() = mMTM.m_snapshot.operating_state;
+            state.IsHomed() = mMTM.m_snapshot.is_homed;
+        } else {
+            mMTM.operating_state(state);
+        }
         if ((state.State() != prmOperatingState::ENABLED)
             || !state.IsHomed()) {
             mTeleopState.SetDesiredState("DISABLED");
             mInterface->SendError(this->GetName() + ": MTM is not in state \"READY\" anymore");
         }
     }
+
+    m_arms_read_time = osaGetTime() - startTime;
 }
 
 void mtsTeleOperationPSM::TransitionDisabled(void)
@@ -697,7 +996,7 @@ void mtsTeleOperationPSM::TransitionDisabled(void)
 void mtsTeleOperationPSM::EnterSettingArmsState(void)
 {
     // reset timer
-    mInStateTimer = StateTable.GetTic();
+    mInStateTimer = Now();
 
     // request state if needed
     prmOperatingState state;
@@ -730,7 +1029,7 @@ void mtsTeleOperationPSM::TransitionSettingArmsState(void)
         return;
     }
     // check timer
-    if ((StateTable.GetTic() - mInStateTimer) > 60.0 * cmn_s) {
+    if ((Now() - mInStateTimer) > 60.0 * cmn_s) {
         if (!((psmState.State() == prmOperatingState::ENABLED) && psmState.IsHomed())) {
             mInterface->SendError(this->GetName() + ": timed out while setting up PSM state");
         }
@@ -747,8 +1046,10 @@ void mtsTeleOperationPSM::EnterAligningMTM(void)
     ConfigurationEvents.scale(m_scale);
 
     // reset timer
-    mInStateTimer = StateTable.GetTic();
+    mInStateTimer = Now();
     mTimeSinceLastAlign = 0.0;
+    mMTMAlignGoalSent = false;
+    mMTMAlignGoalReached = false;
 
     // if we don't align MTM, just stay in same position
     if (!m_align_mtm) {
@@ -781,16 +1082,36 @@ void mtsTeleOperationPSM::RunAligningMTM(void)
         return;
     }
 
-    // set trajectory goal periodically, this will track PSM motion
-    const double currentTime = StateTable.GetTic();
+    // check periodically if the PSM moved, this will track PSM motion
+    const double currentTime = Now();
     if ((currentTime - mTimeSinceLastAlign) > 10.0 * cmn_ms) {
         mTimeSinceLastAlign = currentTime;
         // Orientate MTM with PSM
-        vctFrm4x4 mtmCartesianGoal;
-        mtmCartesianGoal.Translation().Assign(mMTM.m_setpoint_cp.Position().Translation());
         vctMatRot3 mtmRotation;
         mtmRotation = m_registration_rotation.Inverse() * mPSM.m_setpoint_cp.Position().Rotation();
-        mtmCartesianGoal.Rotation().FromNormalized(mtmRotation);
+        // only send a new goal if the PSM moved enough, each new goal
+        // re-plans the trajectory so sending the same goal over and
+        // over would prevent the MTM from following a time optimal
+        // path.  The MTM might also reject a goal without sending
+        // goal_reached (e.g. arm not ready), re-send after a timeout
+        if (mMTMAlignGoalSent
+            && (mMTMAlignGoalReached
+                || ((currentTime - mMTMAlignGoalTime)
+                    < mtsIntuitiveResearchKit::TeleOperationPSM::AlignmentGoalTimeout))) {
+            vctMatRot3 change;
+            mMTMAlignGoal.ApplyInverseTo(mtmRotation, change);
+            vctAxAnRot3 axisAngle(change, VCT_NORMALIZE);
+            if (axisAngle.Angle() < mtsIntuitiveResearchKit::TeleOperationPSM::AlignmentGoalTolerance) {
+                return;
+            }
+        }
+        mMTMAlignGoal.FromNormalized(mtmRotation);
+        mMTMAlignGoalSent = true;
+        mMTMAlignGoalReached = false;
+        mMTMAlignGoalTime = currentTime;
+        vctFrm4x4 mtmCartesianGoal;
+        mtmCartesianGoal.Translation().Assign(mMTM.m_setpoint_cp.Position().Translation());
+        mtmCartesianGoal.Rotation().Assign(mMTMAlignGoal);
         // convert to prm type
         mMTM.m_move_cp.Goal().From(mtmCartesianGoal);
         mMTM.move_cp(mMTM.m_move_cp);
@@ -816,7 +1137,7 @@ void mtsTeleOperationPSM::TransitionAligningMTM(void)
     // if not active, use gripper and/or roll to detect if the user is ready
     if (!m_operator.is_active) {
         // update gripper values
-        mMTM.gripper_measured_js(mMTM.m_gripper_measured_js);
+        UpdateMTMGripper();
         const double gripper = mMTM.m_gripper_measured_js.Position()[0];
         if (gripper > m_operator.gripper_max) {
             m_operator.gripper_max = gripper;
@@ -855,7 +1176,7 @@ void mtsTeleOperationPSM::TransitionAligningMTM(void)
         }
     } else {
         // check timer and issue a message
-        if ((StateTable.GetTic() - mInStateTimer) > 2.0 * cmn_s) {
+        if ((Now() - mInStateTimer) > 2.0 * cmn_s) {
             std::stringstream message;
             if (orientationError >= m_operator.orientation_tolerance) {
                 message << this->GetName() + ": unable to align MTM, angle error is "
@@ -864,7 +1185,7 @@ void mtsTeleOperationPSM::TransitionAligningMTM(void)
                 message << this->GetName() + ": pinch/twist MTM gripper a bit";
             }
             mInterface->SendWarning(message.str());
-            mInStateTimer = StateTable.GetTic();
+            mInStateTimer = Now();
         }
     }
 }
@@ -885,9 +1206,13 @@ void mtsTeleOperationPSM::EnterEnabled(void)
 
     // set MTM/PSM to Teleop (Cartesian Position Mode)
     mMTM.use_gravity_compensation(true);
-    // set forces to zero and lock/unlock orientation as needed
+    // set forces to zero and lock/unlock orientation as needed.
+    // Other components (e.g. teleop ECM) might have left the MTM
+    // wrench orientation relative, force feedback is in base frame
+    mMTM.body_set_cf_orientation_absolute(true);
     prmForceCartesianSet wrench;
     mMTM.servo_cf_body(wrench);
+    ResetForceFeedback();
     if (m_rotation_locked) {
         mMTM.lock_orientation(mMTM.m_measured_cp.Position().Rotation());
     } else {
@@ -925,6 +1250,22 @@ void mtsTeleOperationPSM::RunEnabled(void)
             if (m_rotation_locked) {
                 psmRotation.From(mPSM.CartesianInitial.Rotation());
             } else {
+                // teleop can start before the MTM is perfectly aligned,
+                // remove the residual offset only while the operator
+                // rotates the MTM so the PSM never moves on its own
+                if (m_align_mtm) {
+                    vctAxAnRot3 axisAngle(m_alignment_offset_initial, VCT_NORMALIZE);
+                    if (axisAngle.Angle() > 0.0) {
+                        vctMatRot3 mtmMotion;
+                        m_alignment_mtm_previous.ApplyInverseTo(mtmPosition.Rotation(), mtmMotion);
+                        const vctAxAnRot3 mtmMotionAxisAngle(mtmMotion, VCT_NORMALIZE);
+                        const double delta = mtsIntuitiveResearchKit::TeleOperationPSM::AlignmentOffsetRatio
+                            * mtmMotionAxisAngle.Angle();
+                        axisAngle.Angle() = std::max(0.0, axisAngle.Angle() - delta);
+                        m_alignment_offset_initial.From(axisAngle);
+                    }
+                    m_alignment_mtm_previous.Assign(mtmPosition.Rotation());
+                }
                 psmRotation = m_registration_rotation * mtmPosition.Rotation() * m_alignment_offset_initial;
             }
 
@@ -950,7 +1291,7 @@ void mtsTeleOperationPSM::RunEnabled(void)
             if (!m_jaw.ignore) {
                 // gripper
                 if (mMTM.gripper_measured_js.IsValid()) {
-                    mMTM.gripper_measured_js(mMTM.m_gripper_measured_js);
+                    UpdateMTMGripper();
                     const double currentGripper = mMTM.m_gripper_measured_js.Position()[0];
                     // see if we caught up
                     if (!m_jaw_caught_up_after_clutch) {
@@ -961,8 +1302,8 @@ void mtsTeleOperationPSM::RunEnabled(void)
                     }
                     // pick the rate based on back from clutch or not
                     const double delta = m_jaw_caught_up_after_clutch ?
-                        m_jaw.rate * StateTable.PeriodStats.PeriodAvg()
-                        : m_jaw.rate_back_from_clutch * StateTable.PeriodStats.PeriodAvg();
+                        m_jaw.rate * ControlPeriod()
+                        : m_jaw.rate_back_from_clutch * ControlPeriod();
                     // gripper ghost below, add to catch up
                     if (m_gripper_ghost <= (currentGripper - delta)) {
                         m_gripper_ghost += delta;
@@ -984,6 +1325,10 @@ void mtsTeleOperationPSM::RunEnabled(void)
                     mPSM.jaw_servo_jp(mPSM.m_jaw_servo_jp);
                 }
             }
+
+            if (m_force_feedback.enabled) {
+                RunForceFeedback();
+            }
         }
     }
 }
@@ -992,6 +1337,7 @@ void mtsTeleOperationPSM::TransitionEnabled(void)
 {
     if (mTeleopState.DesiredStateIsNotCurrent()) {
         set_following(false);
+        ResetForceFeedback();
         mTeleopState.SetCurrentState(mTeleopState.DesiredState());
     }
 }
@@ -1034,4 +1380,108 @@ void mtsTeleOperationPSM::set_following(const bool following)
 {
     MessageEvents.following(following);
     m_following = following;
+    // report time to follow since last request to enable
+    if (following && (m_time_to_follow.start != 0.0)) {
+        m_time_to_follow.duration = Now() - m_time_to_follow.start;
+        m_time_to_follow.start = 0.0;
+        std::stringstream message;
+        message << this->GetName() << ": following "
+                << m_time_to_follow.duration << " (s) after enable";
+        mInterface->SendStatus(message.str());
+    }
+}
+
+void mtsTeleOperationPSM::ResetForceFeedback(void)
+{
+    // only send a zero wrench if a force was applied, MTM might not
+    // be in effort mode anymore
+    if (m_force_feedback.active) {
+        m_force_feedback.m_servo_cf.Force().SetAll(0.0);
+        mMTM.servo_cf_body(m_force_feedback.m_servo_cf);
+        m_force_feedback.active = false;
+    }
+    m_force_feedback.filtered.SetAll(0.0);
+    m_force_feedback.applied.SetAll(0.0);
+    m_force_feedback.previous_position.Assign(mMTM.m_measured_cp.Position().Translation());
+    // tank level is preserved, refilling it on every clutch or
+    // invalid sample would defeat the passivity bound
+    m_force_feedback.last_timestamp = 0.0;
+}
+
+void mtsTeleOperationPSM::RunForceFeedback(void)
+{
+    mtsExecutionResult executionResult;
+    executionResult = mPSM.body_measured_cf(mPSM.m_body_measured_cf);
+    if (!executionResult.IsOK()
+        || !mPSM.m_body_measured_cf.Valid()) {
+        // zero force, tank level is not changed
+        ResetForceFeedback();
+        return;
+    }
+
+    // statistics, new samples and age of data
+    const double now = Now();
+    if (mPSM.m_body_measured_cf.Timestamp() != m_force_feedback.last_timestamp) {
+        m_force_feedback.last_timestamp = mPSM.m_body_measured_cf.Timestamp();
+        m_force_feedback.samples++;
+    }
+    m_force_feedback.latency = now - m_force_feedback.last_timestamp;
+
+    // energy injected by MTM since last cycle, using last force
+    // applied.  Work from the operator against the force refills the
+    // tank, work from the MTM on the operator drains it.
+    const vct3 mtmPosition(mMTM.m_measured_cp.Position().Translation());
+    const double work = vctDotProduct(m_force_feedback.applied,
+                                      mtmPosition - m_force_feedback.previous_position);
+    m_force_feedback.previous_position.Assign(mtmPosition);
+    m_force_feedback.tank_level -= work;
+    if (m_force_feedback.tank_level > m_force_feedback.tank_capacity) {
+        m_force_feedback.tank_level = m_force_feedback.tank_capacity;
+    }
+
+    // PSM wrench is the force applied by the tool, operator should
+    // feel the opposite.  Convert from PSM body to MTM base frame.
+    // Only forces are reflected, orientation is handled by
+    // lock_orientation.
+    const vct3 psmForce(mPSM.m_body_measured_cf.Force().Ref<3>(0));
+    vct3 psmForceAbsolute, mtmForce;
+    mPSM.m_setpoint_cp.Position().Rotation().ApplyTo(psmForce, psmForceAbsolute);
+    m_registration_rotation.ApplyInverseTo(psmForceAbsolute, mtmForce);
+    mtmForce.Multiply(-m_force_feedback.scale);
+
+    // first order low pass filter
+    const double dt = m_virtual_clock ? m_virtual_clock->Step() : this->GetPeriodicity();
+    const double alpha = dt / (dt + 1.0 / (2.0 * cmnPI * m_force_feedback.cutoff));
+    m_force_feedback.filtered.Multiply(1.0 - alpha);
+    m_force_feedback.filtered.Add(alpha * mtmForce);
+
+    // saturation
+    m_force_feedback.applied.Assign(m_force_feedback.filtered);
+    const double norm = m_force_feedback.applied.Norm();
+    bool saturated = false;
+    if (norm > m_force_feedback.max_force) {
+        m_force_feedback.applied.Multiply(m_force_feedback.max_force / norm);
+        saturated = true;
+    }
+
+    // energy tank, fade force out as the tank empties
+    if (m_force_feedback.tank_level <= 0.0) {
+        m_force_feedback.tank_level = 0.0;
+        m_force_feedback.applied.SetAll(0.0);
+        saturated = true;
+    } else if (m_force_feedback.tank_level < 0.1 * m_force_feedback.tank_capacity) {
+        m_force_feedback.applied.Multiply(m_force_feedback.tank_level
+                                          / (0.1 * m_force_feedback.tank_capacity));
+        saturated = true;
+    }
+    if (saturated) {
+        m_force_feedback.saturated++;
+    }
+
+    // send to MTM in base frame (absolute orientation set in
+    // EnterEnabled), orientation lock is preserved by MTM
+    m_force_feedback.m_servo_cf.Force().SetAll(0.0);
+    m_force_feedback.m_servo_cf.Force().Ref<3>(0).Assign(m_force_feedback.applied);
+    mMTM.servo_cf_body(m_force_feedback.m_servo_cf);
+    m_force_feedback.active = true;
 }
@@ -0,0 +1,158 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-16
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+  --- begin cisst license - do not edit ---
+
+  This software is provided "as is" under an open source license, with
+  no warranty.  The complete license can be found in license.txt and
+  http://www.cisst.org/cisst/license.txt.
+
+  --- end cisst license ---
+*/
+
+#include <cmath>
+
+#include <sawIntuitiveResearchKit/robTeleOperationECM.h>
+#include <cisstVector/vctEulerRotation3.h>
+
+namespace {
+    // signed angle between two unit vectors, sign is given by the
+    // cross product along the normal of the plane of motion
+    inline double SignedAngle(const vct3 & initial, const vct3 & current,
+                              const vct3 & normal) {
+        if (initial.AlmostEqual(current)) {
+            return 0.0;
+        }
+        const double angle = acos(vctDotProduct(initial, current));
+        if (vctDotProduct(normal, vctCrossProduct(initial, current)) < 0.0) {
+            return -angle;
+        }
+        return angle;
+    }
+
+    inline void ECMEulerToRotation(const vct4 & joints, vctMatRot3 & rotation) {
+        vctEulerZYXRotation3 eulerAngles;
+        eulerAngles.Assign(joints[3], joints[0], joints[1]);
+        vctEulerToMatrixRotation3(eulerAngles, rotation);
+    }
+}
+
+void robTeleOperationECM::Initialize(const vct3 & mtmlPosition, const vctMatRot3 & mtmlRotation,
+                                     const vct3 & mtmrPosition, const vctMatRot3 & mtmrRotation,
+                                     const vct4 & ecmJoints)
+{
+    // -1- initial distance between MTMs
+    vct3 vectorLR;
+    vectorLR.DifferenceOf(mtmrPosition, mtmlPosition);
+    // -2- mid-point, aka center of image
+    mInitial.C.SumOf(mtmrPosition, mtmlPosition);
+    mInitial.C.Multiply(0.5);
+    mInitial.CNorm = mInitial.C.Norm();
+    // -3- image up vector
+    mInitial.Up.CrossProductOf(vectorLR, mInitial.C);
+    mInitial.Up.NormalizedSelf();
+    // -4- width of image, depth of arms wrt image plan
+    vct3 side;
+    side.CrossProductOf(mInitial.C, mInitial.Up);
+    side.NormalizedSelf();
+    mInitial.w = 0.5 * vctDotProduct(side, vectorLR);
+    mInitial.d = 0.5 * vctDotProduct(mInitial.C.Normalized(), vectorLR);
+
+    // projections
+    mInitial.Lr.Assign(mInitial.C[0], 0.0, mInitial.C[2]);
+    mInitial.Lr.NormalizedSelf();
+    mInitial.Ud.Assign(0.0, mInitial.C[1], mInitial.C[2]);
+    mInitial.Ud.NormalizedSelf();
+    mInitial.Cw.Assign(mInitial.Up[0], mInitial.Up[1], 0.0);
+    mInitial.Cw.NormalizedSelf();
+
+    mInitial.ECMPositionJoint.Assign(ecmJoints);
+
+    // -5- store current rotation matrix for MTML, MTMR, and ECM
+    vctMatRot3 ecmRotation;
+    ECMEulerToRotation(mInitial.ECMPositionJoint, ecmRotation);
+    mInitial.ECMRotEulerInverse.InverseOf(ecmRotation);
+    mInitial.MTMLRot.Assign(mtmlRotation);
+    mInitial.MTMRRot.Assign(mtmrRotation);
+
+    // goals match initial state
+    mGoalL.Assign(mtmlPosition);
+    mGoalR.Assign(mtmrPosition);
+    mGoalJoints.Assign(mInitial.ECMPositionJoint);
+    mMTMLRotation.Assign(mInitial.MTMLRot);
+    mMTMRRotation.Assign(mInitial.MTMRRot);
+}
+
+void robTeleOperationECM::Compute(const vct3 & mtmlPosition,
+                                  const vct3 & mtmrPosition,
+                                  const double scale)
+{
+    static const vct3 normXZ(0.0, 1.0, 0.0);
+    static const vct3 normYZ(1.0, 0.0, 0.0);
+    static const vct3 normXY(0.0, 0.0, 1.0);
+
+    // -1- vector between MTMs
+    vct3 vectorLR;
+    vectorLR.DifferenceOf(mtmrPosition, mtmlPosition);
+    // -2- mid-point, aka center of image
+    vct3 c;
+    c.SumOf(mtmrPosition, mtmlPosition);
+    c.Multiply(0.5);
+    const double cNorm = c.Norm();
+    vct3 directionC;
+    directionC.RatioOf(c, cNorm);
+    // -3- image up vector
+    vct3 up;
+    up.CrossProductOf(vectorLR, c);
+    up.NormalizedSelf();
+    // -4- width of image
+    vct3 side;
+    side.CrossProductOf(c, up);
+    side.NormalizedSelf();
+    // -5- find desired position for L and R
+    mGoalL.Assign(c);
+    mGoalL.AddProductOf(-mInitial.w, side);
+    mGoalL.AddProductOf(-mInitial.d, directionC);
+    mGoalR.Assign(c);
+    mGoalR.AddProductOf(mInitial.w, side);
+    mGoalR.AddProductOf(mInitial.d, directionC);
+
+    // change in directions
+    vct4 changeDir;
+    // - direction 0 - left/right, movement in the XZ plane
+    vct3 lr(c[0], 0.0, c[2]);
+    lr.NormalizedSelf();
+    changeDir[0] = -SignedAngle(mInitial.Lr, lr, normXZ);
+    // - direction 1 - up/down, movement in the YZ plane
+    vct3 ud(0.0, c[1], c[2]);
+    ud.NormalizedSelf();
+    changeDir[1] = SignedAngle(mInitial.Ud, ud, normYZ);
+    // - direction 2 - in/out
+    changeDir[2] = scale * (mInitial.CNorm - cNorm);
+    // - direction 3 - cc/ccw, movement in the XY plane
+    vct3 cw(up[0], up[1], 0.0);
+    cw.NormalizedSelf();
+    changeDir[3] = -SignedAngle(mInitial.Cw, cw, normXY);
+
+    // adjusting movement for camera orientation
+    const double totalChangeJoint3 = changeDir[3] + mInitial.ECMPositionJoint[3];
+    const double cosJoint3 = cos(totalChangeJoint3);
+    const double sinJoint3 = sin(totalChangeJoint3);
+    mGoalJoints[0] = mInitial.ECMPositionJoint[0] + changeDir[0] * cosJoint3 - changeDir[1] * sinJoint3;
+    mGoalJoints[1] = mInitial.ECMPositionJoint[1] + changeDir[1] * cosJoint3 + changeDir[0] * sinJoint3;
+    mGoalJoints[2] = mInitial.ECMPositionJoint[2] + changeDir[2];
+    mGoalJoints[3] = mInitial.ECMPositionJoint[3] + changeDir[3];
+
+    // new rotations of MTMs, based on ECM rotation since start
+    vctMatRot3 finalECMRot, currECMRot;
+    ECMEulerToRotation(mGoalJoints, finalECMRot);
+    currECMRot.ProductOf(finalECMRot, mInitial.ECMRotEulerInverse);
+    currECMRot.ApplyInverseTo(mInitial.MTMLRot, mMTMLRotation);
+    currECMRot.ApplyInverseTo(mInitial.MTMRRot, mMTMRRotation);
+}
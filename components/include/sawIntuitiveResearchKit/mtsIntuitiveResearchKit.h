@@ -78,6 +78,118 @@ namespace mtsIntuitiveResearchKit {
         const double JawRate =  2.0 * cmnPI * cmn_s; // 360 d/s
         const double JawRateBackFromClutch =  0.2 * cmnPI * cmn_s; // 36.0 d/s
         const double ToleranceBackFromClutch =  2.0 * cmnPI_180; // in radians
+        const double AlignmentGoalTolerance = 0.5 * cmnPI_180; // in radians, update MTM goal only if PSM moved more than this
+        const double AlignmentGoalTimeout = 2.0 * cmn_s; // re-send MTM goal if not reached, e.g. move_cp rejected
+        const double AlignmentOffsetRatio = 0.1; // residual offset removed after engaging, per radian of MTM rotation
+        // force feedback from PSM wrench to MTM
+        const double ForceFeedbackScale = 0.5;
+        const double ForceFeedbackCutoff = 20.0; // in Hz, low pass filter on PSM wrench
+        const double ForceFeedbackMaxForce = 3.0; // in N, applied on MTM
+        const double ForceFeedbackEnergyTank = 0.1; // in J, energy the MTM can inject before it's refilled by the operator
+    }
+
+    // jitter buffer for socket based teleoperation
+    namespace SocketJitterBuffer {
+        const size_t Capacity = 64; // number of commands buffered
+        const double MinDelay = 2.0 * cmn_ms;
+        const double MaxDelay = 50.0 * cmn_ms;
+        const double Extrapolation = 20.0 * cmn_ms; // max time to extrapolate on loss
+        const double HoldTimeout = 100.0 * cmn_ms; // hold last pose if nothing received
+    }
+
+    // clock offset and latency estimation for socket based teleoperation
+    namespace SocketClockSync {
+        const size_t FilterSize = 8; // samples used to find minimum round trip
+        const size_t LatencyWindow = 512; // samples used for latency distributions
+        const size_t LatencyUpdate = 100; // samples between distribution updates
+        const double DriftInterval = 1.0 * cmn_s; // time between drift estimates
+        const double DriftGain = 0.1; // low pass filter on drift estimates
+        const double MaximumLatency = 50.0 * cmn_ms; // older messages are considered stale
+    }
+
+    // binary streamer, see mtsIntuitiveResearchKitUDPStreamer
+    namespace Streamer {
+        const size_t MaximumDatagramSize = 1472; // fits in a single ethernet frame
+        const size_t MaximumNumberOfJoints = 16; // used to check datagram size
+        const size_t NumberOfSlots = 1024; // shared memory ring, about 1 second at 1 kHz
+    }
+
+    // shared memory telemetry for remote GUIs, see mtsIntuitiveResearchKitRemoteQtWidget
+    namespace Remote {
+        const std::string Prefix = "/dvrk-remote-"; // ring name is prefix + arm or teleop name
+        const unsigned int Decimation = 10; // one sample every N arm cycles
+        const size_t NumberOfSlots = 64;
+        const double Timeout = 2.0 * cmn_s; // GUI re-opens rings not updated
+    }
+
+    // servo commands from external processes, see mtsSharedMemoryCommand
+    namespace SharedMemoryCommand {
+        const size_t NumberOfSlots = 4;
+        const double Timeout = 10.0 * cmn_ms; // arm freezes if no new command
+    }
+
+    // binary recorder, see mtsIntuitiveResearchKitRecorder
+    namespace Recorder {
+        const size_t ChunkSize = 1024; // samples per chunk, about 1 second at 1 kHz
+        const size_t NumberOfBuffers = 8; // chunks buffered per signal before drops
+        const double Period = 1.0 * cmn_ms; // for sources without ExecOut
+    }
+
+    // replay of recorded PID and IO data, see mtsIntuitiveResearchKitReplay
+    namespace Replay {
+        const double Rate = 0.0; // ratio to real time, 0 runs as fast as possible
+        const double Tolerance = 1.0e-4; // radians or meters, setpoint comparison
+        const double Window = 1.0; // seconds decoded at once per signal
+    }
+
+    // stepped simulation on a virtual clock, see mtsIntuitiveResearchKitScheduler
+    namespace Scheduler {
+        const double Step = cmnHzToPeriod(1500.0); // no need for PeriodDelay on a virtual clock
+        const double Rate = 0.0; // ratio to real time, 0 runs as fast as possible
+        const double PausedSleep = 1.0 * cmn_ms;
+    }
+
+    // in process loopback transport with network impairments, for tests
+    namespace SocketImpairment {
+        const size_t Capacity = 256; // datagrams in flight per port
+        const size_t MaximumDatagramSize = 1024; // see BUFFER_SIZE in mtsSocketBasePSM.h
+        const size_t QueueSize = 64 * 1024; // bytes queued before drops when bandwidth is limited
+        const double PollPeriod = 0.1 * cmn_ms; // sleep between receive attempts
+    }
+
+    // simulated IO and PID for dynamic simulation, see mtsIntuitiveResearchKitStandIn
+    namespace StandIn {
+        const double Armature = 0.01; // kg.m^2 or kg, used if the PID gains can't define one
+        const double TimeToPower = 0.1 * cmn_s; // amplifiers report power after this delay
+    }
+
+    // timing distributions, see mtsIntuitiveResearchKitTimingProbe
+    namespace Benchmark {
+        const double Resolution = 1.0 * cmn_us; // histogram bin width
+        const double Range = 20.0 * cmn_ms; // longer periods only known through maximum
+        const double ProbePeriod = 1.0 * cmn_ms; // not used, probes run in source thread
+        const double ReadPeriod = 10.0 * cmn_ms; // external read load, like ROS bridges
+    }
+
+    // run time messages from real time threads, see mtsIntuitiveResearchKitLog
+    namespace Log {
+        const size_t QueueSize = 256; // messages per thread before drops
+        const double Period = 20.0 * cmn_ms; // background thread writes queued messages
+        const double MinimumInterval = 1.0 * cmn_s; // between messages from the same call site
+    }
+
+    namespace Messages {
+        const double Interval = 2.0 * cmn_s; // between two aggregated errors/warnings sent to the user
+    }
+
+    // Qt widgets refresh, see mtsIntuitiveResearchKitRefreshRate
+    namespace Display {
+        const double UnfocusedFactor = 4.0; // period multiplier when the window doesn't have focus
+        const double MinimizedPeriod = 1.0 * cmn_s; // hidden or minimized, only to detect restore
+        const double StatisticsPeriod = 1.0 * cmn_s; // period statistics only change once per second
+        const double LoadInterval = 2.0 * cmn_s; // reads and snapshots per second computed over interval
+        const double PositionPrecision = 1.0e-5; // SI, 0.01 mm, well below 0.01 degree
+        const double EffortPrecision = 1.0e-3; // N and Nm
     }
 };
 
@@ -0,0 +1,92 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-18
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitActuatorModel_h
+#define _mtsIntuitiveResearchKitActuatorModel_h
+
+#include <cstddef>
+#include <vector>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Efforts actually applied by the actuators for the efforts
+  requested by the controller.
+
+  Requests are first delayed by the latency, rounded to a whole
+  number of steps, to model the round trip between the controller
+  and the amplifiers.  Each actuator then follows the delayed request
+  with a first order response (current loop bandwidth) and saturates
+  at its maximum effort.  A null time constant gives an immediate
+  response.
+
+  Only depends on the C++ standard library. */
+class CISST_EXPORT mtsIntuitiveResearchKitActuatorModel
+{
+public:
+    mtsIntuitiveResearchKitActuatorModel(void);
+
+    /*! Set number of actuators, resets parameters and state */
+    void SetSize(const size_t size);
+
+    inline size_t size(void) const {
+        return mEfforts.size();
+    }
+
+    /*! Time constant of the first order response, in seconds */
+    void SetTimeConstant(const size_t index, const double timeConstant);
+
+    /*! Maximum absolute effort, no limit by default */
+    void SetEffortMaximum(const size_t index, const double effortMaximum);
+
+    /*! Delay between requested and applied efforts, in seconds */
+    void SetLatency(const double latency);
+
+    inline double Latency(void) const {
+        return mLatency;
+    }
+
+    /*! Number of steps requests are delayed, updated by Update */
+    inline size_t DelaySteps(void) const {
+        return mDelaySteps;
+    }
+
+    /*! Zero applied efforts and requests in flight, e.g. when the
+      amplifiers are turned off */
+    void Reset(void);
+
+    /*! Advance by dt seconds with the latest requested efforts and
+      returns the applied efforts */
+    const std::vector<double> & Update(const double * requests, const double dt);
+
+    inline const std::vector<double> & Efforts(void) const {
+        return mEfforts;
+    }
+
+protected:
+    double mLatency;
+    size_t mDelaySteps;
+    size_t mDelayIndex;
+    std::vector<double> mDelayLine; // mDelaySteps x size, oldest at mDelayIndex
+    std::vector<double> mDelayed;
+    std::vector<double> mTimeConstants;
+    std::vector<double> mEffortMaximums;
+    std::vector<double> mEfforts;
+};
+
+#endif // _mtsIntuitiveResearchKitActuatorModel_h
@@ -41,6 +41,10 @@ http://www.cisst.org/cisst/license.txt.
 
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArmTypes.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArmSnapshot.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitMessageAggregator.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitVirtualClock.h>
+#include <sawIntuitiveResearchKit/mtsSharedMemoryCommand.h>
 #include <sawIntuitiveResearchKit/mtsStateMachine.h>
 
 // forward declarations
@@ -70,6 +74,27 @@ class CISST_EXPORT mtsIntuitiveResearchKitArm: public mtsTaskPeriodic
         m_calibration_mode = mode;
     }
 
+    /*! Use a virtual clock for timers, timestamps and trajectories
+      instead of the state table tic and period.  Only for arms
+      stepped by the clock owner, see mtsIntuitiveResearchKitScheduler.
+      Must be called before the component is started. */
+    inline void set_virtual_clock(const mtsIntuitiveResearchKitVirtualClock * clock) {
+        m_virtual_clock = clock;
+    }
+
+    /*! Snapshot of the arm state published once per cycle.  Can be
+      used by other components in the same process to bypass read
+      commands. */
+    inline const mtsIntuitiveResearchKitArmSnapshot & snapshot(void) const {
+        return m_snapshot;
+    }
+
+    /*! Data displayed by mtsIntuitiveResearchKitArmQtWidget, only
+      written when requested by a widget in the same process. */
+    inline const mtsIntuitiveResearchKitArmDisplaySnapshot & display_snapshot(void) const {
+        return m_display_snapshot;
+    }
+
  protected:
 
     /*! Define wrench reference frame */
@@ -108,6 +133,18 @@ class CISST_EXPORT mtsIntuitiveResearchKitArm: public mtsTaskPeriodic
     /*! Get data from the PID level based on current state. */
     virtual void GetRobotData(void);
     virtual void UpdateStateJointKinematics(void);
+
+    /*! Fill data for snapshot, called once per cycle.  Derived
+      classes can override to add arm specific data. */
+    virtual void UpdateSnapshot(mtsIntuitiveResearchKitArmSnapshotData & data);
+    mtsIntuitiveResearchKitArmSnapshot m_snapshot;
+    mtsIntuitiveResearchKitArmSnapshotData m_snapshot_data;
+
+    /*! Fill data for display snapshot, only called when requested */
+    void UpdateDisplaySnapshot(mtsIntuitiveResearchKitArmDisplayData & data);
+    mtsIntuitiveResearchKitArmDisplaySnapshot m_display_snapshot;
+    mtsIntuitiveResearchKitArmDisplayData m_display_snapshot_data;
+
     virtual void ToJointsPID(const vctDoubleVec & jointsKinematics, vctDoubleVec & jointsPID);
 
     // state machine
@@ -181,6 +218,9 @@ class CISST_EXPORT mtsIntuitiveResearchKitArm: public mtsTaskPeriodic
     virtual void body_set_cf_orientation_absolute(const bool & absolute);
     virtual void use_gravity_compensation(const bool & gravityCompensation);
     virtual void set_cartesian_impedance_gains(const prmCartesianImpedanceGains & gains);
+    /*! Switch to user mode, servo commands are read from the shared
+      memory mailbox at each cycle (see mtsSharedMemoryCommand). */
+    virtual void use_shared_memory_command(void);
 
     /*! Set base coordinate frame, this will be added to the kinematics */
     virtual void set_base_frame(const prmPositionCartesianSet & newBaseFrame);
@@ -358,11 +398,24 @@ class CISST_EXPORT mtsIntuitiveResearchKitArm: public mtsTaskPeriodic
     mtsIntuitiveResearchKitArmTypes::ControlSpace m_control_space;
     mtsIntuitiveResearchKitArmTypes::ControlMode m_control_mode;
 
-    /*! Method used to check if the arm is ready and throttle messages sent. */
+    /*! Method used to check if the arm is ready, messages are aggregated. */
     bool ArmIsReady(const std::string & methodName,
                     const mtsIntuitiveResearchKitArmTypes::ControlSpace space);
-    size_t mArmNotReadyCounter;
-    double mArmNotReadyTimeLastMessage;
+
+    /*! Errors and warnings that can happen every cycle (e.g. inverse
+      kinematics failures) are aggregated and sent from Run at most
+      once per mtsIntuitiveResearchKit::Messages::Interval.  message
+      must be a string literal. */
+    void SendAggregated(const mtsIntuitiveResearchKitMessageAggregator::LevelType level,
+                        const char * message);
+    void SendAggregated(const mtsIntuitiveResearchKitMessageAggregator::LevelType level,
+                        const char * message, const std::string & detail);
+    void SendArmMessage(const mtsIntuitiveResearchKitMessageAggregator::LevelType level,
+                        const std::string & text);
+    /*! Inverse kinematics failure, the first one is sent right away
+      with its own error, following ones are aggregated. */
+    void SendInverseKinematicsError(void);
+    mtsIntuitiveResearchKitMessageAggregator m_messages;
 
     /*! Set joint velocity ratio for trajectory generation.  Computes
       joint velocities based on maximum joint velocities.  Ratio must
@@ -430,6 +483,21 @@ class CISST_EXPORT mtsIntuitiveResearchKitArm: public mtsTaskPeriodic
 
     mtsCallableVoidBase * mControlCallback;
 
+    // servo commands from external process, active in user mode
+    struct {
+        mtsSharedMemoryCommand mailbox;
+        double timeout = mtsIntuitiveResearchKit::SharedMemoryCommand::Timeout;
+        uint64_t next_index = 0;
+        double last_time = 0.0;
+        uint32_t type = 0; // last command type, PID is reconfigured when type changes
+        // set by the control callback, RunHomed sends one error and freezes the arm
+        const char * freeze_reason = nullptr;
+        mtsSharedMemoryCommand::Data data;
+    } m_shared_memory_command;
+
+    /*! Control callback used after use_shared_memory_command */
+    virtual void control_shared_memory_command(void);
+
     virtual void control_servo_jp(void);
     virtual void control_move_jp(void);
     virtual void control_servo_cp(void);
@@ -491,6 +559,15 @@ class CISST_EXPORT mtsIntuitiveResearchKitArm: public mtsTaskPeriodic
     // flag to determine if this is connected to actual IO/hardware or simulated
     bool m_simulated;
 
+    // optional virtual clock, state table tic and period are used otherwise
+    const mtsIntuitiveResearchKitVirtualClock * m_virtual_clock = nullptr;
+    inline double Now(void) const {
+        return m_virtual_clock ? m_virtual_clock->Time() : StateTable.GetTic();
+    }
+    inline double ControlPeriod(void) const {
+        return m_virtual_clock ? m_virtual_clock->Step() : StateTable.PeriodStats.PeriodAvg();
+    }
+
     // flag to determine if the arm is running in calibration mode, i.e. turn off checks using potentiometers
     bool m_calibration_mode;
 };
@@ -34,6 +34,9 @@ http://www.cisst.org/cisst/license.txt.
 #include <cisstParameterTypes/prmPositionJointSetQtWidget.h>
 #include <cisstParameterTypes/prmOperatingStateQtWidget.h>
 
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArmSnapshot.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitQtRefresh.h>
+
 #include <QWidget>
 
 #include <sawIntuitiveResearchKit/sawIntuitiveResearchKitQtExport.h>
@@ -73,9 +76,23 @@ private slots:
 private:
     //! setup GUI
     void setupUi(void);
-    int TimerPeriodInMilliseconds;
 
 protected:
+    /*! Refresh period based on window's visibility and count of
+      reads/snapshots requested, derived classes should count their
+      own read commands. */
+    mtsIntuitiveResearchKitQtRefresh Refresh;
+
+    /*! Get joint state, cartesian position and wrench using the
+      arm's display snapshot if the arm is a dVRK arm in the same
+      process, read commands otherwise.  Returns false if there is
+      no new data. */
+    bool ReadArm(void);
+    void FindDisplaySnapshot(void);
+    const mtsIntuitiveResearchKitArmDisplaySnapshot * mDisplaySnapshot;
+    unsigned int mDisplaySequence;
+    mtsIntuitiveResearchKitArmDisplayData mDisplayData;
+
     struct ArmStruct {
         mtsFunctionRead configuration_js;
         mtsFunctionRead measured_js;
@@ -98,11 +115,11 @@ protected:
 
     bool DirectControl;
     prmConfigurationJoint ConfigurationJoint;
-    prmStateJoint StateJoint;
+    prmStateJoint StateJoint, StateJointDisplayed;
     prmStateJointQtWidget * QSJWidget;
     QDoubleSpinBox * QSBTrajectoryRatio;
 
-    prmPositionCartesianGet Position;
+    prmPositionCartesianGet Position, PositionDisplayed;
     prmPositionCartesianGetQtWidget * QCPGWidget;
 
     prmForceCartesianGet Wrench;
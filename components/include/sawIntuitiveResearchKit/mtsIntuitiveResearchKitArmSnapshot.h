@@ -0,0 +1,161 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-14
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIntuitiveResearchKitArmSnapshot_h
+#define _mtsIntuitiveResearchKitArmSnapshot_h
+
+#include <atomic>
+
+#include <cisstVector/vctFixedSizeVectorTypes.h>
+#include <cisstVector/vctTransformationTypes.h>
+#include <cisstParameterTypes/prmOperatingState.h>
+
+/*! Single writer, multiple readers sequence lock.  The writer never
+  blocks, readers retry if the data was modified while they were
+  copying it.  This is only meant to be used between components
+  running in the same process, e.g. an arm and a teleoperation
+  component.  The data type should be a plain structure, i.e. copy
+  has no side effect. */
+template <class _dataType>
+class mtsIntuitiveResearchKitSeqLock
+{
+public:
+    typedef _dataType DataType;
+
+    mtsIntuitiveResearchKitSeqLock(void):
+        mSequence(0)
+    {}
+
+    /*! Publish new data, should only be called by a single thread */
+    inline void Write(const DataType & data) {
+        const unsigned int sequence = mSequence.load(std::memory_order_relaxed);
+        // odd sequence means write in progress
+        mSequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mData = data;
+        std::atomic_thread_fence(std::memory_order_release);
+        mSequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /*! Copy latest data.  Returns false if data has never been
+      written or if the reader didn't get a consistent copy after
+      maxAttempts. */
+    inline bool Read(DataType & data, const size_t maxAttempts = 100) const {
+        for (size_t attempt = 0; attempt < maxAttempts; ++attempt) {
+            const unsigned int before = mSequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            data = mData;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const unsigned int after = mSequence.load(std::memory_order_relaxed);
+            if (before == after) {
+                return (before != 0);
+            }
+        }
+        return false;
+    }
+
+    /*! Number of writes, can be used to detect new data */
+    inline unsigned int Sequence(void) const {
+        return mSequence.load(std::memory_order_acquire) / 2;
+    }
+
+protected:
+    std::atomic<unsigned int> mSequence;
+    DataType mData;
+};
+
+/*! Sequence lock only written when requested by a reader.  Used for
+  data that is only displayed, e.g. by Qt widgets, so the real time
+  component doesn't copy anything if no widget is visible.  Readers
+  call Request on each refresh and get the data written at the end
+  of the writer's next cycle, Sequence can be used to check if new
+  data is available and count the snapshots written. */
+template <class _dataType>
+class mtsIntuitiveResearchKitSeqLockOnDemand: public mtsIntuitiveResearchKitSeqLock<_dataType>
+{
+public:
+    mtsIntuitiveResearchKitSeqLockOnDemand(void):
+        mRequested(false)
+    {}
+
+    /*! Request new data, can be called by any reader */
+    inline void Request(void) const {
+        mRequested.store(true, std::memory_order_relaxed);
+    }
+
+    /*! Called by the writer once per cycle, returns true if data
+      should be written.  Requests from multiple readers between two
+      cycles result in a single write. */
+    inline bool Requested(void) {
+        if (!mRequested.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        mRequested.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+protected:
+    mutable std::atomic<bool> mRequested;
+};
+
+/*! Data published by an arm once per cycle.  This contains all the
+  data a teleoperation component needs so it can be read without going
+  through multiple read commands. */
+struct mtsIntuitiveResearchKitArmSnapshotData
+{
+    double timestamp = 0.0;
+    bool measured_cp_valid = false;
+    vctFrm4x4 measured_cp;
+    bool setpoint_cp_valid = false;
+    vctFrm4x4 setpoint_cp;
+    prmOperatingState::StateType operating_state = prmOperatingState::DISABLED;
+    bool is_homed = false;
+    bool is_busy = false;
+    // MTM only
+    bool gripper_valid = false;
+    double gripper = 0.0;
+};
+
+typedef mtsIntuitiveResearchKitSeqLock<mtsIntuitiveResearchKitArmSnapshotData> mtsIntuitiveResearchKitArmSnapshot;
+
+/*! Data displayed by mtsIntuitiveResearchKitArmQtWidget, published
+  on demand.  Joint values are stored in fixed size vectors so the
+  structure can be copied by the sequence lock, names and frames are
+  only read once by the widget. */
+struct mtsIntuitiveResearchKitArmDisplayData
+{
+    enum {MAXIMUM_NUMBER_OF_JOINTS = 10};
+    typedef vctFixedSizeVector<double, MAXIMUM_NUMBER_OF_JOINTS> JointsType;
+
+    size_t number_of_joints = 0;
+    bool measured_js_valid = false;
+    double measured_js_timestamp = 0.0;
+    JointsType measured_jp, measured_jv, measured_jf;
+    bool measured_cp_valid = false;
+    double measured_cp_timestamp = 0.0;
+    vctFrm4x4 measured_cp;
+    bool body_measured_cf_valid = false;
+    double body_measured_cf_timestamp = 0.0;
+    vct6 body_measured_cf;
+};
+
+typedef mtsIntuitiveResearchKitSeqLockOnDemand<mtsIntuitiveResearchKitArmDisplayData> mtsIntuitiveResearchKitArmDisplaySnapshot;
+
+#endif // _mtsIntuitiveResearchKitArmSnapshot_h
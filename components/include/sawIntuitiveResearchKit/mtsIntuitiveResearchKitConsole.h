@@ -29,6 +29,7 @@ http://www.cisst.org/cisst/license.txt.
 #include <cisstParameterTypes/prmPositionCartesianSet.h>
 
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+#include <sawIntuitiveResearchKit/mtsSocketWireFormat.h>
 #include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
 
 // for ROS console
@@ -55,12 +56,13 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
                       ARM_MTM, ARM_PSM, ARM_ECM, ARM_SUJ,
                       ARM_MTM_GENERIC, ARM_PSM_GENERIC, ARM_ECM_GENERIC,
                       ARM_MTM_DERIVED, ARM_PSM_DERIVED, ARM_ECM_DERIVED,
-                      ARM_PSM_SOCKET,
+                      ARM_PSM_SOCKET, ARM_MTM_SOCKET, ARM_ECM_SOCKET,
                       FOCUS_CONTROLLER} ArmType;
 
         typedef enum {SIMULATION_NONE,
                       SIMULATION_KINEMATIC,
-                      SIMULATION_DYNAMIC} SimulationType;
+                      SIMULATION_DYNAMIC,
+                      SIMULATION_REPLAY} SimulationType;
 
         friend class mtsIntuitiveResearchKitConsole;
         friend class mtsIntuitiveResearchKitConsoleQt;
@@ -88,6 +90,12 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
         /*! Connect all interfaces specific to this arm. */
         bool Connect(void);
 
+        /*! Arm provided by a socket client or bridge, no IO, PID nor kinematics */
+        bool IsSocketClient(void) const;
+
+        /*! IO interfaces are provided, either by the IO, replay or stand-in component */
+        bool HasIOInterfaces(void) const;
+
         /*! Accessors */
         const std::string & Name(void) const;
         const std::string & SocketComponentName(void) const;
@@ -111,6 +119,7 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
         std::string m_IO_gripper_configuration_file; // for MTMs only
         // PID
         std::string m_PID_component_name;
+        std::string m_PID_interface_name;
         std::string m_PID_configuration_file;
         // arm
         std::string m_arm_component_name;
@@ -122,6 +131,12 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
         int m_port;
         bool m_socket_server;
         std::string m_socket_component_name;
+        mtsSocketWireFormat::FormatType m_socket_format;
+        Json::Value m_socket_jitter_buffer;
+        Json::Value m_socket_transport;
+        bool m_socket_bridged = false;
+        // dynamic simulation, see mtsIntuitiveResearchKitStandIn
+        Json::Value m_dynamics;
         // generic arm
         bool m_generic;
         bool m_skip_ROS_bridge;
@@ -173,6 +188,9 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
                              const double & periodInSeconds,
                              const Json::Value & jsonConfig);
 
+        /*! Arm provided by a socket client or bridge, no IO, PID nor kinematics */
+        bool IsSocketClient(void) const;
+
         /*! Accessors */
         const std::string & Name(void) const;
 
@@ -180,6 +198,7 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
         std::string m_name;
         TeleopECMType m_type;
         mtsFunctionWrite state_command;
+        mtsFunctionWrite emulate_clutch;
         mtsInterfaceRequired * InterfaceRequired;
     };
 
@@ -199,6 +218,9 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
                              const double & periodInSeconds,
                              const Json::Value & jsonConfig);
 
+        /*! Arm provided by a socket client or bridge, no IO, PID nor kinematics */
+        bool IsSocketClient(void) const;
+
         /*! Accessors */
         const std::string & Name(void) const;
 
@@ -218,6 +240,7 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
         std::string mPSMName;
         mtsFunctionWrite state_command;
         mtsFunctionWrite set_scale;
+        mtsFunctionWrite emulate_clutch;
         mtsInterfaceRequired * InterfaceRequired;
     };
 
@@ -232,6 +255,13 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
     const bool & calibration_mode(void) const;
     void calibration_mode(bool & result) const;
 
+    /*! Publish all dVRK arms and teleops in shared memory rings so a
+      GUI can run in a separate process (see
+      sawIntuitiveResearchKitQtRemote).  Rings are named
+      mtsIntuitiveResearchKit::Remote::Prefix + arm or teleop name.
+      This method must be called before Configure. */
+    void set_remote_telemetry(const bool remote);
+
     /*! Configure console using JSON file. To test is the configuration
       succeeded, used method Configured().
     */
@@ -309,6 +339,58 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
     bool ConfigureECMTeleopJSON(const Json::Value & jsonTeleop);
     bool ConfigurePSMTeleopJSON(const Json::Value & jsonTeleop);
 
+    /*! Optional bridge to multiplex arms over a single pair of UDP
+      ports, see mtsSocketBridge.  Must be configured before the
+      arms. */
+    bool ConfigureSocketBridgeJSON(const Json::Value & jsonBridge);
+    bool ConfigureStreamerJSON(const Json::Value & jsonStreamer);
+    bool ConfigureRemoteTelemetry(void);
+
+    /*! Optional replay of recorded PID and IO data for arms with
+      "simulation" set to "REPLAY", see mtsIntuitiveResearchKitReplay.
+      Must be configured before the arms. */
+    bool ConfigureReplayJSON(const Json::Value & jsonReplay, const cmnPath & configPath);
+    struct {
+        bool Configured = false;
+        std::string ComponentName = "Replay";
+        std::string FileName;
+        std::string IOComponentName = "io";
+        double Step = mtsIntuitiveResearchKit::IOPeriod;
+        double Rate = mtsIntuitiveResearchKit::Replay::Rate;
+        double Tolerance = mtsIntuitiveResearchKit::Replay::Tolerance;
+        Json::Value Tools;
+    } mReplay;
+
+    /*! Stand-in for IO and PID components, created if any arm has
+      "simulation" set to "DYNAMIC", see
+      mtsIntuitiveResearchKitStandIn. */
+    struct {
+        bool Configured = false;
+        std::string ComponentName = "StandIn";
+    } mStandIn;
+
+    /*! Optional virtual clock to step all simulated PIDs, arms, SUJ
+      and tele-operation components from a single thread, see
+      mtsIntuitiveResearchKitScheduler.  All arms must use the
+      "KINEMATIC" or "DYNAMIC" simulation. */
+    bool ConfigureVirtualClockJSON(const Json::Value & jsonClock);
+    struct {
+        bool Configured = false;
+        std::string ComponentName = "Scheduler";
+        double Step = mtsIntuitiveResearchKit::Scheduler::Step;
+        double Rate = mtsIntuitiveResearchKit::Scheduler::Rate;
+        bool Paused = false;
+    } mVirtualClock;
+    struct {
+        bool Configured = false;
+        bool Server = false;
+        std::string ComponentName = "SocketBridge";
+        std::string IP;
+        int Port = 0;
+        std::vector<std::string> Arms;
+        Json::Value Transport;
+    } mSocketBridge;
+
     void power_off(void);
     void power_on(void);
     void home(void);
@@ -326,10 +408,12 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
     void string_to_speech(const std::string & text);
     bool mHasIO;
     void ClutchEventHandler(const prmEventButton & button);
+    void emulate_clutch(const prmEventButton & button);
     void CameraEventHandler(const prmEventButton & button);
     void OperatorPresentEventHandler(const prmEventButton & button);
 
     bool m_calibration_mode = false;
+    bool m_remote_telemetry = false;
 
     struct {
         mtsFunctionWrite beep;
@@ -354,6 +438,9 @@ class CISST_EXPORT mtsIntuitiveResearchKitConsole: public mtsTaskFromSignal
     typedef std::pair<std::string, std::string> InterfaceComponentType;
     typedef std::map<std::string, InterfaceComponentType> DInputSourceType;
     DInputSourceType mDInputSources;
+    // teleop components connected directly to footpedal sources,
+    // console only observes
+    bool m_direct_footpedals = false;
 
     mtsInterfaceProvided * mInterface;
     struct {
@@ -0,0 +1,153 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-15
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitDynamicModel_h
+#define _mtsIntuitiveResearchKitDynamicModel_h
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Rigid body dynamics of a serial arm, integrated one step at a time.
+
+  Links are defined using the same DH parameters and inertial
+  parameters as the kinematic files (see share/kinematic), either
+  using the standard or modified convention.  Inverse dynamics are
+  computed with the recursive Newton-Euler algorithm in base
+  coordinates and the joint space inertia matrix is built one column
+  at a time, so a step costs n + 1 recursions and a Cholesky
+  decomposition, without memory allocation.
+
+  Each joint also has an armature (reflected rotor inertia, kg.m^2 or
+  kg), viscous and Coulomb friction and backlash.  Viscous friction
+  is integrated implicitly so large values don't make the model
+  unstable.  A joint moving slower than VelocityThreshold sticks
+  while the effort applied is lower than its Coulomb friction.
+  Backlash is a dead band between the drive and the link, positions
+  and velocities reported are on the link side and the link only
+  moves once the drive has taken up the play.  Joints stop at their
+  mechanical stops and brakes hold all joints in place.
+
+  Only depends on the C++ standard library. */
+class CISST_EXPORT mtsIntuitiveResearchKitDynamicModel
+{
+public:
+    struct Link {
+        bool Modified = false; // DH convention, standard by default
+        bool Prismatic = false;
+        double Alpha = 0.0, A = 0.0, Theta = 0.0, D = 0.0, Offset = 0.0;
+        double Mass = 0.0;
+        double CenterOfMass[3] = {0.0, 0.0, 0.0}; // in link frame
+        // inertia tensor at center of mass, in link frame, row major
+        double Inertia[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    };
+
+    struct Joint {
+        double Armature = 0.0;
+        double Viscous = 0.0;
+        double Coulomb = 0.0;
+        double Backlash = 0.0; // total play, centered on the drive position
+        // mechanical stops, joints stop without bouncing
+        double PositionMin = std::numeric_limits<double>::lowest();
+        double PositionMax = std::numeric_limits<double>::max();
+    };
+
+    /*! Velocity under which Coulomb friction can stick a joint */
+    static const double VelocityThreshold;
+
+    mtsIntuitiveResearchKitDynamicModel(void);
+
+    /*! Append a link and its joint, resets the state to zero. */
+    void AddLink(const Link & link, const Joint & joint);
+
+    inline size_t NumberOfJoints(void) const {
+        return mLinks.size();
+    }
+
+    inline Joint & JointParameters(const size_t index) {
+        return mJoints.at(index);
+    }
+
+    /*! Gravity acceleration in base frame, default is (0, 0, -9.81) */
+    void SetGravity(const double x, const double y, const double z);
+
+    /*! Set link side positions with zero velocities, play is centered */
+    void Reset(const double * positions);
+
+    /*! Hold all joints until released, velocities are set to zero */
+    void SetBrakes(const bool engaged);
+
+    inline bool BrakesEngaged(void) const {
+        return mBrakes;
+    }
+
+    /*! Integrate for dt seconds with efforts applied by the actuators,
+      using semi-implicit Euler. */
+    void Step(const double * efforts, const double dt);
+
+    /*! Link side state */
+    inline const std::vector<double> & Positions(void) const {
+        return mLinkPositions;
+    }
+    inline const std::vector<double> & Velocities(void) const {
+        return mLinkVelocities;
+    }
+
+    /*! Inverse dynamics, efforts required for given positions,
+      velocities and accelerations including gravity but not friction
+      nor armature.  Accelerations can be null for zero. */
+    void InverseDynamics(const double * positions, const double * velocities,
+                         const double * accelerations, double * efforts);
+
+    /*! Joint space inertia matrix including armatures, n x n row major */
+    void InertiaMatrix(const double * positions, double * inertia);
+
+protected:
+    /*! Link frames, joint axes and centers of mass in base coordinates */
+    void UpdateGeometry(const double * positions);
+
+    /*! Newton-Euler using geometry computed last, velocities and
+      accelerations can be null for zero */
+    void NewtonEuler(const double * velocities, const double * accelerations,
+                     const bool useGravity, double * efforts);
+
+    void InertiaMatrixFromGeometry(double * inertia);
+
+    std::vector<Link> mLinks;
+    std::vector<Joint> mJoints;
+    double mGravity[3];
+    bool mBrakes;
+
+    // state, drive and link sides
+    std::vector<double> mDrivePositions, mDriveVelocities, mLinkPositions, mLinkVelocities;
+
+    // geometry in base coordinates, 3 or 9 doubles per link
+    std::vector<double> mAxes, mJointPoints, mCenters, mInertias;
+
+    // Newton-Euler recursion, 3 doubles per link
+    std::vector<double> mOmega, mAlpha, mAccelerationCenter, mForces, mMoments;
+
+    // integration
+    std::vector<double> mBias, mInertia, mRightHandSide, mZeros, mUnit;
+    std::vector<bool> mStuck;
+};
+
+#endif // _mtsIntuitiveResearchKitDynamicModel_h
@@ -0,0 +1,80 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitLog_h
+#define _mtsIntuitiveResearchKitLog_h
+
+#include <initializer_list>
+#include <string>
+
+#include <cisstMultiTask/mtsExecutionResult.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLogQueue.h>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Run time errors and warnings from real time threads, to be used
+  instead of CMN_LOG_CLASS_RUN_ERROR/WARNING in code executed every
+  cycle.
+
+  Each thread has its own mtsIntuitiveResearchKitLogQueue, created
+  the first time the thread logs (or calls RegisterThread).  Once
+  Start has been called, a background thread formats the queued
+  messages and sends them to cmnLogger, so the calling thread only
+  pays for a bounded copy.  Before Start, or after Stop, messages are
+  written by the calling thread as soon as they are queued.  In both
+  cases, messages are rate limited per call site (see
+  mtsIntuitiveResearchKit::Log::MinimumInterval).
+
+  The message must be a string literal, see
+  mtsIntuitiveResearchKitLogQueue. */
+class CISST_EXPORT mtsIntuitiveResearchKitLog
+{
+public:
+    /*! Start the background thread, messages are written every period */
+    static void Start(void);
+
+    /*! Write remaining messages and stop the background thread */
+    static void Stop(void);
+
+    /*! Create the queue for the calling thread, to avoid the memory
+      allocation when the first message is logged.  Can be called in
+      the components' Startup. */
+    static void RegisterThread(void);
+
+    static void Error(const std::string & name, const char * message,
+                      std::initializer_list<double> values = {});
+    static void Error(const std::string & name, const char * message,
+                      const mtsExecutionResult & result);
+
+    static void Warning(const std::string & name, const char * message,
+                        std::initializer_list<double> values = {});
+    static void Warning(const std::string & name, const char * message,
+                        const mtsExecutionResult & result);
+
+    /*! Totals for all threads */
+    static size_t Dropped(void);
+    static size_t Suppressed(void);
+
+protected:
+    static void Push(const mtsIntuitiveResearchKitLogQueue::LevelType level,
+                     const std::string & name, const char * message,
+                     std::initializer_list<double> values, const int code);
+};
+
+#endif // _mtsIntuitiveResearchKitLog_h
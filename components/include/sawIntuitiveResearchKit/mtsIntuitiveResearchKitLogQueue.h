@@ -0,0 +1,124 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitLogQueue_h
+#define _mtsIntuitiveResearchKitLogQueue_h
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Log messages from a single real time thread, formatted and written
+  later by another thread (see mtsIntuitiveResearchKitLog).
+
+  Messages are fixed size records: the message itself must be a
+  string literal, only its address is stored.  The component name is
+  copied (truncated if needed), as well as a few numerical values and
+  an optional code.  Push doesn't allocate memory nor lock, records
+  are dropped if the queue is full.
+
+  Messages are rate limited per call site and component, i.e. per
+  message address and name since a thread can run multiple
+  components: a message pushed less than the minimum interval after
+  the last one accepted for the same component is suppressed.  The
+  number of suppressed messages is reported with the next one
+  accepted.
+
+  There must be a single producer thread (Push) and a single consumer
+  thread (Pop).
+
+  Only depends on the C++ standard library. */
+class CISST_EXPORT mtsIntuitiveResearchKitLogQueue
+{
+public:
+    typedef enum {LOG_ERROR, LOG_WARNING} LevelType;
+
+    enum {NAME_SIZE = 32,
+          MAXIMUM_NUMBER_OF_VALUES = 8,
+          NUMBER_OF_SITES = 64};
+
+    struct Record {
+        LevelType Level;
+        double Time;
+        const char * Message;
+        char Name[NAME_SIZE];
+        size_t NumberOfValues;
+        double Values[MAXIMUM_NUMBER_OF_VALUES];
+        int Code; // negative if not used
+        size_t Suppressed; // similar messages suppressed before this one
+    };
+
+    /*! Constructor
+        \param capacity Number of records, rounded up to a power of 2
+        \param minimumInterval Seconds between messages from the same call site
+    */
+    mtsIntuitiveResearchKitLogQueue(const size_t capacity, const double minimumInterval);
+
+    inline size_t Capacity(void) const {
+        return mRecords.size();
+    }
+
+    /*! Producer side, returns false if the message has been suppressed
+      or dropped.  Values beyond MAXIMUM_NUMBER_OF_VALUES are
+      ignored. */
+    bool Push(const LevelType level, const double time,
+              const std::string & name, const char * message,
+              std::initializer_list<double> values = {},
+              const int code = -1);
+
+    /*! Consumer side, returns false if the queue is empty */
+    bool Pop(Record & record);
+
+    /*! Messages lost because the queue was full */
+    inline size_t Dropped(void) const {
+        return mDropped;
+    }
+
+    /*! Messages not queued because of rate limiting */
+    inline size_t Suppressed(void) const {
+        return mSuppressed;
+    }
+
+    /*! Human readable message, without the level nor the code */
+    static std::string Format(const Record & record);
+
+protected:
+    struct Site {
+        const char * Message;
+        size_t NameHash;
+        double LastTime;
+        size_t Suppressed;
+    };
+
+    std::vector<Record> mRecords;
+    size_t mMask;
+    std::atomic<size_t> mHead; // next record written, producer
+    std::atomic<size_t> mTail; // next record read, consumer
+    std::atomic<size_t> mDropped;
+    std::atomic<size_t> mSuppressed;
+    double mMinimumInterval;
+    Site mSites[NUMBER_OF_SITES];
+    size_t mNumberOfSites;
+};
+
+#endif // _mtsIntuitiveResearchKitLogQueue_h
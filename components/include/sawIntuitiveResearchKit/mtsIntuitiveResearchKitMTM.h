@@ -106,6 +106,9 @@ protected:
       calling mtsIntuitiveResearchKitArm::GetRobotData. */
     void GetRobotData(void) override;
 
+    /*! Add gripper to arm snapshot. */
+    void UpdateSnapshot(mtsIntuitiveResearchKitArmSnapshotData & data) override;
+
     // see base class
     void control_servo_cf_orientation_locked(void) override;
     void SetControlEffortActiveJoints(void) override;
@@ -0,0 +1,132 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitMessageAggregator_h
+#define _mtsIntuitiveResearchKitMessageAggregator_h
+
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Aggregate messages (errors, warnings, status) that can be
+  triggered every cycle, e.g. inverse kinematics failures.
+
+  Messages are identified by a string literal, only its address is
+  used.  Add only counts occurrences and keeps the latest detail.
+  Process, called once per cycle, sends each message with
+  occurrences at most once per interval, with the number of
+  occurrences since it was last sent.  Strings are only built when a
+  message is sent.  The first occurrence of a message is sent by the
+  next call to Process unless AddOrSend is used.
+
+  Only depends on the C++ standard library. */
+class CISST_EXPORT mtsIntuitiveResearchKitMessageAggregator
+{
+public:
+    typedef enum {MESSAGE_STATUS, MESSAGE_WARNING, MESSAGE_ERROR} LevelType;
+
+    /*! Constructor
+        \param interval Minimum time between two sends of the same message
+        \param maximumNumberOfMessages Messages beyond are never aggregated
+    */
+    mtsIntuitiveResearchKitMessageAggregator(const double interval,
+                                             const size_t maximumNumberOfMessages = 32);
+
+    inline void SetInterval(const double interval) {
+        mInterval = interval;
+    }
+
+    inline double Interval(void) const {
+        return mInterval;
+    }
+
+    /*! Count one occurrence.  Returns false if the message can't be
+      aggregated because too many different messages have been used,
+      caller should then send it directly. */
+    bool Add(const LevelType level, const char * message);
+    bool Add(const LevelType level, const char * message, const std::string & detail);
+
+    /*! Same as Add but the occurrence is sent right away with its
+      own detail if nothing is pending and the interval since the
+      last send elapsed, i.e. the first occurrence isn't delayed nor
+      merged with the following ones.  Returns false if the message
+      can't be aggregated, caller should then send it directly. */
+    template <typename _sender>
+    bool AddOrSend(const double time, const LevelType level, const char * message,
+                   const std::string & detail, _sender sender) {
+        Entry * entry = Find(message);
+        if (!entry) {
+            return false;
+        }
+        entry->Level = level;
+        entry->Detail.assign(detail);
+        ++(entry->Count);
+        if ((entry->Count == 1)
+            && (time - entry->LastSent >= mInterval)) {
+            sender(entry->Level, Text(*entry, time));
+            entry->Count = 0;
+            entry->LastSent = time;
+        }
+        return true;
+    }
+
+    /*! Occurrences not sent yet, for a given message */
+    size_t Pending(const char * message) const;
+
+    /*! Forget occurrences not sent yet and time of last send, e.g.
+      when the condition that triggered the message is cleared */
+    void Reset(const char * message);
+
+    /*! Send messages with pending occurrences if their interval
+      elapsed.  sender is called with the level and the text. */
+    template <typename _sender>
+    void Process(const double time, _sender sender) {
+        for (auto & entry : mEntries) {
+            if ((entry.Count == 0)
+                || (time - entry.LastSent < mInterval)) {
+                continue;
+            }
+            sender(entry.Level, Text(entry, time));
+            entry.Count = 0;
+            entry.LastSent = time;
+        }
+    }
+
+protected:
+    struct Entry {
+        LevelType Level;
+        const char * Message;
+        std::string Detail;
+        size_t Count;
+        double LastSent;
+    };
+
+    Entry * Find(const char * message);
+    std::string Text(const Entry & entry, const double time) const;
+
+    double mInterval;
+    size_t mMaximumNumberOfMessages;
+    std::vector<Entry> mEntries;
+};
+
+#endif // _mtsIntuitiveResearchKitMessageAggregator_h
@@ -0,0 +1,56 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIntuitiveResearchKitQtRefresh_h
+#define _mtsIntuitiveResearchKitQtRefresh_h
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRefreshRate.h>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitQtExport.h>
+
+class QLabel;
+class QWidget;
+
+/*! Timer management for widgets using mtsIntuitiveResearchKitRefreshRate.
+
+  Start replaces the widget's startTimer and Tick should be called at
+  the beginning of the widget's timerEvent.  Tick restarts the timer
+  when the window's visibility changes and returns false if the
+  widget is hidden or minimized.  QLLoad displays the reads and
+  snapshots per second, it has to be added to the widget's layout. */
+class CISST_EXPORT mtsIntuitiveResearchKitQtRefresh: public mtsIntuitiveResearchKitRefreshRate
+{
+public:
+    mtsIntuitiveResearchKitQtRefresh(const double periodInSeconds);
+
+    void Start(QWidget * widget);
+    bool Tick(void);
+
+    /*! Returns true once per mtsIntuitiveResearchKit::Display::StatisticsPeriod */
+    bool StatisticsDue(void);
+
+    QLabel * QLLoad;
+
+protected:
+    QWidget * mWidget;
+    int mTimerId;
+    double mTime;
+    double mLastStatistics;
+};
+
+#endif // _mtsIntuitiveResearchKitQtRefresh_h
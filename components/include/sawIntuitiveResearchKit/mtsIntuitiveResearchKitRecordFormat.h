@@ -0,0 +1,156 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIntuitiveResearchKitRecordFormat_h
+#define _mtsIntuitiveResearchKitRecordFormat_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Binary file format used by mtsIntuitiveResearchKitRecorder, see
+  mtsIntuitiveResearchKitRecordWriter and
+  mtsIntuitiveResearchKitRecordReader.  Each signal is a fixed number
+  of scalars (e.g. all the scalars of a prmStateJoint) and samples are
+  stored by chunks.  Within a chunk, data is stored by column (all
+  times, then all values of the first scalar...) and each column is
+  delta encoded so slowly changing and constant values use one or two
+  bytes.  This class only depends on the C++ standard library.
+
+  Layout, all offsets in bytes, all values little-endian:
+  - file header (64 bytes)
+    - 0: uint32 magic number, "dVRR"
+    - 4: uint16 format version
+    - 6: uint16 header size
+    - 8: uint64 index offset, 0 if the file was not closed properly
+    - 16: uint32 number of index entries
+    - 20: uint32 number of signals
+    - 24: uint64 end of last record, updated after each flush
+  - records, each starts with a 32 bytes header
+    - 0: uint32 record type, "dVRS" for signal or "dVRC" for chunk
+    - 4: uint32 signal id, order in which signals have been added
+    - 8: uint32 number of samples, 0 for signal records
+    - 12: uint32 payload size
+    - 16: double time of first sample
+    - 24: double time of last sample
+  - signal payload
+    - uint16 name size, name
+    - uint32 number of scalars
+    - for each scalar, uint16 name size, name
+  - chunk payload
+    - times in nanoseconds, zigzag varint of first time then of the
+      differences between consecutive intervals
+    - for each scalar, varint of the bits of each value XOR the bits
+      of the previous value (0 for the first value)
+  - index, written when the file is closed, one entry per record
+    (32 bytes)
+    - 0: uint32 record type
+    - 4: uint32 signal id
+    - 8: uint64 record offset
+    - 16: double time of first sample
+    - 24: double time of last sample
+
+  Times are stored with a nanosecond resolution, values are stored
+  without any loss. */
+class CISST_EXPORT mtsIntuitiveResearchKitRecordFormat
+{
+public:
+    static const uint32_t Magic = 0x52525664; // "dVRR" in little-endian
+    static const uint16_t Version = 1;
+    static const size_t HeaderSize = 64;
+    static const size_t RecordHeaderSize = 32;
+    static const size_t IndexEntrySize = 32;
+
+    typedef enum {SIGNAL_RECORD = 0x53525664, // "dVRS"
+                  CHUNK_RECORD = 0x43525664   // "dVRC"
+    } RecordType;
+
+    struct Header {
+        Header(void);
+        uint64_t IndexOffset;
+        uint32_t NumberOfIndexEntries;
+        uint32_t NumberOfSignals;
+        uint64_t DataEnd;
+    };
+
+    struct RecordHeader {
+        RecordHeader(void);
+        uint32_t Type;
+        uint32_t Signal;
+        uint32_t NumberOfSamples;
+        uint32_t PayloadSize;
+        double StartTime;
+        double EndTime;
+    };
+
+    struct IndexEntry {
+        uint32_t Type;
+        uint32_t Signal;
+        uint64_t Offset;
+        double StartTime;
+        double EndTime;
+    };
+
+    struct Signal {
+        std::string Name;
+        std::vector<std::string> ScalarNames;
+    };
+
+    /*! Headers and index entries, buffers must be large enough */
+    //@{
+    static void EncodeHeader(const Header & header, char * buffer);
+    static bool DecodeHeader(const char * buffer, const size_t size, Header & header);
+    static void EncodeRecordHeader(const RecordHeader & header, char * buffer);
+    static void DecodeRecordHeader(const char * buffer, RecordHeader & header);
+    static void EncodeIndexEntry(const IndexEntry & entry, char * buffer);
+    static void DecodeIndexEntry(const char * buffer, IndexEntry & entry);
+    //@}
+
+    /*! Signal description, returns the number of bytes used or 0 if
+      the buffer is too small */
+    static size_t SignalSize(const Signal & signal);
+    static size_t EncodeSignal(const Signal & signal, char * buffer, const size_t bufferSize);
+    static bool DecodeSignal(const char * buffer, const size_t size, Signal & signal);
+
+    /*! Time as stored in chunks, rounded to the nanosecond */
+    static double StoredTime(const double time);
+
+    /*! Worst case payload size for a chunk */
+    static size_t MaximumChunkSize(const size_t numberOfSamples, const size_t numberOfScalars);
+
+    /*! Encode a chunk.  Values are stored by column, value for scalar
+      s and sample i is values[s * stride + i].  Returns the number
+      of bytes used or 0 if the buffer is too small. */
+    static size_t EncodeChunk(const double * times, const double * values,
+                              const size_t numberOfSamples, const size_t numberOfScalars,
+                              const size_t stride,
+                              char * buffer, const size_t bufferSize);
+
+    /*! Decode a chunk.  Values are stored by row, value for scalar s
+      and sample i is values[i * numberOfScalars + s].  Returns false
+      if the payload is truncated or corrupted. */
+    static bool DecodeChunk(const char * buffer, const size_t size,
+                            const size_t numberOfSamples, const size_t numberOfScalars,
+                            double * times, double * values);
+};
+
+#endif // _mtsIntuitiveResearchKitRecordFormat_h
@@ -0,0 +1,96 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIntuitiveResearchKitRecordReader_h
+#define _mtsIntuitiveResearchKitRecordReader_h
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordFormat.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Reads files created by mtsIntuitiveResearchKitRecordWriter.  The
+  file is memory mapped and only the chunks overlapping the requested
+  time range are decoded.  If the file was not closed properly (no
+  index), the reader scans all the records written so far.  Like
+  mtsIntuitiveResearchKitRecordWriter, this class only depends on the
+  C++ standard library and POSIX. */
+class CISST_EXPORT mtsIntuitiveResearchKitRecordReader
+{
+public:
+    typedef mtsIntuitiveResearchKitRecordFormat Format;
+
+    mtsIntuitiveResearchKitRecordReader(void);
+    ~mtsIntuitiveResearchKitRecordReader();
+
+    bool Open(const std::string & fileName);
+    void Close(void);
+
+    /*! False if the index was rebuilt by scanning the file */
+    inline bool IsIndexed(void) const {
+        return mIndexed;
+    }
+
+    inline size_t NumberOfSignals(void) const {
+        return mSignals.size();
+    }
+
+    inline const Format::Signal & Signal(const size_t signal) const {
+        return mSignals.at(signal);
+    }
+
+    /*! Signal id or -1 if not found */
+    int FindSignal(const std::string & name) const;
+
+    size_t NumberOfSamples(const size_t signal) const;
+
+    /*! Times of first and last samples, false if the signal has no sample */
+    bool TimeRange(const size_t signal, double & startTime, double & endTime) const;
+
+    /*! All samples between startTime and endTime (included).  Values
+      are stored by row, i.e. values[sample * number of scalars +
+      scalar].  Returns the number of samples or -1 if the file is
+      corrupted. */
+    int Read(const size_t signal, const double startTime, const double endTime,
+             std::vector<double> & times, std::vector<double> & values) const;
+
+    inline const std::string & LastError(void) const {
+        return mLastError;
+    }
+
+protected:
+    struct Chunk {
+        uint64_t Offset;
+        uint32_t NumberOfSamples;
+        double StartTime;
+        double EndTime;
+    };
+
+    bool AddRecord(const uint64_t offset);
+    bool LoadIndex(const Format::Header & header);
+    void Scan(void);
+
+    const char * mMemory;
+    size_t mMemorySize;
+    bool mIndexed;
+    std::vector<Format::Signal> mSignals;
+    std::vector<std::vector<Chunk> > mChunks;
+    mutable std::string mLastError;
+};
+
+#endif // _mtsIntuitiveResearchKitRecordReader_h
@@ -0,0 +1,141 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIntuitiveResearchKitRecordWriter_h
+#define _mtsIntuitiveResearchKitRecordWriter_h
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordFormat.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Writes signals to a memory mapped file using
+  mtsIntuitiveResearchKitRecordFormat.
+
+  Each signal has a ring of preallocated buffers, each buffer holds
+  up to "chunk size" samples stored by column.  Append only copies
+  the sample in the current buffer, it never allocates, locks or
+  blocks so it can be called from the arm control loop.  A background
+  thread encodes full buffers and writes them to the file.  If the
+  background thread falls behind and all the buffers of a signal are
+  full, new samples are dropped and counted (see Statistics).
+
+  Each signal must be appended by a single thread, different signals
+  can be appended by different threads.  Signals can be added while
+  recording.  Close must be called once all threads stopped appending,
+  it writes partial buffers and the index.  If the process stops
+  before Close, mtsIntuitiveResearchKitRecordReader can still read
+  all the chunks written.  Like mtsSharedMemoryRing, this class only
+  depends on the C++ standard library and POSIX. */
+class CISST_EXPORT mtsIntuitiveResearchKitRecordWriter
+{
+public:
+    static const size_t MaximumNumberOfSignals = 256;
+
+    struct Statistics {
+        uint64_t NumberOfSamples;
+        uint64_t NumberOfDroppedSamples;
+        uint64_t NumberOfChunks;
+        uint64_t NumberOfBytes; // file size, including headers
+    };
+
+    mtsIntuitiveResearchKitRecordWriter(void);
+    ~mtsIntuitiveResearchKitRecordWriter();
+
+    /*! Create the file and start the background thread.  Memory used
+      per signal is chunkSize * numberOfBuffers * (number of scalars + 1)
+      doubles. */
+    bool Open(const std::string & fileName,
+              const size_t chunkSize = 1024,
+              const size_t numberOfBuffers = 8);
+
+    /*! Flush all buffers, write the index and close the file */
+    bool Close(void);
+
+    inline bool IsOpen(void) const {
+        return mOpen;
+    }
+
+    /*! Add a signal, returns the signal id to use with Append or -1 */
+    int AddSignal(const std::string & name, const std::vector<std::string> & scalarNames);
+
+    /*! Append one sample, values must contain one double per scalar.
+      Returns false if the sample was dropped. */
+    bool Append(const int signal, const double time, const double * values);
+
+    Statistics GetStatistics(void) const;
+    std::string LastError(void) const;
+
+protected:
+    typedef mtsIntuitiveResearchKitRecordFormat Format;
+
+    typedef enum {BUFFER_FREE = 0, BUFFER_FILLING, BUFFER_FULL} BufferState;
+
+    struct SignalBuffers;
+
+    void Run(void);
+    void Flush(const bool final);
+    bool WriteSignal(const size_t id, SignalBuffers & signal);
+    bool WriteChunk(const size_t id, SignalBuffers & signal, const size_t buffer);
+    bool Reserve(const size_t size);
+    void UpdateHeader(const uint64_t indexOffset);
+    bool Fail(const std::string & what);
+
+    // configuration, set by Open
+    std::string mFileName;
+    size_t mChunkSize;
+    size_t mNumberOfBuffers;
+
+    // signals, added under mutex and published using the counter
+    std::mutex mSignalsMutex;
+    std::unique_ptr<SignalBuffers> mSignals[MaximumNumberOfSignals];
+    std::atomic<size_t> mNumberOfSignals;
+
+    // background thread
+    std::atomic<bool> mOpen;
+    std::thread mThread;
+    std::mutex mThreadMutex;
+    std::condition_variable mCondition;
+    bool mStop;
+
+    // file, only used by the background thread once started
+    int mFileDescriptor;
+    char * mMemory;
+    size_t mMemorySize;
+    size_t mOffset;
+    size_t mNumberOfSignalRecords;
+    bool mFailed;
+    std::vector<Format::IndexEntry> mIndex;
+
+    // statistics
+    std::atomic<uint64_t> mNumberOfSamples;
+    std::atomic<uint64_t> mNumberOfDroppedSamples;
+    std::atomic<uint64_t> mNumberOfChunks;
+    std::atomic<uint64_t> mNumberOfBytes;
+
+    mutable std::mutex mErrorMutex;
+    std::string mLastError;
+};
+
+#endif // _mtsIntuitiveResearchKitRecordWriter_h
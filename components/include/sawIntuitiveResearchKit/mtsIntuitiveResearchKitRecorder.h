@@ -0,0 +1,129 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitRecorder_h
+#define _mtsIntuitiveResearchKitRecorder_h
+
+#include <memory>
+#include <vector>
+
+#include <cisstMultiTask/mtsTaskPeriodic.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordWriter.h>
+
+#include <cisstMultiTask/mtsForwardDeclarations.h>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Record signals from a component to a binary file, see
+  mtsIntuitiveResearchKitRecordWriter for the file and
+  mtsIntuitiveResearchKitRecordReader to read it.
+
+  Signals are read from the required interface "Source" using read
+  commands (e.g. "measured_js", "setpoint_cp").  All the scalars of
+  each signal are recorded (see cmnGenericObject::ScalarNumber) except
+  the timestamps, the time of each sample is the data timestamp so
+  times are relative to the time server origin, like state tables.
+  Samples with the same timestamp as the previous sample are not
+  recorded again.
+
+  Like mtsIntuitiveResearchKitUDPStreamer, the "ExecIn" interface
+  should be connected to the "ExecOut" interface of the source so the
+  recorder runs in the source thread and records one sample per
+  cycle.  The recorder only copies the values in preallocated buffers,
+  encoding and file IO happen in the writer background thread.
+  Multiple recorders can share the same writer, i.e. the same file.
+
+  Use AddRecorders to create the recorders from a JSON configuration
+  file. */
+class CISST_EXPORT mtsIntuitiveResearchKitRecorder : public mtsTaskPeriodic
+{
+    CMN_DECLARE_SERVICES(CMN_NO_DYNAMIC_CREATION, CMN_LOG_ALLOW_DEFAULT);
+
+ protected:
+    struct Signal {
+        Signal(void): Data(nullptr), Id(-1), LastTimestamp(0.0) {}
+        ~Signal() {
+            delete Data;
+        }
+        std::string Name;
+        mtsFunctionRead Function;
+        mtsGenericObject * Data;
+        int Id; // from writer, -1 until first sample
+        std::vector<size_t> Scalars; // indices of scalars recorded
+        std::vector<double> Values;
+        double LastTimestamp;
+    };
+
+    std::string mPrefix;
+    std::shared_ptr<mtsIntuitiveResearchKitRecordWriter> mWriter;
+    std::vector<Signal *> mSignals;
+
+    // statistics
+    unsigned int mNumberOfSamples;
+    unsigned int mNumberOfDuplicates;
+    unsigned int mNumberOfDroppedSamples;
+
+    bool AddSignal(Signal & signal);
+
+ public:
+    /*! Constructor
+        \param name Name of the component
+        \param period Period in seconds, only used if ExecIn is not connected
+        \param writer Writer used to save samples, can be shared between recorders
+        \param prefix Prefix used for all signal names, e.g. "PSM1/"
+    */
+    mtsIntuitiveResearchKitRecorder(const std::string & name, const double period,
+                                    std::shared_ptr<mtsIntuitiveResearchKitRecordWriter> writer,
+                                    const std::string & prefix);
+
+    /*! Destructor */
+    virtual ~mtsIntuitiveResearchKitRecorder();
+
+    /*! Add read commands to record, must be called before the
+      component is connected */
+    void Configure(const std::vector<std::string> & signals);
+
+    void Startup(void);
+
+    void Run(void);
+
+    void Cleanup(void);
+
+    /*! Create and connect the recorders defined in JSON.  The
+      configuration must have "file" and "sources".  "chunk-size" and
+      "buffers" are optional, see
+      mtsIntuitiveResearchKit::Recorder.  Each source has
+      "component", "signals" (read commands) and optionally
+      "interface" (default is "Arm") and "period" (only used if the
+      component doesn't trigger ExecOut).  Components must have been
+      added to the component manager.  Returns false if the
+      configuration is invalid. */
+    static bool AddRecorders(const Json::Value & jsonConfig);
+
+    /*! Indices and names of the scalars recorded for a given data
+      object, i.e. all scalars but the timestamps.  Used to map
+      recorded values back to data objects for replay. */
+    static void RecordedScalars(const mtsGenericObject & data,
+                                std::vector<size_t> & indices,
+                                std::vector<std::string> & names);
+};
+
+CMN_DECLARE_SERVICES_INSTANTIATION(mtsIntuitiveResearchKitRecorder)
+
+#endif // _mtsIntuitiveResearchKitRecorder_h
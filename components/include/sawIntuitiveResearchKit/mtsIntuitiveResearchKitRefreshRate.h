@@ -0,0 +1,151 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitRefreshRate_h
+#define _mtsIntuitiveResearchKitRefreshRate_h
+
+#include <cmath>
+#include <cstddef>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Refresh policy for widgets displaying data from real time
+  components.
+
+  The refresh period depends on the window's visibility: nominal
+  period when the window has focus, slower when it doesn't and very
+  slow when it is hidden or minimized (only to detect when it is
+  restored).  This class also counts the read commands and snapshots
+  requested by the widget so the load put on the real time component
+  can be displayed.  It doesn't depend on Qt, see
+  mtsIntuitiveResearchKitQtRefresh for the timer management. */
+class CISST_EXPORT mtsIntuitiveResearchKitRefreshRate
+{
+public:
+    typedef enum {REFRESH_FOCUSED, REFRESH_UNFOCUSED, REFRESH_MINIMIZED} VisibilityType;
+
+    /*! All times in seconds, period is used when the window has
+      focus.  Load (reads and snapshots per second) is computed over
+      loadInterval. */
+    mtsIntuitiveResearchKitRefreshRate(const double period,
+                                       const double unfocusedFactor,
+                                       const double minimizedPeriod,
+                                       const double loadInterval);
+
+    /*! Period for a given visibility, never faster than nominal period */
+    double Period(const VisibilityType visibility) const;
+
+    /*! Set visibility, returns true if the period changed, i.e. timer
+      should be restarted with CurrentPeriod. */
+    bool SetVisibility(const VisibilityType visibility);
+
+    inline VisibilityType Visibility(void) const {
+        return mVisibility;
+    }
+
+    inline double CurrentPeriod(void) const {
+        return Period(mVisibility);
+    }
+
+    /*! Read commands sent to the real time component */
+    inline void AddReads(const size_t reads = 1) {
+        mReads += reads;
+    }
+
+    /*! Snapshots written by the real time component for this widget */
+    inline void AddSnapshots(const size_t snapshots = 1) {
+        mSnapshots += snapshots;
+    }
+
+    /*! Update load, returns true once per load interval when new
+      values are available. */
+    bool UpdateLoad(const double time);
+
+    inline double ReadsPerSecond(void) const {
+        return mReadsPerSecond;
+    }
+
+    inline double SnapshotsPerSecond(void) const {
+        return mSnapshotsPerSecond;
+    }
+
+    /*! Request and read an on demand snapshot (see
+      mtsIntuitiveResearchKitSeqLockOnDemand).  Returns true if new
+      data was written since last call, i.e. the data displayed is
+      one refresh period old.  Snapshots written are counted. */
+    template <class _snapshotType>
+    bool ReadSnapshot(const _snapshotType & snapshot,
+                      unsigned int & lastSequence,
+                      typename _snapshotType::DataType & data) {
+        snapshot.Request();
+        const unsigned int sequence = snapshot.Sequence();
+        if (sequence == lastSequence) {
+            return false;
+        }
+        AddSnapshots(sequence - lastSequence);
+        lastSequence = sequence;
+        return snapshot.Read(data);
+    }
+
+    /*! Check if any element changed more than precision, used to
+      skip redraws.  Containers of different sizes are always
+      considered changed. */
+    template <class _containerType>
+    static bool Changed(const _containerType & previous,
+                        const _containerType & current,
+                        const double precision) {
+        if (previous.size() != current.size()) {
+            return true;
+        }
+        auto previousIter = previous.begin();
+        for (auto currentIter = current.begin();
+             currentIter != current.end();
+             ++currentIter, ++previousIter) {
+            if (std::abs(*currentIter - *previousIter) > precision) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*! Same as Changed for frames, i.e. types with Translation and
+      Rotation. */
+    template <class _frameType>
+    static bool ChangedFrame(const _frameType & previous,
+                             const _frameType & current,
+                             const double precision) {
+        return Changed(previous.Translation(), current.Translation(), precision)
+            || Changed(previous.Rotation(), current.Rotation(), precision);
+    }
+
+protected:
+    double mPeriod;
+    double mUnfocusedFactor;
+    double mMinimizedPeriod;
+    VisibilityType mVisibility;
+
+    double mLoadInterval;
+    double mLoadStart;
+    size_t mReads;
+    size_t mSnapshots;
+    double mReadsPerSecond;
+    double mSnapshotsPerSecond;
+};
+
+#endif // _mtsIntuitiveResearchKitRefreshRate_h
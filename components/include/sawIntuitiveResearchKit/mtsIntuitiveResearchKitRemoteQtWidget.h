@@ -0,0 +1,98 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIntuitiveResearchKitRemoteQtWidget_h
+#define _mtsIntuitiveResearchKitRemoteQtWidget_h
+
+#include <vector>
+
+#include <cisstVector/vctForceTorqueQtWidget.h>
+#include <cisstParameterTypes/prmStateJointQtWidget.h>
+#include <cisstParameterTypes/prmPositionCartesianGetQtWidget.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitStreamFormat.h>
+#include <sawIntuitiveResearchKit/mtsSharedMemoryRing.h>
+
+#include <QWidget>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitQtExport.h>
+
+class QLabel;
+
+/*! Read-only arm or teleop display for a console running in another
+  process.
+
+  Data is read from the shared memory ring published by the console
+  when remote telemetry is enabled (see
+  mtsIntuitiveResearchKitConsole::set_remote_telemetry).  The widget
+  only maps the ring read-only and reads the latest slot on each
+  timer tick, it never sends commands nor reads from the arm's state
+  tables so its cost for the console is limited to the streamer
+  running in the arm's thread.  If the ring doesn't exist or stops
+  being updated (e.g. console restarted), the widget keeps trying to
+  open it. */
+class CISST_EXPORT mtsIntuitiveResearchKitRemoteQtWidget: public QWidget
+{
+    Q_OBJECT;
+
+public:
+    mtsIntuitiveResearchKitRemoteQtWidget(const std::string & ringName,
+                                          double periodInSeconds = 50.0 * cmn_ms);
+    ~mtsIntuitiveResearchKitRemoteQtWidget() {}
+
+    void Startup(void);
+
+private slots:
+    void timerEvent(QTimerEvent * event);
+
+private:
+    //! setup GUI
+    void setupUi(void);
+    int TimerPeriodInMilliseconds;
+
+protected:
+    typedef mtsIntuitiveResearchKitStreamFormat StreamFormat;
+
+    bool Read(void);
+    void SetStatus(const QString & status);
+
+    std::string mRingName;
+    mtsSharedMemoryRing mRing;
+    std::vector<char> mBuffer;
+    StreamFormat::Header mHeader;
+    StreamFormat::Sample mSample;
+
+    // to compute the arm's rate and detect writers that stopped,
+    // times from different processes can't be compared
+    uint64_t mLastWriteCount;
+    double mLastWriteTime;
+    uint32_t mLastIndex;
+    double mLastTimestamp;
+
+    QLabel * QLStatus;
+    QLabel * QLState;
+    QLabel * QLTeleopLabel;
+    QLabel * QLTeleop;
+    QLabel * QLRate;
+    QLabel * QLAge;
+    prmStateJointQtWidget * QSJWidget;
+    prmPositionCartesianGetQtWidget * QCPGWidget;
+    vctForceTorqueQtWidget * QFTWidget;
+};
+
+#endif // _mtsIntuitiveResearchKitRemoteQtWidget_h
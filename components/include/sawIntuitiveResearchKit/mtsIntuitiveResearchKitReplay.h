@@ -0,0 +1,213 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-12
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitReplay_h
+#define _mtsIntuitiveResearchKitReplay_h
+
+#include <map>
+#include <vector>
+
+#include <cisstMultiTask/mtsTaskContinuous.h>
+#include <cisstParameterTypes/prmActuatorJointCoupling.h>
+#include <cisstParameterTypes/prmConfigurationJoint.h>
+#include <cisstParameterTypes/prmEventButton.h>
+#include <cisstParameterTypes/prmPositionJointSet.h>
+#include <cisstParameterTypes/prmStateJoint.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitReplayTrack.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitVirtualClock.h>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Replay PID and IO data recorded with mtsIntuitiveResearchKitRecorder
+  through unmodified arm, tele-operation and console components.
+
+  This component replaces both the PID and IO components.  For each
+  arm added, it provides the same interfaces as sawControllersPID
+  ("<arm>-Controller") and sawRobotIO1394 ("<arm>", "<arm>-Gripper",
+  "<arm>-Adapter", "<arm>-Tool", "<arm>-ManipClutch",
+  "<arm>-SUJClutch" and "<arm>-Dallas").  Button interfaces are also
+  provided for all the other buttons found in the recording (e.g.
+  foot pedals).  Recorded signals used, prefixed by the PID component
+  name "<arm>-PID/Controller/" or IO component name and interface
+  "io/<interface>/":
+  - measured_js (required) and setpoint_js
+  - GetActuatorAmpStatus and GetBrakeAmpStatus, all powered if not recorded
+  - GetAnalogInputPosSI for MTM grippers
+  - GetButton, events are sent when the recorded value changes
+
+  The arms and tele-operation components must be connected to
+  "ExecOut" so they run in this component's thread, once per step.
+  Each step advances the replay time by the step size, sample times
+  are used as timestamps for all the data provided.  Steps are run as
+  fast as possible unless a rate is set (1 for real time).  Commands
+  from the arms are processed at the beginning of the next step so
+  servo_jp sent by an arm is compared to the recorded setpoint_js at
+  the next step, the same latency as with the PID component.
+
+  Arms and tele-operation components should use the replay clock (see
+  VirtualClock), otherwise they use the wall clock for timeouts in
+  their state machines (e.g. power and homing) and replays should
+  start with arms enabled, or use a rate of 1 until the arms are
+  ready. */
+class CISST_EXPORT mtsIntuitiveResearchKitReplay: public mtsTaskContinuous
+{
+    CMN_DECLARE_SERVICES(CMN_NO_DYNAMIC_CREATION, CMN_LOG_ALLOW_DEFAULT);
+
+public:
+    mtsIntuitiveResearchKitReplay(const std::string & componentName);
+    ~mtsIntuitiveResearchKitReplay();
+
+    /*! Open the recording, ioComponentName is the name of the IO
+      component used when recording.  Must be called before adding
+      arms. */
+    bool Load(const std::string & fileName,
+              const std::string & ioComponentName = "io");
+
+    /*! Add an arm, must be called before the component is added to
+      the component manager.  The tool type is sent to the PSM when
+      the tool Dallas chip is read, leave empty for arms with fixed
+      tool detection.  Returns false if the arm already exists or
+      measured_js can't be found in the recording. */
+    bool AddArm(const std::string & name, const std::string & toolType = "");
+
+    /*! Time between steps, in seconds */
+    void SetStep(const double step);
+
+    /*! Ratio to real time, 0 to run as fast as possible */
+    void SetRate(const double rate);
+
+    /*! Setpoints are considered different if an error is greater
+      than the tolerance */
+    void SetTolerance(const double tolerance);
+
+    /*! Replay time, valid once the component is started */
+    inline const mtsIntuitiveResearchKitVirtualClock & VirtualClock(void) const {
+        return mClock;
+    }
+
+    void Startup(void);
+    void Run(void);
+    void Cleanup(void);
+
+protected:
+    /*! Map recorded scalars of prmStateJoint, i.e. all scalars but
+      timestamps (see mtsIntuitiveResearchKitRecorder::RecordedScalars),
+      back to positions, velocities and efforts. */
+    class StateJointLayout {
+    public:
+        bool Configure(const size_t numberOfScalars);
+        void Fill(const double * values, prmStateJoint & state) const;
+        inline size_t NumberOfJoints(void) const {
+            return mNumberOfJoints;
+        }
+    protected:
+        size_t mNumberOfJoints = 0;
+        std::vector<int> mTargets; // -1 for ignored scalars
+    };
+
+    class Button {
+    public:
+        void AddInterface(mtsIntuitiveResearchKitReplay * replay, const std::string & name);
+        void Update(const double time);
+        void GetButton(bool & pressed) const;
+
+        std::string mName;
+        mtsIntuitiveResearchKitReplayTrack mTrack;
+        bool mPressed = false;
+        mtsFunctionWrite mEvent;
+    };
+
+    class Arm {
+    public:
+        Arm(mtsIntuitiveResearchKitReplay * replay, const std::string & name);
+        bool Open(const mtsIntuitiveResearchKitRecordReader & reader, const std::string & ioPrefix);
+        void AddInterfaces(void);
+        void Update(const double time);
+        void Compare(void);
+        std::string Summary(void) const;
+
+        // PID
+        void measured_js(prmStateJoint & state) const;
+        void setpoint_js(prmStateJoint & state) const;
+        void configuration_js(prmConfigurationJoint & configuration) const;
+        void configure_js(const prmConfigurationJoint & configuration);
+        void Enabled(bool & enabled) const;
+        void Enable(const bool & enable);
+        void EnableJoints(const vctBoolVec & enable);
+        void SetCoupling(const prmActuatorJointCoupling & coupling);
+        void servo_jp(const prmPositionJointSet & position);
+
+        // IO
+        void GetSerialNumber(std::string & serial) const;
+        void GetActuatorAmpStatus(vctBoolVec & status) const;
+        void GetBrakeAmpStatus(vctBoolVec & status) const;
+        void BiasEncoder(const int & nbSamples);
+        void GetAnalogInputPosSI(prmStateJoint & state) const;
+        void TriggerRead(void);
+
+        // commands without effect on replay
+        template <typename _type>
+        void Ignore(const _type &) {}
+        void IgnoreVoid(void) {}
+
+        mtsIntuitiveResearchKitReplay * mReplay;
+        std::string mName;
+        std::string mToolType;
+        mtsIntuitiveResearchKitReplayTrack mMeasured, mSetpoint, mGripper;
+        mtsIntuitiveResearchKitReplayTrack mActuatorAmpStatus, mBrakeAmpStatus;
+        StateJointLayout mMeasuredLayout, mSetpointLayout, mGripperLayout;
+        prmStateJoint m_measured_js, m_setpoint_js, m_gripper_measured_js;
+        prmConfigurationJoint m_configuration_js;
+        vctBoolVec m_actuator_amp_status, m_brake_amp_status;
+        bool mEnabled = false;
+        prmPositionJointSet m_servo_jp;
+        bool mServoNew = false;
+        mtsIntuitiveResearchKitReplayComparison mComparison;
+        vctDoubleVec m_comparison; // samples, mismatches, maximum and RMS error
+
+        mtsFunctionWrite mCouplingEvent;
+        mtsFunctionWrite mEnabledJointsEvent;
+        mtsFunctionWrite mPositionLimitEvent;
+        mtsFunctionWrite mBiasEncoderEvent;
+        mtsFunctionWrite mToolTypeEvent;
+    };
+
+    Button * AddButton(const std::string & name);
+
+    mtsIntuitiveResearchKitRecordReader mReader;
+    std::string mIOComponentName;
+    std::map<std::string, Arm *> mArms;
+    std::map<std::string, Button *> mButtons;
+    double mStep;
+    double mRate;
+    double mTolerance;
+    double mStartTime, mEndTime;
+    double mWallStartTime;
+    mtsIntuitiveResearchKitVirtualClock mClock;
+    double m_time; // copy of clock time for state table
+    unsigned int mNumberOfSteps;
+    bool mFinished;
+
+    mtsInterfaceProvided * mInterface;
+};
+
+CMN_DECLARE_SERVICES_INSTANTIATION(mtsIntuitiveResearchKitReplay)
+
+#endif // _mtsIntuitiveResearchKitReplay_h
@@ -0,0 +1,133 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-12
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitReplayTrack_h
+#define _mtsIntuitiveResearchKitReplayTrack_h
+
+#include <string>
+#include <vector>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordReader.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Sequential access to one recorded signal, used by
+  mtsIntuitiveResearchKitReplay.  Samples are decoded by windows so
+  long recordings don't have to fit in memory.  Seek returns the last
+  sample recorded at or before the requested time (zero-order hold),
+  times are expected to increase between calls.  Like
+  mtsIntuitiveResearchKitRecordReader, this class only depends on the
+  C++ standard library. */
+class CISST_EXPORT mtsIntuitiveResearchKitReplayTrack
+{
+public:
+    mtsIntuitiveResearchKitReplayTrack(void);
+
+    /*! Returns false if the signal doesn't exist or has no sample.
+      The reader must remain open while the track is used.  Window is
+      the duration decoded at once, in seconds. */
+    bool Open(const mtsIntuitiveResearchKitRecordReader & reader, const std::string & name,
+              const double window = 1.0);
+
+    inline bool IsOpen(void) const {
+        return (mReader != nullptr);
+    }
+
+    inline size_t NumberOfScalars(void) const {
+        return mCurrent.size();
+    }
+
+    inline double StartTime(void) const {
+        return mStartTime;
+    }
+
+    inline double EndTime(void) const {
+        return mEndTime;
+    }
+
+    /*! Values of the last sample at or before time, nullptr if the
+      time is before the first sample or the file is corrupted. */
+    const double * Seek(const double time);
+
+    /*! Time of the sample returned by the last call to Seek */
+    inline double Time(void) const {
+        return mCurrentTime;
+    }
+
+    inline const std::string & LastError(void) const {
+        return mLastError;
+    }
+
+protected:
+    bool Load(const double time);
+
+    const mtsIntuitiveResearchKitRecordReader * mReader;
+    size_t mSignal;
+    double mWindow;
+    double mStartTime, mEndTime;
+    double mLoadedUntil; // end of last window read, included
+    bool mLoaded;
+    std::vector<double> mTimes, mValues;
+    size_t mNext; // next sample in window
+    std::vector<double> mCurrent;
+    double mCurrentTime;
+    bool mValid;
+    std::string mLastError;
+};
+
+/*! Error statistics between recorded and produced vectors, used to
+  compare setpoints computed during replay with the recording. */
+class CISST_EXPORT mtsIntuitiveResearchKitReplayComparison
+{
+public:
+    mtsIntuitiveResearchKitReplayComparison(void);
+
+    /*! Clear statistics, samples with at least one error greater than
+      the tolerance are counted as mismatches */
+    void Reset(const double tolerance);
+
+    /*! Compare the first size elements, returns false for a
+      mismatch */
+    bool Add(const double * expected, const double * produced, const size_t size);
+
+    inline size_t NumberOfSamples(void) const {
+        return mNumberOfSamples;
+    }
+
+    inline size_t NumberOfMismatches(void) const {
+        return mNumberOfMismatches;
+    }
+
+    inline double MaximumError(void) const {
+        return mMaximumError;
+    }
+
+    double RMSError(void) const;
+
+protected:
+    double mTolerance;
+    size_t mNumberOfSamples;
+    size_t mNumberOfMismatches;
+    size_t mNumberOfValues;
+    double mMaximumError;
+    double mSumSquares;
+};
+
+#endif // _mtsIntuitiveResearchKitReplayTrack_h
@@ -25,6 +25,7 @@ http://www.cisst.org/cisst/license.txt.
 #include <cisstParameterTypes/prmOperatingState.h>
 #include <sawIntuitiveResearchKit/mtsStateMachine.h>
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArmTypes.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitVirtualClock.h>
 
 #include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
 
@@ -50,6 +51,12 @@ public:
 
     void set_simulated(void);
 
+    /*! Use a virtual clock for timers instead of the state table tic,
+      see mtsIntuitiveResearchKitArm::set_virtual_clock. */
+    inline void set_virtual_clock(const mtsIntuitiveResearchKitVirtualClock * clock) {
+        m_virtual_clock = clock;
+    }
+
 protected:
 
     void Init(void);
@@ -171,6 +178,12 @@ protected:
     bool m_simulated;
     double mSimulatedTimer;
 
+    // optional virtual clock, state table tic is used otherwise
+    const mtsIntuitiveResearchKitVirtualClock * m_virtual_clock = nullptr;
+    inline double Now(void) const {
+        return m_virtual_clock ? m_virtual_clock->Time() : StateTable.GetTic();
+    }
+
     void DispatchError(const std::string & message);
     void DispatchWarning(const std::string & message);
     void DispatchStatus(const std::string & message);
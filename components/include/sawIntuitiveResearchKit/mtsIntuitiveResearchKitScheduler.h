@@ -0,0 +1,87 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-14
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitScheduler_h
+#define _mtsIntuitiveResearchKitScheduler_h
+
+#include <cisstMultiTask/mtsTaskContinuous.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitVirtualClock.h>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Step simulated components on a virtual time base.
+
+  Components connected to "ExecOut" run in this component's thread,
+  in the order they were connected, once per step.  Components using
+  the virtual clock (see set_virtual_clock on arms, SUJ and
+  tele-operation components) use the clock time for their state
+  machines and timestamps and the step as control period, so a
+  simulated session is reproducible and can run faster than real
+  time.
+
+  Steps are run as fast as possible unless a rate is set (1 for real
+  time).  The scheduler can be paused, commands sent to the stepped
+  components while paused are processed at the next step.  RunFor
+  runs a given virtual duration then pauses, the "Paused" event is
+  sent when the scheduler is paused or resumed. */
+class CISST_EXPORT mtsIntuitiveResearchKitScheduler: public mtsTaskContinuous
+{
+    CMN_DECLARE_SERVICES(CMN_NO_DYNAMIC_CREATION, CMN_LOG_ALLOW_DEFAULT);
+
+public:
+    mtsIntuitiveResearchKitScheduler(const std::string & componentName,
+                                     const double step);
+    inline ~mtsIntuitiveResearchKitScheduler() {}
+
+    /*! Clock used by the stepped components, time starts at 0 */
+    inline const mtsIntuitiveResearchKitVirtualClock & VirtualClock(void) const {
+        return mClock;
+    }
+
+    /*! Ratio to real time, 0 to run as fast as possible */
+    void SetRate(const double & rate);
+
+    /*! Paused schedulers don't step until resumed, see also RunFor */
+    void SetPaused(const bool paused);
+
+    void Startup(void);
+    void Run(void);
+    void Cleanup(void);
+
+protected:
+    void Pause(void);
+    void Resume(void);
+    void RunFor(const double & duration);
+    void ResetRateReference(void);
+
+    mtsIntuitiveResearchKitVirtualClock mClock;
+    double mRate;
+    bool mPaused;
+    size_t mStepsRemaining; // 0 to run until paused
+    double mWallReference, mTimeReference; // to maintain rate
+    double m_time; // copy of clock time for state table
+
+    mtsInterfaceProvided * mInterface;
+    mtsFunctionWrite mPausedEvent;
+};
+
+CMN_DECLARE_SERVICES_INSTANTIATION(mtsIntuitiveResearchKitScheduler)
+
+#endif // _mtsIntuitiveResearchKitScheduler_h
@@ -0,0 +1,223 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-15
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitStandIn_h
+#define _mtsIntuitiveResearchKitStandIn_h
+
+#include <map>
+#include <vector>
+
+#include <json/json.h>
+
+#include <cisstMultiTask/mtsTaskPeriodic.h>
+#include <cisstParameterTypes/prmActuatorJointCoupling.h>
+#include <cisstParameterTypes/prmConfigurationJoint.h>
+#include <cisstParameterTypes/prmEventButton.h>
+#include <cisstParameterTypes/prmForceTorqueJointSet.h>
+#include <cisstParameterTypes/prmMaskedVector.h>
+#include <cisstParameterTypes/prmPositionJointSet.h>
+#include <cisstParameterTypes/prmStateJoint.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitActuatorModel.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitDynamicModel.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitVirtualClock.h>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Stand-in for the IO and PID components of arms with simulation
+  "DYNAMIC".
+
+  For each arm added, this component provides the same interfaces as
+  sawControllersPID ("<arm>-Controller") and sawRobotIO1394 ("<arm>",
+  "<arm>-Gripper", "<arm>-Adapter", "<arm>-Tool", "<arm>-ManipClutch",
+  "<arm>-SUJClutch" and "<arm>-Dallas") so the arms run their
+  hardware state machines (power, encoder bias, homing, coupling
+  changes, tool engagement) and all their control modes, including
+  effort modes.
+
+  Each arm is simulated by a mtsIntuitiveResearchKitDynamicModel
+  built from the DH and inertial parameters of its kinematic file.
+  The model is in actuator space: links from the kinematic file are
+  driven directly by their actuators and PID joints not in the
+  kinematic file (e.g. PSM instrument) are added as massless
+  actuators.  As with the real IO, encoders read the actuator
+  positions plus an offset and the coupling set by the arm maps
+  actuator positions to joint positions and joint efforts to
+  actuator efforts.  Actuator efforts go through a
+  mtsIntuitiveResearchKitActuatorModel (latency, first order
+  response and saturation).  The PID law and gains are read from the
+  same sawControllersPID configuration file as the real PID,
+  position limits are used as mechanical stops.
+
+  Parameters are set using the arm "dynamics" section in the console
+  configuration file.  For actuators, a single value for all or an
+  array:
+  - "armature", by default the armature critically damping the PID
+    position loop, Kd^2 / (4 Kp)
+  - "viscous", "coulomb" and "backlash", default to 0
+  - "position", initial position, default to 0
+  - "time-constant", first order response of actuator efforts,
+    default to 0
+  - "effort-max", actuator effort saturation, no limit by default
+  And for the arm:
+  - "gravity", acceleration in arm base frame, default is (0, 0, -9.81)
+  - "tool", tool type sent when the Dallas chip is read
+  - "latency", delay between PID efforts and actuators, in seconds
+  - "time-to-power", delay before amplifiers report power
+  - "encoders-preloaded", if false (default) encoders read 0 at
+    start up and are biased from the simulated potentiometers when
+    requested, so the MTM has to find its roll limit.  Otherwise
+    the arms are told the encoders are already biased.
+
+  The PSM adapter and tool are always present.  When a virtual clock
+  is set, the component should be stepped before the arms (see
+  mtsIntuitiveResearchKitScheduler), the clock time is used for
+  timestamps and the clock step to integrate.  Otherwise the
+  component's period is used. */
+class CISST_EXPORT mtsIntuitiveResearchKitStandIn: public mtsTaskPeriodic
+{
+    CMN_DECLARE_SERVICES(CMN_NO_DYNAMIC_CREATION, CMN_LOG_ALLOW_DEFAULT);
+
+public:
+    mtsIntuitiveResearchKitStandIn(const std::string & componentName,
+                                   const double periodInSeconds);
+    ~mtsIntuitiveResearchKitStandIn();
+
+    /*! Add an arm, must be called before the component is added to
+      the component manager.  The arm configuration file is used to
+      find the kinematic file.  Returns false if the arm already
+      exists or any file or parameter can't be used. */
+    bool AddArm(const std::string & name,
+                const std::string & armConfigurationFile,
+                const std::string & pidConfigurationFile,
+                const Json::Value & jsonDynamics);
+
+    inline void set_virtual_clock(const mtsIntuitiveResearchKitVirtualClock * clock) {
+        m_virtual_clock = clock;
+    }
+
+    void Startup(void);
+    void Run(void);
+    void Cleanup(void);
+
+protected:
+    class Button {
+    public:
+        void AddInterface(mtsIntuitiveResearchKitStandIn * standIn,
+                          const std::string & name, const bool pressed);
+        void GetButton(bool & pressed) const;
+
+        bool mPressed = false;
+        mtsFunctionWrite mEvent;
+    };
+
+    class Arm {
+    public:
+        Arm(mtsIntuitiveResearchKitStandIn * standIn, const std::string & name);
+        bool ConfigureModel(const std::string & armConfigurationFile);
+        bool ConfigurePID(const std::string & pidConfigurationFile);
+        bool ConfigureDynamics(const Json::Value & jsonDynamics);
+        void AddInterfaces(void);
+        void Run(const double time, const double dt);
+
+        // PID
+        void configure_js(const prmConfigurationJoint & configuration);
+        void Enable(const bool & enable);
+        void EnableJoints(const vctBoolVec & enable);
+        void SetCoupling(const prmActuatorJointCoupling & coupling);
+        void servo_jp(const prmPositionJointSet & position);
+        void servo_jf(const prmForceTorqueJointSet & effort);
+        void feed_forward_jf(const prmForceTorqueJointSet & effort);
+        void SetCheckPositionLimit(const bool & check);
+        void EnableTorqueMode(const vctBoolVec & torqueMode);
+        void EnableTrackingError(const bool & enable);
+        void SetTrackingErrorTolerances(const vctDoubleVec & tolerances);
+
+        // IO
+        void GetSerialNumber(std::string & serial) const;
+        void PowerOnSequence(void);
+        void PowerOffSequence(const bool & openSafetyRelays);
+        void BiasEncoder(const int & nbSamples);
+        void SetEncoderPosition(const vctDoubleVec & positions);
+        void SetSomeEncoderPosition(const prmMaskedDoubleVec & positions);
+        void BrakeRelease(void);
+        void BrakeEngage(void);
+        void TriggerRead(void);
+
+        // commands without effect on simulation
+        template <typename _type>
+        void Ignore(const _type &) {}
+
+        mtsIntuitiveResearchKitStandIn * mStandIn;
+        std::string mName;
+        std::string mToolType;
+        mtsIntuitiveResearchKitDynamicModel mModel;
+        mtsIntuitiveResearchKitActuatorModel mActuators;
+        size_t mNumberOfJoints = 0;
+        std::vector<mtsIntuitiveResearchKitDynamicModel::Link> mLinks; // from kinematic file
+        std::vector<bool> mPrismatic;
+
+        // IO, encoders and coupling
+        vctDoubleMat mActuatorToJointPosition, mJointToActuatorEffort, mActuatorToJointEffort;
+        vctDoubleVec mEncoderOffsets;
+        vctDoubleVec mActuatorPosition, mActuatorVelocity, mActuatorRequest, mActuatorEffort;
+        vctDoubleVec mJointPosition, mJointVelocity;
+        bool mEncodersPreloaded = false;
+        bool mEncodersBiased = false;
+        bool mPowering = false;
+        double mTimeToPower = 0.0;
+        double mPowerTime = 0.0;
+
+        // PID gains and state
+        vctDoubleVec mPGain, mDGain, mIGain, mOffset, mForget, mMinIError, mMaxIError;
+        vctDoubleVec mIError;
+        vctDoubleVec mGoal, mServoEffort, mFeedForward, mEffort;
+        vctBoolVec mEnabledJoints, mTorqueMode;
+        bool mCheckPositionLimit = true;
+        vctBoolVec mPositionLimitFlags;
+        bool mTrackingErrorEnabled = false;
+        vctDoubleVec mTrackingErrorTolerances;
+
+        // state table data
+        bool mEnabled = false;
+        prmStateJoint m_measured_js, m_setpoint_js, m_gripper_measured_js;
+        prmConfigurationJoint m_configuration_js;
+        vctBoolVec m_actuator_amp_status, m_brake_amp_status;
+
+        mtsInterfaceProvided * mPIDInterface = nullptr;
+        mtsFunctionWrite mCouplingEvent;
+        mtsFunctionWrite mEnabledJointsEvent;
+        mtsFunctionWrite mPositionLimitEvent;
+        mtsFunctionWrite mBiasEncoderEvent;
+        mtsFunctionWrite mToolTypeEvent;
+        Button mAdapter, mTool, mManipClutch, mSUJClutch;
+    };
+
+    /*! Virtual clock time if set, state table time otherwise */
+    inline double Now(void) const {
+        return m_virtual_clock ? m_virtual_clock->Time() : StateTable.GetTic();
+    }
+
+    std::map<std::string, Arm *> mArms;
+    const mtsIntuitiveResearchKitVirtualClock * m_virtual_clock = nullptr;
+};
+
+CMN_DECLARE_SERVICES_INSTANTIATION(mtsIntuitiveResearchKitStandIn)
+
+#endif // _mtsIntuitiveResearchKitStandIn_h
@@ -0,0 +1,169 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-01
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsIntuitiveResearchKitStreamFormat_h
+#define _mtsIntuitiveResearchKitStreamFormat_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <cisstVector/vctMatrixRotation3.h>
+#include <cisstParameterTypes/prmStateJoint.h>
+#include <cisstParameterTypes/prmPositionCartesianGet.h>
+#include <cisstParameterTypes/prmVelocityCartesianGet.h>
+#include <cisstParameterTypes/prmForceCartesianGet.h>
+#include <cisstParameterTypes/prmOperatingState.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Binary format used by mtsIntuitiveResearchKitUDPStreamer.
+
+  Each datagram contains a header followed by one or more samples, all
+  little-endian.  Fields present in each sample are defined by a bit
+  mask in the header and are always encoded in the order of FieldType,
+  regardless of the order used in the configuration file.
+
+  - header (32 bytes)
+    - 0: uint32 magic number, "dVRS"
+    - 4: uint16 format version
+    - 6: uint16 number of samples
+    - 8: uint32 datagram sequence number, per destination
+    - 12: uint32 field mask, bit n is set if FieldType n is present
+    - 16: float64 time datagram was sent
+    - 24: uint32 decimation, number of arm cycles between samples
+    - 28: uint32 reserved
+  - sample header (16 bytes)
+    - 0: uint16 sample size, including sample header
+    - 2: uint16 valid flags, bit n is set if FieldType n is valid
+    - 4: uint32 sample index, incremented every arm cycle
+    - 8: float64 sample timestamp
+  - fields, in FieldType order
+    - joint states: uint16 number of positions, velocities and efforts,
+      uint16 reserved then positions, velocities and efforts as float64
+    - cartesian positions: translation then quaternion w, x, y, z (7
+      float64)
+    - cartesian velocities: linear then angular (6 float64)
+    - cartesian forces: force then torque (6 float64)
+    - operating state: uint32 state, uint32 flags (bit 0 is homed,
+      bit 1 is busy)
+    - buttons: uint32, bit 0 is clutch, bit 1 is coag
+    - tele-operation state: uint32 flags (bit 0 is following, bit 1
+      is clutched, bit 2 is operator present), uint32 reserved,
+      float64 scale then alignment offset as quaternion w, x, y, z (4
+      float64)
+
+  Version 2 added the tele-operation state, version 1 datagrams are
+  still decoded.  The sample index lets receivers detect samples lost on the network
+  since the streamer never skips nor duplicates arm cycles. */
+class CISST_EXPORT mtsIntuitiveResearchKitStreamFormat
+{
+public:
+    typedef enum {MEASURED_JS = 0,
+                  SETPOINT_JS,
+                  MEASURED_CP,
+                  SETPOINT_CP,
+                  MEASURED_CV,
+                  BODY_MEASURED_CF,
+                  SPATIAL_MEASURED_CF,
+                  GRIPPER_MEASURED_JS,
+                  OPERATING_STATE,
+                  BUTTONS,
+                  TELEOP_STATE,
+                  NUMBER_OF_FIELDS} FieldType;
+
+    static const uint32_t Magic = 0x53525664; // "dVRS" in little-endian
+    static const uint16_t Version = 2;
+    static const size_t HeaderSize = 32;
+    static const size_t SampleHeaderSize = 16;
+    static const uint32_t ButtonClutch = 0x1;
+    static const uint32_t ButtonCoag = 0x2;
+    static const uint32_t TeleopFollowing = 0x1;
+    static const uint32_t TeleopClutched = 0x2;
+    static const uint32_t TeleopOperatorPresent = 0x4;
+
+    struct Header {
+        uint16_t NumberOfSamples = 0;
+        uint32_t Sequence = 0;
+        uint32_t FieldMask = 0;
+        double Timestamp = 0.0;
+        uint32_t Decimation = 1;
+    };
+
+    /*! Tele-operation state, read from the teleop component using the
+      read commands "following", "clutched", "operator_present",
+      "scale" and "alignment_offset" */
+    struct TeleopState {
+        bool Valid = false;
+        bool following = false;
+        bool clutched = false;
+        bool operator_present = false;
+        double scale = 0.0;
+        vctMatRot3 alignment_offset;
+    };
+
+    /*! All fields that can be streamed, only fields in the mask are
+      encoded. */
+    struct Sample {
+        uint32_t Index = 0;
+        double Timestamp = 0.0;
+        prmStateJoint measured_js;
+        prmStateJoint setpoint_js;
+        prmPositionCartesianGet measured_cp;
+        prmPositionCartesianGet setpoint_cp;
+        prmVelocityCartesianGet measured_cv;
+        prmForceCartesianGet body_measured_cf;
+        prmForceCartesianGet spatial_measured_cf;
+        prmStateJoint gripper_measured_js;
+        prmOperatingState operating_state;
+        uint32_t buttons = 0;
+        TeleopState teleop_state;
+    };
+
+    /*! Field name is the name of the read command used to get the
+      field from the arm, i.e. "measured_js", "body/measured_cf"...
+      except for "buttons" and "teleop_state". */
+    static std::string FieldToString(const FieldType field);
+    /*! Returns false if the string is not a known field */
+    static bool FieldFromString(const std::string & name, FieldType & field);
+
+    /*! Maximum size of a sample, assuming joint states have at most
+      numberOfJoints */
+    static size_t MaximumSampleSize(const uint32_t fieldMask, const size_t numberOfJoints);
+
+    /*! Encode header at beginning of buffer.  Returns number of bytes
+      used or 0 if the buffer is too small. */
+    static size_t EncodeHeader(const Header & header, char * buffer, const size_t bufferSize);
+
+    /*! Returns false if the buffer doesn't start with a valid header */
+    static bool DecodeHeader(const char * buffer, const size_t size, Header & header);
+
+    /*! Encode fields in mask.  Returns number of bytes used or 0 if
+      the buffer is too small. */
+    static size_t EncodeSample(const Sample & sample, const uint32_t fieldMask,
+                               char * buffer, const size_t bufferSize);
+
+    /*! Decode sample, returns number of bytes used or 0 if the buffer
+      doesn't contain a valid sample.  Joint state vectors are
+      resized as needed. */
+    static size_t DecodeSample(const char * buffer, const size_t size,
+                               const uint32_t fieldMask, Sample & sample);
+};
+
+#endif // _mtsIntuitiveResearchKitStreamFormat_h
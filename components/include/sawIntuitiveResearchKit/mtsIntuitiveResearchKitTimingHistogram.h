@@ -0,0 +1,94 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-19
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitTimingHistogram_h
+#define _mtsIntuitiveResearchKitTimingHistogram_h
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Distribution of durations (periods, execution times) with a fixed
+  resolution, used to compute percentiles over long runs without
+  storing every sample.
+
+  Bins are allocated by Configure, Add doesn't allocate memory so it
+  can be called from real time threads.  Values above the range are
+  counted as overflows, percentiles falling in the overflows are
+  reported as the maximum.  Percentiles are the upper edge of the bin
+  they fall in, i.e. they are conservative by at most the resolution.
+
+  Only depends on the C++ standard library. */
+class CISST_EXPORT mtsIntuitiveResearchKitTimingHistogram
+{
+public:
+    mtsIntuitiveResearchKitTimingHistogram(void);
+
+    /*! Set bin width and upper bound of the bins, in seconds.  Resets
+      the distribution. */
+    void Configure(const double resolution, const double range);
+
+    inline double Resolution(void) const {
+        return mResolution;
+    }
+
+    inline double Range(void) const {
+        return mResolution * mBins.size();
+    }
+
+    void Reset(void);
+
+    void Add(const double value);
+
+    inline size_t Count(void) const {
+        return mCount;
+    }
+
+    /*! Number of samples above the range */
+    inline size_t Overflows(void) const {
+        return mOverflows;
+    }
+
+    /*! Exact minimum, maximum and mean, 0 if there are no samples */
+    double Minimum(void) const;
+    double Maximum(void) const;
+    double Mean(void) const;
+
+    /*! Value below which percent (0 to 100) of the samples fall, 0 if
+      there are no samples */
+    double Percentile(const double percent) const;
+
+    /*! Statistic by name, "min", "mean", "max" or "p" followed by a
+      percentile (e.g. "p50", "p99.9").  Returns false if the name is
+      not valid. */
+    bool Statistic(const std::string & name, double & value) const;
+
+protected:
+    double mResolution;
+    std::vector<size_t> mBins;
+    size_t mCount;
+    size_t mOverflows;
+    double mMinimum;
+    double mMaximum;
+    double mSum;
+};
+
+#endif // _mtsIntuitiveResearchKitTimingHistogram_h
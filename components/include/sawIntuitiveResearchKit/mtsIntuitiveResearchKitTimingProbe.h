@@ -0,0 +1,104 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-19
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitTimingProbe_h
+#define _mtsIntuitiveResearchKitTimingProbe_h
+
+#include <atomic>
+#include <list>
+#include <ostream>
+
+#include <cisstMultiTask/mtsTaskPeriodic.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitTimingHistogram.h>
+
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Period and execution time distributions of a task, sampled every
+  cycle.
+
+  The "ExecIn" interface must be connected to the "ExecOut" interface
+  of the source so the probe runs in the source thread, at the end of
+  each cycle (see mtsIntuitiveResearchKitRecorder).  The period is the
+  time between the beginnings of two consecutive cycles and the
+  execution time is the time between the beginning of the cycle and
+  the probe, both based on the source state table Tic.
+
+  Samples are only added while recording.  The histograms should only
+  be read when not recording, i.e. a few source periods after
+  SetRecording(false) or once the components are stopped. */
+class CISST_EXPORT mtsIntuitiveResearchKitTimingProbe : public mtsTaskPeriodic
+{
+    CMN_DECLARE_SERVICES(CMN_NO_DYNAMIC_CREATION, CMN_LOG_ALLOW_DEFAULT);
+
+ protected:
+    mtsTask * mSource;
+    std::atomic<bool> mRecording;
+    double mLastTic;
+    mtsIntuitiveResearchKitTimingHistogram mPeriods;
+    mtsIntuitiveResearchKitTimingHistogram mExecutionTimes;
+
+ public:
+    /*! Constructor
+        \param name Name of the component
+        \param source Task measured, provides ExecOut
+        \param resolution Width of histogram bins in seconds
+        \param range Upper bound of histogram bins in seconds
+    */
+    mtsIntuitiveResearchKitTimingProbe(const std::string & name, mtsTask * source,
+                                       const double resolution, const double range);
+
+    ~mtsIntuitiveResearchKitTimingProbe() {}
+
+    void Startup(void);
+
+    void Run(void);
+
+    void Cleanup(void);
+
+    /*! Start or stop recording, starting resets the histograms */
+    void SetRecording(const bool recording);
+
+    inline const mtsTask * Source(void) const {
+        return mSource;
+    }
+
+    inline const mtsIntuitiveResearchKitTimingHistogram & Periods(void) const {
+        return mPeriods;
+    }
+
+    inline const mtsIntuitiveResearchKitTimingHistogram & ExecutionTimes(void) const {
+        return mExecutionTimes;
+    }
+
+    /*! Create, add and connect a probe for each dVRK task already
+      added to the component manager, i.e. arms, SUJ, tele-operation,
+      stand-in and IO.  Probes are named after the task with the
+      suffix "-Probe". */
+    static std::list<mtsIntuitiveResearchKitTimingProbe *> AddProbes(const double resolution,
+                                                                      const double range);
+
+    /*! Period and execution time percentiles (50, 99, 99.9 and max)
+      in micro seconds, one line per probe */
+    static void PrintReport(std::ostream & output,
+                            const std::list<mtsIntuitiveResearchKitTimingProbe *> & probes);
+};
+
+CMN_DECLARE_SERVICES_INSTANTIATION(mtsIntuitiveResearchKitTimingProbe)
+
+#endif // _mtsIntuitiveResearchKitTimingProbe_h
@@ -3,10 +3,10 @@
 
 /*
 
-  Author(s):  Peter Kazanzides
+  Author(s):  Peter Kazanzides, Anton Deguet
   Created on: 2013-12-02
 
-  (C) Copyright 2013-2014 Johns Hopkins University (JHU), All Rights Reserved.
+  (C) Copyright 2013-2021 Johns Hopkins University (JHU), All Rights Reserved.
 
 --- begin cisst license - do not edit ---
 
@@ -21,48 +21,126 @@ http://www.cisst.org/cisst/license.txt.
 #ifndef _mtsIntuitiveResearchKitUDPStreamer_h
 #define _mtsIntuitiveResearchKitUDPStreamer_h
 
+#include <vector>
+
 #include <cisstOSAbstraction/osaSocket.h>
 #include <cisstMultiTask/mtsTaskPeriodic.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitStreamFormat.h>
+#include <sawIntuitiveResearchKit/mtsSharedMemoryRing.h>
 
 #include <cisstMultiTask/mtsForwardDeclarations.h>
 class prmEventButton;
 
 #include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
 
+/*! Stream arm data over UDP using the binary format defined in
+  mtsIntuitiveResearchKitStreamFormat.
+
+  The fields streamed are read from the required interface "Arm"
+  using the read command with the same name (e.g. "measured_js",
+  "measured_cp", "body/measured_cf", "operating_state").  Buttons are
+  provided by the event handlers on the "Clutch" and "Coag" required
+  interfaces.  Each destination can use its own decimation (send one
+  arm cycle out of N) and batch (number of samples per datagram).
+
+  The same required interface can be connected to a tele-operation
+  component's "Setting" interface to stream the field
+  "teleop_state", built from the read commands "following",
+  "clutched", "operator_present", "scale" and "alignment_offset".
+
+  Destinations can also be POSIX shared memory rings (see
+  mtsSharedMemoryRing), each slot contains a datagram.  Any number of
+  local processes can read the ring without any cost for the arm's
+  thread.
+
+  To get exactly one sample per arm cycle, the "ExecIn" interface of
+  the streamer should be connected to the "ExecOut" interface of the
+  arm so the streamer runs in the arm's thread right after the arm's
+  Run method.  The period is only used if ExecIn is not connected, in
+  which case samples with the same timestamp are not sent again. */
 class CISST_EXPORT mtsIntuitiveResearchKitUDPStreamer : public mtsTaskPeriodic
 {
     CMN_DECLARE_SERVICES(CMN_NO_DYNAMIC_CREATION, CMN_LOG_ALLOW_DEFAULT);
 
  protected:
-
-    osaSocket Socket;
-    bool SocketConfigured;
-
-    mtsFunctionRead measured_cp;
-    mtsFunctionRead GetGripperPosition;
-    bool Clutch;
-    bool Coag;
-
-    void SetDestination(const std::string &ipPort);
-    void EventHandlerManipClutch(const prmEventButton &button);
-    void EventHandlerCoag(const prmEventButton &button);
+    typedef mtsIntuitiveResearchKitStreamFormat StreamFormat;
+
+    struct Destination {
+        Destination(void): Socket(osaSocket::UDP), Ring(nullptr) {}
+        ~Destination() {
+            delete Ring;
+        }
+        osaSocket Socket;
+        mtsSharedMemoryRing * Ring; // null for UDP
+        std::string Address;
+        unsigned int Decimation;
+        unsigned int Batch;
+        unsigned int Cycles;
+        StreamFormat::Header Header;
+        std::vector<char> Buffer;
+        size_t Size;
+    };
+
+    std::vector<Destination *> mDestinations;
+
+    uint32_t mFieldMask;
+    mtsFunctionRead mReadFunctions[StreamFormat::NUMBER_OF_FIELDS];
+    struct {
+        mtsFunctionRead following;
+        mtsFunctionRead clutched;
+        mtsFunctionRead operator_present;
+        mtsFunctionRead scale;
+        mtsFunctionRead alignment_offset;
+    } mTeleop;
+    StreamFormat::Sample mSample;
+    std::vector<char> mSampleBuffer;
+    double mLastTimestamp;
+
+    // statistics
+    unsigned int mNumberOfSamples;
+    unsigned int mNumberOfDatagrams;
+    unsigned int mNumberOfDuplicates;
+
+    /*! Add a UDP destination, decimation and batch are 1.  Existing
+      destinations are not modified. */
+    void SetDestination(const std::string & ipPort);
+    bool AddDestination(const std::string & ip, const unsigned short port,
+                        const unsigned int decimation, const unsigned int batch);
+    bool AddSharedMemory(const std::string & name, const unsigned int numberOfSlots,
+                         const unsigned int decimation, const unsigned int batch);
+    Destination * NewDestination(const unsigned int decimation, const unsigned int batch);
+    void Send(Destination & destination);
+    /*! Send pending samples, even if the batch is not complete */
+    void Flush(Destination & destination);
+    void ReadTeleopState(StreamFormat::TeleopState & state);
+    void EventHandlerManipClutch(const prmEventButton & button);
+    void EventHandlerCoag(const prmEventButton & button);
 
  public:
     /*! Constructor
         \param name Name of the component
-        \param period Period in seconds
+        \param period Period in seconds, only used if ExecIn is not connected
         \param ip IP address for streaming UDP packets
         \param port Port for streaming UDP packets
     */
-    mtsIntuitiveResearchKitUDPStreamer(const std::string &name, double period, const std::string &ip = "", unsigned short port = 0);
+    mtsIntuitiveResearchKitUDPStreamer(const std::string & name, double period,
+                                       const std::string & ip = "", unsigned short port = 0);
 
     /*! Destructor */
     virtual ~mtsIntuitiveResearchKitUDPStreamer();
 
-    /*! Configure: set IP address and port number
-        \param ipPort IP address and port number, separated by ':'
-    */
-    void Configure(const std::string &ipPort);
+    /*! Configure using a JSON file, see Configure(const Json::Value &). */
+    void Configure(const std::string & filename);
+
+    /*! Configure fields and destinations.  "fields" is an array of
+      field names, default is "buttons", "gripper/measured_js" and
+      "measured_cp".  "destinations" is an array of objects with
+      either "ip" and "port" or "shared-memory" (name of the ring)
+      and "slots" (default is
+      mtsIntuitiveResearchKit::Streamer::NumberOfSlots).  All
+      destinations accept "decimation" (default 1) and "batch"
+      (default 1). */
+    void Configure(const Json::Value & jsonConfig);
 
     void Startup(void);
 
@@ -0,0 +1,86 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-14
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#ifndef _mtsIntuitiveResearchKitVirtualClock_h
+#define _mtsIntuitiveResearchKitVirtualClock_h
+
+#include <cmath>
+#include <cstddef>
+
+/*! Time base for components stepped from a single thread, see
+  mtsIntuitiveResearchKitScheduler and mtsIntuitiveResearchKitReplay.
+  Time is computed from the number of steps, not accumulated, so the
+  same number of steps always leads to the same time.  The owner
+  advances the clock before triggering the stepped components, these
+  only read it from the same thread. */
+class mtsIntuitiveResearchKitVirtualClock
+{
+public:
+    mtsIntuitiveResearchKitVirtualClock(void):
+        mStep(1.0),
+        mOrigin(0.0),
+        mNumberOfSteps(0),
+        mTime(0.0)
+    {}
+
+    /*! Restart with time origin + n * step after n steps */
+    inline void Reset(const double step, const double origin = 0.0) {
+        mStep = step;
+        mOrigin = origin;
+        mNumberOfSteps = 0;
+        mTime = origin;
+    }
+
+    inline void Advance(void) {
+        ++mNumberOfSteps;
+        mTime = mOrigin + static_cast<double>(mNumberOfSteps) * mStep;
+    }
+
+    inline double Time(void) const {
+        return mTime;
+    }
+
+    /*! Time between steps, used as control period by stepped
+      components */
+    inline double Step(void) const {
+        return mStep;
+    }
+
+    inline size_t NumberOfSteps(void) const {
+        return mNumberOfSteps;
+    }
+
+    /*! Number of steps closest to a duration, at least one for any
+      positive duration */
+    inline size_t StepsFor(const double duration) const {
+        if (duration <= 0.0) {
+            return 0;
+        }
+        const double steps = std::floor(duration / mStep + 0.5);
+        return (steps < 1.0) ? 1 : static_cast<size_t>(steps);
+    }
+
+protected:
+    double mStep;
+    double mOrigin;
+    size_t mNumberOfSteps;
+    double mTime;
+};
+
+#endif // _mtsIntuitiveResearchKitVirtualClock_h
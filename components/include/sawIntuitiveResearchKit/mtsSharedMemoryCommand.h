@@ -0,0 +1,102 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-06
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsSharedMemoryCommand_h
+#define _mtsSharedMemoryCommand_h
+
+#include <sawIntuitiveResearchKit/mtsSharedMemoryRing.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Mailbox used by external processes to send servo commands to an
+  arm with the latency of a memory copy.
+
+  The arm creates a shared memory ring named "/dvrk-<arm>-command"
+  (see RingName) when "shared-memory-command" is found in the arm
+  configuration file.  A client process opens the ring for writing
+  and sends one command per control cycle.  Commands are only
+  applied after the arm command "use_shared_memory_command" has been
+  called.  The arm then reads the latest command at each cycle of its
+  control loop and freezes if no new command has been received for the
+  configured timeout, if a command is invalid (wrong number of
+  values, values not finite or null quaternion for servo_cp) or if a
+  servo_cp is received while cartesian control is not possible.  A single error
+  is sent and the client has to call "use_shared_memory_command"
+  again.
+
+  Clients can read the arm state using a streamer with a shared
+  memory destination (see mtsSharedMemoryRing and
+  mtsIntuitiveResearchKitUDPStreamer).
+
+  Commands are native structures since the client and the arm run on
+  the same computer.  Like mtsSharedMemoryRing, this class only
+  depends on the C++ standard library and POSIX. */
+class CISST_EXPORT mtsSharedMemoryCommand
+{
+public:
+    typedef enum {SERVO_JP = 1,
+                  SERVO_JF,
+                  SERVO_CP} CommandType;
+
+    static const size_t MaximumNumberOfValues = 16;
+
+    /*! Joint positions and efforts use one value per joint.
+      Cartesian positions use translation then quaternion w, x, y, z. */
+    struct Data {
+        uint32_t Type;
+        uint32_t NumberOfValues;
+        double Time; // see Now
+        double Values[MaximumNumberOfValues];
+    };
+
+    /*! Name of the shared memory ring for a given arm */
+    static std::string RingName(const std::string & armName);
+
+    /*! Time in seconds from a monotonic clock shared by all processes,
+      used to measure latency */
+    static double Now(void);
+
+    /*! Create the mailbox, used by the arm */
+    bool Create(const std::string & armName, const size_t numberOfSlots);
+
+    /*! Latest command, see mtsSharedMemoryRing::ReadLatest */
+    int Poll(uint64_t & index, Data & data) const;
+
+    /*! Open an existing mailbox, used by the client */
+    bool Open(const std::string & armName);
+
+    /*! Client commands, return false if the mailbox is not open or
+      there are too many values */
+    //@{
+    bool servo_jp(const double * positions, const size_t numberOfJoints);
+    bool servo_jf(const double * efforts, const size_t numberOfJoints);
+    bool servo_cp(const double translation[3], const double quaternion[4]);
+    //@}
+
+    inline const mtsSharedMemoryRing & Ring(void) const {
+        return mRing;
+    }
+
+protected:
+    bool Send(const CommandType type, const double * values, const size_t numberOfValues);
+
+    mtsSharedMemoryRing mRing;
+};
+
+#endif // _mtsSharedMemoryCommand_h
@@ -0,0 +1,163 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-04
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsSharedMemoryRing_h
+#define _mtsSharedMemoryRing_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Ring of fixed size slots in POSIX shared memory, one writer
+  process and any number of reader processes.  The process creating
+  the ring owns it and removes it when closed.  This is usually the
+  writer but the ring can also be created by a reader and opened for
+  writing by another process (see mtsSharedMemoryCommand).
+
+  Each slot is protected by a sequence lock (see
+  mtsIntuitiveResearchKitSeqLock) so the writer never waits for
+  readers.  Readers map the shared memory read-only, they can't
+  modify anything the writer uses and don't need to be known by the
+  writer.  A reader too slow to keep up with the writer gets an
+  overrun error and can restart from the latest slot.
+
+  The number of slots and slot size are read from the header once,
+  in Create or Open, and never trusted after.  A process opening an
+  existing ring for writing maps the header page read-only.  The
+  write count and data sizes it can still modify are always checked
+  against the cached geometry so a faulty writer can't make the
+  owner access memory outside the ring.
+
+  The writer is used by mtsIntuitiveResearchKitUDPStreamer to publish
+  arm samples (see mtsIntuitiveResearchKitStreamFormat).  This class
+  only depends on the C++ standard library and POSIX so it can be
+  used as-is by external readers.
+
+  Layout, all offsets in bytes:
+  - header (4096 bytes, one page, only the first 64 bytes are used)
+    - 0: uint32 magic number, "dVRM"
+    - 4: uint16 layout version
+    - 6: uint16 header size
+    - 8: uint32 number of slots
+    - 12: uint32 slot size, including slot header
+    - 16: char[40] source name, null terminated
+    - 56: uint64 reserved
+  - control (64 bytes)
+    - 0: uint64 number of writes, atomic
+  - slots, slot i starts at header size + 64 + i * slot size
+    - 0: uint32 sequence lock, odd while writing, atomic
+    - 4: uint32 data size
+    - 8: uint64 write index
+    - 16: data */
+class CISST_EXPORT mtsSharedMemoryRing
+{
+public:
+    static const uint32_t Magic = 0x4d525664; // "dVRM" in little-endian
+    static const uint16_t Version = 2;
+    static const size_t HeaderSize = 4096;
+    static const size_t ControlSize = 64;
+    static const size_t SlotHeaderSize = 16;
+    static const size_t SourceSize = 40;
+
+    /*! Read results, positive values are the data size */
+    enum {NO_DATA = 0,
+          OVERRUN = -1,
+          BUFFER_TOO_SMALL = -2,
+          BUSY = -3};
+
+    mtsSharedMemoryRing(void);
+
+    /*! Unmaps the shared memory and, for the writer, removes it */
+    ~mtsSharedMemoryRing();
+
+    /*! Create a new shared memory ring, replacing any existing one
+      with the same name.  Name should start with "/", e.g.
+      "/dvrk-PSM1".  The memory is touched and locked if possible to
+      avoid page faults in Write. */
+    bool Create(const std::string & name, const size_t numberOfSlots,
+                const size_t maximumDataSize, const std::string & source = "");
+
+    /*! Open an existing ring, read-only by default.  Returns false
+      if it doesn't exist or the layout doesn't match.  There should
+      never be more than one process writing to a ring. */
+    bool Open(const std::string & name, const bool writable = false);
+
+    void Close(void);
+
+    inline bool IsWriter(void) const {
+        return mWritable;
+    }
+
+    inline bool IsOpen(void) const {
+        return (mHeader != nullptr);
+    }
+
+    /*! Reason Create or Open failed */
+    inline const std::string & LastError(void) const {
+        return mLastError;
+    }
+
+    /*! Copy data to the next slot, writer only.  Returns false if
+      the ring is read-only or data is larger than the slot. */
+    bool Write(const void * data, const size_t size);
+
+    /*! Number of writes, the next slot to write has this index */
+    uint64_t WriteCount(void) const;
+
+    size_t NumberOfSlots(void) const;
+    size_t MaximumDataSize(void) const;
+    std::string Source(void) const;
+
+    /*! Copy data written with a given index.  Returns the data size
+      or NO_DATA if not written yet, OVERRUN if the slot has been
+      overwritten, BUFFER_TOO_SMALL or BUSY if the writer kept
+      modifying the slot for maxAttempts. */
+    int Read(const uint64_t index, void * buffer, const size_t bufferSize,
+             const size_t maxAttempts = 100) const;
+
+    /*! Copy latest data, index is set to the index of data read */
+    int ReadLatest(uint64_t & index, void * buffer, const size_t bufferSize,
+                   const size_t maxAttempts = 100) const;
+
+protected:
+    struct Header;
+    struct Control;
+    struct Slot;
+
+    Slot * GetSlot(const uint64_t index) const;
+    bool Map(const int fileDescriptor, const size_t size);
+    bool Fail(const std::string & what);
+
+    std::string mName;
+    std::string mLastError;
+    bool mOwner;
+    bool mWritable;
+    char * mMemory;
+    size_t mMemorySize;
+    Header * mHeader;
+    Control * mControl;
+    // geometry from Create or Open, never read from the header after
+    size_t mNumberOfSlots;
+    size_t mSlotSize;
+};
+
+#endif // _mtsSharedMemoryRing_h
@@ -20,17 +20,43 @@ http://www.cisst.org/cisst/license.txt.
 #define _mtsSocketBasePSM_h
 
 #include <cisstCommon/cmnUnits.h>
-#include <cisstOSAbstraction/osaSocket.h>
 #include <cisstMultiTask/mtsTaskPeriodic.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArmSnapshot.h>
 #include <sawIntuitiveResearchKit/socketMessages.h>
+#include <sawIntuitiveResearchKit/mtsSocketWireFormat.h>
+#include <sawIntuitiveResearchKit/mtsSocketClockSync.h>
+#include <sawIntuitiveResearchKit/mtsSocketTransport.h>
 
 #define VERSION 10000
 #define BUFFER_SIZE 1024
-#define CLIENT_MSG_SIZE 140
-#define SERVER_MSG_SIZE 140
 
 #define TIMEOUT 4.0 * cmn_ms
 
+/*! Data displayed by mtsSocketBaseQtWidget, published on demand */
+struct mtsSocketBasePSMDisplayData
+{
+    unsigned int LastSentPacketId = 0;
+    unsigned int LastReceivedPacketId = 0;
+    unsigned int PacketsLost = 0;
+    unsigned int PacketsDelayed = 0;
+    unsigned int PacketsStale = 0;
+    double LoopTime = 0.0;
+    double ClockOffset = 0.0;
+    double ClockDrift = 0.0;
+    double RoundTripTime = 0.0;
+    vct5 LatencyIn, LatencyOut;
+    // jitter buffer, socket server only
+    bool HasJitterBuffer = false;
+    double PlayoutDelay = 0.0;
+    double Jitter = 0.0;
+    unsigned int PacketsReordered = 0;
+    unsigned int PacketsLate = 0;
+    unsigned int PlayoutExtrapolated = 0;
+    unsigned int PlayoutHolds = 0;
+};
+
+typedef mtsIntuitiveResearchKitSeqLockOnDemand<mtsSocketBasePSMDisplayData> mtsSocketBasePSMDisplaySnapshot;
+
 class mtsSocketBasePSM : public mtsTaskPeriodic
 {
 
@@ -38,24 +64,63 @@ public:
     mtsSocketBasePSM(const std::string & componentName, const double periodInSeconds,
                      const std::string & ip, const unsigned int port,
                      bool isServer);
-    ~mtsSocketBasePSM() {}
+    ~mtsSocketBasePSM();
 
     void Startup(void) {}
     void Cleanup(void);
     void UpdateStatistics(void);
 
+    /*! Format used to encode messages sent, received messages can be
+      in either format.  Default is PACKED, use CDG to communicate
+      with older versions. */
+    void SetWireFormat(const mtsSocketWireFormat::FormatType format);
+
+    /*! Messages with a one way latency above this are considered
+      stale, i.e. too old to be used.  Latency is only known once the
+      clock offset has been estimated. */
+    void SetMaximumLatency(const double latency);
+
+    /*! Select transport, must be called before Configure.  Uses keys
+      "type" ("udp" or "loopback") and "impairment" for the loopback
+      transport (see mtsSocketImpairment::ProfileFromJSON).  The
+      loopback transport can only be used if both peers are in the
+      same process. */
+    void ConfigureTransport(const Json::Value & jsonConfig);
+
+    /*! Data displayed by mtsSocketBaseQtWidget, only written when
+      requested by a widget in the same process. */
+    inline const mtsSocketBasePSMDisplaySnapshot & DisplaySnapshot(void) const {
+        return mDisplaySnapshot;
+    }
+
 protected:
+    /*! Write display snapshot if requested, called once per cycle
+      after UpdateStatistics. */
+    void PublishDisplaySnapshot(void);
+    virtual void UpdateDisplaySnapshot(mtsSocketBasePSMDisplayData & data);
+    mtsSocketBasePSMDisplaySnapshot mDisplaySnapshot;
+    mtsSocketBasePSMDisplayData mDisplayData;
+
+    /*! Wait for a datagram (see TIMEOUT) then dequeue all pending
+      datagrams and keep the latest one in buffer.  Returns number of
+      bytes of latest datagram, 0 or less if nothing was received. */
+    int ReceiveLatest(mtsSocketTransport * socket, char * buffer);
+
+    /*! Check if a message received is older than the maximum latency,
+      stale messages are counted. */
+    bool IsStale(const socketHeader & header);
+
     // UDP details
     struct {
         socketCommandPSM Data;
-        osaSocket * Socket;
+        mtsSocketTransport * Socket;
         short IpPort;
         char Buffer[BUFFER_SIZE];
     } Command;
 
     struct {
         socketStatePSM Data;
-        osaSocket * Socket;
+        mtsSocketTransport * Socket;
         short IpPort;
         char Buffer[BUFFER_SIZE];
     } State;
@@ -64,11 +129,23 @@ protected:
     bool mIsServer;
     const osaTimeServer & mTimeServer;
     socketMessages::StateType CurrentState, DesiredState;
+    mtsSocketWireFormat::FormatType mWireFormat;
 
 private:
     unsigned int mPacketsLost;
     unsigned int mPacketsDelayed;
     double mLoopTime;
+    char mReceiveBuffer[BUFFER_SIZE];
+
+    // clock offset and one way latencies
+    mtsSocketClockSync mClockSync;
+    unsigned int mLastReceivedId;
+    double mMaximumLatency;
+    double mClockOffset;
+    double mClockDrift;
+    double mRoundTripTime;
+    vct5 mLatencyIn, mLatencyOut;
+    unsigned int mPacketsStale;
 };
 
 #endif // _mtsSocketBasePSM_h
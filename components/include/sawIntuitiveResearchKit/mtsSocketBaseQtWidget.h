@@ -22,6 +22,9 @@ http://www.cisst.org/cisst/license.txt.
 #include <cisstMultiTask/mtsComponent.h>
 #include <cisstMultiTask/mtsQtWidgetIntervalStatistics.h>
 
+#include <sawIntuitiveResearchKit/mtsSocketBasePSM.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitQtRefresh.h>
+
 class mtsSocketBaseQtWidget: public QWidget, public mtsComponent
 {
     Q_OBJECT;
@@ -44,9 +47,18 @@ private slots:
 private:
     //! setup GUI
     void setupUi(void);
-    int TimerPeriodInMilliseconds;
+    mtsIntuitiveResearchKitQtRefresh Refresh;
 
 protected:
+    /*! Use the socket's display snapshot if the component is in the
+      same process, read commands otherwise.  Returns false if there
+      is no new data. */
+    bool ReadSocket(void);
+    void FindDisplaySnapshot(void);
+    const mtsSocketBasePSMDisplaySnapshot * mDisplaySnapshot;
+    unsigned int mDisplaySequence;
+    mtsSocketBasePSMDisplayData mDisplayData;
+
     struct {
         mtsFunctionRead GetPacketsLost;
         mtsFunctionRead GetPacketsDelayed;
@@ -54,12 +66,39 @@ protected:
         mtsFunctionRead GetLastReceivedPacketId;
         mtsFunctionRead GetLastSentPacketId;
         mtsFunctionRead period_statistics;
+        // clock offset and latencies
+        mtsFunctionRead GetClockOffset;
+        mtsFunctionRead GetClockDrift;
+        mtsFunctionRead GetRoundTripTime;
+        mtsFunctionRead GetLatencyIn;
+        mtsFunctionRead GetLatencyOut;
+        mtsFunctionRead GetPacketsStale;
+        // jitter buffer, socket server only
+        mtsFunctionRead GetPlayoutDelay;
+        mtsFunctionRead GetJitter;
+        mtsFunctionRead GetPacketsReordered;
+        mtsFunctionRead GetPacketsLate;
+        mtsFunctionRead GetPlayoutExtrapolated;
+        mtsFunctionRead GetPlayoutHolds;
 
         QLabel * QLPacketsLost;
         QLabel * QLPacketsDelayed;
         QLabel * QLLoopTime;
         QLabel * QLLastReceivedPacketId;
         QLabel * QLLastSentPacketId;
+        QLabel * QLClockOffset;
+        QLabel * QLClockDrift;
+        QLabel * QLRoundTripTime;
+        QLabel * QLLatencyIn;
+        QLabel * QLLatencyOut;
+        QLabel * QLPacketsStale;
+        QWidget * QWJitterBuffer;
+        QLabel * QLPlayoutDelay;
+        QLabel * QLJitter;
+        QLabel * QLPacketsReordered;
+        QLabel * QLPacketsLate;
+        QLabel * QLPlayoutExtrapolated;
+        QLabel * QLPlayoutHolds;
     } SocketBase;
 
 private:
@@ -0,0 +1,287 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-24
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsSocketBridge_h
+#define _mtsSocketBridge_h
+
+#include <sawIntuitiveResearchKit/mtsSocketBasePSM.h>
+#include <cisstParameterTypes/prmForceCartesianSet.h>
+#include <cisstParameterTypes/prmOperatingState.h>
+#include <cisstParameterTypes/prmPositionCartesianGet.h>
+#include <cisstParameterTypes/prmPositionCartesianSet.h>
+#include <cisstParameterTypes/prmPositionJointSet.h>
+#include <cisstParameterTypes/prmStateJoint.h>
+#include <cisstParameterTypes/prmVelocityCartesianGet.h>
+
+/*! Single component to bridge multiple arms over one pair of UDP
+  ports.  Each arm is identified by a channel id, i.e. order in which
+  arms are added, so both sides must add the same arms in the same
+  order and with the same type.  All arms are sent in a single
+  datagram per cycle using the packed wire format (see
+  mtsSocketWireFormat).
+
+  On the server side, a required interface named after each arm is
+  added and should be connected to the arm.  On the client side, a
+  provided interface named after each arm is added.  It provides the
+  commands needed by the console and the tele-operation components:
+  - PSM: same commands as mtsSocketClientPSM in cartesian position mode
+  - MTM: measured_cp, setpoint_cp, measured_cv, gripper/measured_js,
+    move_cp, body/servo_cf, lock_orientation, unlock_orientation,
+    use_gravity_compensation and body/set_cf_orientation_absolute
+  - ECM: measured_cp, setpoint_cp, measured_js, setpoint_js, servo_jp
+    and move_jp
+
+  Each side keeps its own control loops, the bridge only forwards the
+  latest state and commands.  Statistics are provided by the "System"
+  interface, see mtsSocketBasePSM. */
+class mtsSocketBridge: public mtsSocketBasePSM
+{
+    CMN_DECLARE_SERVICES(CMN_NO_DYNAMIC_CREATION, CMN_LOG_ALLOW_DEFAULT);
+
+public:
+    mtsSocketBridge(const std::string & componentName, const double periodInSeconds,
+                    const std::string & ip, const unsigned int port,
+                    const bool isServer);
+    ~mtsSocketBridge();
+
+    /*! Add an arm, must be called before the component is added to
+      the component manager.  Returns false if the arm already exists
+      or if the arm doesn't fit in a datagram. */
+    bool AddArm(const std::string & name,
+                const mtsSocketWireFormat::ChannelType type = mtsSocketWireFormat::CHANNEL_PSM);
+
+    inline size_t NumberOfArms(void) const {
+        return mChannels.size();
+    }
+
+    void Configure(const std::string & fileName = "");
+    void Run(void);
+
+protected:
+    /*! Data and commands common to all arm types */
+    class Channel {
+    public:
+        Channel(mtsSocketBridge * bridge, const std::string & name,
+                const mtsSocketWireFormat::ChannelType type);
+        virtual ~Channel() {}
+
+        // server side
+        virtual void AddFunctions(mtsInterfaceRequired * interfaceRequired);
+        virtual size_t EncodeState(const socketHeader & header, char * buffer, const size_t bufferSize) = 0;
+        virtual bool DecodeCommand(const char * buffer, const size_t size) = 0;
+        virtual void ExecuteCommands(const bool stale) = 0;
+        void GoalReachedEventHandler(const bool & reached);
+
+        // client side
+        virtual void AddCommands(mtsInterfaceProvided * interfaceProvided, mtsStateTable & stateTable);
+        virtual size_t EncodeCommand(const socketHeader & header, char * buffer, const size_t bufferSize) = 0;
+        virtual bool DecodeState(const char * buffer, const size_t size) = 0;
+        virtual void UpdateApplication(void) = 0;
+        virtual void state_command(const std::string & state);
+        virtual void Freeze(void);
+
+        mtsSocketBridge * mBridge;
+        std::string mName;
+        mtsSocketWireFormat::ChannelType mType;
+        socketMessages::StateType mCurrentState, mDesiredState, mPreviousState;
+
+    protected:
+        /*! Modes supported by the arm type, besides SCK_HOMED */
+        virtual bool IsModeSupported(const socketMessages::StateType state) const = 0;
+
+        /*! Server side, current socket state from arm operating state.
+          Modes are kept as long as the arm is homed. */
+        void UpdateCurrentState(void);
+
+        /*! Server side, change arm state or mode if the desired state
+          changed.  Arms in a mode are frozen when the desired state is
+          SCK_HOMED. */
+        void ExecuteStateCommand(const socketMessages::StateType desired);
+
+        /*! Client side, operating state from current socket state,
+          event is sent if the state changed. */
+        void UpdateOperatingState(const socketMessages::StateType state);
+
+        /*! Client side, goal reached event is sent once the server has
+          received the command with the goal */
+        void NewGoal(void);
+        void SetGoalId(const socketHeader & header);
+        void CheckGoalReached(const socketHeader & header, const bool reached);
+
+        // server side
+        mtsFunctionRead operating_state_function;
+        mtsFunctionWrite state_command_function;
+        mtsFunctionVoid freeze_function;
+        bool mGoalReached;
+
+        // both
+        prmOperatingState m_operating_state;
+
+        // client side
+        mtsFunctionWrite operating_state_event;
+        mtsFunctionWrite goal_reached_event;
+        bool mGoalActive;
+        unsigned int mGoalId;
+    };
+
+    class ChannelPSM: public Channel {
+    public:
+        ChannelPSM(mtsSocketBridge * bridge, const std::string & name);
+        // server side
+        void AddFunctions(mtsInterfaceRequired * interfaceRequired) override;
+        size_t EncodeState(const socketHeader & header, char * buffer, const size_t bufferSize) override;
+        bool DecodeCommand(const char * buffer, const size_t size) override;
+        void ExecuteCommands(const bool stale) override;
+        // client side
+        void AddCommands(mtsInterfaceProvided * interfaceProvided, mtsStateTable & stateTable) override;
+        size_t EncodeCommand(const socketHeader & header, char * buffer, const size_t bufferSize) override;
+        bool DecodeState(const char * buffer, const size_t size) override;
+        void UpdateApplication(void) override;
+        void state_command(const std::string & state) override;
+        void Freeze(void) override;
+        void servo_cp(const prmPositionCartesianSet & position);
+        void jaw_servo_jp(const prmPositionJointSet & position);
+
+    protected:
+        bool IsModeSupported(const socketMessages::StateType state) const override;
+
+        socketStatePSM mState;
+        socketCommandPSM mCommand;
+
+        // server side
+        mtsFunctionRead measured_cp;
+        mtsFunctionWrite servo_cp_function;
+        mtsFunctionWrite jaw_servo_jp_function;
+        prmPositionCartesianSet m_servo_cp;
+        prmPositionJointSet m_jaw_servo_jp;
+
+        // both
+        prmPositionCartesianGet m_measured_cp;
+
+        // client side
+        prmStateJoint m_jaw_measured_js;
+    };
+
+    class ChannelMTM: public Channel {
+    public:
+        ChannelMTM(mtsSocketBridge * bridge, const std::string & name);
+        // server side
+        void AddFunctions(mtsInterfaceRequired * interfaceRequired) override;
+        size_t EncodeState(const socketHeader & header, char * buffer, const size_t bufferSize) override;
+        bool DecodeCommand(const char * buffer, const size_t size) override;
+        void ExecuteCommands(const bool stale) override;
+        // client side
+        void AddCommands(mtsInterfaceProvided * interfaceProvided, mtsStateTable & stateTable) override;
+        size_t EncodeCommand(const socketHeader & header, char * buffer, const size_t bufferSize) override;
+        bool DecodeState(const char * buffer, const size_t size) override;
+        void UpdateApplication(void) override;
+        void move_cp(const prmPositionCartesianSet & position);
+        void body_servo_cf(const prmForceCartesianSet & wrench);
+        void lock_orientation(const vctMatRot3 & orientation);
+        void unlock_orientation(void);
+        void use_gravity_compensation(const bool & gravity);
+        void body_set_cf_orientation_absolute(const bool & absolute);
+
+    protected:
+        bool IsModeSupported(const socketMessages::StateType state) const override;
+
+        socketStateMTM mState;
+        socketCommandMTM mCommand;
+
+        // server side
+        struct {
+            mtsFunctionRead measured_cp;
+            mtsFunctionRead setpoint_cp;
+            mtsFunctionRead measured_cv;
+            mtsFunctionRead gripper_measured_js;
+            mtsFunctionWrite move_cp;
+            mtsFunctionWrite body_servo_cf;
+            mtsFunctionWrite lock_orientation;
+            mtsFunctionVoid unlock_orientation;
+            mtsFunctionWrite use_gravity_compensation;
+            mtsFunctionWrite body_set_cf_orientation_absolute;
+        } mArm;
+        // last values sent to the arm, commands are only sent when values change
+        bool mLockOrientation;
+        bool mGravityCompensation;
+        bool mWrenchOrientationAbsolute;
+        vctMatRot3 mOrientation;
+        vctFrm3 mGoalPose;
+        prmPositionCartesianSet m_move_cp;
+        prmForceCartesianSet m_body_servo_cf;
+
+        // both
+        prmPositionCartesianGet m_measured_cp;
+        prmPositionCartesianGet m_setpoint_cp;
+        prmVelocityCartesianGet m_measured_cv;
+        prmStateJoint m_gripper_measured_js;
+    };
+
+    class ChannelECM: public Channel {
+    public:
+        ChannelECM(mtsSocketBridge * bridge, const std::string & name);
+        // server side
+        void AddFunctions(mtsInterfaceRequired * interfaceRequired) override;
+        size_t EncodeState(const socketHeader & header, char * buffer, const size_t bufferSize) override;
+        bool DecodeCommand(const char * buffer, const size_t size) override;
+        void ExecuteCommands(const bool stale) override;
+        // client side
+        void AddCommands(mtsInterfaceProvided * interfaceProvided, mtsStateTable & stateTable) override;
+        size_t EncodeCommand(const socketHeader & header, char * buffer, const size_t bufferSize) override;
+        bool DecodeState(const char * buffer, const size_t size) override;
+        void UpdateApplication(void) override;
+        void servo_jp(const prmPositionJointSet & position);
+        void move_jp(const prmPositionJointSet & position);
+
+    protected:
+        bool IsModeSupported(const socketMessages::StateType state) const override;
+        bool SetGoalJoints(const prmPositionJointSet & position);
+
+        socketStateECM mState;
+        socketCommandECM mCommand;
+
+        // server side
+        struct {
+            mtsFunctionRead measured_cp;
+            mtsFunctionRead setpoint_cp;
+            mtsFunctionRead measured_js;
+            mtsFunctionRead setpoint_js;
+            mtsFunctionWrite servo_jp;
+            mtsFunctionWrite move_jp;
+        } mArm;
+        vct4 mGoalJoints;
+        prmPositionJointSet m_setpoint_jp;
+
+        // both
+        prmPositionCartesianGet m_measured_cp;
+        prmPositionCartesianGet m_setpoint_cp;
+        prmStateJoint m_measured_js;
+        prmStateJoint m_setpoint_js;
+    };
+
+    void ReceiveData(void);
+    void SendData(void);
+
+    std::vector<Channel *> mChannels;
+    // datagram sizes, checked when arms are added
+    size_t mStateSize, mCommandSize;
+};
+
+CMN_DECLARE_SERVICES_INSTANTIATION(mtsSocketBridge);
+
+#endif // _mtsSocketBridge_h
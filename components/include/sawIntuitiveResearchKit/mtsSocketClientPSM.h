@@ -44,18 +44,35 @@ protected:
     void Freeze(void);
     void servo_cp(const prmPositionCartesianSet & position);
     void jaw_servo_jp(const prmPositionJointSet & position);
+    void servo_jp(const prmPositionJointSet & position);
+    void move_cp(const prmPositionCartesianSet & position);
+    void move_jp(const prmPositionJointSet & position);
+    void jaw_move_jp(const prmPositionJointSet & position);
+    /*! Trajectory goal will be sent with next command */
+    void NewTrajectoryGoal(const socketMessages::StateType state);
     void UpdateApplication(void);
     void ReceivePSMStateData(void);
     void SendPSMCommandData(void);
 
 private:
     prmPositionCartesianGet m_measured_cp;
+    prmStateJoint m_measured_js;
     prmStateJoint m_jaw_measured_js;
     mtsInterfaceProvided * mInterface;
 
     socketMessages::StateType PreviousState;
     prmOperatingState m_operating_state;
     mtsFunctionWrite operating_state_event;
+
+    // trajectory goal reached, based on id of the command carrying
+    // the goal and last id received by the server
+    mtsFunctionWrite goal_reached_event;
+    bool mTrajectoryGoalNew;
+    bool mTrajectoryGoalActive;
+    unsigned int mTrajectoryGoalId;
+
+    // last state requested was rejected by the server
+    bool mCommandRejected;
 };
 
 CMN_DECLARE_SERVICES_INSTANTIATION(mtsSocketClientPSM);
@@ -0,0 +1,130 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-27
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsSocketClockSync_h
+#define _mtsSocketClockSync_h
+
+#include <cisstVector/vctFixedSizeVectorTypes.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Estimate clock offset and drift between two peers using the
+  timestamps already in socket message headers, NTP style.
+
+  For each message received, the peer echoes our last timestamp
+  (LastTimestamp) along with its own timestamp (Timestamp).  With the
+  local receive time, this gives a round trip and an offset assuming
+  symmetric delays.  The offset is taken from the sample with the
+  smallest round trip over the last few samples (clock filter) and the
+  drift is estimated from offsets at least DriftInterval apart.
+
+  The peer doesn't report when it received our message so its
+  processing time is included in the round trip.  The error on the
+  offset is bounded by half the round trip of the selected sample.
+
+  Using the estimated offset, one way latencies are computed for each
+  sample in both directions.  Outgoing latencies include the peer
+  processing time.  Distributions are computed over a sliding
+  window. */
+class CISST_EXPORT mtsSocketClockSync
+{
+public:
+    enum {FILTER_SIZE = mtsIntuitiveResearchKit::SocketClockSync::FilterSize,
+          WINDOW_SIZE = mtsIntuitiveResearchKit::SocketClockSync::LatencyWindow};
+
+    mtsSocketClockSync(void);
+
+    void Reset(void);
+
+    /*! Add a sample.  localSendTime is the local timestamp echoed by
+      the peer, remoteTime is the peer timestamp and localReceiveTime
+      is the local time the message was received.  Returns false if
+      the sample is not usable, e.g. nothing echoed yet. */
+    bool AddSample(const double localSendTime, const double remoteTime,
+                   const double localReceiveTime);
+
+    /*! At least one sample has been accepted */
+    inline bool Valid(void) const {
+        return mValid;
+    }
+
+    /*! Remote minus local clock at given local time, drift compensated */
+    double Offset(const double localTime) const;
+
+    /*! Relative drift, remote clock rate over local clock rate minus 1 */
+    inline double Drift(void) const {
+        return mDrift;
+    }
+
+    /*! Round trip of sample used for offset estimate */
+    inline double RoundTripTime(void) const {
+        return mRoundTripTime;
+    }
+
+    /*! One way latency of a message sent at remoteTime (remote clock)
+      and received at localReceiveTime (local clock). */
+    double Latency(const double remoteTime, const double localReceiveTime) const;
+
+    /*! Compute latency distributions over the sliding window.  Each
+      distribution contains minimum, mean, standard deviation, 99th
+      percentile and maximum. */
+    void ComputeDistributions(void);
+
+    inline const vct5 & LatencyIn(void) const {
+        return mLatencyIn;
+    }
+
+    inline const vct5 & LatencyOut(void) const {
+        return mLatencyOut;
+    }
+
+    inline size_t NumberOfSamples(void) const {
+        return mNumberOfSamples;
+    }
+
+protected:
+    struct Sample {
+        double Time;
+        double Offset;
+        double Delay;
+    };
+
+    void ComputeDistribution(const double * window, vct5 & distribution);
+
+    Sample mFilter[FILTER_SIZE];
+    size_t mFilterSize, mFilterIndex;
+
+    bool mValid;
+    double mOffset, mOffsetTime;
+    double mRoundTripTime;
+    bool mDriftValid;
+    double mDrift;
+    double mDriftReferenceTime, mDriftReferenceOffset;
+
+    double mWindowIn[WINDOW_SIZE];
+    double mWindowOut[WINDOW_SIZE];
+    double mScratch[WINDOW_SIZE];
+    size_t mWindowSize, mWindowIndex;
+    size_t mNumberOfSamples;
+
+    vct5 mLatencyIn, mLatencyOut;
+};
+
+#endif // _mtsSocketClockSync_h
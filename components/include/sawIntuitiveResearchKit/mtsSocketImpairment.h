@@ -0,0 +1,130 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-29
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsSocketImpairment_h
+#define _mtsSocketImpairment_h
+
+#include <cstdint>
+#include <json/json.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Emulated network link, used by the loopback socket transport to
+  test socket components without a second computer or tc/netem.
+
+  Datagrams sent are queued with a delivery time based on the
+  impairment profile and can be received once the delivery time is
+  reached, earliest delivery first.  Random jitter can reorder
+  datagrams and the reorder probability holds some datagrams for an
+  extra delay.  Statistics count datagrams received after a datagram
+  sent later as reordered.  When the bandwidth is limited, datagrams
+  are serialized one after the other and dropped if the link queue is
+  full.
+
+  All times are provided by the caller so the link can be used with a
+  simulated clock.  The random generator is seeded from the profile so
+  results are reproducible.  This class is not thread safe. */
+class CISST_EXPORT mtsSocketImpairment
+{
+public:
+    enum {CAPACITY = mtsIntuitiveResearchKit::SocketImpairment::Capacity,
+          MAXIMUM_DATAGRAM_SIZE = mtsIntuitiveResearchKit::SocketImpairment::MaximumDatagramSize};
+
+    /*! Impairment profile, times in seconds, probabilities between 0
+      and 1, bandwidth in bytes per second (0 for unlimited) and
+      queue size in bytes. */
+    struct Profile {
+        double Delay = 0.0;
+        double Jitter = 0.0;
+        double Loss = 0.0;
+        double Duplicate = 0.0;
+        double Reorder = 0.0;
+        double ReorderDelay = 0.0;
+        double Bandwidth = 0.0;
+        size_t QueueSize = mtsIntuitiveResearchKit::SocketImpairment::QueueSize;
+        uint32_t Seed = 1;
+    };
+
+    struct Statistics {
+        unsigned int Sent = 0;
+        unsigned int Delivered = 0;
+        unsigned int Lost = 0;
+        unsigned int Duplicated = 0;
+        unsigned int Reordered = 0;
+        unsigned int Overflows = 0;
+    };
+
+    mtsSocketImpairment(void);
+
+    /*! Set profile, drop datagrams in flight and reset statistics */
+    void Configure(const Profile & profile);
+
+    /*! Parse profile from JSON, uses keys "delay", "jitter", "loss",
+      "duplicate", "reorder", "reorder-delay", "bandwidth",
+      "queue-size" and "seed".  Missing keys keep the value from the
+      profile provided.  Returns false if a value is out of range. */
+    static bool ProfileFromJSON(const Json::Value & jsonProfile, Profile & profile);
+
+    /*! Queue a datagram sent at time.  Returns false if the datagram
+      is too large, was lost or the link queue is full.  Lost
+      datagrams are not reported as errors to the sender so callers
+      should ignore the result unless they check statistics. */
+    bool Send(const char * data, const size_t size, const double time);
+
+    /*! Dequeue the earliest datagram with a delivery time before time.
+      Returns number of bytes copied, 0 if there is nothing to receive
+      or -1 if buffer is too small (datagram is dropped). */
+    int Receive(char * buffer, const size_t bufferSize, const double time);
+
+    /*! Number of datagrams in flight */
+    inline size_t Size(void) const {
+        return mSize;
+    }
+
+    inline const Statistics & GetStatistics(void) const {
+        return mStatistics;
+    }
+
+protected:
+    struct Datagram {
+        double DeliveryTime;
+        uint32_t Sequence;
+        size_t Size;
+        char Data[MAXIMUM_DATAGRAM_SIZE];
+    };
+
+    /*! Uniform random number in [0, 1) */
+    double Random(void);
+
+    bool Queue(const char * data, const size_t size,
+               const uint32_t sequence, const double deliveryTime);
+
+    Profile mProfile;
+    Statistics mStatistics;
+    uint32_t mRandomState;
+    uint32_t mSequence;
+    uint32_t mLastDeliveredSequence;
+    double mLinkFreeTime;
+    Datagram mDatagrams[CAPACITY];
+    size_t mSize;
+};
+
+#endif // _mtsSocketImpairment_h
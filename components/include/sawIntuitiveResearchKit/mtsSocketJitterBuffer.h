@@ -0,0 +1,115 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-22
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsSocketJitterBuffer_h
+#define _mtsSocketJitterBuffer_h
+
+#include <cisstVector/vctTransformationTypes.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Adaptive jitter buffer for cartesian commands received over UDP.
+
+  Commands are stored sorted by message id along with the remote
+  timestamp.  Playout is delayed by an adaptive amount based on the
+  measured inter-arrival jitter (see RFC 3550) so poses can be
+  interpolated at the local rate.  On loss, the pose is extrapolated
+  linearly for a short time.  If nothing is received for longer than
+  the hold timeout, the buffer reports HOLD and the caller should stop
+  sending new goals so the arm holds its last setpoint.
+
+  Remote and local clocks don't need to be synchronized, only the
+  offset between both is estimated. */
+class CISST_EXPORT mtsSocketJitterBuffer
+{
+public:
+    typedef enum {EMPTY, BUFFERING, INTERPOLATING, EXTRAPOLATING, HOLD} PlayoutType;
+
+    enum {CAPACITY = mtsIntuitiveResearchKit::SocketJitterBuffer::Capacity};
+
+    struct Statistics {
+        double PlayoutDelay = 0.0;
+        double Jitter = 0.0;
+        unsigned int PacketsReordered = 0;
+        unsigned int PacketsLate = 0;
+        unsigned int PacketsLost = 0;
+        unsigned int Extrapolated = 0;
+        unsigned int Holds = 0;
+    };
+
+    mtsSocketJitterBuffer(void);
+
+    /*! Set parameters, all times in seconds */
+    void Configure(const double minDelay, const double maxDelay,
+                   const double extrapolation, const double holdTimeout);
+
+    /*! Empty buffer, statistics are preserved */
+    void Reset(void);
+
+    /*! Add a command.  Returns false if the command was dropped
+      (duplicate or received too late to be played out). */
+    bool Push(const unsigned int id, const double remoteTime, const double localTime,
+              const vctFrm3 & pose, const double jaw);
+
+    /*! Compute pose and jaw to send at local time. */
+    PlayoutType Playout(const double localTime, vctFrm3 & pose, double & jaw);
+
+    inline const Statistics & GetStatistics(void) const {
+        return mStatistics;
+    }
+
+    inline size_t Size(void) const {
+        return mSize;
+    }
+
+protected:
+    struct Entry {
+        unsigned int Id;
+        double RemoteTime;
+        vctFrm3 Pose;
+        double Jaw;
+    };
+
+    void DropFront(const size_t count);
+
+    Entry mEntries[CAPACITY];
+    size_t mSize;
+    // last entry removed, used to estimate velocity
+    Entry mPrevious;
+    bool mPreviousValid;
+
+    double mMinDelay, mMaxDelay, mExtrapolation, mHoldTimeout;
+
+    // clock offset (local - remote) estimate and jitter
+    bool mOffsetValid;
+    double mOffset;
+    double mLastTransit;
+    double mLastArrival;
+    unsigned int mNewestId;
+    double mLastPlayoutRemoteTime;
+    PlayoutType mLastPlayout;
+
+    vctFrm3 mLastPose;
+    double mLastJaw;
+
+    Statistics mStatistics;
+};
+
+#endif // _mtsSocketJitterBuffer_h
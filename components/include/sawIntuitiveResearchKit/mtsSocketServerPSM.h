@@ -20,9 +20,11 @@ http://www.cisst.org/cisst/license.txt.
 #define _mtsSocketServerPSM_h
 
 #include <sawIntuitiveResearchKit/mtsSocketBasePSM.h>
+#include <sawIntuitiveResearchKit/mtsSocketJitterBuffer.h>
 #include <cisstParameterTypes/prmPositionCartesianGet.h>
 #include <cisstParameterTypes/prmPositionCartesianSet.h>
 #include <cisstParameterTypes/prmPositionJointSet.h>
+#include <cisstParameterTypes/prmStateJoint.h>
 
 class mtsSocketServerPSM: public mtsSocketBasePSM
 {
@@ -36,24 +38,69 @@ public :
     void Configure(const std::string & fileName = "");
     void Run(void);
 
+    /*! Optional jitter buffer for cartesian commands, uses keys
+      "enabled", "min-delay", "max-delay", "extrapolation" and
+      "hold-timeout" (times in seconds). */
+    void ConfigureJitterBuffer(const Json::Value & jsonConfig);
+
 protected:
+    /*! Check if the arm can be put in the state requested by the
+      client, reason is set if not. */
+    bool StateSupported(const socketMessages::StateType state, std::string & reason);
     void ExecutePSMCommands(void);
     void UpdatePSMState(void);
     void ReceivePSMCommandData(void);
+    void ReceivePSMCommandDataJitterBuffer(void);
     void SendPSMStateData(void);
     void ErrorEventHandler(const mtsMessage & message);
+    void GoalReachedEventHandler(const bool & reached);
+    void UpdateDisplaySnapshot(mtsSocketBasePSMDisplayData & data) override;
 
 private:
     mtsFunctionWrite servo_cp;
     mtsFunctionWrite jaw_servo_jp;
+    mtsFunctionWrite servo_jp;
+    mtsFunctionWrite move_cp;
+    mtsFunctionWrite move_jp;
+    mtsFunctionWrite jaw_move_jp;
     mtsFunctionRead measured_cp;
+    mtsFunctionRead measured_js;
 
     mtsFunctionWrite state_command;
     mtsFunctionRead operating_state;
 
     prmPositionCartesianGet m_measured_cp;
+    prmStateJoint m_measured_js;
     prmPositionCartesianSet m_setpoint_cp;
     prmPositionJointSet m_jaw_setpoint_jp;
+    prmPositionJointSet m_setpoint_jp;
+
+    // trajectory modes, goals are only sent to the arm when they change
+    bool mTrajectoryGoalSent;
+    vctFrm3 mTrajectoryGoalPose;
+    vct6 mTrajectoryGoalJoints;
+    double mTrajectoryGoalJaw;
+
+    // last command received is too old for servo modes
+    bool mCommandStale;
+    // last command received used the packed format, legacy format
+    // doesn't carry joint goals
+    bool mCommandPacked;
+
+    // jitter buffer
+    bool mJitterBufferEnabled;
+    mtsSocketJitterBuffer mJitterBuffer;
+    socketCommandPSM mReceivedCommand;
+    vctFrm3 mPlayoutPose;
+    double mPlayoutJaw;
+    struct {
+        double PlayoutDelay;
+        double Jitter;
+        unsigned int PacketsReordered;
+        unsigned int PacketsLate;
+        unsigned int Extrapolated;
+        unsigned int Holds;
+    } mJitterStatistics;
 };
 
 CMN_DECLARE_SERVICES_INSTANTIATION(mtsSocketServerPSM);
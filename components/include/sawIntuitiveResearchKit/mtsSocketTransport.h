@@ -0,0 +1,104 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-29
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsSocketTransport_h
+#define _mtsSocketTransport_h
+
+#include <string>
+
+#include <cisstOSAbstraction/osaSocket.h>
+#include <sawIntuitiveResearchKit/mtsSocketImpairment.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Datagram transport used by socket components (see
+  mtsSocketBasePSM).  Methods follow osaSocket for UDP. */
+class CISST_EXPORT mtsSocketTransport
+{
+public:
+    typedef enum {UDP, LOOPBACK} TransportType;
+
+    virtual ~mtsSocketTransport() {}
+
+    static std::string TypeToString(const TransportType type);
+    /*! Returns false if the string is not a known transport */
+    static bool TypeFromString(const std::string & name, TransportType & type);
+
+    virtual bool SetDestination(const std::string & host, const unsigned short port) = 0;
+    virtual bool AssignPort(const unsigned short port) = 0;
+    virtual int Send(const char * buffer, const unsigned int size) = 0;
+    /*! Returns number of bytes received, 0 if nothing was received
+      before timeout or -1 on error. */
+    virtual int Receive(char * buffer, const unsigned int maxLength,
+                        const double timeoutInSeconds = 0.0) = 0;
+    virtual void Close(void) = 0;
+};
+
+/*! UDP transport, default */
+class CISST_EXPORT mtsSocketTransportUDP: public mtsSocketTransport
+{
+public:
+    mtsSocketTransportUDP(void);
+
+    bool SetDestination(const std::string & host, const unsigned short port) override;
+    bool AssignPort(const unsigned short port) override;
+    int Send(const char * buffer, const unsigned int size) override;
+    int Receive(char * buffer, const unsigned int maxLength,
+                const double timeoutInSeconds = 0.0) override;
+    void Close(void) override;
+
+protected:
+    osaSocket mSocket;
+};
+
+/*! In process transport, all components using the loopback
+  transport in the same process can communicate.  Host names are
+  ignored, datagrams sent to a port are received by the transport
+  assigned to this port.
+
+  Datagrams sent go through an emulated link (see
+  mtsSocketImpairment) using the impairment profile of the sender.
+  Each destination port has its own link so if multiple senders use
+  the same destination port, the last profile set is used. */
+class CISST_EXPORT mtsSocketTransportLoopback: public mtsSocketTransport
+{
+public:
+    mtsSocketTransportLoopback(const mtsSocketImpairment::Profile & profile);
+
+    bool SetDestination(const std::string & host, const unsigned short port) override;
+    bool AssignPort(const unsigned short port) override;
+    int Send(const char * buffer, const unsigned int size) override;
+    int Receive(char * buffer, const unsigned int maxLength,
+                const double timeoutInSeconds = 0.0) override;
+    void Close(void) override;
+
+    /*! Link statistics for a given port, returns false if the port
+      has never been used */
+    static bool GetStatistics(const unsigned short port,
+                              mtsSocketImpairment::Statistics & statistics);
+
+    class Link;
+
+protected:
+    mtsSocketImpairment::Profile mProfile;
+    Link * mDestination;
+    Link * mSource;
+};
+
+#endif // _mtsSocketTransport_h
@@ -0,0 +1,196 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _mtsSocketWireFormat_h
+#define _mtsSocketWireFormat_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <sawIntuitiveResearchKit/socketMessages.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Encoding of socket messages used by mtsSocketServerPSM,
+  mtsSocketClientPSM and mtsSocketBridge.
+
+  PACKED is a fixed layout, little-endian, versioned format.  All
+  fields are at a fixed offset and are written/read directly in the
+  UDP buffer, no memory allocation.  Layout (offsets in bytes):
+
+  - header (32 bytes)
+    - 0: uint32 magic number, "dVRK"
+    - 4: uint16 format version
+    - 6: uint16 message size, including header
+    - 8: uint32 message id
+    - 12: uint32 last message id received
+    - 16: float64 timestamp
+    - 24: float64 last timestamp received
+  - payload for both socketStatePSM and socketCommandPSM (160 bytes)
+    - 32: uint32 robot control state
+    - 36: uint32 flags, for states bit 0 is goal reached and bit 4 is
+      command rejected, 0 for commands
+    - 40: 3 x float64 translation
+    - 64: 9 x float64 rotation, row major
+    - 136: float64 jaw
+    - 144: 6 x float64 joint positions
+
+  Messages for MTMs and ECMs are only used by mtsSocketBridge and
+  use the same header, payload layouts are:
+
+  - socketStateMTM (256 bytes of payload)
+    - 32: uint32 robot control state
+    - 36: uint32 flags, bit 0 is goal reached
+    - 40: measured_cp, 3 x float64 translation, 9 x float64 rotation
+    - 136: setpoint_cp, same as measured_cp
+    - 232: 6 x float64 measured_cv, linear then angular
+    - 280: float64 gripper position
+  - socketCommandMTM (224 bytes of payload)
+    - 32: uint32 robot control state
+    - 36: uint32 flags, see FlagLockOrientation...
+    - 40: goal for move_cp, 3 x float64 translation, 9 x float64 rotation
+    - 136: 9 x float64 orientation for lock_orientation, row major
+    - 208: 6 x float64 body wrench, force then torque
+  - socketStateECM (264 bytes of payload)
+    - 32: uint32 robot control state
+    - 36: uint32 flags, bit 0 is goal reached
+    - 40: measured_cp, 3 x float64 translation, 9 x float64 rotation
+    - 136: setpoint_cp, same as measured_cp
+    - 232: 4 x float64 measured_js
+    - 264: 4 x float64 setpoint_js
+  - socketCommandECM (40 bytes of payload)
+    - 32: uint32 robot control state
+    - 36: uint32 flags, 0
+    - 40: 4 x float64 joint positions
+
+  CDG is the format used in previous versions, i.e. cmnData binary
+  serialization of the types defined in socketMessages.cdg.  This is
+  only provided to communicate with older peers and uses a string
+  stream.  PSM messages are encoded using the frozen
+  socketStatePSMv1 and socketCommandPSMv1 layouts so joint positions
+  and goal reached are not sent, joint space and trajectory modes
+  require the packed format.
+
+  Decoding detects the format based on the magic number so receivers
+  can accept both formats, the format is only needed for encoding. */
+class CISST_EXPORT mtsSocketWireFormat
+{
+public:
+    typedef enum {PACKED, CDG} FormatType;
+
+    static const uint32_t Magic = 0x4B525664; // "dVRK" in little-endian
+    static const uint16_t Version = 2;
+    static const size_t HeaderSize = 32;
+    static const size_t MessagePSMSize = 192;
+    static const size_t MessageStateMTMSize = 288;
+    static const size_t MessageCommandMTMSize = 256;
+    static const size_t MessageStateECMSize = 296;
+    static const size_t MessageCommandECMSize = 72;
+    static const uint32_t FlagGoalReached = 0x1;
+    static const uint32_t FlagLockOrientation = 0x2;
+    static const uint32_t FlagGravityCompensation = 0x4;
+    static const uint32_t FlagWrenchOrientationAbsolute = 0x8;
+    static const uint32_t FlagCommandRejected = 0x10;
+
+    static std::string FormatToString(const FormatType format);
+    /*! Returns false if the string is not a known format */
+    static bool FormatFromString(const std::string & name, FormatType & format);
+
+    /*! Encode message in buffer.  Returns number of bytes used or 0 if
+      the buffer is too small.  Header size is updated. */
+    //@{
+    static size_t Encode(const FormatType format, socketStatePSM & data,
+                         char * buffer, const size_t bufferSize);
+    static size_t Encode(const FormatType format, socketCommandPSM & data,
+                         char * buffer, const size_t bufferSize);
+    static size_t Encode(const FormatType format, socketStateMTM & data,
+                         char * buffer, const size_t bufferSize);
+    static size_t Encode(const FormatType format, socketCommandMTM & data,
+                         char * buffer, const size_t bufferSize);
+    static size_t Encode(const FormatType format, socketStateECM & data,
+                         char * buffer, const size_t bufferSize);
+    static size_t Encode(const FormatType format, socketCommandECM & data,
+                         char * buffer, const size_t bufferSize);
+    //@}
+
+    /*! Decode message from buffer, format is detected.  Returns false
+      if the buffer doesn't contain a valid message, in which case data
+      might be partially modified. */
+    //@{
+    static bool Decode(const char * buffer, const size_t size,
+                       socketStatePSM & data);
+    static bool Decode(const char * buffer, const size_t size,
+                       socketCommandPSM & data);
+    static bool Decode(const char * buffer, const size_t size,
+                       socketStateMTM & data);
+    static bool Decode(const char * buffer, const size_t size,
+                       socketCommandMTM & data);
+    static bool Decode(const char * buffer, const size_t size,
+                       socketStateECM & data);
+    static bool Decode(const char * buffer, const size_t size,
+                       socketCommandECM & data);
+    //@}
+
+    /*! Check if the buffer starts with the packed format magic number */
+    static bool IsPacked(const char * buffer, const size_t size);
+
+    /*! Multiple arms in a single datagram, see mtsSocketBridge.  The
+      bridge header uses the same layout as the packed header except
+      the magic number is "dVRB" and the size field is replaced by the
+      number of channels.  Each channel starts with a uint16 channel
+      id, a uint16 channel type (see ChannelType) and a packed message
+      for the arm type.  The channel size is found using the packed
+      message size. */
+    //@{
+    typedef enum {CHANNEL_PSM = 0,
+                  CHANNEL_MTM = 1,
+                  CHANNEL_ECM = 2} ChannelType;
+
+    static const uint32_t BridgeMagic = 0x42525664; // "dVRB" in little-endian
+    static const size_t BridgeHeaderSize = 32;
+    static const size_t ChannelHeaderSize = 4;
+    static const size_t BridgeChannelSize = ChannelHeaderSize + MessagePSMSize;
+
+    /*! Size of channels, channel header included */
+    //@{
+    static size_t BridgeChannelStateSize(const ChannelType type);
+    static size_t BridgeChannelCommandSize(const ChannelType type);
+    //@}
+
+    /*! Returns number of bytes used, i.e. BridgeHeaderSize, or 0 if
+      the buffer is too small */
+    static size_t EncodeBridgeHeader(const socketHeader & header, const size_t numberOfChannels,
+                                     char * buffer, const size_t bufferSize);
+    /*! Returns false if the buffer is not a bridge message or is too
+      small for the channels announced. */
+    static bool DecodeBridgeHeader(const char * buffer, const size_t size,
+                                   socketHeader & header, size_t & numberOfChannels);
+    static void EncodeChannelId(const unsigned int channel, char * buffer,
+                                const ChannelType type = CHANNEL_PSM);
+    static unsigned int DecodeChannelId(const char * buffer);
+    /*! Channel type as sent, might not be a valid ChannelType */
+    static unsigned int DecodeChannelType(const char * buffer);
+    /*! Size of channel starting at buffer, channel header included.
+      Only valid for channels checked by DecodeBridgeHeader. */
+    static size_t DecodeChannelSize(const char * buffer);
+    //@}
+};
+
+#endif // _mtsSocketWireFormat_h
@@ -24,10 +24,14 @@ http://www.cisst.org/cisst/license.txt.
 #include <cisstParameterTypes/prmPositionCartesianGet.h>
 #include <cisstParameterTypes/prmVelocityCartesianGet.h>
 #include <cisstParameterTypes/prmPositionCartesianSet.h>
+#include <cisstParameterTypes/prmForceCartesianSet.h>
 #include <cisstParameterTypes/prmStateJoint.h>
 #include <cisstParameterTypes/prmPositionJointSet.h>
 
 #include <sawIntuitiveResearchKit/mtsStateMachine.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitMessageAggregator.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitVirtualClock.h>
+#include <sawIntuitiveResearchKit/robTeleOperationECM.h>
 
 // always include last
 #include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
@@ -49,6 +53,12 @@ public:
 
     void set_scale(const double & scale);
 
+    /*! Use a virtual clock for timers instead of the state table tic,
+      see mtsIntuitiveResearchKitArm::set_virtual_clock. */
+    inline void set_virtual_clock(const mtsIntuitiveResearchKitVirtualClock * clock) {
+        m_virtual_clock = clock;
+    }
+
 protected:
 
     virtual void Init(void);
@@ -69,6 +79,11 @@ protected:
     } MessageEvents;
     mtsInterfaceProvided * mInterface;
 
+    /*! Errors that can happen every cycle are aggregated and sent at
+      most once per mtsIntuitiveResearchKit::Messages::Interval */
+    void SendAggregatedError(const char * message);
+    mtsIntuitiveResearchKitMessageAggregator mMessages;
+
     struct {
         mtsFunctionWrite scale;
     } ConfigurationEvents;
@@ -99,6 +114,7 @@ protected:
 
         prmPositionCartesianGet m_measured_cp;
         prmVelocityCartesianGet m_measured_cv;
+        prmForceCartesianSet m_body_servo_cf;
     } mMTMR, mMTML;
 
     struct {
@@ -118,25 +134,20 @@ protected:
     mtsStateTable * mConfigurationStateTable;
 
     bool m_clutched;
+    double m_clutch_latency; // time between clutch event and handling
 
     mtsStateMachine mTeleopState;
     double mInStateTimer;
 
-    struct TeleopState {
-        vct3 C;     // center
-        vct3 Up;    // up direction
-        vct3 Lr;    // left/right movement, ie. c vector projected on the XZ plane
-        vct3 Ud;    // up/down movement, ie. c vector projected on the YZ plane
-        vct3 Cw;   // cw vector, ie. up vector projected on the XY plane
-        double w;   // width of image
-        double d;   // depth of R along C, depth of L is opposite
-        vctMatRot3 MTMLRot; //initial rotation of MTML
-        vctMatRot3 MTMRRot; //initial rotation of MTMR
-        vctMatrixRotation3<double> ECMRotEuler; //initial rotation of ECM calc using Euler angles
-        vctVec ECMPositionJoint;
-    } mInitial;
-
-    bool m_following;
+    // optional virtual clock, state table tic is used otherwise
+    const mtsIntuitiveResearchKitVirtualClock * m_virtual_clock = nullptr;
+    inline double Now(void) const {
+        return m_virtual_clock ? m_virtual_clock->Time() : StateTable.GetTic();
+    }
+
+    robTeleOperationECM mTeleop;
+
+    bool m_following = false;
     void set_following(const bool following);
 };
 
@@ -26,13 +26,34 @@
 #include <cisstParameterTypes/prmStateJoint.h>
 #include <cisstParameterTypes/prmConfigurationJoint.h>
 #include <cisstParameterTypes/prmPositionJointSet.h>
+#include <cisstParameterTypes/prmForceCartesianGet.h>
+#include <cisstParameterTypes/prmForceCartesianSet.h>
 
 #include <sawIntuitiveResearchKit/mtsIntuitiveResearchKit.h>
 #include <sawIntuitiveResearchKit/mtsStateMachine.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArmSnapshot.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitMessageAggregator.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitVirtualClock.h>
 
 // always include last
 #include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
 
+/*! Data displayed by mtsTeleOperationPSMQtWidget, published on
+  demand.  Frame names are only read once by the widget. */
+struct mtsTeleOperationPSMDisplayData
+{
+    bool MTM_measured_cp_valid = false;
+    double MTM_measured_cp_timestamp = 0.0;
+    vctFrm3 MTM_measured_cp;
+    bool PSM_setpoint_cp_valid = false;
+    double PSM_setpoint_cp_timestamp = 0.0;
+    vctFrm3 PSM_setpoint_cp;
+    vctMatRot3 alignment_offset;
+    vctMatRot3 registration_rotation;
+};
+
+typedef mtsIntuitiveResearchKitSeqLockOnDemand<mtsTeleOperationPSMDisplayData> mtsTeleOperationPSMDisplaySnapshot;
+
 class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
 {
     CMN_DECLARE_SERVICES(CMN_DYNAMIC_CREATION_ONEARG, CMN_LOG_ALLOW_DEFAULT);
@@ -53,6 +74,20 @@ class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
     void lock_rotation(const bool & lock);
     void lock_translation(const bool & lock);
     void set_align_mtm(const bool & alignMTM);
+    void set_force_feedback(const bool & forceFeedback);
+
+    /*! Use a virtual clock for timers and rates instead of the state
+      table tic and period, see
+      mtsIntuitiveResearchKitArm::set_virtual_clock. */
+    inline void set_virtual_clock(const mtsIntuitiveResearchKitVirtualClock * clock) {
+        m_virtual_clock = clock;
+    }
+
+    /*! Data displayed by mtsTeleOperationPSMQtWidget, only written
+      when requested by a widget in the same process. */
+    inline const mtsTeleOperationPSMDisplaySnapshot & display_snapshot(void) const {
+        return m_display_snapshot;
+    }
 
  protected:
 
@@ -60,6 +95,7 @@ class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
 
     // Event Handler
     void MTMErrorEventHandler(const mtsMessage & message);
+    void MTMGoalReachedEventHandler(const bool & reached);
     void PSMErrorEventHandler(const mtsMessage & message);
 
     void ClutchEventHandler(const prmEventButton & button);
@@ -73,16 +109,32 @@ class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
     } MessageEvents;
     mtsInterfaceProvided * mInterface;
 
+    /*! Errors that can happen every cycle are aggregated and sent at
+      most once per mtsIntuitiveResearchKit::Messages::Interval */
+    void SendAggregatedError(const char * message);
+    mtsIntuitiveResearchKitMessageAggregator mMessages;
+
     struct {
         mtsFunctionWrite scale;
         mtsFunctionWrite rotation_locked;
         mtsFunctionWrite translation_locked;
         mtsFunctionWrite align_mtm;
+        mtsFunctionWrite force_feedback;
     } ConfigurationEvents;
 
     void SetDesiredState(const std::string & state);
     void state_command(const std::string & command);
 
+    /*! Find snapshot of arm connected to required interface.
+      Returns 0 if the arm is not a dVRK arm in the same process. */
+    const mtsIntuitiveResearchKitArmSnapshot * FindArmSnapshot(const std::string & interfaceName);
+    void UpdateMTMGripper(void);
+
+    /*! Fill data for display snapshot, only called when requested */
+    void UpdateDisplaySnapshot(mtsTeleOperationPSMDisplayData & data);
+    mtsTeleOperationPSMDisplaySnapshot m_display_snapshot;
+    mtsTeleOperationPSMDisplayData m_display_snapshot_data;
+
     vctMatRot3 UpdateAlignOffset(void);
     void UpdateInitialState(void);
 
@@ -106,6 +158,7 @@ class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
         mtsFunctionWrite lock_orientation;
         mtsFunctionVoid  unlock_orientation;
         mtsFunctionWrite servo_cf_body;
+        mtsFunctionWrite body_set_cf_orientation_absolute;
         mtsFunctionWrite use_gravity_compensation;
 
         mtsFunctionRead  operating_state;
@@ -116,6 +169,11 @@ class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
         prmPositionCartesianGet m_setpoint_cp;
         prmPositionCartesianSet m_move_cp;
         vctFrm4x4 CartesianInitial;
+
+        const mtsIntuitiveResearchKitArmSnapshot * snapshot = 0;
+        mtsIntuitiveResearchKitArmSnapshotData m_snapshot; // last good snapshot
+        bool m_snapshot_valid = false; // snapshot read this cycle, read commands used otherwise
+        size_t m_snapshot_failures = 0;
     } mMTM;
 
     struct {
@@ -125,16 +183,23 @@ class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
         mtsFunctionRead  jaw_setpoint_js;
         mtsFunctionRead  jaw_configuration_js;
         mtsFunctionWrite jaw_servo_jp;
+        mtsFunctionRead  body_measured_cf;
 
         mtsFunctionRead  operating_state;
         mtsFunctionWrite state_command;
 
         prmStateJoint m_jaw_setpoint_js;
+        prmForceCartesianGet m_body_measured_cf;
         prmConfigurationJoint m_jaw_configuration_js;
         prmPositionCartesianGet m_setpoint_cp;
         prmPositionCartesianSet m_servo_cp;
         prmPositionJointSet     m_jaw_servo_jp;
         vctFrm4x4 CartesianInitial;
+
+        const mtsIntuitiveResearchKitArmSnapshot * snapshot = 0;
+        mtsIntuitiveResearchKitArmSnapshotData m_snapshot; // last good snapshot
+        bool m_snapshot_valid = false; // snapshot read this cycle, read commands used otherwise
+        size_t m_snapshot_failures = 0;
     } mPSM;
 
     struct {
@@ -147,6 +212,7 @@ class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
     vctMatRot3 m_registration_rotation; // optional registration between PSM and MTM orientation
     vctMatRot3 m_alignment_offset,
         m_alignment_offset_initial; // rotation offset between MTM and PSM when tele-operation goes in follow mode
+    vctMatRot3 m_alignment_mtm_previous; // MTM orientation on last cycle, residual offset removed only when MTM rotates
 
     // conversion from gripper (MTM) to jaw (PSM)
     // j = s * g + o
@@ -189,12 +255,39 @@ class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
     } m_operator;
 
     bool m_clutched = false;
+    double m_clutch_latency = 0.0; // time between clutch event and handling
     bool m_back_from_clutch = false;
     bool m_jaw_caught_up_after_clutch = false;
     bool m_rotation_locked = false;
     bool m_translation_locked = false;
     bool m_align_mtm = true; // default on da Vinci
 
+    // read arms state using snapshots instead of read commands when possible
+    bool m_use_arm_snapshot = false;
+    double m_arms_read_time = 0.0; // time spent reading arms state
+
+    // force feedback, PSM body wrench applied on MTM
+    struct {
+        bool enabled = false;
+        bool active = false; // true if MTM has been sent a non zero wrench
+        double scale = mtsIntuitiveResearchKit::TeleOperationPSM::ForceFeedbackScale;
+        double cutoff = mtsIntuitiveResearchKit::TeleOperationPSM::ForceFeedbackCutoff;
+        double max_force = mtsIntuitiveResearchKit::TeleOperationPSM::ForceFeedbackMaxForce;
+        double tank_capacity = mtsIntuitiveResearchKit::TeleOperationPSM::ForceFeedbackEnergyTank;
+        double tank_level = 0.0;
+        vct3 filtered; // in MTM base frame
+        vct3 applied; // in MTM base frame, last force sent
+        vct3 previous_position; // MTM position for energy computation
+        double last_timestamp = 0.0; // timestamp of last PSM wrench used
+        unsigned int samples = 0; // number of new PSM wrenches received
+        unsigned int saturated = 0; // number of cycles with force clipped by max or tank
+        double latency = 0.0; // age of the PSM wrench when applied to MTM
+        prmForceCartesianSet m_servo_cf;
+    } m_force_feedback;
+
+    void ResetForceFeedback(void);
+    void RunForceFeedback(void);
+
     vctMatRot3 mMTMClutchedOrientation;
     mtsStateTable * mConfigurationStateTable;
 
@@ -202,7 +295,27 @@ class CISST_EXPORT mtsTeleOperationPSM: public mtsTaskPeriodic
     double mInStateTimer;
     double mTimeSinceLastAlign;
 
-    bool m_following;
+    // optional virtual clock, state table tic and period are used otherwise
+    const mtsIntuitiveResearchKitVirtualClock * m_virtual_clock = nullptr;
+    inline double Now(void) const {
+        return m_virtual_clock ? m_virtual_clock->Time() : StateTable.GetTic();
+    }
+    inline double ControlPeriod(void) const {
+        return m_virtual_clock ? m_virtual_clock->Step() : StateTable.PeriodStats.PeriodAvg();
+    }
+
+    vctMatRot3 mMTMAlignGoal; // last orientation sent to MTM while aligning
+    bool mMTMAlignGoalSent = false;
+    bool mMTMAlignGoalReached = false;
+    double mMTMAlignGoalTime = 0.0;
+
+    // time between request to enable and start of follow mode
+    struct {
+        double start = 0.0; // 0 if no request pending
+        double duration = 0.0;
+    } m_time_to_follow;
+
+    bool m_following = false;
     void set_following(const bool following);
 };
 
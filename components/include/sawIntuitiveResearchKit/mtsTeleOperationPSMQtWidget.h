@@ -25,6 +25,9 @@ http://www.cisst.org/cisst/license.txt.
 #include <cisstParameterTypes/prmPositionCartesianGet.h>
 #include <cisstParameterTypes/prmPositionCartesianGetQtWidget.h>
 
+#include <sawIntuitiveResearchKit/mtsTeleOperationPSM.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitQtRefresh.h>
+
 #include <QSplitter>
 
 #include <sawIntuitiveResearchKit/sawIntuitiveResearchKitQtExport.h>
@@ -79,7 +82,16 @@ private slots:
 private:
     //! setup TeleOperationPSM controller GUI
     void setupUi(void);
-    int TimerPeriodInMilliseconds;
+    mtsIntuitiveResearchKitQtRefresh Refresh;
+
+    /*! Use teleoperation's display snapshot if the component is in
+      the same process, read commands otherwise.  Returns false if
+      there is no new data. */
+    bool ReadTeleOperation(void);
+    void FindDisplaySnapshot(void);
+    const mtsTeleOperationPSMDisplaySnapshot * mDisplaySnapshot;
+    unsigned int mDisplaySequence;
+    mtsTeleOperationPSMDisplayData mDisplayData;
 
     void DesiredStateEventHandler(const std::string & state);
     void CurrentStateEventHandler(const std::string & state);
@@ -111,13 +123,13 @@ private:
     QCheckBox * QCBLockTranslation;
     QCheckBox * QCBAlignMTM;
     QDoubleSpinBox * QSBScale;
-    prmPositionCartesianGet m_MTM_measured_cp;
+    prmPositionCartesianGet m_MTM_measured_cp, m_MTM_measured_cp_displayed;
     prmPositionCartesianGetQtWidget * QCPGMTMWidget;
-    prmPositionCartesianGet m_PSM_setpoint_cp;
+    prmPositionCartesianGet m_PSM_setpoint_cp, m_PSM_setpoint_cp_displayed;
     prmPositionCartesianGetQtWidget * QCPGPSMWidget;
-    vctMatRot3 m_alignment_offset;
+    vctMatRot3 m_alignment_offset, m_alignment_offset_displayed;
     vctQtWidgetRotationDoubleRead * QVRAlignOffset;
-    vctMatRot3 m_registration_rotation;
+    vctMatRot3 m_registration_rotation, m_registration_rotation_displayed;
 
     // timing
     mtsIntervalStatistics m_interval_statistics;
@@ -0,0 +1,88 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-16
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+  --- begin cisst license - do not edit ---
+
+  This software is provided "as is" under an open source license, with
+  no warranty.  The complete license can be found in license.txt and
+  http://www.cisst.org/cisst/license.txt.
+
+  --- end cisst license ---
+*/
+
+#ifndef _robTeleOperationECM_h
+#define _robTeleOperationECM_h
+
+#include <cisstVector/vctFixedSizeVectorTypes.h>
+#include <cisstVector/vctTransformationTypes.h>
+
+// always include last
+#include <sawIntuitiveResearchKit/sawIntuitiveResearchKitExport.h>
+
+/*! Geometry used by the ECM tele-operation.  The MTMs define an image
+  plane (center, up and side vectors).  Motion of the image plane is
+  converted to ECM joint goals and MTM positions/orientations are
+  computed to keep the MTMs in the image plane.  All data is fixed
+  size, no memory allocation is performed by Initialize or Compute. */
+class CISST_EXPORT robTeleOperationECM
+{
+public:
+    /*! Save the initial state.  ECM joints must be of size 4. */
+    void Initialize(const vct3 & mtmlPosition, const vctMatRot3 & mtmlRotation,
+                    const vct3 & mtmrPosition, const vctMatRot3 & mtmrRotation,
+                    const vct4 & ecmJoints);
+
+    /*! Compute goals based on current MTM positions and scale used
+      for ECM insertion. */
+    void Compute(const vct3 & mtmlPosition,
+                 const vct3 & mtmrPosition,
+                 const double scale);
+
+    inline const vct3 & GoalL(void) const {
+        return mGoalL;
+    }
+
+    inline const vct3 & GoalR(void) const {
+        return mGoalR;
+    }
+
+    inline const vct4 & GoalJoints(void) const {
+        return mGoalJoints;
+    }
+
+    inline const vctMatRot3 & MTMLRotation(void) const {
+        return mMTMLRotation;
+    }
+
+    inline const vctMatRot3 & MTMRRotation(void) const {
+        return mMTMRRotation;
+    }
+
+protected:
+    struct {
+        vct3 C;     // center
+        vct3 Up;    // up direction
+        vct3 Lr;    // left/right movement, ie. c vector projected on the XZ plane
+        vct3 Ud;    // up/down movement, ie. c vector projected on the YZ plane
+        vct3 Cw;    // cw vector, ie. up vector projected on the XY plane
+        double CNorm; // norm of C, used for insertion
+        double w;   // width of image
+        double d;   // depth of R along C, depth of L is opposite
+        vctMatRot3 MTMLRot; // initial rotation of MTML
+        vctMatRot3 MTMRRot; // initial rotation of MTMR
+        vctMatRot3 ECMRotEulerInverse; // inverse of initial rotation of ECM calc using Euler angles
+        vct4 ECMPositionJoint;
+    } mInitial;
+
+    vct3 mGoalL, mGoalR;
+    vct4 mGoalJoints;
+    vctMatRot3 mMTMLRotation, mMTMRRotation;
+};
+
+#endif // _robTeleOperationECM_h
@@ -0,0 +1,117 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-18
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitActuatorModelTest.h"
+
+#include <cmath>
+
+namespace {
+    const double Period = 1.0 / 1500.0;
+}
+
+void mtsIntuitiveResearchKitActuatorModelTest::TestIdeal(void)
+{
+    mtsIntuitiveResearchKitActuatorModel model;
+    model.SetSize(2);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), model.size());
+    const double requests[2] = {1.5, -2.0};
+    const std::vector<double> & efforts = model.Update(requests, Period);
+    CPPUNIT_ASSERT_EQUAL(1.5, efforts[0]);
+    CPPUNIT_ASSERT_EQUAL(-2.0, efforts[1]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), model.DelaySteps());
+}
+
+void mtsIntuitiveResearchKitActuatorModelTest::TestLatency(void)
+{
+    mtsIntuitiveResearchKitActuatorModel model;
+    model.SetSize(1);
+    // 2.4 periods rounds to 2 steps
+    model.SetLatency(2.4 * Period);
+    double request = 1.0;
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Update(&request, Period)[0]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), model.DelaySteps());
+    request = 2.0;
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Update(&request, Period)[0]);
+    request = 3.0;
+    CPPUNIT_ASSERT_EQUAL(1.0, model.Update(&request, Period)[0]);
+    request = 4.0;
+    CPPUNIT_ASSERT_EQUAL(2.0, model.Update(&request, Period)[0]);
+    CPPUNIT_ASSERT_EQUAL(3.0, model.Update(&request, Period)[0]);
+    CPPUNIT_ASSERT_EQUAL(4.0, model.Update(&request, Period)[0]);
+
+    // larger step, same latency is now a single step
+    model.SetLatency(Period);
+    request = 5.0;
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Update(&request, Period)[0]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), model.DelaySteps());
+    CPPUNIT_ASSERT_EQUAL(5.0, model.Update(&request, Period)[0]);
+}
+
+void mtsIntuitiveResearchKitActuatorModelTest::TestFirstOrder(void)
+{
+    mtsIntuitiveResearchKitActuatorModel model;
+    model.SetSize(2);
+    const double timeConstant = 100.0 * Period;
+    model.SetTimeConstant(0, timeConstant);
+    const double requests[2] = {1.0, 1.0};
+    for (size_t step = 0; step < 100; ++step) {
+        model.Update(requests, Period);
+    }
+    // exact discretization, independent of step size
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0 - std::exp(-1.0), model.Efforts()[0], 1.0e-9);
+    CPPUNIT_ASSERT_EQUAL(1.0, model.Efforts()[1]);
+    for (size_t step = 0; step < 2000; ++step) {
+        model.Update(requests, Period);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, model.Efforts()[0], 1.0e-6);
+}
+
+void mtsIntuitiveResearchKitActuatorModelTest::TestSaturation(void)
+{
+    mtsIntuitiveResearchKitActuatorModel model;
+    model.SetSize(2);
+    model.SetEffortMaximum(0, 0.5);
+    model.SetEffortMaximum(1, -2.0); // sign is ignored
+    double requests[2] = {1.0, -3.0};
+    model.Update(requests, Period);
+    CPPUNIT_ASSERT_EQUAL(0.5, model.Efforts()[0]);
+    CPPUNIT_ASSERT_EQUAL(-2.0, model.Efforts()[1]);
+    requests[0] = -0.2;
+    requests[1] = 1.0;
+    model.Update(requests, Period);
+    CPPUNIT_ASSERT_EQUAL(-0.2, model.Efforts()[0]);
+    CPPUNIT_ASSERT_EQUAL(1.0, model.Efforts()[1]);
+}
+
+void mtsIntuitiveResearchKitActuatorModelTest::TestReset(void)
+{
+    mtsIntuitiveResearchKitActuatorModel model;
+    model.SetSize(1);
+    model.SetLatency(2.0 * Period);
+    model.SetTimeConstant(0, 10.0 * Period);
+    double request = 1.0;
+    for (size_t step = 0; step < 10; ++step) {
+        model.Update(&request, Period);
+    }
+    CPPUNIT_ASSERT(model.Efforts()[0] > 0.0);
+    model.Reset();
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Efforts()[0]);
+    request = 0.0;
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Update(&request, Period)[0]);
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Update(&request, Period)[0]);
+}
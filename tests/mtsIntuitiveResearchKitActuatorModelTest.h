@@ -0,0 +1,62 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-18
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitActuatorModel.h>
+
+class mtsIntuitiveResearchKitActuatorModelTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsIntuitiveResearchKitActuatorModelTest);
+    {
+        CPPUNIT_TEST(TestIdeal);
+        CPPUNIT_TEST(TestLatency);
+        CPPUNIT_TEST(TestFirstOrder);
+        CPPUNIT_TEST(TestSaturation);
+        CPPUNIT_TEST(TestReset);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // no latency nor time constant, efforts applied immediately
+    void TestIdeal(void);
+
+    // requests delayed by a whole number of steps
+    void TestLatency(void);
+
+    // step response reaches 63% after one time constant
+    void TestFirstOrder(void);
+
+    // efforts limited per actuator
+    void TestSaturation(void);
+
+    // reset drops requests in flight
+    void TestReset(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsIntuitiveResearchKitActuatorModelTest);
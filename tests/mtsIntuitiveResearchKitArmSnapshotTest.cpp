@@ -0,0 +1,198 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-14
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitArmSnapshotTest.h"
+#include "sawIntuitiveResearchKitTestsBenchmark.h"
+
+#include <thread>
+
+#include <cisstOSAbstraction/osaGetTime.h>
+#include <cisstMultiTask/mtsStateTable.h>
+#include <cisstParameterTypes/prmPositionCartesianGet.h>
+#include <cisstParameterTypes/prmStateJoint.h>
+
+namespace {
+    // fill all fields with values derived from a single counter so
+    // readers can check consistency
+    void FillSnapshot(mtsIntuitiveResearchKitArmSnapshotData & data, const double value) {
+        data.timestamp = value;
+        data.measured_cp_valid = true;
+        data.measured_cp.Translation().SetAll(value);
+        data.setpoint_cp_valid = true;
+        data.setpoint_cp.Translation().SetAll(value);
+        data.gripper_valid = true;
+        data.gripper = value;
+    }
+
+    bool IsConsistent(const mtsIntuitiveResearchKitArmSnapshotData & data) {
+        const double value = data.timestamp;
+        return ((data.measured_cp.Translation().X() == value)
+                && (data.measured_cp.Translation().Z() == value)
+                && (data.setpoint_cp.Translation().X() == value)
+                && (data.setpoint_cp.Translation().Z() == value)
+                && (data.gripper == value));
+    }
+}
+
+void mtsIntuitiveResearchKitArmSnapshotTest::TestReadWrite(void)
+{
+    mtsIntuitiveResearchKitArmSnapshot snapshot;
+    mtsIntuitiveResearchKitArmSnapshotData data;
+
+    // nothing written yet
+    CPPUNIT_ASSERT(!snapshot.Read(data));
+    CPPUNIT_ASSERT_EQUAL(0u, snapshot.Sequence());
+
+    FillSnapshot(data, 1.0);
+    data.operating_state = prmOperatingState::ENABLED;
+    data.is_homed = true;
+    snapshot.Write(data);
+    CPPUNIT_ASSERT_EQUAL(1u, snapshot.Sequence());
+
+    mtsIntuitiveResearchKitArmSnapshotData result;
+    CPPUNIT_ASSERT(snapshot.Read(result));
+    CPPUNIT_ASSERT(IsConsistent(result));
+    CPPUNIT_ASSERT_EQUAL(1.0, result.timestamp);
+    CPPUNIT_ASSERT_EQUAL(prmOperatingState::ENABLED, result.operating_state);
+    CPPUNIT_ASSERT(result.is_homed);
+
+    FillSnapshot(data, 2.0);
+    snapshot.Write(data);
+    CPPUNIT_ASSERT_EQUAL(2u, snapshot.Sequence());
+    CPPUNIT_ASSERT(snapshot.Read(result));
+    CPPUNIT_ASSERT_EQUAL(2.0, result.timestamp);
+}
+
+void mtsIntuitiveResearchKitArmSnapshotTest::TestConcurrentReadWrite(void)
+{
+    mtsIntuitiveResearchKitArmSnapshot snapshot;
+    mtsIntuitiveResearchKitArmSnapshotData data;
+    FillSnapshot(data, 0.0);
+    snapshot.Write(data);
+
+    const size_t numberOfWrites = 1000000;
+    std::atomic<bool> done(false);
+
+    std::thread writer([&]() {
+            mtsIntuitiveResearchKitArmSnapshotData local;
+            for (size_t index = 1; index <= numberOfWrites; ++index) {
+                FillSnapshot(local, static_cast<double>(index));
+                snapshot.Write(local);
+            }
+            done = true;
+        });
+
+    size_t reads = 0;
+    size_t inconsistent = 0;
+    double previous = 0.0;
+    bool monotonic = true;
+    mtsIntuitiveResearchKitArmSnapshotData result;
+    while (!done) {
+        if (snapshot.Read(result)) {
+            reads++;
+            if (!IsConsistent(result)) {
+                inconsistent++;
+            }
+            if (result.timestamp < previous) {
+                monotonic = false;
+            }
+            previous = result.timestamp;
+        }
+    }
+    writer.join();
+
+    CPPUNIT_ASSERT(reads > 0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), inconsistent);
+    CPPUNIT_ASSERT(monotonic);
+    CPPUNIT_ASSERT(snapshot.Read(result));
+    CPPUNIT_ASSERT_EQUAL(static_cast<double>(numberOfWrites), result.timestamp);
+}
+
+void mtsIntuitiveResearchKitArmSnapshotTest::TestBenchmark(void)
+{
+    const size_t numberOfReads = 1000000;
+    mtsIntuitiveResearchKitArmSnapshotData data, result;
+    FillSnapshot(data, 1.0);
+
+    // sequence lock
+    mtsIntuitiveResearchKitArmSnapshot snapshot;
+    snapshot.Write(data);
+    double startTime = osaGetTime();
+    for (size_t index = 0; index < numberOfReads; ++index) {
+        snapshot.Read(result);
+    }
+    const double seqLockTime = (osaGetTime() - startTime) / numberOfReads;
+    CPPUNIT_ASSERT(IsConsistent(result));
+
+    // state table, same data and accessors as the arm read commands
+    // used by teleop (measured_cp, setpoint_cp, gripper/measured_js
+    // and operating_state).  This doesn't include the function and
+    // command dispatch so it's a lower bound for read commands.
+    mtsStateTable stateTable(100, "benchmark");
+    prmPositionCartesianGet measured_cp, setpoint_cp;
+    prmStateJoint gripper_measured_js;
+    gripper_measured_js.Position().SetSize(1);
+    prmOperatingState operating_state;
+    stateTable.AddData(measured_cp, "measured_cp");
+    stateTable.AddData(setpoint_cp, "setpoint_cp");
+    stateTable.AddData(gripper_measured_js, "gripper/measured_js");
+    stateTable.AddData(operating_state, "operating_state");
+    stateTable.Start();
+    measured_cp.Position().Translation().SetAll(1.0);
+    measured_cp.Valid() = true;
+    setpoint_cp.Position().Translation().SetAll(1.0);
+    setpoint_cp.Valid() = true;
+    gripper_measured_js.Position().SetAll(1.0);
+    gripper_measured_js.Valid() = true;
+    operating_state.State() = prmOperatingState::ENABLED;
+    stateTable.Advance();
+
+    typedef mtsStateTable::Accessor<prmPositionCartesianGet> CartesianAccessor;
+    typedef mtsStateTable::Accessor<prmStateJoint> JointAccessor;
+    typedef mtsStateTable::Accessor<prmOperatingState> OperatingStateAccessor;
+    const CartesianAccessor * measured_cp_accessor =
+        dynamic_cast<const CartesianAccessor *>(stateTable.GetAccessorByInstance(measured_cp));
+    const CartesianAccessor * setpoint_cp_accessor =
+        dynamic_cast<const CartesianAccessor *>(stateTable.GetAccessorByInstance(setpoint_cp));
+    const JointAccessor * gripper_accessor =
+        dynamic_cast<const JointAccessor *>(stateTable.GetAccessorByInstance(gripper_measured_js));
+    const OperatingStateAccessor * operating_state_accessor =
+        dynamic_cast<const OperatingStateAccessor *>(stateTable.GetAccessorByInstance(operating_state));
+    CPPUNIT_ASSERT(measured_cp_accessor && setpoint_cp_accessor
+                   && gripper_accessor && operating_state_accessor);
+
+    prmPositionCartesianGet measured_cp_read, setpoint_cp_read;
+    prmStateJoint gripper_read;
+    prmOperatingState operating_state_read;
+    startTime = osaGetTime();
+    for (size_t index = 0; index < numberOfReads; ++index) {
+        measured_cp_accessor->GetLatest(measured_cp_read);
+        setpoint_cp_accessor->GetLatest(setpoint_cp_read);
+        gripper_accessor->GetLatest(gripper_read);
+        operating_state_accessor->GetLatest(operating_state_read);
+    }
+    const double stateTableTime = (osaGetTime() - startTime) / numberOfReads;
+    CPPUNIT_ASSERT(measured_cp_read.Valid());
+    CPPUNIT_ASSERT_EQUAL(1.0, measured_cp_read.Position().Translation().X());
+    CPPUNIT_ASSERT_EQUAL(1.0, gripper_read.Position().at(0));
+
+    sawIntuitiveResearchKitTests::BenchmarkOutput() << std::endl
+              << "mtsIntuitiveResearchKitArmSnapshotTest: average read time, sequence lock: "
+              << seqLockTime * 1.0e9 << " (ns), state table (4 reads): "
+              << stateTableTime * 1.0e9 << " (ns)" << std::endl;
+}
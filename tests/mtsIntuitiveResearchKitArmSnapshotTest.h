@@ -0,0 +1,56 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-14
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitArmSnapshot.h>
+
+class mtsIntuitiveResearchKitArmSnapshotTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsIntuitiveResearchKitArmSnapshotTest);
+    {
+        CPPUNIT_TEST(TestReadWrite);
+        CPPUNIT_TEST(TestConcurrentReadWrite);
+#ifdef sawIntuitiveResearchKitTests_BENCHMARKS
+        CPPUNIT_TEST(TestBenchmark);
+#endif
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // single thread, check data is copied and sequence is updated
+    void TestReadWrite(void);
+
+    // one writer, one reader, make sure reader never gets a partial copy
+    void TestConcurrentReadWrite(void);
+
+    // compare read time with the state table reads used by arm read commands
+    void TestBenchmark(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsIntuitiveResearchKitArmSnapshotTest);
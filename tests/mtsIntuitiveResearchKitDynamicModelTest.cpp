@@ -0,0 +1,306 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-15
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitDynamicModelTest.h"
+
+#include <cmath>
+
+namespace {
+    const double Gravity = 9.81;
+    const double Period = 1.0 / 1500.0;
+
+    // single revolute link, rotating around z with point mass and
+    // inertia at tip, length l
+    void AddPendulum(mtsIntuitiveResearchKitDynamicModel & model,
+                     const bool modified, const double l, const double mass,
+                     const double inertia, const double armature) {
+        mtsIntuitiveResearchKitDynamicModel::Link link;
+        link.Modified = modified;
+        if (modified) {
+            // frame is on joint axis, tip is along x
+            link.CenterOfMass[0] = l;
+        } else {
+            // frame is at tip
+            link.A = l;
+        }
+        link.Mass = mass;
+        link.Inertia[0] = inertia;
+        link.Inertia[4] = inertia;
+        link.Inertia[8] = inertia;
+        mtsIntuitiveResearchKitDynamicModel::Joint joint;
+        joint.Armature = armature;
+        model.AddLink(link, joint);
+    }
+}
+
+void mtsIntuitiveResearchKitDynamicModelTest::TestPendulum(void)
+{
+    const double l = 0.5, m = 2.0, I = 0.01, armature = 0.1;
+    for (int modified = 0; modified < 2; ++modified) {
+        mtsIntuitiveResearchKitDynamicModel model;
+        AddPendulum(model, modified == 1, l, m, I, armature);
+        model.SetGravity(0.0, -Gravity, 0.0);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), model.NumberOfJoints());
+
+        // effort to hold position against gravity
+        const double q = 0.3;
+        double effort;
+        model.InverseDynamics(&q, nullptr, nullptr, &effort);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(m * Gravity * l * std::cos(q), effort, 1.0e-9);
+
+        double inertia;
+        model.InertiaMatrix(&q, &inertia);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(m * l * l + I + armature, inertia, 1.0e-9);
+
+        // holding effort keeps it in place
+        model.Reset(&q);
+        for (size_t step = 0; step < 1500; ++step) {
+            model.Step(&effort, Period);
+        }
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(q, model.Positions()[0], 1.0e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, model.Velocities()[0], 1.0e-9);
+
+        // falls without effort
+        const double zero = 0.0;
+        model.Step(&zero, Period);
+        const double acceleration = -m * Gravity * l * std::cos(q) / inertia;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(acceleration * Period, model.Velocities()[0], 1.0e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(q + acceleration * Period * Period, model.Positions()[0], 1.0e-9);
+    }
+}
+
+void mtsIntuitiveResearchKitDynamicModelTest::TestTwoLinks(void)
+{
+    const double m1 = 1.0, m2 = 2.0, l1 = 0.4, l2 = 0.3, lc1 = 0.2, lc2 = 0.15;
+    const double I1 = 0.01, I2 = 0.02;
+
+    mtsIntuitiveResearchKitDynamicModel model;
+    mtsIntuitiveResearchKitDynamicModel::Link link;
+    mtsIntuitiveResearchKitDynamicModel::Joint joint;
+    link.A = l1;
+    link.Mass = m1;
+    link.CenterOfMass[0] = lc1 - l1;
+    link.Inertia[8] = I1;
+    model.AddLink(link, joint);
+    link.A = l2;
+    link.Mass = m2;
+    link.CenterOfMass[0] = lc2 - l2;
+    link.Inertia[8] = I2;
+    model.AddLink(link, joint);
+    model.SetGravity(0.0, 0.0, 0.0);
+
+    const double q[2] = {0.3, 0.7};
+    const double qd[2] = {1.1, -0.6};
+    const double c2 = std::cos(q[1]), s2 = std::sin(q[1]);
+
+    double M[4];
+    model.InertiaMatrix(q, M);
+    const double M11 = m1 * lc1 * lc1 + I1 + m2 * (l1 * l1 + lc2 * lc2 + 2.0 * l1 * lc2 * c2) + I2;
+    const double M12 = m2 * (lc2 * lc2 + l1 * lc2 * c2) + I2;
+    const double M22 = m2 * lc2 * lc2 + I2;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(M11, M[0], 1.0e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(M12, M[1], 1.0e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(M12, M[2], 1.0e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(M22, M[3], 1.0e-9);
+
+    // coriolis and centrifugal
+    double h[2];
+    model.InverseDynamics(q, qd, nullptr, h);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-m2 * l1 * lc2 * s2 * (2.0 * qd[0] * qd[1] + qd[1] * qd[1]), h[0], 1.0e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(m2 * l1 * lc2 * s2 * qd[0] * qd[0], h[1], 1.0e-9);
+
+    // gravity
+    model.SetGravity(0.0, -Gravity, 0.0);
+    double g[2];
+    model.InverseDynamics(q, nullptr, nullptr, g);
+    const double c1 = std::cos(q[0]), c12 = std::cos(q[0] + q[1]);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL((m1 * lc1 + m2 * l1) * Gravity * c1 + m2 * lc2 * Gravity * c12, g[0], 1.0e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(m2 * lc2 * Gravity * c12, g[1], 1.0e-9);
+
+    // full inverse dynamics is M qdd + h + g
+    const double qdd[2] = {0.5, -2.0};
+    double effort[2];
+    model.InverseDynamics(q, qd, qdd, effort);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(M11 * qdd[0] + M12 * qdd[1] + h[0] + g[0], effort[0], 1.0e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(M12 * qdd[0] + M22 * qdd[1] + h[1] + g[1], effort[1], 1.0e-9);
+}
+
+void mtsIntuitiveResearchKitDynamicModelTest::TestPrismatic(void)
+{
+    const double m = 3.0, armature = 0.5;
+    mtsIntuitiveResearchKitDynamicModel model;
+    mtsIntuitiveResearchKitDynamicModel::Link link;
+    link.Prismatic = true;
+    link.Mass = m;
+    mtsIntuitiveResearchKitDynamicModel::Joint joint;
+    joint.Armature = armature;
+    model.AddLink(link, joint);
+
+    const double q = 0.1;
+    double effort, inertia;
+    model.InverseDynamics(&q, nullptr, nullptr, &effort);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(m * Gravity, effort, 1.0e-9);
+    model.InertiaMatrix(&q, &inertia);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(m + armature, inertia, 1.0e-9);
+
+    // push up with twice its weight
+    model.Reset(&q);
+    const double push = 2.0 * m * Gravity;
+    model.Step(&push, Period);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(m * Gravity / (m + armature) * Period, model.Velocities()[0], 1.0e-9);
+}
+
+void mtsIntuitiveResearchKitDynamicModelTest::TestFriction(void)
+{
+    const double l = 0.5, m = 2.0, I = 0.01, armature = 0.1;
+    const double inertia = m * l * l + I + armature;
+    const double zero = 0.0;
+
+    // Coulomb friction higher than effort
+    mtsIntuitiveResearchKitDynamicModel model;
+    AddPendulum(model, false, l, m, I, armature);
+    model.SetGravity(0.0, 0.0, 0.0);
+    model.JointParameters(0).Coulomb = 1.0;
+    model.Reset(&zero);
+    double effort = 0.9;
+    for (size_t step = 0; step < 1500; ++step) {
+        model.Step(&effort, Period);
+    }
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Positions()[0]);
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Velocities()[0]);
+
+    // effort higher than friction
+    effort = 1.5;
+    model.Step(&effort, Period);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL((effort - 1.0) / inertia * Period, model.Velocities()[0], 1.0e-9);
+
+    // back to stop, sticks again once slow enough
+    effort = 0.0;
+    for (size_t step = 0; step < 1500; ++step) {
+        model.Step(&effort, Period);
+    }
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Velocities()[0]);
+    const double stopped = model.Positions()[0];
+    CPPUNIT_ASSERT(stopped > 0.0);
+    model.Step(&effort, Period);
+    CPPUNIT_ASSERT_EQUAL(stopped, model.Positions()[0]);
+
+    // viscous friction, steady state velocity is effort / b
+    model.JointParameters(0).Coulomb = 0.0;
+    model.JointParameters(0).Viscous = 2.0;
+    model.Reset(&zero);
+    effort = 1.0;
+    for (size_t step = 0; step < 5 * 1500; ++step) {
+        model.Step(&effort, Period);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, model.Velocities()[0], 1.0e-6);
+
+    // very high viscous friction is still stable
+    model.JointParameters(0).Viscous = 1.0e6;
+    for (size_t step = 0; step < 1500; ++step) {
+        model.Step(&effort, Period);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-6, model.Velocities()[0], 1.0e-9);
+}
+
+void mtsIntuitiveResearchKitDynamicModelTest::TestBacklash(void)
+{
+    const double play = 0.02;
+    const double zero = 0.0;
+    mtsIntuitiveResearchKitDynamicModel model;
+    AddPendulum(model, false, 0.5, 2.0, 0.01, 0.1);
+    model.SetGravity(0.0, 0.0, 0.0);
+    model.JointParameters(0).Backlash = play;
+    model.Reset(&zero);
+
+    // drive moves first, the link only follows half the play later
+    double effort = 0.1;
+    const double inertia = 2.0 * 0.5 * 0.5 + 0.01 + 0.1;
+    const double acceleration = effort / inertia;
+    // time for drive to move half the play
+    const double delay = std::sqrt(play / acceleration);
+    size_t step = 0;
+    for (; (step + 1) * Period < 0.9 * delay; ++step) {
+        model.Step(&effort, Period);
+        CPPUNIT_ASSERT_EQUAL(0.0, model.Positions()[0]);
+        CPPUNIT_ASSERT_EQUAL(0.0, model.Velocities()[0]);
+    }
+    for (; step * Period < 1.1 * delay; ++step) {
+        model.Step(&effort, Period);
+    }
+    CPPUNIT_ASSERT(model.Positions()[0] > 0.0);
+    CPPUNIT_ASSERT(model.Velocities()[0] > 0.0);
+
+    // reversing, link stops while drive crosses the play
+    effort = -20.0;
+    while (model.Velocities()[0] > 0.0) {
+        model.Step(&effort, Period);
+    }
+    const double position = model.Positions()[0];
+    model.Step(&effort, Period);
+    CPPUNIT_ASSERT_EQUAL(position, model.Positions()[0]);
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Velocities()[0]);
+}
+
+void mtsIntuitiveResearchKitDynamicModelTest::TestBrakes(void)
+{
+    const double q = 0.3;
+    mtsIntuitiveResearchKitDynamicModel model;
+    AddPendulum(model, false, 0.5, 2.0, 0.01, 0.1);
+    model.SetGravity(0.0, -Gravity, 0.0);
+    model.Reset(&q);
+    model.SetBrakes(true);
+    CPPUNIT_ASSERT(model.BrakesEngaged());
+    const double effort = 10.0;
+    for (size_t step = 0; step < 1500; ++step) {
+        model.Step(&effort, Period);
+    }
+    CPPUNIT_ASSERT_EQUAL(q, model.Positions()[0]);
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Velocities()[0]);
+
+    model.SetBrakes(false);
+    model.Step(&effort, Period);
+    CPPUNIT_ASSERT(model.Positions()[0] > q);
+}
+
+void mtsIntuitiveResearchKitDynamicModelTest::TestStops(void)
+{
+    const double zero = 0.0;
+    mtsIntuitiveResearchKitDynamicModel model;
+    AddPendulum(model, false, 0.5, 2.0, 0.01, 0.1);
+    model.SetGravity(0.0, -Gravity, 0.0);
+    model.JointParameters(0).PositionMin = -0.5;
+    model.JointParameters(0).PositionMax = 0.5;
+    model.Reset(&zero);
+
+    // falls on lower stop and stays there
+    for (size_t step = 0; step < 1500; ++step) {
+        model.Step(&zero, Period);
+    }
+    CPPUNIT_ASSERT_EQUAL(-0.5, model.Positions()[0]);
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Velocities()[0]);
+
+    // pushed to upper stop
+    const double effort = 20.0;
+    for (size_t step = 0; step < 1500; ++step) {
+        model.Step(&effort, Period);
+        CPPUNIT_ASSERT(model.Positions()[0] <= 0.5);
+    }
+    CPPUNIT_ASSERT_EQUAL(0.5, model.Positions()[0]);
+    CPPUNIT_ASSERT_EQUAL(0.0, model.Velocities()[0]);
+}
@@ -0,0 +1,70 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-15
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitDynamicModel.h>
+
+class mtsIntuitiveResearchKitDynamicModelTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsIntuitiveResearchKitDynamicModelTest);
+    {
+        CPPUNIT_TEST(TestPendulum);
+        CPPUNIT_TEST(TestTwoLinks);
+        CPPUNIT_TEST(TestPrismatic);
+        CPPUNIT_TEST(TestFriction);
+        CPPUNIT_TEST(TestBacklash);
+        CPPUNIT_TEST(TestBrakes);
+        CPPUNIT_TEST(TestStops);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // single link, gravity and inertia, same with both DH conventions
+    void TestPendulum(void);
+
+    // planar arm, compare to closed form inertia matrix and coriolis
+    void TestTwoLinks(void);
+
+    // vertical slider holding its weight
+    void TestPrismatic(void);
+
+    // Coulomb friction sticks, viscous friction limits velocity
+    void TestFriction(void);
+
+    // link doesn't move until play is taken up
+    void TestBacklash(void);
+
+    // brakes hold position
+    void TestBrakes(void);
+
+    // joints stop at mechanical stops and can move away
+    void TestStops(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsIntuitiveResearchKitDynamicModelTest);
@@ -0,0 +1,169 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitLogQueueTest.h"
+
+#include <cmath>
+#include <string>
+#include <thread>
+
+typedef mtsIntuitiveResearchKitLogQueue Queue;
+
+void mtsIntuitiveResearchKitLogQueueTest::TestPushPop(void)
+{
+    Queue queue(5, 1.0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), queue.Capacity());
+    Queue::Record record;
+    CPPUNIT_ASSERT(!queue.Pop(record));
+
+    const char * message = "call to measured_js failed";
+    const std::string longName(100, 'x');
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, 1.0, longName, message, {1.0, 2.0}, 3));
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT_EQUAL(Queue::LOG_ERROR, record.Level);
+    CPPUNIT_ASSERT_EQUAL(1.0, record.Time);
+    CPPUNIT_ASSERT(record.Message == message);
+    CPPUNIT_ASSERT_EQUAL(std::string(Queue::NAME_SIZE - 1, 'x'), std::string(record.Name));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), record.NumberOfValues);
+    CPPUNIT_ASSERT_EQUAL(2.0, record.Values[1]);
+    CPPUNIT_ASSERT_EQUAL(3, record.Code);
+    CPPUNIT_ASSERT(!queue.Pop(record));
+
+    // extra values ignored
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_WARNING, 2.0, "PSM1", "too many values",
+                              {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0}));
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT_EQUAL(Queue::LOG_WARNING, record.Level);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(Queue::MAXIMUM_NUMBER_OF_VALUES), record.NumberOfValues);
+    CPPUNIT_ASSERT_EQUAL(-1, record.Code);
+}
+
+void mtsIntuitiveResearchKitLogQueueTest::TestDropped(void)
+{
+    // no rate limiting
+    Queue queue(4, 0.0);
+    for (size_t index = 0; index < 4; ++index) {
+        CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, static_cast<double>(index), "PSM1", "message"));
+    }
+    CPPUNIT_ASSERT(!queue.Push(Queue::LOG_ERROR, 4.0, "PSM1", "message"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), queue.Dropped());
+    Queue::Record record;
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT_EQUAL(0.0, record.Time);
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, 5.0, "PSM1", "message"));
+    size_t count = 0;
+    while (queue.Pop(record)) {
+        ++count;
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), count);
+    CPPUNIT_ASSERT_EQUAL(5.0, record.Time);
+}
+
+void mtsIntuitiveResearchKitLogQueueTest::TestRateLimit(void)
+{
+    Queue queue(16, 1.0);
+    const char * first = "first";
+    const char * second = "second";
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, 10.0, "MTMR", first));
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, 10.0, "MTMR", second));
+    CPPUNIT_ASSERT(!queue.Push(Queue::LOG_ERROR, 10.5, "MTMR", first));
+    CPPUNIT_ASSERT(!queue.Push(Queue::LOG_ERROR, 10.9, "MTMR", first));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), queue.Suppressed());
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, 11.0, "MTMR", first));
+
+    Queue::Record record;
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), record.Suppressed);
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT(record.Message == second);
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT(record.Message == first);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), record.Suppressed);
+    CPPUNIT_ASSERT(!queue.Pop(record));
+}
+
+void mtsIntuitiveResearchKitLogQueueTest::TestRateLimitPerComponent(void)
+{
+    // same thread running multiple components, e.g. scheduler
+    Queue queue(16, 1.0);
+    const char * message = "call to PID.measured_js failed";
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, 10.0, "PSM1", message));
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, 10.0, "PSM2", message));
+    CPPUNIT_ASSERT(!queue.Push(Queue::LOG_ERROR, 10.5, "PSM1", message));
+    CPPUNIT_ASSERT(!queue.Push(Queue::LOG_ERROR, 10.6, "PSM1", message));
+    CPPUNIT_ASSERT(!queue.Push(Queue::LOG_ERROR, 10.7, "PSM2", message));
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, 11.0, "PSM1", message));
+    CPPUNIT_ASSERT(queue.Push(Queue::LOG_ERROR, 11.0, "PSM2", message));
+
+    // suppressed counts are not mixed
+    Queue::Record record;
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT_EQUAL(std::string("PSM1"), std::string(record.Name));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), record.Suppressed);
+    CPPUNIT_ASSERT(queue.Pop(record));
+    CPPUNIT_ASSERT_EQUAL(std::string("PSM2"), std::string(record.Name));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), record.Suppressed);
+    CPPUNIT_ASSERT(!queue.Pop(record));
+}
+
+void mtsIntuitiveResearchKitLogQueueTest::TestFormat(void)
+{
+    Queue queue(4, 1.0);
+    Queue::Record record;
+    queue.Push(Queue::LOG_ERROR, 0.0, "PSM1", "amplifier off", {1.0, 0.0});
+    queue.Pop(record);
+    CPPUNIT_ASSERT_EQUAL(std::string("PSM1: amplifier off [1, 0]"), Queue::Format(record));
+
+    queue.Push(Queue::LOG_WARNING, 0.0, "", "no name");
+    queue.Pop(record);
+    CPPUNIT_ASSERT_EQUAL(std::string("no name"), Queue::Format(record));
+
+    queue.Push(Queue::LOG_WARNING, 0.5, "", "no name");
+    queue.Push(Queue::LOG_WARNING, 2.0, "", "no name");
+    queue.Pop(record);
+    CPPUNIT_ASSERT_EQUAL(std::string("no name (1 similar message suppressed)"), Queue::Format(record));
+}
+
+void mtsIntuitiveResearchKitLogQueueTest::TestThreads(void)
+{
+    const size_t numberOfMessages = 100000;
+    Queue queue(64, 0.0);
+    std::thread producer([&queue, numberOfMessages]() {
+            for (size_t index = 0; index < numberOfMessages; ++index) {
+                while (!queue.Push(Queue::LOG_ERROR, static_cast<double>(index), "PSM1", "message")) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    Queue::Record record;
+    size_t received = 0;
+    bool ordered = true;
+    while (received < numberOfMessages) {
+        if (queue.Pop(record)) {
+            ordered &= (record.Time == static_cast<double>(received));
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CPPUNIT_ASSERT(ordered);
+    CPPUNIT_ASSERT_EQUAL(numberOfMessages, received);
+}
@@ -0,0 +1,66 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitLogQueue.h>
+
+class mtsIntuitiveResearchKitLogQueueTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsIntuitiveResearchKitLogQueueTest);
+    {
+        CPPUNIT_TEST(TestPushPop);
+        CPPUNIT_TEST(TestDropped);
+        CPPUNIT_TEST(TestRateLimit);
+        CPPUNIT_TEST(TestRateLimitPerComponent);
+        CPPUNIT_TEST(TestFormat);
+        CPPUNIT_TEST(TestThreads);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // records are copied, names truncated
+    void TestPushPop(void);
+
+    // full queue drops new records
+    void TestDropped(void);
+
+    // same call site suppressed within minimum interval
+    void TestRateLimit(void);
+
+    // same message from different components rate limited separately
+    void TestRateLimitPerComponent(void);
+
+    // human readable messages
+    void TestFormat(void);
+
+    // producer and consumer in separate threads
+    void TestThreads(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsIntuitiveResearchKitLogQueueTest);
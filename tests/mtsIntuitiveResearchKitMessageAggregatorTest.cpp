@@ -0,0 +1,166 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitMessageAggregatorTest.h"
+
+#include <string>
+#include <vector>
+
+typedef mtsIntuitiveResearchKitMessageAggregator Aggregator;
+
+namespace {
+    struct Sent {
+        Aggregator::LevelType Level;
+        std::string Text;
+    };
+
+    // collects messages sent by Process
+    struct Collector {
+        std::vector<Sent> * Messages;
+        void operator()(const Aggregator::LevelType level, const std::string & text) {
+            Messages->push_back(Sent{level, text});
+        }
+    };
+}
+
+void mtsIntuitiveResearchKitMessageAggregatorTest::TestFirstMessage(void)
+{
+    Aggregator aggregator(2.0);
+    std::vector<Sent> sent;
+    Collector collector{&sent};
+
+    aggregator.Process(0.0, collector);
+    CPPUNIT_ASSERT(sent.empty());
+
+    CPPUNIT_ASSERT(aggregator.Add(Aggregator::MESSAGE_ERROR, "unable to solve inverse kinematics"));
+    aggregator.Process(0.001, collector);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), sent.size());
+    CPPUNIT_ASSERT_EQUAL(Aggregator::MESSAGE_ERROR, sent[0].Level);
+    CPPUNIT_ASSERT_EQUAL(std::string("unable to solve inverse kinematics"), sent[0].Text);
+
+    // nothing new, nothing sent
+    aggregator.Process(10.0, collector);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), sent.size());
+}
+
+void mtsIntuitiveResearchKitMessageAggregatorTest::TestInterval(void)
+{
+    Aggregator aggregator(2.0);
+    std::vector<Sent> sent;
+    Collector collector{&sent};
+    const char * message = "PID position limit";
+
+    // one occurrence per cycle
+    double time = 0.0;
+    for (size_t cycle = 0; cycle < 3000; ++cycle) {
+        time = cycle * 0.001;
+        aggregator.Add(Aggregator::MESSAGE_WARNING, message);
+        aggregator.Process(time, collector);
+    }
+    // sent at 0, 2 s
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), sent.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("PID position limit"), sent[0].Text);
+    CPPUNIT_ASSERT_EQUAL(std::string("PID position limit [2000 times in 2s]"), sent[1].Text);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(999), aggregator.Pending(message));
+
+    // pending occurrences sent once interval elapsed
+    aggregator.Process(3.999, collector);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), sent.size());
+    aggregator.Process(4.0, collector);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), sent.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), aggregator.Pending(message));
+}
+
+void mtsIntuitiveResearchKitMessageAggregatorTest::TestDetail(void)
+{
+    Aggregator aggregator(1.0);
+    std::vector<Sent> sent;
+    Collector collector{&sent};
+    const char * message = "arm not ready";
+
+    aggregator.Add(Aggregator::MESSAGE_WARNING, message, "servo_jp");
+    aggregator.Add(Aggregator::MESSAGE_WARNING, message, "move_cp");
+    aggregator.Process(0.0, collector);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), sent.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("arm not ready (move_cp) [2 times]"), sent[0].Text);
+}
+
+void mtsIntuitiveResearchKitMessageAggregatorTest::TestAddOrSend(void)
+{
+    Aggregator aggregator(2.0);
+    std::vector<Sent> sent;
+    Collector collector{&sent};
+    const char * message = "unable to solve inverse kinematics";
+
+    CPPUNIT_ASSERT(aggregator.AddOrSend(0.0, Aggregator::MESSAGE_ERROR, message,
+                                        "joint 3 limit", collector));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), sent.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("unable to solve inverse kinematics (joint 3 limit)"),
+                         sent[0].Text);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), aggregator.Pending(message));
+
+    // following occurrences aggregated
+    aggregator.AddOrSend(0.5, Aggregator::MESSAGE_ERROR, message, "joint 2 limit", collector);
+    aggregator.AddOrSend(1.0, Aggregator::MESSAGE_ERROR, message, "joint 1 limit", collector);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), sent.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), aggregator.Pending(message));
+    aggregator.Process(2.0, collector);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), sent.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("unable to solve inverse kinematics (joint 1 limit) [2 times in 2s]"),
+                         sent[1].Text);
+
+    // sent right away again once interval elapsed
+    aggregator.AddOrSend(4.5, Aggregator::MESSAGE_ERROR, message, "joint 4 limit", collector);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), sent.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("unable to solve inverse kinematics (joint 4 limit)"),
+                         sent[2].Text);
+}
+
+void mtsIntuitiveResearchKitMessageAggregatorTest::TestReset(void)
+{
+    Aggregator aggregator(2.0);
+    std::vector<Sent> sent;
+    Collector collector{&sent};
+    const char * message = "arm not ready";
+
+    aggregator.Add(Aggregator::MESSAGE_WARNING, message);
+    aggregator.Process(0.0, collector);
+    aggregator.Add(Aggregator::MESSAGE_WARNING, message);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), aggregator.Pending(message));
+    aggregator.Reset(message);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), aggregator.Pending(message));
+
+    // sent right away, within the interval of the previous send
+    aggregator.Add(Aggregator::MESSAGE_WARNING, message);
+    aggregator.Process(0.5, collector);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), sent.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("arm not ready"), sent[1].Text);
+}
+
+void mtsIntuitiveResearchKitMessageAggregatorTest::TestFull(void)
+{
+    Aggregator aggregator(1.0, 2);
+    const char * messages[3] = {"first", "second", "third"};
+    CPPUNIT_ASSERT(aggregator.Add(Aggregator::MESSAGE_STATUS, messages[0]));
+    CPPUNIT_ASSERT(aggregator.Add(Aggregator::MESSAGE_STATUS, messages[1]));
+    CPPUNIT_ASSERT(!aggregator.Add(Aggregator::MESSAGE_STATUS, messages[2]));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), aggregator.Pending(messages[2]));
+    // known messages are still aggregated
+    CPPUNIT_ASSERT(aggregator.Add(Aggregator::MESSAGE_STATUS, messages[0]));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), aggregator.Pending(messages[0]));
+}
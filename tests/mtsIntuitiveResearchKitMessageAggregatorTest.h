@@ -0,0 +1,66 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitMessageAggregator.h>
+
+class mtsIntuitiveResearchKitMessageAggregatorTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsIntuitiveResearchKitMessageAggregatorTest);
+    {
+        CPPUNIT_TEST(TestFirstMessage);
+        CPPUNIT_TEST(TestInterval);
+        CPPUNIT_TEST(TestDetail);
+        CPPUNIT_TEST(TestAddOrSend);
+        CPPUNIT_TEST(TestReset);
+        CPPUNIT_TEST(TestFull);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // first occurrence sent on next process
+    void TestFirstMessage(void);
+
+    // occurrences counted and sent once per interval
+    void TestInterval(void);
+
+    // latest detail is sent
+    void TestDetail(void);
+
+    // first occurrence sent right away with its own detail
+    void TestAddOrSend(void);
+
+    // reset forgets pending occurrences and last send
+    void TestReset(void);
+
+    // messages beyond maximum are not aggregated
+    void TestFull(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsIntuitiveResearchKitMessageAggregatorTest);
@@ -0,0 +1,285 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitRecordFileTest.h"
+#include "sawIntuitiveResearchKitTestsBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+    typedef mtsIntuitiveResearchKitRecordFormat Format;
+
+    // unique file name so tests can run in parallel
+    std::string FileName(const std::string & test) {
+        return "mtsIntuitiveResearchKitRecordFileTest-" + test + "-" + std::to_string(getpid()) + ".dvrk";
+    }
+
+    // value for sample i and scalar s
+    double Value(const size_t i, const size_t s) {
+        switch (s) {
+        case 0:
+            return static_cast<double>(i);
+        case 1:
+            return std::sin(0.001 * i);
+        default:
+            return 0.5;
+        }
+    }
+}
+
+void mtsIntuitiveResearchKitRecordFileTest::TestChunk(void)
+{
+    const size_t numberOfSamples = 100;
+    const size_t numberOfScalars = 3;
+    std::vector<double> times(numberOfSamples);
+    std::vector<double> columns(numberOfSamples * numberOfScalars);
+    for (size_t i = 0; i < numberOfSamples; ++i) {
+        times[i] = 1633700000.0 + 0.001 * i;
+        for (size_t s = 0; s < numberOfScalars; ++s) {
+            columns[s * numberOfSamples + i] = Value(i, s);
+        }
+    }
+    columns[numberOfSamples + 10] = -1.0e300; // large jump
+
+    std::vector<char> buffer(Format::MaximumChunkSize(numberOfSamples, numberOfScalars));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0),
+                         Format::EncodeChunk(times.data(), columns.data(), numberOfSamples, numberOfScalars,
+                                             numberOfSamples, buffer.data(), buffer.size() - 1));
+    const size_t size = Format::EncodeChunk(times.data(), columns.data(), numberOfSamples, numberOfScalars,
+                                            numberOfSamples, buffer.data(), buffer.size());
+    CPPUNIT_ASSERT(size > 0);
+    CPPUNIT_ASSERT(size < numberOfSamples * (numberOfScalars + 1) * sizeof(double));
+
+    std::vector<double> decodedTimes(numberOfSamples);
+    std::vector<double> rows(numberOfSamples * numberOfScalars);
+    CPPUNIT_ASSERT(Format::DecodeChunk(buffer.data(), size, numberOfSamples, numberOfScalars,
+                                       decodedTimes.data(), rows.data()));
+    for (size_t i = 0; i < numberOfSamples; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(times[i], decodedTimes[i], 1.0e-6);
+        CPPUNIT_ASSERT_EQUAL(Format::StoredTime(times[i]), decodedTimes[i]);
+        for (size_t s = 0; s < numberOfScalars; ++s) {
+            CPPUNIT_ASSERT_EQUAL(columns[s * numberOfSamples + i], rows[i * numberOfScalars + s]);
+        }
+    }
+    // truncated payload
+    CPPUNIT_ASSERT(!Format::DecodeChunk(buffer.data(), size - 1, numberOfSamples, numberOfScalars,
+                                        decodedTimes.data(), rows.data()));
+
+    // periodic times and constant values use one byte per sample after
+    // the first, times since epoch have a lower resolution
+    const std::vector<double> constant(numberOfSamples, 0.5);
+    for (size_t i = 0; i < numberOfSamples; ++i) {
+        times[i] = 10.0 + 0.001 * i;
+    }
+    const size_t constantSize = Format::EncodeChunk(times.data(), constant.data(), numberOfSamples, 1,
+                                                    numberOfSamples, buffer.data(), buffer.size());
+    CPPUNIT_ASSERT(constantSize <= 2 * numberOfSamples + 2 * 10);
+}
+
+void mtsIntuitiveResearchKitRecordFileTest::TestRoundTrip(void)
+{
+    const std::string fileName = FileName("round-trip");
+    const double startTime = 1633700000.0;
+    {
+        mtsIntuitiveResearchKitRecordWriter writer;
+        CPPUNIT_ASSERT_EQUAL(-1, writer.AddSignal("not-open", {"x"}));
+        CPPUNIT_ASSERT(writer.Open(fileName, 100, 8));
+        CPPUNIT_ASSERT(writer.IsOpen());
+        const int js = writer.AddSignal("PSM1/measured_js", {"position[0]", "position[1]", "position[2]"});
+        CPPUNIT_ASSERT_EQUAL(0, js);
+        double values[3];
+        for (size_t i = 0; i < 350; ++i) {
+            for (size_t s = 0; s < 3; ++s) {
+                values[s] = Value(i, s);
+            }
+            CPPUNIT_ASSERT(writer.Append(js, startTime + 0.001 * i, values));
+            // signal added while recording
+            if (i == 199) {
+                CPPUNIT_ASSERT_EQUAL(1, writer.AddSignal("PSM1/jaw/measured_js", {"position[0]"}));
+            }
+            if (i >= 200) {
+                values[0] = -Value(i, 0);
+                CPPUNIT_ASSERT(writer.Append(1, startTime + 0.001 * i, values));
+            }
+        }
+        CPPUNIT_ASSERT(!writer.Append(2, startTime, values));
+        CPPUNIT_ASSERT(writer.Close());
+        CPPUNIT_ASSERT(!writer.IsOpen());
+        const mtsIntuitiveResearchKitRecordWriter::Statistics statistics = writer.GetStatistics();
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(500), statistics.NumberOfSamples);
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), statistics.NumberOfDroppedSamples);
+        // 3 full and 1 partial for first signal, 1 full and 1 partial for second
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(6), statistics.NumberOfChunks);
+    }
+
+    mtsIntuitiveResearchKitRecordReader reader;
+    CPPUNIT_ASSERT(!reader.Open(FileName("missing")));
+    CPPUNIT_ASSERT(reader.Open(fileName));
+    CPPUNIT_ASSERT(reader.IsIndexed());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), reader.NumberOfSignals());
+    CPPUNIT_ASSERT_EQUAL(0, reader.FindSignal("PSM1/measured_js"));
+    CPPUNIT_ASSERT_EQUAL(1, reader.FindSignal("PSM1/jaw/measured_js"));
+    CPPUNIT_ASSERT_EQUAL(-1, reader.FindSignal("PSM2/measured_js"));
+    CPPUNIT_ASSERT_EQUAL(std::string("position[2]"), reader.Signal(0).ScalarNames[2]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(350), reader.NumberOfSamples(0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(150), reader.NumberOfSamples(1));
+
+    double first, last;
+    CPPUNIT_ASSERT(reader.TimeRange(1, first, last));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(startTime + 0.2, first, 1.0e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(startTime + 0.349, last, 1.0e-6);
+
+    // all samples
+    std::vector<double> times, values;
+    CPPUNIT_ASSERT(reader.TimeRange(0, first, last));
+    CPPUNIT_ASSERT_EQUAL(350, reader.Read(0, first, last, times, values));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(350 * 3), values.size());
+    for (size_t i = 0; i < 350; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(startTime + 0.001 * i, times[i], 1.0e-6);
+        for (size_t s = 0; s < 3; ++s) {
+            CPPUNIT_ASSERT_EQUAL(Value(i, s), values[i * 3 + s]);
+        }
+    }
+
+    // range over two chunks
+    CPPUNIT_ASSERT_EQUAL(101, reader.Read(0, startTime + 0.1495, startTime + 0.2505, times, values));
+    CPPUNIT_ASSERT_EQUAL(Value(150, 0), values.front());
+    CPPUNIT_ASSERT_EQUAL(Value(250, 0), values[100 * 3]);
+    CPPUNIT_ASSERT_EQUAL(50, reader.Read(1, startTime + 0.3, startTime + 1.0, times, values));
+    CPPUNIT_ASSERT_EQUAL(-Value(300, 0), values.front());
+
+    // outside recorded range
+    CPPUNIT_ASSERT_EQUAL(0, reader.Read(0, startTime - 1.0, startTime - 0.5, times, values));
+    CPPUNIT_ASSERT_EQUAL(0, reader.Read(0, startTime + 1.0, startTime + 2.0, times, values));
+
+    reader.Close();
+    std::remove(fileName.c_str());
+}
+
+void mtsIntuitiveResearchKitRecordFileTest::TestRecovery(void)
+{
+    const std::string fileName = FileName("recovery");
+    const std::string copyName = FileName("recovery-copy");
+    {
+        mtsIntuitiveResearchKitRecordWriter writer;
+        CPPUNIT_ASSERT(writer.Open(fileName, 100, 4));
+        const int signal = writer.AddSignal("MTML/measured_js", {"position[0]", "position[1]", "position[2]"});
+        double values[3];
+        for (size_t i = 0; i < 250; ++i) {
+            for (size_t s = 0; s < 3; ++s) {
+                values[s] = Value(i, s);
+            }
+            CPPUNIT_ASSERT(writer.Append(signal, 0.001 * i, values));
+        }
+        // wait for the 2 full chunks, partial chunk is only written on close
+        for (size_t attempt = 0;
+             (writer.GetStatistics().NumberOfChunks < 2) && (attempt < 500);
+             ++attempt) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), writer.GetStatistics().NumberOfChunks);
+
+        // copy of the file as if the process had crashed
+        std::ifstream input(fileName.c_str(), std::ios::binary);
+        std::ofstream output(copyName.c_str(), std::ios::binary);
+        output << input.rdbuf();
+    }
+
+    mtsIntuitiveResearchKitRecordReader reader;
+    CPPUNIT_ASSERT(reader.Open(copyName));
+    CPPUNIT_ASSERT(!reader.IsIndexed());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), reader.NumberOfSignals());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(200), reader.NumberOfSamples(0));
+    std::vector<double> times, values;
+    CPPUNIT_ASSERT_EQUAL(200, reader.Read(0, 0.0, 1.0, times, values));
+    for (size_t i = 0; i < 200; ++i) {
+        CPPUNIT_ASSERT_EQUAL(Value(i, 1), values[i * 3 + 1]);
+    }
+
+    // original file was closed properly and has all samples
+    CPPUNIT_ASSERT(reader.Open(fileName));
+    CPPUNIT_ASSERT(reader.IsIndexed());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(250), reader.NumberOfSamples(0));
+
+    reader.Close();
+    std::remove(fileName.c_str());
+    std::remove(copyName.c_str());
+}
+
+void mtsIntuitiveResearchKitRecordFileTest::TestBenchmark(void)
+{
+    // about the size of a PSM state: measured and setpoint js, cp, cv...
+    const size_t numberOfSamples = 20000;
+    const size_t numberOfScalars = 40;
+    const std::string fileName = FileName("benchmark");
+
+    mtsIntuitiveResearchKitRecordWriter writer;
+    // enough buffers to not depend on the background thread speed
+    CPPUNIT_ASSERT(writer.Open(fileName, 1024, 24));
+    std::vector<std::string> names(numberOfScalars);
+    for (size_t s = 0; s < numberOfScalars; ++s) {
+        names[s] = "scalar[" + std::to_string(s) + "]";
+    }
+    const int signal = writer.AddSignal("PSM1/state", names);
+
+    std::vector<double> values(numberOfScalars);
+    double total = 0.0, maximum = 0.0;
+    for (size_t i = 0; i < numberOfSamples; ++i) {
+        // half smooth signals, half constant (e.g. setpoints while idle)
+        for (size_t s = 0; s < numberOfScalars; ++s) {
+            values[s] = (s % 2) ? 0.25 * s : std::sin(0.001 * i + s);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        writer.Append(signal, 0.001 * i, values.data());
+        const double elapsed =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        total += elapsed;
+        maximum = std::max(maximum, elapsed);
+    }
+    CPPUNIT_ASSERT(writer.Close());
+    const mtsIntuitiveResearchKitRecordWriter::Statistics statistics = writer.GetStatistics();
+
+    const double raw = static_cast<double>((numberOfScalars + 1) * sizeof(double));
+    const double stored = static_cast<double>(statistics.NumberOfBytes) / numberOfSamples;
+    sawIntuitiveResearchKitTests::BenchmarkOutput() << std::endl << "Recorder append (us):"
+              << " mean " << std::setw(8) << std::fixed << std::setprecision(3)
+              << total / numberOfSamples
+              << " max " << maximum
+              << ", bytes per sample " << stored << " (raw " << raw << ")" << std::endl;
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(numberOfSamples), statistics.NumberOfSamples);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), statistics.NumberOfDroppedSamples);
+    CPPUNIT_ASSERT(stored < raw);
+
+    mtsIntuitiveResearchKitRecordReader reader;
+    CPPUNIT_ASSERT(reader.Open(fileName));
+    CPPUNIT_ASSERT_EQUAL(numberOfSamples, reader.NumberOfSamples(0));
+    reader.Close();
+    std::remove(fileName.c_str());
+}
@@ -0,0 +1,59 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-08
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordWriter.h>
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordReader.h>
+
+class mtsIntuitiveResearchKitRecordFileTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsIntuitiveResearchKitRecordFileTest);
+    {
+        CPPUNIT_TEST(TestChunk);
+        CPPUNIT_TEST(TestRoundTrip);
+        CPPUNIT_TEST(TestRecovery);
+        CPPUNIT_TEST(TestBenchmark);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // chunk encoding is lossless and constant values use one byte
+    void TestChunk(void);
+
+    // full chunks, partial chunk and signals added while recording
+    void TestRoundTrip(void);
+
+    // file not closed, reader scans the records
+    void TestRecovery(void);
+
+    // append latency and file size per sample
+    void TestBenchmark(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsIntuitiveResearchKitRecordFileTest);
@@ -0,0 +1,170 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitRefreshRateTest.h"
+
+#include <vector>
+
+typedef mtsIntuitiveResearchKitRefreshRate RefreshRate;
+
+namespace {
+    struct Frame {
+        std::vector<double> mTranslation = {0.0, 0.0, 0.0};
+        std::vector<double> mRotation = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+        const std::vector<double> & Translation(void) const { return mTranslation; }
+        const std::vector<double> & Rotation(void) const { return mRotation; }
+    };
+
+    // same interface as mtsIntuitiveResearchKitSeqLockOnDemand
+    struct Snapshot {
+        typedef int DataType;
+        mutable bool Requested = false;
+        unsigned int Writes = 0;
+        DataType Data = 0;
+        void Request(void) const { Requested = true; }
+        unsigned int Sequence(void) const { return Writes; }
+        bool Read(DataType & data) const { data = Data; return true; }
+        // writer side
+        void Write(const DataType data) {
+            if (Requested) {
+                Requested = false;
+                Data = data;
+                ++Writes;
+            }
+        }
+    };
+}
+
+void mtsIntuitiveResearchKitRefreshRateTest::TestPeriod(void)
+{
+    RefreshRate refresh(0.05, 4.0, 1.0, 2.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.05, refresh.Period(RefreshRate::REFRESH_FOCUSED), 1.0e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, refresh.Period(RefreshRate::REFRESH_UNFOCUSED), 1.0e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, refresh.Period(RefreshRate::REFRESH_MINIMIZED), 1.0e-12);
+
+    // slow widgets are not made faster
+    RefreshRate slow(2.0, 0.5, 1.0, 2.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, slow.Period(RefreshRate::REFRESH_UNFOCUSED), 1.0e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, slow.Period(RefreshRate::REFRESH_MINIMIZED), 1.0e-12);
+}
+
+void mtsIntuitiveResearchKitRefreshRateTest::TestSetVisibility(void)
+{
+    RefreshRate refresh(0.05, 4.0, 1.0, 2.0);
+    CPPUNIT_ASSERT_EQUAL(RefreshRate::REFRESH_FOCUSED, refresh.Visibility());
+    CPPUNIT_ASSERT(!refresh.SetVisibility(RefreshRate::REFRESH_FOCUSED));
+    CPPUNIT_ASSERT(refresh.SetVisibility(RefreshRate::REFRESH_UNFOCUSED));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, refresh.CurrentPeriod(), 1.0e-12);
+    CPPUNIT_ASSERT(!refresh.SetVisibility(RefreshRate::REFRESH_UNFOCUSED));
+    CPPUNIT_ASSERT(refresh.SetVisibility(RefreshRate::REFRESH_MINIMIZED));
+    CPPUNIT_ASSERT(refresh.SetVisibility(RefreshRate::REFRESH_FOCUSED));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.05, refresh.CurrentPeriod(), 1.0e-12);
+
+    // no change if unfocused factor is 1
+    RefreshRate constant(0.05, 1.0, 0.01, 2.0);
+    CPPUNIT_ASSERT(!constant.SetVisibility(RefreshRate::REFRESH_UNFOCUSED));
+    CPPUNIT_ASSERT(!constant.SetVisibility(RefreshRate::REFRESH_MINIMIZED));
+}
+
+void mtsIntuitiveResearchKitRefreshRateTest::TestLoad(void)
+{
+    RefreshRate refresh(0.05, 4.0, 1.0, 2.0);
+    // first update only starts the interval, counts before are ignored
+    refresh.AddReads(100);
+    CPPUNIT_ASSERT(!refresh.UpdateLoad(10.0));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, refresh.ReadsPerSecond(), 1.0e-12);
+
+    for (size_t tick = 0; tick < 40; ++tick) {
+        refresh.AddReads(3);
+        refresh.AddSnapshots();
+        CPPUNIT_ASSERT(!refresh.UpdateLoad(10.0 + tick * 0.05));
+    }
+    CPPUNIT_ASSERT(refresh.UpdateLoad(12.0));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(60.0, refresh.ReadsPerSecond(), 1.0e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(20.0, refresh.SnapshotsPerSecond(), 1.0e-9);
+
+    // nothing requested
+    CPPUNIT_ASSERT(!refresh.UpdateLoad(13.0));
+    CPPUNIT_ASSERT(refresh.UpdateLoad(14.0));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, refresh.ReadsPerSecond(), 1.0e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, refresh.SnapshotsPerSecond(), 1.0e-12);
+}
+
+void mtsIntuitiveResearchKitRefreshRateTest::TestChanged(void)
+{
+    const std::vector<double> previous = {0.1, 0.2, 0.3};
+    std::vector<double> current = previous;
+    CPPUNIT_ASSERT(!RefreshRate::Changed(previous, current, 1.0e-5));
+
+    current[2] += 0.5e-5;
+    CPPUNIT_ASSERT(!RefreshRate::Changed(previous, current, 1.0e-5));
+
+    current[1] -= 2.0e-5;
+    CPPUNIT_ASSERT(RefreshRate::Changed(previous, current, 1.0e-5));
+
+    current = previous;
+    current.push_back(0.0);
+    CPPUNIT_ASSERT(RefreshRate::Changed(previous, current, 1.0e-5));
+}
+
+void mtsIntuitiveResearchKitRefreshRateTest::TestChangedFrame(void)
+{
+    const Frame previous;
+    Frame current;
+    CPPUNIT_ASSERT(!RefreshRate::ChangedFrame(previous, current, 1.0e-5));
+
+    current.mTranslation[0] = 2.0e-5;
+    CPPUNIT_ASSERT(RefreshRate::ChangedFrame(previous, current, 1.0e-5));
+
+    current = previous;
+    current.mRotation[4] = 1.0 - 2.0e-5;
+    CPPUNIT_ASSERT(RefreshRate::ChangedFrame(previous, current, 1.0e-5));
+}
+
+void mtsIntuitiveResearchKitRefreshRateTest::TestReadSnapshot(void)
+{
+    RefreshRate refresh(0.05, 4.0, 1.0, 2.0);
+    Snapshot snapshot;
+    unsigned int sequence = snapshot.Sequence();
+    int data = -1;
+
+    // writer only writes after a request
+    snapshot.Write(1);
+    CPPUNIT_ASSERT_EQUAL(0u, snapshot.Sequence());
+    CPPUNIT_ASSERT(!refresh.ReadSnapshot(snapshot, sequence, data));
+    CPPUNIT_ASSERT(snapshot.Requested);
+    CPPUNIT_ASSERT_EQUAL(-1, data);
+
+    // data requested on previous refresh
+    snapshot.Write(2);
+    snapshot.Write(3);
+    CPPUNIT_ASSERT(refresh.ReadSnapshot(snapshot, sequence, data));
+    CPPUNIT_ASSERT_EQUAL(2, data);
+    CPPUNIT_ASSERT_EQUAL(1u, sequence);
+
+    // nothing written since
+    CPPUNIT_ASSERT(!refresh.ReadSnapshot(snapshot, sequence, data));
+
+    // one snapshot over the load interval
+    refresh.UpdateLoad(0.0);
+    snapshot.Write(4);
+    CPPUNIT_ASSERT(refresh.ReadSnapshot(snapshot, sequence, data));
+    CPPUNIT_ASSERT(refresh.UpdateLoad(2.0));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, refresh.SnapshotsPerSecond(), 1.0e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, refresh.ReadsPerSecond(), 1.0e-12);
+}
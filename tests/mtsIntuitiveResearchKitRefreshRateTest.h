@@ -0,0 +1,66 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRefreshRate.h>
+
+class mtsIntuitiveResearchKitRefreshRateTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsIntuitiveResearchKitRefreshRateTest);
+    {
+        CPPUNIT_TEST(TestPeriod);
+        CPPUNIT_TEST(TestSetVisibility);
+        CPPUNIT_TEST(TestLoad);
+        CPPUNIT_TEST(TestChanged);
+        CPPUNIT_TEST(TestChangedFrame);
+        CPPUNIT_TEST(TestReadSnapshot);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // period based on visibility, never faster than nominal
+    void TestPeriod(void);
+
+    // period change reported only when needed
+    void TestSetVisibility(void);
+
+    // reads and snapshots per second over load interval
+    void TestLoad(void);
+
+    // changes compared to precision
+    void TestChanged(void);
+
+    // translation and rotation compared
+    void TestChangedFrame(void);
+
+    // snapshots requested, read only when new and counted
+    void TestReadSnapshot(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsIntuitiveResearchKitRefreshRateTest);
@@ -0,0 +1,113 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-12
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitReplayTrackTest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitRecordWriter.h>
+
+void mtsIntuitiveResearchKitReplayTrackTest::TestSeek(void)
+{
+    const std::string fileName = "mtsIntuitiveResearchKitReplayTrackTest-" + std::to_string(getpid()) + ".dvrk";
+    const size_t numberOfSamples = 1000;
+    {
+        // small chunks so windows span multiple chunks
+        mtsIntuitiveResearchKitRecordWriter writer;
+        CPPUNIT_ASSERT(writer.Open(fileName, 64, 32));
+        const int signal = writer.AddSignal("PSM1-PID/Controller/measured_js", {"position[0]", "position[1]"});
+        CPPUNIT_ASSERT(signal >= 0);
+        double values[2];
+        for (size_t i = 0; i < numberOfSamples; ++i) {
+            values[0] = static_cast<double>(i);
+            values[1] = -static_cast<double>(i);
+            // 2 ms period
+            CPPUNIT_ASSERT(writer.Append(signal, 10.0 + 0.002 * i, values));
+        }
+        writer.Close();
+    }
+
+    mtsIntuitiveResearchKitRecordReader reader;
+    CPPUNIT_ASSERT(reader.Open(fileName));
+
+    mtsIntuitiveResearchKitReplayTrack track;
+    CPPUNIT_ASSERT(!track.Open(reader, "PSM1-PID/Controller/setpoint_js"));
+    CPPUNIT_ASSERT(!track.IsOpen());
+    CPPUNIT_ASSERT(track.Open(reader, "PSM1-PID/Controller/measured_js", 0.1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), track.NumberOfScalars());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, track.StartTime(), 1.0e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0 + 0.002 * (numberOfSamples - 1), track.EndTime(), 1.0e-9);
+
+    // before first sample
+    CPPUNIT_ASSERT(track.Seek(9.0) == nullptr);
+
+    // step at 1 ms, each sample is returned twice, no sample is skipped
+    const double * values = nullptr;
+    size_t lastSample = 0;
+    for (size_t step = 0; step < 2 * numberOfSamples; ++step) {
+        values = track.Seek(10.0 + 0.001 * step + 1.0e-6);
+        CPPUNIT_ASSERT(values != nullptr);
+        const size_t sample = step / 2;
+        CPPUNIT_ASSERT_EQUAL(static_cast<double>(sample), values[0]);
+        CPPUNIT_ASSERT_EQUAL(-static_cast<double>(sample), values[1]);
+        CPPUNIT_ASSERT(sample >= lastSample);
+        lastSample = sample;
+    }
+
+    // after last sample, hold last value
+    values = track.Seek(100.0);
+    CPPUNIT_ASSERT(values != nullptr);
+    CPPUNIT_ASSERT_EQUAL(static_cast<double>(numberOfSamples - 1), values[0]);
+
+    // jump ahead larger than window
+    CPPUNIT_ASSERT(track.Open(reader, "PSM1-PID/Controller/measured_js", 0.1));
+    values = track.Seek(11.0 + 1.0e-6);
+    CPPUNIT_ASSERT(values != nullptr);
+    CPPUNIT_ASSERT_EQUAL(500.0, values[0]);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(11.0, track.Time(), 1.0e-9);
+
+    reader.Close();
+    std::remove(fileName.c_str());
+}
+
+void mtsIntuitiveResearchKitReplayTrackTest::TestComparison(void)
+{
+    mtsIntuitiveResearchKitReplayComparison comparison;
+    comparison.Reset(0.01);
+    CPPUNIT_ASSERT_EQUAL(0.0, comparison.RMSError());
+
+    const double expected[3] = {1.0, 2.0, 3.0};
+    const double close[3] = {1.005, 2.0, 3.0};
+    const double far[3] = {1.0, 2.0, 3.5};
+    CPPUNIT_ASSERT(comparison.Add(expected, expected, 3));
+    CPPUNIT_ASSERT(comparison.Add(expected, close, 3));
+    CPPUNIT_ASSERT(!comparison.Add(expected, far, 3));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), comparison.NumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), comparison.NumberOfMismatches());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, comparison.MaximumError(), 1.0e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(std::sqrt((0.005 * 0.005 + 0.5 * 0.5) / 9.0),
+                                 comparison.RMSError(), 1.0e-12);
+
+    comparison.Reset(0.01);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), comparison.NumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL(0.0, comparison.MaximumError());
+}
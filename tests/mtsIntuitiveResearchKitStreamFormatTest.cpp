@@ -0,0 +1,225 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-01
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#include "mtsIntuitiveResearchKitStreamFormatTest.h"
+
+#include <vector>
+
+namespace {
+    typedef mtsIntuitiveResearchKitStreamFormat Format;
+
+    const double Tolerance = 1.0e-12;
+
+    uint32_t AllFields(void) {
+        return (1 << Format::NUMBER_OF_FIELDS) - 1;
+    }
+
+    void FillSample(Format::Sample & sample, const uint32_t index) {
+        sample.Index = index;
+        sample.Timestamp = 0.001 * index;
+        sample.measured_js.Position().SetSize(7);
+        sample.measured_js.Velocity().SetSize(7);
+        sample.measured_js.Effort().SetSize(7);
+        for (size_t joint = 0; joint < 7; ++joint) {
+            sample.measured_js.Position().Element(joint) = 0.1 * joint + index;
+            sample.measured_js.Velocity().Element(joint) = -0.2 * joint;
+            sample.measured_js.Effort().Element(joint) = 0.3 * joint;
+        }
+        sample.measured_js.SetValid(true);
+        // positions only
+        sample.setpoint_js.Position().SetSize(6);
+        sample.setpoint_js.Position().SetAll(0.5);
+        sample.setpoint_js.Velocity().SetSize(0);
+        sample.setpoint_js.Effort().SetSize(0);
+        sample.setpoint_js.SetValid(true);
+        sample.measured_cp.Position().Translation().Assign(0.1, -0.2, 0.3);
+        sample.measured_cp.Position().Rotation().From(vctAxAnRot3(vct3(0.0, 0.0, 1.0), 0.3));
+        sample.measured_cp.SetValid(true);
+        sample.setpoint_cp.Position().Translation().Assign(-0.1, 0.2, -0.3);
+        sample.setpoint_cp.Position().Rotation().From(vctAxAnRot3(vct3(1.0, 0.0, 0.0), -0.7));
+        sample.setpoint_cp.SetValid(true);
+        sample.measured_cv.VelocityLinear().Assign(0.01, 0.02, 0.03);
+        sample.measured_cv.VelocityAngular().Assign(-0.1, -0.2, -0.3);
+        sample.measured_cv.SetValid(false);
+        sample.body_measured_cf.Force().Assign(1.0, 2.0, 3.0, 0.1, 0.2, 0.3);
+        sample.body_measured_cf.SetValid(true);
+        sample.spatial_measured_cf.Force().Assign(-1.0, -2.0, -3.0, -0.1, -0.2, -0.3);
+        sample.spatial_measured_cf.SetValid(true);
+        sample.gripper_measured_js.Position().SetSize(1);
+        sample.gripper_measured_js.Position().Element(0) = 0.7;
+        sample.gripper_measured_js.Velocity().SetSize(0);
+        sample.gripper_measured_js.Effort().SetSize(0);
+        sample.gripper_measured_js.SetValid(true);
+        sample.operating_state.State() = prmOperatingState::ENABLED;
+        sample.operating_state.IsHomed() = true;
+        sample.operating_state.IsBusy() = false;
+        sample.operating_state.SetValid(true);
+        sample.buttons = Format::ButtonCoag;
+        sample.teleop_state.following = true;
+        sample.teleop_state.clutched = false;
+        sample.teleop_state.operator_present = true;
+        sample.teleop_state.scale = 0.25;
+        sample.teleop_state.alignment_offset.From(vctAxAnRot3(vct3(0.0, 1.0, 0.0), 0.05));
+        sample.teleop_state.Valid = true;
+    }
+
+    void CheckJointState(const prmStateJoint & expected, const prmStateJoint & result) {
+        CPPUNIT_ASSERT(expected.Position().Equal(result.Position()));
+        CPPUNIT_ASSERT(expected.Velocity().Equal(result.Velocity()));
+        CPPUNIT_ASSERT(expected.Effort().Equal(result.Effort()));
+        CPPUNIT_ASSERT_EQUAL(expected.Valid(), result.Valid());
+    }
+}
+
+void mtsIntuitiveResearchKitStreamFormatTest::TestFieldNames(void)
+{
+    Format::FieldType field;
+    for (int index = 0; index < Format::NUMBER_OF_FIELDS; ++index) {
+        const Format::FieldType expected = static_cast<Format::FieldType>(index);
+        CPPUNIT_ASSERT(Format::FieldFromString(Format::FieldToString(expected), field));
+        CPPUNIT_ASSERT_EQUAL(expected, field);
+    }
+    CPPUNIT_ASSERT(Format::FieldFromString("body/measured_cf", field));
+    CPPUNIT_ASSERT_EQUAL(Format::BODY_MEASURED_CF, field);
+    CPPUNIT_ASSERT(!Format::FieldFromString("measured_cf", field));
+}
+
+void mtsIntuitiveResearchKitStreamFormatTest::TestHeader(void)
+{
+    char buffer[Format::HeaderSize];
+    Format::Header header, result;
+    header.NumberOfSamples = 3;
+    header.Sequence = 1234;
+    header.FieldMask = AllFields();
+    header.Timestamp = 12.5;
+    header.Decimation = 4;
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0),
+                         Format::EncodeHeader(header, buffer, Format::HeaderSize - 1));
+    CPPUNIT_ASSERT_EQUAL(Format::HeaderSize,
+                         Format::EncodeHeader(header, buffer, Format::HeaderSize));
+    CPPUNIT_ASSERT(Format::DecodeHeader(buffer, Format::HeaderSize, result));
+    CPPUNIT_ASSERT_EQUAL(header.NumberOfSamples, result.NumberOfSamples);
+    CPPUNIT_ASSERT_EQUAL(header.Sequence, result.Sequence);
+    CPPUNIT_ASSERT_EQUAL(header.FieldMask, result.FieldMask);
+    CPPUNIT_ASSERT_EQUAL(header.Timestamp, result.Timestamp);
+    CPPUNIT_ASSERT_EQUAL(header.Decimation, result.Decimation);
+
+    // magic number is "dVRS" on the wire
+    CPPUNIT_ASSERT_EQUAL('d', buffer[0]);
+    CPPUNIT_ASSERT_EQUAL('S', buffer[3]);
+    CPPUNIT_ASSERT(!Format::DecodeHeader(buffer, Format::HeaderSize - 1, result));
+
+    // version 1 datagrams are still accepted, newer versions are not
+    buffer[4] = 1;
+    CPPUNIT_ASSERT(Format::DecodeHeader(buffer, Format::HeaderSize, result));
+    buffer[4] = static_cast<char>(Format::Version + 1);
+    CPPUNIT_ASSERT(!Format::DecodeHeader(buffer, Format::HeaderSize, result));
+    buffer[4] = static_cast<char>(Format::Version);
+
+    buffer[0] = 'x';
+    CPPUNIT_ASSERT(!Format::DecodeHeader(buffer, Format::HeaderSize, result));
+}
+
+void mtsIntuitiveResearchKitStreamFormatTest::TestSampleRoundTrip(void)
+{
+    Format::Sample sample, result;
+    FillSample(sample, 42);
+    std::vector<char> buffer(Format::MaximumSampleSize(AllFields(), 7));
+
+    // setpoint and gripper have less than 7 joints and no velocity/effort
+    const size_t size = Format::EncodeSample(sample, AllFields(), buffer.data(), buffer.size());
+    CPPUNIT_ASSERT(size > Format::SampleHeaderSize);
+    CPPUNIT_ASSERT(size < buffer.size());
+    CPPUNIT_ASSERT_EQUAL(size, Format::DecodeSample(buffer.data(), size, AllFields(), result));
+    CPPUNIT_ASSERT_EQUAL(sample.Index, result.Index);
+    CPPUNIT_ASSERT_EQUAL(sample.Timestamp, result.Timestamp);
+    CheckJointState(sample.measured_js, result.measured_js);
+    CheckJointState(sample.setpoint_js, result.setpoint_js);
+    CheckJointState(sample.gripper_measured_js, result.gripper_measured_js);
+    CPPUNIT_ASSERT(sample.measured_cp.Position().AlmostEqual(result.measured_cp.Position(), Tolerance));
+    CPPUNIT_ASSERT(result.measured_cp.Valid());
+    CPPUNIT_ASSERT(sample.setpoint_cp.Position().AlmostEqual(result.setpoint_cp.Position(), Tolerance));
+    CPPUNIT_ASSERT(sample.measured_cv.VelocityLinear().Equal(result.measured_cv.VelocityLinear()));
+    CPPUNIT_ASSERT(sample.measured_cv.VelocityAngular().Equal(result.measured_cv.VelocityAngular()));
+    CPPUNIT_ASSERT(!result.measured_cv.Valid());
+    CPPUNIT_ASSERT(sample.body_measured_cf.Force().Equal(result.body_measured_cf.Force()));
+    CPPUNIT_ASSERT(sample.spatial_measured_cf.Force().Equal(result.spatial_measured_cf.Force()));
+    CPPUNIT_ASSERT_EQUAL(prmOperatingState::ENABLED, result.operating_state.State());
+    CPPUNIT_ASSERT(result.operating_state.IsHomed());
+    CPPUNIT_ASSERT(!result.operating_state.IsBusy());
+    CPPUNIT_ASSERT_EQUAL(Format::ButtonCoag, result.buttons);
+    CPPUNIT_ASSERT(result.teleop_state.Valid);
+    CPPUNIT_ASSERT(result.teleop_state.following);
+    CPPUNIT_ASSERT(!result.teleop_state.clutched);
+    CPPUNIT_ASSERT(result.teleop_state.operator_present);
+    CPPUNIT_ASSERT_EQUAL(0.25, result.teleop_state.scale);
+    CPPUNIT_ASSERT(sample.teleop_state.alignment_offset.AlmostEqual(result.teleop_state.alignment_offset, Tolerance));
+
+    // buffer too small
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0),
+                         Format::EncodeSample(sample, AllFields(), buffer.data(), size - 1));
+    // truncated
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0),
+                         Format::DecodeSample(buffer.data(), size - 1, AllFields(), result));
+
+    // single field
+    const uint32_t mask = (1 << Format::MEASURED_CP);
+    const size_t cpSize = Format::EncodeSample(sample, mask, buffer.data(), buffer.size());
+    CPPUNIT_ASSERT_EQUAL(Format::SampleHeaderSize + 7 * sizeof(double), cpSize);
+    CPPUNIT_ASSERT_EQUAL(Format::MaximumSampleSize(mask, 7), cpSize);
+    Format::Sample cpOnly;
+    CPPUNIT_ASSERT_EQUAL(cpSize, Format::DecodeSample(buffer.data(), cpSize, mask, cpOnly));
+    CPPUNIT_ASSERT(sample.measured_cp.Position().AlmostEqual(cpOnly.measured_cp.Position(), Tolerance));
+}
+
+void mtsIntuitiveResearchKitStreamFormatTest::TestBatch(void)
+{
+    const uint32_t mask = (1 << Format::MEASURED_JS) | (1 << Format::OPERATING_STATE);
+    const size_t batch = 4;
+    std::vector<char> buffer(Format::HeaderSize + batch * Format::MaximumSampleSize(mask, 7));
+
+    // encode like the streamer, samples then header
+    Format::Sample sample;
+    size_t size = Format::HeaderSize;
+    for (uint32_t index = 0; index < batch; ++index) {
+        FillSample(sample, index);
+        size += Format::EncodeSample(sample, mask, buffer.data() + size, buffer.size() - size);
+    }
+    Format::Header header;
+    header.NumberOfSamples = batch;
+    header.FieldMask = mask;
+    Format::EncodeHeader(header, buffer.data(), buffer.size());
+    CPPUNIT_ASSERT_EQUAL(buffer.size(), size);
+
+    // decode like a receiver
+    Format::Header received;
+    CPPUNIT_ASSERT(Format::DecodeHeader(buffer.data(), size, received));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint16_t>(batch), received.NumberOfSamples);
+    size_t offset = Format::HeaderSize;
+    Format::Sample result;
+    for (uint32_t index = 0; index < received.NumberOfSamples; ++index) {
+        const size_t sampleSize = Format::DecodeSample(buffer.data() + offset, size - offset,
+                                                       received.FieldMask, result);
+        CPPUNIT_ASSERT(sampleSize > 0);
+        CPPUNIT_ASSERT_EQUAL(index, result.Index);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1 + index, result.measured_js.Position().Element(1), Tolerance);
+        offset += sampleSize;
+    }
+    CPPUNIT_ASSERT_EQUAL(size, offset);
+}
@@ -0,0 +1,58 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-01
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitStreamFormat.h>
+
+class mtsIntuitiveResearchKitStreamFormatTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsIntuitiveResearchKitStreamFormatTest);
+    {
+        CPPUNIT_TEST(TestFieldNames);
+        CPPUNIT_TEST(TestHeader);
+        CPPUNIT_TEST(TestSampleRoundTrip);
+        CPPUNIT_TEST(TestBatch);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // field names match arm read commands
+    void TestFieldNames(void);
+
+    // header round trip and invalid headers
+    void TestHeader(void);
+
+    // all fields, only some fields and truncated buffers
+    void TestSampleRoundTrip(void);
+
+    // multiple samples in a datagram
+    void TestBatch(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsIntuitiveResearchKitStreamFormatTest);
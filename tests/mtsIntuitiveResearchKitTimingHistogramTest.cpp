@@ -0,0 +1,116 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-19
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitTimingHistogramTest.h"
+
+#include <cmath>
+#include <cmath>
+
+namespace {
+    const double Resolution = 1.0e-6;
+    const double Tolerance = 1.0e-12;
+}
+
+void mtsIntuitiveResearchKitTimingHistogramTest::TestEmpty(void)
+{
+    mtsIntuitiveResearchKitTimingHistogram histogram;
+    histogram.Configure(Resolution, 0.01);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), histogram.Count());
+    CPPUNIT_ASSERT_EQUAL(0.0, histogram.Minimum());
+    CPPUNIT_ASSERT_EQUAL(0.0, histogram.Maximum());
+    CPPUNIT_ASSERT_EQUAL(0.0, histogram.Mean());
+    CPPUNIT_ASSERT_EQUAL(0.0, histogram.Percentile(99.0));
+}
+
+void mtsIntuitiveResearchKitTimingHistogramTest::TestPercentiles(void)
+{
+    mtsIntuitiveResearchKitTimingHistogram histogram;
+    histogram.Configure(Resolution, 0.01);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.01, histogram.Range(), Tolerance);
+
+    // 1 to 1000 microseconds
+    for (size_t index = 1; index <= 1000; ++index) {
+        histogram.Add(static_cast<double>(index) * Resolution);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1000), histogram.Count());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-6, histogram.Minimum(), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-3, histogram.Maximum(), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(500.5e-6, histogram.Mean(), 1.0e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(500.0e-6, histogram.Percentile(50.0), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(990.0e-6, histogram.Percentile(99.0), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(999.0e-6, histogram.Percentile(99.9), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-3, histogram.Percentile(100.0), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-6, histogram.Percentile(0.0), Tolerance);
+
+    // 1 ms period with rare 3 ms spikes, 1 in 500
+    histogram.Reset();
+    for (size_t index = 0; index < 10000; ++index) {
+        histogram.Add((index % 500 == 0) ? 3.0e-3 : 1.0e-3);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-3, histogram.Percentile(50.0), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-3, histogram.Percentile(99.0), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0e-3, histogram.Percentile(99.9), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0e-3, histogram.Maximum(), Tolerance);
+
+    // percentiles are upper edges of bins, never above the maximum
+    histogram.Configure(10.0 * Resolution, 0.01);
+    histogram.Add(1.5e-6);
+    histogram.Add(12.5e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0e-6, histogram.Percentile(50.0), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(12.5e-6, histogram.Percentile(99.0), Tolerance);
+}
+
+void mtsIntuitiveResearchKitTimingHistogramTest::TestOverflows(void)
+{
+    mtsIntuitiveResearchKitTimingHistogram histogram;
+    histogram.Configure(Resolution, 1.0e-3);
+    for (size_t index = 0; index < 98; ++index) {
+        histogram.Add(0.5e-3);
+    }
+    histogram.Add(2.0e-3);
+    histogram.Add(5.0e-3);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100), histogram.Count());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), histogram.Overflows());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5e-3, histogram.Percentile(98.0), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0e-3, histogram.Percentile(99.0), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0e-3, histogram.Maximum(), Tolerance);
+}
+
+void mtsIntuitiveResearchKitTimingHistogramTest::TestStatistic(void)
+{
+    mtsIntuitiveResearchKitTimingHistogram histogram;
+    histogram.Configure(Resolution, 0.01);
+    for (size_t index = 1; index <= 1000; ++index) {
+        histogram.Add(static_cast<double>(index) * Resolution);
+    }
+    double value = 0.0;
+    CPPUNIT_ASSERT(histogram.Statistic("p50", value));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(500.0e-6, value, Tolerance);
+    CPPUNIT_ASSERT(histogram.Statistic("p99.9", value));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(999.0e-6, value, Tolerance);
+    CPPUNIT_ASSERT(histogram.Statistic("max", value));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-3, value, Tolerance);
+    CPPUNIT_ASSERT(histogram.Statistic("min", value));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-6, value, Tolerance);
+    CPPUNIT_ASSERT(histogram.Statistic("mean", value));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(500.5e-6, value, 1.0e-9);
+    CPPUNIT_ASSERT(!histogram.Statistic("p", value));
+    CPPUNIT_ASSERT(!histogram.Statistic("p101", value));
+    CPPUNIT_ASSERT(!histogram.Statistic("p99x", value));
+    CPPUNIT_ASSERT(!histogram.Statistic("median", value));
+}
@@ -0,0 +1,58 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-19
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsIntuitiveResearchKitTimingHistogram.h>
+
+class mtsIntuitiveResearchKitTimingHistogramTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsIntuitiveResearchKitTimingHistogramTest);
+    {
+        CPPUNIT_TEST(TestEmpty);
+        CPPUNIT_TEST(TestPercentiles);
+        CPPUNIT_TEST(TestOverflows);
+        CPPUNIT_TEST(TestStatistic);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // no samples, all statistics are null
+    void TestEmpty(void);
+
+    // percentiles on uniform and skewed distributions
+    void TestPercentiles(void);
+
+    // values above the range only known through the maximum
+    void TestOverflows(void);
+
+    // statistics by name, used for budgets
+    void TestStatistic(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsIntuitiveResearchKitTimingHistogramTest);
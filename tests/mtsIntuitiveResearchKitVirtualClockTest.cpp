@@ -0,0 +1,69 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-14
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsIntuitiveResearchKitVirtualClockTest.h"
+
+void mtsIntuitiveResearchKitVirtualClockTest::TestAdvance(void)
+{
+    const double step = 1.0 / 1500.0;
+    mtsIntuitiveResearchKitVirtualClock clock;
+    clock.Reset(step, 10.0);
+    CPPUNIT_ASSERT_EQUAL(10.0, clock.Time());
+    CPPUNIT_ASSERT_EQUAL(step, clock.Step());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), clock.NumberOfSteps());
+
+    // one hour of steps, time is not accumulated so it doesn't drift
+    const size_t numberOfSteps = 3600 * 1500;
+    for (size_t index = 0; index < numberOfSteps; ++index) {
+        clock.Advance();
+    }
+    CPPUNIT_ASSERT_EQUAL(numberOfSteps, clock.NumberOfSteps());
+    CPPUNIT_ASSERT_EQUAL(10.0 + static_cast<double>(numberOfSteps) * step, clock.Time());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3610.0, clock.Time(), 1.0e-9);
+
+    // same steps after reset, same times
+    mtsIntuitiveResearchKitVirtualClock other;
+    other.Reset(step, 10.0);
+    clock.Reset(step, 10.0);
+    for (size_t index = 0; index < 1000; ++index) {
+        clock.Advance();
+        other.Advance();
+        CPPUNIT_ASSERT_EQUAL(clock.Time(), other.Time());
+    }
+}
+
+void mtsIntuitiveResearchKitVirtualClockTest::TestStepsFor(void)
+{
+    mtsIntuitiveResearchKitVirtualClock clock;
+    clock.Reset(0.001);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), clock.StepsFor(0.0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), clock.StepsFor(-1.0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), clock.StepsFor(0.0001));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1000), clock.StepsFor(1.0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1000), clock.StepsFor(1.0004));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1001), clock.StepsFor(1.0006));
+
+    // running for the computed steps reaches the duration
+    clock.Reset(1.0 / 1500.0, 2.0);
+    const size_t steps = clock.StepsFor(5.0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7500), steps);
+    for (size_t index = 0; index < steps; ++index) {
+        clock.Advance();
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, clock.Time(), 1.0e-12);
+}
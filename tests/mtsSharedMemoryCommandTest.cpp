@@ -0,0 +1,146 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-06
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsSharedMemoryCommandTest.h"
+#include "sawIntuitiveResearchKitTestsBenchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+    // unique arm name so tests can run in parallel
+    std::string ArmName(const std::string & test) {
+        return "test-" + test + "-" + std::to_string(getpid());
+    }
+}
+
+void mtsSharedMemoryCommandTest::TestCommands(void)
+{
+    CPPUNIT_ASSERT_EQUAL(std::string("/dvrk-PSM1-command"), mtsSharedMemoryCommand::RingName("PSM1"));
+
+    const std::string arm = ArmName("commands");
+    mtsSharedMemoryCommand mailbox, client;
+    mtsSharedMemoryCommand::Data data;
+    uint64_t index;
+
+    // client can't send before the arm creates the mailbox
+    CPPUNIT_ASSERT(!client.Open(arm));
+    CPPUNIT_ASSERT(!client.servo_jp(data.Values, 6));
+
+    CPPUNIT_ASSERT(mailbox.Create(arm, 4));
+    CPPUNIT_ASSERT(client.Open(arm));
+    CPPUNIT_ASSERT(client.Ring().IsWriter());
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(mtsSharedMemoryRing::NO_DATA), mailbox.Poll(index, data));
+
+    const double positions[6] = {0.1, -0.2, 0.3, -0.4, 0.5, -0.6};
+    CPPUNIT_ASSERT(client.servo_jp(positions, 6));
+    CPPUNIT_ASSERT(mailbox.Poll(index, data) > 0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), index);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(mtsSharedMemoryCommand::SERVO_JP), data.Type);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(6), data.NumberOfValues);
+    CPPUNIT_ASSERT(std::equal(positions, positions + 6, data.Values));
+    CPPUNIT_ASSERT(data.Time <= mtsSharedMemoryCommand::Now());
+
+    const double efforts[3] = {1.0, 2.0, 3.0};
+    CPPUNIT_ASSERT(client.servo_jf(efforts, 3));
+    CPPUNIT_ASSERT(mailbox.Poll(index, data) > 0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), index);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(mtsSharedMemoryCommand::SERVO_JF), data.Type);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(3), data.NumberOfValues);
+    CPPUNIT_ASSERT(std::equal(efforts, efforts + 3, data.Values));
+
+    const double translation[3] = {0.01, 0.02, -0.1};
+    const double quaternion[4] = {1.0, 0.0, 0.0, 0.0};
+    CPPUNIT_ASSERT(client.servo_cp(translation, quaternion));
+    CPPUNIT_ASSERT(mailbox.Poll(index, data) > 0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(mtsSharedMemoryCommand::SERVO_CP), data.Type);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(7), data.NumberOfValues);
+    CPPUNIT_ASSERT(std::equal(translation, translation + 3, data.Values));
+    CPPUNIT_ASSERT(std::equal(quaternion, quaternion + 4, data.Values + 3));
+
+    // too many values, nothing sent
+    double tooMany[mtsSharedMemoryCommand::MaximumNumberOfValues + 1] = {0.0};
+    CPPUNIT_ASSERT(!client.servo_jp(tooMany, mtsSharedMemoryCommand::MaximumNumberOfValues + 1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(3), mailbox.Ring().WriteCount());
+
+    // mailbox removed when the arm closes it
+    {
+        mtsSharedMemoryCommand temporary;
+        CPPUNIT_ASSERT(temporary.Create(ArmName("closed"), 4));
+    }
+    mtsSharedMemoryCommand other;
+    CPPUNIT_ASSERT(!other.Open(ArmName("closed")));
+}
+
+void mtsSharedMemoryCommandTest::TestLatency(void)
+{
+    const size_t numberOfCommands = 10000;
+    const std::string arm = ArmName("latency");
+    mtsSharedMemoryCommand mailbox, client;
+    CPPUNIT_ASSERT(mailbox.Create(arm, 4));
+    CPPUNIT_ASSERT(client.Open(arm));
+
+    // loopback thread plays the arm, polls as fast as possible and
+    // acknowledges each command so the client sends the next one
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> received(0);
+    std::atomic<size_t> outOfOrder(0);
+    double total = 0.0, maximum = 0.0;
+    std::thread loopback([&]() {
+            mtsSharedMemoryCommand::Data data;
+            uint64_t index;
+            while (!done) {
+                if ((mailbox.Poll(index, data) > 0)
+                    && (index >= received)) {
+                    const double latency = (mtsSharedMemoryCommand::Now() - data.Time) * 1.0e6;
+                    total += latency;
+                    maximum = std::max(maximum, latency);
+                    if ((index != received)
+                        || (data.Values[0] != static_cast<double>(index))) {
+                        outOfOrder++;
+                    }
+                    received = index + 1;
+                }
+                std::this_thread::yield();
+            }
+        });
+
+    double values[6] = {0.0};
+    for (size_t command = 0; command < numberOfCommands; ++command) {
+        values[0] = static_cast<double>(command);
+        CPPUNIT_ASSERT(client.servo_jp(values, 6));
+        while (received != command + 1) {
+            std::this_thread::yield();
+        }
+    }
+    done = true;
+    loopback.join();
+
+    sawIntuitiveResearchKitTests::BenchmarkOutput() << std::endl << "Shared memory command latency (us):"
+              << " mean " << std::setw(8) << std::fixed << std::setprecision(3)
+              << total / numberOfCommands
+              << " max " << maximum << std::endl;
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(numberOfCommands), static_cast<uint64_t>(received));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), static_cast<size_t>(outOfOrder));
+}
@@ -0,0 +1,50 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-06
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsSharedMemoryCommand.h>
+
+class mtsSharedMemoryCommandTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsSharedMemoryCommandTest);
+    {
+        CPPUNIT_TEST(TestCommands);
+        CPPUNIT_TEST(TestLatency);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // commands sent by the client are polled by the arm unchanged
+    void TestCommands(void);
+
+    // loopback latency between client and a thread polling the mailbox
+    void TestLatency(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsSharedMemoryCommandTest);
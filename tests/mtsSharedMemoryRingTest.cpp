@@ -0,0 +1,250 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-04
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#include "mtsSharedMemoryRingTest.h"
+#include "sawIntuitiveResearchKitTestsBenchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    // unique name so tests can run in parallel
+    std::string RingName(const std::string & test) {
+        return "/dvrk-test-" + test + "-" + std::to_string(getpid());
+    }
+
+    // payload filled with its index so readers can detect torn copies
+    const size_t PayloadSize = 32;
+
+    void FillPayload(uint64_t * payload, const uint64_t index) {
+        std::fill(payload, payload + PayloadSize, index);
+    }
+
+    bool CheckPayload(const uint64_t * payload, const uint64_t index) {
+        return std::all_of(payload, payload + PayloadSize,
+                           [index](const uint64_t value) { return value == index; });
+    }
+}
+
+void mtsSharedMemoryRingTest::TestWriteRead(void)
+{
+    const std::string name = RingName("write-read");
+    mtsSharedMemoryRing writer, reader;
+    CPPUNIT_ASSERT(writer.Create(name, 8, sizeof(uint64_t) * PayloadSize, "PSM1-Streamer"));
+    CPPUNIT_ASSERT(reader.Open(name));
+    CPPUNIT_ASSERT(!reader.IsWriter());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), reader.NumberOfSlots());
+    CPPUNIT_ASSERT(reader.MaximumDataSize() >= sizeof(uint64_t) * PayloadSize);
+    CPPUNIT_ASSERT_EQUAL(std::string("PSM1-Streamer"), reader.Source());
+
+    uint64_t payload[PayloadSize];
+    uint64_t index;
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(mtsSharedMemoryRing::NO_DATA),
+                         reader.ReadLatest(index, payload, sizeof(payload)));
+    for (uint64_t write = 0; write < 5; ++write) {
+        FillPayload(payload, write);
+        CPPUNIT_ASSERT(writer.Write(payload, sizeof(payload)));
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(5), reader.WriteCount());
+    for (uint64_t read = 0; read < 5; ++read) {
+        CPPUNIT_ASSERT_EQUAL(static_cast<int>(sizeof(payload)),
+                             reader.Read(read, payload, sizeof(payload)));
+        CPPUNIT_ASSERT(CheckPayload(payload, read));
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(mtsSharedMemoryRing::NO_DATA),
+                         reader.Read(5, payload, sizeof(payload)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(sizeof(payload)),
+                         reader.ReadLatest(index, payload, sizeof(payload)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(4), index);
+    CPPUNIT_ASSERT(CheckPayload(payload, 4));
+
+    // variable size and errors
+    CPPUNIT_ASSERT(writer.Write(payload, 3));
+    CPPUNIT_ASSERT_EQUAL(3, reader.Read(5, payload, sizeof(payload)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(mtsSharedMemoryRing::BUFFER_TOO_SMALL),
+                         reader.Read(5, payload, 2));
+    CPPUNIT_ASSERT(!writer.Write(payload, writer.MaximumDataSize() + 1));
+    CPPUNIT_ASSERT(!reader.Write(payload, 1));
+}
+
+void mtsSharedMemoryRingTest::TestOverrun(void)
+{
+    const std::string name = RingName("overrun");
+    mtsSharedMemoryRing writer, reader;
+    CPPUNIT_ASSERT(writer.Create(name, 4, sizeof(uint64_t) * PayloadSize));
+    CPPUNIT_ASSERT(reader.Open(name));
+
+    uint64_t payload[PayloadSize];
+    for (uint64_t write = 0; write < 10; ++write) {
+        FillPayload(payload, write);
+        writer.Write(payload, sizeof(payload));
+    }
+    // only the last 4 are still available
+    for (uint64_t read = 0; read < 10; ++read) {
+        const int result = reader.Read(read, payload, sizeof(payload));
+        if (read < 6) {
+            CPPUNIT_ASSERT_EQUAL(static_cast<int>(mtsSharedMemoryRing::OVERRUN), result);
+        } else {
+            CPPUNIT_ASSERT_EQUAL(static_cast<int>(sizeof(payload)), result);
+            CPPUNIT_ASSERT(CheckPayload(payload, read));
+        }
+    }
+}
+
+void mtsSharedMemoryRingTest::TestOpen(void)
+{
+    const std::string name = RingName("open");
+    mtsSharedMemoryRing reader;
+    CPPUNIT_ASSERT(!reader.Open(name));
+    CPPUNIT_ASSERT(!reader.LastError().empty());
+    {
+        mtsSharedMemoryRing writer;
+        CPPUNIT_ASSERT(writer.Create(name, 4, 16));
+        CPPUNIT_ASSERT(reader.Open(name));
+        // replacing a ring doesn't affect readers of the previous one
+        mtsSharedMemoryRing replacement;
+        CPPUNIT_ASSERT(replacement.Create(name, 8, 16));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), reader.NumberOfSlots());
+    }
+    reader.Close();
+    CPPUNIT_ASSERT(!reader.Open(name));
+}
+
+void mtsSharedMemoryRingTest::TestCorruptedHeader(void)
+{
+    const std::string name = RingName("corrupted");
+    mtsSharedMemoryRing owner, writer;
+    CPPUNIT_ASSERT(owner.Create(name, 4, sizeof(uint64_t) * PayloadSize));
+    const size_t maximumDataSize = owner.MaximumDataSize();
+    CPPUNIT_ASSERT(writer.Open(name, true));
+    CPPUNIT_ASSERT(writer.IsWriter());
+
+    uint64_t payload[PayloadSize];
+    FillPayload(payload, 0);
+    CPPUNIT_ASSERT(writer.Write(payload, sizeof(payload)));
+
+    // faulty process zeroes the number of slots and enlarges slots
+    const int fileDescriptor = shm_open(name.c_str(), O_RDWR, 0);
+    CPPUNIT_ASSERT(fileDescriptor >= 0);
+    void * memory = mmap(nullptr, mtsSharedMemoryRing::HeaderSize, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fileDescriptor, 0);
+    close(fileDescriptor);
+    CPPUNIT_ASSERT(memory != MAP_FAILED);
+    uint32_t * geometry = reinterpret_cast<uint32_t *>(static_cast<char *>(memory) + 8);
+    geometry[0] = 0;
+    geometry[1] = 0xFFFFFFFF;
+    munmap(memory, mtsSharedMemoryRing::HeaderSize);
+
+    // geometry cached by both sides
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), owner.NumberOfSlots());
+    CPPUNIT_ASSERT_EQUAL(maximumDataSize, owner.MaximumDataSize());
+    CPPUNIT_ASSERT_EQUAL(maximumDataSize, writer.MaximumDataSize());
+    FillPayload(payload, 1);
+    CPPUNIT_ASSERT(writer.Write(payload, sizeof(payload)));
+    uint64_t index;
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(sizeof(payload)),
+                         owner.ReadLatest(index, payload, sizeof(payload)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), index);
+    CPPUNIT_ASSERT(CheckPayload(payload, 1));
+
+    // new readers reject the layout
+    mtsSharedMemoryRing reader;
+    CPPUNIT_ASSERT(!reader.Open(name));
+}
+
+void mtsSharedMemoryRingTest::TestReaders(void)
+{
+    const size_t numberOfWrites = 20000;
+    const size_t maximumReaders = 4;
+    std::vector<size_t> cases = {0, 1, 2, maximumReaders};
+
+    sawIntuitiveResearchKitTests::BenchmarkOutput() << std::endl << "Shared memory ring write time (us) with concurrent readers:" << std::endl;
+    for (const size_t numberOfReaders : cases) {
+        const std::string name = RingName("readers");
+        mtsSharedMemoryRing writer;
+        CPPUNIT_ASSERT(writer.Create(name, 64, sizeof(uint64_t) * PayloadSize));
+
+        std::atomic<bool> done(false);
+        std::atomic<size_t> started(0), reads(0), torn(0);
+        std::vector<std::thread> readers;
+        for (size_t reader = 0; reader < numberOfReaders; ++reader) {
+            readers.emplace_back([&]() {
+                    mtsSharedMemoryRing ring;
+                    if (!ring.Open(name)) {
+                        torn++;
+                        started++;
+                        return;
+                    }
+                    uint64_t payload[PayloadSize];
+                    uint64_t index;
+                    started++;
+                    while (!done) {
+                        if (ring.ReadLatest(index, payload, sizeof(payload)) > 0) {
+                            reads++;
+                            if (!CheckPayload(payload, index)) {
+                                torn++;
+                            }
+                        }
+                        std::this_thread::yield();
+                    }
+                });
+        }
+
+        while (started != numberOfReaders) {
+            std::this_thread::yield();
+        }
+
+        uint64_t payload[PayloadSize];
+        double total = 0.0, maximum = 0.0;
+        for (uint64_t write = 0; write < numberOfWrites; ++write) {
+            FillPayload(payload, write);
+            const auto start = std::chrono::steady_clock::now();
+            writer.Write(payload, sizeof(payload));
+            const double elapsed =
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            total += elapsed;
+            maximum = std::max(maximum, elapsed);
+            // give readers a chance to run on single core machines
+            std::this_thread::yield();
+        }
+        done = true;
+        for (auto & reader : readers) {
+            reader.join();
+        }
+
+        sawIntuitiveResearchKitTests::BenchmarkOutput() << "  " << numberOfReaders << " reader(s)"
+                  << " mean " << std::setw(8) << std::fixed << std::setprecision(3)
+                  << total / numberOfWrites
+                  << " max " << maximum
+                  << " reads " << reads << std::endl;
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), static_cast<size_t>(torn));
+        CPPUNIT_ASSERT((numberOfReaders == 0) || (reads > 0));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(numberOfWrites), writer.WriteCount());
+    }
+}
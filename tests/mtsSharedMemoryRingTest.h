@@ -0,0 +1,62 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-04
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsSharedMemoryRing.h>
+
+class mtsSharedMemoryRingTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsSharedMemoryRingTest);
+    {
+        CPPUNIT_TEST(TestWriteRead);
+        CPPUNIT_TEST(TestOverrun);
+        CPPUNIT_TEST(TestOpen);
+        CPPUNIT_TEST(TestCorruptedHeader);
+        CPPUNIT_TEST(TestReaders);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // data written is read back by index and latest
+    void TestWriteRead(void);
+
+    // slow reader detects slots overwritten by the writer
+    void TestOverrun(void);
+
+    // readers can't open missing rings, ring is removed with writer
+    void TestOpen(void);
+
+    // geometry is not read again from the shared memory
+    void TestCorruptedHeader(void);
+
+    // writer cost with concurrent readers, readers never get torn data
+    void TestReaders(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsSharedMemoryRingTest);
@@ -0,0 +1,116 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-27
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#include <cmath>
+
+#include "mtsSocketClockSyncTest.h"
+
+namespace {
+    // messages every ms, local time starts at Period
+    const double Period = 0.001;
+    const double Tolerance = 1.0e-9;
+
+    // remote clock is rate * local + offset, peer replies immediately
+    void AddSample(mtsSocketClockSync & clock, const unsigned int index,
+                   const double rate, const double offset,
+                   const double delayOut, const double delayIn) {
+        const double localSendTime = index * Period;
+        const double localRemoteTime = localSendTime + delayOut;
+        const double remoteTime = rate * localRemoteTime + offset;
+        CPPUNIT_ASSERT(clock.AddSample(localSendTime, remoteTime,
+                                       localRemoteTime + delayIn));
+    }
+}
+
+void mtsSocketClockSyncTest::TestOffset(void)
+{
+    mtsSocketClockSync clock;
+    CPPUNIT_ASSERT(!clock.Valid());
+
+    // nothing echoed yet or receive before send
+    CPPUNIT_ASSERT(!clock.AddSample(0.0, 10.0, 0.001));
+    CPPUNIT_ASSERT(!clock.AddSample(0.002, 10.0, 0.001));
+    CPPUNIT_ASSERT(!clock.Valid());
+
+    // asymmetric jitter, smallest round trip is 2.5 ms with 1 ms out
+    // and 1.5 ms in so offset error is 0.25 ms
+    for (unsigned int index = 1; index <= 1000; ++index) {
+        AddSample(clock, index, 1.0, 10.0,
+                  0.001 + 0.0005 * (index % 3),
+                  0.001 + 0.0005 * ((index + 1) % 3));
+    }
+    CPPUNIT_ASSERT(clock.Valid());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1000), clock.NumberOfSamples());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0025, clock.RoundTripTime(), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0 - 0.00025, clock.Offset(1.0), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, clock.Drift(), Tolerance);
+    // error bounded by half the round trip
+    CPPUNIT_ASSERT(std::abs(clock.Offset(1.0) - 10.0) <= 0.5 * clock.RoundTripTime());
+
+    // message sent at local time 1.0 and received 2 ms later, offset
+    // error shows up in latency
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.002 - 0.00025, clock.Latency(11.0, 1.002), Tolerance);
+
+    clock.Reset();
+    CPPUNIT_ASSERT(!clock.Valid());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), clock.NumberOfSamples());
+}
+
+void mtsSocketClockSyncTest::TestDrift(void)
+{
+    mtsSocketClockSync clock;
+    // remote clock 100 ppm faster, symmetric delays, 5 seconds
+    const double rate = 1.0 + 1.0e-4;
+    for (unsigned int index = 1; index <= 5000; ++index) {
+        AddSample(clock, index, rate, 5.0, 0.001, 0.001);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0e-4, clock.Drift(), 1.0e-8);
+    // offset is extrapolated from sample received 1 ms after peer time
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0 + 1.0e-4 * 6.0, clock.Offset(6.0), 1.0e-6);
+}
+
+void mtsSocketClockSyncTest::TestDistributions(void)
+{
+    mtsSocketClockSync clock;
+    // 1 ms each way, every 10th incoming message is 5 ms late
+    for (unsigned int index = 1; index <= 1000; ++index) {
+        const double delayIn = (index % 10 == 0) ? 0.006 : 0.001;
+        AddSample(clock, index, 1.0, 2.0, 0.001, delayIn);
+    }
+    clock.ComputeDistributions();
+
+    // window contains last 512 samples, 52 of which are late
+    const size_t windowSize = mtsSocketClockSync::WINDOW_SIZE;
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(512), windowSize);
+    const double ratio = 52.0 / 512.0;
+    const vct5 & in = clock.LatencyIn();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.001, in[0], Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.001 + 0.005 * ratio, in[1], Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.005 * std::sqrt(ratio * (1.0 - ratio)), in[2], Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.006, in[3], Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.006, in[4], Tolerance);
+
+    // outgoing messages are not affected
+    const vct5 & out = clock.LatencyOut();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.001, out[0], Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.001, out[1], Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, out[2], Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.001, out[3], Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.001, out[4], Tolerance);
+}
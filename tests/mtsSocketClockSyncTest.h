@@ -0,0 +1,54 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-27
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsSocketClockSync.h>
+
+class mtsSocketClockSyncTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsSocketClockSyncTest);
+    {
+        CPPUNIT_TEST(TestOffset);
+        CPPUNIT_TEST(TestDrift);
+        CPPUNIT_TEST(TestDistributions);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // constant offset with jitter, smallest round trip is used
+    void TestOffset(void);
+
+    // remote clock faster than local clock
+    void TestDrift(void);
+
+    // latency spikes in one direction only
+    void TestDistributions(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsSocketClockSyncTest);
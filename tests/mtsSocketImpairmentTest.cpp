@@ -0,0 +1,291 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-29
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+
+#include "mtsSocketImpairmentTest.h"
+#include "sawIntuitiveResearchKitTestsBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <cisstCommon/cmnConstants.h>
+#include <sawIntuitiveResearchKit/mtsSocketWireFormat.h>
+
+namespace {
+    const double Period = 0.001;
+    const size_t BufferSize = 1024;
+
+    // datagram contains its index
+    void SendIndex(mtsSocketImpairment & link, const unsigned int index, const double time) {
+        char buffer[8] = {0};
+        memcpy(buffer, &index, sizeof(index));
+        link.Send(buffer, sizeof(buffer), time);
+    }
+
+    int ReceiveIndex(mtsSocketImpairment & link, const double time, unsigned int & index) {
+        char buffer[BufferSize];
+        const int bytesRead = link.Receive(buffer, BufferSize, time);
+        if (bytesRead > 0) {
+            memcpy(&index, buffer, sizeof(index));
+        }
+        return bytesRead;
+    }
+
+    // simulated PSM follows a sine wave on x, 5 cm amplitude at 0.5 Hz
+    const double Amplitude = 0.05;
+    const double Frequency = 0.5;
+    const double MaximumVelocity = 2.0 * cmnPI * Frequency * Amplitude;
+
+    double Desired(const double time) {
+        return Amplitude * std::sin(2.0 * cmnPI * Frequency * time);
+    }
+
+    struct TrackingError {
+        double RMS;
+        double Maximum;
+    };
+
+    /*! Client sends cartesian commands every period using the packed
+      format, server uses the latest datagram received (see
+      mtsSocketBasePSM::ReceiveLatest) and the simulated arm reaches
+      the goal immediately.  Error is measured after 1 second. */
+    TrackingError Tracking(const mtsSocketImpairment::Profile & profile) {
+        std::unique_ptr<mtsSocketImpairment> link(new mtsSocketImpairment);
+        link->Configure(profile);
+
+        socketCommandPSM command;
+        command.RobotControlState = socketMessages::SCK_CART_POS;
+        socketCommandPSM received;
+        char buffer[BufferSize];
+        double position = 0.0;
+        double sumSquares = 0.0;
+        size_t numberOfSamples = 0;
+        TrackingError error = {0.0, 0.0};
+
+        for (unsigned int index = 1; index <= 5000; ++index) {
+            const double time = index * Period;
+            // client
+            command.Header.Id = index;
+            command.Header.Timestamp = time;
+            command.GoalPose.Translation().Assign(Desired(time), 0.0, 0.0);
+            const size_t size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, command,
+                                                            buffer, BufferSize);
+            link->Send(buffer, size, time);
+            // server
+            int bytesRead = link->Receive(buffer, BufferSize, time);
+            while (bytesRead > 0) {
+                if (mtsSocketWireFormat::Decode(buffer, bytesRead, received)) {
+                    position = received.GoalPose.Translation().X();
+                }
+                bytesRead = link->Receive(buffer, BufferSize, time);
+            }
+            // error
+            if (time > 1.0) {
+                const double difference = std::abs(position - Desired(time));
+                sumSquares += difference * difference;
+                numberOfSamples++;
+                error.Maximum = std::max(error.Maximum, difference);
+            }
+        }
+        error.RMS = std::sqrt(sumSquares / numberOfSamples);
+        return error;
+    }
+}
+
+void mtsSocketImpairmentTest::TestDelay(void)
+{
+    std::unique_ptr<mtsSocketImpairment> link(new mtsSocketImpairment);
+    mtsSocketImpairment::Profile profile;
+    profile.Delay = 0.005;
+    link->Configure(profile);
+
+    for (unsigned int index = 0; index < 10; ++index) {
+        SendIndex(*link, index, index * Period);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), link->Size());
+
+    unsigned int index;
+    CPPUNIT_ASSERT_EQUAL(0, ReceiveIndex(*link, 0.0049, index));
+    CPPUNIT_ASSERT(ReceiveIndex(*link, 0.0051, index) > 0);
+    CPPUNIT_ASSERT_EQUAL(0u, index);
+    CPPUNIT_ASSERT_EQUAL(0, ReceiveIndex(*link, 0.0051, index));
+
+    // everything else arrives in order
+    for (unsigned int expected = 1; expected < 10; ++expected) {
+        CPPUNIT_ASSERT(ReceiveIndex(*link, 1.0, index) > 0);
+        CPPUNIT_ASSERT_EQUAL(expected, index);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), link->Size());
+    CPPUNIT_ASSERT_EQUAL(10u, link->GetStatistics().Delivered);
+    CPPUNIT_ASSERT_EQUAL(0u, link->GetStatistics().Reordered);
+
+    // buffer too small, datagram is dropped
+    SendIndex(*link, 0, 0.0);
+    char small[4];
+    CPPUNIT_ASSERT_EQUAL(-1, link->Receive(small, sizeof(small), 1.0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), link->Size());
+}
+
+void mtsSocketImpairmentTest::TestLoss(void)
+{
+    std::unique_ptr<mtsSocketImpairment> link(new mtsSocketImpairment);
+    mtsSocketImpairment::Profile profile;
+    profile.Loss = 0.1;
+    profile.Duplicate = 0.05;
+    link->Configure(profile);
+
+    unsigned int index, received = 0;
+    for (unsigned int sent = 0; sent < 10000; ++sent) {
+        const double time = sent * Period;
+        SendIndex(*link, sent, time);
+        while (ReceiveIndex(*link, time, index) > 0) {
+            received++;
+        }
+    }
+    const mtsSocketImpairment::Statistics & statistics = link->GetStatistics();
+    CPPUNIT_ASSERT_EQUAL(10000u, statistics.Sent);
+    CPPUNIT_ASSERT(statistics.Lost > 900);
+    CPPUNIT_ASSERT(statistics.Lost < 1100);
+    CPPUNIT_ASSERT(statistics.Duplicated > 350);
+    CPPUNIT_ASSERT(statistics.Duplicated < 550);
+    CPPUNIT_ASSERT_EQUAL(statistics.Sent - statistics.Lost + statistics.Duplicated, received);
+
+    // same seed, same results
+    const unsigned int lost = statistics.Lost;
+    link->Configure(profile);
+    for (unsigned int sent = 0; sent < 10000; ++sent) {
+        SendIndex(*link, sent, sent * Period);
+        while (ReceiveIndex(*link, sent * Period, index) > 0) {
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(lost, link->GetStatistics().Lost);
+
+    // invalid profile
+    Json::Value jsonProfile;
+    jsonProfile["loss"] = 1.5;
+    CPPUNIT_ASSERT(!mtsSocketImpairment::ProfileFromJSON(jsonProfile, profile));
+    jsonProfile["loss"] = 0.2;
+    jsonProfile["delay"] = 0.01;
+    CPPUNIT_ASSERT(mtsSocketImpairment::ProfileFromJSON(jsonProfile, profile));
+    CPPUNIT_ASSERT_EQUAL(0.2, profile.Loss);
+    CPPUNIT_ASSERT_EQUAL(0.01, profile.Delay);
+    CPPUNIT_ASSERT_EQUAL(0.05, profile.Duplicate);
+}
+
+void mtsSocketImpairmentTest::TestReorder(void)
+{
+    std::unique_ptr<mtsSocketImpairment> link(new mtsSocketImpairment);
+    mtsSocketImpairment::Profile profile;
+    profile.Delay = 0.002;
+    profile.Reorder = 0.2;
+    profile.ReorderDelay = 0.005;
+    link->Configure(profile);
+
+    unsigned int index, previous = 0, outOfOrder = 0;
+    bool first = true;
+    for (unsigned int sent = 0; sent < 1000; ++sent) {
+        const double time = sent * Period;
+        SendIndex(*link, sent, time);
+        while (ReceiveIndex(*link, time, index) > 0) {
+            if (!first && (index < previous)) {
+                outOfOrder++;
+            }
+            if (first || (index > previous)) {
+                previous = index;
+            }
+            first = false;
+        }
+    }
+    CPPUNIT_ASSERT(outOfOrder > 100);
+    CPPUNIT_ASSERT_EQUAL(outOfOrder, link->GetStatistics().Reordered);
+}
+
+void mtsSocketImpairmentTest::TestBandwidth(void)
+{
+    std::unique_ptr<mtsSocketImpairment> link(new mtsSocketImpairment);
+    mtsSocketImpairment::Profile profile;
+    // 8 bytes take 1 ms, queue can hold 10 datagrams
+    profile.Bandwidth = 8000.0;
+    profile.QueueSize = 80;
+    link->Configure(profile);
+
+    for (unsigned int sent = 0; sent < 20; ++sent) {
+        SendIndex(*link, sent, 0.0);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), link->Size());
+    CPPUNIT_ASSERT_EQUAL(10u, link->GetStatistics().Overflows);
+
+    // one datagram per ms
+    unsigned int index;
+    for (unsigned int expected = 0; expected < 10; ++expected) {
+        const double time = (expected + 1) * Period;
+        CPPUNIT_ASSERT_EQUAL(0, ReceiveIndex(*link, time - 0.0001, index));
+        CPPUNIT_ASSERT(ReceiveIndex(*link, time + 0.0001, index) > 0);
+        CPPUNIT_ASSERT_EQUAL(expected, index);
+    }
+}
+
+void mtsSocketImpairmentTest::TestTracking(void)
+{
+    struct Case {
+        std::string Name;
+        mtsSocketImpairment::Profile Profile;
+        TrackingError Error;
+    };
+    std::vector<Case> cases(6);
+    cases[0].Name = "none";
+    cases[1].Name = "delay 5 ms";
+    cases[1].Profile.Delay = 0.005;
+    cases[2].Name = "delay 5 ms, jitter 2 ms";
+    cases[2].Profile.Delay = 0.005;
+    cases[2].Profile.Jitter = 0.002;
+    cases[3].Name = "loss 10%";
+    cases[3].Profile.Loss = 0.1;
+    cases[4].Name = "delay 5 ms, reorder 10% by 10 ms";
+    cases[4].Profile.Delay = 0.005;
+    cases[4].Profile.Reorder = 0.1;
+    cases[4].Profile.ReorderDelay = 0.01;
+    cases[5].Name = "bandwidth 100 kB/s";
+    cases[5].Profile.Bandwidth = 100000.0;
+
+    sawIntuitiveResearchKitTests::BenchmarkOutput() << std::endl << "Tracking error (mm) for simulated PSM over socket:" << std::endl;
+    for (auto & testCase : cases) {
+        testCase.Error = Tracking(testCase.Profile);
+        sawIntuitiveResearchKitTests::BenchmarkOutput() << "  " << std::setw(34) << std::left << testCase.Name
+                  << " rms " << std::setw(8) << std::fixed << std::setprecision(3)
+                  << testCase.Error.RMS * 1000.0
+                  << " max " << testCase.Error.Maximum * 1000.0 << std::endl;
+    }
+
+    // no impairment, goal is received immediately
+    CPPUNIT_ASSERT(cases[0].Error.Maximum < 1.0e-12);
+    // goal is at most delay + period old
+    CPPUNIT_ASSERT(cases[1].Error.RMS > 0.0);
+    CPPUNIT_ASSERT(cases[1].Error.Maximum <= MaximumVelocity * (0.005 + Period) + 1.0e-9);
+    // latest received can be older by jitter
+    CPPUNIT_ASSERT(cases[2].Error.Maximum <= MaximumVelocity * (0.005 + 2.0 * 0.002 + Period) + 1.0e-9);
+    // some impairments are worse than others
+    CPPUNIT_ASSERT(cases[3].Error.RMS < cases[1].Error.RMS);
+    CPPUNIT_ASSERT(cases[4].Error.RMS > cases[1].Error.RMS);
+    CPPUNIT_ASSERT(cases[5].Error.RMS > cases[1].Error.RMS);
+}
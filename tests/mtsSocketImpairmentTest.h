@@ -0,0 +1,62 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-29
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsSocketImpairment.h>
+
+class mtsSocketImpairmentTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsSocketImpairmentTest);
+    {
+        CPPUNIT_TEST(TestDelay);
+        CPPUNIT_TEST(TestLoss);
+        CPPUNIT_TEST(TestReorder);
+        CPPUNIT_TEST(TestBandwidth);
+        CPPUNIT_TEST(TestTracking);
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // fixed delay, datagrams received in order
+    void TestDelay(void);
+
+    // random loss and duplicates
+    void TestLoss(void);
+
+    // datagrams held for extra delay are received out of order
+    void TestReorder(void);
+
+    // serialization delay and drops when link queue is full
+    void TestBandwidth(void);
+
+    // simulated PSM following cartesian commands sent over impaired links
+    void TestTracking(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsSocketImpairmentTest);
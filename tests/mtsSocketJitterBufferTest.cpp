@@ -0,0 +1,134 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-22
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsSocketJitterBufferTest.h"
+
+namespace {
+    // commands every 10 ms, constant transit time of 1 s
+    const double Period = 0.01;
+    const double Transit = 1.0;
+    const double Tolerance = 1.0e-9;
+
+    void PushCommand(mtsSocketJitterBuffer & buffer, const unsigned int id) {
+        vctFrm3 pose;
+        pose.Translation().Assign(id * 0.01, 0.0, 0.0);
+        pose.Rotation().From(vctAxAnRot3(vct3(0.0, 0.0, 1.0), id * 0.1));
+        const double remoteTime = id * Period;
+        buffer.Push(id, remoteTime, remoteTime + Transit, pose, id * 0.1);
+    }
+
+    double Angle(const vctFrm3 & pose) {
+        vctAxAnRot3 axisAngle(pose.Rotation(), VCT_NORMALIZE);
+        return axisAngle.Angle();
+    }
+}
+
+void mtsSocketJitterBufferTest::TestInterpolation(void)
+{
+    mtsSocketJitterBuffer buffer;
+    // fixed 10 ms delay
+    buffer.Configure(0.01, 0.01, 0.02, 0.1);
+
+    vctFrm3 pose;
+    double jaw;
+    CPPUNIT_ASSERT_EQUAL(mtsSocketJitterBuffer::EMPTY,
+                         buffer.Playout(Transit, pose, jaw));
+
+    for (unsigned int id = 1; id <= 5; ++id) {
+        PushCommand(buffer, id);
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), buffer.Size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, buffer.GetStatistics().Jitter, Tolerance);
+
+    // playout time is before first command
+    CPPUNIT_ASSERT_EQUAL(mtsSocketJitterBuffer::BUFFERING,
+                         buffer.Playout(Transit, pose, jaw));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.01, pose.Translation().X(), Tolerance);
+
+    // half way between commands 3 and 4
+    CPPUNIT_ASSERT_EQUAL(mtsSocketJitterBuffer::INTERPOLATING,
+                         buffer.Playout(Transit + 0.035 + 0.01, pose, jaw));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.035, pose.Translation().X(), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.35, Angle(pose), Tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.35, jaw, Tolerance);
+    // older commands are dropped
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), buffer.Size());
+}
+
+void mtsSocketJitterBufferTest::TestExtrapolationAndHold(void)
+{
+    mtsSocketJitterBuffer buffer;
+    buffer.Configure(0.01, 0.01, 0.02, 0.1);
+
+    vctFrm3 pose;
+    double jaw;
+    for (unsigned int id = 1; id <= 5; ++id) {
+        PushCommand(buffer, id);
+    }
+
+    // 5 ms after last command, extrapolated using last velocity
+    CPPUNIT_ASSERT_EQUAL(mtsSocketJitterBuffer::EXTRAPOLATING,
+                         buffer.Playout(Transit + 0.055 + 0.01, pose, jaw));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.055, pose.Translation().X(), Tolerance);
+    CPPUNIT_ASSERT_EQUAL(1u, buffer.GetStatistics().Extrapolated);
+
+    // extrapolation is limited to 20 ms
+    CPPUNIT_ASSERT_EQUAL(mtsSocketJitterBuffer::EXTRAPOLATING,
+                         buffer.Playout(Transit + 0.09 + 0.01, pose, jaw));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.07, pose.Translation().X(), Tolerance);
+    CPPUNIT_ASSERT_EQUAL(1u, buffer.GetStatistics().Extrapolated);
+
+    // nothing received for more than 100 ms
+    CPPUNIT_ASSERT_EQUAL(mtsSocketJitterBuffer::HOLD,
+                         buffer.Playout(Transit + 0.05 + 0.2, pose, jaw));
+    CPPUNIT_ASSERT_EQUAL(mtsSocketJitterBuffer::HOLD,
+                         buffer.Playout(Transit + 0.05 + 0.3, pose, jaw));
+    CPPUNIT_ASSERT_EQUAL(1u, buffer.GetStatistics().Holds);
+}
+
+void mtsSocketJitterBufferTest::TestReorderAndLoss(void)
+{
+    mtsSocketJitterBuffer buffer;
+    buffer.Configure(0.01, 0.01, 0.02, 0.1);
+
+    PushCommand(buffer, 1);
+    PushCommand(buffer, 2);
+    PushCommand(buffer, 4);
+    CPPUNIT_ASSERT_EQUAL(1u, buffer.GetStatistics().PacketsLost);
+
+    // 3 arrives late but can still be played
+    PushCommand(buffer, 3);
+    CPPUNIT_ASSERT_EQUAL(1u, buffer.GetStatistics().PacketsReordered);
+    CPPUNIT_ASSERT_EQUAL(0u, buffer.GetStatistics().PacketsLost);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), buffer.Size());
+
+    // duplicate is ignored
+    vctFrm3 pose;
+    CPPUNIT_ASSERT(!buffer.Push(3, 3 * Period, 3 * Period + Transit, pose, 0.0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), buffer.Size());
+
+    // commands are sorted, interpolate between 3 and 4
+    double jaw;
+    CPPUNIT_ASSERT_EQUAL(mtsSocketJitterBuffer::INTERPOLATING,
+                         buffer.Playout(Transit + 0.035 + 0.01, pose, jaw));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.035, pose.Translation().X(), Tolerance);
+
+    // command older than playout time is late
+    CPPUNIT_ASSERT(!buffer.Push(6, 0.03, 0.03 + Transit, pose, 0.0));
+    CPPUNIT_ASSERT_EQUAL(1u, buffer.GetStatistics().PacketsLate);
+}
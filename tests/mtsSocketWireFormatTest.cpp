@@ -0,0 +1,485 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "mtsSocketWireFormatTest.h"
+#include "sawIntuitiveResearchKitTestsBenchmark.h"
+
+#include <cstring>
+#include <sstream>
+
+#include <cisstOSAbstraction/osaGetTime.h>
+
+namespace {
+    void FillState(socketStatePSM & state, const unsigned int id) {
+        state.Header.Id = id;
+        state.Header.LastId = id - 1;
+        state.Header.Timestamp = 0.001 * id;
+        state.Header.LastTimestamp = 0.001 * id - 0.0005;
+        state.RobotControlState = socketMessages::SCK_CART_POS;
+        state.CurrentPose.Rotation().From(vctAxAnRot3(vct3(0.0, 0.0, 1.0), 0.01 * id));
+        state.CurrentPose.Translation().Assign(0.1, -0.2, 0.3 + 0.001 * id);
+        state.CurrentJaw = 0.5;
+        state.CurrentJoints.Assign(0.1, 0.2, 0.15, -0.3, 0.4, -0.5);
+        state.GoalReached = true;
+    }
+
+    void FillCommand(socketCommandPSM & command, const unsigned int id) {
+        command.Header.Id = id;
+        command.Header.LastId = id + 3;
+        command.Header.Timestamp = 0.002 * id;
+        command.Header.LastTimestamp = 0.002 * id - 0.001;
+        command.RobotControlState = socketMessages::SCK_HOMED;
+        command.GoalPose.Rotation().From(vctAxAnRot3(vct3(1.0, 0.0, 0.0), -0.02 * id));
+        command.GoalPose.Translation().Assign(-0.05, 0.02 * id, 0.1);
+        command.GoalJaw = -0.2;
+        command.GoalJoints.Assign(-0.1, 0.3, 0.12, 0.0, -0.4, 0.5 * id);
+    }
+
+    void FillStateMTM(socketStateMTM & state, const unsigned int id) {
+        state.Header.Id = id;
+        state.Header.LastId = id - 2;
+        state.Header.Timestamp = 0.001 * id;
+        state.Header.LastTimestamp = 0.001 * id - 0.0002;
+        state.RobotControlState = socketMessages::SCK_CART_EFFORT;
+        state.MeasuredPose.Rotation().From(vctAxAnRot3(vct3(0.0, 1.0, 0.0), 0.03 * id));
+        state.MeasuredPose.Translation().Assign(0.2, 0.1, -0.3);
+        state.SetpointPose.Rotation().From(vctAxAnRot3(vct3(1.0, 0.0, 0.0), -0.01 * id));
+        state.SetpointPose.Translation().Assign(-0.2, 0.15, 0.01 * id);
+        state.MeasuredTwist.Assign(0.01, -0.02, 0.03, 0.1, -0.2, 0.3);
+        state.Gripper = 0.7;
+        state.GoalReached = true;
+    }
+
+    void FillCommandMTM(socketCommandMTM & command, const unsigned int id) {
+        command.Header.Id = id;
+        command.Header.LastId = id + 1;
+        command.Header.Timestamp = 0.002 * id;
+        command.Header.LastTimestamp = 0.002 * id - 0.001;
+        command.RobotControlState = socketMessages::SCK_CART_TRAJ;
+        command.GoalPose.Rotation().From(vctAxAnRot3(vct3(0.0, 0.0, 1.0), 0.05 * id));
+        command.GoalPose.Translation().Assign(0.01 * id, -0.1, 0.2);
+        command.Orientation.From(vctAxAnRot3(vct3(0.0, 1.0, 0.0), -0.4));
+        command.Wrench.Assign(1.0, -2.0, 3.0, 0.1, 0.2, -0.3);
+        command.LockOrientation = true;
+        command.GravityCompensation = false;
+        command.WrenchOrientationAbsolute = true;
+    }
+
+    void FillStateECM(socketStateECM & state, const unsigned int id) {
+        state.Header.Id = id;
+        state.Header.LastId = id - 1;
+        state.Header.Timestamp = 0.001 * id;
+        state.Header.LastTimestamp = 0.001 * id - 0.0005;
+        state.RobotControlState = socketMessages::SCK_JNT_TRAJ;
+        state.MeasuredPose.Rotation().From(vctAxAnRot3(vct3(1.0, 0.0, 0.0), 0.02 * id));
+        state.MeasuredPose.Translation().Assign(0.0, 0.05, -0.1);
+        state.SetpointPose.Assign(state.MeasuredPose);
+        state.MeasuredJoints.Assign(0.1, -0.2, 0.05, 0.01 * id);
+        state.SetpointJoints.Assign(0.11, -0.21, 0.06, 0.3);
+        state.GoalReached = false;
+    }
+
+    void FillCommandECM(socketCommandECM & command, const unsigned int id) {
+        command.Header.Id = id;
+        command.Header.LastId = id + 2;
+        command.Header.Timestamp = 0.002 * id;
+        command.Header.LastTimestamp = 0.002 * id - 0.001;
+        command.RobotControlState = socketMessages::SCK_JNT_POS;
+        command.GoalJoints.Assign(-0.1, 0.2, 0.08, -0.01 * id);
+    }
+
+    void CheckHeader(const socketHeader & expected, const socketHeader & result) {
+        CPPUNIT_ASSERT_EQUAL(expected.Id, result.Id);
+        CPPUNIT_ASSERT_EQUAL(expected.LastId, result.LastId);
+        CPPUNIT_ASSERT_EQUAL(expected.Timestamp, result.Timestamp);
+        CPPUNIT_ASSERT_EQUAL(expected.LastTimestamp, result.LastTimestamp);
+        CPPUNIT_ASSERT_EQUAL(expected.Size, result.Size);
+    }
+}
+
+void mtsSocketWireFormatTest::TestPackedRoundTrip(void)
+{
+    char buffer[1024];
+
+    socketStatePSM state, stateResult;
+    FillState(state, 42);
+    size_t size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, state,
+                                              buffer, sizeof(buffer));
+    CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::MessagePSMSize, size);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(size), state.Header.Size);
+    CPPUNIT_ASSERT(mtsSocketWireFormat::IsPacked(buffer, size));
+    CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, stateResult));
+    CheckHeader(state.Header, stateResult.Header);
+    CPPUNIT_ASSERT_EQUAL(state.RobotControlState, stateResult.RobotControlState);
+    CPPUNIT_ASSERT(state.CurrentPose.Equal(stateResult.CurrentPose));
+    CPPUNIT_ASSERT_EQUAL(state.CurrentJaw, stateResult.CurrentJaw);
+    CPPUNIT_ASSERT(state.CurrentJoints.Equal(stateResult.CurrentJoints));
+    CPPUNIT_ASSERT(stateResult.GoalReached);
+    state.GoalReached = false;
+    mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, state, buffer, sizeof(buffer));
+    CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, stateResult));
+    CPPUNIT_ASSERT(!stateResult.GoalReached);
+    CPPUNIT_ASSERT(!stateResult.CommandRejected);
+    state.CommandRejected = true;
+    mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, state, buffer, sizeof(buffer));
+    CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, stateResult));
+    CPPUNIT_ASSERT(!stateResult.GoalReached);
+    CPPUNIT_ASSERT(stateResult.CommandRejected);
+
+    socketCommandPSM command, commandResult;
+    FillCommand(command, 7);
+    size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, command,
+                                       buffer, sizeof(buffer));
+    CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::MessagePSMSize, size);
+    CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, commandResult));
+    CheckHeader(command.Header, commandResult.Header);
+    CPPUNIT_ASSERT_EQUAL(command.RobotControlState, commandResult.RobotControlState);
+    CPPUNIT_ASSERT(command.GoalPose.Equal(commandResult.GoalPose));
+    CPPUNIT_ASSERT_EQUAL(command.GoalJaw, commandResult.GoalJaw);
+    CPPUNIT_ASSERT(command.GoalJoints.Equal(commandResult.GoalJoints));
+}
+
+void mtsSocketWireFormatTest::TestPackedLayout(void)
+{
+    char buffer[1024];
+    socketStatePSM state;
+    FillState(state, 0x01020304);
+    const size_t size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, state,
+                                                    buffer, sizeof(buffer));
+    CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::MessagePSMSize, size);
+
+    // magic "dVRK"
+    CPPUNIT_ASSERT_EQUAL('d', buffer[0]);
+    CPPUNIT_ASSERT_EQUAL('V', buffer[1]);
+    CPPUNIT_ASSERT_EQUAL('R', buffer[2]);
+    CPPUNIT_ASSERT_EQUAL('K', buffer[3]);
+    // version, little-endian
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(mtsSocketWireFormat::Version), buffer[4]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(0), buffer[5]);
+    // size
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(mtsSocketWireFormat::MessagePSMSize), buffer[6]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(0), buffer[7]);
+    // id, little-endian
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(0x04), buffer[8]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(0x03), buffer[9]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(0x02), buffer[10]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(0x01), buffer[11]);
+    // state
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(socketMessages::SCK_CART_POS), buffer[32]);
+    // flags, goal reached
+    CPPUNIT_ASSERT_EQUAL(static_cast<char>(mtsSocketWireFormat::FlagGoalReached), buffer[36]);
+    // last joint
+    double joint;
+    memcpy(&joint, buffer + mtsSocketWireFormat::MessagePSMSize - sizeof(double), sizeof(double));
+    CPPUNIT_ASSERT_EQUAL(state.CurrentJoints.Element(5), joint);
+}
+
+void mtsSocketWireFormatTest::TestArmsRoundTrip(void)
+{
+    char buffer[1024];
+    const mtsSocketWireFormat::FormatType formats[2] = {mtsSocketWireFormat::PACKED,
+                                                        mtsSocketWireFormat::CDG};
+    for (const auto format : formats) {
+        const bool packed = (format == mtsSocketWireFormat::PACKED);
+
+        socketStateMTM stateMTM, stateMTMResult;
+        FillStateMTM(stateMTM, 3);
+        size_t size = mtsSocketWireFormat::Encode(format, stateMTM, buffer, sizeof(buffer));
+        if (packed) {
+            CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::MessageStateMTMSize, size);
+        }
+        CPPUNIT_ASSERT(size > 0);
+        CPPUNIT_ASSERT_EQUAL(packed, mtsSocketWireFormat::IsPacked(buffer, size));
+        CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, stateMTMResult));
+        CheckHeader(stateMTM.Header, stateMTMResult.Header);
+        CPPUNIT_ASSERT_EQUAL(stateMTM.RobotControlState, stateMTMResult.RobotControlState);
+        CPPUNIT_ASSERT(stateMTM.MeasuredPose.Equal(stateMTMResult.MeasuredPose));
+        CPPUNIT_ASSERT(stateMTM.SetpointPose.Equal(stateMTMResult.SetpointPose));
+        CPPUNIT_ASSERT(stateMTM.MeasuredTwist.Equal(stateMTMResult.MeasuredTwist));
+        CPPUNIT_ASSERT_EQUAL(stateMTM.Gripper, stateMTMResult.Gripper);
+        CPPUNIT_ASSERT(stateMTMResult.GoalReached);
+
+        socketCommandMTM commandMTM, commandMTMResult;
+        FillCommandMTM(commandMTM, 4);
+        size = mtsSocketWireFormat::Encode(format, commandMTM, buffer, sizeof(buffer));
+        if (packed) {
+            CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::MessageCommandMTMSize, size);
+        }
+        CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, commandMTMResult));
+        CheckHeader(commandMTM.Header, commandMTMResult.Header);
+        CPPUNIT_ASSERT_EQUAL(commandMTM.RobotControlState, commandMTMResult.RobotControlState);
+        CPPUNIT_ASSERT(commandMTM.GoalPose.Equal(commandMTMResult.GoalPose));
+        CPPUNIT_ASSERT(commandMTM.Orientation.Equal(commandMTMResult.Orientation));
+        CPPUNIT_ASSERT(commandMTM.Wrench.Equal(commandMTMResult.Wrench));
+        CPPUNIT_ASSERT(commandMTMResult.LockOrientation);
+        CPPUNIT_ASSERT(!commandMTMResult.GravityCompensation);
+        CPPUNIT_ASSERT(commandMTMResult.WrenchOrientationAbsolute);
+
+        socketStateECM stateECM, stateECMResult;
+        FillStateECM(stateECM, 5);
+        size = mtsSocketWireFormat::Encode(format, stateECM, buffer, sizeof(buffer));
+        if (packed) {
+            CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::MessageStateECMSize, size);
+        }
+        CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, stateECMResult));
+        CheckHeader(stateECM.Header, stateECMResult.Header);
+        CPPUNIT_ASSERT_EQUAL(stateECM.RobotControlState, stateECMResult.RobotControlState);
+        CPPUNIT_ASSERT(stateECM.MeasuredPose.Equal(stateECMResult.MeasuredPose));
+        CPPUNIT_ASSERT(stateECM.SetpointPose.Equal(stateECMResult.SetpointPose));
+        CPPUNIT_ASSERT(stateECM.MeasuredJoints.Equal(stateECMResult.MeasuredJoints));
+        CPPUNIT_ASSERT(stateECM.SetpointJoints.Equal(stateECMResult.SetpointJoints));
+        CPPUNIT_ASSERT(!stateECMResult.GoalReached);
+
+        socketCommandECM commandECM, commandECMResult;
+        FillCommandECM(commandECM, 6);
+        size = mtsSocketWireFormat::Encode(format, commandECM, buffer, sizeof(buffer));
+        if (packed) {
+            CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::MessageCommandECMSize, size);
+        }
+        CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, commandECMResult));
+        CheckHeader(commandECM.Header, commandECMResult.Header);
+        CPPUNIT_ASSERT_EQUAL(commandECM.RobotControlState, commandECMResult.RobotControlState);
+        CPPUNIT_ASSERT(commandECM.GoalJoints.Equal(commandECMResult.GoalJoints));
+    }
+
+    // message types can't be mixed
+    socketStatePSM statePSM;
+    FillState(statePSM, 1);
+    const size_t size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, statePSM,
+                                                    buffer, sizeof(buffer));
+    socketStateECM stateECM;
+    CPPUNIT_ASSERT(!mtsSocketWireFormat::Decode(buffer, size, stateECM));
+}
+
+void mtsSocketWireFormatTest::TestCDGRoundTrip(void)
+{
+    char buffer[1024];
+
+    socketStatePSM state, stateResult;
+    FillState(state, 12);
+    size_t size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::CDG, state,
+                                              buffer, sizeof(buffer));
+    CPPUNIT_ASSERT(size > 0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(size), state.Header.Size);
+    CPPUNIT_ASSERT(!mtsSocketWireFormat::IsPacked(buffer, size));
+    CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, stateResult));
+    CheckHeader(state.Header, stateResult.Header);
+    CPPUNIT_ASSERT_EQUAL(state.RobotControlState, stateResult.RobotControlState);
+    CPPUNIT_ASSERT(state.CurrentPose.Equal(stateResult.CurrentPose));
+    CPPUNIT_ASSERT_EQUAL(state.CurrentJaw, stateResult.CurrentJaw);
+    // not part of the legacy layout
+    CPPUNIT_ASSERT(stateResult.CurrentJoints.Equal(vct6(0.0)));
+    CPPUNIT_ASSERT(!stateResult.GoalReached);
+
+    // same bytes as the legacy message
+    socketStatePSMv1 legacyState;
+    legacyState.Header = state.Header;
+    legacyState.RobotControlState = state.RobotControlState;
+    legacyState.CurrentPose = state.CurrentPose;
+    legacyState.CurrentJaw = state.CurrentJaw;
+    std::stringstream stream;
+    cmnData<socketStatePSMv1>::SerializeBinary(legacyState, stream);
+    CPPUNIT_ASSERT_EQUAL(stream.str(), std::string(buffer, size));
+
+    socketCommandPSM command, commandResult;
+    FillCommand(command, 5);
+    size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::CDG, command,
+                                       buffer, sizeof(buffer));
+    CPPUNIT_ASSERT(size > 0);
+    CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(buffer, size, commandResult));
+    CheckHeader(command.Header, commandResult.Header);
+    CPPUNIT_ASSERT(command.GoalPose.Equal(commandResult.GoalPose));
+    CPPUNIT_ASSERT_EQUAL(command.GoalJaw, commandResult.GoalJaw);
+    CPPUNIT_ASSERT(commandResult.GoalJoints.Equal(vct6(0.0)));
+
+    socketCommandPSMv1 legacyCommand;
+    legacyCommand.Header = command.Header;
+    legacyCommand.RobotControlState = command.RobotControlState;
+    legacyCommand.GoalPose = command.GoalPose;
+    legacyCommand.GoalJaw = command.GoalJaw;
+    stream.str("");
+    cmnData<socketCommandPSMv1>::SerializeBinary(legacyCommand, stream);
+    CPPUNIT_ASSERT_EQUAL(stream.str(), std::string(buffer, size));
+}
+
+void mtsSocketWireFormatTest::TestInvalid(void)
+{
+    char buffer[1024];
+    socketStatePSM state, stateResult;
+    FillState(state, 1);
+
+    // buffer too small to encode
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0),
+                         mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, state,
+                                                     buffer, mtsSocketWireFormat::MessagePSMSize - 1));
+
+    const size_t size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, state,
+                                                    buffer, sizeof(buffer));
+    // truncated message
+    CPPUNIT_ASSERT(!mtsSocketWireFormat::Decode(buffer, size - 1, stateResult));
+    // unknown version
+    buffer[4] = static_cast<char>(mtsSocketWireFormat::Version + 1);
+    CPPUNIT_ASSERT(!mtsSocketWireFormat::Decode(buffer, size, stateResult));
+    buffer[4] = static_cast<char>(mtsSocketWireFormat::Version);
+    // invalid state
+    buffer[32] = 100;
+    CPPUNIT_ASSERT(!mtsSocketWireFormat::Decode(buffer, size, stateResult));
+}
+
+void mtsSocketWireFormatTest::TestBridge(void)
+{
+    char buffer[1024];
+    socketHeader header;
+    header.Id = 42;
+    header.LastId = 40;
+    header.Timestamp = 1.5;
+    header.LastTimestamp = 1.25;
+
+    // buffer too small for header
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0),
+                         mtsSocketWireFormat::EncodeBridgeHeader(header, 3, buffer,
+                                                                 mtsSocketWireFormat::BridgeHeaderSize - 1));
+
+    // PSM, MTM and ECM, channels in reverse order
+    const size_t numberOfChannels = 3;
+    size_t size = mtsSocketWireFormat::EncodeBridgeHeader(header, numberOfChannels,
+                                                          buffer, sizeof(buffer));
+    CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::BridgeHeaderSize, size);
+    socketCommandPSM commandPSM;
+    FillCommand(commandPSM, 1);
+    socketCommandMTM commandMTM;
+    FillCommandMTM(commandMTM, 2);
+    socketCommandECM commandECM;
+    FillCommandECM(commandECM, 3);
+
+    mtsSocketWireFormat::EncodeChannelId(2, buffer + size, mtsSocketWireFormat::CHANNEL_PSM);
+    size += mtsSocketWireFormat::ChannelHeaderSize;
+    size += mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, commandPSM,
+                                        buffer + size, sizeof(buffer) - size);
+    mtsSocketWireFormat::EncodeChannelId(1, buffer + size, mtsSocketWireFormat::CHANNEL_MTM);
+    size += mtsSocketWireFormat::ChannelHeaderSize;
+    size += mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, commandMTM,
+                                        buffer + size, sizeof(buffer) - size);
+    mtsSocketWireFormat::EncodeChannelId(0, buffer + size, mtsSocketWireFormat::CHANNEL_ECM);
+    size += mtsSocketWireFormat::ChannelHeaderSize;
+    size += mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, commandECM,
+                                        buffer + size, sizeof(buffer) - size);
+    CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::BridgeHeaderSize
+                         + mtsSocketWireFormat::BridgeChannelCommandSize(mtsSocketWireFormat::CHANNEL_PSM)
+                         + mtsSocketWireFormat::BridgeChannelCommandSize(mtsSocketWireFormat::CHANNEL_MTM)
+                         + mtsSocketWireFormat::BridgeChannelCommandSize(mtsSocketWireFormat::CHANNEL_ECM),
+                         size);
+
+    // single arm messages are not bridge messages
+    socketHeader headerResult;
+    size_t numberOfChannelsResult;
+    CPPUNIT_ASSERT(!mtsSocketWireFormat::DecodeBridgeHeader(buffer + mtsSocketWireFormat::BridgeHeaderSize
+                                                            + mtsSocketWireFormat::ChannelHeaderSize,
+                                                            mtsSocketWireFormat::MessagePSMSize,
+                                                            headerResult, numberOfChannelsResult));
+    // truncated, last channel is incomplete
+    CPPUNIT_ASSERT(!mtsSocketWireFormat::DecodeBridgeHeader(buffer, size - 1,
+                                                            headerResult, numberOfChannelsResult));
+
+    CPPUNIT_ASSERT(mtsSocketWireFormat::DecodeBridgeHeader(buffer, size,
+                                                           headerResult, numberOfChannelsResult));
+    CPPUNIT_ASSERT_EQUAL(numberOfChannels, numberOfChannelsResult);
+    CPPUNIT_ASSERT_EQUAL(header.Id, headerResult.Id);
+    CPPUNIT_ASSERT_EQUAL(header.LastId, headerResult.LastId);
+    CPPUNIT_ASSERT_EQUAL(header.Timestamp, headerResult.Timestamp);
+    CPPUNIT_ASSERT_EQUAL(header.LastTimestamp, headerResult.LastTimestamp);
+
+    // walk channels using their sizes
+    const char * pointer = buffer + mtsSocketWireFormat::BridgeHeaderSize;
+    CPPUNIT_ASSERT_EQUAL(2u, mtsSocketWireFormat::DecodeChannelId(pointer));
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(mtsSocketWireFormat::CHANNEL_PSM),
+                         mtsSocketWireFormat::DecodeChannelType(pointer));
+    size_t channelSize = mtsSocketWireFormat::DecodeChannelSize(pointer);
+    CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::BridgeChannelSize, channelSize);
+    socketCommandPSM commandPSMResult;
+    CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(pointer + mtsSocketWireFormat::ChannelHeaderSize,
+                                               channelSize - mtsSocketWireFormat::ChannelHeaderSize,
+                                               commandPSMResult));
+    CheckHeader(commandPSM.Header, commandPSMResult.Header);
+    CPPUNIT_ASSERT(commandPSM.GoalPose.Equal(commandPSMResult.GoalPose));
+    CPPUNIT_ASSERT_EQUAL(commandPSM.GoalJaw, commandPSMResult.GoalJaw);
+    pointer += channelSize;
+
+    CPPUNIT_ASSERT_EQUAL(1u, mtsSocketWireFormat::DecodeChannelId(pointer));
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(mtsSocketWireFormat::CHANNEL_MTM),
+                         mtsSocketWireFormat::DecodeChannelType(pointer));
+    channelSize = mtsSocketWireFormat::DecodeChannelSize(pointer);
+    CPPUNIT_ASSERT_EQUAL(mtsSocketWireFormat::BridgeChannelCommandSize(mtsSocketWireFormat::CHANNEL_MTM),
+                         channelSize);
+    socketCommandMTM commandMTMResult;
+    CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(pointer + mtsSocketWireFormat::ChannelHeaderSize,
+                                               channelSize - mtsSocketWireFormat::ChannelHeaderSize,
+                                               commandMTMResult));
+    CheckHeader(commandMTM.Header, commandMTMResult.Header);
+    CPPUNIT_ASSERT(commandMTM.Wrench.Equal(commandMTMResult.Wrench));
+    pointer += channelSize;
+
+    CPPUNIT_ASSERT_EQUAL(0u, mtsSocketWireFormat::DecodeChannelId(pointer));
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(mtsSocketWireFormat::CHANNEL_ECM),
+                         mtsSocketWireFormat::DecodeChannelType(pointer));
+    channelSize = mtsSocketWireFormat::DecodeChannelSize(pointer);
+    socketCommandECM commandECMResult;
+    // wrong message type for channel
+    CPPUNIT_ASSERT(!mtsSocketWireFormat::Decode(pointer + mtsSocketWireFormat::ChannelHeaderSize,
+                                                channelSize - mtsSocketWireFormat::ChannelHeaderSize,
+                                                commandMTMResult));
+    CPPUNIT_ASSERT(mtsSocketWireFormat::Decode(pointer + mtsSocketWireFormat::ChannelHeaderSize,
+                                               channelSize - mtsSocketWireFormat::ChannelHeaderSize,
+                                               commandECMResult));
+    CPPUNIT_ASSERT(commandECM.GoalJoints.Equal(commandECMResult.GoalJoints));
+    pointer += channelSize;
+    CPPUNIT_ASSERT_EQUAL(size, static_cast<size_t>(pointer - buffer));
+}
+
+void mtsSocketWireFormatTest::TestBenchmark(void)
+{
+    const size_t numberOfPackets = 100000;
+    char buffer[1024];
+    socketStatePSM state, stateResult;
+    FillState(state, 1);
+
+    double startTime = osaGetTime();
+    for (size_t index = 0; index < numberOfPackets; ++index) {
+        state.Header.Id = index;
+        const size_t size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::PACKED, state,
+                                                        buffer, sizeof(buffer));
+        mtsSocketWireFormat::Decode(buffer, size, stateResult);
+    }
+    const double packedTime = (osaGetTime() - startTime) / numberOfPackets;
+    CPPUNIT_ASSERT_EQUAL(state.Header.Id, stateResult.Header.Id);
+
+    startTime = osaGetTime();
+    for (size_t index = 0; index < numberOfPackets; ++index) {
+        state.Header.Id = index;
+        const size_t size = mtsSocketWireFormat::Encode(mtsSocketWireFormat::CDG, state,
+                                                        buffer, sizeof(buffer));
+        mtsSocketWireFormat::Decode(buffer, size, stateResult);
+    }
+    const double cdgTime = (osaGetTime() - startTime) / numberOfPackets;
+    CPPUNIT_ASSERT_EQUAL(state.Header.Id, stateResult.Header.Id);
+
+    sawIntuitiveResearchKitTests::BenchmarkOutput() << std::endl
+              << "mtsSocketWireFormatTest: average encode + decode time per packet, packed: "
+              << packedTime * 1.0e9 << " (ns), cdg: "
+              << cdgTime * 1.0e9 << " (ns)" << std::endl;
+}
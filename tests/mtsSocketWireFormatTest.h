@@ -0,0 +1,72 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-20
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/mtsSocketWireFormat.h>
+
+class mtsSocketWireFormatTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(mtsSocketWireFormatTest);
+    {
+        CPPUNIT_TEST(TestPackedRoundTrip);
+        CPPUNIT_TEST(TestPackedLayout);
+        CPPUNIT_TEST(TestArmsRoundTrip);
+        CPPUNIT_TEST(TestCDGRoundTrip);
+        CPPUNIT_TEST(TestInvalid);
+        CPPUNIT_TEST(TestBridge);
+#ifdef sawIntuitiveResearchKitTests_BENCHMARKS
+        CPPUNIT_TEST(TestBenchmark);
+#endif
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // encode/decode state and command using packed format
+    void TestPackedRoundTrip(void);
+
+    // check a few fields at their documented offsets
+    void TestPackedLayout(void);
+
+    // encode/decode MTM and ECM state and command, both formats
+    void TestArmsRoundTrip(void);
+
+    // encode/decode using legacy format, detected on decode, layout is frozen
+    void TestCDGRoundTrip(void);
+
+    // truncated buffers and bad version should be rejected
+    void TestInvalid(void);
+
+    // multiple arm types in a single datagram, as used by mtsSocketBridge
+    void TestBridge(void);
+
+    // compare per packet encode + decode time for both formats
+    void TestBenchmark(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(mtsSocketWireFormatTest);
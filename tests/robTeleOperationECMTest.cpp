@@ -0,0 +1,324 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-16
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include "robTeleOperationECMTest.h"
+#include "sawIntuitiveResearchKitTestsBenchmark.h"
+
+#include <cmath>
+
+#include <cisstVector/vctDynamicVectorTypes.h>
+#include <cisstVector/vctEulerRotation3.h>
+#include <cisstOSAbstraction/osaGetTime.h>
+
+namespace {
+
+    // copy of the algorithm used in mtsTeleOperationECM before it was
+    // moved to robTeleOperationECM, uses dynamic vectors
+    class ReferenceTeleOperationECM
+    {
+    public:
+        void Initialize(const vct3 & mtmlPosition, const vctMatRot3 & mtmlRotation,
+                        const vct3 & mtmrPosition, const vctMatRot3 & mtmrRotation,
+                        const vctVec & ecmJoints) {
+            vct3 vectorLR;
+            vectorLR.DifferenceOf(mtmrPosition, mtmlPosition);
+            C.SumOf(mtmrPosition, mtmlPosition);
+            C.Multiply(0.5);
+            Up.CrossProductOf(vectorLR, C);
+            Up.NormalizedSelf();
+            vct3 side;
+            side.CrossProductOf(C, Up);
+            side.NormalizedSelf();
+            w = 0.5 * vctDotProduct(side, vectorLR);
+            d = 0.5 * vctDotProduct(C.Normalized(), vectorLR);
+            Lr.Assign(C[0], 0, C[2]);
+            Lr.NormalizedSelf();
+            Ud.Assign(0, C[1], C[2]);
+            Ud.NormalizedSelf();
+            Cw.Assign(Up[0], Up[1], 0);
+            Cw.NormalizedSelf();
+            ECMPositionJoint = ecmJoints;
+            vctEulerZYXRotation3 eulerAngles;
+            eulerAngles.Assign(ECMPositionJoint[3], ECMPositionJoint[0], ECMPositionJoint[1]);
+            vctEulerToMatrixRotation3(eulerAngles, ECMRotEuler);
+            MTMLRot = mtmlRotation;
+            MTMRRot = mtmrRotation;
+        }
+
+        void Compute(const vct3 & mtmlPosition, const vct3 & mtmrPosition,
+                     const double scale) {
+            vct3 vectorLR;
+            vectorLR.DifferenceOf(mtmrPosition, mtmlPosition);
+            vct3 c;
+            c.SumOf(mtmrPosition, mtmlPosition);
+            c.Multiply(0.5);
+            vct3 directionC = c.Normalized();
+            vct3 up;
+            up.CrossProductOf(vectorLR, c);
+            up.NormalizedSelf();
+            vct3 side;
+            side.CrossProductOf(c, up);
+            side.NormalizedSelf();
+            GoalL.Assign(c);
+            GoalL.AddProductOf(-w, side);
+            GoalL.AddProductOf(-d, directionC);
+            GoalR.Assign(c);
+            GoalR.AddProductOf(w, side);
+            GoalR.AddProductOf(d, directionC);
+
+            static const vct3 normXZ(0.0, 1.0, 0.0);
+            static const vct3 normYZ(1.0, 0.0, 0.0);
+            static const vct3 normXY(0.0, 0.0, 1.0);
+            vctVec goalJoints(ECMPositionJoint);
+            vctVec changeJoints(4);
+            vctVec changeDir(4);
+            vct3 crossN;
+
+            vct3 lr(c[0], 0.0, c[2]);
+            lr.NormalizedSelf();
+            if (Lr.AlmostEqual(lr)) {
+                changeDir[0] = 0.0;
+            } else {
+                changeDir[0] = -acos(vctDotProduct(Lr, lr));
+                crossN = vctCrossProduct(Lr, lr);
+                if (vctDotProduct(normXZ, crossN) < 0.0) {
+                    changeDir[0] = -changeDir[0];
+                }
+            }
+            vct3 ud(0.0, c[1], c[2]);
+            ud.NormalizedSelf();
+            if (Ud.AlmostEqual(ud)) {
+                changeDir[1] = 0.0;
+            } else {
+                changeDir[1] = acos(vctDotProduct(Ud, ud));
+                crossN = vctCrossProduct(Ud, ud);
+                if (vctDotProduct(normYZ, crossN) < 0.0) {
+                    changeDir[1] = -changeDir[1];
+                }
+            }
+            changeDir[2] = scale * (C.Norm() - c.Norm());
+            vct3 cw(up[0], up[1], 0);
+            cw.NormalizedSelf();
+            if (Cw.AlmostEqual(cw)) {
+                changeDir[3] = 0.0;
+            } else {
+                changeDir[3] = -acos(vctDotProduct(Cw, cw));
+                crossN = vctCrossProduct(Cw, cw);
+                if (vctDotProduct(normXY, crossN) < 0) {
+                    changeDir[3] = -changeDir[3];
+                }
+            }
+            double totalChangeJoint3 = changeDir[3] + ECMPositionJoint[3];
+            changeJoints[0] = changeDir[0] * cos(totalChangeJoint3) - changeDir[1] * sin(totalChangeJoint3);
+            changeJoints[1] = changeDir[1] * cos(totalChangeJoint3) + changeDir[0] * sin(totalChangeJoint3);
+            changeJoints[2] = changeDir[2];
+            changeJoints[3] = changeDir[3];
+            goalJoints.Add(changeJoints);
+            GoalJoints.ForceAssign(goalJoints);
+
+            vctEulerZYXRotation3 finalEulerAngles;
+            vctMatrixRotation3<double> currECMRot;
+            vctMatrixRotation3<double> finalECMRot;
+            finalEulerAngles.Assign(goalJoints[3], goalJoints[0], goalJoints[1]);
+            vctEulerToMatrixRotation3(finalEulerAngles, finalECMRot);
+            currECMRot = finalECMRot * ECMRotEuler.Inverse();
+            MTMLRotation = currECMRot.Inverse() * MTMLRot;
+            MTMRRotation = currECMRot.Inverse() * MTMRRot;
+        }
+
+        vct3 C, Up, Lr, Ud, Cw;
+        double w, d;
+        vctMatRot3 MTMLRot, MTMRRot;
+        vctMatrixRotation3<double> ECMRotEuler;
+        vctVec ECMPositionJoint;
+
+        vct3 GoalL, GoalR;
+        vctVec GoalJoints;
+        vctMatRot3 MTMLRotation, MTMRRotation;
+    };
+
+    // synthetic MTM motion, both arms start in front of the user and
+    // move along smooth trajectories covering all 4 ECM directions
+    void SyntheticPositions(const size_t index,
+                            vct3 & mtml, vct3 & mtmr) {
+        const double t = index * 0.001;
+        mtml.Assign(-0.15 + 0.03 * sin(1.3 * t),
+                    -0.05 + 0.02 * sin(0.7 * t),
+                    -0.35 + 0.04 * sin(0.9 * t));
+        mtmr.Assign( 0.15 + 0.02 * sin(1.1 * t),
+                    -0.05 + 0.03 * cos(0.5 * t) - 0.03,
+                    -0.35 + 0.03 * sin(1.7 * t));
+    }
+
+    void InitialState(vct3 & mtml, vctMatRot3 & mtmlRotation,
+                      vct3 & mtmr, vctMatRot3 & mtmrRotation,
+                      vct4 & ecmJoints) {
+        SyntheticPositions(0, mtml, mtmr);
+        mtmlRotation.From(vctAxAnRot3(vct3(0.0, 0.0, 1.0), 0.2));
+        mtmrRotation.From(vctAxAnRot3(vct3(0.0, 1.0, 0.0), -0.3));
+        ecmJoints.Assign(0.1, -0.2, 0.12, 0.3);
+    }
+}
+
+void robTeleOperationECMTest::TestInitialize(void)
+{
+    vct3 mtml, mtmr;
+    vctMatRot3 mtmlRotation, mtmrRotation;
+    vct4 ecmJoints;
+    InitialState(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJoints);
+
+    robTeleOperationECM teleop;
+    teleop.Initialize(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJoints);
+    teleop.Compute(mtml, mtmr, 0.2);
+
+    const double tolerance = 1.0e-9;
+    CPPUNIT_ASSERT(teleop.GoalL().AlmostEqual(mtml, tolerance));
+    CPPUNIT_ASSERT(teleop.GoalR().AlmostEqual(mtmr, tolerance));
+    CPPUNIT_ASSERT(teleop.GoalJoints().AlmostEqual(ecmJoints, tolerance));
+    CPPUNIT_ASSERT(teleop.MTMLRotation().AlmostEqual(mtmlRotation, tolerance));
+    CPPUNIT_ASSERT(teleop.MTMRRotation().AlmostEqual(mtmrRotation, tolerance));
+}
+
+void robTeleOperationECMTest::TestInsertion(void)
+{
+    vct3 mtml, mtmr;
+    vctMatRot3 mtmlRotation, mtmrRotation;
+    vct4 ecmJoints;
+    InitialState(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJoints);
+
+    robTeleOperationECM teleop;
+    teleop.Initialize(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJoints);
+
+    // both MTMs move away from the user along the center direction
+    vct3 center;
+    center.SumOf(mtml, mtmr);
+    center.Multiply(0.5);
+    const vct3 direction = center.Normalized();
+    const double distance = 0.02;
+    const double scale = 0.2;
+    mtml.AddProductOf(distance, direction);
+    mtmr.AddProductOf(distance, direction);
+    teleop.Compute(mtml, mtmr, scale);
+
+    const double tolerance = 1.0e-9;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ecmJoints[0], teleop.GoalJoints()[0], tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ecmJoints[1], teleop.GoalJoints()[1], tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ecmJoints[2] - scale * distance, teleop.GoalJoints()[2], tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ecmJoints[3], teleop.GoalJoints()[3], tolerance);
+    // MTMs stay where they are, orientation doesn't change
+    CPPUNIT_ASSERT(teleop.GoalL().AlmostEqual(mtml, tolerance));
+    CPPUNIT_ASSERT(teleop.GoalR().AlmostEqual(mtmr, tolerance));
+    CPPUNIT_ASSERT(teleop.MTMLRotation().AlmostEqual(mtmlRotation, tolerance));
+    CPPUNIT_ASSERT(teleop.MTMRRotation().AlmostEqual(mtmrRotation, tolerance));
+}
+
+void robTeleOperationECMTest::TestRotation(void)
+{
+    // MTMs side by side, center along -Z so up vector is in XY plane
+    vct3 mtml(-0.15, 0.0, -0.35);
+    vct3 mtmr( 0.15, 0.0, -0.35);
+    const vctMatRot3 mtmlRotation, mtmrRotation;
+    const vct4 ecmJoints(0.1, -0.2, 0.12, 0.3);
+
+    robTeleOperationECM teleop;
+    teleop.Initialize(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJoints);
+
+    // rotate both MTMs around the center
+    const double angle = 0.2;
+    vctMatRot3 rotation;
+    rotation.From(vctAxAnRot3(vct3(0.0, 0.0, 1.0), angle));
+    mtml = rotation * mtml;
+    mtmr = rotation * mtmr;
+    teleop.Compute(mtml, mtmr, 0.2);
+
+    const double tolerance = 1.0e-9;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ecmJoints[0], teleop.GoalJoints()[0], tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ecmJoints[1], teleop.GoalJoints()[1], tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ecmJoints[2], teleop.GoalJoints()[2], tolerance);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ecmJoints[3] - angle, teleop.GoalJoints()[3], tolerance);
+    // MTMs stay where they are
+    CPPUNIT_ASSERT(teleop.GoalL().AlmostEqual(mtml, tolerance));
+    CPPUNIT_ASSERT(teleop.GoalR().AlmostEqual(mtmr, tolerance));
+}
+
+void robTeleOperationECMTest::TestEquivalence(void)
+{
+    vct3 mtml, mtmr;
+    vctMatRot3 mtmlRotation, mtmrRotation;
+    vct4 ecmJoints;
+    InitialState(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJoints);
+
+    robTeleOperationECM teleop;
+    teleop.Initialize(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJoints);
+    ReferenceTeleOperationECM reference;
+    vctVec ecmJointsDynamic(4);
+    ecmJointsDynamic.Assign(ecmJoints);
+    reference.Initialize(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJointsDynamic);
+
+    const double tolerance = 1.0e-9;
+    const size_t numberOfSteps = 20000;
+    for (size_t index = 0; index < numberOfSteps; ++index) {
+        SyntheticPositions(index, mtml, mtmr);
+        teleop.Compute(mtml, mtmr, 0.2);
+        reference.Compute(mtml, mtmr, 0.2);
+        CPPUNIT_ASSERT(teleop.GoalL().AlmostEqual(reference.GoalL, tolerance));
+        CPPUNIT_ASSERT(teleop.GoalR().AlmostEqual(reference.GoalR, tolerance));
+        for (size_t joint = 0; joint < 4; ++joint) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(reference.GoalJoints[joint],
+                                         teleop.GoalJoints()[joint],
+                                         tolerance);
+        }
+        CPPUNIT_ASSERT(teleop.MTMLRotation().AlmostEqual(reference.MTMLRotation, tolerance));
+        CPPUNIT_ASSERT(teleop.MTMRRotation().AlmostEqual(reference.MTMRRotation, tolerance));
+    }
+}
+
+void robTeleOperationECMTest::TestBenchmark(void)
+{
+    vct3 mtml, mtmr;
+    vctMatRot3 mtmlRotation, mtmrRotation;
+    vct4 ecmJoints;
+    InitialState(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJoints);
+
+    robTeleOperationECM teleop;
+    teleop.Initialize(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJoints);
+    ReferenceTeleOperationECM reference;
+    vctVec ecmJointsDynamic(4);
+    ecmJointsDynamic.Assign(ecmJoints);
+    reference.Initialize(mtml, mtmlRotation, mtmr, mtmrRotation, ecmJointsDynamic);
+
+    const size_t numberOfSteps = 100000;
+    double startTime = osaGetTime();
+    for (size_t index = 0; index < numberOfSteps; ++index) {
+        SyntheticPositions(index, mtml, mtmr);
+        teleop.Compute(mtml, mtmr, 0.2);
+    }
+    const double fixedTime = (osaGetTime() - startTime) / numberOfSteps;
+
+    startTime = osaGetTime();
+    for (size_t index = 0; index < numberOfSteps; ++index) {
+        SyntheticPositions(index, mtml, mtmr);
+        reference.Compute(mtml, mtmr, 0.2);
+    }
+    const double referenceTime = (osaGetTime() - startTime) / numberOfSteps;
+
+    sawIntuitiveResearchKitTests::BenchmarkOutput() << std::endl
+              << "robTeleOperationECMTest: average compute time, fixed size: "
+              << fixedTime * 1.0e9 << " (ns), dynamic (original): "
+              << referenceTime * 1.0e9 << " (ns)" << std::endl;
+}
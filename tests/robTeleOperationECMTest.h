@@ -0,0 +1,64 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-09-16
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sawIntuitiveResearchKit/robTeleOperationECM.h>
+
+class robTeleOperationECMTest : public CppUnit::TestFixture
+{
+protected:
+
+    CPPUNIT_TEST_SUITE(robTeleOperationECMTest);
+    {
+        CPPUNIT_TEST(TestInitialize);
+        CPPUNIT_TEST(TestInsertion);
+        CPPUNIT_TEST(TestRotation);
+        CPPUNIT_TEST(TestEquivalence);
+#ifdef sawIntuitiveResearchKitTests_BENCHMARKS
+        CPPUNIT_TEST(TestBenchmark);
+#endif
+    }
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp(void) {
+    }
+
+    void tearDown(void) {
+    }
+
+    // goals should match initial state if MTMs don't move
+    void TestInitialize(void);
+
+    // symmetric motion along center only changes insertion (joint 2)
+    void TestInsertion(void);
+
+    // rotation of MTMs around center only changes roll (joint 3)
+    void TestRotation(void);
+
+    // compare with original implementation using dynamic vectors
+    void TestEquivalence(void);
+
+    // compare computation time with original implementation
+    void TestBenchmark(void);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(robTeleOperationECMTest);
@@ -0,0 +1,41 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-    */
+/* ex: set filetype=cpp softtabstop=4 shiftwidth=4 tabstop=4 cindent expandtab: */
+
+/*
+  Author(s):  Anton Deguet
+  Created on: 2021-10-21
+
+  (C) Copyright 2021 Johns Hopkins University (JHU), All Rights Reserved.
+
+--- begin cisst license - do not edit ---
+
+This software is provided "as is" under an open source license, with
+no warranty.  The complete license can be found in license.txt and
+http://www.cisst.org/cisst/license.txt.
+
+--- end cisst license ---
+*/
+
+#ifndef _sawIntuitiveResearchKitTestsBenchmark_h
+#define _sawIntuitiveResearchKitTestsBenchmark_h
+
+#include <iostream>
+
+namespace sawIntuitiveResearchKitTests {
+
+    /*! Stream used to report timings.  Tests stay silent unless they
+      are configured with sawIntuitiveResearchKitTests_BENCHMARKS, in
+      which case the timing only tests are also registered. */
+    inline std::ostream & BenchmarkOutput(void) {
+#ifdef sawIntuitiveResearchKitTests_BENCHMARKS
+        return std::cout;
+#else
+        // stream without buffer, everything is discarded
+        static std::ostream discard(nullptr);
+        return discard;
+#endif
+    }
+
+}
+
+#endif // _sawIntuitiveResearchKitTestsBenchmark_h